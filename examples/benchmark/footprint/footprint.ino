@@ -0,0 +1,147 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/**
+ *   Footprint probe: minimal program, using single library API. Probe is selected
+ *   by FOOTPRINT_<NAME> define (see tools/footprint.sh, which builds all probes and
+ *   collects flash/SRAM usage). Without define the sketch is empty program, which
+ *   is used as a reference.
+ */
+
+#if defined(FOOTPRINT_ENGINE_ADAFRUIT)
+#define CONFIG_ADAFRUIT_GFX_ENABLE
+#endif
+
+#include "ssd1306.h"
+#include "nano_engine.h"
+
+#if defined(FOOTPRINT_ENGINE_ADAFRUIT) && !defined(ARDUINO)
+extern "C" void __cxa_pure_virtual() { while (1); }
+#endif
+
+const PROGMEM uint8_t heartImage[8] =
+{
+    0B01100110,
+    0B11111001,
+    0B11111101,
+    0B11111111,
+    0B01111110,
+    0B00111100,
+    0B00011000,
+    0B00000000
+};
+
+#if defined(FOOTPRINT_CANVAS1)
+uint8_t canvasData[32*32/8];
+NanoCanvas1 canvas(32, 32, canvasData);
+#elif defined(FOOTPRINT_ENGINE_8X8)
+NanoEngine<TILE_8x8_MONO> engine;
+#elif defined(FOOTPRINT_ENGINE_16X16)
+NanoEngine<TILE_16x16_MONO> engine;
+#elif defined(FOOTPRINT_ENGINE_32X32)
+NanoEngine<TILE_32x32_MONO> engine;
+#elif defined(FOOTPRINT_ENGINE_ADAFRUIT)
+NanoEngine<ADATILE_8x8_MONO> engine;
+#endif
+
+#if defined(FOOTPRINT_MENU)
+const char *menuItems[] =
+{
+    "draw bitmap",
+    "sprites",
+    "fonts",
+};
+SAppMenu menu;
+#endif
+
+#if defined(FOOTPRINT_ENGINE_8X8) || defined(FOOTPRINT_ENGINE_16X16) || \
+    defined(FOOTPRINT_ENGINE_32X32) || defined(FOOTPRINT_ENGINE_ADAFRUIT)
+#define FOOTPRINT_ENGINE
+bool drawAll()
+{
+    engine.canvas.clear();
+    engine.canvas.drawRect(10, 10, 50, 40);
+    engine.canvas.printFixed(0, 0, "Hello");
+    return true;
+}
+#endif
+
+void setup()
+{
+#if defined(FOOTPRINT_SPI_INIT)
+    ssd1306_128x64_spi_init(3, 4, 5);
+#elif defined(FOOTPRINT_I2C_INIT) || defined(FOOTPRINT_TEXT) || defined(FOOTPRINT_TEXT_2X) || \
+      defined(FOOTPRINT_TEXT_UTF8) || defined(FOOTPRINT_BITMAP) || defined(FOOTPRINT_SPRITE) || \
+      defined(FOOTPRINT_MENU) || defined(FOOTPRINT_CANVAS1) || defined(FOOTPRINT_ENGINE)
+    ssd1306_128x64_i2c_init();
+#endif
+
+#if defined(FOOTPRINT_TEXT)
+    ssd1306_clearScreen();
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    ssd1306_printFixed(0, 8, "Hello", STYLE_NORMAL);
+#elif defined(FOOTPRINT_TEXT_2X)
+    ssd1306_clearScreen();
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    ssd1306_printFixedN(0, 8, "Hello", STYLE_NORMAL, FONT_SIZE_2X);
+#elif defined(FOOTPRINT_TEXT_UTF8)
+    ssd1306_clearScreen();
+    ssd1306_setFreeFont(free_calibri11x12);
+    ssd1306_setSecondaryFont(free_calibri11x12_cyrillic);
+    ssd1306_enableUtf8Mode();
+    ssd1306_printFixed(0, 8, "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82", STYLE_NORMAL);
+#elif defined(FOOTPRINT_BITMAP)
+    ssd1306_clearScreen();
+    ssd1306_drawBitmap(0, 0, 8, 8, heartImage);
+#elif defined(FOOTPRINT_SPRITE)
+    ssd1306_clearScreen();
+    SPRITE sprite = ssd1306_createSprite(0, 0, sizeof(heartImage), heartImage);
+    sprite.x = 10;
+    ssd1306_drawSprite(&sprite);
+#elif defined(FOOTPRINT_MENU)
+    ssd1306_clearScreen();
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    ssd1306_createMenu(&menu, menuItems, sizeof(menuItems) / sizeof(char *));
+    ssd1306_showMenu(&menu);
+#elif defined(FOOTPRINT_CANVAS1)
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    canvas.clear();
+    canvas.drawRect(2, 2, 29, 29);
+    canvas.printFixed(4, 8, "Hi");
+    canvas.blt(48, 16);
+#elif defined(FOOTPRINT_ENGINE)
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    engine.begin();
+    engine.drawCallback(drawAll);
+    engine.refresh();
+#endif
+}
+
+void loop()
+{
+#if defined(FOOTPRINT_ENGINE)
+    if (!engine.nextFrame()) return;
+    engine.display();
+#endif
+}
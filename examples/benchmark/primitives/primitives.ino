@@ -0,0 +1,394 @@
+/*
+    MIT License
+
+    Copyright (c) 2016-2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * Benchmark for individual library primitives and NanoEngine frames.
+ * The sketch runs each test several times and prints results as comma separated table:
+ *
+ *   test,bpp,intf,us,bytes,pixels_per_s
+ *
+ * us is average duration of single test run in microseconds, bytes is number of bytes
+ * sent to the display by single run, pixels_per_s is drawing speed for pixels, touched
+ * by the test. The table can be saved and compared between library releases.
+ *
+ * Select display and interface below. 8-bit and 16-bit tests are run only for color displays.
+ * On Linux the sketch can be run both with real display and with SDL emulator.
+ */
+
+#include "ssd1306.h"
+#include "nano_engine.h"
+#include "intf/ssd1306_interface.h"
+
+#define TEST_I2C                0
+#define TEST_SPI                1
+
+#define OLED_SSD1306            0
+#define OLED_SSD1351            1
+
+#define TEST_INTERFACE          TEST_SPI
+#define TEST_OLED               OLED_SSD1306
+
+/** Number of runs for each test */
+#define TEST_RUNS               8
+
+const uint8_t heartImage[8] PROGMEM =
+{
+    0B00001110,
+    0B00011111,
+    0B00111111,
+    0B01111110,
+    0B01111110,
+    0B00111101,
+    0B00011001,
+    0B00001110
+};
+
+/* Buffer, shared by all canvas tests: 128x64 for 1-bit, 32x32 for 8-bit, 32x16 for 16-bit */
+uint8_t canvasData[1024];
+
+NanoEngine1  engine1;
+#if TEST_OLED != OLED_SSD1306
+NanoEngine8  engine8;
+NanoEngine16 engine16;
+#endif
+
+/////////////////////////////// BYTES COUNTER ///////////////////////////////
+
+static uint32_t s_bytes;
+static void (*s_send)(uint8_t data);
+static void (*s_sendBuffer)(const uint8_t *buffer, uint16_t size);
+
+static void countSend(uint8_t data)
+{
+    s_bytes++;
+    s_send(data);
+}
+
+static void countSendBuffer(const uint8_t *buffer, uint16_t size)
+{
+    s_bytes += size;
+    s_sendBuffer(buffer, size);
+}
+
+/* lcd drivers copy interface pointers to lcd structure, so they are replaced too */
+static void hookInterface()
+{
+    s_send = ssd1306_intf.send;
+    s_sendBuffer = ssd1306_intf.send_buffer;
+    ssd1306_intf.send = countSend;
+    ssd1306_intf.send_buffer = countSendBuffer;
+    if (ssd1306_lcd.send_pixels1 == s_send) ssd1306_lcd.send_pixels1 = countSend;
+    if (ssd1306_lcd.send_pixels8 == s_send) ssd1306_lcd.send_pixels8 = countSend;
+    if (ssd1306_lcd.send_pixels_buffer1 == s_sendBuffer) ssd1306_lcd.send_pixels_buffer1 = countSendBuffer;
+}
+
+/////////////////////////////// 1-BIT TESTS /////////////////////////////////
+
+static void drawLine1()
+{
+    ssd1306_drawLine(0, 0, 127, 63);
+}
+
+static void fillRect1()
+{
+    ssd1306_fillScreen(0xFF);
+}
+
+static void printFixed1()
+{
+    ssd1306_printFixed(0, 8, "Hello, world!", STYLE_NORMAL);
+}
+
+static void drawBitmap1()
+{
+    for (uint8_t x = 0; x < 128; x += 8)
+    {
+        ssd1306_drawBitmap(x, 2, 8, 8, heartImage);
+    }
+}
+
+static void canvasBlt1()
+{
+    NanoCanvas1 canvas(128, 64, canvasData);
+    canvas.drawRect(10, 10, 117, 53);
+    canvas.blt();
+}
+
+static bool drawEngine1()
+{
+    engine1.canvas.clear();
+    engine1.canvas.drawRect(10, 10, 117, 53);
+    engine1.canvas.printFixed(16, 24, "Engine");
+    return true;
+}
+
+static void engineFrame1()
+{
+    engine1.refresh();
+    engine1.display();
+}
+
+/////////////////////////////// 8-BIT TESTS /////////////////////////////////
+
+#if TEST_OLED != OLED_SSD1306
+static void drawLine8()
+{
+    ssd1306_setColor(RGB_COLOR8(255, 255, 0));
+    ssd1306_drawLine8(0, 0, ssd1306_lcd.width - 1, ssd1306_lcd.height - 1);
+}
+
+static void fillRect8()
+{
+    ssd1306_setColor(RGB_COLOR8(0, 0, 255));
+    ssd1306_fillRect8(0, 0, ssd1306_lcd.width - 1, ssd1306_lcd.height - 1);
+}
+
+static void printFixed8()
+{
+    ssd1306_setColor(RGB_COLOR8(255, 255, 255));
+    ssd1306_printFixed8(0, 8, "Hello, world!", STYLE_NORMAL);
+}
+
+static void drawBitmap8()
+{
+    ssd1306_setColor(RGB_COLOR8(255, 0, 0));
+    for (lcduint_t x = 0; x < 128; x += 8)
+    {
+        ssd1306_drawMonoBitmap8(x, 16, 8, 8, heartImage);
+    }
+}
+
+static void canvasBlt8()
+{
+    NanoCanvas8 canvas(32, 32, canvasData);
+    canvas.setColor(RGB_COLOR8(0, 255, 0));
+    canvas.drawRect(2, 2, 29, 29);
+    canvas.blt();
+}
+
+static bool drawEngine8()
+{
+    engine8.canvas.clear();
+    engine8.canvas.setColor(RGB_COLOR8(0, 255, 0));
+    engine8.canvas.drawRect(10, 10, ssd1306_lcd.width - 11, ssd1306_lcd.height - 11);
+    engine8.canvas.printFixed(16, 24, "Engine");
+    return true;
+}
+
+static void engineFrame8()
+{
+    engine8.refresh();
+    engine8.display();
+}
+
+/////////////////////////////// 16-BIT TESTS ////////////////////////////////
+
+static void drawLine16()
+{
+    ssd1306_setColor(RGB_COLOR16(255, 255, 0));
+    ssd1306_drawLine16(0, 0, ssd1306_lcd.width - 1, ssd1306_lcd.height - 1);
+}
+
+static void fillRect16()
+{
+    ssd1306_setColor(RGB_COLOR16(0, 0, 255));
+    ssd1306_fillRect16(0, 0, ssd1306_lcd.width - 1, ssd1306_lcd.height - 1);
+}
+
+static void printFixed16()
+{
+    ssd1306_setColor(RGB_COLOR16(255, 255, 255));
+    ssd1306_printFixed16(0, 8, "Hello, world!", STYLE_NORMAL);
+}
+
+static void drawBitmap16()
+{
+    ssd1306_setColor(RGB_COLOR16(255, 0, 0));
+    for (lcduint_t x = 0; x < 128; x += 8)
+    {
+        ssd1306_drawMonoBitmap16(x, 16, 8, 8, heartImage);
+    }
+}
+
+static void canvasBlt16()
+{
+    NanoCanvas16 canvas(32, 16, canvasData);
+    canvas.setColor(RGB_COLOR16(0, 255, 0));
+    canvas.drawRect(2, 2, 29, 13);
+    canvas.blt();
+}
+
+static bool drawEngine16()
+{
+    engine16.canvas.clear();
+    engine16.canvas.setColor(RGB_COLOR16(0, 255, 0));
+    engine16.canvas.drawRect(10, 10, ssd1306_lcd.width - 11, ssd1306_lcd.height - 11);
+    engine16.canvas.printFixed(16, 24, "Engine");
+    return true;
+}
+
+static void engineFrame16()
+{
+    engine16.refresh();
+    engine16.display();
+}
+#endif
+
+/////////////////////////////// TEST RUNNER /////////////////////////////////
+
+typedef struct
+{
+    /** Test name */
+    const char *name;
+    /** Number of bits per pixel */
+    uint8_t bpp;
+    /** Number of pixels, touched by single run */
+    uint32_t pixels;
+    /** Test function */
+    void (*run)(void);
+} BenchmarkTest;
+
+const char nameLine[] PROGMEM = "drawLine";
+const char nameFill[] PROGMEM = "fillRect";
+const char namePrint[] PROGMEM = "printFixed";
+const char nameBitmap[] PROGMEM = "drawBitmap";
+const char nameBlt[] PROGMEM = "canvas.blt";
+const char nameFrame[] PROGMEM = "engineFrame";
+
+/* For color displays pixel counts are calculated for 128x128 screen */
+const BenchmarkTest tests[] =
+{
+    { nameLine,   1, 128,          drawLine1 },
+    { nameFill,   1, 128 * 64,     fillRect1 },
+    { namePrint,  1, 13 * 6 * 8,   printFixed1 },
+    { nameBitmap, 1, 16 * 8 * 8,   drawBitmap1 },
+    { nameBlt,    1, 128 * 64,     canvasBlt1 },
+    { nameFrame,  1, 128 * 64,     engineFrame1 },
+#if TEST_OLED != OLED_SSD1306
+    { nameLine,   8, 128,          drawLine8 },
+    { nameFill,   8, 128 * 128,    fillRect8 },
+    { namePrint,  8, 13 * 6 * 8,   printFixed8 },
+    { nameBitmap, 8, 16 * 8 * 8,   drawBitmap8 },
+    { nameBlt,    8, 32 * 32,      canvasBlt8 },
+    { nameFrame,  8, 128 * 128,    engineFrame8 },
+    { nameLine,   16, 128,         drawLine16 },
+    { nameFill,   16, 128 * 128,   fillRect16 },
+    { namePrint,  16, 13 * 6 * 8,  printFixed16 },
+    { nameBitmap, 16, 16 * 8 * 8,  drawBitmap16 },
+    { nameBlt,    16, 32 * 16,     canvasBlt16 },
+    { nameFrame,  16, 128 * 128,   engineFrame16 },
+#endif
+};
+
+static void printStr(const char *str)
+{
+#ifdef __linux__
+    printf("%s", str);
+#else
+    Serial.print(str);
+#endif
+}
+
+static void printStrPgm(const char *str)
+{
+    while (pgm_read_byte(str))
+    {
+#ifdef __linux__
+        printf("%c", (char)pgm_read_byte(str++));
+#else
+        Serial.print((char)pgm_read_byte(str++));
+#endif
+    }
+}
+
+static void printNum(uint32_t value, char separator)
+{
+#ifdef __linux__
+    printf("%u%c", (unsigned)value, separator);
+#else
+    Serial.print(value);
+    Serial.print(separator);
+#endif
+}
+
+static void runTest(const BenchmarkTest *test)
+{
+    if (test->bpp == 1)
+    {
+        ssd1306_setMode(LCD_MODE_SSD1306_COMPAT);
+    }
+    else
+    {
+        ssd1306_setMode(LCD_MODE_NORMAL);
+    }
+    ssd1306_clearScreen();
+    s_bytes = 0;
+    uint32_t start = micros();
+    for (uint8_t i = 0; i < TEST_RUNS; i++)
+    {
+        test->run();
+    }
+    uint32_t duration = (micros() - start) / TEST_RUNS;
+    printStrPgm(test->name);
+    printStr(",");
+    printNum(test->bpp, ',');
+    printStr(ssd1306_intf.spi ? "spi," : "i2c,");
+    printNum(duration, ',');
+    printNum(s_bytes / TEST_RUNS, ',');
+    printNum(duration ? (uint32_t)((uint64_t)test->pixels * 1000000 / duration) : 0, '\n');
+}
+
+void setup()
+{
+#ifndef __linux__
+    Serial.begin(115200);
+#endif
+#if TEST_OLED == OLED_SSD1306
+    #if TEST_INTERFACE == TEST_SPI
+    ssd1306_128x64_spi_init(3, 4, 5);
+    #else
+    ssd1306_128x64_i2c_init();
+    #endif
+#else
+    ssd1351_128x128_spi_init(3, 4, 5);
+#endif
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    hookInterface();
+    engine1.drawCallback(drawEngine1);
+#if TEST_OLED != OLED_SSD1306
+    engine8.drawCallback(drawEngine8);
+    engine16.drawCallback(drawEngine16);
+#endif
+    printStr("test,bpp,intf,us,bytes,pixels_per_s\n");
+    for (uint8_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++)
+    {
+        runTest(&tests[i]);
+    }
+}
+
+void loop()
+{
+#ifdef __linux__
+    exit(0);
+#endif
+}
@@ -0,0 +1,105 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ *   Atmega328 I2C PINS: connect LCD to A4/A5
+ *   ESP8266   I2C PINS: GPIO4/GPIO5
+ *   ESP32     I2C PINS: 21/22
+ *
+ *   The sketch draws the same scene with tiles of different size, replays
+ *   refreshed areas of a moving sprite and shows average frame time for each tile
+ *   size. Tile with the lowest frame time, fitting RAM budget, is marked with '*'.
+ */
+
+#include "ssd1306.h"
+#include "nano_engine.h"
+
+/* Max tile buffer size, the application can afford */
+static const uint32_t RAM_BUDGET = 512;
+
+static const uint8_t FRAMES = 48;
+
+/* Each frame refreshes old and new positions of 8x8 sprite */
+static NanoRect pattern[FRAMES * 2];
+
+static bool drawScene(NanoCanvas1 &canvas)
+{
+    canvas.clear();
+    canvas.drawRect(0, 0, 127, 63);
+    canvas.printFixed(8, 8, "Tile tuner", STYLE_NORMAL);
+    canvas.fillRect(56, 28, 71, 43);
+    return true;
+}
+
+static void preparePattern()
+{
+    NanoRect prev = { {4, 28}, {11, 35} };
+    for (uint8_t i = 0; i < FRAMES; i++)
+    {
+        NanoRect next = prev;
+        next.move( 2, (i & 0x08) ? 1 : -1 );
+        pattern[i * 2] = prev;
+        pattern[i * 2 + 1] = next;
+        prev = next;
+    }
+}
+
+static void printResult(uint8_t row, const NanoTileBenchResult &r, bool best)
+{
+    char line[22];
+    char *p = line;
+    *p++ = best ? '*' : ' ';
+    utoa(r.tileWidth, p, 10); p += strlen(p);
+    *p++ = 'x';
+    utoa(r.tileHeight, p, 10); p += strlen(p);
+    *p++ = ' ';
+    utoa(r.frameUs, p, 10); p += strlen(p);
+    strcpy(p, "us");
+    ssd1306_printFixed(0, row * 8, line, STYLE_NORMAL);
+}
+
+void setup()
+{
+    ssd1306_setFixedFont(ssd1306xled_font6x8);
+    ssd1306_128x64_i2c_init();
+    preparePattern();
+
+    NanoTileTuner<NanoCanvas1> tuner(drawScene, pattern, FRAMES * 2, 2);
+    NanoTileBenchResult results[4];
+    uint8_t count = 0;
+    if (tuner.run<8, 8, 3>(results[count])) count++;
+    if (tuner.run<16, 16, 4>(results[count])) count++;
+    if (tuner.run<32, 32, 5>(results[count])) count++;
+    if (tuner.run<64, 64, 6>(results[count])) count++;
+    const NanoTileBenchResult *best = NanoTileTuner<NanoCanvas1>::recommend(results, count, RAM_BUDGET);
+
+    ssd1306_clearScreen();
+    for (uint8_t i = 0; i < count; i++)
+    {
+        printResult(i, results[i], &results[i] == best);
+    }
+}
+
+void loop()
+{
+}
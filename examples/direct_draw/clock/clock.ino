@@ -39,6 +39,12 @@ uint8_t  hours = 10;
 uint8_t  minutes = 35;
 uint8_t  seconds = 0;
 
+/* Text fields remember drawn digits and send to display only changed ones */
+char hoursText[3];
+char minutesText[3];
+STextField hoursField;
+STextField minutesField;
+
 void printSeconds()
 {
     if (seconds & 1)
@@ -53,18 +59,14 @@ void printSeconds()
 
 void printMinutes()
 {
-    char minutesStr[3] = "00";
-    minutesStr[0] = '0' + minutes / 10;
-    minutesStr[1] = '0' + minutes % 10;
-    ssd1306_printFixed(78,  8, minutesStr, STYLE_NORMAL);
+    char minutesStr[3];
+    ssd1306_updateTextField(&minutesField, ssd1306_formatNumber(minutesStr, minutes, 2, '0'));
 }
 
 void printHours()
 {
-    char hoursStr[3] = "00";
-    hoursStr[0] = '0' + hours / 10;
-    hoursStr[1] = '0' + hours % 10;
-    ssd1306_printFixed(6,  8, hoursStr, STYLE_NORMAL);
+    char hoursStr[3];
+    ssd1306_updateTextField(&hoursField, ssd1306_formatNumber(hoursStr, hours, 2, '0'));
 }
 
 void setup() {
@@ -72,6 +74,8 @@ void setup() {
     ssd1306_128x64_i2c_init();
     ssd1306_fillScreen(0x00);
     ssd1306_setFixedFont(comic_sans_font24x32_123);
+    ssd1306_createTextField(&hoursField, 6, 8, hoursText, sizeof(hoursText));
+    ssd1306_createTextField(&minutesField, 78, 8, minutesText, sizeof(minutesText));
     lastMillis = millis();
     printHours();
     printMinutes();
@@ -158,7 +158,7 @@ void drawIntro()
 #elif defined(CONFIG_SOFTWARE_I2C_AVAILABLE)
     ssd1306_i2cInit_Embedded(-1,-1,0);
 #elif defined(CONFIG_PLATFORM_I2C_AVAILABLE)
-    ssd1306_platform_i2cInit(-1,0,-1);
+    ssd1306_platform_i2cInit(-1,0,NULL);
 #elif defined(CONFIG_TWI_I2C_AVAILABLE)
     ssd1306_i2cInit_Twi(0);
 #else
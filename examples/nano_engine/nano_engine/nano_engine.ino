@@ -55,7 +55,8 @@ void displayStats()
         engine.canvas.setColor(RGB_COLOR8(255,0,255));
         engine.canvas.printFixed(0, 0, "MS: ");
         engine.canvas.printFixed(24, 0, bufStr);
-        utoa(1000/(totalDuration/frames),bufStr,10);
+        /* Frame may take less than 1 ms on fast platforms and emulator */
+        utoa(totalDuration >= frames ? 1000/(totalDuration/frames) : 1000,bufStr,10);
         engine.canvas.printFixed(0, 8, "FPS: ");
         engine.canvas.printFixed(30, 8, bufStr);
     }
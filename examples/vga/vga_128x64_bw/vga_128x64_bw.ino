@@ -28,6 +28,10 @@
  *     D9 - H-Sync of D-Sub connector
  *     D3 - V-Sync of D-Sub connector
  *
+ *   If VGA_128X64_MSPIM is defined before including vga_isr.h, pixels are output
+ *   by USART: connect D1 (instead of A0) to blue, green, red channels. D1 and D4 are
+ *   used by USART, so Serial cannot be used.
+ *
  *   Sketch allows to use all other PINs except A3-A6 pins.
  *   delay, millis functions do not work. Use ssd1306_vga_delay() instead.
  *
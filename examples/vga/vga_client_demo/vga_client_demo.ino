@@ -71,6 +71,7 @@ const char *menuItems[] =
     "fonts",
     "canvas gfx",
     "draw lines",
+    "batch",
 };
 
 static void bitmapDemo()
@@ -160,6 +161,21 @@ static void drawLinesDemo()
     delay(3000);
 }
 
+static void batchDemo()
+{
+    // Whole screen is sent as a single frame of drawing commands
+    ssd1306_vgaBatchBegin();
+    ssd1306_vgaBatchFillRect(0, 0, 95, 39, RGB_COLOR8(0, 0, 0));
+    for (uint8_t y = 0; y < 40; y += 4)
+    {
+        ssd1306_vgaBatchDrawHLine(0, y, 95, RGB_COLOR8(0, 0, 255));
+    }
+    ssd1306_vgaBatchFillRect(16, 12, 79, 27, RGB_COLOR8(255, 0, 0));
+    ssd1306_vgaBatchPrint(24, 16, RGB_COLOR8(255, 255, 0), "BATCH");
+    ssd1306_vgaBatchEnd();
+    delay(3000);
+}
+
 void setup()
 {
     ssd1306_setFixedFont(ssd1306xled_font6x8);
@@ -197,6 +213,10 @@ void loop()
             drawLinesDemo();
             break;
 
+        case 5:
+            batchDemo();
+            break;
+
         default:
             break;
     }
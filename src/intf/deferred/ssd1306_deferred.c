@@ -0,0 +1,460 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_deferred.h"
+#include "intf/ssd1306_interface.h"
+#include "intf/spi/ssd1306_spi.h"
+
+#if defined(CONFIG_DEFERRED_INTF_AVAILABLE) && defined(CONFIG_DEFERRED_INTF_ENABLE)
+
+#if defined(SSD1306_ESP_PLATFORM) || defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#define DEFERRED_FREERTOS
+#elif defined(SSD1306_RP2040_PLATFORM)
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+#define DEFERRED_PICO
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if (CONFIG_DEFERRED_INTF_QUEUE_SIZE & (CONFIG_DEFERRED_INTF_QUEUE_SIZE - 1)) != 0
+#error "CONFIG_DEFERRED_INTF_QUEUE_SIZE must be power of 2"
+#endif
+
+#define DEFERRED_MASK       (CONFIG_DEFERRED_INTF_QUEUE_SIZE - 1)
+/* Bytes of single send record, published as soon as it is full */
+#if CONFIG_DEFERRED_INTF_QUEUE_SIZE > 0x20000
+#define DEFERRED_MAX_SEND   0x8000
+#else
+#define DEFERRED_MAX_SEND   (CONFIG_DEFERRED_INTF_QUEUE_SIZE / 4)
+#endif
+
+/* Queue records: 1-byte code, followed by arguments */
+enum
+{
+    DEFERRED_START = 1,
+    DEFERRED_STOP,
+    DEFERRED_DATA_MODE,  /* 1 byte: mode */
+    DEFERRED_SEND,       /* 2 bytes: little-endian length, followed by data */
+};
+
+static ssd1306_interface_t s_deferred_intf;
+static uint8_t s_deferred_queue[CONFIG_DEFERRED_INTF_QUEUE_SIZE];
+/* Free-running positions: head is written by producer, tail by bus thread */
+static uint32_t s_deferred_head;
+static uint32_t s_deferred_tail;
+/* Producer side: write position and open send record, not published yet */
+static uint32_t s_deferred_wr;
+static uint32_t s_deferred_rec;
+static uint16_t s_deferred_rec_len;
+static uint8_t s_deferred_rec_open;
+static uint8_t s_deferred_sleeping;
+static uint8_t s_deferred_running;
+static uint8_t s_deferred_active;
+
+#ifdef DEFERRED_FREERTOS
+static TaskHandle_t s_deferred_task;
+static uint8_t s_deferred_stopped;
+#elif defined(DEFERRED_PICO)
+static uint8_t s_deferred_stopped;
+#else
+static pthread_t s_deferred_thread;
+static pthread_mutex_t s_deferred_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_deferred_cond = PTHREAD_COND_INITIALIZER;
+#endif
+
+static void ssd1306_deferred_wake(void)
+{
+    if (!__atomic_load_n(&s_deferred_sleeping, __ATOMIC_SEQ_CST))
+    {
+        return;
+    }
+#ifdef DEFERRED_FREERTOS
+    xTaskNotifyGive(s_deferred_task);
+#elif defined(DEFERRED_PICO)
+    __sev();
+#else
+    pthread_mutex_lock(&s_deferred_mutex);
+    pthread_cond_signal(&s_deferred_cond);
+    pthread_mutex_unlock(&s_deferred_mutex);
+#endif
+}
+
+static void ssd1306_deferred_yield(void)
+{
+#ifdef DEFERRED_FREERTOS
+    taskYIELD();
+#elif defined(DEFERRED_PICO)
+    tight_loop_contents();
+#else
+    sched_yield();
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//                         PRODUCER
+/////////////////////////////////////////////////////////////////////////////////
+
+static void ssd1306_deferred_close_record(void)
+{
+    if (s_deferred_rec_open)
+    {
+        s_deferred_queue[(s_deferred_rec + 1) & DEFERRED_MASK] = s_deferred_rec_len & 0xFF;
+        s_deferred_queue[(s_deferred_rec + 2) & DEFERRED_MASK] = s_deferred_rec_len >> 8;
+        s_deferred_rec_open = 0;
+    }
+}
+
+static void ssd1306_deferred_publish(void)
+{
+    __atomic_store_n(&s_deferred_head, s_deferred_wr, __ATOMIC_SEQ_CST);
+    ssd1306_deferred_wake();
+}
+
+static uint32_t ssd1306_deferred_space(void)
+{
+    return CONFIG_DEFERRED_INTF_QUEUE_SIZE -
+           (s_deferred_wr - __atomic_load_n(&s_deferred_tail, __ATOMIC_ACQUIRE));
+}
+
+static void ssd1306_deferred_wait_space(uint32_t size)
+{
+    while (ssd1306_deferred_space() < size)
+    {
+        ssd1306_deferred_close_record();
+        ssd1306_deferred_publish();
+        ssd1306_deferred_yield();
+    }
+}
+
+static void ssd1306_deferred_put_op(uint8_t op, uint8_t size, uint8_t arg)
+{
+    ssd1306_deferred_close_record();
+    ssd1306_deferred_wait_space(size);
+    s_deferred_queue[s_deferred_wr++ & DEFERRED_MASK] = op;
+    if (size > 1)
+    {
+        s_deferred_queue[s_deferred_wr++ & DEFERRED_MASK] = arg;
+    }
+    ssd1306_deferred_publish();
+}
+
+static void ssd1306_deferred_put_data(const uint8_t *buffer, uint16_t size)
+{
+    while (size)
+    {
+        if (!s_deferred_rec_open)
+        {
+            ssd1306_deferred_wait_space(4);
+            s_deferred_rec = s_deferred_wr;
+            s_deferred_queue[s_deferred_wr & DEFERRED_MASK] = DEFERRED_SEND;
+            s_deferred_wr += 3;
+            s_deferred_rec_len = 0;
+            s_deferred_rec_open = 1;
+        }
+        uint32_t n = ssd1306_deferred_space();
+        if ( n > (uint32_t)(DEFERRED_MAX_SEND - s_deferred_rec_len) ) n = DEFERRED_MAX_SEND - s_deferred_rec_len;
+        if ( n > size ) n = size;
+        if ( !n )
+        {
+            ssd1306_deferred_wait_space(1);
+            continue;
+        }
+        uint32_t pos = s_deferred_wr & DEFERRED_MASK;
+        uint32_t part = CONFIG_DEFERRED_INTF_QUEUE_SIZE - pos;
+        if ( part > n ) part = n;
+        memcpy(&s_deferred_queue[pos], buffer, part);
+        memcpy(&s_deferred_queue[0], buffer + part, n - part);
+        s_deferred_wr += n;
+        s_deferred_rec_len += n;
+        buffer += n;
+        size -= n;
+        if ( s_deferred_rec_len == DEFERRED_MAX_SEND )
+        {
+            /* Let bus thread send full record, while the next one is filled */
+            ssd1306_deferred_close_record();
+            ssd1306_deferred_publish();
+        }
+    }
+}
+
+static void ssd1306_deferred_start(void)
+{
+    ssd1306_deferred_put_op(DEFERRED_START, 1, 0);
+}
+
+static void ssd1306_deferred_stop(void)
+{
+    ssd1306_deferred_put_op(DEFERRED_STOP, 1, 0);
+}
+
+static void ssd1306_deferred_send(uint8_t data)
+{
+    ssd1306_deferred_put_data(&data, 1);
+}
+
+static void ssd1306_deferred_send_buffer(const uint8_t *buffer, uint16_t size)
+{
+    ssd1306_deferred_put_data(buffer, size);
+}
+
+static void ssd1306_deferred_wait(void)
+{
+    ssd1306_deferred_close_record();
+    ssd1306_deferred_publish();
+    while (__atomic_load_n(&s_deferred_tail, __ATOMIC_ACQUIRE) != s_deferred_wr)
+    {
+        ssd1306_deferred_yield();
+    }
+}
+
+static void ssd1306_deferred_close(void)
+{
+    ssd1306_deferredDetach();
+    if (ssd1306_intf.close)
+    {
+        ssd1306_intf.close();
+    }
+}
+
+uint8_t ssd1306_deferredDataMode(uint8_t mode)
+{
+    if (!s_deferred_active)
+    {
+        return 0;
+    }
+    ssd1306_deferred_put_op(DEFERRED_DATA_MODE, 2, mode);
+    return 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//                         BUS THREAD
+/////////////////////////////////////////////////////////////////////////////////
+
+static void ssd1306_deferred_sleep(uint32_t tail)
+{
+#ifdef DEFERRED_FREERTOS
+    __atomic_store_n(&s_deferred_sleeping, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&s_deferred_head, __ATOMIC_SEQ_CST) == tail &&
+        __atomic_load_n(&s_deferred_running, __ATOMIC_SEQ_CST))
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    __atomic_store_n(&s_deferred_sleeping, 0, __ATOMIC_SEQ_CST);
+#elif defined(DEFERRED_PICO)
+    /* Producer sets event by __sev() after publishing new records */
+    __atomic_store_n(&s_deferred_sleeping, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&s_deferred_head, __ATOMIC_SEQ_CST) == tail &&
+           __atomic_load_n(&s_deferred_running, __ATOMIC_SEQ_CST))
+    {
+        __wfe();
+    }
+    __atomic_store_n(&s_deferred_sleeping, 0, __ATOMIC_SEQ_CST);
+#else
+    pthread_mutex_lock(&s_deferred_mutex);
+    __atomic_store_n(&s_deferred_sleeping, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&s_deferred_head, __ATOMIC_SEQ_CST) == tail &&
+        __atomic_load_n(&s_deferred_running, __ATOMIC_SEQ_CST))
+    {
+        pthread_cond_wait(&s_deferred_cond, &s_deferred_mutex);
+    }
+    __atomic_store_n(&s_deferred_sleeping, 0, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&s_deferred_mutex);
+#endif
+}
+
+static void ssd1306_deferred_process(void)
+{
+    uint32_t tail = s_deferred_tail;
+    for(;;)
+    {
+        uint32_t head = __atomic_load_n(&s_deferred_head, __ATOMIC_ACQUIRE);
+        if ( tail == head )
+        {
+            if ( !__atomic_load_n(&s_deferred_running, __ATOMIC_SEQ_CST) )
+            {
+                break;
+            }
+            ssd1306_deferred_sleep(tail);
+            continue;
+        }
+        switch ( s_deferred_queue[tail & DEFERRED_MASK] )
+        {
+        case DEFERRED_START:
+            s_deferred_intf.start();
+            tail++;
+            break;
+        case DEFERRED_STOP:
+            /* Keep spi transaction open, if the next one is already waiting */
+            if ( s_deferred_intf.spi && tail + 1 != head &&
+                 s_deferred_queue[(tail + 1) & DEFERRED_MASK] == DEFERRED_START )
+            {
+                tail += 2;
+                break;
+            }
+            s_deferred_intf.stop();
+            tail++;
+            break;
+        case DEFERRED_DATA_MODE:
+            /* Same dispatcher as direct path, so 8080 bus and 3-wire spi work too */
+            ssd1306_spiApplyDataMode(s_deferred_queue[(tail + 1) & DEFERRED_MASK],
+                                     s_deferred_intf.wait);
+            tail += 2;
+            break;
+        case DEFERRED_SEND:
+        {
+            uint16_t len = s_deferred_queue[(tail + 1) & DEFERRED_MASK] |
+                           (s_deferred_queue[(tail + 2) & DEFERRED_MASK] << 8);
+            uint32_t pos = (tail + 3) & DEFERRED_MASK;
+            uint32_t part = CONFIG_DEFERRED_INTF_QUEUE_SIZE - pos;
+            if ( part > len ) part = len;
+            s_deferred_intf.send_buffer(&s_deferred_queue[pos], part);
+            if ( len > part )
+            {
+                s_deferred_intf.send_buffer(&s_deferred_queue[0], len - part);
+            }
+            tail += 3 + len;
+            break;
+        }
+        default:
+            break;
+        }
+        __atomic_store_n(&s_deferred_tail, tail, __ATOMIC_RELEASE);
+    }
+}
+
+#ifdef DEFERRED_FREERTOS
+static void ssd1306_deferred_task(void *arg)
+{
+    ssd1306_deferred_process();
+    __atomic_store_n(&s_deferred_stopped, 1, __ATOMIC_SEQ_CST);
+    /* The task is deleted by ssd1306_deferredDetach() */
+    for(;;)
+    {
+        vTaskSuspend(NULL);
+    }
+}
+#elif defined(DEFERRED_PICO)
+static void ssd1306_deferred_core1(void)
+{
+    ssd1306_deferred_process();
+    __atomic_store_n(&s_deferred_stopped, 1, __ATOMIC_SEQ_CST);
+    /* Core 1 is reset by ssd1306_deferredDetach() */
+    for(;;)
+    {
+        __wfe();
+    }
+}
+#else
+static void *ssd1306_deferred_thread(void *arg)
+{
+    ssd1306_deferred_process();
+    return NULL;
+}
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////
+//                         API
+/////////////////////////////////////////////////////////////////////////////////
+
+int ssd1306_deferredAttach(void)
+{
+    if (s_deferred_active)
+    {
+        return 0;
+    }
+    s_deferred_head = 0;
+    s_deferred_tail = 0;
+    s_deferred_wr = 0;
+    s_deferred_rec_open = 0;
+    s_deferred_running = 1;
+#ifdef DEFERRED_FREERTOS
+    s_deferred_stopped = 0;
+    if ( xTaskCreate(ssd1306_deferred_task, "ssd1306_bus", 2048, NULL,
+                     uxTaskPriorityGet(NULL), &s_deferred_task) != pdPASS )
+    {
+        return -1;
+    }
+#elif defined(DEFERRED_PICO)
+    s_deferred_stopped = 0;
+    multicore_reset_core1();
+    multicore_launch_core1(ssd1306_deferred_core1);
+#else
+    if ( pthread_create(&s_deferred_thread, NULL, ssd1306_deferred_thread, NULL) != 0 )
+    {
+        return -1;
+    }
+#endif
+    s_deferred_intf = ssd1306_intf;
+    ssd1306_intf.start = ssd1306_deferred_start;
+    ssd1306_intf.stop = ssd1306_deferred_stop;
+    ssd1306_intf.send = ssd1306_deferred_send;
+    ssd1306_intf.send_buffer = ssd1306_deferred_send_buffer;
+    /* Data are copied to the queue, so the buffer can be reused right after the call */
+    ssd1306_intf.send_buffer_async = ssd1306_deferred_send_buffer;
+    ssd1306_intf.wait = ssd1306_deferred_wait;
+    ssd1306_intf.close = ssd1306_deferred_close;
+    s_deferred_active = 1;
+    return 0;
+}
+
+void ssd1306_deferredDetach(void)
+{
+    if (!s_deferred_active)
+    {
+        return;
+    }
+    ssd1306_deferred_wait();
+    s_deferred_active = 0;
+    __atomic_store_n(&s_deferred_running, 0, __ATOMIC_SEQ_CST);
+#ifdef DEFERRED_FREERTOS
+    xTaskNotifyGive(s_deferred_task);
+    while (!__atomic_load_n(&s_deferred_stopped, __ATOMIC_SEQ_CST))
+    {
+        vTaskDelay(1);
+    }
+    vTaskDelete(s_deferred_task);
+#elif defined(DEFERRED_PICO)
+    __sev();
+    while (!__atomic_load_n(&s_deferred_stopped, __ATOMIC_SEQ_CST))
+    {
+        tight_loop_contents();
+    }
+    multicore_reset_core1();
+#else
+    pthread_mutex_lock(&s_deferred_mutex);
+    pthread_cond_signal(&s_deferred_cond);
+    pthread_mutex_unlock(&s_deferred_mutex);
+    pthread_join(s_deferred_thread, NULL);
+#endif
+    if (ssd1306_intf.send == ssd1306_deferred_send)
+    {
+        ssd1306_intf = s_deferred_intf;
+    }
+}
+
+#endif
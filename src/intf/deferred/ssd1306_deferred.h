@@ -0,0 +1,98 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/**
+ * @file ssd1306_deferred.h Deferred interface: display transfers in separate bus thread
+ */
+
+#ifndef _SSD1306_DEFERRED_H_
+#define _SSD1306_DEFERRED_H_
+
+#include "ssd1306_hal/io.h"
+
+#if defined(CONFIG_DEFERRED_INTF_AVAILABLE) && defined(CONFIG_DEFERRED_INTF_ENABLE)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @ingroup LCD_HW_INTERFACE_API
+ * @{
+ */
+
+#ifndef CONFIG_DEFERRED_INTF_QUEUE_SIZE
+/** Size of deferred interface queue in bytes, must be power of 2 */
+#define CONFIG_DEFERRED_INTF_QUEUE_SIZE   4096
+#endif
+
+/**
+ * @brief Moves display transfers to separate bus thread.
+ *
+ * Wraps current interface functions: start(), stop(), send(), send_buffer() and
+ * D/C line switching are recorded to lock-free single-producer single-consumer queue,
+ * and return immediately. Bus thread (pthread on Linux, FreeRTOS task on ESP32, core 1
+ * on RP2040) takes records from the queue and sends them via original interface
+ * functions. Bytes, sent by consecutive send() and send_buffer() calls, are passed to
+ * bus thread as single send_buffer() call. On spi interface stop() and start() of consecutive transactions
+ * are skipped, if both are already in the queue.
+ * Draw functions wait for the bus only if queue is full. ssd1306_intf.wait() waits
+ * until the queue is empty, so it can be used as frame end barrier.
+ *
+ * @return 0 on success, -1 if bus thread cannot be started
+ *
+ * @note call this function after display initialization, and draw to the display from
+ *       single thread only. If display contexts are used, only one display can be
+ *       deferred at a time: ssd1306_contextSelect() waits for the queue to become empty.
+ *       On RP2040 core 1 must not be used by the application: it is reset by
+ *       ssd1306_deferredAttach() and ssd1306_deferredDetach().
+ */
+int ssd1306_deferredAttach(void);
+
+/**
+ * @brief Stops bus thread and restores original interface functions.
+ *
+ * Waits until all recorded transfers are sent, stops bus thread and restores
+ * interface functions, replaced by ssd1306_deferredAttach().
+ */
+void ssd1306_deferredDetach(void);
+
+/**
+ * Records D/C line switching to the queue. Called by ssd1306_spiDataMode().
+ * @param mode - 0 for command mode, 1 for data mode
+ * @return 1 if switching is recorded, 0 if deferred interface is not active.
+ */
+uint8_t ssd1306_deferredDataMode(uint8_t mode);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif /* _SSD1306_DEFERRED_H_ */
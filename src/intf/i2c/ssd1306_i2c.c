@@ -27,10 +27,13 @@
 
 void ssd1306_i2cInitEx(int8_t scl, int8_t sda, int8_t sa)
 {
-#if defined(CONFIG_PLATFORM_I2C_AVAILABLE) && defined(CONFIG_PLATFORM_I2C_ENABLE)
+#if defined(CONFIG_USI_I2C_AVAILABLE) && defined(CONFIG_USI_I2C_ENABLE)
+    ssd1306_i2cInit_Usi(sa);
+#elif defined(CONFIG_PLATFORM_I2C_AVAILABLE) && defined(CONFIG_PLATFORM_I2C_ENABLE)
     ssd1306_platform_i2cConfig_t cfg;
     cfg.scl = scl;
     cfg.sda = sda;
+    cfg.chunk = 0;
     ssd1306_platform_i2cInit(-1, sa, &cfg);
 #elif defined(CONFIG_TWI_I2C_AVAILABLE) && defined(CONFIG_TWI_I2C_ENABLE)
     ssd1306_i2cConfigure_Twi(0);
@@ -40,6 +43,9 @@ void ssd1306_i2cInitEx(int8_t scl, int8_t sda, int8_t sa)
 #else
     #warning "ssd1306 library: no i2c support for the target platform"
 #endif
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+    ssd1306_intfStatsAttach();
+#endif
 }
 
 void ssd1306_i2cInit()
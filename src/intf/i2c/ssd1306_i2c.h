@@ -32,6 +32,7 @@
 #include "ssd1306_i2c_conf.h"
 #include "ssd1306_i2c_embedded.h"
 #include "ssd1306_i2c_twi.h"
+#include "ssd1306_i2c_usi.h"
 
 #ifdef __cplusplus
 extern "C" {
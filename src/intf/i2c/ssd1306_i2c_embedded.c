@@ -36,8 +36,15 @@
  * For ATmega328p, it is PORTC, which corresponds to Analog inputs/outputs
  */
 
+#if defined(CONFIG_SOFTWARE_I2C_SCL_BIT) && defined(CONFIG_SOFTWARE_I2C_SDA_BIT)
+/* Constant masks let compiler use sbi/cbi instructions for each bus edge */
+#define SSD1306_I2C_FIXED_PINS
+#define s_scl (1<<CONFIG_SOFTWARE_I2C_SCL_BIT)
+#define s_sda (1<<CONFIG_SOFTWARE_I2C_SDA_BIT)
+#else
 static uint8_t s_scl = (1<<SSD1306_SCL);
 static uint8_t s_sda = (1<<SSD1306_SDA);
+#endif
 static uint8_t s_sa  = SSD1306_SA;
 
 #if defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__)
@@ -97,6 +104,8 @@ static uint8_t s_sa  = SSD1306_SA;
 //#define DIGITAL_WRITE_LOW(DREG, PREG, BIT)  { DREG |= (1 << BIT); PREG &= ~(1 << BIT); }
 #define DIGITAL_WRITE_LOW(DREG, PREG, BIT)  { DREG |= BIT; PREG &= ~BIT; }
 
+#if !defined(CONFIG_SOFTWARE_I2C_FAST_ENABLE)
+
 static uint8_t oldSREG;
 static uint8_t interruptsOff = 0;
 
@@ -170,20 +179,126 @@ static void ssd1306_i2cStop_Embedded(void)
     }
 }
 
+#else
+
+#ifndef CONFIG_SOFTWARE_I2C_FAST_DELAY
+    #define CONFIG_SOFTWARE_I2C_FAST_DELAY  0
+#endif
+
+/*
+ * Fast mode doesn't touch PORT register while sending the data: released line is
+ * pulled up by external resistors, and each bus edge is single write to DDR register.
+ * Values, written to DDR, are precalculated for each byte, so interrupts must remain
+ * disabled while the byte is being sent.
+ */
+#define I2C_FAST_BIT(mask) \
+    { \
+        low = (data & mask) ? low1 : low0; \
+        DDR_REG = low; \
+        ssd1306_delay(CONFIG_SOFTWARE_I2C_FAST_DELAY); \
+        DDR_REG = low & high; \
+        ssd1306_delay(CONFIG_SOFTWARE_I2C_FAST_DELAY); \
+        DDR_REG = low; \
+    }
+
+/**
+ * Inputs: SCL is LOW, SDA is has no meaning
+ * Outputs: SCL is LOW
+ */
+static void ssd1306_i2cSendByte_Fast(uint8_t data)
+{
+    uint8_t sreg = SREG;
+    cli();
+    uint8_t high = ~s_scl;
+    uint8_t low1 = (DDR_REG | s_scl) & ~s_sda;
+    uint8_t low0 = low1 | s_sda;
+    uint8_t low;
+    I2C_FAST_BIT(0x80);
+    I2C_FAST_BIT(0x40);
+    I2C_FAST_BIT(0x20);
+    I2C_FAST_BIT(0x10);
+    I2C_FAST_BIT(0x08);
+    I2C_FAST_BIT(0x04);
+    I2C_FAST_BIT(0x02);
+    I2C_FAST_BIT(0x01);
+#if defined(CONFIG_SOFTWARE_I2C_FAST_NO_ACK)
+    // SDA is not released for confirmation impulse: lines are open-drain, so
+    // display can pull SDA low at the same time without any conflict.
+#else
+    low = low1;
+    DDR_REG = low;
+    ssd1306_delay(CONFIG_SOFTWARE_I2C_FAST_DELAY);
+#endif
+    DDR_REG = low & high;
+    ssd1306_delay(CONFIG_SOFTWARE_I2C_FAST_DELAY);
+    DDR_REG = low;
+    SREG = sreg;
+}
+
+static void ssd1306_i2cSendBytes_Fast(const uint8_t *buffer, uint16_t size)
+{
+    while (size--)
+    {
+        ssd1306_i2cSendByte_Fast(*buffer);
+        buffer++;
+    }
+}
+
+/**
+ * SCL remains LOW on EXIT, Low SDA means start transmission
+ */
+static void ssd1306_i2cStart_Fast(void)
+{
+    uint8_t sreg = SREG;
+    cli();
+    PORT_REG &= ~(s_scl | s_sda);                    // Disable internal pull-ups
+    DDR_REG |= s_sda;                                // Set to LOW
+    ssd1306_delay(CONFIG_SOFTWARE_I2C_FAST_DELAY);
+    DDR_REG |= s_scl;                                // Set to LOW
+    SREG = sreg;
+    ssd1306_i2cSendByte_Fast((s_sa << 1) | 0);
+}
+
+static void ssd1306_i2cStop_Fast(void)
+{
+    uint8_t sreg = SREG;
+    cli();
+    DDR_REG |= s_sda;                                // Set to LOW
+    ssd1306_delay(CONFIG_SOFTWARE_I2C_FAST_DELAY);
+    DDR_REG &= ~s_scl;                               // Set to HIGH
+    ssd1306_delay(CONFIG_SOFTWARE_I2C_FAST_DELAY);
+    DDR_REG &= ~s_sda;                               // Set to HIGH
+    SREG = sreg;
+}
+
+#endif
+
 static void ssd1306_i2cClose_Embedded()
 {
 }
 
 void ssd1306_i2cInit_Embedded(int8_t scl, int8_t sda, uint8_t sa)
 {
+#if !defined(SSD1306_I2C_FIXED_PINS)
     if (scl>=0) s_scl = (1<<scl);
     if (sda>=0) s_sda = (1<<sda);
+#else
+    (void)scl;
+    (void)sda;
+#endif
     if (sa)  s_sa  = sa;
     ssd1306_intf.spi = 0;
+#if defined(CONFIG_SOFTWARE_I2C_FAST_ENABLE)
+    ssd1306_intf.start = ssd1306_i2cStart_Fast;
+    ssd1306_intf.stop = ssd1306_i2cStop_Fast;
+    ssd1306_intf.send = ssd1306_i2cSendByte_Fast;
+    ssd1306_intf.send_buffer = ssd1306_i2cSendBytes_Fast;
+#else
     ssd1306_intf.start = ssd1306_i2cStart_Embedded;
     ssd1306_intf.stop = ssd1306_i2cStop_Embedded;
     ssd1306_intf.send = ssd1306_i2cSendByte_Embedded;
     ssd1306_intf.send_buffer = ssd1306_i2cSendBytes_Embedded;
+#endif
     ssd1306_intf.close = ssd1306_i2cClose_Embedded;
 }
 
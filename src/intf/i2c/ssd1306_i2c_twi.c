@@ -37,6 +37,8 @@
 
 static uint8_t s_sa = SSD1306_SA;
 
+#if !defined(CONFIG_TWI_I2C_ISR_ENABLE)
+
 static uint8_t ssd1306_twi_start(void)
 {
     uint8_t twst;
@@ -108,6 +110,8 @@ static void ssd1306_i2cStop_Twi(void)
     ssd1306_twi_stop();
 }
 
+#endif
+
 void ssd1306_i2cConfigure_Twi(uint8_t arg)
 {
 #if defined(__AVR_ATmega328P__)
@@ -122,6 +126,8 @@ void ssd1306_i2cConfigure_Twi(uint8_t arg)
     TWCR = (1 << TWEN) | (1 << TWEA);
 }
 
+#if !defined(CONFIG_TWI_I2C_ISR_ENABLE)
+
 static void ssd1306_i2cSendByte_Twi(uint8_t data)
 {
     for(;;)
@@ -152,9 +158,186 @@ static void ssd1306_i2cSendBytes_Twi(const uint8_t *buffer, uint16_t size)
     }
 }
 
+#else
+
+#include <avr/interrupt.h>
+
+#ifndef CONFIG_TWI_I2C_QUEUE_SIZE
+    #define CONFIG_TWI_I2C_QUEUE_SIZE  32
+#endif
+
+#define TWI_QUEUE_MASK   (CONFIG_TWI_I2C_QUEUE_SIZE - 1)
+/* Queue entry flags. Entry without flags is data byte. */
+#define TWI_ENTRY_START  0x0100
+#define TWI_ENTRY_STOP   0x0200
+#define TWI_ENTRY_ASYNC  0x0400
+
+#define TWI_CONTINUE     ((1<<TWINT) | (1<<TWEN) | (1<<TWIE))
+
+/*
+ * Queue is written by the main code only (s_twi_head), and read by TWI interrupt
+ * handler only (s_twi_tail). Start entry keeps slave address, async entry means that
+ * the bytes must be taken from s_twi_async_buffer.
+ */
+static volatile uint16_t s_twi_queue[CONFIG_TWI_I2C_QUEUE_SIZE];
+static volatile uint8_t s_twi_head = 0;
+static volatile uint8_t s_twi_tail = 0;
+static volatile uint8_t s_twi_busy = 0;
+static const uint8_t * volatile s_twi_async_buffer;
+static volatile uint16_t s_twi_async_size = 0;
+static uint8_t s_twi_async_active = 0;
+static uint8_t s_twi_address;
+static uint8_t s_twi_last;
+static uint8_t s_twi_addressing;
+static uint8_t s_twi_resend;
+
+static inline void ssd1306_twi_write(uint8_t data)
+{
+    s_twi_last = data;
+    s_twi_addressing = 0;
+    TWDR = data;
+    TWCR = TWI_CONTINUE;
+}
+
+/* Must be called with interrupts disabled */
+static void ssd1306_twi_next(void)
+{
+    for(;;)
+    {
+        if (s_twi_async_active)
+        {
+            if (s_twi_async_size)
+            {
+                ssd1306_twi_write(*s_twi_async_buffer);
+                s_twi_async_buffer++;
+                s_twi_async_size--;
+                return;
+            }
+            s_twi_async_active = 0;
+        }
+        if (s_twi_tail == s_twi_head)
+        {
+            /* TWINT remains set: SCL is held low until new bytes are queued */
+            s_twi_busy = 0;
+            TWCR = (1<<TWEN);
+            return;
+        }
+        uint16_t entry = s_twi_queue[s_twi_tail];
+        s_twi_tail = (s_twi_tail + 1) & TWI_QUEUE_MASK;
+        if (entry & TWI_ENTRY_START)
+        {
+            s_twi_address = entry & 0xFF;
+            TWCR = TWI_CONTINUE | (1<<TWSTA);
+            return;
+        }
+        if (entry & TWI_ENTRY_STOP)
+        {
+            TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWSTO);
+            while (TWCR & (1<<TWSTO));
+            continue;
+        }
+        if (entry & TWI_ENTRY_ASYNC)
+        {
+            s_twi_async_active = 1;
+            continue;
+        }
+        ssd1306_twi_write(entry);
+        return;
+    }
+}
+
+ISR(TWI_vect)
+{
+    uint8_t twsr = TWSR & 0xF8;
+    if (twsr == TW_MT_ARB_LOST)
+    {
+        /* Restart transaction and send lost byte again */
+        s_twi_resend = !s_twi_addressing;
+        TWCR = TWI_CONTINUE | (1<<TWSTA);
+    }
+    else if ((twsr == TW_START) || (twsr == TW_REP_START))
+    {
+        s_twi_addressing = 1;
+        TWDR = s_twi_address;
+        TWCR = TWI_CONTINUE;
+    }
+    else if (s_twi_resend)
+    {
+        s_twi_resend = 0;
+        ssd1306_twi_write(s_twi_last);
+    }
+    else
+    {
+        /* Errors are ignored, since API functions have void type */
+        ssd1306_twi_next();
+    }
+}
+
+static void ssd1306_twi_push(uint16_t entry)
+{
+    uint8_t head = (s_twi_head + 1) & TWI_QUEUE_MASK;
+    while (head == s_twi_tail);
+    s_twi_queue[s_twi_head] = entry;
+    s_twi_head = head;
+    if (!s_twi_busy)
+    {
+        uint8_t sreg = SREG;
+        cli();
+        if (!s_twi_busy)
+        {
+            s_twi_busy = 1;
+            ssd1306_twi_next();
+        }
+        SREG = sreg;
+    }
+}
+
+static void ssd1306_i2cStart_Twi(void)
+{
+    ssd1306_twi_push(TWI_ENTRY_START | (s_sa << 1));
+}
+
+static void ssd1306_i2cStop_Twi(void)
+{
+    ssd1306_twi_push(TWI_ENTRY_STOP);
+}
+
+static void ssd1306_i2cSendByte_Twi(uint8_t data)
+{
+    ssd1306_twi_push(data);
+}
+
+static void ssd1306_i2cSendBytes_Twi(const uint8_t *buffer, uint16_t size)
+{
+    while (size--)
+    {
+        ssd1306_twi_push(*buffer);
+        buffer++;
+    }
+}
+
+static void ssd1306_i2cSendBytesAsync_Twi(const uint8_t *buffer, uint16_t size)
+{
+    /* Only one buffer can be sent in background */
+    while (s_twi_async_size);
+    s_twi_async_buffer = buffer;
+    s_twi_async_size = size;
+    ssd1306_twi_push(TWI_ENTRY_ASYNC);
+}
+
+static void ssd1306_i2cWait_Twi(void)
+{
+    while (s_twi_busy);
+}
+
+#endif
+
 
 static void ssd1306_i2cClose_Twi()
 {
+#if defined(CONFIG_TWI_I2C_ISR_ENABLE)
+    ssd1306_i2cWait_Twi();
+#endif
 }
 
 void ssd1306_i2cInit_Twi(uint8_t sa)
@@ -166,6 +349,10 @@ void ssd1306_i2cInit_Twi(uint8_t sa)
     ssd1306_intf.send = ssd1306_i2cSendByte_Twi;
     ssd1306_intf.send_buffer = ssd1306_i2cSendBytes_Twi;
     ssd1306_intf.close = ssd1306_i2cClose_Twi;
+#if defined(CONFIG_TWI_I2C_ISR_ENABLE)
+    ssd1306_intf.send_buffer_async = ssd1306_i2cSendBytesAsync_Twi;
+    ssd1306_intf.wait = ssd1306_i2cWait_Twi;
+#endif
 }
 
 #endif
@@ -0,0 +1,149 @@
+/*
+    MIT License
+
+    Copyright (c) 2018, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_i2c_usi.h"
+#include "intf/ssd1306_interface.h"
+#include "ssd1306_i2c.h"
+
+#if defined(CONFIG_USI_I2C_AVAILABLE) && defined(CONFIG_USI_I2C_ENABLE)
+
+#if defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__)
+    #define DDR_USI      DDRB
+    #define PORT_USI     PORTB
+    #define PIN_USI      PINB
+    #define PIN_USI_SDA  PINB0
+    #define PIN_USI_SCL  PINB2
+#else // For AttinyX4 controllers
+    #define DDR_USI      DDRA
+    #define PORT_USI     PORTA
+    #define PIN_USI      PINA
+    #define PIN_USI_SDA  PINA6
+    #define PIN_USI_SCL  PINA4
+#endif
+
+/* Fast mode (400kHz) timings in microseconds: SCL low period and SCL high period */
+#ifndef USI_I2C_T2
+    #define USI_I2C_T2   1.3
+#endif
+#ifndef USI_I2C_T4
+    #define USI_I2C_T4   0.6
+#endif
+
+/* Clear all flags and set counter to shift 8 bits (16 clock edges) */
+#define USISR_8BIT   ((1<<USISIF) | (1<<USIOIF) | (1<<USIPF) | (1<<USIDC) | (0x0 << USICNT0))
+/* Clear all flags and set counter to shift 1 bit (2 clock edges) */
+#define USISR_1BIT   ((1<<USISIF) | (1<<USIOIF) | (1<<USIPF) | (1<<USIDC) | (0xE << USICNT0))
+
+static uint8_t s_sa = SSD1306_SA;
+
+/**
+ * Generates clock pulses until USI counter overflows.
+ * Inputs: SCL is LOW
+ * Outputs: SCL is LOW, SDA is released
+ */
+static void ssd1306_usiI2cTransfer(uint8_t usisr)
+{
+    const uint8_t strobe = (1<<USIWM1) | (1<<USICS1) | (1<<USICLK) | (1<<USITC);
+    USISR = usisr;
+    do
+    {
+        _delay_us(USI_I2C_T2);
+        USICR = strobe;                              // Positive SCL edge
+        while ( !(PIN_USI & (1<<PIN_USI_SCL)) );     // Wait for SCL to go high
+        _delay_us(USI_I2C_T4);
+        USICR = strobe;                              // Negative SCL edge
+    } while ( !(USISR & (1<<USIOIF)) );
+    _delay_us(USI_I2C_T2);
+    USIDR = 0xFF;
+}
+
+static void ssd1306_i2cSendByte_Usi(uint8_t data)
+{
+    USIDR = data;
+    ssd1306_usiI2cTransfer(USISR_8BIT);
+    /* Release SDA for confirmation impulse. ssd1306 library doesn't check ack */
+    DDR_USI &= ~(1<<PIN_USI_SDA);
+    ssd1306_usiI2cTransfer(USISR_1BIT);
+    DDR_USI |= (1<<PIN_USI_SDA);
+}
+
+static void ssd1306_i2cSendBytes_Usi(const uint8_t *buffer, uint16_t size)
+{
+    while (size--)
+    {
+        ssd1306_i2cSendByte_Usi(*buffer);
+        buffer++;
+    }
+}
+
+/**
+ * SCL is LOW on EXIT, Low SDA means start transmission
+ */
+static void ssd1306_i2cStart_Usi(void)
+{
+    PORT_USI |= (1<<PIN_USI_SCL);
+    while ( !(PIN_USI & (1<<PIN_USI_SCL)) );
+    _delay_us(USI_I2C_T2);
+    PORT_USI &= ~(1<<PIN_USI_SDA);
+    _delay_us(USI_I2C_T4);
+    PORT_USI &= ~(1<<PIN_USI_SCL);
+    /* SDA is controlled by USI data register from now */
+    PORT_USI |= (1<<PIN_USI_SDA);
+    ssd1306_i2cSendByte_Usi((s_sa << 1) | 0);
+}
+
+static void ssd1306_i2cStop_Usi(void)
+{
+    PORT_USI &= ~(1<<PIN_USI_SDA);
+    PORT_USI |= (1<<PIN_USI_SCL);
+    while ( !(PIN_USI & (1<<PIN_USI_SCL)) );
+    _delay_us(USI_I2C_T4);
+    PORT_USI |= (1<<PIN_USI_SDA);
+    _delay_us(USI_I2C_T2);
+}
+
+static void ssd1306_i2cClose_Usi()
+{
+    USICR = 0;
+}
+
+void ssd1306_i2cInit_Usi(uint8_t sa)
+{
+    if (sa) s_sa = sa;
+    /* Lines are released */
+    PORT_USI |= (1<<PIN_USI_SDA) | (1<<PIN_USI_SCL);
+    DDR_USI  |= (1<<PIN_USI_SDA) | (1<<PIN_USI_SCL);
+    USIDR = 0xFF;
+    /* Two-wire mode, software clock strobe */
+    USICR = (1<<USIWM1) | (1<<USICS1) | (1<<USICLK);
+    USISR = USISR_8BIT;
+    ssd1306_intf.spi = 0;
+    ssd1306_intf.start = ssd1306_i2cStart_Usi;
+    ssd1306_intf.stop = ssd1306_i2cStop_Usi;
+    ssd1306_intf.send = ssd1306_i2cSendByte_Usi;
+    ssd1306_intf.send_buffer = ssd1306_i2cSendBytes_Usi;
+    ssd1306_intf.close = ssd1306_i2cClose_Usi;
+}
+
+#endif
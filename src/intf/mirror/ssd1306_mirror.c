@@ -0,0 +1,306 @@
+/*
+    MIT License
+
+    Copyright (c) 2018, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_mirror.h"
+#include "intf/ssd1306_interface.h"
+#include "lcd/lcd_common.h"
+
+#if defined(CONFIG_NET_MIRROR_AVAILABLE) && defined(CONFIG_NET_MIRROR_ENABLE)
+
+#if defined(ESP_PLATFORM)
+#include "lwip/sockets.h"
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+#ifndef SSD1306_MIRROR_BUFFER_SIZE
+/** Number of pixel bytes, collected before sending udp packet */
+#define SSD1306_MIRROR_BUFFER_SIZE  512
+#endif
+
+#define MIRROR_HEADER_SIZE  20
+
+static ssd1306_interface_t s_mirror_intf;
+static ssd1306_lcd_t s_mirror_lcd;
+static int s_mirror_socket = -1;
+static struct sockaddr_in s_mirror_addr;
+static uint8_t s_mirror_bits;
+/* Set if color lcd is switched to ssd1306 compatible mode */
+static uint8_t s_mirror_compat;
+/* Set while bytes, sent to interface, are pixels of current block */
+static uint8_t s_mirror_capture;
+static uint16_t s_mirror_x;
+static uint16_t s_mirror_y;
+static uint16_t s_mirror_w;
+static uint32_t s_mirror_offset;
+static uint16_t s_mirror_len;
+static uint8_t s_mirror_data[SSD1306_MIRROR_BUFFER_SIZE];
+/* Compression adds 1 byte per 128 literal units in the worst case */
+static uint8_t s_mirror_packet[MIRROR_HEADER_SIZE + SSD1306_MIRROR_BUFFER_SIZE + 2 +
+                               SSD1306_MIRROR_BUFFER_SIZE / 128 + 1];
+
+static uint8_t *ssd1306_mirror_put16(uint8_t *p, uint16_t value)
+{
+    *p++ = value & 0xFF;
+    *p++ = value >> 8;
+    return p;
+}
+
+/*
+ * Compresses data in the same format as ssd1306_drawCompressedBitmap() (see tools/format.txt).
+ * Unit is 1 byte for monochrome and RGB8 data, and 2 bytes for RGB565 data.
+ */
+static uint8_t *ssd1306_mirror_pack(uint8_t *p, const uint8_t *src, uint16_t len, uint8_t unit)
+{
+    uint16_t units = (len + unit - 1) / unit;
+    while (units)
+    {
+        uint8_t count = 1;
+        while ((count < units) && (count < 128) && !memcmp(&src[count * unit], src, unit))
+        {
+            count++;
+        }
+        if (count >= 3)
+        {
+            *p++ = 0x80 | (count - 1);
+            memcpy(p, src, unit);
+            p += unit;
+        }
+        else
+        {
+            /* Collect literal units until next run of 3 equal units */
+            count = 0;
+            while ((count < units) && (count < 128))
+            {
+                if ((count + 2 < units) && !memcmp(&src[count * unit], &src[(count + 1) * unit], unit) &&
+                    !memcmp(&src[count * unit], &src[(count + 2) * unit], unit))
+                {
+                    break;
+                }
+                count++;
+            }
+            *p++ = count - 1;
+            memcpy(p, src, count * unit);
+            p += count * unit;
+        }
+        src += count * unit;
+        units -= count;
+    }
+    return p;
+}
+
+static void ssd1306_mirror_flush(void)
+{
+    if (!s_mirror_len)
+    {
+        return;
+    }
+    uint8_t *p = s_mirror_packet;
+    *p++ = 'S';
+    *p++ = 'M';
+    *p++ = s_mirror_bits;
+    *p++ = 0;
+    p = ssd1306_mirror_put16(p, ssd1306_lcd.width);
+    p = ssd1306_mirror_put16(p, ssd1306_lcd.height);
+    p = ssd1306_mirror_put16(p, s_mirror_x);
+    p = ssd1306_mirror_put16(p, s_mirror_y);
+    p = ssd1306_mirror_put16(p, s_mirror_w);
+    p = ssd1306_mirror_put16(p, s_mirror_offset & 0xFFFF);
+    p = ssd1306_mirror_put16(p, s_mirror_offset >> 16);
+    p = ssd1306_mirror_put16(p, s_mirror_len);
+    p = ssd1306_mirror_pack(p, s_mirror_data, s_mirror_len, s_mirror_bits == 16 ? 2 : 1);
+    sendto(s_mirror_socket, s_mirror_packet, p - s_mirror_packet, MSG_DONTWAIT,
+           (struct sockaddr *)&s_mirror_addr, sizeof(s_mirror_addr));
+    s_mirror_offset += s_mirror_len;
+    s_mirror_len = 0;
+}
+
+static void ssd1306_mirror_capture(const uint8_t *buffer, uint16_t size)
+{
+    while (size)
+    {
+        uint16_t count = sizeof(s_mirror_data) - s_mirror_len;
+        if (count > size)
+        {
+            count = size;
+        }
+        memcpy(&s_mirror_data[s_mirror_len], buffer, count);
+        s_mirror_len += count;
+        buffer += count;
+        size -= count;
+        if (s_mirror_len == sizeof(s_mirror_data))
+        {
+            ssd1306_mirror_flush();
+        }
+    }
+}
+
+static void ssd1306_mirror_stop(void)
+{
+    s_mirror_intf.stop();
+    ssd1306_mirror_flush();
+    s_mirror_capture = 0;
+}
+
+static void ssd1306_mirror_send(uint8_t data)
+{
+    s_mirror_intf.send(data);
+    if (s_mirror_capture)
+    {
+        ssd1306_mirror_capture(&data, 1);
+    }
+}
+
+static void ssd1306_mirror_send_buffer(const uint8_t *buffer, uint16_t size)
+{
+    s_mirror_intf.send_buffer(buffer, size);
+    if (s_mirror_capture)
+    {
+        ssd1306_mirror_capture(buffer, size);
+    }
+}
+
+static void ssd1306_mirror_send_buffer_async(const uint8_t *buffer, uint16_t size)
+{
+    s_mirror_intf.send_buffer_async(buffer, size);
+    if (s_mirror_capture)
+    {
+        ssd1306_mirror_capture(buffer, size);
+    }
+}
+
+static void ssd1306_mirror_set_block(lcduint_t x, lcduint_t y, lcduint_t w)
+{
+    ssd1306_mirror_flush();
+    s_mirror_capture = 0;
+    s_mirror_lcd.set_block(x, y, w);
+    s_mirror_x = x;
+    s_mirror_y = y;
+    s_mirror_w = w ? w : ssd1306_lcd.width - x;
+    s_mirror_offset = 0;
+    s_mirror_capture = !s_mirror_compat;
+}
+
+static void ssd1306_mirror_next_page(void)
+{
+    /* Commands, sent by next_page(), are not pixels, but the block continues */
+    s_mirror_capture = 0;
+    s_mirror_lcd.next_page();
+    s_mirror_capture = !s_mirror_compat;
+}
+
+static void ssd1306_mirror_wrap_lcd(void)
+{
+    s_mirror_lcd.set_block = ssd1306_lcd.set_block;
+    s_mirror_lcd.next_page = ssd1306_lcd.next_page;
+    ssd1306_lcd.set_block = ssd1306_mirror_set_block;
+    ssd1306_lcd.next_page = ssd1306_mirror_next_page;
+}
+
+static void ssd1306_mirror_set_mode(lcd_mode_t mode)
+{
+    ssd1306_lcd.set_block = s_mirror_lcd.set_block;
+    ssd1306_lcd.next_page = s_mirror_lcd.next_page;
+    s_mirror_lcd.set_mode(mode);
+    /* set_mode() usually replaces set_block() and next_page() functions */
+    ssd1306_mirror_wrap_lcd();
+    s_mirror_compat = (mode == LCD_MODE_SSD1306_COMPAT) && (s_mirror_bits != 1);
+}
+
+int ssd1306_mirrorAttach(const char *host, uint16_t port, uint8_t bits)
+{
+    if (ssd1306_intf.send == ssd1306_mirror_send)
+    {
+        return 0;
+    }
+    s_mirror_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (s_mirror_socket < 0)
+    {
+        return -1;
+    }
+    memset(&s_mirror_addr, 0, sizeof(s_mirror_addr));
+    s_mirror_addr.sin_family = AF_INET;
+    s_mirror_addr.sin_port = htons(port);
+    s_mirror_addr.sin_addr.s_addr = inet_addr(host);
+    s_mirror_bits = bits;
+    s_mirror_compat = 0;
+    s_mirror_capture = 0;
+    s_mirror_len = 0;
+
+    s_mirror_intf = ssd1306_intf;
+    ssd1306_intf.stop = ssd1306_mirror_stop;
+    ssd1306_intf.send = ssd1306_mirror_send;
+    ssd1306_intf.send_buffer = ssd1306_mirror_send_buffer;
+    ssd1306_intf.send_buffer_async = ssd1306_mirror_send_buffer_async;
+
+    s_mirror_lcd = ssd1306_lcd;
+    /* lcd drivers often use interface functions directly to send pixels */
+    if (ssd1306_lcd.send_pixels1 == s_mirror_intf.send)
+        ssd1306_lcd.send_pixels1 = ssd1306_mirror_send;
+    if (ssd1306_lcd.send_pixels8 == s_mirror_intf.send)
+        ssd1306_lcd.send_pixels8 = ssd1306_mirror_send;
+    if (ssd1306_lcd.send_pixels_buffer1 == s_mirror_intf.send_buffer)
+        ssd1306_lcd.send_pixels_buffer1 = ssd1306_mirror_send_buffer;
+    /* Hardware accelerated functions change display content without pixels */
+    ssd1306_lcd.draw_line = NULL;
+    ssd1306_lcd.draw_rect = NULL;
+    ssd1306_lcd.copy_block = NULL;
+    ssd1306_lcd.set_column_block = NULL;
+    if (ssd1306_lcd.set_mode)
+    {
+        ssd1306_lcd.set_mode = ssd1306_mirror_set_mode;
+    }
+    ssd1306_mirror_wrap_lcd();
+    return 0;
+}
+
+void ssd1306_mirrorDetach(void)
+{
+    if (ssd1306_intf.send != ssd1306_mirror_send)
+    {
+        return;
+    }
+    ssd1306_mirror_flush();
+    ssd1306_intf = s_mirror_intf;
+    if (ssd1306_lcd.send_pixels1 == ssd1306_mirror_send)
+        ssd1306_lcd.send_pixels1 = s_mirror_intf.send;
+    if (ssd1306_lcd.send_pixels8 == ssd1306_mirror_send)
+        ssd1306_lcd.send_pixels8 = s_mirror_intf.send;
+    if (ssd1306_lcd.send_pixels_buffer1 == ssd1306_mirror_send_buffer)
+        ssd1306_lcd.send_pixels_buffer1 = s_mirror_intf.send_buffer;
+    ssd1306_lcd.draw_line = s_mirror_lcd.draw_line;
+    ssd1306_lcd.draw_rect = s_mirror_lcd.draw_rect;
+    ssd1306_lcd.copy_block = s_mirror_lcd.copy_block;
+    ssd1306_lcd.set_column_block = s_mirror_lcd.set_column_block;
+    ssd1306_lcd.set_mode = s_mirror_lcd.set_mode;
+    ssd1306_lcd.set_block = s_mirror_lcd.set_block;
+    ssd1306_lcd.next_page = s_mirror_lcd.next_page;
+    close(s_mirror_socket);
+    s_mirror_socket = -1;
+}
+
+#endif
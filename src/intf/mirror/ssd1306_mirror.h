@@ -0,0 +1,95 @@
+/*
+    MIT License
+
+    Copyright (c) 2018, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/**
+ * @file ssd1306_mirror.h Mirroring of display content to network
+ */
+
+#ifndef _SSD1306_MIRROR_H_
+#define _SSD1306_MIRROR_H_
+
+#include "ssd1306_hal/io.h"
+
+#if defined(CONFIG_NET_MIRROR_AVAILABLE) && defined(CONFIG_NET_MIRROR_ENABLE)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @ingroup LCD_HW_INTERFACE_API
+ * @{
+ */
+
+/**
+ * @brief Starts mirroring of display updates to remote host.
+ *
+ * Wraps current interface and lcd functions: pixels, sent to display after each
+ * set_block() call, are also sent as UDP packets to remote host. Each packet
+ * describes part of updated rectangle, so only changed areas are transferred.
+ * Packet format (all numbers are little-endian):
+ *    2 bytes 'S', 'M',
+ *    1 byte bits per pixel (1 - ssd1306 page format, 8 - RGB8, 16 - RGB565),
+ *    1 byte flags (reserved, 0),
+ *    2 bytes display width, 2 bytes display height,
+ *    2 bytes left position of block, 2 bytes top position of block
+ *    (in pages for 1-bit mode), 2 bytes width of block,
+ *    4 bytes offset of the packet data from the block start in bytes,
+ *    2 bytes number of data bytes, followed by data, compressed in the format
+ *    of ssd1306_drawCompressedBitmap() (see tools/format.txt), with 2-byte units
+ *    for 16-bit mode.
+ * Use tools/mirror_viewer.py to see mirrored content.
+ *
+ * @param host ip address of remote host, for example "192.168.1.10"
+ * @param port udp port of remote host
+ * @param bits bits per pixel of the data, sent to display controller: 1, 8 or 16.
+ *        For example, ili9341 always receives 16-bit pixels, even from 8-bit functions.
+ * @return 0 on success, -1 if socket cannot be created
+ *
+ * @note call this function after display initialization. Hardware accelerated
+ *       draw_line, draw_rect and copy_block functions, and vertical addressing
+ *       (set_column_block) are disabled while mirroring.
+ *       Color displays are not mirrored in ssd1306 compatible mode.
+ */
+int ssd1306_mirrorAttach(const char *host, uint16_t port, uint8_t bits);
+
+/**
+ * @brief Stops mirroring of display updates.
+ *
+ * Restores interface and lcd functions, replaced by ssd1306_mirrorAttach(),
+ * and closes the socket.
+ */
+void ssd1306_mirrorDetach(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif /* _SSD1306_MIRROR_H_ */
@@ -26,7 +26,10 @@
 #include "ssd1306_spi.h"
 #include "ssd1306_spi_avr.h"
 #include "ssd1306_spi_usi.h"
+#include "ssd1306_spi_usart.h"
+#include "ssd1306_spi_3wire.h"
 #include "intf/ssd1306_interface.h"
+#include "intf/deferred/ssd1306_deferred.h"
 #include "lcd/lcd_common.h"
 #include "ssd1306_hal/io.h"
 
@@ -36,6 +39,9 @@ uint32_t s_ssd1306_spi_clock = 8000000;
 
 void ssd1306_spiInit(int8_t cesPin, int8_t dcPin)
 {
+#ifdef CONFIG_SPI_3WIRE_ENABLE
+    ssd1306_spi3WireDetach();
+#endif
 #if defined(CONFIG_AVR_SPI_AVAILABLE) && defined(CONFIG_AVR_SPI_ENABLE)
     ssd1306_spiInit_avr(cesPin, dcPin);
 #elif defined(CONFIG_PLATFORM_SPI_AVAILABLE) && defined(CONFIG_PLATFORM_SPI_ENABLE)
@@ -45,12 +51,70 @@ void ssd1306_spiInit(int8_t cesPin, int8_t dcPin)
 #else
     #warning "ssd1306 library: no spi support for the target platform"
 #endif
+#ifdef CONFIG_SPI_3WIRE_ENABLE
+    if (dcPin < 0)
+    {
+        ssd1306_spi3WireAttach();
+    }
+#endif
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+    ssd1306_intfStatsAttach();
+#endif
 }
 
 void ssd1306_spiDataMode(uint8_t mode)
 {
-    if (s_ssd1306_dc)
+#if defined(CONFIG_DEFERRED_INTF_AVAILABLE) && defined(CONFIG_DEFERRED_INTF_ENABLE)
+    /* D/C line is switched by bus thread in the order of recorded transfers */
+    if (ssd1306_deferredDataMode(mode))
     {
-        digitalWrite(s_ssd1306_dc, mode ? HIGH : LOW);
+        return;
     }
+#endif
+    ssd1306_spiApplyDataMode(mode, ssd1306_intf.wait);
+}
+
+void ssd1306_spiApplyDataMode(uint8_t mode, void (*wait)(void))
+{
+#if defined(CONFIG_PLATFORM_PARALLEL_AVAILABLE) && defined(CONFIG_PLATFORM_PARALLEL_ENABLE)
+    /* 8080 bus drives D/C itself (gpio controlled by bus driver or FSMC address line) */
+    if (ssd1306_platform_parallelDataMode(mode))
+    {
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+        ssd1306_intfStatsDataMode(mode);
+#endif
+        return;
+    }
+#endif
+#ifdef CONFIG_SPI_3WIRE_ENABLE
+    /* There is no D/C line, D/C bit is sent with each byte */
+    if (ssd1306_spi3WireDataMode(mode))
+    {
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+        ssd1306_intfStatsDataMode(mode);
+#endif
+        return;
+    }
+#endif
+#if defined(CONFIG_PLATFORM_SPI_DC_AVAILABLE) && defined(CONFIG_PLATFORM_SPI_ENABLE)
+    /* D/C line is set by spi bus driver at the boundary of staged blocks */
+    if (ssd1306_platform_spiDataMode(mode))
+    {
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+        ssd1306_intfStatsDataMode(mode);
+#endif
+        return;
+    }
+#endif
+#if !defined(SSD1306_SPI_DC_FIXED)
+    if (s_ssd1306_dc >= 0)
+#endif
+    {
+        /* D/C line must not change while asynchronous transfer is in progress */
+        wait();
+        ssd1306_spiWriteDc(mode);
+    }
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+    ssd1306_intfStatsDataMode(mode);
+#endif
 }
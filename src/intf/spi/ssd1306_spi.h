@@ -55,6 +55,27 @@ extern int8_t s_ssd1306_dc;
  */
 extern uint32_t s_ssd1306_spi_clock;
 
+#if defined(CONFIG_AVR_SPI_DC_PORT) && defined(CONFIG_AVR_SPI_DC_BIT)
+/** D/C line is bound to port bit at compile time, see CONFIG_AVR_SPI_DC_PORT */
+#define SSD1306_SPI_DC_FIXED
+#define ssd1306_spiWriteDc(level) \
+    do { if (level) CONFIG_AVR_SPI_DC_PORT |= (1 << CONFIG_AVR_SPI_DC_BIT); \
+         else CONFIG_AVR_SPI_DC_PORT &= ~(1 << CONFIG_AVR_SPI_DC_BIT); } while (0)
+#else
+/** Sets level of D/C line */
+#define ssd1306_spiWriteDc(level)  digitalWrite(s_ssd1306_dc, (level) ? HIGH : LOW)
+#endif
+
+#if defined(CONFIG_AVR_SPI_CS_PORT) && defined(CONFIG_AVR_SPI_CS_BIT)
+#define ssd1306_spiWriteCs(level) \
+    do { if (level) CONFIG_AVR_SPI_CS_PORT |= (1 << CONFIG_AVR_SPI_CS_BIT); \
+         else CONFIG_AVR_SPI_CS_PORT &= ~(1 << CONFIG_AVR_SPI_CS_BIT); } while (0)
+#else
+/** Sets level of chip select line, if it is used */
+#define ssd1306_spiWriteCs(level) \
+    do { if (s_ssd1306_cs >= 0) digitalWrite(s_ssd1306_cs, (level) ? HIGH : LOW); } while (0)
+#endif
+
 /**
  * @ingroup LCD_HW_INTERFACE_API
  *
@@ -62,7 +83,8 @@ extern uint32_t s_ssd1306_spi_clock;
  * The function automatically selects available type of spi implementation
  * 1. SPI library (ssd1306_spiInit_hw())
  * @param cesPin - pin, controlling chip enable of LCD
- * @param dcPin - pin, controlling data/command mode of LCD
+ * @param dcPin - pin, controlling data/command mode of LCD. If CONFIG_SPI_3WIRE_ENABLE
+ *        is defined, negative value selects 3-wire 9-bit mode without D/C line.
  *
  * @note: after call to this function you need to initialize lcd display.
  */
@@ -77,6 +99,20 @@ void         ssd1306_spiInit(int8_t cesPin, int8_t dcPin);
  */
 void         ssd1306_spiDataMode(uint8_t mode);
 
+/**
+ * @ingroup LCD_HW_INTERFACE_API
+ *
+ * Switches D/C mode on the bus right away, bypassing deferred interface queue:
+ * via 8080 bus driver, 3-wire spi D/C bit, spi bus driver or D/C pin, whichever
+ * is used. ssd1306_spiDataMode() calls it, and deferred interface bus thread
+ * calls it, when recorded mode switch is replayed.
+ * @param mode - 1 data mode
+ *               0 command mode
+ * @param wait function, waiting for asynchronous transfers of the bus to complete
+ *        before D/C pin is changed
+ */
+void         ssd1306_spiApplyDataMode(uint8_t mode, void (*wait)(void));
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,168 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include "ssd1306_spi_3wire.h"
+#include "ssd1306_spi.h"
+#include "intf/ssd1306_interface.h"
+#ifdef SDL_EMULATION
+#include "sdl_core.h"
+#endif
+
+#ifdef CONFIG_SPI_3WIRE_ENABLE
+
+#if defined(__AVR__)
+/* Size of packed bytes buffer: 16 words */
+#define SPI3WIRE_BUFFER_SIZE  18
+#else
+/* Size of packed bytes buffer: 64 words */
+#define SPI3WIRE_BUFFER_SIZE  72
+#endif
+
+/* Functions of spi backend, packed words are sent with */
+static ssd1306_interface_t s_spi;
+static uint8_t s_active = 0;
+/* D/C bit, placed to bit 8 of each word */
+static uint16_t s_dc = 0;
+/* Bits of the last word, which are not put to the buffer yet: less than 8 */
+static uint16_t s_acc;
+static uint8_t s_accBits;
+static uint8_t s_buffer[SPI3WIRE_BUFFER_SIZE];
+static uint8_t s_size;
+
+static void ssd1306_spi3WireFlush(void)
+{
+    if (s_size)
+    {
+        s_spi.send_buffer(s_buffer, s_size);
+        s_size = 0;
+    }
+}
+
+static inline void ssd1306_spi3WirePut(uint8_t data)
+{
+    /* 9 bits are added to less than 8 pending bits, so they fit 16-bit accumulator */
+    s_acc = (s_acc << 9) | s_dc | data;
+    s_accBits += 1;
+    s_buffer[s_size++] = s_acc >> s_accBits;
+    if (s_accBits == 8)
+    {
+        s_buffer[s_size++] = s_acc;
+        s_accBits = 0;
+    }
+    s_acc &= (1 << s_accBits) - 1;
+    if (s_size > SPI3WIRE_BUFFER_SIZE - 2)
+    {
+        ssd1306_spi3WireFlush();
+    }
+}
+
+static void ssd1306_spi3WireStart(void)
+{
+    s_acc = 0;
+    s_accBits = 0;
+    s_size = 0;
+    s_spi.start();
+}
+
+static void ssd1306_spi3WireStop(void)
+{
+    if (s_accBits)
+    {
+        /* Incomplete word is padded with zeroes, controller drops it on chip select release */
+        s_buffer[s_size++] = s_acc << (8 - s_accBits);
+        s_accBits = 0;
+    }
+    ssd1306_spi3WireFlush();
+    s_spi.stop();
+}
+
+static void ssd1306_spi3WireSend(uint8_t data)
+{
+    ssd1306_spi3WirePut(data);
+}
+
+static void ssd1306_spi3WireSendBuffer(const uint8_t *buffer, uint16_t size)
+{
+    while (size--)
+    {
+        ssd1306_spi3WirePut(*buffer++);
+    }
+}
+
+static void ssd1306_spi3WireClose(void)
+{
+    void (*close)(void) = s_spi.close;
+    ssd1306_spi3WireDetach();
+    if (close) close();
+}
+
+void ssd1306_spi3WireAttach(void)
+{
+    if (s_active)
+    {
+        return;
+    }
+    s_spi = ssd1306_intf;
+    s_dc = 0;
+    s_acc = 0;
+    s_accBits = 0;
+    s_size = 0;
+    ssd1306_intf.start = ssd1306_spi3WireStart;
+    ssd1306_intf.stop = ssd1306_spi3WireStop;
+    ssd1306_intf.send = ssd1306_spi3WireSend;
+    ssd1306_intf.send_buffer = ssd1306_spi3WireSendBuffer;
+    /* Words are packed to the internal buffer, so asynchronous transfer gives nothing */
+    ssd1306_intf.send_buffer_async = ssd1306_spi3WireSendBuffer;
+    ssd1306_intf.close = ssd1306_spi3WireClose;
+    s_active = 1;
+#ifdef SDL_EMULATION
+    sdl_set_spi_3wire(1);
+#endif
+}
+
+void ssd1306_spi3WireDetach(void)
+{
+    if (!s_active)
+    {
+        return;
+    }
+    ssd1306_intf = s_spi;
+    s_active = 0;
+#ifdef SDL_EMULATION
+    sdl_set_spi_3wire(0);
+#endif
+}
+
+uint8_t ssd1306_spi3WireDataMode(uint8_t mode)
+{
+    if (!s_active)
+    {
+        return 0;
+    }
+    s_dc = mode ? 0x100 : 0;
+    return 1;
+}
+
+#endif
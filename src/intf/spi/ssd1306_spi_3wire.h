@@ -0,0 +1,80 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+/**
+ * @file ssd1306_spi_3wire.h 3-wire 9-bit SPI mode for displays without D/C line
+ */
+
+#ifndef _SSD1306_SPI_3WIRE_H_
+#define _SSD1306_SPI_3WIRE_H_
+
+#include "ssd1306_hal/io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_SPI_3WIRE_ENABLE
+
+/**
+ * @ingroup LCD_HW_INTERFACE_API
+ *
+ * Switches initialized spi interface to 3-wire 9-bit mode. Each byte is sent as 9-bit
+ * word with D/C bit as most significant bit, so the display needs no D/C line.
+ * Words are packed to bytes (8 words per 9 bytes) and passed to send_buffer() of
+ * the spi backend, so command and data bytes go in one continuous transfer.
+ * ssd1306_spiDataMode() changes D/C bit of next words instead of gpio.
+ * The display must be configured for 3-wire serial interface (IM pins or BS[2:0]).
+ * Incomplete word, padded with zero bits at the end of the transaction, is ignored
+ * by the controller when chip select goes high.
+ *
+ * ssd1306_spiInit() calls this function if dcPin is negative.
+ *
+ * @note: after call to this function you need to initialize lcd display.
+ */
+void ssd1306_spi3WireAttach(void);
+
+/**
+ * Restores spi interface, replaced by ssd1306_spi3WireAttach().
+ * Does nothing if 3-wire mode is not active.
+ */
+void ssd1306_spi3WireDetach(void);
+
+/**
+ * Sets D/C bit of next 9-bit words.
+ *
+ * @param mode 0 for command mode, 1 for data mode
+ * @return 1 if 3-wire mode is active, 0 otherwise
+ */
+uint8_t ssd1306_spi3WireDataMode(uint8_t mode);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+// ----------------------------------------------------------------------------
+#endif // _SSD1306_SPI_3WIRE_H_
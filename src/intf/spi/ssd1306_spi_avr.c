@@ -43,6 +43,8 @@
 #define SPI_2XCLOCK_MASK 0x01
 
 extern uint32_t s_ssd1306_spi_clock;
+/* Set when spi clock is F_CPU/2, and pipelined transfer can be used */
+static uint8_t s_spi_full_speed = 0;
 
 static void ssd1306_spiConfigure_avr()
 {
@@ -58,6 +60,7 @@ static void ssd1306_spiConfigure_avr()
     {
         clockDiv = 7;
     }
+    s_spi_full_speed = (clockDiv == 0);
     // Invert the SPI2X bit
     clockDiv ^= 0x1;
 
@@ -76,49 +79,59 @@ static void ssd1306_spiConfigure_avr()
     delay(10);
 }
 
-static void ssd1306_spiClose_avr()
-{
-}
-
-static void ssd1306_spiStart_avr()
+/*
+ * AVR SPI has no transmit buffer, but at F_CPU/2 each byte takes exactly 16 cpu cycles.
+ * So, instead of polling SPIF, next byte is loaded while current one is shifted out, and
+ * written to SPDR after 18 cycles. Interrupts can only increase the gap between bytes.
+ */
+static void ssd1306_spiSendBytesPipelined_avr(const uint8_t *buffer, uint16_t size)
 {
-    if (s_ssd1306_cs >= 0)
+    uint8_t data;
+    if (!size)
     {
-        digitalWrite(s_ssd1306_cs,LOW);
+        return;
     }
+    asm volatile(
+        "ld   %[data], %a[buffer]+  \n\t"
+        "1:                         \n\t"
+        "out  %[spdr], %[data]      \n\t" // 1 cycle
+        "sbiw %[size], 1            \n\t" // 2 cycles
+        "breq 2f                    \n\t" // 1 cycle
+        "ld   %[data], %a[buffer]+  \n\t" // 2 cycles
+        "rjmp .+0                   \n\t" // 2 cycles x 5
+        "rjmp .+0                   \n\t"
+        "rjmp .+0                   \n\t"
+        "rjmp .+0                   \n\t"
+        "rjmp .+0                   \n\t"
+        "rjmp 1b                    \n\t" // 2 cycles
+        "2:                         \n\t"
+        : [buffer] "+e" (buffer), [size] "+w" (size), [data] "=&r" (data)
+        : [spdr] "I" (_SFR_IO_ADDR(SPDR))
+    );
+    /* Wait for the last byte, and clear SPIF flag */
+    __builtin_avr_delay_cycles(14);
+    while((SPSR & (1<<SPIF))==0);
+    SPDR;
 }
 
-static void ssd1306_spiSendByte_avr(uint8_t data)
+static void ssd1306_spiClose_avr()
 {
-    SPDR = data;
-    asm volatile("nop");
-    while((SPSR & (1<<SPIF))==0);
 }
 
-static void ssd1306_spiSendBytes_avr(const uint8_t * buffer, uint16_t size)
+static void ssd1306_spiStart_avr()
 {
-    while (size--)
-    {
-        SPDR = *buffer;
-        asm volatile("nop"); // to improve speed
-        while((SPSR & (1<<SPIF))==0);
-        SPDR; // read SPI input
-        buffer++;
-    }
+    ssd1306_spiWriteCs(LOW);
 }
 
 static void ssd1306_spiStop_avr()
 {
     if (ssd1306_lcd.type == LCD_TYPE_PCD8544)
     {
-        digitalWrite(s_ssd1306_dc, LOW);
+        ssd1306_spiWriteDc(LOW);
         ssd1306_spiSendByte_avr( 0x00 ); // Send NOP command to allow last data byte to pass (bug in PCD8544?)
                                          // ssd1306 E3h is NOP command
     }
-    if (s_ssd1306_cs >= 0)
-    {
-        digitalWrite(s_ssd1306_cs, HIGH);
-    }
+    ssd1306_spiWriteCs(HIGH);
 }
 
 void ssd1306_spiInit_avr(int8_t cesPin, int8_t dcPin)
@@ -132,7 +145,8 @@ void ssd1306_spiInit_avr(int8_t cesPin, int8_t dcPin)
     ssd1306_intf.start = ssd1306_spiStart_avr;
     ssd1306_intf.stop = ssd1306_spiStop_avr;
     ssd1306_intf.send = ssd1306_spiSendByte_avr;
-    ssd1306_intf.send_buffer = ssd1306_spiSendBytes_avr;
+    ssd1306_intf.send_buffer = s_spi_full_speed ? ssd1306_spiSendBytesPipelined_avr
+                                                : ssd1306_spiSendBytes_avr;
     ssd1306_intf.close = ssd1306_spiClose_avr;
 }
 
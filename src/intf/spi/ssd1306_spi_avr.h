@@ -50,6 +50,35 @@ extern "C" {
  */
 void         ssd1306_spiInit_avr(int8_t cesPin, int8_t dcPin);
 
+/**
+ * Sends byte via hardware AVR SPI. Defined inline to allow the library to use it
+ * directly, when CONFIG_SSD1306_STATIC_AVR_SPI is defined.
+ * @param data - byte to send
+ */
+static inline void ssd1306_spiSendByte_avr(uint8_t data)
+{
+    SPDR = data;
+    asm volatile("nop");
+    while((SPSR & (1<<SPIF))==0);
+}
+
+/**
+ * Sends bytes via hardware AVR SPI.
+ * @param buffer - bytes to send
+ * @param size - number of bytes to send
+ */
+static inline void ssd1306_spiSendBytes_avr(const uint8_t * buffer, uint16_t size)
+{
+    while (size--)
+    {
+        SPDR = *buffer;
+        asm volatile("nop"); // to improve speed
+        while((SPSR & (1<<SPIF))==0);
+        SPDR; // read SPI input
+        buffer++;
+    }
+}
+
 #endif
 
 #ifdef __cplusplus
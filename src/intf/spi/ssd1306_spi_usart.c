@@ -0,0 +1,123 @@
+/*
+    MIT License
+
+    Copyright (c) 2018, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_spi_usart.h"
+#include "ssd1306_spi.h"
+
+#include "intf/ssd1306_interface.h"
+#include "lcd/lcd_common.h"
+#include "ssd1306_hal/io.h"
+
+#if defined(CONFIG_USART_SPI_AVAILABLE) && defined(CONFIG_USART_SPI_ENABLE)
+
+extern uint32_t s_ssd1306_spi_clock;
+/* Set when there are bytes, which still can be in USART shift register */
+static uint8_t s_usart_busy = 0;
+
+static void ssd1306_spiConfigure_Usart()
+{
+    /* XCK frequency is F_CPU / (2 * (UBRR0 + 1)) */
+    uint32_t div = (F_CPU / 2 + s_ssd1306_spi_clock - 1) / s_ssd1306_spi_clock;
+    UBRR0 = 0;
+    /* XCK pin as output enables master mode */
+    DDRD |= (1<<DDD4);
+    /* Master SPI mode, MSB first, SPI mode 0 */
+    UCSR0C = (1<<UMSEL01) | (1<<UMSEL00) | (0<<UDORD0) | (0<<UCPHA0) | (0<<UCPOL0);
+    UCSR0B = (1<<TXEN0);
+    /* Baud rate must be set after transmitter is enabled */
+    UBRR0 = div ? div - 1 : 0;
+}
+
+static void ssd1306_spiWait_Usart()
+{
+    if (s_usart_busy)
+    {
+        while ( (UCSR0A & (1<<TXC0)) == 0 );
+        s_usart_busy = 0;
+    }
+}
+
+static void ssd1306_spiClose_Usart()
+{
+    ssd1306_spiWait_Usart();
+    UCSR0B = 0;
+}
+
+static void ssd1306_spiStart_Usart()
+{
+    ssd1306_spiWriteCs(LOW);
+}
+
+/*
+ * Function waits only for free space in transmit buffer, so next byte can be written
+ * while previous one is shifted out. TXC0 flag is cleared to detect end of transfer later.
+ */
+static void ssd1306_spiSendByte_Usart(uint8_t data)
+{
+    while ( (UCSR0A & (1<<UDRE0)) == 0 );
+    UCSR0A = (1<<TXC0);
+    UDR0 = data;
+    s_usart_busy = 1;
+}
+
+static void ssd1306_spiSendBytes_Usart(const uint8_t *buffer, uint16_t size)
+{
+    while (size--)
+    {
+        ssd1306_spiSendByte_Usart(*buffer);
+        buffer++;
+    }
+}
+
+static void ssd1306_spiStop_Usart()
+{
+    if (ssd1306_lcd.type == LCD_TYPE_PCD8544)
+    {
+        ssd1306_spiWait_Usart();
+        ssd1306_spiWriteDc(LOW);
+        ssd1306_spiSendByte_Usart( 0x00 ); // Send NOP command to allow last data byte to pass (bug in PCD8544?)
+                                          // ssd1306 E3h is NOP command
+    }
+    ssd1306_spiWait_Usart();
+    ssd1306_spiWriteCs(HIGH);
+}
+
+void ssd1306_spiInit_Usart(int8_t cesPin, int8_t dcPin)
+{
+    if (cesPin >=0) pinMode(cesPin, OUTPUT);
+    if (dcPin >= 0) pinMode(dcPin, OUTPUT);
+    if (cesPin) s_ssd1306_cs = cesPin;
+    if (dcPin) s_ssd1306_dc = dcPin;
+    ssd1306_intf.spi = 1;
+    ssd1306_spiConfigure_Usart();
+    ssd1306_intf.start = ssd1306_spiStart_Usart;
+    ssd1306_intf.stop = ssd1306_spiStop_Usart;
+    ssd1306_intf.send = ssd1306_spiSendByte_Usart;
+    ssd1306_intf.send_buffer = ssd1306_spiSendBytes_Usart;
+    ssd1306_intf.close = ssd1306_spiClose_Usart;
+    /* ssd1306_spiDataMode() waits for the end of transfer before D/C line is changed */
+    ssd1306_intf.wait = ssd1306_spiWait_Usart;
+}
+
+#endif
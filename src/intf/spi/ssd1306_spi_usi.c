@@ -32,7 +32,6 @@
 #if defined(CONFIG_USI_SPI_AVAILABLE) && defined(CONFIG_USI_SPI_ENABLE)
 
 #include <stdlib.h>
-#include <util/atomic.h>
 
 #define PORT_SPI    PORTB
 #define DDR_SPI     DDRB
@@ -55,53 +54,53 @@ static void ssd1306_spiClose_Usi()
 
 static void ssd1306_spiStart_Usi()
 {
-    if (s_ssd1306_cs >= 0)
-    {
-        digitalWrite(s_ssd1306_cs,LOW);
-    }
+    ssd1306_spiWriteCs(LOW);
     USICR = (0<<USIWM1) | (1<<USIWM0) |
             (1<<USICS1) | (0<<USICS0) | (1<<USICLK);
 }
 
-static void ssd1306_spiSendByte_Usi(uint8_t data)
+/*
+ * USITC toggles SCK, USICLK shifts data register: each bit takes two writes to USICR,
+ * so byte is sent in 16 cpu cycles (SPI clock is F_CPU/2). Since SPI is synchronous
+ * interface, interrupts need not to be disabled during transfer.
+ */
+#define USI_SPI_STROBE(lo, hi) { USICR = lo; USICR = hi; }
+
+static inline void ssd1306_usiTransfer(uint8_t data)
 {
+    const uint8_t lo = (1<<USIWM0) | (1<<USITC);
+    const uint8_t hi = (1<<USIWM0) | (1<<USITC) | (1<<USICLK);
     USIDR = data;
-    USISR = (1<<USIOIF);
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
-    {
-        while ( (USISR & (1<<USIOIF)) == 0 )
-        {
-            USICR |= (1<<USITC);
-        }
-    }
+    USI_SPI_STROBE(lo, hi);
+    USI_SPI_STROBE(lo, hi);
+    USI_SPI_STROBE(lo, hi);
+    USI_SPI_STROBE(lo, hi);
+    USI_SPI_STROBE(lo, hi);
+    USI_SPI_STROBE(lo, hi);
+    USI_SPI_STROBE(lo, hi);
+    USI_SPI_STROBE(lo, hi);
+}
+
+static void ssd1306_spiSendByte_Usi(uint8_t data)
+{
+    ssd1306_usiTransfer(data);
 }
 
 static void ssd1306_spiSendBytes_Usi(const uint8_t *buffer, uint16_t size)
 {
     while (size--)
     {
-        USIDR = *buffer;
-        USISR = (1<<USIOIF);
-        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
-        {
-            while ( (USISR & (1<<USIOIF)) == 0 )
-            {
-                USICR |= (1<<USITC);
-            }
-        }
+        ssd1306_usiTransfer(*buffer);
         buffer++;
     };
 }
 
 static void ssd1306_spiStop_Usi()
 {
-    if (s_ssd1306_cs >= 0)
-    {
-        digitalWrite(s_ssd1306_cs, HIGH);
-    }
+    ssd1306_spiWriteCs(HIGH);
     if (ssd1306_lcd.type == LCD_TYPE_PCD8544)
     {
-        digitalWrite(s_ssd1306_dc, LOW);
+        ssd1306_spiWriteDc(LOW);
         ssd1306_spiSendByte_Usi( 0x00 ); // Send NOP command to allow last data byte to pass (bug in PCD8544?)
                                          // ssd1306 E3h is NOP command
     }
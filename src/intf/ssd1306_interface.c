@@ -27,10 +27,14 @@
 #include <stddef.h>
 
 static void ssd1306_send_buffer_generic(const uint8_t* buffer, uint16_t size);
+static void ssd1306_send_buffer_async_generic(const uint8_t* buffer, uint16_t size);
+static void ssd1306_wait_generic(void);
 
 ssd1306_interface_t ssd1306_intf =
 {
-    .send_buffer = ssd1306_send_buffer_generic
+    .send_buffer = ssd1306_send_buffer_generic,
+    .send_buffer_async = ssd1306_send_buffer_async_generic,
+    .wait = ssd1306_wait_generic,
 };
 
 void ssd1306_commandStart(void)
@@ -66,3 +70,237 @@ void ssd1306_send_buffer_generic(const uint8_t* buffer, uint16_t size)
         buffer++;
     }
 }
+
+static void ssd1306_send_buffer_async_generic(const uint8_t* buffer, uint16_t size)
+{
+    ssd1306_intf.send_buffer(buffer, size);
+}
+
+static void ssd1306_wait_generic(void)
+{
+}
+
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+
+static ssd1306_interface_t s_stats_intf;
+static ssd1306_intf_stats_t s_stats;
+static uint32_t s_stats_start_ts;
+static uint8_t s_stats_data_mode;
+/* i2c transactions start with control byte, which defines command or data mode: 1 - next *
+ * byte is control byte, 2 - next byte is single byte after control byte with Co bit set   */
+static uint8_t s_stats_control_byte;
+
+static void ssd1306_stats_count(const uint8_t *buffer, uint16_t size)
+{
+    while (size && s_stats_control_byte)
+    {
+        uint8_t data = *buffer++;
+        size--;
+        if (s_stats_control_byte == 1)
+        {
+            s_stats.command_bytes++;
+            s_stats_data_mode = (data & 0x40) ? 1 : 0;
+            s_stats_control_byte = (data & 0x80) ? 2 : 0;
+            continue;
+        }
+        if (s_stats_data_mode)
+            s_stats.data_bytes++;
+        else
+            s_stats.command_bytes++;
+        s_stats_control_byte = 1;
+    }
+    if (s_stats_data_mode)
+        s_stats.data_bytes += size;
+    else
+        s_stats.command_bytes += size;
+}
+
+static void ssd1306_stats_start(void)
+{
+    s_stats.transactions++;
+    if (!ssd1306_intf.spi)
+    {
+        s_stats_control_byte = 1;
+    }
+    s_stats_start_ts = micros();
+    s_stats_intf.start();
+}
+
+static void ssd1306_stats_stop(void)
+{
+    s_stats_intf.stop();
+    s_stats.bus_time_us += micros() - s_stats_start_ts;
+}
+
+static void ssd1306_stats_send(uint8_t data)
+{
+    ssd1306_stats_count(&data, 1);
+    s_stats.send_bytes++;
+    s_stats_intf.send(data);
+}
+
+static void ssd1306_stats_send_buffer(const uint8_t *buffer, uint16_t size)
+{
+    if (size)
+    {
+        s_stats.buffer_bytes += size;
+        ssd1306_stats_count(buffer, size);
+    }
+    s_stats_intf.send_buffer(buffer, size);
+}
+
+static void ssd1306_stats_send_buffer_async(const uint8_t *buffer, uint16_t size)
+{
+    if (size)
+    {
+        s_stats.buffer_bytes += size;
+        ssd1306_stats_count(buffer, size);
+    }
+    s_stats_intf.send_buffer_async(buffer, size);
+}
+
+void ssd1306_intfStatsAttach(void)
+{
+    if (ssd1306_intf.send == ssd1306_stats_send)
+    {
+        return;
+    }
+    /* New interface starts with its own statistics */
+    ssd1306_intfStatsReset();
+    s_stats_intf = ssd1306_intf;
+    ssd1306_intf.start = ssd1306_stats_start;
+    ssd1306_intf.stop = ssd1306_stats_stop;
+    ssd1306_intf.send = ssd1306_stats_send;
+    ssd1306_intf.send_buffer = ssd1306_stats_send_buffer;
+    ssd1306_intf.send_buffer_async = ssd1306_stats_send_buffer_async;
+}
+
+void ssd1306_intfStatsGet(ssd1306_intf_stats_t *stats)
+{
+    *stats = s_stats;
+}
+
+void ssd1306_intfStatsReset(void)
+{
+    ssd1306_intf_stats_t empty = { 0 };
+    s_stats = empty;
+}
+
+void ssd1306_intfStatsDataMode(uint8_t mode)
+{
+    s_stats_data_mode = mode;
+}
+
+void ssd1306_intfStatsSave(ssd1306_intf_stats_state_t *state)
+{
+    state->intf = s_stats_intf;
+    state->stats = s_stats;
+    state->start_ts = s_stats_start_ts;
+    state->data_mode = s_stats_data_mode;
+    state->control_byte = s_stats_control_byte;
+}
+
+void ssd1306_intfStatsRestore(const ssd1306_intf_stats_state_t *state)
+{
+    s_stats_intf = state->intf;
+    s_stats = state->stats;
+    s_stats_start_ts = state->start_ts;
+    s_stats_data_mode = state->data_mode;
+    s_stats_control_byte = state->control_byte;
+}
+
+#endif
+
+#ifdef CONFIG_SSD1306_BUS_SHARE_ENABLE
+
+static void (*s_share_start)(void) = NULL;
+static void (*s_share_stop)(void);
+static void (*s_share_hook)(void);
+static uint16_t s_share_burst;
+static uint16_t s_share_count;
+static uint8_t s_share_depth = 0;
+static uint8_t s_share_held = 0;
+static volatile uint8_t s_share_request = 0;
+
+static void ssd1306_share_release(void)
+{
+    s_share_held = 0;
+    s_share_stop();
+}
+
+static void ssd1306_share_start(void)
+{
+    if (!s_share_held)
+    {
+        s_share_start();
+        s_share_held = s_share_depth ? 1 : 0;
+        s_share_count = 0;
+    }
+    s_share_count++;
+}
+
+static void ssd1306_share_stop(void)
+{
+    if (s_share_held && !s_share_request && (!s_share_burst || (s_share_count < s_share_burst)))
+    {
+        return;
+    }
+    ssd1306_share_release();
+    if (s_share_request)
+    {
+        s_share_request = 0;
+        if (s_share_hook)
+        {
+            s_share_hook();
+        }
+    }
+}
+
+void ssd1306_busShareAttach(uint16_t burst, void (*yieldHook)(void))
+{
+    s_share_burst = burst;
+    s_share_hook = yieldHook;
+    if (!ssd1306_intf.spi || (ssd1306_intf.start == ssd1306_share_start))
+    {
+        return;
+    }
+    s_share_start = ssd1306_intf.start;
+    s_share_stop = ssd1306_intf.stop;
+    ssd1306_intf.start = ssd1306_share_start;
+    ssd1306_intf.stop = ssd1306_share_stop;
+}
+
+void ssd1306_busShareDetach(void)
+{
+    if (ssd1306_intf.start != ssd1306_share_start)
+    {
+        return;
+    }
+    if (s_share_held)
+    {
+        ssd1306_share_release();
+    }
+    s_share_depth = 0;
+    ssd1306_intf.start = s_share_start;
+    ssd1306_intf.stop = s_share_stop;
+}
+
+void ssd1306_busBeginBurst(void)
+{
+    s_share_depth++;
+}
+
+void ssd1306_busEndBurst(void)
+{
+    if (s_share_depth && !--s_share_depth && s_share_held)
+    {
+        ssd1306_share_release();
+    }
+}
+
+void ssd1306_busRequest(void)
+{
+    s_share_request = 1;
+}
+
+#endif
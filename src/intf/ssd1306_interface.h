@@ -86,6 +86,27 @@ typedef struct
      * the function has meaning in Linux-like systems.
      */
     void (*close)(void);
+    /**
+     * @brief Starts sending bytes to SSD1306 device and returns immediately.
+     *
+     * Starts sending bytes to SSD1306 device in background (usually via DMA)
+     * and returns without waiting for transfer to complete. Buffer must remain
+     * valid until ssd1306_intf.wait() is called. If platform doesn't support
+     * asynchronous transfers, this function works the same way as
+     * ssd1306_intf.send_buffer.
+     *
+     * @param buffer - bytes to send
+     * @param size - number of bytes to send
+     */
+    void (*send_buffer_async)(const uint8_t *buffer, uint16_t size);
+    /**
+     * @brief Waits until all asynchronous transfers are complete.
+     *
+     * Waits until all transfers, started by ssd1306_intf.send_buffer_async(),
+     * are complete. After this call the buffer, passed to send_buffer_async(),
+     * can be reused.
+     */
+    void (*wait)(void);
 } ssd1306_interface_t;
 
 /**
@@ -93,6 +114,19 @@ typedef struct
  */
 extern ssd1306_interface_t ssd1306_intf;
 
+#if defined(CONFIG_SSD1306_STATIC_AVR_SPI) && defined(CONFIG_AVR_SPI_AVAILABLE) && defined(CONFIG_AVR_SPI_ENABLE)
+#include "intf/spi/ssd1306_spi_avr.h"
+/** Sends byte to display via interface, selected at compile time */
+#define ssd1306_intfSend(data)                 ssd1306_spiSendByte_avr(data)
+/** Sends bytes to display via interface, selected at compile time */
+#define ssd1306_intfSendBuffer(buffer, size)   ssd1306_spiSendBytes_avr(buffer, size)
+#else
+/** Sends byte to display via currently initialized interface */
+#define ssd1306_intfSend(data)                 ssd1306_intf.send(data)
+/** Sends bytes to display via currently initialized interface */
+#define ssd1306_intfSendBuffer(buffer, size)   ssd1306_intf.send_buffer(buffer, size)
+#endif
+
 /**
  * Deprecated
  */
@@ -140,6 +174,163 @@ void ssd1306_commandStart(void);
  */
 void ssd1306_dataStart(void);
 
+/** State of ssd1306_i2cControlTrack(): the next byte of the transaction is control byte */
+#define SSD1306_I2C_CONTROL_NEXT   0xFF
+
+/**
+ * @brief Tracks i2c control bytes of the transaction, which is split to chunks.
+ *
+ * Control byte without Co bit (0x00, 0x40) applies to all following bytes of the
+ * transaction, control byte with Co bit (0x80, 0xC0) applies to the next byte only,
+ * which is followed by another control byte. i2c backends, splitting long transactions,
+ * pass sent bytes to this function and start the next chunk with returned control byte,
+ * or with the next caller byte if SSD1306_I2C_CONTROL_NEXT is returned.
+ * Parsing stops at the first control byte without Co bit, so data streams cost nothing.
+ * @param state SSD1306_I2C_CONTROL_NEXT at the transaction start or the value, returned for previous bytes
+ * @param data bytes sent
+ * @param len number of bytes
+ * @return new state
+ */
+static inline uint8_t ssd1306_i2cControlTrack(uint8_t state, const uint8_t *data, uint16_t len)
+{
+    while (len && (state & 0x80))
+    {
+        state = state == SSD1306_I2C_CONTROL_NEXT ? *data : SSD1306_I2C_CONTROL_NEXT;
+        data++;
+        len--;
+    }
+    return state;
+}
+
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+
+/** Interface usage statistics, collected if CONFIG_SSD1306_INTF_STATS_ENABLE is defined */
+typedef struct
+{
+    /** Number of start()/stop() transactions */
+    uint32_t transactions;
+    /** Number of bytes, sent via send() */
+    uint32_t send_bytes;
+    /** Number of bytes, sent via send_buffer() and send_buffer_async() */
+    uint32_t buffer_bytes;
+    /** Number of bytes, sent in command mode (including i2c control bytes) */
+    uint32_t command_bytes;
+    /** Number of bytes, sent in data mode */
+    uint32_t data_bytes;
+    /** Time in microseconds, spent between start() and stop() */
+    uint32_t bus_time_us;
+} ssd1306_intf_stats_t;
+
+/**
+ * @brief Wraps current interface functions to collect statistics.
+ *
+ * Wraps current interface functions to collect statistics. The function is called
+ * automatically by ssd1306_i2cInitEx() and ssd1306_spiInit(). If you initialize
+ * interface in some other way, call this function after interface initialization
+ * and before display initialization, since display drivers copy interface functions.
+ * Statistics, collected for previous interface, are reset.
+ */
+void ssd1306_intfStatsAttach(void);
+
+/**
+ * Copies statistics, collected since last reset, to the structure.
+ * @param stats - pointer to structure to fill
+ */
+void ssd1306_intfStatsGet(ssd1306_intf_stats_t *stats);
+
+/**
+ * Resets collected statistics.
+ */
+void ssd1306_intfStatsReset(void);
+
+/**
+ * Tells statistics module, which mode spi D/C line is switched to.
+ * Called by ssd1306_spiDataMode().
+ * @param mode - 0 for command mode, 1 for data mode
+ */
+void ssd1306_intfStatsDataMode(uint8_t mode);
+
+/**
+ * Statistics of single interface together with interface functions, wrapped by
+ * ssd1306_intfStatsAttach(). Display contexts keep it, so each display collects its
+ * own statistics and sends data via its own interface.
+ */
+typedef struct
+{
+    /** interface functions, wrapped by statistics module */
+    ssd1306_interface_t intf;
+    /** collected statistics */
+    ssd1306_intf_stats_t stats;
+    /** start time of current transaction */
+    uint32_t start_ts;
+    /** current spi D/C mode */
+    uint8_t data_mode;
+    /** i2c control byte tracking state */
+    uint8_t control_byte;
+} ssd1306_intf_stats_state_t;
+
+/**
+ * Copies state of statistics module of current interface to the structure.
+ * Used by ssd1306_contextSelect().
+ * @param state - pointer to structure to fill
+ */
+void ssd1306_intfStatsSave(ssd1306_intf_stats_state_t *state);
+
+/**
+ * Makes state, saved by ssd1306_intfStatsSave(), current.
+ * Used by ssd1306_contextSelect().
+ * @param state - pointer to saved state
+ */
+void ssd1306_intfStatsRestore(const ssd1306_intf_stats_state_t *state);
+
+#endif
+
+#ifdef CONFIG_SSD1306_BUS_SHARE_ENABLE
+
+/**
+ * @brief Wraps current spi interface to share the bus with other devices.
+ *
+ * Outside of bursts display transactions work as usual. Inside of burst
+ * (see ssd1306_busBeginBurst()) the first start() takes the bus (SPI transaction
+ * and chip select), and following stop() calls keep it, so next transactions
+ * continue without setup. The bus is released at the end of burst, after each
+ * burst transactions, or at the first stop() after ssd1306_busRequest().
+ * Does nothing for i2c interface, which cannot merge transactions.
+ * Call this function after interface initialization and before enabling shadow
+ * buffer, trace or mirror modes, since they copy interface functions.
+ *
+ * @param burst max number of display transactions, sent while the bus is held,
+ *        0 to hold the bus until the end of burst
+ * @param yieldHook function, called after the bus is released on request of other
+ *        device, for example to serve the radio. Can be NULL.
+ */
+void ssd1306_busShareAttach(uint16_t burst, void (*yieldHook)(void));
+
+/**
+ * Releases the bus and restores interface functions, replaced by ssd1306_busShareAttach().
+ */
+void ssd1306_busShareDetach(void);
+
+/**
+ * Starts burst of display transactions. Bursts can be nested.
+ */
+void ssd1306_busBeginBurst(void);
+
+/**
+ * Ends burst of display transactions. The bus is released at the end of outer burst.
+ */
+void ssd1306_busEndBurst(void);
+
+/**
+ * @brief Asks display to release the bus.
+ *
+ * The display releases the bus at the next transaction boundary and calls yield hook,
+ * passed to ssd1306_busShareAttach(). Can be called from interrupt handler.
+ */
+void ssd1306_busRequest(void);
+
+#endif
+
 /**
  * @}
  */
@@ -0,0 +1,264 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include "ssd1306_uart_link.h"
+#include "intf/ssd1306_interface.h"
+
+enum
+{
+    LINK_WAIT_SOF = 0,
+    LINK_FLAGS,
+    LINK_LEN_LSB,
+    LINK_LEN_MSB,
+    LINK_PAYLOAD,
+    LINK_SUM,
+};
+
+static void (*s_link_write)(const uint8_t *buffer, uint16_t len);
+static uint8_t s_link_rle;
+static uint8_t s_link_flags;
+static uint16_t s_link_len;
+static uint8_t s_link_buf[CONFIG_UART_LINK_PAYLOAD];
+
+/* Walks RLE packets of the frame payload: returns compressed size, sending packets if emit is set */
+static uint16_t ssd1306_linkCompress(uint8_t emit, uint8_t *sum)
+{
+    uint16_t size = 0;
+    uint16_t i = 0;
+    while (i < s_link_len)
+    {
+        uint8_t run = 1;
+        while (i + run < s_link_len && s_link_buf[i + run] == s_link_buf[i] && run < 128) run++;
+        uint8_t packet[2];
+        uint8_t count;
+        const uint8_t *data;
+        if (run >= 3)
+        {
+            packet[0] = 0x80 | (run - 1);
+            packet[1] = s_link_buf[i];
+            data = &packet[1];
+            count = 1;
+            i += run;
+        }
+        else
+        {
+            /* Literal packet lasts until the next run of 3 bytes */
+            uint16_t start = i;
+            while (i < s_link_len && i - start < 128)
+            {
+                if (i + 2 < s_link_len && s_link_buf[i] == s_link_buf[i + 1] &&
+                    s_link_buf[i] == s_link_buf[i + 2]) break;
+                i++;
+            }
+            packet[0] = i - start - 1;
+            data = &s_link_buf[start];
+            count = i - start;
+        }
+        size += 1 + count;
+        if (emit)
+        {
+            *sum += packet[0];
+            for (uint8_t n = 0; n < count; n++) *sum += data[n];
+            s_link_write(packet, 1);
+            s_link_write(data, count);
+        }
+    }
+    return size;
+}
+
+static void ssd1306_linkFlush(uint8_t flags)
+{
+    flags |= s_link_flags;
+    uint16_t len = s_link_len;
+    if (s_link_rle && len)
+    {
+        uint16_t packed = ssd1306_linkCompress(0, 0);
+        if (packed < len)
+        {
+            len = packed;
+            flags |= UART_LINK_RLE;
+        }
+    }
+    uint8_t header[4] = { UART_LINK_SOF, flags, len & 0xFF, len >> 8 };
+    uint8_t sum = header[1] + header[2] + header[3];
+    s_link_write(header, sizeof(header));
+    if (flags & UART_LINK_RLE)
+    {
+        ssd1306_linkCompress(1, &sum);
+    }
+    else
+    {
+        for (uint16_t i = 0; i < len; i++) sum += s_link_buf[i];
+        s_link_write(s_link_buf, len);
+    }
+    s_link_write(&sum, 1);
+    s_link_flags = 0;
+    s_link_len = 0;
+}
+
+static void ssd1306_linkStart(void)
+{
+    s_link_flags = UART_LINK_START;
+    s_link_len = 0;
+}
+
+static void ssd1306_linkStop(void)
+{
+    ssd1306_linkFlush(UART_LINK_STOP);
+}
+
+static void ssd1306_linkSendByte(uint8_t data)
+{
+    s_link_buf[s_link_len++] = data;
+    if (s_link_len == CONFIG_UART_LINK_PAYLOAD)
+    {
+        ssd1306_linkFlush(0);
+    }
+}
+
+static void ssd1306_linkSendBytes(const uint8_t *buffer, uint16_t len)
+{
+    while (len)
+    {
+        uint16_t count = CONFIG_UART_LINK_PAYLOAD - s_link_len;
+        if (count > len) count = len;
+        for (uint16_t i = 0; i < count; i++) s_link_buf[s_link_len + i] = buffer[i];
+        s_link_len += count;
+        buffer += count;
+        len -= count;
+        if (s_link_len == CONFIG_UART_LINK_PAYLOAD)
+        {
+            ssd1306_linkFlush(0);
+        }
+    }
+}
+
+static void ssd1306_linkClose(void)
+{
+}
+
+void ssd1306_uartLinkInit(void (*write)(const uint8_t *buffer, uint16_t len), uint8_t rle)
+{
+    s_link_write = write;
+    s_link_rle = rle;
+    s_link_flags = 0;
+    s_link_len = 0;
+    ssd1306_intf.spi = 0;
+    ssd1306_intf.start = ssd1306_linkStart;
+    ssd1306_intf.stop = ssd1306_linkStop;
+    ssd1306_intf.send = ssd1306_linkSendByte;
+    ssd1306_intf.send_buffer = ssd1306_linkSendBytes;
+    ssd1306_intf.close = ssd1306_linkClose;
+}
+
+void ssd1306_uartLinkReceiverInit(SUartLinkReceiver *rx)
+{
+    rx->state = LINK_WAIT_SOF;
+    rx->errors = 0;
+}
+
+/* Sends received payload to the local display, expanding RLE packets */
+static void ssd1306_linkReplay(SUartLinkReceiver *rx)
+{
+    if (rx->flags & UART_LINK_START)
+    {
+        ssd1306_intf.start();
+    }
+    if (!(rx->flags & UART_LINK_RLE))
+    {
+        ssd1306_intf.send_buffer(rx->buffer, rx->len);
+    }
+    else
+    {
+        uint16_t i = 0;
+        while (i < rx->len)
+        {
+            uint8_t header = rx->buffer[i++];
+            uint8_t count = (header & 0x7F) + 1;
+            if (!(header & 0x80))
+            {
+                if (count > rx->len - i) count = rx->len - i;
+                ssd1306_intf.send_buffer(&rx->buffer[i], count);
+                i += count;
+            }
+            else if (i < rx->len)
+            {
+                uint8_t data = rx->buffer[i++];
+                while (count--) ssd1306_intf.send(data);
+            }
+        }
+    }
+    if (rx->flags & UART_LINK_STOP)
+    {
+        ssd1306_intf.stop();
+    }
+}
+
+int8_t ssd1306_uartLinkReceive(SUartLinkReceiver *rx, uint8_t data)
+{
+    switch (rx->state)
+    {
+        case LINK_WAIT_SOF:
+            if (data == UART_LINK_SOF) rx->state = LINK_FLAGS;
+            return 0;
+        case LINK_FLAGS:
+            rx->flags = data;
+            rx->sum = data;
+            rx->state = LINK_LEN_LSB;
+            return 0;
+        case LINK_LEN_LSB:
+            rx->len = data;
+            rx->sum += data;
+            rx->state = LINK_LEN_MSB;
+            return 0;
+        case LINK_LEN_MSB:
+            rx->len |= (uint16_t)data << 8;
+            rx->sum += data;
+            rx->pos = 0;
+            if (rx->len > CONFIG_UART_LINK_PAYLOAD)
+            {
+                break;
+            }
+            rx->state = rx->len ? LINK_PAYLOAD : LINK_SUM;
+            return 0;
+        case LINK_PAYLOAD:
+            rx->buffer[rx->pos++] = data;
+            rx->sum += data;
+            if (rx->pos == rx->len) rx->state = LINK_SUM;
+            return 0;
+        default:
+            if (data != rx->sum)
+            {
+                break;
+            }
+            rx->state = LINK_WAIT_SOF;
+            ssd1306_linkReplay(rx);
+            return 1;
+    }
+    /* Broken frame: start byte may be inside, so it is checked again */
+    rx->errors++;
+    rx->state = data == UART_LINK_SOF ? LINK_FLAGS : LINK_WAIT_SOF;
+    return -1;
+}
@@ -0,0 +1,126 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/**
+ * @file ssd1306_uart_link.h Framed display link over UART or any other byte stream
+ */
+
+#ifndef _SSD1306_UART_LINK_H_
+#define _SSD1306_UART_LINK_H_
+
+#include "ssd1306_hal/io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @ingroup LCD_HW_INTERFACE_API
+ * @{
+ *
+ * Display link transfers ssd1306_intf transactions (control byte 0x00/0x40 followed
+ * by commands or data) in frames:
+ *
+ *     0x7E | FLAGS | LEN(LSB) | LEN(MSB) | PAYLOAD[LEN] | SUM
+ *
+ * FLAGS bit 0 - payload is RLE-compressed in bitmapcompress.py format (1-byte units),
+ * bit 1 - frame starts transaction, bit 2 - frame completes transaction.
+ * LEN is payload length as transmitted, up to CONFIG_UART_LINK_PAYLOAD bytes.
+ * SUM is 8-bit sum of FLAGS, LEN and PAYLOAD bytes.
+ * Frames are not escaped: receiver drops frames with wrong length or sum and
+ * looks for the next 0x7E, so whole frames can be moved by DMA or ring buffers.
+ */
+
+#ifndef CONFIG_UART_LINK_PAYLOAD
+#if defined(__AVR__)
+/** Maximum payload length of link frame, defines RAM used by sender and receiver */
+#define CONFIG_UART_LINK_PAYLOAD   64
+#else
+#define CONFIG_UART_LINK_PAYLOAD   256
+#endif
+#endif
+
+/** Link frame start byte */
+#define UART_LINK_SOF       0x7E
+/** Frame payload is RLE-compressed */
+#define UART_LINK_RLE       0x01
+/** Frame starts ssd1306_intf transaction */
+#define UART_LINK_START     0x02
+/** Frame completes ssd1306_intf transaction */
+#define UART_LINK_STOP      0x04
+
+/**
+ * Receiver state of display link
+ */
+typedef struct
+{
+    /// number of frames, dropped due to wrong length or sum
+    uint16_t errors;
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    uint8_t state;
+    uint8_t flags;
+    uint8_t sum;
+    uint16_t len;
+    uint16_t pos;
+    uint8_t buffer[CONFIG_UART_LINK_PAYLOAD];
+#endif
+} SUartLinkReceiver;
+
+/**
+ * Initializes ssd1306_intf to send display transactions as link frames.
+ *
+ * @param write function to send frame bytes (uart_send_buffer(), serial port write, etc.)
+ * @param rle 1 to compress frames, if it makes them shorter, 0 to send frames as is
+ *
+ * @note: after call to this function you need to initialize lcd display.
+ */
+void ssd1306_uartLinkInit(void (*write)(const uint8_t *buffer, uint16_t len), uint8_t rle);
+
+/**
+ * Resets link receiver state.
+ *
+ * @param rx pointer to receiver state
+ */
+void ssd1306_uartLinkReceiverInit(SUartLinkReceiver *rx);
+
+/**
+ * Passes received byte to the link receiver. Once complete frame is received
+ * and checked, its payload is sent to the local display via ssd1306_intf.
+ *
+ * @param rx pointer to receiver state
+ * @param data received byte
+ * @return 1 if frame is received and sent to the display, -1 if frame is dropped,
+ *         0 if more bytes are needed
+ */
+int8_t ssd1306_uartLinkReceive(SUartLinkReceiver *rx, uint8_t data);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SSD1306_UART_LINK_H_ */
@@ -27,6 +27,7 @@
 #include "intf/ssd1306_interface.h"
 #include "lcd/lcd_common.h"
 #include "lcd/vga_commands.h"
+#include "ssd1306_generic.h"
 
 #if defined(CONFIG_VGA_AVAILABLE) && defined(CONFIG_VGA_ENABLE) && defined(__AVR_ATmega328P__)
 
@@ -46,6 +47,8 @@ extern uint16_t ssd1306_color;
 static uint8_t s_mode = 0x01;
 static uint8_t s_vga_command = 0xFF;
 static uint8_t s_vga_arg = 0;
+/* Arguments of drawing commands collected so far */
+static uint8_t s_vga_args[4];
 static uint8_t s_column = 0;
 static uint8_t s_column_end = 0;
 static uint8_t s_cursor_x = 0;
@@ -87,6 +90,63 @@ static inline void vga_controller_put_pixels(uint8_t x, uint8_t y, uint8_t pixel
     }
 }
 
+static inline void vga_controller_put_pixel(uint8_t x, uint8_t y, uint8_t color)
+{
+    if ((x >= 128) || (y >= 64))
+    {
+        return;
+    }
+    uint16_t addr = (x >> 3) + (uint16_t)(y * 16);
+    uint8_t mask = 1 << (x & 0x07);
+    if (color) __vga_buffer[addr] |= mask;
+          else __vga_buffer[addr] &= ~mask;
+}
+
+/* Fills rectangle with white (color != 0) or black, both corners are inclusive */
+static void vga_controller_fill_rect(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color)
+{
+    if (x2 >= 128) x2 = 127;
+    if (y2 >= 64) y2 = 63;
+    for (uint8_t y = y1; y <= y2; y++)
+    {
+        for (uint8_t x = x1; x <= x2; x++)
+        {
+            vga_controller_put_pixel(x, y, color);
+        }
+    }
+}
+
+/* Draws single char of current fixed font and returns number of pixels to advance */
+static uint8_t vga_controller_put_char(uint8_t x, uint8_t y, uint8_t color, uint8_t ch)
+{
+    uint16_t unicode = ssd1306_unicode16FromUtf8(ch);
+    if (unicode == SSD1306_MORE_CHARS_REQUIRED) return 0;
+    SCharInfo char_info;
+    ssd1306_getCharBitmap(unicode, &char_info);
+    for (uint8_t j = 0; j < char_info.height; j++)
+    {
+        const uint8_t *glyph = char_info.glyph + (j >> 3) * char_info.width;
+        for (uint8_t i = 0; i < char_info.width; i++)
+        {
+            uint8_t bits = pgm_read_byte( &glyph[i] );
+            vga_controller_put_pixel(x + i, y + j, (bits & (1 << (j & 0x07))) ? color : 0);
+        }
+    }
+    return char_info.width + char_info.spacing;
+}
+
+/* Puts 8 vertical pixels to current block position and moves cursor */
+static void vga_controller_put_data(uint8_t data)
+{
+    vga_controller_put_pixels(s_cursor_x, s_cursor_y, data);
+    s_cursor_x++;
+    if (s_cursor_x > s_column_end)
+    {
+        s_cursor_x = s_column;
+        s_cursor_y += 8;
+    }
+}
+
 static void vga_controller_send_byte(uint8_t data)
 {
     if (s_vga_command == 0xFF)
@@ -96,13 +156,7 @@ static void vga_controller_send_byte(uint8_t data)
     }
     if (s_vga_command == 0x40)
     {
-        vga_controller_put_pixels(s_cursor_x, s_cursor_y, data);
-        s_cursor_x++;
-        if (s_cursor_x > s_column_end)
-        {
-            s_cursor_x = s_column;
-            s_cursor_y += 8;
-        }
+        vga_controller_put_data(data);
         return;
     }
     // command mode
@@ -127,15 +181,139 @@ static void vga_controller_send_byte(uint8_t data)
     {
         if (s_vga_arg == 1) { s_mode = data; s_vga_command = 0; }
     }
+    if (s_vga_command == VGA_FILL_RECT)
+    {
+        if (s_vga_arg && s_vga_arg < 5) { s_vga_args[s_vga_arg - 1] = data; }
+        if (s_vga_arg == 5)
+        {
+            vga_controller_fill_rect(s_vga_args[0], s_vga_args[1], s_vga_args[2], s_vga_args[3], data);
+            s_vga_command = 0;
+        }
+    }
+    if (s_vga_command == VGA_DRAW_HLINE)
+    {
+        if (s_vga_arg && s_vga_arg < 4) { s_vga_args[s_vga_arg - 1] = data; }
+        if (s_vga_arg == 4)
+        {
+            vga_controller_fill_rect(s_vga_args[0], s_vga_args[1], s_vga_args[2], s_vga_args[1], data);
+            s_vga_command = 0;
+        }
+    }
+    if (s_vga_command == VGA_TEXT)
+    {
+        if (s_vga_arg && s_vga_arg < 5) { s_vga_args[s_vga_arg - 1] = data; }
+        if (s_vga_arg == 4 && !data) { s_vga_command = 0; }
+        if (s_vga_arg == 5)
+        {
+            s_vga_args[0] += vga_controller_put_char(s_vga_args[0], s_vga_args[1], s_vga_args[2], data);
+            if (!--s_vga_args[3]) s_vga_command = 0;
+            s_vga_arg = 4;
+        }
+    }
+    if (s_vga_command == VGA_PIXELS_RLE)
+    {
+        if (s_vga_arg == 1) { s_vga_args[0] = data; }
+        if (s_vga_arg == 2)
+        {
+            while (s_vga_args[0]--) vga_controller_put_data(data);
+            s_vga_command = 0;
+        }
+    }
+    if (s_vga_command == VGA_PIXELS)
+    {
+        if (s_vga_arg == 1) { s_vga_args[0] = data; if (!data) s_vga_command = 0; }
+        if (s_vga_arg == 2)
+        {
+            vga_controller_put_data(data);
+            if (!--s_vga_args[0]) s_vga_command = 0;
+            s_vga_arg = 1;
+        }
+    }
     s_vga_arg++;
 }
 
+/*
+ * Function sends span of page bytes to the buffer. Each group of 8 bytes, aligned to
+ * vga buffer byte, is transposed to 8 rows and written without read-modify-write.
+ */
+static void vga_controller_put_span(uint8_t x, uint8_t y, const uint8_t *pixels, uint8_t count)
+{
+    volatile uint8_t *row = &__vga_buffer[(x >> 3) + (uint16_t)(y * 16)];
+    uint8_t mask = 1 << (x & 0x07);
+    while (count)
+    {
+        if (mask == 0x01 && count >= 8)
+        {
+            uint8_t rows[8] = {0};
+            for (uint8_t i=8; i>0; i--)
+            {
+                uint8_t data = *pixels++;
+                for (uint8_t r=0; r<8; r++)
+                {
+                    rows[r] >>= 1;
+                    if (data & 0x01) rows[r] |= 0x80;
+                    data >>= 1;
+                }
+            }
+            volatile uint8_t *p = row;
+            for (uint8_t r=0; r<8; r++)
+            {
+                *p = rows[r];
+                p += 16;
+            }
+            row++;
+            count -= 8;
+            continue;
+        }
+        uint8_t data = *pixels++;
+        volatile uint8_t *p = row;
+        for (uint8_t r=8; r>0; r--)
+        {
+            if (data & 0x01) *p |= mask;
+                        else *p &= ~mask;
+            p += 16;
+            data >>= 1;
+        }
+        mask <<= 1;
+        if (!mask)
+        {
+            mask = 0x01;
+            row++;
+        }
+        count--;
+    }
+}
+
 static void vga_controller_send_bytes(const uint8_t *buffer, uint16_t len)
 {
-    while (len--)
+    if (s_vga_command != 0x40)
     {
-        ssd1306_intf.send(*buffer);
-        buffer++;
+        while (len--)
+        {
+            vga_controller_send_byte(*buffer);
+            buffer++;
+        }
+        return;
+    }
+    while (len)
+    {
+        uint8_t count = s_column_end - s_cursor_x + 1;
+        if (count > len)
+        {
+            count = len;
+        }
+        if (s_cursor_y < 64)
+        {
+            vga_controller_put_span(s_cursor_x, s_cursor_y, buffer, count);
+        }
+        buffer += count;
+        len -= count;
+        s_cursor_x += count;
+        if (s_cursor_x > s_column_end)
+        {
+            s_cursor_x = s_column;
+            s_cursor_y += 8;
+        }
     }
 }
 
@@ -194,6 +372,23 @@ static inline void init_vga_crt_driver(uint8_t enable_jitter_fix)
     sei();
 }
 
+/*
+ * Configures USART as pixel shift register (master SPI mode). Transmitter is enabled
+ * by scan line ISR only while pixels are sent, otherwise D1 is driven low by PORTD.
+ */
+static void init_vga_mspim(void)
+{
+    UCSR0B = 0;
+    // XCK must be output for master mode. UBRR0 must be 0, when transmitter is enabled
+    UBRR0 = 0;
+    pinMode(4, OUTPUT);
+    pinMode(1, OUTPUT);
+    PORTD &= ~(1<<PD1);
+    // LSB first to match vga buffer bit order, pixel clock is fosc/2
+    UCSR0C = (1<<UMSEL01) | (1<<UMSEL00) | (1<<UDORD0);
+    UBRR0 = 0;
+}
+
 void ssd1306_vga_controller_128x64_init_no_output(void)
 {
     ssd1306_intf.spi = 0;
@@ -217,6 +412,13 @@ void ssd1306_vga_controller_128x64_init_enable_output_no_jitter_fix(void)
 //    set_sleep_mode (SLEEP_MODE_IDLE);
 }
 
+void ssd1306_vga_controller_128x64_init_mspim(uint8_t enable_jitter_fix)
+{
+    ssd1306_vga_controller_128x64_init_no_output();
+    init_vga_mspim();
+    init_vga_crt_driver(enable_jitter_fix);
+}
+
 void ssd1306_debug_print_vga_buffer_128x64(void (*func)(uint8_t))
 {
     for(int y = 0; y < ssd1306_lcd.height; y++)
@@ -27,6 +27,7 @@
 #include "intf/ssd1306_interface.h"
 #include "lcd/lcd_common.h"
 #include "lcd/vga_commands.h"
+#include "ssd1306_generic.h"
 
 #if defined(CONFIG_VGA_AVAILABLE) && defined(CONFIG_VGA_ENABLE) && defined(__AVR_ATmega328P__)
 
@@ -46,10 +47,16 @@ extern uint16_t ssd1306_color;
 static uint8_t s_mode = 0x01;
 static uint8_t s_vga_command = 0xFF;
 static uint8_t s_vga_arg = 0;
+/* Arguments of drawing commands collected so far */
+static uint8_t s_vga_args[4];
 static uint8_t s_column = 0;
 static uint8_t s_column_end = 0;
 static uint8_t s_cursor_x = 0;
 static uint8_t s_cursor_y = 0;
+/* Set if vga buffer uses nibble packing: see vga_controller_put_pixel_nibble() */
+static uint8_t s_nibbles = 0;
+/* 1 if vga buffer has half height and each buffer line is used for 2 pixel rows */
+static uint8_t s_row_shift = 0;
 volatile uint8_t s_vga_frames;
 
 static void vga_controller_init(void)
@@ -116,35 +123,116 @@ static inline void vga_controller_put_pixel3(uint8_t x, uint8_t y, uint8_t color
     }
 }
 
-static void vga_controller_send_byte4(uint8_t data)
+/* Alternative buffer packing: each byte holds 2 pixels, 48 bytes per line
+
+   BYTE:  -- R2 G2 B2 -- R1 G1 B1
+
+   ISR outputs such buffer without any bits shuffling, and single pixel is
+   changed with one read-modify-write operation.
+*/
+static inline void vga_controller_put_pixel_nibble(uint8_t x, uint8_t y, uint8_t color)
 {
-    if (s_vga_command == 0xFF)
+    y >>= s_row_shift;
+    uint16_t addr = (x >> 1) + (uint16_t)y*48;
+    if (x >= 96 || addr >= ((48*40) >> s_row_shift))
     {
-        s_vga_command = data;
         return;
     }
-    if (s_vga_command == 0x40)
+    if (x & 1)
+    {
+        __vga_buffer[addr] = (__vga_buffer[addr] & 0x0F) | (color << 4);
+    }
+    else
+    {
+        __vga_buffer[addr] = (__vga_buffer[addr] & 0xF0) | color;
+    }
+}
+
+/* Converts RGB8 color to 3-bit color of vga buffer: R G B */
+static inline uint8_t vga_controller_color3(uint8_t data)
+{
+    return ((data & 0x80) >> 5) | ((data & 0x10) >> 3) | ((data & 0x02)>>1);
+}
+
+static inline void vga_controller_put_pixel(uint8_t x, uint8_t y, uint8_t color)
+{
+    if (s_nibbles)
+    {
+        vga_controller_put_pixel_nibble(x, y, color);
+    }
+    else if (x < 96)
+    {
+        vga_controller_put_pixel3(x, y, color);
+    }
+}
+
+/* Fills rectangle with 3-bit color, both corners are inclusive */
+static void vga_controller_fill_rect(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color)
+{
+    if (x2 >= 96) x2 = 95;
+    if (y2 >= 40) y2 = 39;
+    for (uint8_t y = y1; y <= y2; y++)
     {
-        uint8_t color = ((data & 0x80) >> 5) | ((data & 0x10) >> 3) | ((data & 0x02)>>1);
-        vga_controller_put_pixel3(s_cursor_x, s_cursor_y, color);
-        if (s_mode == 0x00)
+        for (uint8_t x = x1; x <= x2; x++)
         {
-            s_cursor_x++;
-            if (s_cursor_x > s_column_end)
-            {
-                s_cursor_x = s_column;
-                s_cursor_y++;
-            }
+            vga_controller_put_pixel(x, y, color);
         }
-        else
+    }
+}
+
+/* Draws single char of current fixed font and returns number of pixels to advance */
+static uint8_t vga_controller_put_char(uint8_t x, uint8_t y, uint8_t color, uint8_t ch)
+{
+    uint16_t unicode = ssd1306_unicode16FromUtf8(ch);
+    if (unicode == SSD1306_MORE_CHARS_REQUIRED) return 0;
+    SCharInfo char_info;
+    ssd1306_getCharBitmap(unicode, &char_info);
+    for (uint8_t j = 0; j < char_info.height; j++)
+    {
+        const uint8_t *glyph = char_info.glyph + (j >> 3) * char_info.width;
+        for (uint8_t i = 0; i < char_info.width; i++)
+        {
+            uint8_t bits = pgm_read_byte( &glyph[i] );
+            vga_controller_put_pixel(x + i, y + j, (bits & (1 << (j & 0x07))) ? color : 0);
+        }
+    }
+    return char_info.width + char_info.spacing;
+}
+
+/* Puts single pixel to current block position and moves cursor */
+static void vga_controller_put_data(uint8_t data)
+{
+    vga_controller_put_pixel(s_cursor_x, s_cursor_y, vga_controller_color3(data));
+    if (s_mode == 0x00)
+    {
+        s_cursor_x++;
+        if (s_cursor_x > s_column_end)
         {
+            s_cursor_x = s_column;
             s_cursor_y++;
-            if ((s_cursor_y & 0x07) == 0)
-            {
-                s_cursor_y -= 8;
-                s_cursor_x++;
-            }
         }
+    }
+    else
+    {
+        s_cursor_y++;
+        if ((s_cursor_y & 0x07) == 0)
+        {
+            s_cursor_y -= 8;
+            s_cursor_x++;
+        }
+    }
+}
+
+static void vga_controller_send_byte4(uint8_t data)
+{
+    if (s_vga_command == 0xFF)
+    {
+        s_vga_command = data;
+        return;
+    }
+    if (s_vga_command == 0x40)
+    {
+        vga_controller_put_data(data);
         return;
     }
     // command mode
@@ -165,6 +253,57 @@ static void vga_controller_send_byte4(uint8_t data)
     {
         if (s_vga_arg == 1) { s_mode = data; s_vga_command = 0; }
     }
+    if (s_vga_command == VGA_FILL_RECT)
+    {
+        if (s_vga_arg && s_vga_arg < 5) { s_vga_args[s_vga_arg - 1] = data; }
+        if (s_vga_arg == 5)
+        {
+            vga_controller_fill_rect(s_vga_args[0], s_vga_args[1], s_vga_args[2], s_vga_args[3],
+                                     vga_controller_color3(data));
+            s_vga_command = 0;
+        }
+    }
+    if (s_vga_command == VGA_DRAW_HLINE)
+    {
+        if (s_vga_arg && s_vga_arg < 4) { s_vga_args[s_vga_arg - 1] = data; }
+        if (s_vga_arg == 4)
+        {
+            vga_controller_fill_rect(s_vga_args[0], s_vga_args[1], s_vga_args[2], s_vga_args[1],
+                                     vga_controller_color3(data));
+            s_vga_command = 0;
+        }
+    }
+    if (s_vga_command == VGA_TEXT)
+    {
+        if (s_vga_arg && s_vga_arg < 5) { s_vga_args[s_vga_arg - 1] = data; }
+        if (s_vga_arg == 4 && !data) { s_vga_command = 0; }
+        if (s_vga_arg == 5)
+        {
+            s_vga_args[0] += vga_controller_put_char(s_vga_args[0], s_vga_args[1],
+                                                     vga_controller_color3(s_vga_args[2]), data);
+            if (!--s_vga_args[3]) s_vga_command = 0;
+            s_vga_arg = 4;
+        }
+    }
+    if (s_vga_command == VGA_PIXELS_RLE)
+    {
+        if (s_vga_arg == 1) { s_vga_args[0] = data; }
+        if (s_vga_arg == 2)
+        {
+            while (s_vga_args[0]--) vga_controller_put_data(data);
+            s_vga_command = 0;
+        }
+    }
+    if (s_vga_command == VGA_PIXELS)
+    {
+        if (s_vga_arg == 1) { s_vga_args[0] = data; if (!data) s_vga_command = 0; }
+        if (s_vga_arg == 2)
+        {
+            vga_controller_put_data(data);
+            if (!--s_vga_args[0]) s_vga_command = 0;
+            s_vga_arg = 1;
+        }
+    }
     s_vga_arg++;
 }
 
@@ -172,7 +311,7 @@ static void vga_controller_send_bytes(const uint8_t *buffer, uint16_t len)
 {
     while (len--)
     {
-        ssd1306_intf.send(*buffer);
+        vga_controller_send_byte4(*buffer);
         buffer++;
     }
 }
@@ -255,13 +394,19 @@ void ssd1306_vga_controller_96x40_init_enable_output_no_jitter_fix(void)
 //    set_sleep_mode (SLEEP_MODE_IDLE);
 }
 
+void ssd1306_vga_controller_96x40_nibble_mode(uint8_t double_lines)
+{
+    s_nibbles = 1;
+    s_row_shift = double_lines ? 1 : 0;
+}
+
 void ssd1306_debug_print_vga_buffer_96x40(void (*func)(uint8_t))
 {
     for(int y = 0; y < ssd1306_lcd.height; y++)
     {
         for(int x = 0; x < ssd1306_lcd.width; x++)
         {
-            uint8_t color = (__vga_buffer[(y*ssd1306_lcd.width + x)/2] >> ((x&1)<<2)) & 0x0F;
+            uint8_t color = (__vga_buffer[((y >> s_row_shift)*ssd1306_lcd.width + x)/2] >> ((x&1)<<2)) & 0x0F;
             if (color)
             {
                 func('#');
@@ -31,6 +31,13 @@
  * define VGA_CONTROLLER_DEBUG before including this header. If you want to use library with
  * AVR sleep mode, then jitter fix is not required, you will able to use TIMER0, so define
  * SSD1306_VGA_SLEEP_MODE before including this header.
+ * 96x40 mode can use nibble packed buffer (CONFIG_VGA_96X40_NIBBLE_ENABLE), which
+ * is output by simpler ISR code, but needs 1920 bytes. Define VGA_96X40_LINE_DOUBLING
+ * to use half-height buffer (960 bytes): each buffer line is shown for 2 pixel rows.
+ * 128x64 mode can output pixels via USART in master SPI mode (define VGA_128X64_MSPIM):
+ * USART shifts pixels out of TXD (D1) at fosc/2, so scan line takes 256 cycles
+ * instead of ~370, and the picture is about 70% of its usual width. Serial cannot be used
+ * in this mode.
  */
 
 #ifndef _SSD1306_VGA_ATMEGA328P_ISR_H_
@@ -61,16 +68,31 @@ static const volatile uint8_t *__VGA_BUFFER_PTR = &__vga_buffer[0];
 void ssd1306_vga_controller_128x64_init_no_output(void);
 void ssd1306_vga_controller_128x64_init_enable_output(void);
 void ssd1306_vga_controller_128x64_init_enable_output_no_jitter_fix(void);
+void ssd1306_vga_controller_128x64_init_mspim(uint8_t enable_jitter_fix);
 void ssd1306_debug_print_vga_buffer_128x64(void (*func)(uint8_t));
 
 #elif defined(CONFIG_VGA_96X40_ENABLE)
 
+#if defined(CONFIG_VGA_96X40_NIBBLE_ENABLE)
+#if defined(VGA_96X40_LINE_DOUBLING)
+static const uint16_t __VGA_VERTICAL_PIXELS = 20;
+static const uint16_t __VGA_PIXEL_HEIGHT = 20;
+volatile uint8_t      __vga_buffer[48*20] = {0};
+#else
+static const uint16_t __VGA_VERTICAL_PIXELS = 40;
+static const uint16_t __VGA_PIXEL_HEIGHT = 10;
+volatile uint8_t      __vga_buffer[48*40] = {0};
+#endif
+static const uint16_t __VGA_LINE_BYTES = 48;
+#else
 static const uint16_t __VGA_VERTICAL_PIXELS = 40;
 static const uint16_t __VGA_LINE_BYTES = 36;
 static const uint16_t __VGA_PIXEL_HEIGHT = 10;
 volatile uint8_t      __vga_buffer[36*40] = {0};
+#endif
 static const volatile uint8_t * __VGA_BUFFER_PTR = &__vga_buffer[0];
 
+void ssd1306_vga_controller_96x40_nibble_mode(uint8_t double_lines);
 void ssd1306_vga_controller_96x40_init_no_output(void);
 void ssd1306_vga_controller_96x40_init_enable_output(void);
 void ssd1306_vga_controller_96x40_init_enable_output_no_jitter_fix(void);
@@ -109,7 +131,47 @@ ISR(TIMER1_OVF_vect)
     timer0_millis += 16;
 } // end of TIMER1_OVF_vect
 
-#if defined(CONFIG_VGA_128X64_ENABLE)
+#if defined(CONFIG_VGA_128X64_ENABLE) && defined(VGA_128X64_MSPIM)
+static inline void /*__attribute__ ((noinline))*/ do_scan_line()
+{
+    // output all pixels: USART shifts out 8 pixels per 16 cycles, LSB first.
+    // Next byte is written as soon as transmit buffer is empty, so there are no gaps.
+    // TXD is high while transmitter is idle, so it is disabled at the end of the line.
+
+    asm volatile(
+         "ldi r25, %[txcmask]\n\t"
+         "sts %[ucsra], r25\n\t"   // clear TXC0
+         "ldi r25, %[txen]\n\t"
+         "ld r24, Z+\n\t"
+         "sts %[ucsrb], r25\n\t"
+         "sts %[udr], r24\n\t"
+
+         ".rept 15\n\t"
+
+         "ld r24, Z+\n\t"
+         "1: lds r25, %[ucsra]\n\t"
+         "sbrs r25, %[udre]\n\t"
+         "rjmp 1b\n\t"
+         "sts %[udr], r24\n\t"
+
+         ".endr\n\t"
+         "2: lds r25, %[ucsra]\n\t"
+         "sbrs r25, %[txc]\n\t"
+         "rjmp 2b\n\t"
+         "sts %[ucsrb], __zero_reg__\n\t"
+    :
+    : [ucsra] "n" (_SFR_MEM_ADDR(UCSR0A)),
+      [ucsrb] "n" (_SFR_MEM_ADDR(UCSR0B)),
+      [udr] "n" (_SFR_MEM_ADDR(UDR0)),
+      [udre] "I" (UDRE0),
+      [txc] "I" (TXC0),
+      [txcmask] "M" (1 << TXC0),
+      [txen] "M" (1 << TXEN0),
+       "z" "I" ((uint8_t *)s_current_scan_line_data )
+    : "r24", "r25", "memory"
+    );
+}
+#elif defined(CONFIG_VGA_128X64_ENABLE)
 static inline void /*__attribute__ ((noinline))*/ do_scan_line()
 {
     // output all pixels
@@ -151,6 +213,44 @@ static inline void /*__attribute__ ((noinline))*/ do_scan_line()
     : "r24", "memory"
     );
 }
+#elif defined(CONFIG_VGA_96X40_ENABLE) && defined(CONFIG_VGA_96X40_NIBBLE_ENABLE)
+static inline void /*__attribute__ ((noinline))*/ do_scan_line()
+{
+    // output all pixels: 3 cycles per pixel, no bits shuffling needed
+
+    asm volatile(
+         ".rept 48
+	"
+
+         "ld r24, Z+
+	"        // r24 = -222-111
+         "out %[port], r24
+	"  // 111
+         "swap r24
+	"          // r24 = -111-222
+         "nop
+	"
+         "out %[port], r24
+	"  // 222
+
+         ".endr
+	"
+         "nop
+	"
+         "nop
+	"
+         "ldi r24,0
+	"
+         "out %[port], r24 
+	"
+         "nop
+	"
+    :
+    : [port] "I" (_SFR_IO_ADDR(PORTC)),
+       "z" "I" ((uint8_t *)s_current_scan_line_data )
+    : "r24", "memory"
+    );
+}
 #elif defined(CONFIG_VGA_96X40_ENABLE)
 static inline void /*__attribute__ ((noinline))*/ do_scan_line()
 {
@@ -269,6 +369,10 @@ static inline void ssd1306_vga_controller_init(void)
     // if there is no builtin support then only debug mode is available
 #if defined(VGA_CONTROLLER_DEBUG)
     ssd1306_vga_controller_128x64_init_no_output();
+#elif defined(VGA_128X64_MSPIM) && defined(SSD1306_VGA_SLEEP_MODE)
+    ssd1306_vga_controller_128x64_init_mspim(0);
+#elif defined(VGA_128X64_MSPIM)
+    ssd1306_vga_controller_128x64_init_mspim(1);
 #elif defined(SSD1306_VGA_SLEEP_MODE)
     ssd1306_vga_controller_128x64_init_enable_output_no_jitter_fix();
 #else
@@ -293,6 +397,9 @@ static inline void ssd1306_vga_controller_init(void)
 #else
     ssd1306_vga_controller_96x40_init_enable_output();
 #endif
+#if defined(CONFIG_VGA_96X40_NIBBLE_ENABLE)
+    ssd1306_vga_controller_96x40_nibble_mode(__VGA_VERTICAL_PIXELS < 40);
+#endif
 }
 
 void ssd1306_debug_print_vga_buffer(void (*func)(uint8_t))
@@ -9,6 +9,10 @@
 #include "driver/i2s.h"
 
 #define I2S_VGA_SAMPLE_RATE   (4000000)
+/* Highest sample rate, used if frame buffer width doesn't fit active line at lower rate */
+#define I2S_VGA_MAX_SAMPLE_RATE (8000000)
+/* Number of DMA buffers, each buffer holds single line */
+#define I2S_VGA_DMA_LINES     (8)
 static const i2s_port_t I2S_PORT = (i2s_port_t)I2S_NUM_0;
 
 const TechProperties PALProperties = {
@@ -68,6 +72,8 @@ void CompositeOutput::init(int xres, int yres, int bpp)
     m_buffer_width = xres;
     m_buffer_height = yres;
     m_bpp = bpp;
+    m_stride = xres * bpp / 8;
+    m_pixels_per_byte = 8 / bpp;
 
     linesOdd = properties.lines / 2;
     linesEven = properties.lines - linesOdd;
@@ -76,8 +82,14 @@ void CompositeOutput::init(int xres, int yres, int bpp)
     linesEvenVisible = linesEvenActive - properties.linesOverscanTop - properties.linesOverscanBottom;
     linesOddVisible = linesOddActive - properties.linesOverscanTop - properties.linesOverscanBottom;
 
-    targetYresOdd = (yres / 2 < linesOddVisible) ? yres / 2 : linesOddVisible;
-    targetYresEven = (yres - targetYresOdd < linesEvenVisible) ? yres - targetYresOdd : linesEvenVisible;
+    /* Both fields show whole frame buffer, each row is repeated to fill the screen */
+    m_line_repeat = linesOddVisible / yres;
+    if (m_line_repeat < 1)
+    {
+        m_line_repeat = 1;
+    }
+    targetYresOdd = (yres * m_line_repeat < linesOddVisible) ? yres * m_line_repeat : linesOddVisible;
+    targetYresEven = (yres * m_line_repeat < linesEvenVisible) ? yres * m_line_repeat : linesEvenVisible;
     targetYres = targetYresEven + targetYresOdd;
 
     linesEvenBlankTop = properties.linesFirstTop - LINES_SYNC_TOP + properties.linesOverscanTop + (linesEvenVisible - targetYresEven) / 2;
@@ -85,13 +97,23 @@ void CompositeOutput::init(int xres, int yres, int bpp)
     linesOddBlankTop = linesEvenBlankTop;
     linesOddBlankBottom = linesOdd - linesOddBlankTop - targetYresOdd - LINES_SYNC_BOTTOM;
 
-    double samplesPerSecond = I2S_VGA_SAMPLE_RATE;
-    double samplesPerMicro = samplesPerSecond * 0.000001;
-    m_samples_per_line = (int)(samplesPerMicro * properties.lineMicros + 1.5) & ~1;
-    samplesSync = samplesPerMicro * properties.syncMicros + 0.5;
-    samplesBlank = samplesPerMicro * (properties.blankEndMicros - properties.syncMicros + properties.overscanLeftMicros) + 0.5;
-    samplesBack = samplesPerMicro * (properties.backMicros + properties.overscanRightMicros) + 0.5;
-    samplesActive = m_samples_per_line - samplesSync - samplesBlank - samplesBack;
+    m_sample_rate = I2S_VGA_SAMPLE_RATE;
+    for (;;)
+    {
+        double samplesPerMicro = m_sample_rate * 0.000001;
+        m_samples_per_line = (int)(samplesPerMicro * properties.lineMicros + 1.5) & ~1;
+        samplesSync = samplesPerMicro * properties.syncMicros + 0.5;
+        samplesBlank = samplesPerMicro * (properties.blankEndMicros - properties.syncMicros + properties.overscanLeftMicros) + 0.5;
+        samplesBack = samplesPerMicro * (properties.backMicros + properties.overscanRightMicros) + 0.5;
+        samplesActive = m_samples_per_line - samplesSync - samplesBlank - samplesBack;
+        /* Each pixel needs at least one sample */
+        if (xres <= samplesActive || m_sample_rate >= I2S_VGA_MAX_SAMPLE_RATE)
+        {
+            break;
+        }
+        m_sample_rate *= 2;
+    }
+    double samplesPerMicro = m_sample_rate * 0.000001;
 
     targetXres = xres < samplesActive ? xres : samplesActive;
 
@@ -102,29 +124,54 @@ void CompositeOutput::init(int xres, int yres, int bpp)
 
 //    pixelAspect = (float(samplesActive) / (linesEvenVisible + linesOddVisible)) / properties.imageAspect;
 
-    line = (uint16_t*)malloc(sizeof(uint16_t) * m_samples_per_line * 2);
-    m_ptr = line;
-    m_end = line + m_samples_per_line * 2;
-
+    init_lines();
     init_hardware();
 }
 
+void CompositeOutput::init_lines()
+{
+    /* Sync and blank parts of the lines never change, so they are generated once */
+    m_lines = (uint16_t*)malloc(sizeof(uint16_t) * m_samples_per_line * LINE_TYPES);
+    m_ptr = m_lines;
+    generate_long_sync();
+    generate_short_sync();
+    generate_long_short_sync();
+    generate_short_long_sync();
+    generate_short_blank_sync();
+    generate_blank_short_sync();
+    generate_blank_line();
+    generate_data_line();
+    /* Each pixels byte is converted to samples at once: 8 for mono, 2 for 4-bit grayscale */
+    m_lut = (uint16_t*)malloc(sizeof(uint16_t) * 256 * m_pixels_per_byte);
+    int mask = (1 << m_bpp) - 1;
+    for (int value = 0; value < 256; value++)
+    {
+        for (int pixel = 0; pixel < m_pixels_per_byte; pixel++)
+        {
+            int gray = (value >> (pixel * m_bpp)) & mask;
+            int level = m_bpp == 1 ? (gray ? 0x80: 0x00)
+                                   : (gray * (grayValues - 1) + mask / 2) / mask;
+            m_lut[value * m_pixels_per_byte + pixel] = (levelBlack + level) << 8;
+        }
+    }
+}
+
 void CompositeOutput::init_hardware()
 {
     i2s_config_t i2s_config = {
        .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX | I2S_MODE_DAC_BUILT_IN),
-       .sample_rate = I2S_VGA_SAMPLE_RATE,  //not really used
+       .sample_rate = m_sample_rate,  //not really used
        .bits_per_sample = (i2s_bits_per_sample_t)I2S_BITS_PER_SAMPLE_16BIT,
        .channel_format = I2S_CHANNEL_FMT_ONLY_RIGHT,
        .communication_format = I2S_COMM_FORMAT_I2S_MSB,
        .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-       .dma_buf_count = 2,
+       .dma_buf_count = I2S_VGA_DMA_LINES,
        .dma_buf_len = m_samples_per_line  //a buffer per line
     };
 
     i2s_driver_install(I2S_PORT, &i2s_config, 0, NULL);    //start i2s driver
     i2s_set_pin(I2S_PORT, NULL);                           //use internal DAC
-    i2s_set_sample_rates(I2S_PORT, I2S_VGA_SAMPLE_RATE);   //dummy sample rate, since the function fails at high values
+    i2s_set_sample_rates(I2S_PORT, m_sample_rate);         //dummy sample rate, since the function fails at high values
 }
 
 void CompositeOutput::fillValues(uint8_t value, int count)
@@ -136,56 +183,65 @@ void CompositeOutput::fillValues(uint8_t value, int count)
     }
 }
 
-void CompositeOutput::sendFrameHalfResolution(const uint8_t *frame)
+void SSD1306_IRAM CompositeOutput::send_line(LineType type)
 {
-    generate_long_sync();       // 1
-    generate_long_sync();       // 2
-    generate_long_short_sync(); // 3
-    generate_short_sync();      // 4
-    generate_short_sync();      // 5
-    for (int y = 0; y < linesEvenBlankTop; y++)
+    i2s_write_bytes(I2S_PORT, (char*)&m_lines[type * m_samples_per_line],
+                    sizeof(uint16_t) * m_samples_per_line, portMAX_DELAY);
+}
+
+void SSD1306_IRAM CompositeOutput::send_field(const uint8_t *frame, int lines)
+{
+    int repeat = 0;
+    for (int y = 0; y < lines; y++)
     {
-        generate_blank_line();  // top blank lines
+        const uint8_t *next = generate_line_from_buffer( frame );  // real data
+        if (++repeat == m_line_repeat)
+        {
+            frame = next;
+            repeat = 0;
+        }
     }
+}
 
-    for (int y = 0; y < targetYresEven; y++)
+void SSD1306_IRAM CompositeOutput::sendFrameHalfResolution(const uint8_t *frame)
+{
+    send_line(LINE_LONG_SYNC);       // 1
+    send_line(LINE_LONG_SYNC);       // 2
+    send_line(LINE_LONG_SHORT_SYNC); // 3
+    send_line(LINE_SHORT_SYNC);      // 4
+    send_line(LINE_SHORT_SYNC);      // 5
+    for (int y = 0; y < linesEvenBlankTop; y++)
     {
-        generate_line_from_buffer( &frame[(y >> 3)*(m_buffer_width * m_bpp / 8)] );  // real data
+        send_line(LINE_BLANK);       // top blank lines
     }
+
+    send_field(frame, targetYresEven);
     for (int y = 0; y < linesEvenBlankBottom; y++)
     {
-        generate_blank_line();  // bottom blank lines
+        send_line(LINE_BLANK);       // bottom blank lines
     }
-    generate_short_sync();      // 311
-    generate_short_sync();      // 312
+    send_line(LINE_SHORT_SYNC);      // 311
+    send_line(LINE_SHORT_SYNC);      // 312
 
-    generate_short_long_sync();      // 313
-    generate_long_sync();       // 314
-    generate_long_sync();       // 315
-    generate_short_sync();      // 316
-    generate_short_sync();      // 317
+    send_line(LINE_SHORT_LONG_SYNC); // 313
+    send_line(LINE_LONG_SYNC);       // 314
+    send_line(LINE_LONG_SYNC);       // 315
+    send_line(LINE_SHORT_SYNC);      // 316
+    send_line(LINE_SHORT_SYNC);      // 317
 
-    generate_short_blank_sync(); // 318
+    send_line(LINE_SHORT_BLANK_SYNC); // 318
     for (int y = 0; y < linesOddBlankTop; y++)
     {
-        generate_blank_line();  // top blank lines
-    }
-    for (int y = 0; y < targetYresOdd; y++)
-    {
-        generate_line_from_buffer( &frame[(y>>3)*(m_buffer_width * m_bpp / 8)] );  // real data
+        send_line(LINE_BLANK);       // top blank lines
     }
+    send_field(frame, targetYresOdd);
     for(int y = 0; y < linesOddBlankBottom; y++)
     {
-        generate_blank_line();  // bottom blank lines
-    }
-    generate_blank_short_sync();  // 623
-    generate_short_sync();        // 624
-    generate_short_sync();        // 625
-    if (m_ptr != line) // force to send data
-    {
-        i2s_write_bytes(I2S_PORT, (char*)line, (m_ptr - line) * sizeof(uint16_t), portMAX_DELAY);
-        m_ptr = line;
+        send_line(LINE_BLANK);       // bottom blank lines
     }
+    send_line(LINE_BLANK_SHORT_SYNC); // 623
+    send_line(LINE_SHORT_SYNC);       // 624
+    send_line(LINE_SHORT_SYNC);       // 625
 }
 
 void CompositeOutput::generate_long_sync()
@@ -195,7 +251,6 @@ void CompositeOutput::generate_long_sync()
         fillValues(levelSync, m_samples_per_line / 2 - samplesVSyncShort);
         fillValues(levelBlank, samplesVSyncShort);
     }
-    check_buffer();
 }
 
 void CompositeOutput::generate_short_sync()
@@ -205,7 +260,6 @@ void CompositeOutput::generate_short_sync()
         fillValues(levelSync, samplesVSyncShort);
         fillValues(levelBlank, m_samples_per_line / 2 - samplesVSyncShort);
     }
-    check_buffer();
 }
 
 void CompositeOutput::generate_long_short_sync()
@@ -214,7 +268,6 @@ void CompositeOutput::generate_long_short_sync()
     fillValues(levelBlank, samplesVSyncShort);
     fillValues(levelSync, samplesVSyncShort);
     fillValues(levelBlank, m_samples_per_line / 2 - samplesVSyncShort);
-    check_buffer();
 }
 
 void CompositeOutput::generate_short_long_sync()
@@ -223,7 +276,6 @@ void CompositeOutput::generate_short_long_sync()
     fillValues(levelBlank, m_samples_per_line / 2 - samplesVSyncShort);
     fillValues(levelSync, m_samples_per_line / 2 - samplesVSyncShort);
     fillValues(levelBlank, samplesVSyncShort);
-    check_buffer();
 }
 
 void CompositeOutput::generate_short_blank_sync()
@@ -231,7 +283,6 @@ void CompositeOutput::generate_short_blank_sync()
     fillValues(levelSync, samplesVSyncShort);
     fillValues(levelBlank, m_samples_per_line / 2 - samplesVSyncShort);
     fillValues(levelBlank, m_samples_per_line / 2);
-    check_buffer();
 }
 
 void CompositeOutput::generate_blank_short_sync()
@@ -240,7 +291,6 @@ void CompositeOutput::generate_blank_short_sync()
     fillValues(levelBlank, m_samples_per_line / 2 - samplesSync);
     fillValues(levelSync, samplesVSyncShort);
     fillValues(levelBlank, m_samples_per_line / 2 - samplesVSyncShort);
-    check_buffer();
 }
 
 void CompositeOutput::generate_blank_line()
@@ -249,35 +299,38 @@ void CompositeOutput::generate_blank_line()
     fillValues(levelBlank, samplesBlank);
     fillValues(levelBlack, samplesActive);
     fillValues(levelBlank, samplesBack);
-    check_buffer();
 }
 
-const uint8_t* CompositeOutput::generate_line_from_buffer(const uint8_t *pixels)
+void CompositeOutput::generate_data_line()
 {
     fillValues(levelSync, samplesSync);
     fillValues(levelBlank, samplesBlank);
     fillValues(levelBlack, samplesBlackLeft);
-    for (int x = 0; x < targetXres; x++)
-    {
-        uint8_t color = pixels[(x >> 3)] & (1<< (x&0x07));
-//        *m_ptr = (levelBlack + pixels[x]) << 8;
-        *m_ptr = (levelBlack + (color ? 0x80: 0x00 )) << 8;
-        m_ptr++;
-    }
+    m_active = m_ptr;
+    fillValues(levelBlack, targetXres);
     fillValues(levelBlack, samplesBlackRight);
     fillValues(levelBlank, samplesBack);
-    check_buffer();
-    return pixels + m_buffer_width * m_bpp / 8;
-//    return pixels + targetXres;
 }
 
-void CompositeOutput::check_buffer()
+const uint8_t* SSD1306_IRAM CompositeOutput::generate_line_from_buffer(const uint8_t *pixels)
 {
-    if (m_ptr == m_end)
+    /* Only active pixels span of precomputed data line is updated */
+    uint16_t *ptr = m_active;
+    const uint8_t *src = pixels;
+    int x = 0;
+    for (; x + m_pixels_per_byte <= targetXres; x += m_pixels_per_byte)
     {
-        i2s_write_bytes(I2S_PORT, (char*)line, sizeof(uint16_t) * (m_end - line), portMAX_DELAY);
-        m_ptr = line;
+        memcpy(ptr, &m_lut[*src * m_pixels_per_byte], sizeof(uint16_t) * m_pixels_per_byte);
+        ptr += m_pixels_per_byte;
+        src++;
     }
+    if (x < targetXres)
+    {
+        memcpy(ptr, &m_lut[*src * m_pixels_per_byte], sizeof(uint16_t) * (targetXres - x));
+    }
+    send_line(LINE_DATA);
+    return pixels + m_stride;
+//    return pixels + targetXres;
 }
 
 #endif
@@ -88,15 +88,43 @@ private:
     int m_buffer_width = 0;
     int m_buffer_height = 0;
     int m_bpp = 0;
+    /** Number of bytes in single row of frame buffer */
+    int m_stride = 0;
+    /** Number of pixels, packed to single byte of frame buffer */
+    int m_pixels_per_byte = 8;
+    /** Number of output lines per single row of frame buffer */
+    int m_line_repeat = 1;
+    /** Samples per second, output rate is raised for wide frame buffers */
+    int m_sample_rate = 0;
 
 //    float pixelAspect;
 
-    uint16_t *line = nullptr;
-    uint16_t *m_end = nullptr;
+    /** Types of lines, precomputed once by init() */
+    enum LineType
+    {
+        LINE_LONG_SYNC,
+        LINE_SHORT_SYNC,
+        LINE_LONG_SHORT_SYNC,
+        LINE_SHORT_LONG_SYNC,
+        LINE_SHORT_BLANK_SYNC,
+        LINE_BLANK_SHORT_SYNC,
+        LINE_BLANK,
+        LINE_DATA,
+        LINE_TYPES
+    };
+
+    /** Precomputed samples for all line types, data line has sync and borders only */
+    uint16_t *m_lines = nullptr;
+    /** Pointer to active pixels span of data line */
+    uint16_t *m_active = nullptr;
+    /** Samples for all pixels of each pixels byte value */
+    uint16_t *m_lut = nullptr;
     uint16_t *m_ptr = nullptr;
 
     void init_hardware();
-    void check_buffer();
+    void init_lines();
+    void send_line(LineType type);
+    void send_field(const uint8_t *frame, int lines);
     void generate_vsync();
     void generate_long_sync();
     void generate_short_sync();
@@ -105,6 +133,7 @@ private:
     void generate_short_blank_sync();
     void generate_blank_short_sync();
     void generate_blank_line();
+    void generate_data_line();
     const uint8_t * generate_line_from_buffer(const uint8_t * buffer);
 };
 
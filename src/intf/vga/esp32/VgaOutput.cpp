@@ -0,0 +1,232 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "VgaOutput.h"
+
+#if defined(CONFIG_VGA_AVAILABLE) && defined(CONFIG_VGA_ENABLE) && defined(__XTENSA__)
+
+#include "soc/i2s_struct.h"
+#include "soc/i2s_reg.h"
+#include "soc/io_mux_reg.h"
+#include "soc/rtc.h"
+#include "driver/gpio.h"
+#include "driver/periph_ctrl.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+/* 640x480@60Hz timings with halved pixel clock: each sample is 2 VGA pixels wide */
+#define VGA_PIXEL_CLOCK       (12587500)
+#define VGA_FRONT_PORCH       (8)
+#define VGA_HSYNC             (48)
+#define VGA_BACK_PORCH        (24)
+#define VGA_PORCH_SAMPLES     (VGA_FRONT_PORCH + VGA_HSYNC + VGA_BACK_PORCH)
+#define VGA_VISIBLE_LINES     (480)
+#define VGA_V_FRONT_PORCH     (10)
+#define VGA_VSYNC_LINES       (2)
+#define VGA_V_BACK_PORCH      (33)
+#define VGA_TOTAL_LINES       (VGA_VISIBLE_LINES + VGA_V_FRONT_PORCH + VGA_VSYNC_LINES + VGA_V_BACK_PORCH)
+
+/* Sample bits in 8-bit mode */
+#define VGA_BIT3_RED          (0)
+#define VGA_BIT3_GREEN        (1)
+#define VGA_BIT3_BLUE         (2)
+#define VGA_BIT3_HSYNC        (6)
+#define VGA_BIT3_VSYNC        (7)
+/* Sync bits in 16-bit mode, color bits are RGB8 color as is */
+#define VGA_BIT8_HSYNC        (8)
+#define VGA_BIT8_VSYNC        (9)
+
+static i2s_dev_t &s_i2s = I2S1;
+
+uint8_t *VgaOutput::allocSamples(uint16_t count, uint16_t value)
+{
+    uint8_t *buffer = static_cast<uint8_t *>(heap_caps_malloc((uint32_t)count * (m_bits / 8), MALLOC_CAP_DMA));
+    if (buffer) fillSamples(buffer, 0, count, value);
+    return buffer;
+}
+
+void VgaOutput::fillSamples(uint8_t *buffer, uint16_t from, uint16_t count, uint16_t value)
+{
+    /* Porches are multiples of 4 samples, so swapped order of samples doesn't matter here */
+    for (uint16_t i = from; i < from + count; i++)
+    {
+        if (m_bits == 8) buffer[i] = value;
+        else reinterpret_cast<uint16_t *>(buffer)[i] = value;
+    }
+}
+
+void VgaOutput::setDescriptor(lldesc_t *desc, uint8_t *buffer, uint16_t samples, lldesc_t *next)
+{
+    desc->size = samples * (m_bits / 8);
+    desc->length = desc->size;
+    desc->offset = 0;
+    desc->sosf = 0;
+    desc->eof = 0;
+    desc->owner = 1;
+    desc->buf = buffer;
+    desc->qe.stqe_next = next;
+}
+
+bool VgaOutput::init(const SVgaPins *pins, uint8_t bits)
+{
+    m_bits = bits;
+    m_hsyncBit = 1 << (bits == 8 ? VGA_BIT3_HSYNC : VGA_BIT8_HSYNC);
+    m_vsyncBit = 1 << (bits == 8 ? VGA_BIT3_VSYNC : VGA_BIT8_VSYNC);
+    /* Both sync pulses have negative polarity in 640x480 mode */
+    m_syncIdle = m_hsyncBit | m_vsyncBit;
+    for (uint16_t color = 0; color < 256; color++)
+    {
+        /* Most significant bit of each RGB8 component */
+        m_lut3[color] = m_syncIdle |
+                        (((color >> 7) & 1) << VGA_BIT3_RED) |
+                        (((color >> 4) & 1) << VGA_BIT3_GREEN) |
+                        (((color >> 1) & 1) << VGA_BIT3_BLUE);
+    }
+    for (uint8_t v = 0; v < 2; v++)
+    {
+        uint16_t idle = v ? m_hsyncBit : m_syncIdle;
+        m_blank[v] = allocSamples(WIDTH, idle);
+        m_porch[v] = allocSamples(VGA_PORCH_SAMPLES, idle);
+        if (!m_blank[v] || !m_porch[v]) return false;
+        fillSamples(m_porch[v], VGA_FRONT_PORCH, VGA_HSYNC, idle & ~m_hsyncBit);
+    }
+    for (uint16_t y = 0; y < HEIGHT; y++)
+    {
+        /* Rows are allocated separately, since 150 KiB of 16-bit mode frame buffer *
+         * doesn't fit single block of ESP32 DMA capable memory                    */
+        m_rows[y] = allocSamples(WIDTH, m_syncIdle);
+        if (!m_rows[y]) return false;
+    }
+    m_descriptors = static_cast<lldesc_t *>(heap_caps_malloc(sizeof(lldesc_t) * VGA_TOTAL_LINES * 2, MALLOC_CAP_DMA));
+    if (!m_descriptors) return false;
+    for (uint16_t line = 0; line < VGA_TOTAL_LINES; line++)
+    {
+        lldesc_t *desc = &m_descriptors[line * 2];
+        uint8_t vsync = (line >= VGA_VISIBLE_LINES + VGA_V_FRONT_PORCH) &&
+                        (line < VGA_VISIBLE_LINES + VGA_V_FRONT_PORCH + VGA_VSYNC_LINES);
+        uint8_t *active = line < VGA_VISIBLE_LINES ? m_rows[line >> 1] : m_blank[vsync];
+        lldesc_t *next = line + 1 < VGA_TOTAL_LINES ? &desc[2] : &m_descriptors[0];
+        setDescriptor(&desc[0], active, WIDTH, &desc[1]);
+        setDescriptor(&desc[1], m_porch[vsync], VGA_PORCH_SAMPLES, next);
+    }
+    initPins(pins);
+    initHardware();
+    return true;
+}
+
+void VgaOutput::initPins(const SVgaPins *pins)
+{
+    int8_t map[16];
+    memset(map, -1, sizeof(map));
+    if (m_bits == 8)
+    {
+        map[VGA_BIT3_RED] = pins->red[0];
+        map[VGA_BIT3_GREEN] = pins->green[0];
+        map[VGA_BIT3_BLUE] = pins->blue[0];
+        map[VGA_BIT3_HSYNC] = pins->hsync;
+        map[VGA_BIT3_VSYNC] = pins->vsync;
+    }
+    else
+    {
+        /* RGB8 color: RRRGGGBB, pins are listed from most significant bit */
+        for (uint8_t i = 0; i < 3; i++) map[7 - i] = pins->red[i];
+        for (uint8_t i = 0; i < 3; i++) map[4 - i] = pins->green[i];
+        for (uint8_t i = 0; i < 2; i++) map[1 - i] = pins->blue[i];
+        map[VGA_BIT8_HSYNC] = pins->hsync;
+        map[VGA_BIT8_VSYNC] = pins->vsync;
+    }
+    for (uint8_t i = 0; i < m_bits; i++)
+    {
+        if (map[i] < 0) continue;
+        PIN_FUNC_SELECT(GPIO_PIN_MUX_REG[map[i]], PIN_FUNC_GPIO);
+        gpio_set_direction((gpio_num_t)map[i], GPIO_MODE_DEF_OUTPUT);
+        /* I2S1 outputs 16-bit samples on the upper half of its 24-bit bus */
+        gpio_matrix_out(map[i], I2S1O_DATA_OUT0_IDX + i + (m_bits == 16 ? 8 : 0), false, false);
+    }
+}
+
+void VgaOutput::initHardware()
+{
+    periph_module_enable(PERIPH_I2S1_MODULE);
+
+    s_i2s.conf.tx_reset = 1;
+    s_i2s.conf.tx_reset = 0;
+    s_i2s.lc_conf.out_rst = 1;
+    s_i2s.lc_conf.out_rst = 0;
+    s_i2s.conf.tx_fifo_reset = 1;
+    s_i2s.conf.tx_fifo_reset = 0;
+
+    /* LCD mode: samples are sent to parallel bus, one per clock */
+    s_i2s.conf2.val = 0;
+    s_i2s.conf2.lcd_en = 1;
+    s_i2s.conf2.lcd_tx_wrx2_en = 1;
+    s_i2s.conf2.lcd_tx_sdx2_en = 0;
+
+    s_i2s.sample_rate_conf.val = 0;
+    s_i2s.sample_rate_conf.tx_bits_mod = m_bits;
+    s_i2s.sample_rate_conf.tx_bck_div_num = 1;
+
+    /* Audio PLL gives precise pixel clock: freq = xtal * (4 + sdm2 + sdm1/256 + sdm0/65536) / (2 * (odir + 2)) */
+    const double freq = (double)VGA_PIXEL_CLOCK * 2 * (m_bits / 8);
+    long sdm = 0;
+    long sdmNext = 0;
+    int odir = -1;
+    do
+    {
+        odir++;
+        sdm = (long)(freq / (20000000. / (odir + 2)) * 0x10000) - 0x40000;
+        sdmNext = (long)(freq / (20000000. / (odir + 3)) * 0x10000) - 0x40000;
+    } while ((sdm < 0x8c0ecL) && (odir < 31) && (sdmNext < 0xa1fffL));
+    if (sdm > 0xa1fffL) sdm = 0xa1fffL;
+    rtc_clk_apll_enable(true, sdm & 0xFF, (sdm >> 8) & 0xFF, sdm >> 16, odir);
+
+    s_i2s.clkm_conf.val = 0;
+    s_i2s.clkm_conf.clka_en = 1;
+    s_i2s.clkm_conf.clkm_div_num = 2;
+    s_i2s.clkm_conf.clkm_div_a = 1;
+    s_i2s.clkm_conf.clkm_div_b = 0;
+
+    s_i2s.fifo_conf.val = 0;
+    s_i2s.fifo_conf.tx_fifo_mod_force_en = 1;
+    s_i2s.fifo_conf.tx_fifo_mod = 1;
+    s_i2s.fifo_conf.tx_data_num = 32;
+    s_i2s.fifo_conf.dscr_en = 1;
+
+    s_i2s.conf1.val = 0;
+    s_i2s.conf1.tx_stop_en = 0;
+    s_i2s.conf1.tx_pcm_bypass = 1;
+
+    s_i2s.conf_chan.val = 0;
+    s_i2s.conf_chan.tx_chan_mod = 1;
+    s_i2s.conf.tx_right_first = 1;
+    s_i2s.timing.val = 0;
+
+    /* Descriptors are closed into a ring, so DMA never stops */
+    s_i2s.lc_conf.val = I2S_OUT_DATA_BURST_EN | I2S_OUTDSCR_BURST_EN;
+    s_i2s.out_link.addr = (uint32_t)&m_descriptors[0];
+    s_i2s.out_link.start = 1;
+    s_i2s.conf.tx_start = 1;
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file VgaOutput.h VGA output for ESP32 via I2S parallel mode and DMA
+ */
+
+#pragma once
+
+#include "ssd1306_hal/io.h"
+
+#if defined(CONFIG_VGA_AVAILABLE) && defined(CONFIG_VGA_ENABLE) && defined(__XTENSA__)
+
+#include <stdint.h>
+#include "rom/lldesc.h"
+#include "lcd/vga_monitor.h"
+
+/**
+ * Generates VGA signal (RGB and H-Sync/V-Sync) from frame buffer. I2S1 peripheral
+ * works in LCD (parallel) mode, and reads samples via DMA descriptor chain, closed
+ * into a ring. Each frame buffer row is referenced by descriptors of 2 scanlines
+ * (640x480 timings with pixel clock divided by 2), and sync pulses are taken from
+ * shared porch buffers. So, the hardware repeats frames forever without any CPU
+ * involvement. Frame buffer samples hold sync bits in idle state, color bits are
+ * changed by drawing functions directly.
+ */
+class VgaOutput
+{
+public:
+    /** Visible width in pixels */
+    static const uint16_t WIDTH = 320;
+    /** Visible height in pixels */
+    static const uint16_t HEIGHT = 240;
+
+    /**
+     * Allocates frame buffer and starts output.
+     * @param pins - GPIO pins of VGA connector
+     * @param bits - 8 for 3-bit color (1 pin per channel), 16 for RGB8 color
+     * @return false if there is not enough DMA capable memory
+     */
+    bool init(const SVgaPins *pins, uint8_t bits);
+
+    /** Returns number of bits in single sample: 8 or 16 */
+    uint8_t bits() const { return m_bits; }
+
+    /**
+     * Sets pixel color.
+     * @param x - horizontal position, must be less than WIDTH
+     * @param y - vertical position, must be less than HEIGHT
+     * @param color - RGB8 color
+     */
+    inline void SSD1306_IRAM setPixel(uint16_t x, uint16_t y, uint8_t color)
+    {
+        /* I2S sends samples of each 32-bit word in swapped order: *
+         * bytes 2,3,0,1 in 8-bit mode and words 1,0 in 16-bit mode */
+        if (m_bits == 8)
+            m_rows[y][x ^ 2] = m_lut3[color];
+        else
+            reinterpret_cast<uint16_t *>(m_rows[y])[x ^ 1] = color | m_syncIdle;
+    }
+
+private:
+    uint8_t m_bits = 0;
+    /** Sample value with both sync signals inactive and black color */
+    uint16_t m_syncIdle = 0;
+    /** Sync bits of the sample */
+    uint16_t m_hsyncBit = 0;
+    uint16_t m_vsyncBit = 0;
+    /** RGB8 to 3-bit sample conversion table, used in 8-bit mode */
+    uint8_t m_lut3[256];
+    /** Frame buffer rows, each row holds WIDTH samples */
+    uint8_t *m_rows[HEIGHT];
+    /** Black active part of blanking lines: without and with V-Sync */
+    uint8_t *m_blank[2] = { nullptr, nullptr };
+    /** Horizontal porches and H-Sync pulse: without and with V-Sync */
+    uint8_t *m_porch[2] = { nullptr, nullptr };
+    /** DMA descriptors ring: 2 descriptors per scanline */
+    lldesc_t *m_descriptors = nullptr;
+
+    uint8_t *allocSamples(uint16_t count, uint16_t value);
+    void fillSamples(uint8_t *buffer, uint16_t from, uint16_t count, uint16_t value);
+    void setDescriptor(lldesc_t *desc, uint8_t *buffer, uint16_t samples, lldesc_t *next);
+    void initPins(const SVgaPins *pins);
+    void initHardware();
+};
+
+#endif
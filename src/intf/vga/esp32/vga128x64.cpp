@@ -30,37 +30,69 @@
 #if defined(CONFIG_VGA_AVAILABLE) && defined(CONFIG_VGA_ENABLE) && defined(ESP32)
 
 #include "CompositeOutput.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <string.h>
 
 //#define VGA_CONTROLLER_DEBUG
 
+#ifndef VGA_OUTPUT_TASK_PRIORITY
+/** Priority of composite output task. The task sleeps most of time, waiting for i2s DMA */
+#define VGA_OUTPUT_TASK_PRIORITY  5
+#endif
+
+/* Back buffer: all drawing operations go here */
 static uint8_t *__vga_buffer = nullptr;
+/* Front buffer: output task streams it to composite output */
+static uint8_t *s_front = nullptr;
+static uint16_t s_buffer_size = 0;
+/* Set when back buffer has changes, not yet swapped to front buffer */
+static volatile bool s_swap_pending = false;
+/* Held while back buffer is being changed, so the swap never shows half drawn primitives */
+static SemaphoreHandle_t s_frame_mutex = nullptr;
 extern uint16_t ssd1306_color;
 
 // Set to ssd1306 compatible mode by default
 static uint8_t s_mode = 0x01;
 static uint8_t s_vga_command = 0xFF;
 static uint8_t s_vga_arg = 0;
-static uint8_t s_column = 0;
-static uint8_t s_column_end = 0;
-static uint8_t s_cursor_x = 0;
-static uint8_t s_cursor_y = 0;
-static uint8_t s_width = 0;
-static uint8_t s_height = 0;
+static uint16_t s_column = 0;
+static uint16_t s_column_end = 0;
+static uint16_t s_cursor_x = 0;
+static uint16_t s_cursor_y = 0;
+static uint16_t s_width = 0;
+static uint16_t s_height = 0;
 static uint8_t s_bpp = 0;
+/* Number of bytes in single row of vga buffer */
+static uint16_t s_stride = 0;
+/* RGB8 to 4-bit gray conversion table for grayscale modes */
+static uint8_t *s_gray = nullptr;
 
 static CompositeOutput output(CompositeOutput::PAL);
 
-static void compositeCore(void *data)
+static void SSD1306_IRAM compositeCore(void *data)
 {
     while (true)
     {
-        //just send the graphics frontbuffer whithout any interruption 
-        output.sendFrameHalfResolution(__vga_buffer);
+        //just send the graphics frontbuffer whithout any interruption
+        output.sendFrameHalfResolution(s_front);
+        // vsync: swap buffers if drawing is not in progress, or try on next frame
+        if (s_swap_pending && xSemaphoreTakeRecursive(s_frame_mutex, 0) == pdTRUE)
+        {
+            uint8_t *front = __vga_buffer;
+            __vga_buffer = s_front;
+            s_front = front;
+            memcpy(__vga_buffer, s_front, s_buffer_size);
+            s_swap_pending = false;
+            xSemaphoreGiveRecursive(s_frame_mutex);
+        }
     }
 }
 
 static void vga_controller_init(void)
 {
+    if (s_frame_mutex) xSemaphoreTakeRecursive(s_frame_mutex, portMAX_DELAY);
     s_vga_command = 0xFF;
 }
 
@@ -78,6 +110,7 @@ static void vga_controller_stop(void)
     #ifdef VGA_CONTROLLER_DEBUG
         ssd1306_debug_print_vga_buffer( uart_send_byte );
     #endif
+    if (s_frame_mutex) xSemaphoreGiveRecursive(s_frame_mutex);
 }
 
 static void vga_controller_close(void)
@@ -87,25 +120,52 @@ static void vga_controller_close(void)
 /*
  * Function sends 8 vertical pixels to buffer
  */
-static inline void vga_controller_put_pixels(uint8_t x, uint8_t y, uint8_t pixels)
+static inline void vga_controller_put_pixels(uint16_t x, uint16_t y, uint8_t pixels)
 {
-    uint16_t addr = (x >> 3)   + (uint16_t)(y * 16);
+    uint16_t addr = (x >> 3)   + (uint16_t)(y * s_stride);
     uint8_t offset = x & 0x07;
     uint8_t mask = 1 << offset;
-    if (addr >= 16*64)
+    if (x >= s_width)
     {
         return;
     }
-    for (uint8_t i=8; i>0; i--)
+    for (uint8_t i=8; i>0 && addr < s_buffer_size; i--)
     {
         if (pixels & 0x01) __vga_buffer[addr] |= mask;
                       else __vga_buffer[addr] &= ~mask;
-        addr += 16;
+        addr += s_stride;
         pixels >>= 1;
     }
 }
 
-static void vga_controller_send_byte(uint8_t data)
+/*
+ * Function sends single RGB8 pixel to 4-bit grayscale buffer
+ */
+static inline void vga_controller_put_pixel4(uint16_t x, uint16_t y, uint8_t color)
+{
+    if (x >= s_width || y >= s_height)
+    {
+        return;
+    }
+    uint16_t addr = (x >> 1) + (uint16_t)(y * s_stride);
+    if (x & 0x01) __vga_buffer[addr] = (__vga_buffer[addr] & 0x0F) | (s_gray[color] << 4);
+             else __vga_buffer[addr] = (__vga_buffer[addr] & 0xF0) | s_gray[color];
+}
+
+static void vga_controller_init_gray(void)
+{
+    s_gray = (uint8_t *) malloc(256);
+    for (int color = 0; color < 256; color++)
+    {
+        // luminance of RGB 3-3-2 color, scaled to 0..10000
+        int y = ((color >> 5) & 0x07) * 2990 / 7 +
+                ((color >> 2) & 0x07) * 5870 / 7 +
+                (color & 0x03) * 1140 / 3;
+        s_gray[color] = (y * 15 + 5000) / 10000;
+    }
+}
+
+static void SSD1306_IRAM vga_controller_send_byte(uint8_t data)
 {
     if (s_vga_command == 0xFF)
     {
@@ -114,12 +174,42 @@ static void vga_controller_send_byte(uint8_t data)
     }
     if (s_vga_command == 0x40)
     {
-        vga_controller_put_pixels(s_cursor_x, s_cursor_y, data);
-        s_cursor_x++;
-        if (s_cursor_x > s_column_end)
+        s_swap_pending = true;
+        if (s_bpp == 1)
         {
-            s_cursor_x = s_column;
-            s_cursor_y += 8;
+            vga_controller_put_pixels(s_cursor_x, s_cursor_y, data);
+            s_cursor_x++;
+            if (s_cursor_x > s_column_end)
+            {
+                s_cursor_x = s_column;
+                s_cursor_y += 8;
+            }
+            return;
+        }
+        vga_controller_put_pixel4(s_cursor_x, s_cursor_y, data);
+        if (s_mode == LCD_MODE_NORMAL)
+        {
+            s_cursor_x++;
+            if (s_cursor_x > s_column_end)
+            {
+                s_cursor_x = s_column;
+                s_cursor_y++;
+            }
+        }
+        else
+        {
+            // ssd1306 compatible mode: 8 vertical pixels, then next column
+            s_cursor_y++;
+            if ((s_cursor_y & 0x07) == 0)
+            {
+                s_cursor_y -= 8;
+                s_cursor_x++;
+                if (s_cursor_x > s_column_end)
+                {
+                    s_cursor_x = s_column;
+                    s_cursor_y += 8;
+                }
+            }
         }
         return;
     }
@@ -138,7 +228,8 @@ static void vga_controller_send_byte(uint8_t data)
             s_cursor_x = s_column;
         }
         if (s_vga_arg == 2) { s_column_end = data >= ssd1306_lcd.width ? ssd1306_lcd.width - 1 : data; }
-        if (s_vga_arg == 3) { s_cursor_y = (data << 3); }
+        // 1-bit modes accept page number, other modes accept row
+        if (s_vga_arg == 3) { s_cursor_y = s_bpp == 1 ? (data << 3) : data; }
         if (s_vga_arg == 4) { s_vga_command = 0; }
     }
     else if (s_vga_command == VGA_SET_MODE)
@@ -149,20 +240,31 @@ static void vga_controller_send_byte(uint8_t data)
     else if (s_vga_command == VGA_SET_RESOLUTION )
     {
         if (s_vga_arg == 1) { s_width = data; }
-        if (s_vga_arg == 2) { s_height = data; }
-        if (s_vga_arg == 3) { s_bpp = data; s_vga_command = 0; }
+        if (s_vga_arg == 2) { s_width |= (uint16_t)data << 8; }
+        if (s_vga_arg == 3) { s_height = data; }
+        if (s_vga_arg == 4) { s_bpp = data; s_vga_command = 0; }
     }
     else if (s_vga_command == VGA_DISPLAY_ON )
     {
-        __vga_buffer = (uint8_t *) malloc(s_width * s_height * s_bpp / 8);
+        s_stride = s_width * s_bpp / 8;
+        s_buffer_size = s_stride * s_height;
+        if (s_bpp == 4)
+        {
+            vga_controller_init_gray();
+        }
+        __vga_buffer = (uint8_t *) calloc(s_buffer_size, 1);
+        s_front = (uint8_t *) calloc(s_buffer_size, 1);
         output.init(s_width, s_height, s_bpp);
-        xTaskCreatePinnedToCore(compositeCore, "c", 1024, NULL, 1, NULL, 0);
+        // Created locked, since the command is sent inside start()/stop() transaction
+        s_frame_mutex = xSemaphoreCreateRecursiveMutex();
+        xSemaphoreTakeRecursive(s_frame_mutex, portMAX_DELAY);
+        xTaskCreatePinnedToCore(compositeCore, "c", 1024, NULL, VGA_OUTPUT_TASK_PRIORITY, NULL, 0);
         s_vga_command = 0;
     }
     s_vga_arg++;
 }
 
-static void vga_controller_send_bytes(const uint8_t *buffer, uint16_t len)
+static void SSD1306_IRAM vga_controller_send_bytes(const uint8_t *buffer, uint16_t len)
 {
     while (len--)
     {
@@ -171,6 +273,23 @@ static void vga_controller_send_bytes(const uint8_t *buffer, uint16_t len)
     }
 }
 
+void ssd1306_vgaLockFrame(void)
+{
+    if (s_frame_mutex) xSemaphoreTakeRecursive(s_frame_mutex, portMAX_DELAY);
+}
+
+void ssd1306_vgaUnlockFrame(void)
+{
+    // Back buffer could be changed directly via ssd1306_vgaGetBuffer()
+    s_swap_pending = true;
+    if (s_frame_mutex) xSemaphoreGiveRecursive(s_frame_mutex);
+}
+
+uint8_t *ssd1306_vgaGetBuffer(void)
+{
+    return __vga_buffer;
+}
+
 extern "C" void ssd1306_CompositeVideoInit_esp32(void);
 void ssd1306_CompositeVideoInit_esp32(void)
 {
@@ -188,7 +307,8 @@ void ssd1306_debug_print_vga_buffer_128x64(void (*func)(uint8_t))
     {
         for(int x = 0; x < ssd1306_lcd.width; x++)
         {
-            uint8_t color = __vga_buffer[(x >> 3) + y * 16] & (1<< (x&0x07));
+            uint8_t color = s_bpp == 1 ? __vga_buffer[(x >> 3) + y * s_stride] & (1<< (x&0x07))
+                                       : __vga_buffer[(x >> 1) + y * s_stride] & ((x & 0x01) ? 0x80 : 0x08);
             if (color)
             {
                 func('#');
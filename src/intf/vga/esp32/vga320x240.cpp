@@ -0,0 +1,195 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "intf/ssd1306_interface.h"
+#include "lcd/lcd_common.h"
+#include "lcd/vga_monitor.h"
+
+#if defined(CONFIG_VGA_AVAILABLE) && defined(CONFIG_VGA_ENABLE) && defined(ESP32)
+
+#include "VgaOutput.h"
+
+/* Drawing functions write to VGA frame buffer directly, no bus is involved */
+
+static VgaOutput s_output;
+static lcduint_t s_column = 0;
+static lcduint_t s_column_end = 0;
+static lcduint_t s_cursor_x = 0;
+static lcduint_t s_cursor_y = 0;
+static lcd_mode_t s_mode = LCD_MODE_SSD1306_COMPAT;
+extern "C" uint16_t ssd1306_color;
+
+static void vga320_set_block(lcduint_t x, lcduint_t y, lcduint_t w)
+{
+    s_column = x;
+    s_column_end = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
+    if (s_column_end >= ssd1306_lcd.width) s_column_end = ssd1306_lcd.width - 1;
+    s_cursor_x = x;
+    // ssd1306 compatible mode accepts page number
+    s_cursor_y = s_mode == LCD_MODE_NORMAL ? y : (y << 3);
+}
+
+static void vga320_next_page(void)
+{
+    if (s_mode != LCD_MODE_NORMAL)
+    {
+        s_cursor_x = s_column;
+        s_cursor_y = (s_cursor_y & ~0x07) + 8;
+    }
+}
+
+static inline void vga320_put_pixel(uint8_t color)
+{
+    if ((s_cursor_x < ssd1306_lcd.width) && (s_cursor_y < ssd1306_lcd.height))
+    {
+        s_output.setPixel(s_cursor_x, s_cursor_y, color);
+    }
+}
+
+static void SSD1306_IRAM vga320_send_pixels1(uint8_t data)
+{
+    // 8 vertical pixels, then next column
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        vga320_put_pixel( (data & 0x01) ? (uint8_t)ssd1306_color : 0x00 );
+        s_cursor_y++;
+        data >>= 1;
+    }
+    s_cursor_y -= 8;
+    s_cursor_x++;
+    if (s_cursor_x > s_column_end)
+    {
+        s_cursor_x = s_column;
+        s_cursor_y += 8;
+    }
+}
+
+static void SSD1306_IRAM vga320_send_pixels_buffer1(const uint8_t *buffer, uint16_t len)
+{
+    while (len--)
+    {
+        vga320_send_pixels1(*buffer);
+        buffer++;
+    }
+}
+
+static void SSD1306_IRAM vga320_send_pixels8(uint8_t color)
+{
+    vga320_put_pixel(color);
+    if (s_mode == LCD_MODE_NORMAL)
+    {
+        s_cursor_x++;
+        if (s_cursor_x > s_column_end)
+        {
+            s_cursor_x = s_column;
+            s_cursor_y++;
+        }
+        return;
+    }
+    // ssd1306 compatible mode: 8 vertical pixels, then next column
+    s_cursor_y++;
+    if ((s_cursor_y & 0x07) == 0)
+    {
+        s_cursor_y -= 8;
+        s_cursor_x++;
+        if (s_cursor_x > s_column_end)
+        {
+            s_cursor_x = s_column;
+            s_cursor_y += 8;
+        }
+    }
+}
+
+static void SSD1306_IRAM vga320_send_pixels_buffer8(const uint8_t *buffer, uint16_t len)
+{
+    while (len--)
+    {
+        vga320_send_pixels8(*buffer);
+        buffer++;
+    }
+}
+
+static void SSD1306_IRAM vga320_fill_pixels8(uint8_t color, uint32_t count)
+{
+    while (count--)
+    {
+        vga320_send_pixels8(color);
+    }
+}
+
+static void vga320_set_mode(lcd_mode_t mode)
+{
+    s_mode = mode;
+}
+
+static void vga320_intf_none(void)
+{
+}
+
+static void vga320_intf_send(uint8_t data)
+{
+}
+
+static void vga320_intf_send_buffer(const uint8_t *buffer, uint16_t size)
+{
+}
+
+static void vga320_init(const SVgaPins *pins, uint8_t bits)
+{
+    ssd1306_intf.spi = 0;
+    ssd1306_intf.start = vga320_intf_none;
+    ssd1306_intf.stop = vga320_intf_none;
+    ssd1306_intf.send = vga320_intf_send;
+    ssd1306_intf.send_buffer = vga320_intf_send_buffer;
+    ssd1306_intf.close = vga320_intf_none;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1331);
+    // Nothing is drawn, if there is not enough memory for frame buffer
+    ssd1306_lcd.width = 0;
+    ssd1306_lcd.height = 0;
+    ssd1306_lcd.set_block = vga320_set_block;
+    ssd1306_lcd.next_page = vga320_next_page;
+    ssd1306_lcd.send_pixels1 = vga320_send_pixels1;
+    ssd1306_lcd.send_pixels_buffer1 = vga320_send_pixels_buffer1;
+    ssd1306_lcd.send_pixels8 = vga320_send_pixels8;
+    ssd1306_lcd.send_pixels_buffer8 = vga320_send_pixels_buffer8;
+    ssd1306_lcd.fill_pixels8 = vga320_fill_pixels8;
+    ssd1306_lcd.set_mode = vga320_set_mode;
+    if (s_output.init(pins, bits))
+    {
+        ssd1306_lcd.width = VgaOutput::WIDTH;
+        ssd1306_lcd.height = VgaOutput::HEIGHT;
+    }
+}
+
+void vga_320x240_8colors_init(const SVgaPins *pins)
+{
+    vga320_init(pins, 8);
+}
+
+void vga_320x240_rgb8_init(const SVgaPins *pins)
+{
+    vga320_init(pins, 16);
+}
+
+#endif
@@ -64,6 +64,30 @@ void ssd1306_vga_delay(uint32_t ms);
  */
 void ssd1306_debug_print_vga_buffer(void (*func)(uint8_t));
 
+#if defined(ESP32)
+/**
+ * Composite video output on ESP32 is double buffered: drawing functions change
+ * back buffer, and output task swaps buffers on vsync. By default each drawing
+ * operation can be shown as soon as it is completed. Call ssd1306_vgaLockFrame()
+ * before drawing the frame, consisting of several operations, and
+ * ssd1306_vgaUnlockFrame() after, to show the whole frame at once.
+ */
+void ssd1306_vgaLockFrame(void);
+
+/**
+ * Allows output task to show changes, made since ssd1306_vgaLockFrame().
+ */
+void ssd1306_vgaUnlockFrame(void);
+
+/**
+ * Returns back buffer of composite video output for drawing directly in it,
+ * for example, with NanoCanvasVga1. The pointer is valid only between
+ * ssd1306_vgaLockFrame() and ssd1306_vgaUnlockFrame() calls, since buffers are
+ * swapped on vsync.
+ */
+uint8_t *ssd1306_vgaGetBuffer(void);
+#endif
+
 /**
  * Initializes hardware VGA controller
  * Be careful, this function reinitialized Atmega328p timers.
@@ -35,7 +35,27 @@ static const uint8_t PROGMEM s_composite128x64_initData[] =
     SDL_LCD_SSD1306,
     0x00,
 #endif
-    VGA_SET_RESOLUTION,128,64,1,
+    VGA_SET_RESOLUTION,128,0,64,1,
+    VGA_DISPLAY_ON,
+};
+
+static const uint8_t PROGMEM s_composite256x192_initData[] =
+{
+#ifdef SDL_EMULATION
+    SDL_LCD_SSD1306,
+    0x00,
+#endif
+    VGA_SET_RESOLUTION,0,1,192,1,
+    VGA_DISPLAY_ON,
+};
+
+static const uint8_t PROGMEM s_composite160x120_initData[] =
+{
+#ifdef SDL_EMULATION
+    SDL_LCD_SSD1331_X8,
+    0x00,
+#endif
+    VGA_SET_RESOLUTION,160,0,120,4,
     VGA_DISPLAY_ON,
 };
 
@@ -84,8 +104,6 @@ static void vga_next_page2(void)
 {
 }
 
-#if 0
-
 static void vga_send_pixels(uint8_t data)
 {
     for (uint8_t i=8; i>0; i--)
@@ -102,7 +120,14 @@ static void vga_send_pixels(uint8_t data)
     }
 }
 
-#endif
+static void vga_send_pixels_buffer(const uint8_t *buffer, uint16_t len)
+{
+    while(len--)
+    {
+        vga_send_pixels(*buffer);
+        buffer++;
+    }
+}
 
 static void vga_set_mode(lcd_mode_t mode)
 {
@@ -124,19 +149,49 @@ static void vga_set_mode(lcd_mode_t mode)
     // empty for a while
 }
 
-void composite_video_128x64_mono_init(void)
+static void composite_video_mono_init(lcduint_t width, lcduint_t height)
 {
     // init vga interface
     ssd1306_vgaInit();
     // init display
-    ssd1306_lcd.type = LCD_TYPE_SSD1306;
-    ssd1306_lcd.width = 128;
-    ssd1306_lcd.height = 64;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1306);
+    ssd1306_lcd.width = width;
+    ssd1306_lcd.height = height;
     ssd1306_lcd.set_block = vga_set_block2;
     ssd1306_lcd.next_page = vga_next_page2;
     ssd1306_lcd.send_pixels1  = ssd1306_intf.send;
     ssd1306_lcd.send_pixels_buffer1 = ssd1306_intf.send_buffer;
     ssd1306_lcd.set_mode = vga_set_mode;
+}
+
+void composite_video_128x64_mono_init(void)
+{
+    composite_video_mono_init(128, 64);
     ssd1306_configureI2cDisplay( s_composite128x64_initData, sizeof(s_composite128x64_initData));
 }
 
+void composite_video_256x192_mono_init(void)
+{
+    composite_video_mono_init(256, 192);
+    ssd1306_configureI2cDisplay( s_composite256x192_initData, sizeof(s_composite256x192_initData));
+}
+
+void composite_video_160x120_gray4_init(void)
+{
+    // init vga interface
+    ssd1306_vgaInit();
+    // init display
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1331);
+    ssd1306_lcd.width = 160;
+    ssd1306_lcd.height = 120;
+    ssd1306_lcd.set_block = vga_set_block1;
+    ssd1306_lcd.next_page = vga_next_page1;
+    ssd1306_lcd.send_pixels1  = vga_send_pixels;
+    ssd1306_lcd.send_pixels_buffer1 = vga_send_pixels_buffer;
+    ssd1306_lcd.send_pixels8 = ssd1306_intf.send;
+    ssd1306_lcd.send_pixels_buffer8 = ssd1306_sendPixelsBuffer8;
+    ssd1306_lcd.fill_pixels8 = ssd1306_fillPixels8;
+    ssd1306_lcd.set_mode = vga_set_mode;
+    ssd1306_configureI2cDisplay( s_composite160x120_initData, sizeof(s_composite160x120_initData));
+}
+
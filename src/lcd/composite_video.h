@@ -51,6 +51,28 @@ extern "C" {
  */
 void composite_video_128x64_mono_init(void);
 
+/**
+ * @brief Inits 256x192 monochrome composite video display.
+ *
+ * Inits 256x192 monochrome composite video display. This mode supports 2 colors:
+ * black and white. Frame buffer takes 6 KiB, and the display works in the same way
+ * as 128x64 mode, but uses higher output sample rate.
+ *
+ * @see composite_video_128x64_mono_init()
+ */
+void composite_video_256x192_mono_init(void);
+
+/**
+ * @brief Inits 160x120 4-bit grayscale composite video display.
+ *
+ * Inits 160x120 composite video display with 16 gray levels. The display accepts
+ * RGB8 pixels like other 8-bit displays, and converts them to gray levels.
+ * Use NanoCanvas8 and TILE_..._GRAY4 tiles for drawing.
+ *
+ * @see composite_video_128x64_mono_init()
+ */
+void composite_video_160x120_gray4_init(void);
+
 /**
  * @}
  */
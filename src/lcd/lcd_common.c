@@ -23,11 +23,15 @@
 */
 
 #include "lcd/lcd_common.h"
+#include "lcd/lcd_simd.h"
 #include "intf/ssd1306_interface.h"
 #include "intf/spi/ssd1306_spi.h"
+#include "nano_gfx_types.h"
 #include <stddef.h>
+#include <string.h>
 
 #define CMD_ARG 0xFF
+#define CMD_DELAY 0xFE
 
 ssd1306_lcd_t ssd1306_lcd = { 0 };
 
@@ -38,45 +42,872 @@ void ssd1306_sendData(uint8_t data)
     ssd1306_intf.stop();
 }
 
-void ssd1306_configureI2cDisplay(const uint8_t *config, uint8_t configSize)
+void ssd1306_batchBegin(ssd1306_batch_t *batch)
 {
-    ssd1306_commandStart();
-    for( uint8_t i=0; i<configSize; i++)
+    batch->size = 0;
+    batch->args = 0;
+    batch->started = 0;
+    batch->mode = 0;
+}
+
+static void ssd1306_batchSwitch(ssd1306_batch_t *batch, uint8_t mode)
+{
+    if (batch->started && batch->mode == mode)
     {
-        uint8_t data = pgm_read_byte(&config[i]);
-        ssd1306_intf.send(data);
+        return;
     }
-    ssd1306_intf.stop();
+    if (batch->started && ssd1306_intf.spi)
+    {
+        ssd1306_spiDataMode(mode);
+    }
+    else
+    {
+        /* i2c controllers get command/data mode via control byte at the start of transaction */
+        if (batch->started)
+        {
+            ssd1306_intf.stop();
+        }
+        if (mode) ssd1306_dataStart(); else ssd1306_commandStart();
+    }
+    batch->started = 1;
+    batch->mode = mode;
 }
 
-void ssd1306_configureSpiDisplay(const uint8_t *config, uint8_t configSize)
+void ssd1306_batchFlush(ssd1306_batch_t *batch)
+{
+    uint8_t i = 0;
+    while (i < batch->size)
+    {
+        uint8_t mode = (batch->args >> i) & 0x01;
+        uint8_t n = i + 1;
+        while ((n < batch->size) && (((batch->args >> n) & 0x01) == mode))
+        {
+            n++;
+        }
+        ssd1306_batchSwitch(batch, mode);
+        ssd1306_intf.send_buffer(&batch->data[i], n - i);
+        i = n;
+    }
+    batch->size = 0;
+    batch->args = 0;
+}
+
+static void ssd1306_batchAdd(ssd1306_batch_t *batch, uint8_t data, uint8_t mode)
 {
+    if (batch->size == SSD1306_BATCH_SIZE)
+    {
+        ssd1306_batchFlush(batch);
+    }
+    batch->data[batch->size] = data;
+    if (mode)
+    {
+        batch->args |= (1u << batch->size);
+    }
+    batch->size++;
+}
+
+void ssd1306_batchCommand(ssd1306_batch_t *batch, uint8_t cmd)
+{
+    ssd1306_batchAdd(batch, cmd, 0);
+}
+
+void ssd1306_batchArg(ssd1306_batch_t *batch, uint8_t arg)
+{
+    ssd1306_batchAdd(batch, arg, 1);
+}
+
+void ssd1306_batchRange16(ssd1306_batch_t *batch, uint8_t cmd, uint16_t start, uint16_t end, uint16_t *cache)
+{
+    if ((cache[0] == start) && (cache[1] == end))
+    {
+        return;
+    }
+    cache[0] = start;
+    cache[1] = end;
+    ssd1306_batchAdd(batch, cmd, 0);
+    ssd1306_batchAdd(batch, start >> 8, 1);
+    ssd1306_batchAdd(batch, start & 0xFF, 1);
+    ssd1306_batchAdd(batch, end >> 8, 1);
+    ssd1306_batchAdd(batch, end & 0xFF, 1);
+}
+
+#ifdef CONFIG_SSD1306_I2C_INTERLEAVE_ENABLE
+/*
+ * Sends the whole batch and switches to data mode in single i2c transaction: each byte
+ * follows control byte with Co bit set, and the last control byte (0x40) without Co bit
+ * makes the rest of transaction GDRAM data. Backends, splitting long transactions,
+ * restart chunks with the right control byte, see ssd1306_i2cControlTrack().
+ */
+static void ssd1306_batchInterleave(ssd1306_batch_t *batch)
+{
+    uint8_t buffer[SSD1306_BATCH_SIZE * 2 + 1];
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < batch->size; i++)
+    {
+        buffer[n++] = ((batch->args >> i) & 0x01) ? 0xC0 : 0x80;
+        buffer[n++] = batch->data[i];
+    }
+    buffer[n++] = 0x40;
     ssd1306_intf.start();
-    ssd1306_spiDataMode(0);
+    ssd1306_intf.send_buffer(buffer, n);
+    batch->size = 0;
+    batch->args = 0;
+    batch->started = 1;
+    batch->mode = 1;
+}
+#endif
+
+void ssd1306_batchEnd(ssd1306_batch_t *batch, uint8_t dataMode)
+{
+#ifdef CONFIG_SSD1306_I2C_INTERLEAVE_ENABLE
+    if (dataMode && !batch->started && !ssd1306_intf.spi)
+    {
+        ssd1306_batchInterleave(batch);
+        return;
+    }
+#endif
+    ssd1306_batchFlush(batch);
+    if (dataMode)
+    {
+        ssd1306_batchSwitch(batch, 1);
+    }
+    else if (batch->started)
+    {
+        ssd1306_intf.stop();
+    }
+}
+
+#ifdef CONFIG_SSD1306_WINDOW_CACHE_ENABLE
+
+#if defined(CONFIG_SSD1306_STATIC_AVR_SPI) || defined(CONFIG_SSD1306_STATIC_MONO_LCD)
+#error "CONFIG_SSD1306_WINDOW_CACHE_ENABLE cannot count bytes, sent bypassing ssd1306_intf"
+#endif
+
+static ssd1306_interface_t s_window_intf;
+static void (*s_window_set_block)(lcduint_t x, lcduint_t y, lcduint_t w);
+
+static struct
+{
+    /** left column of block, programmed to the controller */
+    lcduint_t left;
+    /** right column of block, programmed to the controller */
+    lcduint_t right;
+    /** top page of block, programmed to the controller */
+    lcduint_t top;
+    /** current column of GDRAM pointer */
+    lcduint_t column;
+    /** current page of GDRAM pointer */
+    lcduint_t page;
+    /** non-zero if GDRAM pointer position is known */
+    uint8_t valid;
+    /** non-zero while bytes are sent by the library itself and must not be counted */
+    uint8_t busy;
+} s_window;
+
+static void ssd1306_window_advance(uint16_t size)
+{
+    if (!s_window.valid || s_window.busy)
+    {
+        return;
+    }
+    while (size)
+    {
+        lcduint_t left = s_window.right - s_window.column + 1;
+        if (size < left)
+        {
+            s_window.column += size;
+            return;
+        }
+        size -= left;
+        s_window.column = s_window.left;
+        /* horizontal addressing mode wraps the pointer back to the top page of the block */
+        if (++s_window.page >= (ssd1306_lcd.height >> 3))
+        {
+            s_window.page = s_window.top;
+        }
+    }
+}
+
+static void ssd1306_window_start(void)
+{
+    if (!s_window.busy)
+    {
+        /* unknown transaction can change controller addresses */
+        s_window.valid = 0;
+    }
+    s_window_intf.start();
+}
+
+static void ssd1306_window_send(uint8_t data)
+{
+    ssd1306_window_advance(1);
+    s_window_intf.send(data);
+}
+
+static void ssd1306_window_send_buffer(const uint8_t *buffer, uint16_t size)
+{
+    uint8_t busy = s_window.busy;
+    ssd1306_window_advance(size);
+    /* generic send_buffer() implementation calls ssd1306_intf.send() for each byte */
+    s_window.busy = 1;
+    s_window_intf.send_buffer(buffer, size);
+    s_window.busy = busy;
+}
+
+static void ssd1306_window_send_buffer_async(const uint8_t *buffer, uint16_t size)
+{
+    uint8_t busy = s_window.busy;
+    ssd1306_window_advance(size);
+    s_window.busy = 1;
+    s_window_intf.send_buffer_async(buffer, size);
+    s_window.busy = busy;
+}
+
+static void ssd1306_window_set_block(lcduint_t x, lcduint_t y, lcduint_t w)
+{
+    lcduint_t right = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
+    s_window.busy = 1;
+    if ( s_window.valid && (s_window.left == x) && (s_window.right == right) &&
+         (s_window.column == x) && (s_window.page == y) )
+    {
+        ssd1306_dataStart();
+    }
+    else
+    {
+        s_window_set_block(x, y, w);
+        s_window.left = x;
+        s_window.right = right;
+        s_window.top = y;
+        s_window.column = x;
+        s_window.page = y;
+        s_window.valid = 1;
+    }
+    s_window.busy = 0;
+}
+
+void ssd1306_windowCacheAttach(void)
+{
+    s_window.valid = 0;
+    if (ssd1306_intf.start != ssd1306_window_start)
+    {
+        s_window_intf = ssd1306_intf;
+        ssd1306_intf.start = ssd1306_window_start;
+        ssd1306_intf.send = ssd1306_window_send;
+        ssd1306_intf.send_buffer = ssd1306_window_send_buffer;
+        ssd1306_intf.send_buffer_async = ssd1306_window_send_buffer_async;
+    }
+    if (ssd1306_lcd.send_pixels1 == s_window_intf.send)
+    {
+        ssd1306_lcd.send_pixels1 = ssd1306_intf.send;
+    }
+    if (ssd1306_lcd.send_pixels_buffer1 == s_window_intf.send_buffer)
+    {
+        ssd1306_lcd.send_pixels_buffer1 = ssd1306_intf.send_buffer;
+    }
+    if (ssd1306_lcd.set_block != ssd1306_window_set_block)
+    {
+        s_window_set_block = ssd1306_lcd.set_block;
+        ssd1306_lcd.set_block = ssd1306_window_set_block;
+    }
+}
+
+void ssd1306_windowCacheReset(void)
+{
+    s_window.valid = 0;
+}
+
+void ssd1306_windowCacheSave(ssd1306_window_cache_t *cache)
+{
+    cache->intf = s_window_intf;
+    cache->set_block = s_window_set_block;
+}
+
+void ssd1306_windowCacheRestore(const ssd1306_window_cache_t *cache)
+{
+    s_window_intf = cache->intf;
+    s_window_set_block = cache->set_block;
+    s_window.valid = 0;
+}
+
+#endif
+
+/* Reset pulse width, enough for all supported controllers (ssd1306 needs 3us, ili9341 needs 10us) */
+#define RESET_PULSE_US  10
+
+/* Set if the controller is not ready yet to accept next command */
+static uint8_t s_lcdBusy = 0;
+/* Time stamp in milliseconds, when the controller becomes ready */
+static uint32_t s_lcdReadyTs;
+static uint8_t s_lcdInitAsync = 0;
+/* Init sequence, being sent to spi controller, NULL if there is nothing to send */
+static const uint8_t *s_initConfig = NULL;
+static uint8_t s_initSize;
+static uint8_t s_initPos;
+/* Mode and rotation, last set by ssd1306_setMode() and ssd1306_setRotation(), and the
+ * driver functions they were set with. See ssd1306_lcdInvalidateState() */
+static void (*s_lcdModeSet)(lcd_mode_t mode) = NULL;
+static lcd_mode_t s_lcdMode;
+static void (*s_lcdRotationSet)(uint8_t rotation) = NULL;
+static uint8_t s_lcdRotation;
+
+/* Column/page windows, last sent to ili9341 style controllers, see ssd1306_batchRange16() */
+uint16_t ssd1306_lcdWindow2A[2] = { 0xFFFF, 0xFFFF };
+uint16_t ssd1306_lcdWindow2B[2] = { 0xFFFF, 0xFFFF };
+
+/* Callback to run before the last command of init sequence (display on) */
+static void (*s_displayOnHook)(void) = NULL;
+
+static void ssd1306_lcdBusy(uint8_t delayMs)
+{
+    s_lcdReadyTs = millis() + delayMs;
+    s_lcdBusy = 1;
+}
+
+static void ssd1306_runDisplayOnHook(ssd1306_batch_t *batch)
+{
+    void (*hook)(void) = s_displayOnHook;
+    s_displayOnHook = NULL;
+    ssd1306_batchEnd(batch, 0);
+    hook();
+    ssd1306_batchBegin(batch);
+}
+
+void ssd1306_setDisplayOnHook(void (*hook)(void))
+{
+    s_displayOnHook = hook;
+}
+
+static uint8_t ssd1306_lcdReady(void)
+{
+    if (s_lcdBusy && (int32_t)(millis() - s_lcdReadyTs) < 0)
+    {
+        return 0;
+    }
+    s_lcdBusy = 0;
+    return 1;
+}
+
+void ssd1306_configureI2cDisplay(const uint8_t *config, uint8_t configSize)
+{
+    ssd1306_batch_t batch;
+    ssd1306_lcdInvalidateState();
+    while (!ssd1306_lcdReady()) { }
+    ssd1306_batchBegin(&batch);
     for( uint8_t i=0; i<configSize; i++)
     {
-        uint8_t data = pgm_read_byte(&config[i]);
+        if (s_displayOnHook && i == configSize - 1)
+        {
+            ssd1306_runDisplayOnHook(&batch);
+        }
+        ssd1306_batchCommand(&batch, pgm_read_byte(&config[i]));
+    }
+    ssd1306_batchEnd(&batch, 0);
+}
+
+uint8_t ssd1306_lcdInitPoll(void)
+{
+    ssd1306_batch_t batch;
+    if (!ssd1306_lcdReady())
+    {
+        return 1;
+    }
+    if (!s_initConfig)
+    {
+        return 0;
+    }
+    ssd1306_batchBegin(&batch);
+    while (s_initPos < s_initSize)
+    {
+        if (s_displayOnHook && s_initPos == s_initSize - 1)
+        {
+            ssd1306_runDisplayOnHook(&batch);
+        }
+        uint8_t data = pgm_read_byte(&s_initConfig[s_initPos++]);
         if (data == CMD_ARG)
         {
-            data = pgm_read_byte(&config[++i]);
-            ssd1306_spiDataMode(1);
-            ssd1306_intf.send(data);
-            ssd1306_spiDataMode(0);
+            ssd1306_batchArg(&batch, pgm_read_byte(&s_initConfig[s_initPos++]));
+        }
+        else if (data == CMD_DELAY)
+        {
+            ssd1306_lcdBusy(pgm_read_byte(&s_initConfig[s_initPos++]));
+            break;
         }
         else
         {
-            ssd1306_intf.send(data);
+            ssd1306_batchCommand(&batch, data);
         }
     }
-    ssd1306_intf.stop();
+    ssd1306_batchEnd(&batch, 0);
+    if (s_initPos >= s_initSize)
+    {
+        s_initConfig = NULL;
+    }
+    return s_initConfig || s_lcdBusy;
+}
+
+void ssd1306_configureSpiDisplay(const uint8_t *config, uint8_t configSize)
+{
+    ssd1306_lcdInvalidateState();
+    s_initConfig = config;
+    s_initSize = configSize;
+    s_initPos = 0;
+    if (s_lcdInitAsync)
+    {
+        ssd1306_lcdInitPoll();
+        return;
+    }
+    while (ssd1306_lcdInitPoll()) { }
+}
+
+void ssd1306_setLcdInitAsync(uint8_t enable)
+{
+    s_lcdInitAsync = enable;
+}
+
+/* Number of pixels, prepared on the stack by ssd1306_fillPixels8() per send_buffer() call */
+#define FILL8_CHUNK_PIXELS   32
+/* Number of pixels, prepared on the stack by ssd1306_fillPixels16() per send_buffer() call */
+#define FILL16_CHUNK_PIXELS  16
+#if defined(CONFIG_SIMD_AVAILABLE)
+/* Hosts with SIMD kernels convert faster than send_buffer() call costs, so they use bigger chunks */
+#define RGB8TO16_CHUNK_PIXELS  128
+#define MONO16_CHUNK_BYTES   16
+#else
+/* Number of pixels, converted on the stack by ssd1306_sendPixelsBuffer8To16() per send_buffer() call */
+#define RGB8TO16_CHUNK_PIXELS  16
+/* Number of mono bytes, expanded on the stack by ssd1306_sendPixelsBuffer1To16() per send_buffer() call */
+#define MONO16_CHUNK_BYTES   4
+#endif
+
+extern uint16_t ssd1306_color;
+
+/* Color correction tables for RGB16 pixels: 32 red, 64 green and 32 blue entries, or NULL */
+static const uint8_t *s_lutRed = NULL;
+static const uint8_t *s_lutGreen = NULL;
+static const uint8_t *s_lutBlue = NULL;
+
+static inline uint16_t ssd1306_correct16(uint16_t color)
+{
+    return ((uint16_t)s_lutRed[color >> 11] << 11) |
+           ((uint16_t)s_lutGreen[(color >> 5) & 0x3F] << 5) |
+           s_lutBlue[color & 0x1F];
+}
+
+void ssd1306_fillPixels8(uint8_t color, uint32_t count)
+{
+    uint8_t chunk[FILL8_CHUNK_PIXELS];
+    for (uint8_t i = 0; i < sizeof(chunk); i++)
+    {
+        chunk[i] = color;
+    }
+    while (count >= FILL8_CHUNK_PIXELS)
+    {
+        ssd1306_intf.send_buffer(chunk, sizeof(chunk));
+        count -= FILL8_CHUNK_PIXELS;
+    }
+    if (count)
+    {
+        ssd1306_intf.send_buffer(chunk, (uint16_t)count);
+    }
+}
+
+void ssd1306_fillPixels8To16(uint8_t color, uint32_t count)
+{
+    ssd1306_lcd.fill_pixels16(RGB8_TO_RGB16(color), count);
+}
+
+void ssd1306_sendPixelsBuffer8(const uint8_t *buffer, uint16_t len)
+{
+    ssd1306_intf.send_buffer(buffer, len);
+}
+
+#if !defined(__AVR__)
+/* RGB8 to RGB16 conversion table. AVR has no spare RAM for it, so macro is used there */
+static uint16_t s_rgb8to16[256];
+static uint8_t s_rgb8to16_ready = 0;
+
+/* Corrected colors are stored in the table, so correction costs nothing per pixel */
+static void ssd1306_rgb8To16Init(void)
+{
+    uint8_t color = 0;
+    do
+    {
+        uint16_t rgb16 = RGB8_TO_RGB16(color);
+        s_rgb8to16[color] = s_lutRed ? ssd1306_correct16(rgb16) : rgb16;
+    } while (++color);
+    s_rgb8to16_ready = 1;
+}
+
+#define RGB8_TO_RGB16_FAST(c)  s_rgb8to16[c]
+#else
+#define RGB8_TO_RGB16_FAST(c)  (s_lutRed ? ssd1306_correct16(RGB8_TO_RGB16(c)) : RGB8_TO_RGB16(c))
+#endif
+
+void ssd1306_sendPixelsBuffer8To16(const uint8_t *buffer, uint16_t len)
+{
+    uint8_t burst[RGB8TO16_CHUNK_PIXELS << 1];
+#if !defined(__AVR__)
+    if (!s_rgb8to16_ready)
+    {
+        ssd1306_rgb8To16Init();
+    }
+#endif
+    while (len)
+    {
+        uint8_t count = len < RGB8TO16_CHUNK_PIXELS ? len : RGB8TO16_CHUNK_PIXELS;
+        uint8_t *dst = burst;
+        uint8_t i = count;
+#if defined(CONFIG_SIMD_AVAILABLE)
+        /* SIMD kernel knows nothing about color correction */
+        for (; !s_lutRed && i >= SIMD_PIXELS; i -= SIMD_PIXELS)
+        {
+            simd_rgb8To16(dst, buffer);
+            dst += SIMD_PIXELS << 1;
+            buffer += SIMD_PIXELS;
+        }
+#endif
+        for (; i > 0; i--)
+        {
+            uint16_t color = RGB8_TO_RGB16_FAST(*buffer);
+            dst[0] = color >> 8;
+            dst[1] = color & 0xFF;
+            dst += 2;
+            buffer++;
+        }
+        ssd1306_intf.send_buffer(burst, (uint16_t)count << 1);
+        len -= count;
+    }
+}
+
+/* Number of bytes, copied from Flash to the stack by ssd1306_sendProgmemPixels*() per send_buffer() call */
+#define PROGMEM_CHUNK_BYTES  32
+
+#if defined(__AVR__) || defined(ESP8266)
+/* Flash is not in data address space (AVR) or is not byte-addressable (ESP8266) */
+#define PROGMEM_NEEDS_STAGING
+#endif
+
+void ssd1306_sendProgmemPixels1(const uint8_t *data, uint16_t len, uint8_t invert)
+{
+#ifndef PROGMEM_NEEDS_STAGING
+    if (!invert)
+    {
+        ssd1306_lcdSendPixelsBuffer1(data, len);
+        return;
+    }
+#endif
+    uint8_t burst[PROGMEM_CHUNK_BYTES];
+    while (len)
+    {
+        uint8_t count = len < PROGMEM_CHUNK_BYTES ? len : PROGMEM_CHUNK_BYTES;
+        memcpy_P(burst, data, count);
+        if (invert)
+        {
+            for (uint8_t i = 0; i < count; i++)
+            {
+                burst[i] ^= invert;
+            }
+        }
+        ssd1306_lcdSendPixelsBuffer1(burst, count);
+        data += count;
+        len -= count;
+    }
+}
+
+void ssd1306_sendProgmemPixels(void (*send_buffer)(const uint8_t *buffer, uint16_t len),
+                               const uint8_t *data, uint32_t count, uint8_t pixelSize)
+{
+#ifndef PROGMEM_NEEDS_STAGING
+    while (count)
+    {
+        uint16_t n = count < 0x4000 ? count : 0x4000;
+        send_buffer(data, n);
+        data += (uint32_t)n * pixelSize;
+        count -= n;
+    }
+#else
+    uint8_t burst[PROGMEM_CHUNK_BYTES];
+    uint8_t chunk = PROGMEM_CHUNK_BYTES / pixelSize;
+    while (count)
+    {
+        uint8_t n = count < chunk ? count : chunk;
+        memcpy_P(burst, data, n * pixelSize);
+        send_buffer(burst, n);
+        data += n * pixelSize;
+        count -= n;
+    }
+#endif
+}
+
+void ssd1306_sendPixelsBuffer16(const uint8_t *buffer, uint16_t len)
+{
+    if (s_lutRed)
+    {
+        /* Corrected pixels are prepared on the stack, source buffer is not changed */
+        uint8_t burst[RGB8TO16_CHUNK_PIXELS << 1];
+        while (len)
+        {
+            uint8_t count = len < RGB8TO16_CHUNK_PIXELS ? len : RGB8TO16_CHUNK_PIXELS;
+            for (uint16_t i = 0; i < ((uint16_t)count << 1); i += 2)
+            {
+                uint16_t color = ssd1306_correct16((buffer[i] << 8) | buffer[i + 1]);
+                burst[i] = color >> 8;
+                burst[i + 1] = color & 0xFF;
+            }
+            ssd1306_intf.send_buffer(burst, (uint16_t)count << 1);
+            buffer += (uint16_t)count << 1;
+            len -= count;
+        }
+        return;
+    }
+    /* len << 1 doesn't fit 16-bit send_buffer() argument for large blocks */
+    while (len > 0x7FFF)
+    {
+        ssd1306_intf.send_buffer(buffer, 0xFFFE);
+        buffer += 0xFFFE;
+        len -= 0x7FFF;
+    }
+    if (len)
+    {
+        ssd1306_intf.send_buffer(buffer, len << 1);
+    }
+}
+
+void ssd1306_fillPixels16(uint16_t color, uint32_t count)
+{
+    uint8_t chunk[FILL16_CHUNK_PIXELS << 1];
+    if (s_lutRed) color = ssd1306_correct16(color);
+    for (uint8_t i = 0; i < sizeof(chunk); i += 2)
+    {
+        chunk[i] = color >> 8;
+        chunk[i + 1] = color & 0xFF;
+    }
+    while (count >= FILL16_CHUNK_PIXELS)
+    {
+        ssd1306_intf.send_buffer(chunk, sizeof(chunk));
+        count -= FILL16_CHUNK_PIXELS;
+    }
+    if (count)
+    {
+        ssd1306_intf.send_buffer(chunk, (uint16_t)count << 1);
+    }
+}
+
+/*
+ * Expands 8 vertical mono pixels to 16 bytes of RGB16 data. colors holds
+ * background pixel bytes at [0..1] and foreground pixel bytes at [2..3].
+ */
+static uint8_t *ssd1306_expandPixels1To16(uint8_t *dst, uint8_t data, const uint8_t *colors)
+{
+#if defined(CONFIG_SIMD_AVAILABLE)
+    simd_expand1To16(dst, data, colors[0] | (colors[1] << 8), colors[2] | (colors[3] << 8));
+    return dst + 16;
+#else
+    for (uint8_t i = 8; i > 0; i--)
+    {
+        const uint8_t *pixel = &colors[(data & 0x01) << 1];
+        dst[0] = pixel[0];
+        dst[1] = pixel[1];
+        dst += 2;
+        data >>= 1;
+    }
+    return dst;
+#endif
+}
+
+void ssd1306_sendPixels1To16(uint8_t data)
+{
+    uint16_t color = s_lutRed ? ssd1306_correct16(ssd1306_color) : ssd1306_color;
+    uint16_t black = s_lutRed ? ssd1306_correct16(0) : 0;
+    uint8_t colors[4] = { (uint8_t)(black >> 8), (uint8_t)black, (uint8_t)(color >> 8), (uint8_t)color };
+    uint8_t burst[16];
+    ssd1306_expandPixels1To16(burst, data, colors);
+    ssd1306_intf.send_buffer(burst, sizeof(burst));
+}
+
+void ssd1306_sendPixelsBuffer1To16(const uint8_t *buffer, uint16_t len)
+{
+    uint16_t color = s_lutRed ? ssd1306_correct16(ssd1306_color) : ssd1306_color;
+    uint16_t black = s_lutRed ? ssd1306_correct16(0) : 0;
+    uint8_t colors[4] = { (uint8_t)(black >> 8), (uint8_t)black, (uint8_t)(color >> 8), (uint8_t)color };
+    uint8_t burst[MONO16_CHUNK_BYTES << 4];
+    while (len)
+    {
+        uint8_t count = len < MONO16_CHUNK_BYTES ? len : MONO16_CHUNK_BYTES;
+        uint8_t *dst = burst;
+        for (uint8_t i = count; i > 0; i--)
+        {
+            dst = ssd1306_expandPixels1To16(dst, *buffer, colors);
+            buffer++;
+        }
+        ssd1306_intf.send_buffer(burst, (uint16_t)count << 4);
+        len -= count;
+    }
+}
+
+void ssd1306_setColorCorrection16(const uint8_t *red, const uint8_t *green, const uint8_t *blue)
+{
+    s_lutRed = (red && green && blue) ? red : NULL;
+    s_lutGreen = green;
+    s_lutBlue = blue;
+#if !defined(__AVR__)
+    s_rgb8to16_ready = 0;
+#endif
+}
+
+uint8_t ssd1306_isColorCorrection16(void)
+{
+    return s_lutRed != NULL;
+}
+
+/* Square root of 0.15 fixed point value */
+static uint32_t ssd1306_sqrt15(uint32_t x)
+{
+    uint32_t value = x << 15;
+    uint32_t root = 0;
+    for (uint32_t bit = 1UL << 30; bit; bit >>= 2)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+    }
+    return root;
+}
+
+void ssd1306_makeCorrectionTable(uint8_t *table, uint8_t size, uint8_t gamma, uint8_t brightness)
+{
+    uint8_t power = gamma / 10;
+    /* Fractional part of gamma in 1/16 units: x^(1/2), x^(1/4) ... are taken by square roots */
+    uint8_t frac = ((gamma % 10) * 16 + 5) / 10;
+    for (uint8_t i = 0; i < size; i++)
+    {
+        /* x^gamma in 0.15 fixed point */
+        uint32_t x = ((uint32_t)i << 15) / (size - 1);
+        uint32_t y = 0x8000;
+        for (uint8_t n = 0; n < power; n++)
+        {
+            y = (y * x) >> 15;
+        }
+        uint32_t root = x;
+        for (uint8_t bit = 0x08; bit; bit >>= 1)
+        {
+            root = ssd1306_sqrt15(root);
+            if (frac & bit) y = (y * root) >> 15;
+        }
+        table[i] = (uint8_t)(((y * brightness / 255) * (size - 1) + 0x4000) >> 15);
+    }
+}
+
+void ssd1306_lcdInvalidateState(void)
+{
+    s_lcdModeSet = NULL;
+    s_lcdRotationSet = NULL;
+    ssd1306_lcdWindow2A[0] = 0xFFFF;
+    ssd1306_lcdWindow2B[0] = 0xFFFF;
+#ifdef CONFIG_SSD1306_WINDOW_CACHE_ENABLE
+    ssd1306_windowCacheReset();
+#endif
+}
+
+void ssd1306_lcdInitTable(lcd_type_t type)
+{
+    /* Optional hooks, left by previously initialized display, must not be
+     * called for the new one, so the table is always filled in from scratch */
+    memset(&ssd1306_lcd, 0, sizeof(ssd1306_lcd));
+    ssd1306_lcd.type = type;
 }
 
 void ssd1306_setMode(lcd_mode_t mode)
 {
     if (ssd1306_lcd.set_mode)
     {
+        /* Switching mode rewrites remap registers and window of the controller,
+         * so it is skipped if the same driver is already in requested mode */
+        if (s_lcdModeSet == ssd1306_lcd.set_mode && s_lcdMode == mode)
+        {
+            return;
+        }
         ssd1306_lcd.set_mode( mode );
+        s_lcdModeSet = ssd1306_lcd.set_mode;
+        s_lcdMode = mode;
+    }
+}
+
+uint8_t ssd1306_copyBlock(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x, lcdint_t y)
+{
+    if (ssd1306_lcd.copy_block)
+    {
+        return ssd1306_lcd.copy_block( x1, y1, x2, y2, x, y );
+    }
+    return 0;
+}
+
+uint8_t ssd1306_setRotation(uint8_t rotation)
+{
+    if (ssd1306_lcd.set_rotation)
+    {
+        if (s_lcdRotationSet != ssd1306_lcd.set_rotation || s_lcdRotation != rotation)
+        {
+            ssd1306_lcd.set_rotation( rotation );
+            s_lcdRotationSet = ssd1306_lcd.set_rotation;
+            s_lcdRotation = rotation;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+void ssd1306_waitVSync(void)
+{
+    if (ssd1306_lcd.wait_vsync)
+    {
+        ssd1306_lcd.wait_vsync();
+    }
+}
+
+/* Maximum time to wait for TE signal, longer than frame period of any panel */
+#define TEARING_TIMEOUT_MS  40
+
+static int8_t s_tearingPin = -1;
+
+static void ssd1306_waitTearingPin(void)
+{
+    /* TE pin is high during vertical blanking: wait for its rising edge, so the *
+     * whole blanking period and the scan of the next frame are ahead           */
+    uint32_t ts = millis();
+    while (digitalRead(s_tearingPin) == HIGH)
+    {
+        if ((uint32_t)(millis() - ts) > TEARING_TIMEOUT_MS) return;
+    }
+    while (digitalRead(s_tearingPin) == LOW)
+    {
+        if ((uint32_t)(millis() - ts) > TEARING_TIMEOUT_MS) return;
+    }
+}
+
+void ssd1306_dcsSetTearingPin(int8_t pin)
+{
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    if (pin >= 0)
+    {
+        ssd1306_batchCommand(&batch, 0x35); // TEON
+        ssd1306_batchArg(&batch, 0x00);     // v-blank information only
+        pinMode(pin, INPUT);
     }
+    else
+    {
+        ssd1306_batchCommand(&batch, 0x34); // TEOFF
+    }
+    ssd1306_batchEnd(&batch, 0);
+    s_tearingPin = pin;
+    ssd1306_lcd.wait_vsync = pin >= 0 ? ssd1306_waitTearingPin : NULL;
 }
 
 void ssd1306_resetController(int8_t rstPin, uint8_t delayMs)
@@ -91,3 +922,13 @@ void ssd1306_resetController(int8_t rstPin, uint8_t delayMs)
     digitalWrite(rstPin, HIGH);
 }
 
+void ssd1306_resetControllerFast(int8_t rstPin, uint8_t readyMs)
+{
+    pinMode(rstPin, OUTPUT);
+    digitalWrite(rstPin, LOW);
+    delayMicroseconds(RESET_PULSE_US);
+    digitalWrite(rstPin, HIGH);
+    /* Do not wait here: interface initialization runs, while controller completes reset */
+    ssd1306_lcdBusy(readyMs);
+}
+
@@ -29,6 +29,7 @@
 #define _LCD_COMMON_H_
 
 #include "ssd1306_hal/io.h"
+#include "intf/ssd1306_interface.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -141,6 +142,38 @@ typedef struct
      */
     void (*send_pixels8)(uint8_t data);
 
+    /**
+     * @brief Sends buffer of RGB pixels encoded in 3-3-2 format to OLED driver.
+     * Sends buffer of RGB pixels encoded in 3-3-2 format to OLED driver.
+     * Controllers, working in RGB16 mode, convert whole buffer before sending it.
+     * The field is NULL if display controller doesn't support RGB8 mode.
+     * @param buffer - buffer containing RGB8 pixels, 1 byte per pixel.
+     * @param len - number of pixels in the buffer.
+     */
+    void (*send_pixels_buffer8)(const uint8_t *buffer, uint16_t len);
+
+    /**
+     * @brief Sends buffer of packed 4-bit grayscale pixels to OLED driver.
+     * Sends buffer of 4-bit grayscale pixels to OLED driver. Each byte holds
+     * 2 horizontal pixels, low nibble is the left pixel. This is the format used
+     * by NanoCanvas4 and ssd1306_drawBufferFast4().
+     * The field is NULL if display controller doesn't support 4-bit mode.
+     * @param buffer - buffer containing packed 4-bit pixels.
+     * @param len - length of buffer in bytes.
+     */
+    void (*send_pixels_buffer4)(const uint8_t *buffer, uint16_t len);
+
+    /**
+     * @brief Sends the same RGB pixel, encoded in 3-3-2 format, count times.
+     * Sends the same RGB pixel, encoded in 3-3-2 format, count times to the
+     * block, specified by set_block(). Some controllers (SSD1331) fill the block
+     * by hardware instead of sending pixels over the bus.
+     * The field is NULL if display controller doesn't support RGB8 mode.
+     * @param color byte, representing RGB8 pixel
+     * @param count number of pixels to send
+     */
+    void (*fill_pixels8)(uint8_t color, uint32_t count);
+
     /**
      * @brief Sends RGB pixel encoded in 5-6-5 format to OLED driver.
      * Sends RGB pixel encoded in 5-6-5 format to OLED driver.
@@ -148,6 +181,26 @@ typedef struct
      */
     void (*send_pixels16)(uint16_t data);
 
+    /**
+     * @brief Sends buffer of RGB pixels encoded in 5-6-5 format to OLED driver.
+     * Sends buffer of RGB pixels encoded in 5-6-5 format to OLED driver.
+     * Each pixel takes 2 bytes, high byte first, which is the format used
+     * by NanoCanvas16 and ssd1306_drawBufferFast16().
+     * The field is NULL if display controller doesn't support RGB16 mode.
+     * @param buffer - buffer containing RGB16 pixels.
+     * @param len - number of pixels in the buffer.
+     */
+    void (*send_pixels_buffer16)(const uint8_t *buffer, uint16_t len);
+
+    /**
+     * @brief Sends the same RGB pixel, encoded in 5-6-5 format, count times.
+     * Sends the same RGB pixel, encoded in 5-6-5 format, count times.
+     * The field is NULL if display controller doesn't support RGB16 mode.
+     * @param color 16-bit word, representing RGB16 pixel
+     * @param count number of pixels to send
+     */
+    void (*fill_pixels16)(uint16_t color, uint32_t count);
+
     /**
      * @brief Sets library display mode for direct draw functions.
      *
@@ -162,6 +215,120 @@ typedef struct
      * @see lcd_mode_t
      */
     void (*set_mode)(lcd_mode_t mode);
+
+    /**
+     * @brief Sets GDRAM line, displayed at the top of the screen.
+     *
+     * Sets GDRAM line, displayed at the top of the screen, thus scrolling
+     * display content vertically in hardware. Screen row r shows GDRAM row
+     * (r + line) % height. set_block() still works with GDRAM coordinates.
+     * The field is NULL if display controller doesn't support hardware scrolling.
+     *
+     * @param line - GDRAM line to display at the top of the screen [0, height-1]
+     */
+    void (*set_start_line)(lcduint_t line);
+
+    /**
+     * @brief Sets screen orientation using controller remap settings.
+     *
+     * Sets screen orientation by reprogramming controller GDRAM remap settings
+     * (segment remap and COM scan direction, remap register, MADCTL), so rotated
+     * drawing costs nothing per pixel. For 90 and 270 degrees width and height
+     * fields are exchanged.
+     * The field is NULL if display controller doesn't support rotation.
+     *
+     * @param rotation - 0 - normal, 1 - 90 CW, 2 - 180 CW, 3 - 270 CW
+     */
+    void (*set_rotation)(uint8_t rotation);
+
+    /**
+     * @brief Sets block in GDRAM, filled column by column.
+     *
+     * Sets block in GDRAM using vertical addressing mode of the controller: each
+     * data byte, sent after the call, is 8 vertical pixels, and the pointer moves
+     * down through all pages of the block first, then goes to the next column.
+     * So, column-oriented content (vertical lines, bar graphs, charts) is sent in
+     * single transaction without per-column addressing commands.
+     * The field is NULL if display controller doesn't support vertical addressing.
+     *
+     * @param x - column (left region)
+     * @param y - page (top page of the block)
+     * @param w - width of the block in pixels
+     * @param h - height of the block in pages (8 pixels)
+     */
+    void (*set_column_block)(lcduint_t x, lcduint_t y, lcduint_t w, lcduint_t h);
+
+    /**
+     * @brief Waits for start of vertical blanking period of the panel.
+     *
+     * Waits for tearing effect (TE) signal of the controller, so the frame, sent right
+     * after the call, doesn't race the panel scan.
+     * The field is NULL if synchronization with the panel is not configured.
+     */
+    void (*wait_vsync)(void);
+
+    /**
+     * @brief Draws line using display controller graphics accelerator.
+     *
+     * Draws line using display controller graphics accelerator. The function
+     * starts and stops interface session itself.
+     * The field is NULL if display controller has no graphics accelerator.
+     *
+     * @param x1 - x position of start point
+     * @param y1 - y position of start point
+     * @param x2 - x position of end point
+     * @param y2 - y position of end point
+     * @param color - RGB16 color of the line
+     * @return 1 if line is drawn, 0 if line cannot be drawn by hardware,
+     *         for example, if it doesn't fit the screen.
+     */
+    uint8_t (*draw_line)(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint16_t color);
+
+    /**
+     * @brief Draws rectangle outline using display controller graphics accelerator.
+     *
+     * Draws rectangle outline using display controller graphics accelerator.
+     * The function starts and stops interface session itself.
+     * The field is NULL if display controller has no graphics accelerator.
+     *
+     * @param x1 - x position of left-top corner
+     * @param y1 - y position of left-top corner
+     * @param x2 - x position of right-bottom corner
+     * @param y2 - y position of right-bottom corner
+     * @param color - RGB16 color of the outline
+     * @return 1 if rectangle is drawn, 0 if rectangle cannot be drawn by hardware.
+     */
+    uint8_t (*draw_rect)(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint16_t color);
+
+    /**
+     * @brief Copies block of GDRAM to new position.
+     *
+     * Copies block of GDRAM to new position using display controller graphics
+     * accelerator. The function starts and stops interface session itself.
+     * The field is NULL if display controller has no graphics accelerator.
+     *
+     * @param x1 - x position of left-top corner of source block
+     * @param y1 - y position of left-top corner of source block
+     * @param x2 - x position of right-bottom corner of source block
+     * @param y2 - y position of right-bottom corner of source block
+     * @param x - x position of left-top corner of destination block
+     * @param y - y position of left-top corner of destination block
+     * @return 1 if block is copied, 0 if block cannot be copied by hardware.
+     */
+    uint8_t (*copy_block)(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x, lcdint_t y);
+
+    /**
+     * @brief Sets panel brightness using controller current registers.
+     *
+     * Sets panel brightness via contrast or master current register of the controller
+     * (SSD1306 0x81, SSD1331 0x87, SSD1351 0xC7), so brightness can be changed by
+     * few command bytes without redrawing GDRAM content. Controllers with coarse
+     * master current use high bits of the level only.
+     * The field is NULL if display controller has no such register.
+     *
+     * @param level - brightness [0-255]
+     */
+    void (*set_brightness)(uint8_t level);
 } ssd1306_lcd_t;
 
 /**
@@ -169,6 +336,18 @@ typedef struct
  */
 extern ssd1306_lcd_t ssd1306_lcd;
 
+#ifdef CONFIG_SSD1306_STATIC_MONO_LCD
+/** Sends 1-bit pixels to monochrome display, selected at compile time */
+#define ssd1306_lcdSendPixels1(data)               ssd1306_intfSend(data)
+/** Sends buffer of 1-bit pixels to monochrome display, selected at compile time */
+#define ssd1306_lcdSendPixelsBuffer1(buffer, len)  ssd1306_intfSendBuffer(buffer, len)
+#else
+/** Sends 1-bit pixels to currently initialized display */
+#define ssd1306_lcdSendPixels1(data)               ssd1306_lcd.send_pixels1(data)
+/** Sends buffer of 1-bit pixels to currently initialized display */
+#define ssd1306_lcdSendPixelsBuffer1(buffer, len)  ssd1306_lcd.send_pixels_buffer1(buffer, len)
+#endif
+
 /**
  * Current display height
  * @deprecated Use ssd1306_lcd.height instead.
@@ -268,12 +447,370 @@ void ssd1306_configureI2cDisplay(const uint8_t *config, uint8_t configSize);
  * and next byte after will be sent in data spi mode. Then the function will switch back
  * to command mode. If lcd controller requires cmd arguments to be sent in command mode,
  * please use ssd1306_configureI2cDisplay().
+ * If data byte is 0xFE, the next byte after is the number of milliseconds
+ * the controller needs before it accepts next command (for example, after sleep-out
+ * command). Commands between such waits are sent as a single transaction.
  *
  * @param config configuration, located in flash, to send to i2c/spi controller.
  * @param configSize - size of configuration data in bytes.
+ * @see ssd1306_setLcdInitAsync()
  */
 void ssd1306_configureSpiDisplay(const uint8_t *config, uint8_t configSize);
 
+/**
+ * @brief Sets function to run once before display is turned on during initialization.
+ *
+ * The callback is called by ssd1306_configureI2cDisplay() or ssd1306_configureSpiDisplay()
+ * right before the last command of init sequence, which is display-on command for
+ * all supported displays, and then is reset. At this point ssd1306_lcd is already
+ * set up, so the callback can write GDRAM, while the panel is still off.
+ *
+ * @param hook function to call or NULL
+ * @see ssd1306_setBootSplash()
+ */
+void ssd1306_setDisplayOnHook(void (*hook)(void));
+
+/**
+ * @brief Enables non-blocking initialization of spi displays.
+ *
+ * If enabled, ssd1306_configureSpiDisplay() (and so xxx_spi_init() functions of
+ * color displays) returns at the first wait, required by controller, instead of blocking
+ * the application. The rest of init sequence is sent by ssd1306_lcdInitPoll(),
+ * which must be called until it returns 0, before any output to the display.
+ * This allows to overlap reset and sleep-out delays of the controller with
+ * initialization of other application peripherals.
+ *
+ * @param enable 1 to enable non-blocking initialization, 0 to disable (default)
+ */
+void ssd1306_setLcdInitAsync(uint8_t enable);
+
+/**
+ * @brief Continues non-blocking initialization of the display.
+ *
+ * Sends next part of init sequence if the controller is ready to accept it.
+ *
+ * @return 1 if initialization is still in progress, 0 if display is ready
+ * @see ssd1306_setLcdInitAsync()
+ */
+uint8_t ssd1306_lcdInitPoll(void);
+
+/** Maximum number of bytes, collected by command batch before sending them to display */
+#define SSD1306_BATCH_SIZE  16
+
+/**
+ * Command batch collects command opcodes and their arguments, and sends them to lcd
+ * controller via ssd1306_intf.send_buffer() with minimal number of D/C line switches.
+ */
+typedef struct
+{
+    /** collected bytes */
+    uint8_t data[SSD1306_BATCH_SIZE];
+    /** bit mask of collected bytes, which must be sent in data mode */
+    uint16_t args;
+    /** number of collected bytes */
+    uint8_t size;
+    /** non-zero if transaction to lcd controller is started */
+    uint8_t started;
+    /** current mode of started transaction: 0 - command mode, 1 - data mode */
+    uint8_t mode;
+} ssd1306_batch_t;
+
+/**
+ * @brief Prepares command batch for collecting commands.
+ *
+ * Prepares command batch for collecting commands. Transaction to lcd controller is
+ * started only, when collected bytes are sent.
+ * @param batch command batch to initialize
+ */
+void ssd1306_batchBegin(ssd1306_batch_t *batch);
+
+/**
+ * @brief Adds byte, which must be sent in command mode.
+ *
+ * Adds byte, which must be sent in command mode. Use this function for command arguments
+ * if lcd controller requires arguments to be sent in command mode (ssd1306, ssd1331).
+ * @param batch command batch
+ * @param cmd command opcode or argument
+ */
+void ssd1306_batchCommand(ssd1306_batch_t *batch, uint8_t cmd);
+
+/**
+ * @brief Adds command argument, which must be sent in data mode.
+ *
+ * Adds command argument, which must be sent in spi data mode (ssd1351, ili9341, il9163).
+ * @param batch command batch
+ * @param arg command argument
+ */
+void ssd1306_batchArg(ssd1306_batch_t *batch, uint8_t arg);
+
+/**
+ * @brief Adds window command with 16-bit start and end arguments, if needed.
+ *
+ * Adds command with 16-bit start and end arguments (like column address set command
+ * of ili9341), sent in data mode. If cache contains the same start and end values,
+ * which lcd controller already has, the command is not added. The function can be used
+ * only for controllers, which reset GDRAM pointer on memory write command.
+ * @param batch command batch
+ * @param cmd command opcode
+ * @param start first argument
+ * @param end second argument
+ * @param cache array of 2 words, keeping last values, sent to controller. Set cache[0]
+ *        to 0xFFFF to invalidate it.
+ */
+void ssd1306_batchRange16(ssd1306_batch_t *batch, uint8_t cmd, uint16_t start, uint16_t end, uint16_t *cache);
+
+/**
+ * Column (0x2A) and page (0x2B) windows, last sent to ili9341 style controllers.
+ * Used as cache for ssd1306_batchRange16() by display drivers.
+ */
+extern uint16_t ssd1306_lcdWindow2A[2];
+/** @copydoc ssd1306_lcdWindow2A */
+extern uint16_t ssd1306_lcdWindow2B[2];
+
+/**
+ * @brief Forgets controller state, cached by the library.
+ *
+ * The library skips commands, which would set the same mode, rotation or address
+ * window again. Call this function if controller state is changed bypassing the
+ * library, or another display is connected to the same interface.
+ * ssd1306_contextSelect(), display init functions and mode/rotation functions of
+ * display drivers (like ili9341_setRotation()) call it automatically.
+ */
+void ssd1306_lcdInvalidateState(void);
+
+/**
+ * @brief Clears ssd1306_lcd table before display driver fills it in.
+ *
+ * Resets all ssd1306_lcd fields, including optional hooks (set_rotation, draw_line,
+ * set_brightness, etc.), and sets type of the display. All display init functions
+ * call it first, so hooks of previously initialized display are never called for
+ * another one. Custom display drivers should call it too.
+ * @param type type of the display
+ */
+void ssd1306_lcdInitTable(lcd_type_t type);
+
+/**
+ * @brief Sends collected bytes to lcd controller.
+ *
+ * Sends collected bytes to lcd controller, starting transaction if needed. Bytes of the
+ * same mode are sent via single ssd1306_intf.send_buffer() call. Transaction remains open.
+ * @param batch command batch
+ */
+void ssd1306_batchFlush(ssd1306_batch_t *batch);
+
+/**
+ * @brief Sends collected bytes and completes batch.
+ *
+ * Sends collected bytes to lcd controller. If dataMode is zero, the function completes
+ * transaction. Otherwise, it switches transaction to data mode, so pixels can be sent
+ * right after the call (this is what set_block() functions need).
+ * @param batch command batch
+ * @param dataMode 0 to stop transaction, 1 to leave transaction in data mode
+ */
+void ssd1306_batchEnd(ssd1306_batch_t *batch, uint8_t dataMode);
+
+#ifdef CONFIG_SSD1306_WINDOW_CACHE_ENABLE
+/**
+ * @brief Enables tracking of GDRAM pointer for current display.
+ *
+ * Enables tracking of GDRAM pointer for displays with horizontal addressing mode,
+ * which keep block left and right columns and move pointer to the left column of the
+ * next page, when the right column is reached. The function wraps ssd1306_lcd.set_block()
+ * and interface functions, so the library counts data bytes sent to the display. If
+ * set_block() is called for the same columns and the pointer is already at the start of
+ * requested block, the address commands are not sent. Any transaction, started not by
+ * set_block(), resets tracked position. Display init functions call this function after
+ * ssd1306_lcd table is filled in.
+ */
+void ssd1306_windowCacheAttach(void);
+
+/**
+ * Resets tracked GDRAM pointer position, so next set_block() call sends all address
+ * commands to the display.
+ */
+void ssd1306_windowCacheReset(void);
+
+/**
+ * Functions, wrapped by ssd1306_windowCacheAttach() for single display. Display contexts
+ * keep them, so each display sends data via its own interface and set_block().
+ */
+typedef struct
+{
+    /** interface functions, wrapped by window cache */
+    ssd1306_interface_t intf;
+    /** set_block() function of display driver */
+    void (*set_block)(lcduint_t x, lcduint_t y, lcduint_t w);
+} ssd1306_window_cache_t;
+
+/**
+ * Copies functions, wrapped by window cache for current display, to the structure.
+ * Used by ssd1306_contextSelect().
+ * @param cache structure to fill
+ */
+void ssd1306_windowCacheSave(ssd1306_window_cache_t *cache);
+
+/**
+ * Makes functions, saved by ssd1306_windowCacheSave(), current and resets tracked
+ * GDRAM pointer position. Used by ssd1306_contextSelect().
+ * @param cache saved functions
+ */
+void ssd1306_windowCacheRestore(const ssd1306_window_cache_t *cache);
+#endif
+
+/**
+ * @brief Sends the same RGB8 pixel count times via ssd1306_intf.send_buffer().
+ *
+ * Generic implementation of ssd1306_lcd.fill_pixels8() for the
+ * controllers, which accept RGB8 pixels as single byte.
+ *
+ * @param color byte, representing RGB8 pixel
+ * @param count number of pixels to send
+ */
+void ssd1306_fillPixels8(uint8_t color, uint32_t count);
+
+/**
+ * @brief Sends buffer of RGB8 pixels to lcd controller via ssd1306_intf.send_buffer().
+ *
+ * Generic implementation of ssd1306_lcd.send_pixels_buffer8() for the
+ * controllers, which accept RGB8 pixels as single byte.
+ *
+ * @param buffer - buffer containing RGB8 pixels.
+ * @param len - number of pixels in the buffer.
+ */
+void ssd1306_sendPixelsBuffer8(const uint8_t *buffer, uint16_t len);
+
+/**
+ * @brief Sends buffer of RGB8 pixels to lcd controller, converted to RGB16.
+ *
+ * Generic implementation of ssd1306_lcd.send_pixels_buffer8() for the
+ * controllers, working in RGB16 mode. Pixels are converted on the stack
+ * in groups and sent via ssd1306_intf.send_buffer(). On platforms other
+ * than AVR conversion uses 256-entry table, built in RAM on first call.
+ *
+ * @param buffer - buffer containing RGB8 pixels.
+ * @param len - number of pixels in the buffer.
+ */
+void ssd1306_sendPixelsBuffer8To16(const uint8_t *buffer, uint16_t len);
+
+/**
+ * @brief Sends the same RGB8 pixel count times, converted to RGB16.
+ *
+ * Generic implementation of ssd1306_lcd.fill_pixels8() for the
+ * controllers, working in RGB16 mode. Uses ssd1306_lcd.fill_pixels16().
+ *
+ * @param color byte, representing RGB8 pixel
+ * @param count number of pixels to send
+ */
+void ssd1306_fillPixels8To16(uint8_t color, uint32_t count);
+
+/**
+ * @brief Sends 8 vertical mono pixels to lcd controller as RGB16 pixels.
+ *
+ * Generic implementation of ssd1306_lcd.send_pixels1() for the
+ * controllers, working in RGB16 mode. Set bits are sent in current color
+ * (ssd1306_setColor()), cleared bits are sent as black. All 8 pixels are
+ * expanded on the stack and sent via single ssd1306_intf.send_buffer() call.
+ *
+ * @param data byte, representing 8 vertical pixels, lsb first
+ */
+void ssd1306_sendPixels1To16(uint8_t data);
+
+/**
+ * @brief Sends buffer of mono pixels to lcd controller as RGB16 pixels.
+ *
+ * Generic implementation of ssd1306_lcd.send_pixels_buffer1() for the
+ * controllers, working in RGB16 mode. Works as ssd1306_sendPixels1To16(),
+ * but groups several bytes into each ssd1306_intf.send_buffer() call.
+ *
+ * @param buffer - buffer containing mono pixels, 8 vertical pixels per byte.
+ * @param len - number of bytes in the buffer.
+ */
+void ssd1306_sendPixelsBuffer1To16(const uint8_t *buffer, uint16_t len);
+
+/**
+ * @brief Sends buffer of RGB16 pixels to lcd controller via ssd1306_intf.send_buffer().
+ *
+ * Generic implementation of ssd1306_lcd.send_pixels_buffer16() for the
+ * controllers, which accept RGB16 pixels as 2 bytes, high byte first.
+ *
+ * @param buffer - buffer containing RGB16 pixels, 2 bytes per pixel.
+ * @param len - number of pixels in the buffer.
+ */
+void ssd1306_sendPixelsBuffer16(const uint8_t *buffer, uint16_t len);
+
+/**
+ * @brief Sends mono pixels, located in Flash, to currently initialized display.
+ *
+ * Flash data are copied to the stack in chunks via memcpy_P() and each chunk is sent
+ * via single ssd1306_lcd.send_pixels_buffer1() call. On platforms, where Flash
+ * is accessible as regular memory, the data are sent without copying if not inverted.
+ *
+ * @param data - pointer to Flash data, 8 vertical pixels per byte.
+ * @param len - number of bytes to send.
+ * @param invert - mask to xor each byte with (0 to send data as is).
+ */
+void ssd1306_sendProgmemPixels1(const uint8_t *data, uint16_t len, uint8_t invert);
+
+/**
+ * @brief Sends color pixels, located in Flash, via buffer function of the display.
+ *
+ * Works as ssd1306_sendProgmemPixels1() for RGB8 and RGB16 pixels.
+ *
+ * @param send_buffer - ssd1306_lcd.send_pixels_buffer8 or ssd1306_lcd.send_pixels_buffer16
+ * @param data - pointer to Flash data.
+ * @param count - number of pixels to send.
+ * @param pixelSize - size of single pixel in bytes: 1 for RGB8 and 2 for RGB16 pixels.
+ */
+void ssd1306_sendProgmemPixels(void (*send_buffer)(const uint8_t *buffer, uint16_t len),
+                               const uint8_t *data, uint32_t count, uint8_t pixelSize);
+
+/**
+ * @brief Enables per-channel color correction of RGB16 pixels.
+ *
+ * Generic RGB16 functions (ssd1306_sendPixelsBuffer16(), ssd1306_sendPixelsBuffer8To16(),
+ * ssd1306_fillPixels16(), ssd1306_sendPixelsBuffer1To16()) pass each pixel through the
+ * tables at transfer time, so gamma correction or brightness fade doesn't need
+ * assets or canvases to be redrawn. Buffers of the application are not changed.
+ * Single pixel functions of the drivers (send_pixels8, send_pixels16) are not corrected.
+ * Tables are not copied and must stay valid while correction is enabled.
+ *
+ * @param red table of 32 entries (5-bit values), located in RAM
+ * @param green table of 64 entries (6-bit values), located in RAM
+ * @param blue table of 32 entries (5-bit values), located in RAM
+ * @note If any table is NULL, correction is disabled.
+ */
+void ssd1306_setColorCorrection16(const uint8_t *red, const uint8_t *green, const uint8_t *blue);
+
+/**
+ * Returns non-zero if color correction of RGB16 pixels is enabled, that is
+ * ssd1306_sendPixelsBuffer16() doesn't send application buffers as is.
+ */
+uint8_t ssd1306_isColorCorrection16(void);
+
+/**
+ * @brief Fills color correction table for ssd1306_setColorCorrection16().
+ *
+ * Entry i gets brightness * (i / (size - 1)) ^ gamma, scaled to size - 1.
+ * Fractional part of gamma is calculated via repeated square roots.
+ *
+ * @param table table to fill
+ * @param size number of entries: 32 for red and blue, 64 for green
+ * @param gamma gamma multiplied by 10, 10 for linear table, 22 for 2.2
+ * @param brightness 0 - 255, 255 for full brightness
+ */
+void ssd1306_makeCorrectionTable(uint8_t *table, uint8_t size, uint8_t gamma, uint8_t brightness);
+
+/**
+ * @brief Sends the same RGB16 pixel count times via ssd1306_intf.send_buffer().
+ *
+ * Generic implementation of ssd1306_lcd.fill_pixels16() for the
+ * controllers, which accept RGB16 pixels as 2 bytes, high byte first.
+ *
+ * @param color 16-bit word, representing RGB16 pixel
+ * @param count number of pixels to send
+ */
+void ssd1306_fillPixels16(uint16_t color, uint32_t count);
+
 /**
  * @brief Sets library display mode for direct draw functions.
  *
@@ -281,6 +818,9 @@ void ssd1306_configureSpiDisplay(const uint8_t *config, uint8_t configSize);
  * There are currently 2 modes supported: LCD_MODE_SSD1306_COMPAT and
  * LCD_MODE_NORMAL. In general, ssd1306 compatible mode uses different GDRAM
  * addressing mode, than normal mode, intended for using with RBG full-color functions.
+ * The active mode is remembered, and nothing is sent to the controller if requested
+ * mode is already active, so mono and color output can be mixed without extra cost.
+ * Display init functions reset remembered mode.
  *
  * @param mode lcd mode to activate.
  * @see LCD_MODE_SSD1306_COMPAT
@@ -289,6 +829,63 @@ void ssd1306_configureSpiDisplay(const uint8_t *config, uint8_t configSize);
  */
 void ssd1306_setMode(lcd_mode_t mode);
 
+/**
+ * @brief Copies block of display content to new position.
+ *
+ * Copies block of display content to new position. This can be used to scroll
+ * part of the screen without sending pixels to the display. Only displays with
+ * graphics accelerator (ssd1331) support this function.
+ * Uncovered part of source block keeps old content.
+ *
+ * @param x1 - x position of left-top corner of source block
+ * @param y1 - y position of left-top corner of source block
+ * @param x2 - x position of right-bottom corner of source block
+ * @param y2 - y position of right-bottom corner of source block
+ * @param x - x position of left-top corner of destination block
+ * @param y - y position of left-top corner of destination block
+ * @return 1 if block is copied, 0 if display doesn't support block copy or
+ *         block is out of screen.
+ */
+uint8_t ssd1306_copyBlock(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x, lcdint_t y);
+
+/**
+ * @brief Rotates display content using display controller.
+ *
+ * Sets screen orientation via controller remap settings and updates
+ * ssd1306_lcd.width and ssd1306_lcd.height. Screen content is not redrawn,
+ * so call the function before drawing. Monochrome ssd1306 displays support
+ * only 0 and 180 degrees, since their GDRAM pages are always vertical: 90 and 270
+ * degrees are applied as 0 and 180 there. Nothing is sent to the controller if
+ * the rotation is already active.
+ *
+ * @param rotation - 0 - normal, 1 - 90 CW, 2 - 180 CW, 3 - 270 CW
+ * @return 1 if rotation is applied, 0 if display doesn't support rotation.
+ */
+uint8_t ssd1306_setRotation(uint8_t rotation);
+
+/**
+ * @brief Waits for vertical blanking of the panel.
+ *
+ * Waits for tearing effect signal of the controller, if it is configured (refer to
+ * ili9341_setTearingPin(), il9163_setTearingPin()). Otherwise returns immediately.
+ * Call the function right before sending full frame: the update is tear-free,
+ * if it is sent faster than the panel scans the screen. Nano engine calls it
+ * automatically before sending full-screen buffer.
+ */
+void ssd1306_waitVSync(void);
+
+/**
+ * @brief Enables tearing effect output of MIPI DCS controllers.
+ *
+ * Sends TEON (v-blank only) or TEOFF command to the controller (ili9341, il9163,
+ * st7735) and configures ssd1306_lcd.wait_vsync to poll TE pin. Waiting is limited
+ * by 40 milliseconds, so not connected pin only slows down the updates.
+ * Used by display drivers.
+ *
+ * @param pin - MCU pin, connected to TE output of the controller, -1 to disable
+ */
+void ssd1306_dcsSetTearingPin(int8_t pin);
+
 /**
  * @brief Does hardware reset for oled controller.
  *
@@ -301,6 +898,20 @@ void ssd1306_setMode(lcd_mode_t mode);
  */
 void ssd1306_resetController(int8_t rstPin, uint8_t delayMs);
 
+/**
+ * @brief Does hardware reset for lcd controller with minimal timings.
+ *
+ * Does hardware reset for lcd controller, using reset pulse width of 10 microseconds,
+ * which is enough for all supported controllers. The function doesn't wait for
+ * controller to complete reset: next ssd1306_configureI2cDisplay() or
+ * ssd1306_configureSpiDisplay() call waits for remaining time if needed.
+ *
+ * @param rstPin reset pin number
+ * @param readyMs time in milliseconds, required by controller after reset before
+ *        it accepts commands
+ */
+void ssd1306_resetControllerFast(int8_t rstPin, uint8_t readyMs);
+
 /**
  * Macro SSD1306_COMPAT_SPI_BLOCK_8BIT_CMDS() generates 2 static functions,
  * applicable for many oled controllers with 8-bit commands:
@@ -319,17 +930,17 @@ void ssd1306_resetController(int8_t rstPin, uint8_t delayMs);
     static void set_block_compat(lcduint_t x, lcduint_t y, lcduint_t w) \
     { \
         uint8_t rx = w ? (x + w - 1) : (ssd1306_lcd.width - 1); \
+        ssd1306_batch_t batch; \
         __s_column = x; \
         __s_page = y; \
-        ssd1306_intf.start(); \
-        ssd1306_spiDataMode(0); \
-        ssd1306_intf.send(column_cmd); \
-        ssd1306_intf.send(x); \
-        ssd1306_intf.send(rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1)); \
-        ssd1306_intf.send(row_cmd); \
-        ssd1306_intf.send(y<<3); \
-        ssd1306_intf.send(((y<<3) + 7) < ssd1306_lcd.height ? ((y<<3) + 7) : (ssd1306_lcd.height - 1)); \
-        ssd1306_spiDataMode(1); \
+        ssd1306_batchBegin(&batch); \
+        ssd1306_batchCommand(&batch, column_cmd); \
+        ssd1306_batchCommand(&batch, x); \
+        ssd1306_batchCommand(&batch, rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1)); \
+        ssd1306_batchCommand(&batch, row_cmd); \
+        ssd1306_batchCommand(&batch, y<<3); \
+        ssd1306_batchCommand(&batch, ((y<<3) + 7) < ssd1306_lcd.height ? ((y<<3) + 7) : (ssd1306_lcd.height - 1)); \
+        ssd1306_batchEnd(&batch, 1); \
     } \
     static void next_page_compat(void) \
     { \
@@ -353,15 +964,15 @@ void ssd1306_resetController(int8_t rstPin, uint8_t delayMs);
     static void set_block_native(lcduint_t x, lcduint_t y, lcduint_t w) \
     { \
         uint8_t rx = w ? (x + w - 1) : (ssd1306_lcd.width - 1); \
-        ssd1306_intf.start(); \
-        ssd1306_spiDataMode(0); \
-        ssd1306_intf.send(column_cmd); \
-        ssd1306_intf.send(x); \
-        ssd1306_intf.send(rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1)); \
-        ssd1306_intf.send(row_cmd); \
-        ssd1306_intf.send(y); \
-        ssd1306_intf.send(ssd1306_lcd.height - 1); \
-        ssd1306_spiDataMode(1); \
+        ssd1306_batch_t batch; \
+        ssd1306_batchBegin(&batch); \
+        ssd1306_batchCommand(&batch, column_cmd); \
+        ssd1306_batchCommand(&batch, x); \
+        ssd1306_batchCommand(&batch, rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1)); \
+        ssd1306_batchCommand(&batch, row_cmd); \
+        ssd1306_batchCommand(&batch, y); \
+        ssd1306_batchCommand(&batch, ssd1306_lcd.height - 1); \
+        ssd1306_batchEnd(&batch, 1); \
     } \
     static void next_page_native(void) \
     { \
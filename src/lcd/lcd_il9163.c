@@ -33,8 +33,8 @@
 #endif
 
 #define CMD_ARG     0xFF
+#define CMD_DELAY   0xFE
 
-extern uint16_t ssd1306_color;
 extern uint32_t s_ssd1306_spi_clock;
 
 static uint8_t s_rotation = 0x00;
@@ -47,7 +47,6 @@ static const PROGMEM uint8_t s_oled128x128_initData[] =
     0x00,
 #endif
 //    0x01,                     // sw reset. not needed, we do hardware reset
-    0x11,                       // exit sleep mode
     0x3A, CMD_ARG, 0x05,        // set 16-bit pixel format
     0x26, CMD_ARG, 0x04,        // set gamma curve: valid values 1, 2, 4, 8
 //    0xF2, CMD_ARG, 0x01,        // enable gamma adjustment, 0 - to disable
@@ -70,6 +69,9 @@ static const PROGMEM uint8_t s_oled128x128_initData[] =
 //    0x2A,  CMD_ARG,  0x00, CMD_ARG, 0x00, CMD_ARG, 0x00, CMD_ARG, 0x7F,   // set column address, not needed. set by direct API
 //    0x2B,  CMD_ARG,  0x00, CMD_ARG, 0x00, CMD_ARG, 0x00, CMD_ARG, 0x9F,   // set page address, not needed. set by direct API
     0x36,  CMD_ARG,  0b10001100,          // enable fake "vertical addressing" mode (for il9163_setBlock() )
+    CMD_DELAY, 115,                       // sleep-out is allowed 120ms after reset
+    0x11,                                 // exit sleep mode
+    CMD_DELAY, 5,                         // wait 5ms after sleep-out before next command
     0x29,                                 // display on
 };
 
@@ -80,7 +82,6 @@ static const PROGMEM uint8_t s_oled128x160_initData[] =
     0x00,
 #endif
 //    0x01,                     // sw reset. not needed, we do hardware reset
-    0x11,                       // exit sleep mode
 //    0x28,                                 // display off
     0x3A, CMD_ARG, 0x05,        // set 16-bit pixel format
     0x26, CMD_ARG, 0x04,        // set gamma curve: valid values 1, 2, 4, 8
@@ -104,6 +105,9 @@ static const PROGMEM uint8_t s_oled128x160_initData[] =
 //    0x2A,  CMD_ARG,  0x00, CMD_ARG, 0x00, CMD_ARG, 0x00, CMD_ARG, 0x7F,   // set column address, not needed. set by direct API
 //    0x2B,  CMD_ARG,  0x00, CMD_ARG, 0x00, CMD_ARG, 0x00, CMD_ARG, 0x9F,   // set page address, not needed. set by direct API
     0x36,  CMD_ARG,  0b00100000,          // enable fake "vertical addressing" mode (for il9163_setBlock() )
+    CMD_DELAY, 115,                       // sleep-out is allowed 120ms after reset
+    0x11,                                 // exit sleep mode
+    CMD_DELAY, 5,                         // wait 5ms after sleep-out before next command
     0x29,                                 // display on
 };
 
@@ -115,50 +119,32 @@ static void il9163_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
     uint8_t rx = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
     s_column = x;
     s_page = y;
-    ssd1306_intf.start();
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2B);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(0);
-    ssd1306_intf.send(x + (s_rotation == 3 ? 32 : 0));
-    ssd1306_intf.send(0);
-    ssd1306_intf.send((rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1))
-                       + (s_rotation == 3 ? 32 : 0));
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2A);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(0);
-    ssd1306_intf.send((y<<3) + (s_rotation == 2 ? 32: 0));
-    ssd1306_intf.send(0);
-    ssd1306_intf.send((((y<<3) + 7) < ssd1306_lcd.height ? ((y<<3) + 7) : (ssd1306_lcd.height - 1))
-                      + (s_rotation == 2 ? 32: 0));
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2C);
-    ssd1306_spiDataMode(1);
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    // According to datasheet all args must be passed in data mode
+    ssd1306_batchRange16(&batch, 0x2B, x + (s_rotation == 3 ? 32 : 0),
+                         (rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1))
+                         + (s_rotation == 3 ? 32 : 0), ssd1306_lcdWindow2B);
+    ssd1306_batchRange16(&batch, 0x2A, (y<<3) + (s_rotation == 2 ? 32: 0),
+                         (((y<<3) + 7) < ssd1306_lcd.height ? ((y<<3) + 7) : (ssd1306_lcd.height - 1))
+                         + (s_rotation == 2 ? 32: 0), ssd1306_lcdWindow2A);
+    ssd1306_batchCommand(&batch, 0x2C);
+    ssd1306_batchEnd(&batch, 1);
 }
 
 static void il9163_setBlock2(lcduint_t x, lcduint_t y, lcduint_t w)
 {
     uint8_t rx = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
-    ssd1306_intf.start();
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2A);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(0);
-    ssd1306_intf.send(x + (s_rotation == 7 ? 32 : 0));
-    ssd1306_intf.send(0);
-    ssd1306_intf.send((rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1))
-                       + (s_rotation == 7 ? 32 : 0));
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2B);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(0);
-    ssd1306_intf.send(y + (s_rotation == 6 ? 32: 0));
-    ssd1306_intf.send(0);
-    ssd1306_intf.send(ssd1306_lcd.height - 1 + (s_rotation == 6 ? 32: 0));
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2C);
-    ssd1306_spiDataMode(1);
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    // According to datasheet all args must be passed in data mode
+    ssd1306_batchRange16(&batch, 0x2A, x + (s_rotation == 7 ? 32 : 0),
+                         (rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1))
+                         + (s_rotation == 7 ? 32 : 0), ssd1306_lcdWindow2A);
+    ssd1306_batchRange16(&batch, 0x2B, y + (s_rotation == 6 ? 32: 0),
+                         ssd1306_lcd.height - 1 + (s_rotation == 6 ? 32: 0), ssd1306_lcdWindow2B);
+    ssd1306_batchCommand(&batch, 0x2C);
+    ssd1306_batchEnd(&batch, 1);
 }
 
 static void il9163_nextPage(void)
@@ -173,6 +159,7 @@ static void il9163_nextPage2(void)
 
 void    il9163_setMode(lcd_mode_t mode)
 {
+    ssd1306_lcdInvalidateState();
     ssd1306_intf.start();
     ssd1306_spiDataMode(0);
     ssd1306_intf.send( 0x36 );
@@ -192,33 +179,6 @@ void    il9163_setMode(lcd_mode_t mode)
     s_rotation = mode ? 0x00 : 0x04;
 }
 
-static void il9163_sendPixels(uint8_t data)
-{
-    for (uint8_t i=8; i>0; i--)
-    {
-        if ( data & 0x01 )
-        {
-            ssd1306_intf.send( (uint8_t)(ssd1306_color>>8) );
-            ssd1306_intf.send( (uint8_t)(ssd1306_color) );
-        }
-        else
-        {
-            ssd1306_intf.send( 0B00000000 );
-            ssd1306_intf.send( 0B00000000 );
-        }
-        data >>= 1;
-    }
-}
-
-static void il9163_sendPixelsBuffer(const uint8_t *buffer, uint16_t len)
-{
-    while(len--)
-    {
-        il9163_sendPixels(*buffer);
-        buffer++;
-    }
-}
-
 static void il9163_sendPixel8(uint8_t data)
 {
     uint16_t color = RGB8_TO_RGB16(data);
@@ -234,17 +194,22 @@ static void il9163_sendPixel16(uint16_t color)
 
 void    il9163_128x128_init()
 {
-    ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1331);
     ssd1306_lcd.height = 128;
     ssd1306_lcd.width = 128;
     s_rgb_bit = 0b00001000; // set BGR mode mapping
     ssd1306_lcd.set_block = il9163_setBlock;
     ssd1306_lcd.next_page = il9163_nextPage;
-    ssd1306_lcd.send_pixels1  = il9163_sendPixels;
-    ssd1306_lcd.send_pixels_buffer1 = il9163_sendPixelsBuffer;
+    ssd1306_lcd.send_pixels1  = ssd1306_sendPixels1To16;
+    ssd1306_lcd.send_pixels_buffer1 = ssd1306_sendPixelsBuffer1To16;
     ssd1306_lcd.send_pixels8 = il9163_sendPixel8;
+    ssd1306_lcd.send_pixels_buffer8 = ssd1306_sendPixelsBuffer8To16;
+    ssd1306_lcd.fill_pixels8 = ssd1306_fillPixels8To16;
     ssd1306_lcd.send_pixels16 = il9163_sendPixel16;
+    ssd1306_lcd.send_pixels_buffer16 = ssd1306_sendPixelsBuffer16;
+    ssd1306_lcd.fill_pixels16 = ssd1306_fillPixels16;
     ssd1306_lcd.set_mode = il9163_setMode;
+    ssd1306_lcd.set_rotation = il9163_setRotation;
     ssd1306_configureSpiDisplay(s_oled128x128_initData, sizeof(s_oled128x128_initData));
 }
 
@@ -252,14 +217,8 @@ void   il9163_128x128_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        pinMode(rstPin, OUTPUT);
-        digitalWrite(rstPin, HIGH);
-        /* Wait at least 1ms after VCC is up for LCD */
-        delay(1);
-        /* Perform reset operation of LCD display */
-        digitalWrite(rstPin, LOW);
-        delay(20);
-        digitalWrite(rstPin, HIGH);
+        /* Commands are accepted 5ms after reset, while sleep-out needs 120ms (see init sequence) */
+        ssd1306_resetControllerFast( rstPin, 5 );
     }
     /* ssd1351 cannot work faster than at 4MHz per datasheet */
     s_ssd1306_spi_clock = 8000000;
@@ -277,6 +236,7 @@ void il9163_setRotation(uint8_t rotation)
         ssd1306_lcd.height = t;
     }
     s_rotation = (rotation & 0x03) | (s_rotation & 0x04);
+    ssd1306_lcdInvalidateState();
     ssd1306_intf.start();
     ssd1306_spiDataMode(0);
     ssd1306_intf.send(0x28);
@@ -315,6 +275,11 @@ void il9163_setRotation(uint8_t rotation)
     ssd1306_intf.stop();
 }
 
+void il9163_setTearingPin(int8_t tePin)
+{
+    ssd1306_dcsSetTearingPin(tePin);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 //                         ST7735 support
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -324,24 +289,16 @@ static void st7735_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
     uint8_t rx = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
     s_column = x;
     s_page = y;
-    ssd1306_intf.start();
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2B);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(0);
-    ssd1306_intf.send(x);
-    ssd1306_intf.send(0);
-    ssd1306_intf.send((rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1)));
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2A);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(0);
-    ssd1306_intf.send((y<<3));
-    ssd1306_intf.send(0);
-    ssd1306_intf.send((((y<<3) + 7) < ssd1306_lcd.height ? ((y<<3) + 7) : (ssd1306_lcd.height - 1)));
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2C);
-    ssd1306_spiDataMode(1);
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    // According to datasheet all args must be passed in data mode
+    ssd1306_batchRange16(&batch, 0x2B, x, rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1),
+                         ssd1306_lcdWindow2B);
+    ssd1306_batchRange16(&batch, 0x2A, y<<3,
+                         ((y<<3) + 7) < ssd1306_lcd.height ? ((y<<3) + 7) : (ssd1306_lcd.height - 1),
+                         ssd1306_lcdWindow2A);
+    ssd1306_batchCommand(&batch, 0x2C);
+    ssd1306_batchEnd(&batch, 1);
 }
 
 #if 0
@@ -371,17 +328,22 @@ static void st7735_setBlock2(lcduint_t x, lcduint_t y, lcduint_t w)
 
 void    st7735_128x160_init()
 {
-    ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1331);
     ssd1306_lcd.width = 128;
     ssd1306_lcd.height = 160;
     s_rgb_bit = 0b00000000; // set RGB mode mapping
     ssd1306_lcd.set_block = st7735_setBlock;
     ssd1306_lcd.next_page = il9163_nextPage;
-    ssd1306_lcd.send_pixels1  = il9163_sendPixels;
-    ssd1306_lcd.send_pixels_buffer1 = il9163_sendPixelsBuffer;
+    ssd1306_lcd.send_pixels1  = ssd1306_sendPixels1To16;
+    ssd1306_lcd.send_pixels_buffer1 = ssd1306_sendPixelsBuffer1To16;
     ssd1306_lcd.send_pixels8 = il9163_sendPixel8;
+    ssd1306_lcd.send_pixels_buffer8 = ssd1306_sendPixelsBuffer8To16;
+    ssd1306_lcd.fill_pixels8 = ssd1306_fillPixels8To16;
     ssd1306_lcd.send_pixels16 = il9163_sendPixel16;
+    ssd1306_lcd.send_pixels_buffer16 = ssd1306_sendPixelsBuffer16;
+    ssd1306_lcd.fill_pixels16 = ssd1306_fillPixels16;
     ssd1306_lcd.set_mode = il9163_setMode;
+    ssd1306_lcd.set_rotation = il9163_setRotation;
     ssd1306_configureSpiDisplay(s_oled128x160_initData, sizeof(s_oled128x160_initData));
 }
 
@@ -389,9 +351,8 @@ void   st7735_128x160_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        ssd1306_resetController( rstPin, 20 );
-        /* Give 120ms display to initialize */
-        delay(120);
+        /* Commands are accepted 5ms after reset, while sleep-out needs 120ms (see init sequence) */
+        ssd1306_resetControllerFast( rstPin, 5 );
     }
     /* ssd1351 cannot work faster than at 4MHz per datasheet */
     s_ssd1306_spi_clock = 8000000;
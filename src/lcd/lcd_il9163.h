@@ -123,6 +123,21 @@ void il9163_setRotation(uint8_t rotation);
  */
 #define st7735_setRotation il9163_setRotation
 
+/**
+ * @brief Enables synchronization with tearing effect (TE) output of the controller
+ *
+ * Enables TE output of il9163/st7735 and polling of the pin, connected to it. Full frame
+ * updates of nano engine and ssd1306_waitVSync() start at vertical blanking then.
+ *
+ * @param tePin pin, connected to TE output of the controller, -1 to disable synchronization
+ */
+void il9163_setTearingPin(int8_t tePin);
+
+/**
+ * @copydoc il9163_setTearingPin
+ */
+#define st7735_setTearingPin il9163_setTearingPin
+
 /**
  * @}
  */
@@ -33,8 +33,8 @@
 #endif
 
 #define CMD_ARG     0xFF
+#define CMD_DELAY   0xFE
 
-extern uint16_t ssd1306_color;
 extern uint32_t s_ssd1306_spi_clock;
 
 static uint8_t s_rotation = 0x00;
@@ -49,7 +49,7 @@ static const PROGMEM uint8_t s_oled240x320_initData[] =
     0x00,
 #endif
     0x01,                     // sw reset. not needed, we do hardware reset
-    0x11,                       // exit sleep mode
+    CMD_DELAY, 5,               // controller accepts commands 5ms after reset
     0x3A, CMD_ARG, 0x05,        // set 16-bit pixel format
     0x26, CMD_ARG, 0x04,        // set gamma curve: valid values 1, 2, 4, 8
     0xF2, CMD_ARG, 0x01,        // enable gamma adjustment, 0 - to disable
@@ -70,6 +70,9 @@ static const PROGMEM uint8_t s_oled240x320_initData[] =
     0xC5,  CMD_ARG,  0x50, CMD_ARG, 0x5B, // vcom control 1
     0xC7,  CMD_ARG,  0x40,                // vcom offset
     0x36,  CMD_ARG,  0b10100000,          // enable fake "vertical addressing" mode (for ili9341_setBlock() )
+    CMD_DELAY, 115,                       // sleep-out is allowed 120ms after reset
+    0x11,                                 // exit sleep mode
+    CMD_DELAY, 5,                         // wait 5ms after sleep-out before next command
     0x29,                                 // display on
 };
 
@@ -81,24 +84,16 @@ static void ili9341_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
     lcduint_t rx = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
     s_column = x;
     s_page = y;
-    ssd1306_intf.start();
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2B);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(x >> 8);
-    ssd1306_intf.send(x & 0xFF);
-    ssd1306_intf.send((rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1)) >> 8);
-    ssd1306_intf.send((rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1)) & 0xFF);
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2A);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send((y<<3) >> 8);
-    ssd1306_intf.send((y<<3)  & 0xFF);
-    ssd1306_intf.send((((y<<3) + 7) < ssd1306_lcd.height ? ((y<<3) + 7) : (ssd1306_lcd.height - 1))>>8);
-    ssd1306_intf.send((((y<<3) + 7) < ssd1306_lcd.height ? ((y<<3) + 7) : (ssd1306_lcd.height - 1)) & 0xFF);
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2C);
-    ssd1306_spiDataMode(1);
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    // According to datasheet all args must be passed in data mode
+    ssd1306_batchRange16(&batch, 0x2B, x, rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1),
+                         ssd1306_lcdWindow2B);
+    ssd1306_batchRange16(&batch, 0x2A, y<<3,
+                         ((y<<3) + 7) < ssd1306_lcd.height ? ((y<<3) + 7) : (ssd1306_lcd.height - 1),
+                         ssd1306_lcdWindow2A);
+    ssd1306_batchCommand(&batch, 0x2C);
+    ssd1306_batchEnd(&batch, 1);
 }
 
 static void ili9341_setBlock2(lcduint_t x, lcduint_t y, lcduint_t w)
@@ -106,24 +101,13 @@ static void ili9341_setBlock2(lcduint_t x, lcduint_t y, lcduint_t w)
     lcduint_t width = s_rotate_output ? ssd1306_lcd.height : ssd1306_lcd.width;
     lcduint_t height = s_rotate_output ? ssd1306_lcd.width : ssd1306_lcd.height;
     lcduint_t rx = w ? (x + w - 1) : (width - 1);
-    ssd1306_intf.start();
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2A);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(x >> 8);
-    ssd1306_intf.send(x & 0xFF);
-    ssd1306_intf.send((rx < width ? rx : (width - 1))>>8);
-    ssd1306_intf.send((rx < width ? rx : (width - 1)) & 0xFF);
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2B);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(y >> 8);
-    ssd1306_intf.send(y & 0xFF);
-    ssd1306_intf.send((height - 1) >> 8);
-    ssd1306_intf.send((height - 1) & 0xFF);
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(0x2C);
-    ssd1306_spiDataMode(1);
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    // According to datasheet all args must be passed in data mode
+    ssd1306_batchRange16(&batch, 0x2A, x, rx < width ? rx : (width - 1), ssd1306_lcdWindow2A);
+    ssd1306_batchRange16(&batch, 0x2B, y, height - 1, ssd1306_lcdWindow2B);
+    ssd1306_batchCommand(&batch, 0x2C);
+    ssd1306_batchEnd(&batch, 1);
 }
 
 static void ili9341_nextPage(void)
@@ -136,6 +120,18 @@ static void ili9341_nextPage2(void)
 {
 }
 
+static void ili9341_setStartLine(lcduint_t line)
+{
+    /* MY bit reverses order of GDRAM rows, so the scroll offset is counted from the end */
+    uint16_t offset = (s_rotation == 4) ? ((320 - line) % 320) : line;
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    ssd1306_batchCommand(&batch, 0x37);
+    ssd1306_batchArg(&batch, offset >> 8);
+    ssd1306_batchArg(&batch, offset & 0xFF);
+    ssd1306_batchEnd(&batch, 0);
+}
+
 void    ili9341_setMode(lcd_mode_t mode)
 {
     s_rotation &= 0x03;
@@ -153,33 +149,6 @@ void    ili9341_setMode(lcd_mode_t mode)
     }
 }
 
-static void ili9341_sendPixels(uint8_t data)
-{
-    for (uint8_t i=8; i>0; i--)
-    {
-        if ( data & 0x01 )
-        {
-            ssd1306_intf.send( (uint8_t)(ssd1306_color>>8) );
-            ssd1306_intf.send( (uint8_t)(ssd1306_color) );
-        }
-        else
-        {
-            ssd1306_intf.send( 0B00000000 );
-            ssd1306_intf.send( 0B00000000 );
-        }
-        data >>= 1;
-    }
-}
-
-static void ili9341_sendPixelsBuffer(const uint8_t *buffer, uint16_t len)
-{
-    while(len--)
-    {
-        ili9341_sendPixels(*buffer);
-        buffer++;
-    }
-}
-
 static void ili9341_sendPixel8(uint8_t data)
 {
     uint16_t color = RGB8_TO_RGB16(data);
@@ -195,17 +164,23 @@ static void ili9341_sendPixel16(uint16_t color)
 
 void    ili9341_240x320_init()
 {
-    ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1331);
     ssd1306_lcd.width = 240;
     ssd1306_lcd.height = (lcduint_t)320;
     s_rgb_bit = 0b00001000; // set BGR mode mapping
     ssd1306_lcd.set_block = ili9341_setBlock;
     ssd1306_lcd.next_page = ili9341_nextPage;
-    ssd1306_lcd.send_pixels1  = ili9341_sendPixels;
-    ssd1306_lcd.send_pixels_buffer1 = ili9341_sendPixelsBuffer;
+    ssd1306_lcd.send_pixels1  = ssd1306_sendPixels1To16;
+    ssd1306_lcd.send_pixels_buffer1 = ssd1306_sendPixelsBuffer1To16;
     ssd1306_lcd.send_pixels8 = ili9341_sendPixel8;
+    ssd1306_lcd.send_pixels_buffer8 = ssd1306_sendPixelsBuffer8To16;
+    ssd1306_lcd.fill_pixels8 = ssd1306_fillPixels8To16;
     ssd1306_lcd.send_pixels16 = ili9341_sendPixel16;
+    ssd1306_lcd.send_pixels_buffer16 = ssd1306_sendPixelsBuffer16;
+    ssd1306_lcd.fill_pixels16 = ssd1306_fillPixels16;
     ssd1306_lcd.set_mode = ili9341_setMode;
+    ssd1306_lcd.set_start_line = NULL;
+    ssd1306_lcd.set_rotation = ili9341_setRotation;
     ssd1306_configureSpiDisplay(s_oled240x320_initData, sizeof(s_oled240x320_initData));
 }
 
@@ -213,14 +188,8 @@ void   ili9341_240x320_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        pinMode(rstPin, OUTPUT);
-        digitalWrite(rstPin, HIGH);
-        /* Wait at least 1ms after VCC is up for LCD */
-        delay(1);
-        /* Perform reset operation of LCD display */
-        digitalWrite(rstPin, LOW);
-        delay(100);
-        digitalWrite(rstPin, HIGH);
+        /* Commands are accepted 5ms after reset, while sleep-out needs 120ms (see init sequence) */
+        ssd1306_resetControllerFast( rstPin, 5 );
     }
     s_ssd1306_spi_clock = 10000000;
     ssd1306_spiInit(cesPin, dcPin);
@@ -237,6 +206,7 @@ void ili9341_setRotation(uint8_t rotation)
         ssd1306_lcd.height = t;
     }
     s_rotation = (rotation & 0x03) | (s_rotation & 0x04);
+    ssd1306_lcdInvalidateState();
     ssd1306_intf.start();
     ssd1306_spiDataMode(0);
     ssd1306_intf.send(0x28);
@@ -271,8 +241,22 @@ void ili9341_setRotation(uint8_t rotation)
     }
     ssd1306_intf.send( ram_mode | s_rgb_bit );
     ssd1306_spiDataMode(0);
+    ssd1306_intf.send(0x37); // reset vertical scrolling
+    ssd1306_spiDataMode(1);
+    ssd1306_intf.send(0x00);
+    ssd1306_intf.send(0x00);
+    ssd1306_spiDataMode(0);
     ssd1306_intf.send(0x29);
     ssd1306_intf.stop();
+    /* Vertical scrolling moves display content along gate lines only, that is when
+     * screen rows are not exchanged with columns (MV bit) */
+    ssd1306_lcd.set_start_line = ((s_rotation & 0x04) && !(ram_mode & 0b00100000)) ?
+                                 ili9341_setStartLine : NULL;
+}
+
+void ili9341_setTearingPin(int8_t tePin)
+{
+    ssd1306_dcsSetTearingPin(tePin);
 }
 
 void ili9341_rotateOutput(uint8_t on)
@@ -105,6 +105,16 @@ void ili9341_setRotation(uint8_t rotation);
  */
 void ili9341_rotateOutput(uint8_t on);
 
+/**
+ * @brief Enables synchronization with tearing effect (TE) output of the controller
+ *
+ * Enables TE output of ili9341 and polling of the pin, connected to it. Full frame
+ * updates of nano engine and ssd1306_waitVSync() start at vertical blanking then.
+ *
+ * @param tePin pin, connected to TE output of ili9341, -1 to disable synchronization
+ */
+void ili9341_setTearingPin(int8_t tePin);
+
 /**
  * @}
  */
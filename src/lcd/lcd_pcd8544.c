@@ -66,11 +66,22 @@ static void pcd8544_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 
 static void pcd8544_nextPage(void)
 {
-    if ( s_width != 1)
+    if ( s_width == 1 )
     {
-        ssd1306_intf.stop();
-        pcd8544_setBlock(s_column, s_page+1, s_width);
+        return;
     }
+    s_page++;
+    /* In horizontal mode controller moves to next row after column 83 itself */
+    if ( s_column == 0 && (s_width == 0 || s_width >= ssd1306_lcd.width) )
+    {
+        return;
+    }
+    /* Narrow blocks are readdressed without closing the transaction, so
+       NOP workaround of spi stop is sent once per block */
+    ssd1306_spiDataMode(0);
+    ssd1306_intf.send(0x80 | s_column);
+    ssd1306_intf.send(0x40 | s_page);
+    ssd1306_spiDataMode(1);
 }
 
 static void pcd8544_setMode(lcd_mode_t mode)
@@ -79,29 +90,23 @@ static void pcd8544_setMode(lcd_mode_t mode)
 
 void pcd8544_84x48_init()
 {
-    ssd1306_lcd.type = LCD_TYPE_PCD8544;
+    ssd1306_lcdInitTable(LCD_TYPE_PCD8544);
     ssd1306_lcd.width = 84;
     ssd1306_lcd.height = 48;
-    ssd1306_intf.start();
-    ssd1306_spiDataMode(0);
     ssd1306_lcd.set_block = pcd8544_setBlock;
     ssd1306_lcd.next_page = pcd8544_nextPage;
     ssd1306_lcd.send_pixels1 = ssd1306_intf.send;
     ssd1306_lcd.send_pixels_buffer1 = ssd1306_intf.send_buffer;
     ssd1306_lcd.set_mode = pcd8544_setMode;
 
-    for( uint8_t i=0; i<sizeof(s_lcd84x48_initData); i++)
-    {
-        ssd1306_intf.send(pgm_read_byte(&s_lcd84x48_initData[i]));
-    }
-    ssd1306_intf.stop();
+    ssd1306_configureI2cDisplay(s_lcd84x48_initData, sizeof(s_lcd84x48_initData));
 }
 
 void    pcd8544_84x48_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        ssd1306_resetController( rstPin, 1 );
+        ssd1306_resetControllerFast( rstPin, 0 );
     }
     ssd1306_spiInit(cesPin, dcPin);
     pcd8544_84x48_init();
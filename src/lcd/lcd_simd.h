@@ -0,0 +1,128 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file lcd_simd.h SIMD kernels for pixel format conversion on Linux hosts
+ *
+ * SSE2 (x86) and NEON (Raspberry Pi) versions are selected at compile time.
+ * Kernels produce RGB16 data in display byte order (high byte first) and
+ * work only on little-endian cores. Bitmaps in "flash" are read directly,
+ * so the kernels are enabled only for hosts, where flash is ordinary memory.
+ * Define SSD1306_NO_SIMD to use scalar code everywhere.
+ */
+
+#ifndef _LCD_SIMD_H_
+#define _LCD_SIMD_H_
+
+#include <stdint.h>
+
+#if !defined(SSD1306_NO_SIMD) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+/** The macro is defined when SSE2 kernels are used */
+#define CONFIG_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+/** The macro is defined when NEON kernels are used */
+#define CONFIG_SIMD_NEON
+#endif
+#endif
+
+#if defined(CONFIG_SIMD_SSE2) || defined(CONFIG_SIMD_NEON)
+/** The macro is defined when SIMD kernels below are available */
+#define CONFIG_SIMD_AVAILABLE
+
+/** Number of pixels, processed by single kernel call */
+#define SIMD_PIXELS  8
+
+/**
+ * Converts 8 RGB8 pixels to 16 bytes of RGB16 data.
+ */
+static inline void simd_rgb8To16(uint8_t *dst, const uint8_t *src)
+{
+#if defined(CONFIG_SIMD_SSE2)
+    __m128i c = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+    __m128i v = _mm_or_si128(_mm_or_si128(
+                    _mm_slli_epi16(_mm_and_si128(c, _mm_set1_epi16(0xE0)), 8),
+                    _mm_slli_epi16(_mm_and_si128(c, _mm_set1_epi16(0x1C)), 6)),
+                    _mm_slli_epi16(_mm_and_si128(c, _mm_set1_epi16(0x03)), 3));
+    _mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+#else
+    uint16x8_t c = vmovl_u8(vld1_u8(src));
+    uint16x8_t v = vorrq_u16(vorrq_u16(
+                       vshlq_n_u16(vandq_u16(c, vdupq_n_u16(0xE0)), 8),
+                       vshlq_n_u16(vandq_u16(c, vdupq_n_u16(0x1C)), 6)),
+                       vshlq_n_u16(vandq_u16(c, vdupq_n_u16(0x03)), 3));
+    vst1q_u8(dst, vrev16q_u8(vreinterpretq_u8_u16(v)));
+#endif
+}
+
+/**
+ * Expands 8 vertical mono pixels (bit 0 first) to 16 bytes of RGB16 data.
+ * bg and fg are colors in display byte order, read as little-endian 16-bit words.
+ */
+static inline void simd_expand1To16(uint8_t *dst, uint8_t data, uint16_t bg, uint16_t fg)
+{
+#if defined(CONFIG_SIMD_SSE2)
+    const __m128i bits = _mm_set_epi16(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    __m128i mask = _mm_cmpeq_epi16(_mm_and_si128(_mm_set1_epi16(data), bits), bits);
+    _mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_and_si128(mask, _mm_set1_epi16(fg)),
+                                                  _mm_andnot_si128(mask, _mm_set1_epi16(bg))));
+#else
+    static const uint16_t bits[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+    uint16x8_t mask = vtstq_u16(vdupq_n_u16(data), vld1q_u16(bits));
+    vst1q_u8(dst, vreinterpretq_u8_u16(vbslq_u16(mask, vdupq_n_u16(fg), vdupq_n_u16(bg))));
+#endif
+}
+
+/**
+ * Fills 8 RGB16 pixels (16 bytes). color is in display byte order, read as
+ * little-endian 16-bit word.
+ */
+static inline void simd_fill16(uint8_t *dst, uint16_t color)
+{
+#if defined(CONFIG_SIMD_SSE2)
+    _mm_storeu_si128((__m128i *)dst, _mm_set1_epi16(color));
+#else
+    vst1q_u8(dst, vreinterpretq_u8_u16(vdupq_n_u16(color)));
+#endif
+}
+
+/**
+ * Copies 16 RGB8 pixels, skipping black (transparent) ones.
+ */
+static inline void simd_copyTransparent8(uint8_t *dst, const uint8_t *src)
+{
+#if defined(CONFIG_SIMD_SSE2)
+    __m128i s = _mm_loadu_si128((const __m128i *)src);
+    __m128i d = _mm_loadu_si128((const __m128i *)dst);
+    __m128i mask = _mm_cmpeq_epi8(s, _mm_setzero_si128());
+    _mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_and_si128(mask, d), _mm_andnot_si128(mask, s)));
+#else
+    uint8x16_t s = vld1q_u8(src);
+    vst1q_u8(dst, vbslq_u8(vceqq_u8(s, vdupq_n_u8(0)), vld1q_u8(dst), s));
+#endif
+}
+#endif
+
+#endif
@@ -23,6 +23,7 @@
 */
 
 #include "oled_sh1106.h"
+#include "oled_ssd1306.h"
 #include "lcd_common.h"
 #include "ssd1306_commands.h"
 #include "intf/ssd1306_interface.h"
@@ -60,43 +61,70 @@ static const uint8_t PROGMEM s_oled128x64_initData[] =
 static uint8_t s_column;
 static uint8_t s_page;
 
-static void sh1106_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
+/*
+ * Page address commands, prepared once per block. For i2c each command is preceded
+ * by control byte with Co bit set, and the last control byte switches to data, so
+ * page commands and pixels of the page go in single i2c transaction. For spi only
+ * commands (odd bytes) are sent, and all pages of the block share one transaction.
+ */
+static uint8_t s_pageCmd[7] =
+{
+    0x80, SSD1306_SETPAGE, 0x80, SSD1306_SETHIGHCOLUMN, 0x80, SSD1306_SETLOWCOLUMN, 0x40,
+};
+
+static void sh1106_sendPageCmd(void)
 {
-    s_column = x;
-    s_page = y;
-    ssd1306_intf.start();
-    if (ssd1306_intf.spi)
-        ssd1306_spiDataMode(0);
-    else
-        ssd1306_intf.send(0x00);
-    ssd1306_intf.send(SSD1306_SETPAGE | y);
-    ssd1306_intf.send(((x+2)>>4) | SSD1306_SETHIGHCOLUMN);
-    ssd1306_intf.send(((x+2) & 0x0f) | SSD1306_SETLOWCOLUMN);
     if (ssd1306_intf.spi)
     {
+        ssd1306_spiDataMode(0);
+        ssd1306_intf.send(s_pageCmd[1]);
+        ssd1306_intf.send(s_pageCmd[3]);
+        ssd1306_intf.send(s_pageCmd[5]);
         ssd1306_spiDataMode(1);
     }
     else
     {
-        ssd1306_intf.stop();
-        ssd1306_intf.start();
-        ssd1306_intf.send(0x40);
+        ssd1306_intf.send_buffer(s_pageCmd, sizeof(s_pageCmd));
     }
 }
 
+static void sh1106_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
+{
+    s_column = x;
+    s_page = y;
+    /* SH1106 has 132 columns of GDRAM, 128x64 panels are connected to columns 2-129 */
+    s_pageCmd[1] = SSD1306_SETPAGE | y;
+    s_pageCmd[3] = ((x+2)>>4) | SSD1306_SETHIGHCOLUMN;
+    s_pageCmd[5] = ((x+2) & 0x0f) | SSD1306_SETLOWCOLUMN;
+    ssd1306_intf.start();
+    sh1106_sendPageCmd();
+}
+
 static void sh1106_nextPage(void)
 {
-    ssd1306_intf.stop();
-    sh1106_setBlock(s_column,s_page+1,0);
+    s_page++;
+    s_pageCmd[1] = SSD1306_SETPAGE | s_page;
+    if (!ssd1306_intf.spi)
+    {
+        /* i2c data stream cannot be switched back to commands */
+        ssd1306_intf.stop();
+        ssd1306_intf.start();
+    }
+    sh1106_sendPageCmd();
 }
 
 static void sh1106_setMode(lcd_mode_t mode)
 {
 }
 
+static void sh1106_setStartLine(lcduint_t line)
+{
+    ssd1306_sendCommand( SSD1306_SETSTARTLINE | (line & 0x3F) );
+}
+
 void    sh1106_128x64_init()
 {
-    ssd1306_lcd.type = LCD_TYPE_SH1106;
+    ssd1306_lcdInitTable(LCD_TYPE_SH1106);
     ssd1306_lcd.height = 64;
     ssd1306_lcd.width = 128;
     ssd1306_lcd.set_block = sh1106_setBlock;
@@ -104,10 +132,9 @@ void    sh1106_128x64_init()
     ssd1306_lcd.send_pixels1 = ssd1306_intf.send;
     ssd1306_lcd.send_pixels_buffer1 = ssd1306_intf.send_buffer;
     ssd1306_lcd.set_mode = sh1106_setMode;
-    for( uint8_t i=0; i<sizeof(s_oled128x64_initData); i++)
-    {
-        ssd1306_sendCommand(pgm_read_byte(&s_oled128x64_initData[i]));
-    }
+    ssd1306_lcd.set_start_line = sh1106_setStartLine;
+    ssd1306_lcd.set_brightness = ssd1306_setContrast;
+    ssd1306_configureI2cDisplay(s_oled128x64_initData, sizeof(s_oled128x64_initData));
 }
 
 void    sh1106_128x64_i2c_init()
@@ -120,7 +147,7 @@ void   sh1106_128x64_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        ssd1306_resetController( rstPin, 10 );
+        ssd1306_resetControllerFast( rstPin, 0 );
     }
     ssd1306_spiInit(cesPin, dcPin);
     sh1106_128x64_init();
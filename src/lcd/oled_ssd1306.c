@@ -29,11 +29,19 @@
 #include "intf/i2c/ssd1306_i2c.h"
 #include "intf/spi/ssd1306_spi.h"
 #include "ssd1306_hal/io.h"
+#include "ssd1306_1bit.h"
 #ifdef SDL_EMULATION
 #include "sdl_core.h"
 #endif
 
+extern SFixedFontInfo s_fixedFont;
+
 uint8_t s_ssd1306_startLine = 0;
+/* Non-zero while controller is in vertical addressing mode, set by set_column_block() */
+static uint8_t s_ssd1306_vertical = 0;
+/* Non-zero in double buffered mode, pageOffset is the first page of GDRAM half to draw to */
+static uint8_t s_ssd1306_doubleBuffer = 0;
+static uint8_t s_ssd1306_pageOffset = 0;
 
 static const uint8_t PROGMEM s_oled128x64_initData[] =
 {
@@ -85,27 +93,41 @@ static const uint8_t PROGMEM s_oled128x32_initData[] =
 
 static void ssd1306_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
-    ssd1306_intf.start();
-    if (ssd1306_intf.spi)
-        ssd1306_spiDataMode(0);
-    else
-        ssd1306_intf.send(0x00);
-    ssd1306_intf.send(SSD1306_COLUMNADDR);
-    ssd1306_intf.send(x);
-    ssd1306_intf.send(w ? (x + w - 1) : (ssd1306_lcd.width - 1));
-    ssd1306_intf.send(SSD1306_PAGEADDR);
-    ssd1306_intf.send(y);
-    ssd1306_intf.send((ssd1306_lcd.height >> 3) - 1);
-    if (ssd1306_intf.spi)
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    if (s_ssd1306_vertical)
     {
-        ssd1306_spiDataMode(1);
+        /* Horizontal addressing is restored only after column blocks */
+        ssd1306_batchCommand(&batch, SSD1306_MEMORYMODE);
+        ssd1306_batchCommand(&batch, HORIZONTAL_ADDRESSING_MODE);
+        s_ssd1306_vertical = 0;
     }
-    else
+    ssd1306_batchCommand(&batch, SSD1306_COLUMNADDR);
+    ssd1306_batchCommand(&batch, x);
+    ssd1306_batchCommand(&batch, w ? (x + w - 1) : (ssd1306_lcd.width - 1));
+    ssd1306_batchCommand(&batch, SSD1306_PAGEADDR);
+    ssd1306_batchCommand(&batch, y + s_ssd1306_pageOffset);
+    ssd1306_batchCommand(&batch, s_ssd1306_pageOffset + (ssd1306_lcd.height >> 3) - 1);
+    ssd1306_batchEnd(&batch, 1);
+}
+
+static void ssd1306_setColumnBlock(lcduint_t x, lcduint_t y, lcduint_t w, lcduint_t h)
+{
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    if (!s_ssd1306_vertical)
     {
-        ssd1306_intf.stop();
-        ssd1306_intf.start();
-        ssd1306_intf.send(0x40);
+        ssd1306_batchCommand(&batch, SSD1306_MEMORYMODE);
+        ssd1306_batchCommand(&batch, VERTICAL_ADDRESSING_MODE);
+        s_ssd1306_vertical = 1;
     }
+    ssd1306_batchCommand(&batch, SSD1306_COLUMNADDR);
+    ssd1306_batchCommand(&batch, x);
+    ssd1306_batchCommand(&batch, x + w - 1);
+    ssd1306_batchCommand(&batch, SSD1306_PAGEADDR);
+    ssd1306_batchCommand(&batch, y + s_ssd1306_pageOffset);
+    ssd1306_batchCommand(&batch, y + s_ssd1306_pageOffset + h - 1);
+    ssd1306_batchEnd(&batch, 1);
 }
 
 static void ssd1306_nextPage(void)
@@ -116,6 +138,11 @@ static void ssd1306_setMode_int(lcd_mode_t mode)
 {
 }
 
+static void ssd1306_setStartLine_int(lcduint_t line)
+{
+    ssd1306_setStartLine(line);
+}
+
 void ssd1306_displayOff()
 {
     ssd1306_sendCommand(SSD1306_DISPLAYOFF);
@@ -161,11 +188,98 @@ void ssd1306_setStartLine(uint8_t line)
     ssd1306_sendCommand( SSD1306_SETSTARTLINE | (line & 0x3F) );
 }
 
+static void ssd1306_setRotation_int(uint8_t rotation)
+{
+    /* Pages are always vertical, so only 180 degrees can be done by remapping */
+    ssd1306_flipHorizontal( rotation & 0x02 );
+    ssd1306_flipVertical( rotation & 0x02 );
+}
+
 uint8_t ssd1306_getStartLine(void)
 {
     return s_ssd1306_startLine;
 }
 
+uint8_t ssd1306_setDoubleBuffer(uint8_t enable)
+{
+    /* Only panels, showing half of 64-row GDRAM, have spare area */
+    if ( (ssd1306_lcd.type != LCD_TYPE_SSD1306) || (ssd1306_lcd.height != 32) )
+    {
+        return 0;
+    }
+    s_ssd1306_doubleBuffer = enable;
+    s_ssd1306_pageOffset = enable ? (ssd1306_lcd.height >> 3) : 0;
+    ssd1306_setStartLine(0);
+    return 1;
+}
+
+void ssd1306_swapBuffers(void)
+{
+    if ( !s_ssd1306_doubleBuffer )
+    {
+        return;
+    }
+    /* Start line command is applied by controller at once, so there is no tearing */
+    ssd1306_setStartLine( s_ssd1306_pageOffset << 3 );
+    s_ssd1306_pageOffset = s_ssd1306_pageOffset ? 0 : (ssd1306_lcd.height >> 3);
+}
+
+void ssd1306_configureScroll(uint8_t direction, uint8_t startPage, uint8_t endPage,
+                             uint8_t interval, uint8_t verticalOffset)
+{
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    /* Scroll parameters must not be changed while scroll is active */
+    ssd1306_batchCommand(&batch, SSD1306_DEACTIVATE_SCROLL);
+    if (verticalOffset)
+    {
+        ssd1306_batchCommand(&batch, SSD1306_SET_VERTICAL_SCROLL_AREA);
+        ssd1306_batchCommand(&batch, 0);
+        ssd1306_batchCommand(&batch, ssd1306_lcd.height);
+        ssd1306_batchCommand(&batch, direction ? SSD1306_VERTICAL_AND_LEFT_HORIZONTAL_SCROLL
+                                               : SSD1306_VERTICAL_AND_RIGHT_HORIZONTAL_SCROLL);
+    }
+    else
+    {
+        ssd1306_batchCommand(&batch, direction ? SSD1306_LEFT_HORIZONTAL_SCROLL
+                                               : SSD1306_RIGHT_HORIZONTAL_SCROLL);
+    }
+    ssd1306_batchCommand(&batch, 0x00); // dummy byte
+    ssd1306_batchCommand(&batch, (startPage + s_ssd1306_pageOffset) & 0x07);
+    ssd1306_batchCommand(&batch, interval & 0x07);
+    ssd1306_batchCommand(&batch, (endPage + s_ssd1306_pageOffset) & 0x07);
+    if (verticalOffset)
+    {
+        ssd1306_batchCommand(&batch, verticalOffset & 0x3F);
+    }
+    else
+    {
+        ssd1306_batchCommand(&batch, 0x00); // dummy bytes
+        ssd1306_batchCommand(&batch, 0xFF);
+    }
+    ssd1306_batchEnd(&batch, 0);
+}
+
+void ssd1306_startScroll(void)
+{
+    ssd1306_sendCommand(SSD1306_ACTIVATE_SCROLL);
+}
+
+void ssd1306_stopScroll(void)
+{
+    ssd1306_sendCommand(SSD1306_DEACTIVATE_SCROLL);
+}
+
+void ssd1306_marquee(uint8_t y, const char *text, uint8_t direction, uint8_t interval)
+{
+    uint8_t page = y >> 3;
+    ssd1306_stopScroll();
+    ssd1306_clearBlock(0, page, ssd1306_lcd.width, s_fixedFont.pages << 3);
+    ssd1306_printFixed(0, y, text, STYLE_NORMAL);
+    ssd1306_configureScroll(direction, page, page + s_fixedFont.pages - 1, interval, 0);
+    ssd1306_startScroll();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //  I2C SSD1306 128x64
 ///////////////////////////////////////////////////////////////////////////////
@@ -178,7 +292,10 @@ void    ssd1306_init()
 
 void    ssd1306_128x64_init()
 {
-    ssd1306_lcd.type = LCD_TYPE_SSD1306;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1306);
+    s_ssd1306_vertical = 0;
+    s_ssd1306_pageOffset = 0;
+    s_ssd1306_doubleBuffer = 0;
     ssd1306_lcd.height = 64;
     ssd1306_lcd.width = 128;
     ssd1306_lcd.set_block = ssd1306_setBlock;
@@ -186,10 +303,14 @@ void    ssd1306_128x64_init()
     ssd1306_lcd.send_pixels1  = ssd1306_intf.send;
     ssd1306_lcd.send_pixels_buffer1 = ssd1306_intf.send_buffer;
     ssd1306_lcd.set_mode = ssd1306_setMode_int;
-    for( uint8_t i=0; i<sizeof(s_oled128x64_initData); i++)
-    {
-        ssd1306_sendCommand(pgm_read_byte(&s_oled128x64_initData[i]));
-    }
+    ssd1306_lcd.set_start_line = ssd1306_setStartLine_int;
+    ssd1306_lcd.set_rotation = ssd1306_setRotation_int;
+    ssd1306_lcd.set_brightness = ssd1306_setContrast;
+    ssd1306_lcd.set_column_block = ssd1306_setColumnBlock;
+#ifdef CONFIG_SSD1306_WINDOW_CACHE_ENABLE
+    ssd1306_windowCacheAttach();
+#endif
+    ssd1306_configureI2cDisplay(s_oled128x64_initData, sizeof(s_oled128x64_initData));
 }
 
 void    ssd1306_128x64_i2c_init()
@@ -212,7 +333,7 @@ void   ssd1306_128x64_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        ssd1306_resetController( rstPin, 10 );
+        ssd1306_resetControllerFast( rstPin, 0 );
     }
     ssd1306_spiInit(cesPin, dcPin);
     ssd1306_128x64_init();
@@ -224,17 +345,26 @@ void   ssd1306_128x64_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 
 void    ssd1306_128x32_init()
 {
-    ssd1306_lcd.type = LCD_TYPE_SSD1306;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1306);
+    s_ssd1306_vertical = 0;
+    s_ssd1306_pageOffset = 0;
+    s_ssd1306_doubleBuffer = 0;
     ssd1306_lcd.height = 32;
     ssd1306_lcd.width = 128;
     ssd1306_lcd.set_block = ssd1306_setBlock;
     ssd1306_lcd.next_page = ssd1306_nextPage;
     ssd1306_lcd.send_pixels1  = ssd1306_intf.send;
+    ssd1306_lcd.send_pixels_buffer1 = ssd1306_intf.send_buffer;
     ssd1306_lcd.set_mode = ssd1306_setMode_int;
-    for( uint8_t i=0; i < sizeof(s_oled128x32_initData); i++)
-    {
-        ssd1306_sendCommand(pgm_read_byte(&s_oled128x32_initData[i]));
-    }
+    // 128x32 panel shows only half of GDRAM, so scrolled lines would wrap to invisible area
+    ssd1306_lcd.set_start_line = NULL;
+    ssd1306_lcd.set_rotation = ssd1306_setRotation_int;
+    ssd1306_lcd.set_brightness = ssd1306_setContrast;
+    ssd1306_lcd.set_column_block = ssd1306_setColumnBlock;
+#ifdef CONFIG_SSD1306_WINDOW_CACHE_ENABLE
+    ssd1306_windowCacheAttach();
+#endif
+    ssd1306_configureI2cDisplay(s_oled128x32_initData, sizeof(s_oled128x32_initData));
 }
 
 
@@ -252,7 +382,7 @@ void   ssd1306_128x32_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        ssd1306_resetController( rstPin, 10 );
+        ssd1306_resetControllerFast( rstPin, 0 );
     }
     ssd1306_spiInit(cesPin, dcPin);
     ssd1306_128x32_init();
@@ -186,6 +186,93 @@ void ssd1306_setStartLine(uint8_t line);
  */
 uint8_t ssd1306_getStartLine(void);
 
+/**
+ * @brief Enables double buffering in spare GDRAM of 128x32 displays.
+ *
+ * ssd1306 controller has 64 rows of GDRAM, but 128x32 panels show only half of them.
+ * In double buffered mode all drawing functions write to the hidden half, and
+ * ssd1306_swapBuffers() shows it with single start line command. So, frames appear
+ * at once without partial updates, even at slow i2c speed, and without MCU framebuffer.
+ * Hidden half keeps the frame before previous one, so each frame should be redrawn
+ * completely (or the same changes should be applied to both halves).
+ *
+ * @param enable 1 to enable double buffering, 0 to draw to visible GDRAM again
+ * @return 1 if double buffering is enabled, 0 if display has no spare GDRAM.
+ */
+uint8_t ssd1306_setDoubleBuffer(uint8_t enable);
+
+/**
+ * @brief Shows GDRAM half with just drawn frame.
+ *
+ * Shows GDRAM half, where drawing functions wrote since last call, and switches drawing
+ * functions to another half. Does nothing if double buffering is not enabled.
+ * @see ssd1306_setDoubleBuffer()
+ */
+void ssd1306_swapBuffers(void);
+
+/** Time interval between SSD1306 scroll steps, in frames. */
+enum ESsd1306ScrollInterval
+{
+    SSD1306_SCROLL_5_FRAMES    = 0x00,
+    SSD1306_SCROLL_64_FRAMES   = 0x01,
+    SSD1306_SCROLL_128_FRAMES  = 0x02,
+    SSD1306_SCROLL_256_FRAMES  = 0x03,
+    SSD1306_SCROLL_3_FRAMES    = 0x04,
+    SSD1306_SCROLL_4_FRAMES    = 0x05,
+    SSD1306_SCROLL_25_FRAMES   = 0x06,
+    SSD1306_SCROLL_2_FRAMES    = 0x07,
+};
+
+/**
+ * @brief Configures continuous hardware scroll of ssd1306 controller.
+ *
+ * Configures controller to scroll content of the pages in range [startPage; endPage]
+ * by one column each interval without any data transfers from MCU. Columns, moved out
+ * of the display, appear on the other side. If verticalOffset is not zero, whole
+ * display also scrolls vertically by verticalOffset rows each step (diagonal scroll).
+ * Active scroll is stopped by this function, call ssd1306_startScroll() to start it.
+ *
+ * @param direction 0 to scroll right, 1 to scroll left
+ * @param startPage first page (8 pixels rows) to scroll
+ * @param endPage last page to scroll
+ * @param interval time between scroll steps (ESsd1306ScrollInterval)
+ * @param verticalOffset rows to scroll vertically each step, 0 for horizontal scroll
+ * @note Supported only by ssd1306, use ssd1306_setStartLine() for vertical scroll
+ *       on other monochrome displays.
+ */
+void ssd1306_configureScroll(uint8_t direction, uint8_t startPage, uint8_t endPage,
+                             uint8_t interval, uint8_t verticalOffset);
+
+/**
+ * Starts hardware scroll, configured by ssd1306_configureScroll().
+ * Do not draw to scrolled area, while scroll is active: controller
+ * moves GDRAM content and new data can be corrupted.
+ */
+void ssd1306_startScroll(void);
+
+/**
+ * Stops hardware scroll. GDRAM content stays shifted, so scrolled area
+ * should be redrawn if its original position matters.
+ */
+void ssd1306_stopScroll(void);
+
+/**
+ * @brief Shows text, scrolled by ssd1306 controller.
+ *
+ * Clears text row at y position, prints text there once with current fixed font,
+ * and starts hardware scroll of the pages, occupied by the font. So, ticker text
+ * moves without any further bus traffic. Text, wider than display, is cut.
+ * Call ssd1306_stopScroll() before drawing to other parts of the display,
+ * and ssd1306_startScroll() to continue scrolling after that.
+ *
+ * @param y vertical position of the text in pixels (must be divided by 8)
+ * @param text null-terminated string to show
+ * @param direction 0 to scroll right, 1 to scroll left
+ * @param interval time between scroll steps (ESsd1306ScrollInterval)
+ * @see ssd1306_setFixedFont
+ */
+void ssd1306_marquee(uint8_t y, const char *text, uint8_t direction, uint8_t interval);
+
 /**
  * @}
  */
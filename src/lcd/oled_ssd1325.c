@@ -31,6 +31,9 @@
 #include "sdl_core.h"
 #endif
 
+/* Number of mono bytes, expanded on the stack by ssd1325_sendPixelsBuffer() per send_buffer() call */
+#define SSD1325_MONO_CHUNK_BYTES  8
+
 extern uint16_t ssd1306_color;
 
 static const PROGMEM uint8_t s_oled_128x64_initData[] =
@@ -62,24 +65,37 @@ static const PROGMEM uint8_t s_oled_128x64_initData[] =
 
 SSD1306_COMPAT_SPI_BLOCK_8BIT_CMDS( 0x15, 0x75 );
 
-static void ssd1325_sendPixels(uint8_t data)
+/*
+ * Each mono byte is expanded to 4 bytes of packed nibbles. Nibble pairs are taken
+ * from the table, indexed by 2 neighbour bits, and sent via single send_buffer() call.
+ */
+static void ssd1325_sendPixelsBuffer(const uint8_t *buffer, uint16_t len)
 {
-    for (uint8_t i=4; i>0; i--)
+    uint8_t color = ssd1306_color;
+    uint8_t pairs[4] = { 0x00, color, (uint8_t)(color << 4), (uint8_t)(color | (color << 4)) };
+    uint8_t burst[SSD1325_MONO_CHUNK_BYTES << 2];
+    while (len)
     {
-        uint8_t color = (data & 0x01) ? ssd1306_color : 0;
-        color |= (((data & 0x02) ? ssd1306_color: 0) << 4);
-        ssd1306_intf.send(color);
-        data >>= 2;
+        uint8_t count = len < SSD1325_MONO_CHUNK_BYTES ? len : SSD1325_MONO_CHUNK_BYTES;
+        uint8_t *dst = burst;
+        for (uint8_t i = count; i > 0; i--)
+        {
+            uint8_t data = *buffer;
+            dst[0] = pairs[data & 0x03];
+            dst[1] = pairs[(data >> 2) & 0x03];
+            dst[2] = pairs[(data >> 4) & 0x03];
+            dst[3] = pairs[data >> 6];
+            dst += 4;
+            buffer++;
+        }
+        ssd1306_intf.send_buffer(burst, (uint16_t)count << 2);
+        len -= count;
     }
 }
 
-static void ssd1325_sendPixelsBuffer(const uint8_t *buffer, uint16_t len)
+static void ssd1325_sendPixels(uint8_t data)
 {
-    while(len--)
-    {
-        ssd1325_sendPixels(*buffer);
-        buffer++;
-    }
+    ssd1325_sendPixelsBuffer(&data, 1);
 }
 
 //////////////////////// SSD1331 NATIVE MODE ///////////////////////////////////
@@ -91,6 +107,7 @@ CONTROLLER_NATIVE_SPI_BLOCK_8BIT_CMDS( 0x15, 0x75 );
 
 void    ssd1325_setMode(lcd_mode_t mode)
 {
+    ssd1306_lcdInvalidateState();
     if (mode == LCD_MODE_NORMAL)
     {
         ssd1306_lcd.set_block = set_block_native;
@@ -104,14 +121,15 @@ void    ssd1325_setMode(lcd_mode_t mode)
     ssd1306_intf.start();
     ssd1306_spiDataMode(0);
     ssd1306_intf.send( 0xA0 );
-    ssd1306_intf.send( 0x10 | (mode == LCD_MODE_NORMAL ? 0x00 : 0x04) );
+    /* Keep column and nibble remap of init sequence, so both modes have the same orientation */
+    ssd1306_intf.send( 0x10 | 0x02 | 0x01 | (mode == LCD_MODE_NORMAL ? 0x00 : 0x04) );
     ssd1306_intf.stop();
     return;
 }
 
 void    ssd1325_128x64_init()
 {
-    ssd1306_lcd.type = LCD_TYPE_CUSTOM;
+    ssd1306_lcdInitTable(LCD_TYPE_CUSTOM);
     ssd1306_lcd.width = 128;  // specify width
     ssd1306_lcd.height = 64; // specify height
     // Set functions for compatible mode
@@ -121,6 +139,10 @@ void    ssd1325_128x64_init()
     ssd1306_lcd.send_pixels_buffer1 = ssd1325_sendPixelsBuffer;
     // Set function for 8-bit mode
     ssd1306_lcd.send_pixels8 = ssd1306_intf.send;
+    ssd1306_lcd.send_pixels_buffer8 = ssd1306_sendPixelsBuffer8;
+    // Native mode accepts packed 4-bit pixels as is
+    ssd1306_lcd.send_pixels_buffer4 = ssd1306_sendPixelsBuffer8;
+    ssd1306_lcd.fill_pixels8 = ssd1306_fillPixels8;
     ssd1306_lcd.set_mode = ssd1325_setMode;
     // Use one of 2 functions for initialization below
     // Please, read help on this functions and read datasheet before you decide, which
@@ -133,7 +155,7 @@ void   ssd1325_128x64_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        ssd1306_resetController( rstPin, 10 );
+        ssd1306_resetControllerFast( rstPin, 1 );
     }
     ssd1306_spiInit(cesPin, dcPin);
     ssd1325_128x64_init();
@@ -107,14 +107,161 @@ CONTROLLER_NATIVE_SPI_BLOCK_8BIT_CMDS(
      (s_rotation & 1) ? SSD1331_ROWADDR: SSD1331_COLUMNADDR,
      (s_rotation & 1) ? SSD1331_COLUMNADDR: SSD1331_ROWADDR );
 
+//////////////////////// SSD1331 HARDWARE ACCELERATION /////////////////////////
+
+static uint8_t s_blockX;
+static uint8_t s_blockY;
+static uint8_t s_blockW;
+
+static void set_block_native_hw(lcduint_t x, lcduint_t y, lcduint_t w)
+{
+    /* Remember block, since hardware fill needs window coordinates */
+    s_blockX = x;
+    s_blockY = y;
+    s_blockW = w ? w : (ssd1306_lcd.width - x);
+    set_block_native(x, y, w);
+}
+
+/* Time, SSD1331 needs to draw single row of the rectangle or copied block */
+#define SSD1331_HW_ROW_US    48
+/* Time, SSD1331 needs to draw the line */
+#define SSD1331_HW_LINE_US   100
+
+static uint8_t ssd1331_inScreen(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    return (x1 >= 0) && (y1 >= 0) && (x1 <= x2) && (y1 <= y2) &&
+           (x2 < (lcdint_t)ssd1306_lcd.width) && (y2 < (lcdint_t)ssd1306_lcd.height);
+}
+
+static void ssd1331_hwPoint(lcdint_t x, lcdint_t y)
+{
+    /* Drawing commands accept controller columns and rows, not rotated ones */
+    ssd1306_intf.send( (s_rotation & 1) ? y : x );
+    ssd1306_intf.send( (s_rotation & 1) ? x : y );
+}
+
+static void ssd1331_hwColor(uint16_t color)
+{
+    /* Blue, green and red components in 6-bit scale, same as ssd1331_drawLine() */
+    ssd1306_intf.send( (color << 1) & 0x3F );
+    ssd1306_intf.send( (color >> 5) & 0x3F );
+    ssd1306_intf.send( (color >> 11) << 1 );
+}
+
+static void ssd1331_hwWaitRows(lcdint_t rows)
+{
+    /* Rows are processed sequentially, GDRAM must not be accessed until the end */
+    while (rows-- > 0)
+    {
+        delayMicroseconds( SSD1331_HW_ROW_US );
+    }
+}
+
+/* Must be called inside the session. Leaves spi in data mode */
+static void ssd1331_hwRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint16_t color, uint8_t fill)
+{
+    ssd1306_spiDataMode(0);
+    ssd1306_intf.send( SSD1331_FILL );
+    ssd1306_intf.send( fill );
+    ssd1306_intf.send( SSD1331_DRAWRECT );
+    ssd1331_hwPoint( x1, y1 );
+    ssd1331_hwPoint( x2, y2 );
+    ssd1331_hwColor( color ); // outline color
+    ssd1331_hwColor( color ); // fill color
+    ssd1331_hwWaitRows( y2 - y1 + 1 );
+    ssd1306_spiDataMode(1);
+}
+
+static uint8_t ssd1331_hwDrawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint16_t color)
+{
+    if ( !ssd1331_inScreen( x1 < x2 ? x1 : x2, y1 < y2 ? y1 : y2,
+                            x1 < x2 ? x2 : x1, y1 < y2 ? y2 : y1 ) )
+    {
+        return 0;
+    }
+    ssd1306_intf.start();
+    ssd1306_spiDataMode(0);
+    ssd1306_intf.send( SSD1331_DRAWLINE );
+    ssd1331_hwPoint( x1, y1 );
+    ssd1331_hwPoint( x2, y2 );
+    ssd1331_hwColor( color );
+    delayMicroseconds( SSD1331_HW_LINE_US );
+    ssd1306_intf.stop();
+    return 1;
+}
+
+static uint8_t ssd1331_hwDrawRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint16_t color)
+{
+    if ( !ssd1331_inScreen( x1, y1, x2, y2 ) )
+    {
+        return 0;
+    }
+    ssd1306_intf.start();
+    ssd1331_hwRect( x1, y1, x2, y2, color, 0x00 );
+    ssd1306_intf.stop();
+    return 1;
+}
+
+static uint8_t ssd1331_hwCopyBlock(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x, lcdint_t y)
+{
+    if ( !ssd1331_inScreen( x1, y1, x2, y2 ) ||
+         !ssd1331_inScreen( x, y, x + x2 - x1, y + y2 - y1 ) )
+    {
+        return 0;
+    }
+    ssd1306_intf.start();
+    ssd1306_spiDataMode(0);
+    ssd1306_intf.send( SSD1331_COPY );
+    ssd1331_hwPoint( x1, y1 );
+    ssd1331_hwPoint( x2, y2 );
+    ssd1331_hwPoint( x, y );
+    ssd1331_hwWaitRows( y2 - y1 + 1 );
+    ssd1306_intf.stop();
+    return 1;
+}
+
+static uint8_t ssd1331_hwFillBlock(uint16_t color, uint32_t count)
+{
+    /* set_block() window always spans to the bottom of the screen, so only
+       full rows of the block can be filled by hardware */
+    if ( (s_rotation & 0x04) || !s_blockW )
+    {
+        return 0;
+    }
+    uint8_t rows = count / s_blockW;
+    if ( !rows || ((uint32_t)rows * s_blockW != count) || (rows > ssd1306_lcd.height - s_blockY) )
+    {
+        return 0;
+    }
+    ssd1331_hwRect( s_blockX, s_blockY, s_blockX + s_blockW - 1, s_blockY + rows - 1, color, 0x01 );
+    return 1;
+}
+
+static void ssd1331_fillPixels8(uint8_t color, uint32_t count)
+{
+    if ( !ssd1331_hwFillBlock( RGB8_TO_RGB16(color), count ) )
+    {
+        ssd1306_fillPixels8( color, count );
+    }
+}
+
+static void ssd1331_fillPixels16(uint16_t color, uint32_t count)
+{
+    if ( !ssd1331_hwFillBlock( color, count ) )
+    {
+        ssd1306_fillPixels16( color, count );
+    }
+}
+
 //////////////////////////// GENERIC FUNCTIONS ////////////////////////////
 
 void    ssd1331_setMode(lcd_mode_t mode)
 {
+    ssd1306_lcdInvalidateState();
     if (mode == LCD_MODE_NORMAL)
     {
         s_rotation &= ~0x04;
-        ssd1306_lcd.set_block = set_block_native;
+        ssd1306_lcd.set_block = set_block_native_hw;
         ssd1306_lcd.next_page = next_page_native;
     }
     else if (mode == LCD_MODE_SSD1306_COMPAT )
@@ -127,8 +274,18 @@ void    ssd1331_setMode(lcd_mode_t mode)
     return;
 }
 
+static void ssd1331_setBrightness(uint8_t level)
+{
+    ssd1306_intf.start();
+    ssd1306_spiDataMode(0);
+    ssd1306_intf.send( SSD1331_MASTERCURRENT );
+    ssd1306_intf.send( level >> 4 );
+    ssd1306_intf.stop();
+}
+
 void ssd1331_setRotation(uint8_t rotation)
 {
+    ssd1306_lcdInvalidateState();
     uint8_t ram_mode;
     if ((rotation^s_rotation) & 0x01)
     {
@@ -200,7 +357,7 @@ static void    ssd1331_sendPixel16(uint16_t color)
 
 void    ssd1331_96x64_init()
 {
-    ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1331);
     ssd1306_lcd.height = 64;
     ssd1306_lcd.width = 96;
     ssd1306_lcd.set_block = set_block_compat;
@@ -209,17 +366,23 @@ void    ssd1331_96x64_init()
     ssd1306_lcd.send_pixels_buffer1 = send_pixels_buffer_compat;
 
     ssd1306_lcd.send_pixels8 = ssd1306_intf.send;
+    ssd1306_lcd.send_pixels_buffer8 = ssd1306_sendPixelsBuffer8;
+    ssd1306_lcd.fill_pixels8 = ssd1331_fillPixels8;
     ssd1306_lcd.send_pixels16 = ssd1331_sendPixel16_8;
+    ssd1306_lcd.send_pixels_buffer16 = NULL;
+    ssd1306_lcd.fill_pixels16 = NULL;
     ssd1306_lcd.set_mode = ssd1331_setMode;
-    for( uint8_t i=0; i<sizeof(s_oled96x64_initData); i++)
-    {
-        ssd1306_sendCommand(pgm_read_byte(&s_oled96x64_initData[i]));
-    }
+    ssd1306_lcd.set_rotation = ssd1331_setRotation;
+    ssd1306_lcd.draw_line = ssd1331_hwDrawLine;
+    ssd1306_lcd.draw_rect = ssd1331_hwDrawRect;
+    ssd1306_lcd.copy_block = ssd1331_hwCopyBlock;
+    ssd1306_lcd.set_brightness = ssd1331_setBrightness;
+    ssd1306_configureI2cDisplay(s_oled96x64_initData, sizeof(s_oled96x64_initData));
 }
 
 void    ssd1331_96x64_init16()
 {
-    ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1331);
     ssd1306_lcd.height = 64;
     ssd1306_lcd.width = 96;
     ssd1306_lcd.set_block = set_block_compat;
@@ -228,19 +391,25 @@ void    ssd1331_96x64_init16()
     ssd1306_lcd.send_pixels_buffer1 = send_pixels_buffer_compat16;
 
     ssd1306_lcd.send_pixels8 = ssd1331_sendPixel8_16;
+    ssd1306_lcd.send_pixels_buffer8 = ssd1306_sendPixelsBuffer8To16;
+    ssd1306_lcd.fill_pixels8 = ssd1306_fillPixels8To16;
     ssd1306_lcd.send_pixels16 = ssd1331_sendPixel16;
+    ssd1306_lcd.send_pixels_buffer16 = ssd1306_sendPixelsBuffer16;
+    ssd1306_lcd.fill_pixels16 = ssd1331_fillPixels16;
     ssd1306_lcd.set_mode = ssd1331_setMode;
-    for( uint8_t i=0; i<sizeof(s_oled96x64_initData16); i++)
-    {
-        ssd1306_sendCommand(pgm_read_byte(&s_oled96x64_initData16[i]));
-    }
+    ssd1306_lcd.set_rotation = ssd1331_setRotation;
+    ssd1306_lcd.draw_line = ssd1331_hwDrawLine;
+    ssd1306_lcd.draw_rect = ssd1331_hwDrawRect;
+    ssd1306_lcd.copy_block = ssd1331_hwCopyBlock;
+    ssd1306_lcd.set_brightness = ssd1331_setBrightness;
+    ssd1306_configureI2cDisplay(s_oled96x64_initData16, sizeof(s_oled96x64_initData16));
 }
 
 void   ssd1331_96x64_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        ssd1306_resetController( rstPin, 10 );
+        ssd1306_resetControllerFast( rstPin, 1 );
     }
     ssd1306_spiInit(cesPin, dcPin);
     ssd1331_96x64_init();
@@ -250,7 +419,7 @@ void   ssd1331_96x64_spi_init16(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        ssd1306_resetController( rstPin, 10 );
+        ssd1306_resetControllerFast( rstPin, 1 );
     }
     ssd1306_spiInit(cesPin, dcPin);
     ssd1331_96x64_init16();
@@ -35,7 +35,6 @@
 
 #define CMD_ARG     0xFF
 
-extern uint16_t ssd1306_color;
 extern uint32_t s_ssd1306_spi_clock;
 
 static const PROGMEM uint8_t s_oled128x128_initData[] =
@@ -65,50 +64,47 @@ static const PROGMEM uint8_t s_oled128x128_initData[] =
     SSD1351_EXTVSL, CMD_ARG, 0xA0, CMD_ARG, 0xB5, CMD_ARG, 0x55,
     SSD1351_PRECHARGESECOND, CMD_ARG, 0x01,  //
     SSD1351_SLEEP_OFF,                    // Disable power-safe mode
-    SSD1351_NORMALDISPLAY,
 };
 
 static uint8_t s_column;
 static uint8_t s_page;
+/* Bits 0-1 are rotation, bit 2 is set in ssd1306 compatible mode */
+static uint8_t s_rotation = 0x04;
 
 static void ssd1351_setBlock(lcduint_t x, lcduint_t y, lcduint_t w)
 {
     uint8_t rx = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
     s_column = x;
     s_page = y;
-    ssd1306_intf.start();
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(SSD1351_COLUMNADDR);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(x);
-    ssd1306_intf.send(rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1));
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(SSD1351_ROWADDR);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(y<<3);
-    ssd1306_intf.send(((y<<3) + 7) < ssd1306_lcd.height ? ((y<<3) + 7) : (ssd1306_lcd.height - 1));
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(SSD1331_WRITEDATA);
-    ssd1306_spiDataMode(1);
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    // Rotated screen by 90 degrees exchanges GDRAM columns and rows
+    ssd1306_batchCommand(&batch, (s_rotation & 1) ? SSD1351_ROWADDR : SSD1351_COLUMNADDR);
+    // According to datasheet all args must be passed in data mode
+    ssd1306_batchArg(&batch, x);
+    ssd1306_batchArg(&batch, rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1));
+    ssd1306_batchCommand(&batch, (s_rotation & 1) ? SSD1351_COLUMNADDR : SSD1351_ROWADDR);
+    ssd1306_batchArg(&batch, y<<3);
+    ssd1306_batchArg(&batch, ((y<<3) + 7) < ssd1306_lcd.height ? ((y<<3) + 7) : (ssd1306_lcd.height - 1));
+    ssd1306_batchCommand(&batch, SSD1331_WRITEDATA);
+    ssd1306_batchEnd(&batch, 1);
 }
 
 static void ssd1351_setBlock2(lcduint_t x, lcduint_t y, lcduint_t w)
 {
     uint8_t rx = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
-    ssd1306_intf.start();
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(SSD1351_COLUMNADDR);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(x);
-    ssd1306_intf.send(rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1));
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(SSD1351_ROWADDR);
-    ssd1306_spiDataMode(1);  // According to datasheet all args must be passed in data mode
-    ssd1306_intf.send(y);
-    ssd1306_intf.send(ssd1306_lcd.height - 1);
-    ssd1306_spiDataMode(0);
-    ssd1306_intf.send(SSD1331_WRITEDATA);
-    ssd1306_spiDataMode(1);
+    ssd1306_batch_t batch;
+    ssd1306_batchBegin(&batch);
+    // Rotated screen by 90 degrees exchanges GDRAM columns and rows
+    ssd1306_batchCommand(&batch, (s_rotation & 1) ? SSD1351_ROWADDR : SSD1351_COLUMNADDR);
+    // According to datasheet all args must be passed in data mode
+    ssd1306_batchArg(&batch, x);
+    ssd1306_batchArg(&batch, rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1));
+    ssd1306_batchCommand(&batch, (s_rotation & 1) ? SSD1351_COLUMNADDR : SSD1351_ROWADDR);
+    ssd1306_batchArg(&batch, y);
+    ssd1306_batchArg(&batch, ssd1306_lcd.height - 1);
+    ssd1306_batchCommand(&batch, SSD1331_WRITEDATA);
+    ssd1306_batchEnd(&batch, 1);
 }
 
 static void ssd1351_nextPage(void)
@@ -121,14 +117,24 @@ static void ssd1351_nextPage2(void)
 {
 }
 
-void    ssd1351_setMode(lcd_mode_t mode)
+static void ssd1351_sendRemap(void)
 {
+    /* Column remap and COM scan direction for 0, 90, 180 and 270 degrees */
+    static const uint8_t remap[4] = { 0B00110100, 0B00110110, 0B00100110, 0B00100100 };
     ssd1306_intf.start();
     ssd1306_spiDataMode(0);
     ssd1306_intf.send( SSD1351_SEGREMAP );
     ssd1306_spiDataMode(1);
-    ssd1306_intf.send( 0B00110100 | mode );
+    /* Vertical auto-increment for compatible mode, it is swapped for rotated screen */
+    ssd1306_intf.send( remap[s_rotation & 0x03] | (((s_rotation >> 2) ^ s_rotation) & 0x01) );
     ssd1306_intf.stop();
+}
+
+void    ssd1351_setMode(lcd_mode_t mode)
+{
+    ssd1306_lcdInvalidateState();
+    s_rotation = (s_rotation & 0x03) | (mode == LCD_MODE_SSD1306_COMPAT ? 0x04 : 0x00);
+    ssd1351_sendRemap();
     if (mode == LCD_MODE_SSD1306_COMPAT)
     {
         ssd1306_lcd.set_block = ssd1351_setBlock;
@@ -141,31 +147,39 @@ void    ssd1351_setMode(lcd_mode_t mode)
     }
 }
 
-static void ssd1351_sendPixels(uint8_t data)
+static void ssd1351_setStartLine(lcduint_t line)
 {
-    for (uint8_t i=8; i>0; i--)
-    {
-        if ( data & 0x01 )
-        {
-            ssd1306_intf.send( (uint8_t)(ssd1306_color>>8) );
-            ssd1306_intf.send( (uint8_t)(ssd1306_color) );
-        }
-        else
-        {
-            ssd1306_intf.send( 0B00000000 );
-            ssd1306_intf.send( 0B00000000 );
-        }
-        data >>= 1;
-    }
+    ssd1306_intf.start();
+    ssd1306_spiDataMode(0);
+    ssd1306_intf.send(SSD1351_SETSTARTLINE);
+    ssd1306_spiDataMode(1);
+    ssd1306_intf.send(line & 0x7F);
+    ssd1306_intf.stop();
 }
 
-static void ssd1351_sendPixelsBuffer(const uint8_t *buffer, uint16_t len)
+static void ssd1351_setBrightness(uint8_t level)
 {
-    while(len--)
+    ssd1306_intf.start();
+    ssd1306_spiDataMode(0);
+    ssd1306_intf.send(SSD1351_MASTERCURRENT);
+    ssd1306_spiDataMode(1);
+    ssd1306_intf.send(level >> 4);
+    ssd1306_intf.stop();
+}
+
+void ssd1351_setRotation(uint8_t rotation)
+{
+    ssd1306_lcdInvalidateState();
+    if ((rotation^s_rotation) & 0x01)
     {
-        ssd1351_sendPixels(*buffer);
-        buffer++;
+        lcduint_t t = ssd1306_lcd.width;
+        ssd1306_lcd.width = ssd1306_lcd.height;
+        ssd1306_lcd.height = t;
     }
+    s_rotation = (rotation & 0x03) | (s_rotation & 0x04);
+    ssd1351_sendRemap();
+    /* Start line scrolls GDRAM rows, which match screen rows only for not rotated screen */
+    ssd1306_lcd.set_start_line = (s_rotation & 0x03) ? NULL : ssd1351_setStartLine;
 }
 
 static void ssd1351_sendPixel8(uint8_t data)
@@ -183,41 +197,32 @@ static void ssd1351_sendPixel16(uint16_t color)
 
 void    ssd1351_128x128_init()
 {
-    ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1331);
     ssd1306_lcd.height = 128;
     ssd1306_lcd.width = 128;
     ssd1306_lcd.set_block = ssd1351_setBlock;
     ssd1306_lcd.next_page = ssd1351_nextPage;
-    ssd1306_lcd.send_pixels1  = ssd1351_sendPixels;
-    ssd1306_lcd.send_pixels_buffer1 = ssd1351_sendPixelsBuffer;
+    ssd1306_lcd.send_pixels1  = ssd1306_sendPixels1To16;
+    ssd1306_lcd.send_pixels_buffer1 = ssd1306_sendPixelsBuffer1To16;
     ssd1306_lcd.send_pixels8 = ssd1351_sendPixel8;
+    ssd1306_lcd.send_pixels_buffer8 = ssd1306_sendPixelsBuffer8To16;
+    ssd1306_lcd.fill_pixels8 = ssd1306_fillPixels8To16;
     ssd1306_lcd.send_pixels16 = ssd1351_sendPixel16;
+    ssd1306_lcd.send_pixels_buffer16 = ssd1306_sendPixelsBuffer16;
+    ssd1306_lcd.fill_pixels16 = ssd1306_fillPixels16;
     ssd1306_lcd.set_mode = ssd1351_setMode;
-    ssd1306_intf.start();
-    ssd1306_spiDataMode(0);
-    for( uint8_t i=0; i<sizeof(s_oled128x128_initData); i++)
-    {
-        uint8_t data = pgm_read_byte(&s_oled128x128_initData[i]);
-        if (data == CMD_ARG)
-        {
-            data = pgm_read_byte(&s_oled128x128_initData[++i]);
-            ssd1306_spiDataMode(1);
-            ssd1306_intf.send(data);
-            ssd1306_spiDataMode(0);
-        }
-        else
-        {
-            ssd1306_intf.send(data);
-        }
-    }
-    ssd1306_intf.stop();
+    ssd1306_lcd.set_start_line = ssd1351_setStartLine;
+    ssd1306_lcd.set_rotation = ssd1351_setRotation;
+    ssd1306_lcd.set_brightness = ssd1351_setBrightness;
+    s_rotation = 0x04;
+    ssd1306_configureSpiDisplay(s_oled128x128_initData, sizeof(s_oled128x128_initData));
 }
 
 void   ssd1351_128x128_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        ssd1306_resetController( rstPin, 20 );
+        ssd1306_resetControllerFast( rstPin, 1 );
     }
     /* ssd1351 cannot work faster than at 4MHz per datasheet */
     s_ssd1306_spi_clock = 4400000;
@@ -56,6 +56,15 @@ extern "C" {
  */
 void        ssd1351_setMode(lcd_mode_t mode);
 
+/**
+ * @brief Sets screen orientation (rotation)
+ *
+ * Sets screen orientation (rotation): 0 - normal, 1 - 90 CW, 2 - 180 CW, 3 - 270 CW.
+ * Rotation is done by controller remap register, so it costs nothing per pixel.
+ * @param rotation - screen rotation 0 - normal, 1 - 90 CW, 2 - 180 CW, 3 - 270 CW
+ */
+void        ssd1351_setRotation(uint8_t rotation);
+
 /**
  * @brief Inits 128x128 RGB OLED display (based on SSD1351 controller).
  *
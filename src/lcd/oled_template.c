@@ -123,6 +123,7 @@ static void template_nextPage(void)
 
 void    template_setMode(lcd_mode_t mode)
 {
+    ssd1306_lcdInvalidateState();
     if (mode == LCD_MODE_NORMAL)
     {
         ssd1306_lcd.set_block = template_setBlock;
@@ -143,7 +144,7 @@ void    template_setMode(lcd_mode_t mode)
 
 void    template_WxH_init()
 {
-    ssd1306_lcd.type = LCD_TYPE_CUSTOM;
+    ssd1306_lcdInitTable(LCD_TYPE_CUSTOM);
     ssd1306_lcd.width = 96;  // specify width
     ssd1306_lcd.height = 64; // specify height
     // Set functions for compatible mode
@@ -153,6 +154,8 @@ void    template_WxH_init()
     ssd1306_lcd.send_pixels_buffer1 = template_sendPixelsBuffer;
     // Set function for 8-bit mode
     ssd1306_lcd.send_pixels8 = ssd1306_intf.send;
+    ssd1306_lcd.send_pixels_buffer8 = ssd1306_sendPixelsBuffer8;
+    ssd1306_lcd.fill_pixels8 = ssd1306_fillPixels8;
     ssd1306_lcd.set_mode = template_setMode;
     // Use one of 2 functions for initialization below
     // Please, read help on this functions and read datasheet before you decide, which
@@ -166,7 +169,8 @@ void   template_WxH_spi_init(int8_t rstPin, int8_t cesPin, int8_t dcPin)
 {
     if (rstPin >=0)
     {
-        ssd1306_resetController( rstPin, 10 );
+        // Take time, required by controller after reset, from datasheet
+        ssd1306_resetControllerFast( rstPin, 1 );
     }
     ssd1306_spiInit(cesPin, dcPin);
     template_WxH_init();
@@ -41,11 +41,18 @@ enum ESsd1306Commands
     SSD1306_MEMORYMODE       = 0x20,
     SSD1306_COLUMNADDR       = 0x21,
     SSD1306_PAGEADDR         = 0x22,
+    SSD1306_RIGHT_HORIZONTAL_SCROLL = 0x26,
+    SSD1306_LEFT_HORIZONTAL_SCROLL  = 0x27,
+    SSD1306_VERTICAL_AND_RIGHT_HORIZONTAL_SCROLL = 0x29,
+    SSD1306_VERTICAL_AND_LEFT_HORIZONTAL_SCROLL  = 0x2A,
+    SSD1306_DEACTIVATE_SCROLL = 0x2E,
+    SSD1306_ACTIVATE_SCROLL  = 0x2F,
     SSD1306_SETSTARTLINE     = 0x40,
     SSD1306_DEFAULT_ADDRESS  = 0x78,
     SSD1306_SETCONTRAST      = 0x81,
     SSD1306_CHARGEPUMP       = 0x8D,
     SSD1306_SEGREMAP         = 0xA0,
+    SSD1306_SET_VERTICAL_SCROLL_AREA = 0xA3,
     SSD1306_DISPLAYALLON_RESUME = 0xA4,
     SSD1306_DISPLAYALLON     = 0xA5,
     SSD1306_NORMALDISPLAY    = 0xA6,
@@ -58,9 +58,67 @@ enum EVgaCommands
      */
     VGA_SET_MODE        = 0x02,
 
+    /**
+     * VGA_SET_RESOLUTION command sets size of VGA ram. The command needs 4 byte-arguments:
+     *    low byte of width in pixels,
+     *    high byte of width in pixels,
+     *    height in pixels,
+     *    bits per pixel: 1 - monochrome, 4 - 4-bit grayscale.
+     * In grayscale mode RGB8 pixels are accepted and converted to gray levels.
+     */
     VGA_SET_RESOLUTION  = 0x03,
 
+    /**
+     * VGA_DISPLAY_ON command allocates VGA ram and starts video output.
+     * The command has no arguments.
+     */
     VGA_DISPLAY_ON      = 0x04,
+
+    /*
+     * Drawing commands below are self-delimited, so any number of them can follow
+     * single 0x00 command byte in one frame (batch). All coordinates are in pixels,
+     * colors are RGB8 for color modes and zero/non-zero for monochrome mode.
+     * Drawing commands do not change block, set by VGA_SET_BLOCK.
+     */
+
+    /**
+     * VGA_FILL_RECT command fills rectangle with color. The command needs 5 byte-arguments:
+     *    left, top, right, bottom boundaries in pixels (inclusive),
+     *    color.
+     */
+    VGA_FILL_RECT       = 0x05,
+
+    /**
+     * VGA_DRAW_HLINE command draws horizontal line. The command needs 4 byte-arguments:
+     *    left boundary, top position, right boundary in pixels (inclusive),
+     *    color.
+     */
+    VGA_DRAW_HLINE      = 0x06,
+
+    /**
+     * VGA_TEXT command prints text run, using fixed font, currently set on VGA controller.
+     * The command needs 4 byte-arguments, followed by text bytes:
+     *    left, top position in pixels,
+     *    color,
+     *    number of text bytes (utf-8 encoded) to follow.
+     */
+    VGA_TEXT            = 0x07,
+
+    /**
+     * VGA_PIXELS_RLE command sends same data byte several times to the block,
+     * set by VGA_SET_BLOCK, like in data mode (0x40). The command needs 2 byte-arguments:
+     *    number of repeats,
+     *    data byte.
+     */
+    VGA_PIXELS_RLE      = 0x08,
+
+    /**
+     * VGA_PIXELS command sends data bytes to the block, set by VGA_SET_BLOCK,
+     * like in data mode (0x40), but can be followed by other commands in the same frame.
+     * The command needs 1 byte-argument, followed by data bytes:
+     *    number of data bytes to follow.
+     */
+    VGA_PIXELS          = 0x09,
 };
 
 #ifdef __cplusplus
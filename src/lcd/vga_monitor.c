@@ -120,7 +120,7 @@ static void vga_set_mode(lcd_mode_t mode)
 
 void vga_96x40_8colors_init(void)
 {
-    ssd1306_lcd.type = LCD_TYPE_SSD1331;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1331);
     ssd1306_lcd.width = 96;
     ssd1306_lcd.height = 40;
     ssd1306_lcd.set_block = vga_set_block1;
@@ -128,12 +128,14 @@ void vga_96x40_8colors_init(void)
     ssd1306_lcd.send_pixels1  = vga_send_pixels;
     ssd1306_lcd.send_pixels_buffer1 = vga_send_pixels_buffer;
     ssd1306_lcd.send_pixels8 = ssd1306_intf.send;
+    ssd1306_lcd.send_pixels_buffer8 = ssd1306_sendPixelsBuffer8;
+    ssd1306_lcd.fill_pixels8 = ssd1306_fillPixels8;
     ssd1306_lcd.set_mode = vga_set_mode;
 }
 
 void vga_128x64_mono_init(void)
 {
-    ssd1306_lcd.type = LCD_TYPE_SSD1306;
+    ssd1306_lcdInitTable(LCD_TYPE_SSD1306);
     ssd1306_lcd.width = 128;
     ssd1306_lcd.height = 64;
     ssd1306_lcd.set_block = vga_set_block2;
@@ -143,3 +145,94 @@ void vga_128x64_mono_init(void)
     ssd1306_lcd.set_mode = vga_set_mode;
 }
 
+
+void ssd1306_vgaBatchBegin(void)
+{
+    ssd1306_intf.start();
+    ssd1306_intf.send(0x00);
+}
+
+void ssd1306_vgaBatchEnd(void)
+{
+    ssd1306_intf.stop();
+}
+
+void ssd1306_vgaBatchSetBlock(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+{
+    ssd1306_intf.send(VGA_SET_BLOCK);
+    ssd1306_intf.send(x1);
+    ssd1306_intf.send(x2);
+    ssd1306_intf.send(y1);
+    ssd1306_intf.send(y2);
+}
+
+void ssd1306_vgaBatchFillRect(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color)
+{
+    ssd1306_intf.send(VGA_FILL_RECT);
+    ssd1306_intf.send(x1);
+    ssd1306_intf.send(y1);
+    ssd1306_intf.send(x2);
+    ssd1306_intf.send(y2);
+    ssd1306_intf.send(color);
+}
+
+void ssd1306_vgaBatchDrawHLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t color)
+{
+    ssd1306_intf.send(VGA_DRAW_HLINE);
+    ssd1306_intf.send(x1);
+    ssd1306_intf.send(y1);
+    ssd1306_intf.send(x2);
+    ssd1306_intf.send(color);
+}
+
+void ssd1306_vgaBatchPrint(uint8_t x, uint8_t y, uint8_t color, const char *text)
+{
+    uint8_t len = 0;
+    while (text[len] && len < 255)
+    {
+        len++;
+    }
+    ssd1306_intf.send(VGA_TEXT);
+    ssd1306_intf.send(x);
+    ssd1306_intf.send(y);
+    ssd1306_intf.send(color);
+    ssd1306_intf.send(len);
+    ssd1306_intf.send_buffer((const uint8_t *)text, len);
+}
+
+void ssd1306_vgaBatchPixels(const uint8_t *buffer, uint16_t len)
+{
+    while (len)
+    {
+        uint8_t count = 1;
+        while ((count < len) && (count < 255) && (buffer[count] == buffer[0]))
+        {
+            count++;
+        }
+        if (count >= 3)
+        {
+            ssd1306_intf.send(VGA_PIXELS_RLE);
+            ssd1306_intf.send(count);
+            ssd1306_intf.send(buffer[0]);
+        }
+        else
+        {
+            /* Collect literal bytes until next run of 3 equal bytes */
+            count = 0;
+            while ((count < len) && (count < 255))
+            {
+                if ((count + 2 < len) && (buffer[count] == buffer[count + 1]) &&
+                    (buffer[count] == buffer[count + 2]))
+                {
+                    break;
+                }
+                count++;
+            }
+            ssd1306_intf.send(VGA_PIXELS);
+            ssd1306_intf.send(count);
+            ssd1306_intf.send_buffer(buffer, count);
+        }
+        buffer += count;
+        len -= count;
+    }
+}
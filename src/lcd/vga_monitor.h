@@ -63,6 +63,116 @@ void vga_96x40_8colors_init(void);
  */
 void vga_128x64_mono_init(void);
 
+/** GPIO pins of VGA connector, -1 for unused pin */
+typedef struct
+{
+    int8_t red[3];    ///< red channel pins, most significant bit first
+    int8_t green[3];  ///< green channel pins, most significant bit first
+    int8_t blue[2];   ///< blue channel pins, most significant bit first
+    int8_t hsync;     ///< H-Sync pin
+    int8_t vsync;     ///< V-Sync pin
+} SVgaPins;
+
+#if defined(ESP32)
+/**
+ * @brief Inits 320x240 8-color VGA display on ESP32.
+ *
+ * Inits 320x240 VGA display (640x480 monitor mode), driven directly by ESP32
+ * I2S1 peripheral in parallel mode. This mode supports 8 colors, so only first
+ * pin of each color channel is used. RGB8 colors are accepted, and the most
+ * significant bit of each component is shown. Frame buffer takes 75 KiB of
+ * DMA capable memory, and the picture is refreshed by DMA without CPU.
+ * Drawing functions change frame buffer directly, so no interface
+ * initialization is needed.
+ *
+ * @param pins GPIO pins of VGA connector
+ */
+void vga_320x240_8colors_init(const SVgaPins *pins);
+
+/**
+ * @brief Inits 320x240 RGB8 VGA display on ESP32.
+ *
+ * Works as vga_320x240_8colors_init(), but shows 256 colors via resistor DAC
+ * on 3+3+2 color pins. Frame buffer takes 150 KiB of DMA capable memory.
+ *
+ * @param pins GPIO pins of VGA connector
+ */
+void vga_320x240_rgb8_init(const SVgaPins *pins);
+#endif
+
+/**
+ * @brief Starts batch of VGA drawing commands.
+ *
+ * Starts single frame of VGA drawing commands. All ssd1306_vgaBatch*() functions
+ * must be called between ssd1306_vgaBatchBegin() and ssd1306_vgaBatchEnd(), and
+ * no other drawing functions are allowed until batch is finished.
+ * This allows to describe screen content to VGA controller with much smaller number
+ * of bytes than raw pixels, and without stop/start pair for each block.
+ *
+ * @see VGA_FILL_RECT
+ */
+void ssd1306_vgaBatchBegin(void);
+
+/**
+ * @brief Finishes batch of VGA drawing commands.
+ */
+void ssd1306_vgaBatchEnd(void);
+
+/**
+ * @brief Sets block for ssd1306_vgaBatchPixels().
+ *
+ * @param x1 left boundary in pixels
+ * @param y1 top boundary: in pixels for color mode, in pages for monochrome mode
+ * @param x2 right boundary in pixels (inclusive)
+ * @param y2 bottom boundary (not implemented by VGA controllers yet)
+ */
+void ssd1306_vgaBatchSetBlock(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+
+/**
+ * @brief Fills rectangle on VGA display.
+ *
+ * @param x1 left boundary in pixels
+ * @param y1 top boundary in pixels
+ * @param x2 right boundary in pixels (inclusive)
+ * @param y2 bottom boundary in pixels (inclusive)
+ * @param color RGB8 color for color mode, zero or non-zero for monochrome mode
+ */
+void ssd1306_vgaBatchFillRect(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color);
+
+/**
+ * @brief Draws horizontal line on VGA display.
+ *
+ * @param x1 left boundary in pixels
+ * @param y1 vertical position in pixels
+ * @param x2 right boundary in pixels (inclusive)
+ * @param color RGB8 color for color mode, zero or non-zero for monochrome mode
+ */
+void ssd1306_vgaBatchDrawHLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t color);
+
+/**
+ * @brief Prints text on VGA display.
+ *
+ * Prints text, using fixed font, set on VGA controller side. Only first 255 bytes
+ * of text are sent.
+ *
+ * @param x left position in pixels
+ * @param y top position in pixels
+ * @param color RGB8 color for color mode, zero or non-zero for monochrome mode
+ * @param text utf-8 string, located in RAM
+ */
+void ssd1306_vgaBatchPrint(uint8_t x, uint8_t y, uint8_t color, const char *text);
+
+/**
+ * @brief Sends pixels to the block, set by ssd1306_vgaBatchSetBlock().
+ *
+ * Sends pixels in the same format as lcd data mode. Runs of 3 and more equal
+ * bytes are sent as VGA_PIXELS_RLE commands.
+ *
+ * @param buffer pixels data, located in RAM
+ * @param len number of bytes to send
+ */
+void ssd1306_vgaBatchPixels(const uint8_t *buffer, uint16_t len);
+
 /**
  * @}
  */
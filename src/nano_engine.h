@@ -30,10 +30,20 @@
 #define _NANO_ENGINE_H_
 
 #include "nano_engine/sprite.h"
+#include "nano_engine/tilemap.h"
+#include "nano_engine/fixed.h"
 #include "nano_engine/canvas.h"
+#include "nano_engine/display_list.h"
 #include "nano_engine/adafruit.h"
 #include "nano_engine/tiler.h"
 #include "nano_engine/core.h"
+#include "nano_engine/strip.h"
+#include "nano_engine/pipeline.h"
+#include "nano_engine/widgets.h"
+#include "nano_engine/collision_grid.h"
+#include "nano_engine/pool.h"
+#include "nano_engine/particles.h"
+#include "nano_engine/tile_tuner.h"
 
 // DO NOT DECLARE NanoEngine8, NanoEngine16, NanoEngine1 as class NAME: public NanoEngine<T>
 // This causes flash and RAM memory consumption in compiled ELF
@@ -102,6 +102,74 @@ public:
      */
     void drawPixel(int16_t x, int16_t y, uint16_t color) override;
 
+    /**
+     * Draws horizontal line directly in canvas buffer
+     *
+     * @param x x position of left point
+     * @param y y position
+     * @param w width of the line in pixels
+     * @param color color of pixels
+     */
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override
+    {
+        fillRect(x, y, w, 1, color);
+    }
+
+    /**
+     * Draws vertical line directly in canvas buffer
+     *
+     * @param x x position
+     * @param y y position of top point
+     * @param h height of the line in pixels
+     * @param color color of pixels
+     */
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override
+    {
+        fillRect(x, y, 1, h, color);
+    }
+
+    /**
+     * Fills rectangle directly in canvas buffer. Clipping and rotation are
+     * applied once for whole rectangle.
+     *
+     * @param x x position of left-top corner
+     * @param y y position of left-top corner
+     * @param w width of rectangle in pixels
+     * @param h height of rectangle in pixels
+     * @param color color of pixels
+     */
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    // Adafruit GFX drawBitmap() methods are not virtual, so they are hidden here
+    // to draw monochrome bitmaps without per-pixel virtual calls.
+    using Adafruit_GFX::drawBitmap;
+
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                    int16_t w, int16_t h, uint16_t color)
+    {
+        drawMonoBitmap(x, y, bitmap, w, h, color, 0, false, true);
+    }
+
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                    int16_t w, int16_t h, uint16_t color, uint16_t bg)
+    {
+        drawMonoBitmap(x, y, bitmap, w, h, color, bg, true, true);
+    }
+
+    void drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
+                    int16_t w, int16_t h, uint16_t color)
+    {
+        drawMonoBitmap(x, y, bitmap, w, h, color, 0, false, false);
+    }
+
+    void drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
+                    int16_t w, int16_t h, uint16_t color, uint16_t bg)
+    {
+        drawMonoBitmap(x, y, bitmap, w, h, color, bg, true, false);
+    }
+#endif
+
     /**
      * Sets offset
      * @param ox - X offset in pixels
@@ -142,8 +210,126 @@ private:
         }
 
     }
+
+    inline void rotateRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h)
+    {
+        int16_t t;
+        switch (getRotation()) {
+        case 1:
+            t = x;
+            x = WIDTH - y - h;
+            y = t;
+            ssd1306_swap_data(w, h, int16_t);
+            break;
+        case 2:
+            x = WIDTH - x - w;
+            y = HEIGHT - y - h;
+            break;
+        case 3:
+            t = y;
+            y = HEIGHT - x - w;
+            x = t;
+            ssd1306_swap_data(w, h, int16_t);
+            break;
+        }
+    }
+
+    /** Puts pixel to buffer, x and y are buffer coordinates, already checked */
+    inline void putRawPixel(int16_t x, int16_t y, uint16_t color);
+
+    /** Fills block in buffer coordinates, already clipped */
+    inline void fillRawBlock(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+    void drawMonoBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h,
+                        uint16_t color, uint16_t bg, bool opaque, bool progmem);
 };
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <uint8_t BPP>
+void AdafruitCanvasOps<BPP>::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    x -= offset.x;
+    y -= offset.y;
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+    {
+        return;
+    }
+    rotatePosition(x, y);
+    putRawPixel(x, y, color);
+}
+
+template <uint8_t BPP>
+void AdafruitCanvasOps<BPP>::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    x -= offset.x;
+    y -= offset.y;
+    if (w < 0) { x += w + 1; w = -w; }
+    if (h < 0) { y += h + 1; h = -h; }
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > width()) w = width() - x;
+    if (y + h > height()) h = height() - y;
+    if ((w <= 0) || (h <= 0))
+    {
+        return;
+    }
+    rotateRect(x, y, w, h);
+    fillRawBlock(x, y, w, h, color);
+}
+
+template <uint8_t BPP>
+void AdafruitCanvasOps<BPP>::drawMonoBitmap(int16_t x, int16_t y, const uint8_t *bitmap,
+                                            int16_t w, int16_t h, uint16_t color,
+                                            uint16_t bg, bool opaque, bool progmem)
+{
+    x -= offset.x;
+    y -= offset.y;
+    int16_t byteWidth = (w + 7) >> 3;
+    int16_t i0 = x < 0 ? -x : 0;
+    int16_t j0 = y < 0 ? -y : 0;
+    int16_t i1 = x + w > width() ? width() - x : w;
+    int16_t j1 = y + h > height() ? height() - y : h;
+    if ((i0 >= i1) || (j0 >= j1))
+    {
+        return;
+    }
+    // Buffer position of the first visible pixel and buffer steps
+    // for the next bitmap column (dx*) and the next bitmap row (dy*)
+    int16_t px = x + i0;
+    int16_t py = y + j0;
+    int16_t dxx = 1, dxy = 0, dyx = 0, dyy = 1;
+    rotatePosition(px, py);
+    switch (getRotation()) {
+    case 1: dxx = 0; dxy = 1; dyx = -1; dyy = 0; break;
+    case 2: dxx = -1; dyy = -1; break;
+    case 3: dxx = 0; dxy = -1; dyx = 1; dyy = 0; break;
+    }
+    bitmap += j0 * byteWidth;
+    for (int16_t j = j0; j < j1; j++)
+    {
+        int16_t rx = px;
+        int16_t ry = py;
+        for (int16_t i = i0; i < i1; i++)
+        {
+            uint8_t data = progmem ? pgm_read_byte(&bitmap[i >> 3]) : bitmap[i >> 3];
+            if (data & (0x80 >> (i & 7)))
+            {
+                putRawPixel(rx, ry, color);
+            }
+            else if (opaque)
+            {
+                putRawPixel(rx, ry, bg);
+            }
+            rx += dxx;
+            ry += dxy;
+        }
+        bitmap += byteWidth;
+        px += dyx;
+        py += dyy;
+    }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /**
  * Base class for all AdafruitCanvas childs
  */
@@ -203,16 +389,8 @@ public:
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 template <>
-void AdafruitCanvasOps<1>::drawPixel(int16_t x, int16_t y, uint16_t color)
+inline void AdafruitCanvasOps<1>::putRawPixel(int16_t x, int16_t y, uint16_t color)
 {
-    x -= offset.x;
-    y -= offset.y;
-    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
-    {
-        return;
-    }
-    rotatePosition(x, y);
-
     switch (color)
     {
         case 1:   m_buffer[x+ (y/8)*WIDTH] |=  (1 << (y&7)); break;
@@ -220,6 +398,26 @@ void AdafruitCanvasOps<1>::drawPixel(int16_t x, int16_t y, uint16_t color)
         case 2:   m_buffer[x+ (y/8)*WIDTH] ^=  (1 << (y&7)); break;
     }
 }
+
+template <>
+inline void AdafruitCanvasOps<1>::fillRawBlock(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    int16_t y2 = y + h - 1;
+    for (int16_t page = y >> 3; page <= (y2 >> 3); page++)
+    {
+        uint8_t mask = 0xFF;
+        if (page == (y >> 3)) mask &= 0xFF << (y & 7);
+        if (page == (y2 >> 3)) mask &= 0xFF >> (7 - (y2 & 7));
+        uint8_t *p = &m_buffer[x + page * WIDTH];
+        int16_t n = w;
+        switch (color)
+        {
+            case 1:   while (n--) *p++ |= mask; break;
+            case 0:   while (n--) *p++ &= ~mask; break;
+            case 2:   while (n--) *p++ ^= mask; break;
+        }
+    }
+}
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -259,17 +457,20 @@ public:
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 template <>
-void AdafruitCanvasOps<8>::drawPixel(int16_t x, int16_t y, uint16_t color)
+inline void AdafruitCanvasOps<8>::putRawPixel(int16_t x, int16_t y, uint16_t color)
 {
-    x -= offset.x;
-    y -= offset.y;
-    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+    m_buffer[x+y*WIDTH] = color;
+}
+
+template <>
+inline void AdafruitCanvasOps<8>::fillRawBlock(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    uint8_t *p = &m_buffer[x + y * WIDTH];
+    while (h--)
     {
-        return;
+        memset(p, color, w);
+        p += WIDTH;
     }
-    rotatePosition(x, y);
-
-    m_buffer[x+y*WIDTH] = color;
 }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
@@ -311,18 +512,29 @@ public:
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 template <>
-void AdafruitCanvasOps<16>::drawPixel(int16_t x, int16_t y, uint16_t color)
+inline void AdafruitCanvasOps<16>::putRawPixel(int16_t x, int16_t y, uint16_t color)
 {
-    x -= offset.x;
-    y -= offset.y;
-    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+    // High byte goes first, the same as NanoCanvas16 and ssd1306_drawBufferFast16() expect
+    m_buffer[(x+y*WIDTH) * 2 + 0] = color >> 8;
+    m_buffer[(x+y*WIDTH) * 2 + 1] = color;
+}
+
+template <>
+inline void AdafruitCanvasOps<16>::fillRawBlock(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    uint8_t hi = color >> 8;
+    uint8_t lo = color;
+    uint8_t *row = &m_buffer[(x + y * WIDTH) * 2];
+    while (h--)
     {
-        return;
+        uint8_t *p = row;
+        for (int16_t n = w; n > 0; n--)
+        {
+            *p++ = hi;
+            *p++ = lo;
+        }
+        row += WIDTH * 2;
     }
-    rotatePosition(x, y);
-
-    m_buffer[(x+y*WIDTH) * 2 + 0] = color;
-    m_buffer[(x+y*WIDTH) * 2 + 1] = color >> 8;
 }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
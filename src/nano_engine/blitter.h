@@ -0,0 +1,253 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file blitter.h Specialized canvas to display blitters
+ */
+
+#ifndef _NANO_ENGINE_BLITTER_H_
+#define _NANO_ENGINE_BLITTER_H_
+
+#include "ssd1306_hal/io.h"
+#include "nano_gfx_types.h"
+#include "lcd/lcd_common.h"
+#include "intf/ssd1306_interface.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+extern "C" uint16_t ssd1306_color;
+extern "C" uint8_t s_ssd1306_invertByte;
+
+#ifndef NANO_BLT_BURST_PIXELS
+#if defined(CONFIG_LARGE_RAM_AVAILABLE)
+/** Number of pixels, prepared on the stack per send_buffer() call */
+#define NANO_BLT_BURST_PIXELS  64
+#else
+/** Number of pixels, prepared on the stack per send_buffer() call */
+#define NANO_BLT_BURST_PIXELS  16
+#endif
+#endif
+
+/** Pixel formats, sent by the display controller over the bus */
+enum
+{
+    NANO_WIRE_GENERIC = 0,  ///< Unknown format, pixels are sent via ssd1306_lcd callbacks
+    NANO_WIRE_RGB8    = 1,  ///< One byte per pixel, sent as is
+    NANO_WIRE_RGB16   = 2,  ///< Two bytes per pixel, RGB565 MSB first
+};
+
+/**
+ * Detects wire format of the active display by the pixel functions its driver installed.
+ * Controllers with own pixel functions are reported as NANO_WIRE_GENERIC.
+ */
+static inline uint8_t nanoWireFormat()
+{
+    if (ssd1306_lcd.send_pixels_buffer16 == ssd1306_sendPixelsBuffer16)
+    {
+        return NANO_WIRE_RGB16;
+    }
+    if (ssd1306_lcd.send_pixels_buffer8 == ssd1306_sendPixelsBuffer8 &&
+        ssd1306_lcd.send_pixels8 == ssd1306_intf.send)
+    {
+        return NANO_WIRE_RGB8;
+    }
+    return NANO_WIRE_GENERIC;
+}
+
+/** Source format: 1-bit canvas, drawn with 8-bit RGB color */
+struct NanoBltMono8
+{
+    /** Converts canvas color to RGB8 */
+    static inline uint8_t toRgb8(uint16_t color) { return color; }
+    /** Converts canvas color to RGB16 */
+    static inline uint16_t toRgb16(uint16_t color) { return RGB8_TO_RGB16(color); }
+    /** Sends single pixel via display driver */
+    static inline void sendPixel(uint16_t color) { ssd1306_lcd.send_pixels8(color); }
+};
+
+/** Source format: 1-bit canvas, drawn with 16-bit RGB color */
+struct NanoBltMono16
+{
+    /** Converts canvas color to RGB8 */
+    static inline uint8_t toRgb8(uint16_t color) { return RGB16_TO_RGB8(color); }
+    /** Converts canvas color to RGB16 */
+    static inline uint16_t toRgb16(uint16_t color) { return color; }
+    /** Sends single pixel via display driver */
+    static inline void sendPixel(uint16_t color) { ssd1306_lcd.send_pixels16(color); }
+};
+
+/** Wire format policy for NANO_WIRE_RGB8 */
+struct NanoWireRgb8
+{
+    /** Number of bytes per pixel on the wire */
+    static const uint8_t BYTES = 1;
+    /** Stores canvas color of source format S as wire pixel */
+    template <class S>
+    static inline void pack(uint8_t *pixel, uint16_t color) { pixel[0] = S::toRgb8(color); }
+    /** Copies prepared wire pixel */
+    static inline void put(uint8_t *dst, const uint8_t *pixel) { dst[0] = pixel[0]; }
+};
+
+/** Wire format policy for NANO_WIRE_RGB16 */
+struct NanoWireRgb16
+{
+    /** Number of bytes per pixel on the wire */
+    static const uint8_t BYTES = 2;
+    /** Stores canvas color of source format S as wire pixel */
+    template <class S>
+    static inline void pack(uint8_t *pixel, uint16_t color)
+    {
+        uint16_t rgb16 = S::toRgb16(color);
+        pixel[0] = rgb16 >> 8;
+        pixel[1] = rgb16 & 0xFF;
+    }
+    /** Copies prepared wire pixel */
+    static inline void put(uint8_t *dst, const uint8_t *pixel) { dst[0] = pixel[0]; dst[1] = pixel[1]; }
+};
+
+/**
+ * Bus policy: sends via interface, selected at compile time if CONFIG_SSD1306_STATIC_AVR_SPI
+ * is defined, or via currently initialized interface otherwise.
+ */
+struct NanoBusIntf
+{
+    /** Sends prepared pixels */
+    static inline void send(const uint8_t *buffer, uint16_t size) { ssd1306_intfSendBuffer(buffer, size); }
+    /** Completes transfer */
+    static inline void stop() { ssd1306_intf.stop(); }
+};
+
+/**
+ * Blitter for 1-bit canvas buffers, organized in 8-pixel vertical pages.
+ * Each combination of source format S, wire format WIRE and bus BUS compiles to
+ * own loop: foreground and background pixels are prepared in wire format once per
+ * blit, and each row is sent in NANO_BLT_BURST_PIXELS bursts without calling driver
+ * callbacks for every pixel.
+ */
+template <class S, class WIRE, class BUS = NanoBusIntf>
+class NanoMonoBlitter
+{
+public:
+    /**
+     * Sends w x h area of 1-bit buffer to display.
+     *
+     * @param x position on the display
+     * @param y position on the display
+     * @param w width of the area in pixels
+     * @param h height of the area in pixels
+     * @param pitch width of the buffer in pixels
+     * @param bitmap pointer to the first column of the area in page 0 of the buffer
+     * @param row buffer row, corresponding to top of the area
+     */
+    static void blt(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch,
+                    const uint8_t *bitmap, lcduint_t row)
+    {
+        uint8_t colors[WIRE::BYTES * 2];
+        WIRE::template pack<S>(&colors[0], s_ssd1306_invertByte ? ssd1306_color : 0x0000);
+        WIRE::template pack<S>(&colors[WIRE::BYTES], s_ssd1306_invertByte ? 0x0000 : ssd1306_color);
+        uint8_t burst[NANO_BLT_BURST_PIXELS * WIRE::BYTES];
+        ssd1306_lcd.set_block(x, y, w);
+        for (; h > 0; h--, row++)
+        {
+            const uint8_t *src = bitmap + (row >> 3) * pitch;
+            uint8_t bit = 1 << (row & 0x07);
+            lcduint_t count = w;
+            while (count)
+            {
+                uint8_t n = count < NANO_BLT_BURST_PIXELS ? count : NANO_BLT_BURST_PIXELS;
+                uint8_t *dst = burst;
+                for (uint8_t i = n; i > 0; i--)
+                {
+                    WIRE::put(dst, &colors[(*src & bit) ? WIRE::BYTES : 0]);
+                    dst += WIRE::BYTES;
+                    src++;
+                }
+                BUS::send(burst, (uint16_t)n * WIRE::BYTES);
+                count -= n;
+            }
+        }
+        BUS::stop();
+    }
+};
+
+/**
+ * Generic blitter for 1-bit canvas buffers, which sends pixels one by one via
+ * ssd1306_lcd callbacks. Used for controllers with unknown wire format.
+ */
+template <class S>
+class NanoMonoBlitter<S, void, void>
+{
+public:
+    /** @copydoc NanoMonoBlitter::blt */
+    static void blt(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch,
+                    const uint8_t *bitmap, lcduint_t row)
+    {
+        uint16_t blackColor = s_ssd1306_invertByte ? ssd1306_color : 0x0000;
+        uint16_t color = s_ssd1306_invertByte ? 0x0000 : ssd1306_color;
+        ssd1306_lcd.set_block(x, y, w);
+        for (; h > 0; h--, row++)
+        {
+            const uint8_t *src = bitmap + (row >> 3) * pitch;
+            uint8_t bit = 1 << (row & 0x07);
+            for (lcduint_t i = w; i > 0; i--)
+            {
+                S::sendPixel((*src & bit) ? color : blackColor);
+                src++;
+            }
+        }
+        ssd1306_intf.stop();
+    }
+};
+
+/**
+ * Sends area of 1-bit canvas buffer to display, using blitter specialized for
+ * source format S and wire format of the active display. Wire format is checked
+ * once per call, all per-pixel work is done by the selected instantiation.
+ * Parameters are the same as for NanoMonoBlitter::blt().
+ */
+template <class S>
+void nanoBltMono(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch,
+                 const uint8_t *bitmap, lcduint_t row = 0)
+{
+    switch (nanoWireFormat())
+    {
+        case NANO_WIRE_RGB8:
+            NanoMonoBlitter<S, NanoWireRgb8>::blt(x, y, w, h, pitch, bitmap, row);
+            break;
+        case NANO_WIRE_RGB16:
+            NanoMonoBlitter<S, NanoWireRgb16>::blt(x, y, w, h, pitch, bitmap, row);
+            break;
+        default:
+            NanoMonoBlitter<S, void, void>::blt(x, y, w, h, pitch, bitmap, row);
+            break;
+    }
+}
+
+/**
+ * @}
+ */
+
+#endif
@@ -23,7 +23,9 @@
 */
 
 #include "canvas.h"
+#include "blitter.h"
 #include "lcd/lcd_common.h"
+#include "lcd/lcd_simd.h"
 #include "ssd1306.h"
 
 extern const uint8_t *s_font6x8;
@@ -38,6 +40,117 @@ extern "C" uint8_t g_ssd1306_unicode;
 //
 /////////////////////////////////////////////////////////////////////////////////
 
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::setSize(lcduint_t w, lcduint_t h)
+{
+    m_w = w;
+    m_h = h;
+    m_p = 3;
+    while (w >> (m_p+1)) { m_p++; };
+    if (BPP == 16) m_p++;
+    resetClip();
+    resetDirty();
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::resetClip()
+{
+    m_clip.p1 = { 0, 0 };
+    m_clip.p2 = { (lcdint_t)(m_w - 1), (lcdint_t)(m_h - 1) };
+    m_clipDepth = 0;
+}
+
+template <uint8_t BPP>
+bool NanoCanvasOps<BPP>::pushClipRect(const NanoRect &rect)
+{
+    if (m_clipDepth >= CANVAS_CLIP_STACK_DEPTH) return false;
+    m_clipStack[m_clipDepth++] = m_clip;
+    NanoRect area = rect;
+    /* Clip area may become empty here, primitives check that after clipping */
+    m_clip.crop(area - offset);
+    return true;
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::popClipRect()
+{
+    if (m_clipDepth) m_clip = m_clipStack[--m_clipDepth];
+}
+
+template <uint8_t BPP>
+bool NanoCanvasOps<BPP>::clipArea(lcdint_t &x, lcdint_t &y, lcduint_t &w, lcduint_t &h,
+                                  lcduint_t &left, lcduint_t &top)
+{
+    if (!w || !h) return false;
+    if (m_dirty) markDirty(x, y, x + w - 1, y + h - 1);
+    x -= offset.x;
+    y -= offset.y;
+    lcdint_t x2 = min((lcdint_t)(x + (lcdint_t)w - 1), m_clip.p2.x);
+    lcdint_t y2 = min((lcdint_t)(y + (lcdint_t)h - 1), m_clip.p2.y);
+    left = x < m_clip.p1.x ? m_clip.p1.x - x : 0;
+    top = y < m_clip.p1.y ? m_clip.p1.y - y : 0;
+    x += left;
+    y += top;
+    if ((x > x2) || (y > y2)) return false;
+    w = x2 - x + 1;
+    h = y2 - y + 1;
+    return true;
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::enableDirtyTracking(lcduint_t *ranges)
+{
+    m_dirty = ranges;
+    resetDirty();
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::resetDirty()
+{
+    if (!m_dirty) return;
+    for (lcduint_t y = 0; y < m_h; y++)
+    {
+        m_dirty[y << 1] = ~(lcduint_t)0;
+        m_dirty[(y << 1) + 1] = 0;
+    }
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::markDirty(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
+    if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
+    x1 -= offset.x;
+    x2 -= offset.x;
+    y1 -= offset.y;
+    y2 -= offset.y;
+    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
+    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    x1 = max(0, x1);
+    x2 = min(x2, (lcdint_t)(m_w - 1));
+    y1 = max(0, y1);
+    y2 = min(y2, (lcdint_t)(m_h - 1));
+    for (lcdint_t y = y1; y <= y2; y++)
+    {
+        lcduint_t *range = &m_dirty[y << 1];
+        if ((lcduint_t)x1 < range[0]) range[0] = x1;
+        if ((lcduint_t)x2 > range[1]) range[1] = x2;
+    }
+}
+
+template <uint8_t BPP>
+lcduint_t NanoCanvasOps<BPP>::dirtyRows(lcduint_t y, lcduint_t &x1, lcduint_t &x2) const
+{
+    x1 = m_dirty[y << 1];
+    x2 = m_dirty[(y << 1) + 1];
+    lcduint_t rows = 1;
+    while ( (y + rows < m_h) && (m_dirty[(y + rows) << 1] == x1) && (m_dirty[((y + rows) << 1) + 1] == x2) )
+    {
+        rows++;
+    }
+    return rows;
+}
+
 template <uint8_t BPP>
 void NanoCanvasOps<BPP>::putPixel(const NanoPoint &p)
 {
@@ -62,9 +175,20 @@ void NanoCanvasOps<BPP>::drawRect(const NanoRect &rect)
 template <uint8_t BPP>
 void NanoCanvasOps<BPP>::drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    if (y1 == y2)
+    {
+        drawHLine(x1, y1, x2);
+        return;
+    }
+    if (x1 == x2)
+    {
+        drawVLine(x1, y1, y2);
+        return;
+    }
     lcduint_t  dx = x1 > x2 ? (x1 - x2): (x2 - x1);
     lcduint_t  dy = y1 > y2 ? (y1 - y2): (y2 - y1);
     lcduint_t  err = 0;
+    /* Pixels, having the same x (steep lines) or y (shallow lines), are drawn as single line */
     if (dy > dx)
     {
         if (y1 > y2)
@@ -72,16 +196,19 @@ void NanoCanvasOps<BPP>::drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_
             ssd1306_swap_data(x1, x2, lcdint_t);
             ssd1306_swap_data(y1, y2, lcdint_t);
         }
+        lcdint_t start = y1;
         for(; y1<=y2; y1++)
         {
             err += dx;
             if (err >= dy)
             {
                  err -= dy;
+                 if (y1 > start) drawVLine( x1, start, y1 - 1 );
+                 start = y1;
                  x1 < x2 ? x1++: x1--;
             }
-            putPixel( x1, y1 );
         }
+        drawVLine( x1, start, y2 );
     }
     else
     {
@@ -90,16 +217,19 @@ void NanoCanvasOps<BPP>::drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_
             ssd1306_swap_data(x1, x2, lcdint_t);
             ssd1306_swap_data(y1, y2, lcdint_t);
         }
+        lcdint_t start = x1;
         for(; x1<=x2; x1++)
         {
             err += dy;
             if (err >= dx)
             {
                  err -= dx;
+                 if (x1 > start) drawHLine( start, y1, x1 - 1 );
+                 start = x1;
                  if (y1 < y2) y1++; else y1--;
             }
-            putPixel( x1, y1 );
         }
+        drawHLine( start, y1, x2 );
     }
 }
 
@@ -115,21 +245,134 @@ void NanoCanvasOps<BPP>::fillRect(const NanoRect &rect)
     fillRect(rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y);
 }
 
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::invertRect(const NanoRect &rect)
+{
+    invertRect(rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y);
+}
+
+template <uint8_t BPP>
+static void canvasHSpan(void *ctx, lcdint_t y, lcdint_t x1, lcdint_t x2)
+{
+    static_cast<NanoCanvasOps<BPP> *>(ctx)->drawHLine(x1, y, x2);
+}
+
+/* Monochrome canvas fills shapes by columns: each span is sent as page-masked bytes */
+template <uint8_t BPP>
+static void canvasVSpan(void *ctx, lcdint_t x, lcdint_t y1, lcdint_t y2)
+{
+    static_cast<NanoCanvasOps<BPP> *>(ctx)->drawVLine(x, y1, y2);
+}
+
+template <uint8_t BPP>
+static void canvasFillSpans(NanoCanvasOps<BPP> *canvas, lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2,
+                            lcduint_t rx, lcduint_t ry)
+{
+    if (BPP == 1)
+        gfx_roundRectSpans(x1, y1, x2, y2, rx, ry, GFX_SPANS_FILL | GFX_SPANS_COLUMNS, canvasVSpan<BPP>, canvas);
+    else
+        gfx_roundRectSpans(x1, y1, x2, y2, rx, ry, GFX_SPANS_FILL, canvasHSpan<BPP>, canvas);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawCircle(lcdint_t x, lcdint_t y, lcduint_t r)
+{
+    gfx_roundRectSpans(x - r, y - r, x + r, y + r, r, r, 0, canvasHSpan<BPP>, this);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::fillCircle(lcdint_t x, lcdint_t y, lcduint_t r)
+{
+    canvasFillSpans<BPP>(this, x - r, y - r, x + r, y + r, r, r);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawEllipse(lcdint_t x, lcdint_t y, lcduint_t rx, lcduint_t ry)
+{
+    gfx_roundRectSpans(x - rx, y - ry, x + rx, y + ry, rx, ry, 0, canvasHSpan<BPP>, this);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::fillEllipse(lcdint_t x, lcdint_t y, lcduint_t rx, lcduint_t ry)
+{
+    canvasFillSpans<BPP>(this, x - rx, y - ry, x + rx, y + ry, rx, ry);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawRoundRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r)
+{
+    gfx_roundRectSpans(x1, y1, x2, y2, r, r, 0, canvasHSpan<BPP>, this);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::fillRoundRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r)
+{
+    canvasFillSpans<BPP>(this, x1, y1, x2, y2, r, r);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawTriangle(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x3, lcdint_t y3)
+{
+    drawLine(x1, y1, x2, y2);
+    drawLine(x2, y2, x3, y3);
+    drawLine(x3, y3, x1, y1);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::fillTriangle(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x3, lcdint_t y3)
+{
+    lcdint_t xy[6] = { x1, y1, x2, y2, x3, y3 };
+    if (BPP == 1)
+        gfx_triangleSpans(xy, GFX_SPANS_COLUMNS, canvasVSpan<BPP>, this);
+    else
+        gfx_triangleSpans(xy, 0, canvasHSpan<BPP>, this);
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawPolygon(const NanoPoint *points, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const NanoPoint &next = points[i + 1 < count ? i + 1 : 0];
+        drawLine(points[i].x, points[i].y, next.x, next.y);
+    }
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::fillPolygon(const NanoPoint *points, uint8_t count)
+{
+    /* NanoPoint holds just x and y, so the array is passed as x, y pairs */
+    const lcdint_t *xy = reinterpret_cast<const lcdint_t *>(points);
+    if (BPP == 1)
+        gfx_polygonSpans(xy, count, GFX_SPANS_COLUMNS, canvasVSpan<BPP>, this);
+    else
+        gfx_polygonSpans(xy, count, 0, canvasHSpan<BPP>, this);
+    drawPolygon(points, count);
+}
+
 template <uint8_t BPP>
 uint8_t NanoCanvasOps<BPP>::printChar(uint8_t c)
 {
-    uint16_t unicode = ssd1306_unicode16FromUtf8(c);
+    uint16_t unicode = ssd1306_unicode16FromUtf8Ex(&m_utf8State, c);
     if (unicode == SSD1306_MORE_CHARS_REQUIRED) return 0;
     SCharInfo char_info;
     ssd1306_getCharBitmap(unicode, &char_info);
     uint8_t mode = m_textMode;
+    uint8_t rows = ssd1306_isRowsFont();
     for (uint8_t i = 0; i<(m_fontStyle == STYLE_BOLD ? 2: 1); i++)
     {
-        drawBitmap1(m_cursorX + i,
-                    m_cursorY,
-                    char_info.width,
-                    char_info.height,
-                    char_info.glyph );
+        if ( rows )
+        {
+            drawGlyphRows(m_cursorX + i, m_cursorY, char_info);
+        }
+        else if ( !drawGlyphFixed(m_cursorX + i, m_cursorY, char_info) )
+        {
+            drawBitmap1(m_cursorX + i,
+                        m_cursorY,
+                        char_info.width,
+                        char_info.height,
+                        char_info.glyph );
+        }
         m_textMode |= CANVAS_MODE_TRANSPARENT;
     }
     m_textMode = mode;
@@ -147,6 +390,54 @@ uint8_t NanoCanvasOps<BPP>::printChar(uint8_t c)
     return 1;
 }
 
+/*
+ * Glyph pixels of rows fonts go in the same order as canvas pixels, so 8-bit and 16-bit
+ * canvases write them with pointer walking, others write them with putLocal(). Pixels
+ * outside of clip area are skipped by the reader, so visible pixels are not checked.
+ * Anti-aliased glyphs take colors from ramp in opaque mode and are blended with canvas
+ * pixels in transparent mode.
+ */
+static inline void canvasGlyphClip(lcdint_t &x1, lcdint_t &y1, const NanoRect &clip,
+                                   const SCharInfo &info, lcduint_t &left, lcduint_t &visible,
+                                   lcduint_t &top, lcduint_t &rows)
+{
+    left = x1 < clip.p1.x ? clip.p1.x - x1 : 0;
+    top = y1 < clip.p1.y ? clip.p1.y - y1 : 0;
+    lcdint_t right = x1 + (lcdint_t)info.width > clip.p2.x + 1 ? clip.p2.x + 1 - x1 : info.width;
+    lcdint_t bottom = y1 + (lcdint_t)info.height > clip.p2.y + 1 ? clip.p2.y + 1 - y1 : info.height;
+    visible = right > (lcdint_t)left ? right - left : 0;
+    rows = bottom > (lcdint_t)top ? bottom - top : 0;
+    x1 += left;
+    y1 += top;
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawGlyphRows(lcdint_t xpos, lcdint_t ypos, const SCharInfo &info)
+{
+    if (m_dirty) markDirty(xpos, ypos, xpos + info.width - 1, ypos + info.height - 1);
+    lcdint_t x1 = xpos - offset.x;
+    lcdint_t y1 = ypos - offset.y;
+    lcduint_t left, visible, top, rows;
+    canvasGlyphClip(x1, y1, m_clip, info, left, visible, top, rows);
+    if (!visible || !rows) return;
+    SGlyphReader reader;
+    ssd1306_glyphReaderInit(&reader, &info);
+    ssd1306_glyphSkipPixels(&reader, (uint16_t)top * info.width);
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    for (lcduint_t j = 0; j < rows; j++)
+    {
+        ssd1306_glyphSkipPixels(&reader, left);
+        for (lcduint_t i = 0; i < visible; i++)
+        {
+            if ( ssd1306_glyphReadPixel(&reader) )
+                putLocal(x1 + i, y1 + j, m_color);
+            else if ( !transparent )
+                putLocal(x1 + i, y1 + j, 0);
+        }
+        ssd1306_glyphSkipPixels(&reader, info.width - left - visible);
+    }
+}
+
 template <uint8_t BPP>
 size_t NanoCanvasOps<BPP>::write(uint8_t c)
 {
@@ -166,6 +457,18 @@ size_t NanoCanvasOps<BPP>::write(uint8_t c)
     return 1;
 }
 
+template <uint8_t BPP>
+size_t NanoCanvasOps<BPP>::write(const uint8_t *buffer, size_t size)
+{
+    /* Chars are passed to the canvas writer directly, without virtual call per char */
+    size_t n = 0;
+    while (size--)
+    {
+        n += NanoCanvasOps<BPP>::write(*buffer++);
+    }
+    return n;
+}
+
 template <uint8_t BPP>
 void NanoCanvasOps<BPP>::printFixed(lcdint_t xpos, lcdint_t y, const char *ch, EFontStyle style)
 {
@@ -179,6 +482,155 @@ void NanoCanvasOps<BPP>::printFixed(lcdint_t xpos, lcdint_t y, const char *ch, E
     }
 }
 
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::printLayout(lcdint_t xpos, lcdint_t y, const STextLayout &layout, uint8_t firstLine)
+{
+    uint8_t mode = m_textMode;
+    m_textMode &= ~(CANVAS_TEXT_WRAP | CANVAS_TEXT_WRAP_LOCAL);
+    m_fontStyle = STYLE_NORMAL;
+    lcdint_t bottom = offset.y + (lcdint_t)m_h;
+    for (uint8_t i = firstLine; (i < layout.count) && (y < bottom); i++)
+    {
+        if ( y + (lcdint_t)layout.lineHeight > offset.y )
+        {
+            const STextLine &line = layout.lines[i];
+            const char *ch = &layout.text[line.offset];
+            m_cursorX = xpos;
+            m_cursorY = y;
+            m_utf8State = 0;
+            for (uint8_t n = line.length; n > 0; n--, ch++)
+            {
+                if ( *ch != '\r' ) printChar( *ch );
+            }
+        }
+        y += (lcdint_t)layout.lineHeight;
+    }
+    m_textMode = mode;
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawGlyphScaled(lcdint_t x, lcdint_t y, const SCharInfo &info, uint8_t factor)
+{
+    SGlyphReader reader;
+    ssd1306_glyphReaderInit(&reader, &info);
+    uint8_t rows = ssd1306_isRowsFont();
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    uint16_t color = m_color;
+    lcdint_t scale = 1 << factor;
+    for (lcduint_t j = 0; j < info.height; j++)
+    {
+        const uint8_t *glyph = &info.glyph[(j >> 3) * info.width];
+        uint8_t bit = 1 << (j & 0x07);
+        lcdint_t top = y + (lcdint_t)(j << factor);
+        lcduint_t start = 0;
+        uint8_t value = 0;
+        for (lcduint_t i = 0; i <= info.width; i++)
+        {
+            uint8_t set = 2;
+            if ( i < info.width )
+            {
+                set = rows ? !!ssd1306_glyphReadPixel(&reader) : !!(pgm_read_byte(&glyph[i]) & bit);
+            }
+            if ( i && (set != value) )
+            {
+                if ( value || !transparent )
+                {
+                    m_color = value ? color : 0;
+                    fillRect(x + (lcdint_t)(start << factor), top,
+                             x + (lcdint_t)(i << factor) - 1, top + scale - 1);
+                }
+                start = i;
+            }
+            value = set;
+        }
+    }
+    m_color = color;
+}
+
+template <uint8_t BPP>
+template <bool MONO>
+void NanoCanvasOps<BPP>::drawScaledRow(lcdint_t x, lcdint_t top, lcduint_t w,
+                                       const uint8_t *row, uint8_t bit, uint8_t scale)
+{
+    if ((top + scale - 1 < offset.y + m_clip.p1.y) || (top > offset.y + m_clip.p2.y)) return;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    uint16_t color = m_color;
+    lcduint_t start = 0;
+    uint8_t value = MONO ? (pgm_read_byte(&row[0]) & bit) : pgm_read_byte(&row[0]);
+    for (lcduint_t i = 1; i <= w; i++)
+    {
+        uint8_t set = 0;
+        if ( i < w )
+        {
+            set = MONO ? (pgm_read_byte(&row[i]) & bit) : pgm_read_byte(&row[i]);
+            if ( set == value ) continue;
+        }
+        if ( value || !transparent )
+        {
+            if ( MONO ) m_color = value ? color : 0;
+            else m_color = (BPP == 16) ? RGB8_TO_RGB16(value) : value;
+            fillRect(x + (lcdint_t)(start * scale), top,
+                     x + (lcdint_t)(i * scale) - 1, top + scale - 1);
+        }
+        start = i;
+        value = set;
+    }
+    m_color = color;
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawBitmap1Scaled(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                                           const uint8_t *bitmap, uint8_t scale)
+{
+    for (lcduint_t j = 0; j < h; j++)
+    {
+        drawScaledRow<true>(x, y + (lcdint_t)(j * scale), w, &bitmap[(j >> 3) * w], 1 << (j & 0x07), scale);
+    }
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawBitmap8Scaled(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                                           const uint8_t *bitmap, uint8_t scale)
+{
+    for (lcduint_t j = 0; j < h; j++)
+    {
+        drawScaledRow<false>(x, y + (lcdint_t)(j * scale), w, &bitmap[j * w], 0, scale);
+    }
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::printFixedN(lcdint_t xpos, lcdint_t y, const char *ch, EFontStyle style, uint8_t factor)
+{
+    m_fontStyle = style;
+    m_cursorX = xpos;
+    m_cursorY = y;
+    for (; *ch; ch++)
+    {
+        if (*ch == '\n')
+        {
+            m_cursorY += (lcdint_t)s_fixedFont.h.height << factor;
+            m_cursorX = xpos;
+            continue;
+        }
+        if (*ch == '\r')
+        {
+            continue;
+        }
+        uint16_t unicode = ssd1306_unicode16FromUtf8Ex(&m_utf8State, *ch);
+        if (unicode == SSD1306_MORE_CHARS_REQUIRED) continue;
+        SCharInfo char_info;
+        ssd1306_getCharBitmap(unicode, &char_info);
+        uint8_t mode = m_textMode;
+        for (uint8_t i = 0; i<(m_fontStyle == STYLE_BOLD ? 2: 1); i++)
+        {
+            drawGlyphScaled(m_cursorX + (i << factor), m_cursorY, char_info, factor);
+            m_textMode |= CANVAS_MODE_TRANSPARENT;
+        }
+        m_textMode = mode;
+        m_cursorX += (lcdint_t)(char_info.width + char_info.spacing) << factor;
+    }
+}
+
 template <uint8_t BPP>
 void NanoCanvasOps<BPP>::printFixedPgm(lcdint_t xpos, lcdint_t y, const char *ch, EFontStyle style)
 {
@@ -203,18 +655,65 @@ void NanoCanvasOps<BPP>::printFixedPgm(lcdint_t xpos, lcdint_t y, const char *ch
 #ifdef CONFIG_MULTIPLICATION_NOT_SUPPORTED
 #define YADDR1(y) (static_cast<uint16_t>((y) >> 3) << m_p)
 #define BANK_ADDR1(b) ((b) << m_p)
+#define CANVAS_BANK_ADDR1(c, b) (static_cast<uint16_t>(b) << (c).m_p)
 #else
 #define YADDR1(y) (static_cast<uint16_t>((y) >> 3) * m_w)
 #define BANK_ADDR1(b) ((b) * m_w)
+#define CANVAS_BANK_ADDR1(c, b) (static_cast<uint16_t>(b) * (c).m_w)
+#endif
+
+#if !defined(__AVR__) && defined(__GNUC__)
+/* 32-bit platforms process 4 columns (4 bytes of the page) per iteration */
+#define CANVAS_WORD_OPS
+typedef uint32_t __attribute__((__may_alias__)) canvas_word_t;
+/* Replicates byte to all 4 bytes of the word */
+#define CANVAS_WORD(b) (0x01010101UL * (uint8_t)(b))
+
+static inline uint32_t canvasReadWord1(const uint8_t *bitmap)
+{
+    /* bitmap can be unaligned and located in flash, so read it byte by byte */
+    uint8_t bytes[4] = { pgm_read_byte(&bitmap[0]), pgm_read_byte(&bitmap[1]),
+                         pgm_read_byte(&bitmap[2]), pgm_read_byte(&bitmap[3]) };
+    uint32_t data;
+    memcpy(&data, bytes, sizeof(data));
+    return data;
+}
+#endif
+
+/* Sets bits of mask in count sequential bytes of the page if color is not zero, or clears them */
+static void canvasFillColumns1(uint8_t *buf, lcduint_t count, uint8_t mask, uint16_t color)
+{
+    uint8_t andMask = color ? 0xFF : ~mask;
+    uint8_t orMask = color ? mask : 0x00;
+#ifdef CANVAS_WORD_OPS
+    while ( count && ((uintptr_t)buf & (sizeof(canvas_word_t) - 1)) )
+    {
+        *buf = (*buf & andMask) | orMask;
+        buf++;
+        count--;
+    }
+    canvas_word_t *words = reinterpret_cast<canvas_word_t *>(buf);
+    for ( ; count >= sizeof(canvas_word_t); count -= sizeof(canvas_word_t) )
+    {
+        *words = (*words & CANVAS_WORD(andMask)) | CANVAS_WORD(orMask);
+        words++;
+    }
+    buf = reinterpret_cast<uint8_t *>(words);
 #endif
+    while ( count-- )
+    {
+        *buf = (*buf & andMask) | orMask;
+        buf++;
+    }
+}
 
 template <>
 void NanoCanvasOps<1>::putPixel(lcdint_t x, lcdint_t y)
 {
+    if (m_dirty) markDirty(x, y, x, y);
     x -= offset.x;
     y -= offset.y;
-    if ((x<0) || (y<0)) return;
-    if (( x >= (lcdint_t)m_w ) || ( y >= (lcdint_t)m_h)) return;
+    if (!m_clip.collision({x, y})) return;
     if (m_color)
     {
         m_buf[YADDR1(y) + x] |= (1 << (y & 0x7));
@@ -228,37 +727,32 @@ void NanoCanvasOps<1>::putPixel(lcdint_t x, lcdint_t y)
 template <>
 void NanoCanvasOps<1>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 {
+    if (m_dirty) markDirty(x1, y1, x2, y1);
     if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
     x1 -= offset.x;
     x2 -= offset.x;
     y1 -= offset.y;
-    if ((y1 >= (lcdint_t)m_h) || (y1 < 0)) return;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    x1 = max(0, x1);
-    x2 = min(x2, (lcdint_t)(m_w -1));
-    uint16_t addr = YADDR1(y1) + x1;
-    uint8_t mask = (1 << (y1 & 0x7));
-    if (m_color)
-    {
-        do { m_buf[addr++] |= mask; } while (x2>x1++);
-    }
-    else
-    {
-        do { m_buf[addr++] &= ~mask; } while (x2>x1++);
-    }
+    if (!m_clip.collisionY(y1)) return;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    if (x1 > x2) return;
+    canvasFillColumns1(&m_buf[YADDR1(y1) + x1], x2 - x1 + 1, 1 << (y1 & 0x7), m_color);
 }
 
 template <>
 void NanoCanvasOps<1>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 {
+    if (m_dirty) markDirty(x1, y1, x1, y2);
     if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
     x1 -= offset.x;
     y1 -= offset.y;
     y2 -= offset.y;
-    if ((x1 >= (lcdint_t)m_w) || (x1 < 0)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    y1 = max(0, y1);
-    y2 = min(y2, (lcdint_t)(m_h -1));
+    if (!m_clip.collisionX(x1)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    y1 = max(y1, m_clip.p1.y);
+    y2 = min(y2, m_clip.p2.y);
+    if (y1 > y2) return;
 
     uint16_t addr = YADDR1(y1) + x1;
     if ((y1 & 0xFFF8) == (y2 & 0xFFF8))
@@ -297,18 +791,20 @@ void NanoCanvasOps<1>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 template <>
 void NanoCanvasOps<1>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    if (m_dirty) markDirty(x1, y1, x2, y2);
     if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
     if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
     x1 -= offset.x;
     x2 -= offset.x;
     y1 -= offset.y;
     y2 -= offset.y;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(0, x1);
-    x2 = min(x2, (lcdint_t)(m_w - 1));
-    y1 = max(0, y1);
-    y2 = min(y2, (lcdint_t)(m_h - 1));
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    y1 = max(y1, m_clip.p1.y);
+    y2 = min(y2, m_clip.p2.y);
+    if ((x1 > x2) || (y1 > y2)) return;
     uint8_t bank1 = (y1 >> 3);
     uint8_t bank2 = (y2 >> 3);
     for (uint8_t bank = bank1; bank<=bank2; bank++)
@@ -326,40 +822,98 @@ void NanoCanvasOps<1>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
         {
             mask = (mask >> (7 - (y2 & 7)));
         }
-        for (uint8_t x=x1; x<=x2; x++)
-        {
-            if (m_color)
-            {
-                m_buf[BANK_ADDR1(bank) + x] |= mask;
-            }
-            else
-            {
-                m_buf[BANK_ADDR1(bank) + x] &= ~mask;
-            }
-        }
+        canvasFillColumns1(&m_buf[BANK_ADDR1(bank) + x1], x2 - x1 + 1, mask, m_color);
     }
 };
 
+template <>
+void NanoCanvasOps<1>::invertRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    if (m_dirty) markDirty(x1, y1, x2, y2);
+    if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
+    if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
+    x1 -= offset.x;
+    x2 -= offset.x;
+    y1 -= offset.y;
+    y2 -= offset.y;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    y1 = max(y1, m_clip.p1.y);
+    y2 = min(y2, m_clip.p2.y);
+    if ((x1 > x2) || (y1 > y2)) return;
+    for (uint8_t bank = (y1 >> 3); bank <= (y2 >> 3); bank++)
+    {
+        uint8_t mask = 0xFF;
+        if (bank == (y1 >> 3)) mask <<= (y1 & 7);
+        if (bank == (y2 >> 3)) mask &= 0xFF >> (7 - (y2 & 7));
+        uint8_t *buf = &m_buf[BANK_ADDR1(bank) + x1];
+        for (lcdint_t x = x1; x <= x2; x++)
+        {
+            *buf++ ^= mask;
+        }
+    }
+}
+
 template <>
 void NanoCanvasOps<1>::clear()
 {
+    if (m_dirty) markDirty(offset.x, offset.y, offset.x + m_w - 1, offset.y + m_h - 1);
     memset(m_buf, 0, YADDR1(m_h));
 }
 
-// TODO: Not so fast implementation. needs to be optimized
+/* Returns bits of the page, starting at top row, which are inside clip area */
+static inline uint8_t canvasPageClip1(lcdint_t top, const NanoRect &clip)
+{
+    lcdint_t first = clip.p1.y - top;
+    lcdint_t last = clip.p2.y - top;
+    if ((last < 0) || (first > 7) || (first > last)) return 0;
+    uint8_t mask = 0xFF;
+    if (first > 0) mask <<= first;
+    if (last < 7) mask &= 0xFF >> (7 - last);
+    return mask;
+}
+
+template <>
+inline void NanoCanvasOps<1>::drawBitmapColumn1(uint16_t addr, const uint8_t *bitmap, lcduint_t pitch,
+                                                uint8_t offs, uint8_t mainFlag, uint8_t complexFlag,
+                                                uint8_t clip)
+{
+    uint8_t data = 0;
+    uint8_t mask = 0;
+    if ( mainFlag )    { data |= (pgm_read_byte(bitmap) << offs); mask |= (0xFF << offs); }
+    if ( complexFlag ) { data |= (pgm_read_byte(bitmap - pitch) >> (8 - offs)); mask |= (0xFF >> (8 - offs)); }
+    data &= clip;
+    mask &= clip;
+    if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
+    {
+        m_buf[addr] &= ~mask;
+        m_buf[addr] |= m_color == BLACK ? ~data & mask: data;
+    }
+    else
+    {
+        if (m_color == BLACK)
+            m_buf[addr] &= ~data;
+        else
+            m_buf[addr] |= data;
+    }
+}
+
 template <>
 void NanoCanvasOps<1>::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    if (m_dirty) markDirty(x, y, x + w - 1, y + h - 1);
     x -= offset.x;
     y -= offset.y;
     lcduint_t origin_width = w;
     uint8_t offs = y & 0x07;
     uint8_t complexFlag = 0;
     uint8_t mainFlag = 1;
-    if (y + (lcdint_t)h <= 0) return;
-    if (y >= (lcdint_t)m_h) return;
-    if (x + (lcdint_t)w <= 0) return;
-    if (x >= (lcdint_t)m_w)  return;
+    if (y + (lcdint_t)h <= m_clip.p1.y) return;
+    if (y > m_clip.p2.y) return;
+    if (x + (lcdint_t)w <= m_clip.p1.x) return;
+    if (x > m_clip.p2.x) return;
     if (y < 0)
     {
          bitmap += ((lcduint_t)((-y) + 7) >> 3) * w;
@@ -367,20 +921,21 @@ void NanoCanvasOps<1>::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_
          y = 0;
          complexFlag = 1;
     }
-    if (x < 0)
+    if (x < m_clip.p1.x)
     {
-         bitmap += -x;
-         w += x;
-         x = 0;
+         bitmap += m_clip.p1.x - x;
+         w -= m_clip.p1.x - x;
+         x = m_clip.p1.x;
     }
+    if (x > m_clip.p2.x) return;
     uint8_t max_pages = (lcduint_t)(h + 15 - offs) >> 3;
     if ((lcduint_t)(y + (lcdint_t)h) > (lcduint_t)m_h)
     {
          h = (lcduint_t)(m_h - (lcduint_t)y);
     }
-    if ((lcduint_t)(x + (lcdint_t)w) > (lcduint_t)m_w)
+    if (x + (lcdint_t)w > m_clip.p2.x + 1)
     {
-         w = (lcduint_t)(m_w - (lcduint_t)x);
+         w = (lcduint_t)(m_clip.p2.x + 1 - x);
     }
     uint8_t pages = ((y + h - 1) >> 3) - (y >> 3) + 1;
     uint8_t j;
@@ -388,98 +943,337 @@ void NanoCanvasOps<1>::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_
 
     for(j=0; j < pages; j++)
     {
-        uint16_t addr = YADDR1(y + ((uint16_t)j<<3)) + x;
+        lcdint_t top = (y & ~0x07) + ((lcdint_t)j << 3);
+        uint16_t addr = YADDR1(top) + x;
         if ( j == max_pages - 1 ) mainFlag = !offs;
-        for( i=w; i > 0; i--)
+        /* Rows outside of clip area are cut off by page mask, so columns are not checked */
+        uint8_t clip = canvasPageClip1(top, m_clip);
+        if ( !clip )
         {
-            uint8_t data = 0;
-            uint8_t mask = 0;
-            if ( mainFlag )    { data |= (pgm_read_byte(bitmap) << offs); mask |= (0xFF << offs); }
-            if ( complexFlag ) { data |= (pgm_read_byte(bitmap - origin_width) >> (8 - offs)); mask |= (0xFF >> (8 - offs)); }
+            bitmap += origin_width;
+            complexFlag = offs;
+            continue;
+        }
+        i = w;
+#ifdef CANVAS_WORD_OPS
+        /* Shift 4 columns at once: bits, moved to neighbour byte, are cut off by page masks */
+        uint32_t mainMask = mainFlag ? CANVAS_WORD((0xFF << offs) & clip) : 0;
+        uint32_t carryMask = complexFlag ? CANVAS_WORD((0xFF >> (8 - offs)) & clip) : 0;
+        while ( i && ((uintptr_t)&m_buf[addr] & (sizeof(canvas_word_t) - 1)) )
+        {
+            drawBitmapColumn1( addr++, bitmap++, origin_width, offs, mainFlag, complexFlag, clip );
+            i--;
+        }
+        for ( ; i >= sizeof(canvas_word_t); i -= sizeof(canvas_word_t) )
+        {
+            uint32_t data = 0;
+            if ( mainFlag )    { data |= (canvasReadWord1(bitmap) << offs) & mainMask; }
+            if ( complexFlag ) { data |= (canvasReadWord1(bitmap - origin_width) >> (8 - offs)) & carryMask; }
+            uint32_t mask = mainMask | carryMask;
+            canvas_word_t *dst = reinterpret_cast<canvas_word_t *>(&m_buf[addr]);
             if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
             {
-                m_buf[addr] &= ~mask;
-                m_buf[addr] |= m_color == BLACK ? ~data: data;
+                *dst = (*dst & ~mask) | (m_color == BLACK ? ~data & mask: data);
             }
             else
             {
                 if (m_color == BLACK)
-                    m_buf[addr] &= ~data;
+                    *dst &= ~data;
                 else
-                    m_buf[addr] |= data;
+                    *dst |= data;
             }
-            bitmap++;
-            addr++;
+            bitmap += sizeof(canvas_word_t);
+            addr += sizeof(canvas_word_t);
+        }
+#endif
+        for( ; i > 0; i--)
+        {
+            drawBitmapColumn1( addr++, bitmap++, origin_width, offs, mainFlag, complexFlag, clip );
         }
         bitmap += origin_width - w;
         complexFlag = offs;
     }
 }
 
+template <>
+void NanoCanvasOps<1>::drawBitmap1Ex(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch,
+                                     lcduint_t srcX, lcduint_t srcY, const uint8_t *bitmap)
+{
+    lcduint_t left, top;
+    if (!clipArea(x, y, w, h, left, top)) return;
+    srcX += left;
+    srcY += top;
+    NanoRect area = { {x, y}, {(lcdint_t)(x + w - 1), (lcdint_t)(y + h - 1)} };
+    uint16_t firstPage = srcY >> 3;
+    uint16_t lastPage = (srcY + h - 1) >> 3;
+    /* Source row at bit 0 of canvas page, biased by 8 to stay positive for the first page */
+    uint16_t row = srcY + 8 - (y & 0x07);
+    uint8_t shift = row & 0x07;
+    for (lcdint_t pageTop = y & ~0x07; pageTop <= area.p2.y; pageTop += 8)
+    {
+        /* Canvas page takes upper bits of source page and lower bits of the next one */
+        uint16_t next = row >> 3;
+        uint8_t mainFlag = (next > firstPage) && (next - 1 <= lastPage);
+        uint8_t nextFlag = shift && (next >= firstPage) && (next <= lastPage);
+        const uint8_t *src = bitmap + next * pitch + srcX;
+        uint8_t mask = canvasPageClip1(pageTop, area);
+        uint8_t *dst = &m_buf[YADDR1(pageTop) + x];
+        for (lcduint_t i = 0; i < w; i++)
+        {
+            uint8_t data = 0;
+            if ( mainFlag ) data |= pgm_read_byte(&src[i] - pitch) >> shift;
+            if ( nextFlag ) data |= pgm_read_byte(&src[i]) << (8 - shift);
+            data &= mask;
+            if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
+            {
+                dst[i] = (dst[i] & ~mask) | (m_color == BLACK ? ~data & mask: data);
+            }
+            else
+            {
+                if (m_color == BLACK)
+                    dst[i] &= ~data;
+                else
+                    dst[i] |= data;
+            }
+        }
+        row += 8;
+    }
+}
+
+template <>
+void NanoCanvasOps<1>::xorBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    if (m_dirty) markDirty(x, y, x + w - 1, y + h - 1);
+    x -= offset.x;
+    y -= offset.y;
+    NanoRect area = { {max(x, m_clip.p1.x), max(y, m_clip.p1.y)},
+                      {min(x + (lcdint_t)w - 1, m_clip.p2.x), min(y + (lcdint_t)h - 1, m_clip.p2.y)} };
+    if ((area.p1.x > area.p2.x) || (area.p1.y > area.p2.y)) return;
+    lcdint_t pages = (h + 7) >> 3;
+    /* Canvas page gets bits of bitmap pages k and k + 1, shifted down by s */
+    uint8_t s = static_cast<uint8_t>(-y) & 0x07;
+    for (lcdint_t bank = (area.p1.y >> 3); bank <= (area.p2.y >> 3); bank++)
+    {
+        lcdint_t k = ((bank << 3) - y - s) / 8;
+        uint8_t mask = canvasPageClip1(bank << 3, area);
+        uint8_t *buf = &m_buf[BANK_ADDR1(bank) + area.p1.x];
+        const uint8_t *src = bitmap + (area.p1.x - x);
+        for (lcdint_t col = area.p1.x; col <= area.p2.x; col++)
+        {
+            uint8_t data = 0;
+            if ((k >= 0) && (k < pages)) data = pgm_read_byte(src + k * w) >> s;
+            if (s && (k + 1 >= 0) && (k + 1 < pages)) data |= pgm_read_byte(src + (k + 1) * w) << (8 - s);
+            *buf++ ^= data & mask;
+            src++;
+        }
+    }
+}
+
+template <>
+void NanoCanvasOps<1>::drawShiftedBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *shifted)
+{
+    if (m_dirty) markDirty(x, y, x + w - 1, y + h - 1);
+    x -= offset.x;
+    y -= offset.y;
+    if (y + (lcdint_t)h <= m_clip.p1.y) return;
+    if (y > m_clip.p2.y) return;
+    if (x + (lcdint_t)w <= m_clip.p1.x) return;
+    if (x > m_clip.p2.x) return;
+    uint8_t offs = y & 0x07;
+    lcdint_t top = y - offs;
+    uint8_t pages = (offs + h + 7) >> 3;
+    uint8_t lastMask = 0xFF >> ((8 - ((offs + h) & 0x07)) & 0x07);
+    lcduint_t pitch = w;
+    if (x < m_clip.p1.x)
+    {
+        shifted += m_clip.p1.x - x;
+        w -= m_clip.p1.x - x;
+        x = m_clip.p1.x;
+    }
+    if (x > m_clip.p2.x) return;
+    if (x + (lcdint_t)w > m_clip.p2.x + 1)
+    {
+        w = (lcduint_t)(m_clip.p2.x + 1 - x);
+    }
+    for (uint8_t j = 0; j < pages; j++, top += 8, shifted += pitch)
+    {
+        if (top + 7 < m_clip.p1.y) continue;
+        if (top > m_clip.p2.y) break;
+        uint8_t mask = canvasPageClip1(top, m_clip);
+        if (j == 0) mask &= 0xFF << offs;
+        if (j == pages - 1) mask &= lastMask;
+        uint8_t *dst = &m_buf[YADDR1(top) + x];
+        const uint8_t *src = shifted;
+        if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
+        {
+            uint8_t invert = m_color == BLACK ? mask : 0;
+            for (lcduint_t i = w; i > 0; i--, dst++)
+            {
+                *dst = (*dst & ~mask) | ((*src++ ^ invert) & mask);
+            }
+        }
+        else if (m_color == BLACK)
+        {
+            for (lcduint_t i = w; i > 0; i--) *dst++ &= ~(*src++ & mask);
+        }
+        else
+        {
+            for (lcduint_t i = w; i > 0; i--) *dst++ |= *src++ & mask;
+        }
+    }
+}
+
+template <>
+void NanoCanvasOps<1>::drawMaskedBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                                         const uint8_t *bitmap, const uint8_t *mask)
+{
+    if (m_dirty) markDirty(x, y, x + w - 1, y + h - 1);
+    x -= offset.x;
+    y -= offset.y;
+    if (y + (lcdint_t)h <= m_clip.p1.y) return;
+    if (y > m_clip.p2.y) return;
+    if (x + (lcdint_t)w <= m_clip.p1.x) return;
+    if (x > m_clip.p2.x) return;
+    uint8_t offs = y & 0x07;
+    lcdint_t top = y - offs;
+    uint8_t srcPages = (h + 7) >> 3;
+    uint8_t pages = (offs + h + 7) >> 3;
+    lcduint_t pitch = w;
+    if (x < m_clip.p1.x)
+    {
+        bitmap += m_clip.p1.x - x;
+        mask += m_clip.p1.x - x;
+        w -= m_clip.p1.x - x;
+        x = m_clip.p1.x;
+    }
+    if (x > m_clip.p2.x) return;
+    if (x + (lcdint_t)w > m_clip.p2.x + 1)
+    {
+        w = (lcduint_t)(m_clip.p2.x + 1 - x);
+    }
+    for (uint8_t j = 0; j < pages; j++, top += 8)
+    {
+        if (top + 7 < m_clip.p1.y) continue;
+        if (top > m_clip.p2.y) break;
+        uint8_t clip = canvasPageClip1(top, m_clip);
+        uint8_t *dst = &m_buf[YADDR1(top) + x];
+        /* Destination page gets lower part of source page j and upper part of page j - 1 */
+        const uint8_t *src = bitmap + (uint16_t)j * pitch;
+        const uint8_t *msk = mask + (uint16_t)j * pitch;
+        uint8_t mainFlag = j < srcPages;
+        uint8_t carryFlag = (j > 0) && offs;
+        for (lcduint_t i = 0; i < w; i++)
+        {
+            uint8_t data = 0;
+            uint8_t m = 0;
+            if ( mainFlag )
+            {
+                data = pgm_read_byte(&src[i]) << offs;
+                m = pgm_read_byte(&msk[i]) << offs;
+            }
+            if ( carryFlag )
+            {
+                data |= pgm_read_byte(&src[i] - pitch) >> (8 - offs);
+                m |= pgm_read_byte(&msk[i] - pitch) >> (8 - offs);
+            }
+            m &= clip;
+            dst[i] = (dst[i] & ~m) | (data & m);
+        }
+    }
+}
+
 template <>
 void NanoCanvasOps<1>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    if (m_dirty) markDirty(x, y, x + w - 1, y + h - 1);
     x -= offset.x;
     y -= offset.y;
     lcduint_t origin_width = w;
-    if (y + (lcdint_t)h <= 0) return;
-    if (y >= (lcdint_t)m_h) return;
-    if (x + (lcdint_t)w <= 0) return;
-    if (x >= (lcdint_t)m_w)  return;
-
-    delay(100);
+    if (y + (lcdint_t)h <= m_clip.p1.y) return;
+    if (y > m_clip.p2.y) return;
+    if (x + (lcdint_t)w <= m_clip.p1.x) return;
+    if (x > m_clip.p2.x) return;
 
     uint8_t start_bit = 0;
     lcduint_t pitch_delta = 0;
-    if (y < 0)
+    if (y < m_clip.p1.y)
     {
-        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(-y);
-        h += y;
-        y = 0;
+        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(m_clip.p1.y - y);
+        h -= m_clip.p1.y - y;
+        y = m_clip.p1.y;
     }
-    if (x < 0)
+    if (x < m_clip.p1.x)
     {
-        bitmap += ((lcduint_t)(-x)) / 8;
-        start_bit = ((lcduint_t)(-x)) & 0x07;
-        w += x;
-        x = 0;
+        bitmap += ((lcduint_t)(m_clip.p1.x - x)) / 8;
+        start_bit = ((lcduint_t)(m_clip.p1.x - x)) & 0x07;
+        w -= m_clip.p1.x - x;
+        x = m_clip.p1.x;
     }
-    if ((lcduint_t)(y + (lcdint_t)h) > (lcduint_t)m_h)
+    if ((y > m_clip.p2.y) || (x > m_clip.p2.x)) return;
+    if (y + (lcdint_t)h > m_clip.p2.y + 1)
     {
-        h = (lcduint_t)(m_h - (lcduint_t)y);
+        h = (lcduint_t)(m_clip.p2.y + 1 - y);
     }
-    if ((lcduint_t)(x + (lcdint_t)w) > (lcduint_t)m_w)
+    if (x + (lcdint_t)w > m_clip.p2.x + 1)
     {
-        w = (lcduint_t)(m_w - (lcduint_t)x);
+        w = (lcduint_t)(m_clip.p2.x + 1 - x);
     }
-    pitch_delta = ((origin_width + 7 - start_bit) >> 3) - ((w + 7) >> 3);
+    pitch_delta = ((origin_width + 7) >> 3) - ((start_bit + w + 7) >> 3);
 
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    lcduint_t pitch = (origin_width + 7) >> 3;
+    while ((start_bit == 0) && ((y & 0x07) == 0) && (h >= 8))
+    {
+        /* Whole pages: 8x8 blocks of bitmap rows are transposed to page bytes */
+        uint8_t *dst = &m_buf[YADDR1(y) + x];
+        for(lcduint_t i = 0; i < w; i += 8)
+        {
+            uint8_t block[8];
+            uint8_t n = (w - i) < 8 ? (w - i) : 8;
+            for (uint8_t k = 0; k < 8; k++)
+            {
+                block[k] = pgm_read_byte(&bitmap[k * pitch + (i >> 3)]);
+            }
+            ssd1306_transpose8x8(block);
+            for (uint8_t k = 0; k < n; k++)
+            {
+                if (!transparent)
+                    dst[i + k] = m_color == BLACK ? ~block[k] : block[k];
+                else if (m_color == BLACK)
+                    dst[i + k] &= ~block[k];
+                else
+                    dst[i + k] |= block[k];
+            }
+        }
+        bitmap += pitch * 8;
+        y += 8;
+        h -= 8;
+    }
     for(lcduint_t j = 0; j < h; j++)
     {
+        /* Each bitmap row is drawn to the same bit of sequential page bytes */
+        uint8_t *dst = &m_buf[YADDR1(y + j) + x];
+        uint8_t mask = 1 << ((y + j) & 0x7);
+        uint8_t fg = m_color == BLACK ? 0 : mask;
         uint8_t bit = start_bit;
+        uint8_t data = pgm_read_byte(bitmap) >> bit;
         for(lcduint_t i = 0; i < w; i++)
         {
-            uint8_t data = 0;
-            data = (pgm_read_byte(bitmap) >> bit) & 0x01;
-            if (data)
+            if (data & 0x01)
             {
-                if (m_color == BLACK)
-                    m_buf[YADDR1(y + j) + (x + i)] &= ~(1 << ((y + j) & 0x7));
-                else
-                    m_buf[YADDR1(y + j) + (x + i)] |= (1 << ((y + j) & 0x7));
+                dst[i] = (dst[i] & ~mask) | fg;
             }
-            else if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
+            else if (!transparent)
             {
-                if (m_color == BLACK)
-                    m_buf[YADDR1(y + j) + (x + i)] |= (1 << ((y + j) & 0x7));
-                else
-                    m_buf[YADDR1(y + j) + (x + i)] &= ~(1 << ((y + j) & 0x7));
+                dst[i] = (dst[i] & ~mask) | (fg ^ mask);
             }
+            data >>= 1;
             bit++;
             if (bit >= 8)
             {
                 bitmap++;
                 bit=0;
+                if (i + 1 < w) data = pgm_read_byte(bitmap);
             }
         }
         if (bit)
@@ -501,87 +1295,161 @@ void NanoCanvasOps<1>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
     m_cursorY = 0;
     m_color = WHITE;
     m_textMode = 0;
+    m_utf8State = 0;
     m_p = 3;
     while (w >> (m_p+1)) { m_p++; };
     m_buf = bytes;
-    clear();
+    resetClip();
+    if (m_buf) clear();
 }
 
 //                 NANO CANVAS 1
 
 void NanoCanvas1::blt(lcdint_t x, lcdint_t y)
 {
-    ssd1306_drawBufferFast(x, y, m_w, m_h, m_buf);
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    if (!m_dirty)
+    {
+        ssd1306_drawBufferFast(x, y, m_w, m_h, m_buf);
+        return;
+    }
+    /* Display memory is organized in pages, so dirty rows are joined to 8-row spans */
+    for (lcduint_t page = 0; page < (m_h >> 3); page++)
+    {
+        lcduint_t x1 = ~(lcduint_t)0, x2 = 0;
+        for (lcduint_t row = page << 3; row < ((page + 1) << 3); row++)
+        {
+            x1 = min(x1, m_dirty[row << 1]);
+            x2 = max(x2, m_dirty[(row << 1) + 1]);
+        }
+        if (x1 <= x2)
+        {
+            ssd1306_drawBufferFast(x + x1, y + (page << 3), x2 - x1 + 1, 8, m_buf + BANK_ADDR1(page) + x1);
+        }
+    }
+    resetDirty();
 }
 
 void NanoCanvas1::blt()
 {
-    ssd1306_drawBufferFast(offset.x, offset.y, m_w, m_h, m_buf);
+    blt(offset.x, offset.y);
 }
 
 void NanoCanvas1::blt(const NanoRect &rect)
 {
-    // TODO: NOT IMPLEMENTED
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    /* Canvas is sent to lcd by pages, so the rect is expanded to page boundaries */
+    for (lcduint_t page = rect.p1.y >> 3; page <= (lcduint_t)(rect.p2.y >> 3); page++)
+    {
+        ssd1306_drawBufferFast(offset.x + rect.p1.x, offset.y + (page << 3), rect.width(), 8,
+                               m_buf + BANK_ADDR1(page) + rect.p1.x);
+    }
 }
 
 //                 NANO CANVAS 1_8
 
 void NanoCanvas1_8::blt(lcdint_t x, lcdint_t y)
 {
-    ssd1306_drawMonoBuffer8(x, y, m_w, m_h, m_buf);
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    const uint16_t size = m_w * ((m_h + 7) >> 3);
+    /* Canvas, filled with background or foreground only, is sent as fill command */
+    if (((m_buf[0] == 0x00) || (m_buf[0] == 0xFF)) && !memcmp(m_buf, m_buf + 1, size - 1))
+        ssd1306_fillBlock8(x, y, m_w, m_h, (m_buf[0] == 0xFF) != (s_ssd1306_invertByte != 0) ? ssd1306_color : 0);
+    else
+        nanoBltMono<NanoBltMono8>(x, y, m_w, m_h, m_w, m_buf);
 }
 
 void NanoCanvas1_8::blt()
 {
-    ssd1306_drawMonoBuffer8(offset.x, offset.y, m_w, m_h, m_buf);
+    blt(offset.x, offset.y);
 }
 
 void NanoCanvas1_8::blt(const NanoRect &rect)
 {
-    // TODO: NOT IMPLEMENTED
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    nanoBltMono<NanoBltMono8>(offset.x + rect.p1.x, offset.y + rect.p1.y, rect.width(), rect.height(),
+                      m_w, m_buf + rect.p1.x, rect.p1.y);
 }
 
 //                 NANO CANVAS 1_16
 
 void NanoCanvas1_16::blt(lcdint_t x, lcdint_t y)
 {
-    ssd1306_drawMonoBuffer16(x, y, m_w, m_h, m_buf);
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    const uint16_t size = m_w * ((m_h + 7) >> 3);
+    /* Canvas, filled with background or foreground only, is sent as fill command */
+    if (((m_buf[0] == 0x00) || (m_buf[0] == 0xFF)) && !memcmp(m_buf, m_buf + 1, size - 1))
+        ssd1306_fillBlock16(x, y, m_w, m_h, (m_buf[0] == 0xFF) != (s_ssd1306_invertByte != 0) ? ssd1306_color : 0);
+    else
+        nanoBltMono<NanoBltMono16>(x, y, m_w, m_h, m_w, m_buf);
 }
 
 void NanoCanvas1_16::blt()
 {
-    ssd1306_drawMonoBuffer16(offset.x, offset.y, m_w, m_h, m_buf);
+    blt(offset.x, offset.y);
 }
 
 void NanoCanvas1_16::blt(const NanoRect &rect)
 {
-    // TODO: NOT IMPLEMENTED
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    nanoBltMono<NanoBltMono16>(offset.x + rect.p1.x, offset.y + rect.p1.y, rect.width(), rect.height(),
+                      m_w, m_buf + rect.p1.x, rect.p1.y);
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 //
-//                             8-BIT GRAPHICS
+//                             4-BIT GRAPHICS
 //
 /////////////////////////////////////////////////////////////////////////////////
 
-/* We need to use multiply operation, because there are displays on the market *
- * with resolution different from 2^N (160x128, 96x64, etc.)                   */
-#define YADDR8(y) (static_cast<uint32_t>(y) * m_w)
+/* Each line takes (width + 1) / 2 bytes, 2 pixels per byte */
+#define PITCH4 ((m_w + 1) >> 1)
+#define YADDR4(y) (static_cast<uint32_t>(y) * PITCH4)
+
+/* Writes single pixel to canvas line, low nibble is the left pixel */
+static inline void canvasPutNibble4(uint8_t *line, lcduint_t x, uint8_t color)
+{
+    uint8_t *p = &line[x >> 1];
+    if (x & 0x01)
+        *p = (*p & 0x0F) | (color << 4);
+    else
+        *p = (*p & 0xF0) | color;
+}
+
+/* Fills pixels x1..x2 of canvas line, coordinates must be already clipped */
+static void canvasFillLine4(uint8_t *line, lcduint_t x1, lcduint_t x2, uint8_t color)
+{
+    if (x1 & 0x01)
+    {
+        canvasPutNibble4(line, x1, color);
+        x1++;
+    }
+    if (x1 > x2) return;
+    if (!(x2 & 0x01))
+    {
+        canvasPutNibble4(line, x2, color);
+        if (x2 == x1) return;
+        x2--;
+    }
+    memset(&line[x1 >> 1], color | (color << 4), ((x2 - x1) >> 1) + 1);
+}
 
 template <>
-void NanoCanvasOps<8>::putPixel(lcdint_t x, lcdint_t y)
+void NanoCanvasOps<4>::putPixel(lcdint_t x, lcdint_t y)
 {
+    if (m_dirty) markDirty(x, y, x, y);
     x -= offset.x;
     y -= offset.y;
-    if ((x >= 0) && (y >= 0) && (x < (lcdint_t)m_w) && (y < (lcdint_t)m_h))
+    if (m_clip.collision({x, y}))
     {
-        m_buf[YADDR8(y) + x] = m_color;
+        canvasPutNibble4(m_buf + YADDR4(y), x, m_color & 0x0F);
     }
 }
 
 template <>
-void NanoCanvasOps<8>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
+void NanoCanvasOps<4>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 {
+    if (m_dirty) markDirty(x1, y1, x1, y2);
     x1 -= offset.x;
     y1 -= offset.y;
     y2 -= offset.y;
@@ -589,22 +1457,24 @@ void NanoCanvasOps<8>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
     {
         ssd1306_swap_data(y1, y2, lcdint_t);
     }
-    if ((x1 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    y1 = max(y1,0);
-    uint8_t *buf = m_buf + YADDR8(y1) + x1;
-    y2 = min(y2,(lcdint_t)m_h-1) - y1;
+    if (!m_clip.collisionX(x1)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    y1 = max(y1, m_clip.p1.y);
+    if (y1 > m_clip.p2.y) return;
+    uint8_t *line = m_buf + YADDR4(y1);
+    y2 = min(y2, m_clip.p2.y) - y1;
     do
     {
-        *buf = m_color;
-        buf += m_w;
+        canvasPutNibble4(line, x1, m_color & 0x0F);
+        line += PITCH4;
     }
     while (y2--);
 }
 
 template <>
-void NanoCanvasOps<8>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
+void NanoCanvasOps<4>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 {
+    if (m_dirty) markDirty(x1, y1, x2, y1);
     x1 -= offset.x;
     y1 -= offset.y;
     x2 -= offset.x;
@@ -612,21 +1482,18 @@ void NanoCanvasOps<8>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
     {
         ssd1306_swap_data(x1, x2, lcdint_t);
     }
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y1 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
-    uint8_t *buf = m_buf + YADDR8(y1) + x1;
-    for (lcdint_t x = 0; x <= x2 - x1; x++)
-    {
-        *buf = m_color;
-        buf++;
-    }
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if (!m_clip.collisionY(y1)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    if (x1 > x2) return;
+    canvasFillLine4(m_buf + YADDR4(y1), x1, x2, m_color & 0x0F);
 }
 
 template <>
-void NanoCanvasOps<8>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+void NanoCanvasOps<4>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    if (m_dirty) markDirty(x1, y1, x2, y2);
     if (y1 > y2)
     {
         ssd1306_swap_data(y1, y2, lcdint_t);
@@ -639,27 +1506,53 @@ void NanoCanvasOps<8>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
     y1 -= offset.y;
     x2 -= offset.x;
     y2 -= offset.y;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
-    y1 = max(y1,0);
-    y2 = min(y2,(lcdint_t)m_h-1);
-    uint8_t *buf = m_buf + YADDR8(y1) + x1;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    y1 = max(y1, m_clip.p1.y);
+    y2 = min(y2, m_clip.p2.y);
+    if ((x1 > x2) || (y1 > y2)) return;
+    uint8_t *line = m_buf + YADDR4(y1);
+    for (lcdint_t y = y1; y <= y2; y++)
+    {
+        canvasFillLine4(line, x1, x2, m_color & 0x0F);
+        line += PITCH4;
+    }
+}
+
+template <>
+void NanoCanvasOps<4>::invertRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    if (m_dirty) markDirty(x1, y1, x2, y2);
+    if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
+    if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
+    x1 -= offset.x;
+    x2 -= offset.x;
+    y1 -= offset.y;
+    y2 -= offset.y;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    y1 = max(y1, m_clip.p1.y);
+    y2 = min(y2, m_clip.p2.y);
+    if ((x1 > x2) || (y1 > y2)) return;
+    uint8_t *line = m_buf + YADDR4(y1);
     for (lcdint_t y = y1; y <= y2; y++)
     {
         for (lcdint_t x = x1; x <= x2; x++)
         {
-            *buf = m_color;
-            buf++;
+            line[x >> 1] ^= (x & 0x01) ? 0xF0 : 0x0F;
         }
-        buf += ((lcdint_t)(m_w) - (x2 - x1 + 1));
+        line += PITCH4;
     }
 }
 
 template <>
-void NanoCanvasOps<8>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+void NanoCanvasOps<4>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    if (m_dirty) markDirty(xpos, ypos, xpos + w - 1, ypos + h - 1);
     uint8_t offs = 0;
     /* calculate char rectangle */
     lcdint_t x1 = xpos - offset.x;
@@ -667,43 +1560,45 @@ void NanoCanvasOps<8>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
     lcdint_t x2 = x1 + (lcdint_t)w - 1;
     lcdint_t y2 = y1 + (lcdint_t)h - 1;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < m_clip.p1.x)
     {
-        bitmap -= x1;
-        x1 = 0;
+        bitmap += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < m_clip.p1.y)
     {
-        bitmap += ((lcduint_t)(-y1) >> 3) * w;
-        offs = ((-y1) & 0x07);
-        y1 = 0;
+        bitmap += ((lcduint_t)(m_clip.p1.y - y1) >> 3) * w;
+        offs = ((m_clip.p1.y - y1) & 0x07);
+        y1 = m_clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > m_clip.p2.y)
     {
-         y2 = (lcdint_t)m_h - 1;
+         y2 = m_clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > m_clip.p2.x)
     {
-         x2 = (lcdint_t)m_w - 1;
+         x2 = m_clip.p2.x;
     }
+    if ((x1 > x2) || (y1 > y2)) return;
     uint8_t offs2 = 8 - offs;
+    uint8_t color = m_color & 0x0F;
     lcdint_t y = y1;
     while ( y <= y2)
     {
         for ( lcdint_t x = x1; x <= x2; x++ )
         {
             uint8_t data = pgm_read_byte( bitmap );
-            uint16_t addr = YADDR8(y) + x;
+            uint8_t *line = m_buf + YADDR4(y);
             for (uint8_t n = 0; n < min(y2 - y + 1, 8); n++)
             {
                 if ( data & (1<<(n + offs)) )
-                    m_buf[addr] = m_color;
+                    canvasPutNibble4(line, x, color);
                 else if (!(m_textMode & CANVAS_MODE_TRANSPARENT))
-                    m_buf[addr] = 0x00;
-                addr += (lcduint_t)m_w;
+                    canvasPutNibble4(line, x, 0x00);
+                line += PITCH4;
             }
             bitmap++;
         }
@@ -715,43 +1610,47 @@ void NanoCanvasOps<8>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lc
 }
 
 template <>
-void NanoCanvasOps<8>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+void NanoCanvasOps<4>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    if (m_dirty) markDirty(x, y, x + w - 1, y + h - 1);
     x -= offset.x;
     y -= offset.y;
     lcduint_t origin_width = w;
-    if (y + (lcdint_t)h <= 0) return;
-    if (y >= (lcdint_t)m_h) return;
-    if (x + (lcdint_t)w <= 0) return;
-    if (x >= (lcdint_t)m_w)  return;
+    if (y + (lcdint_t)h <= m_clip.p1.y) return;
+    if (y > m_clip.p2.y) return;
+    if (x + (lcdint_t)w <= m_clip.p1.x) return;
+    if (x > m_clip.p2.x) return;
 
     uint8_t start_bit = 0;
     lcduint_t pitch_delta = 0;
-    if (y < 0)
+    if (y < m_clip.p1.y)
     {
-        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(-y);
-        h += y;
-        y = 0;
+        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(m_clip.p1.y - y);
+        h -= m_clip.p1.y - y;
+        y = m_clip.p1.y;
     }
-    if (x < 0)
+    if (x < m_clip.p1.x)
     {
-        bitmap += ((lcduint_t)(-x)) / 8;
-        start_bit = ((lcduint_t)(-x)) & 0x07;
-        w += x;
-        x = 0;
+        bitmap += ((lcduint_t)(m_clip.p1.x - x)) / 8;
+        start_bit = ((lcduint_t)(m_clip.p1.x - x)) & 0x07;
+        w -= m_clip.p1.x - x;
+        x = m_clip.p1.x;
     }
-    if ((lcduint_t)(y + (lcdint_t)h) > (lcduint_t)m_h)
+    if ((y > m_clip.p2.y) || (x > m_clip.p2.x)) return;
+    if (y + (lcdint_t)h > m_clip.p2.y + 1)
     {
-        h = (lcduint_t)(m_h - (lcduint_t)y);
+        h = (lcduint_t)(m_clip.p2.y + 1 - y);
     }
-    if ((lcduint_t)(x + (lcdint_t)w) > (lcduint_t)m_w)
+    if (x + (lcdint_t)w > m_clip.p2.x + 1)
     {
-        w = (lcduint_t)(m_w - (lcduint_t)x);
+        w = (lcduint_t)(m_clip.p2.x + 1 - x);
     }
-    pitch_delta = ((origin_width + 7 - start_bit) >> 3) - ((w + 7) >> 3);
+    pitch_delta = ((origin_width + 7) >> 3) - ((start_bit + w + 7) >> 3);
 
+    uint8_t color = m_color & 0x0F;
     for(lcduint_t j = 0; j < h; j++)
     {
+        uint8_t *line = m_buf + YADDR4(y + j);
         uint8_t bit = start_bit;
         for(lcduint_t i = 0; i < w; i++)
         {
@@ -759,11 +1658,11 @@ void NanoCanvasOps<8>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint
             data = (pgm_read_byte(bitmap) >> bit) & 0x01;
             if (data)
             {
-                m_buf[YADDR8(y + j) + (x + i)] = m_color;
+                canvasPutNibble4(line, x + i, color);
             }
             else if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
             {
-                m_buf[YADDR8(y + j) + (x + i)] = 0x00;
+                canvasPutNibble4(line, x + i, 0x00);
             }
             bit++;
             if (bit >= 8)
@@ -781,61 +1680,15 @@ void NanoCanvasOps<8>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint
 }
 
 template <>
-void NanoCanvasOps<8>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
-{
-    /* calculate char rectangle */
-    lcdint_t x1 = xpos - offset.x;
-    lcdint_t y1 = ypos - offset.y;
-    lcdint_t x2 = x1 + (lcdint_t)w - 1;
-    lcdint_t y2 = y1 + (lcdint_t)h - 1;
-    /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-
-    if (x1 < 0)
-    {
-        bitmap -= x1;
-        x1 = 0;
-    }
-    if (y1 < 0)
-    {
-        bitmap += (lcduint_t)(-y1) * w;
-        y1 = 0;
-    }
-    if (y2 >= (lcdint_t)m_h)
-    {
-         y2 = (lcdint_t)m_h - 1;
-    }
-    if (x2 >= (lcdint_t)m_w)
-    {
-         x2 = (lcdint_t)m_w - 1;
-    }
-    lcdint_t y = y1;
-    while ( y <= y2 )
-    {
-        for ( lcdint_t x = x1; x <= x2; x++ )
-        {
-            uint8_t data = pgm_read_byte( bitmap );
-            if ( (data) || (!(m_textMode & CANVAS_MODE_TRANSPARENT)) )
-            {
-                m_buf[YADDR8(y) + x] = data;
-            }
-            bitmap++;
-        }
-        bitmap += (w - (x2 - x1 + 1));
-        y++;
-    }
-}
-
-template <>
-void NanoCanvasOps<8u>::clear()
+void NanoCanvasOps<4>::clear()
 {
-    memset(m_buf, 0, YADDR8(m_h));
+    if (m_dirty) markDirty(offset.x, offset.y, offset.x + m_w - 1, offset.y + m_h - 1);
+    memset(m_buf, 0, YADDR4(m_h));
 }
 
 /* This method must be implemented always after clear() */
 template <>
-void NanoCanvasOps<8>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
+void NanoCanvasOps<4>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
 {
     m_w = w;
     m_h = h;
@@ -843,61 +1696,86 @@ void NanoCanvasOps<8>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
     offset.y = 0;
     m_cursorX = 0;
     m_cursorY = 0;
-    m_color = 0xFF; // white color by default
+    m_color = 0x0F; // white color by default
     m_textMode = 0;
+    m_utf8State = 0;
     m_p = 3;
     while (w >> (m_p+1)) { m_p++; };
     m_buf = bytes;
-    clear();
+    resetClip();
+    if (m_buf) clear();
 }
 
-//                NANO CANVAS 8
+//                NANO CANVAS 4
 
-void NanoCanvas8::blt(lcdint_t x, lcdint_t y)
+void NanoCanvas4::blt(lcdint_t x, lcdint_t y)
 {
-    ssd1306_drawBufferFast8(x, y, m_w, m_h, m_buf);
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    if (!m_dirty)
+    {
+        ssd1306_drawBufferFast4(x, y, m_w, m_h, m_buf);
+        return;
+    }
+    for (lcduint_t row = 0; row < m_h; )
+    {
+        lcduint_t x1, x2;
+        lcduint_t rows = dirtyRows(row, x1, x2);
+        if (x1 <= x2)
+        {
+            /* 2 pixels share single byte, so the range is extended to even columns */
+            x1 &= ~1;
+            x2 = min((lcduint_t)(x2 | 1), (lcduint_t)(m_w - 1));
+            ssd1306_drawBufferEx4(x + x1, y + row, x2 - x1 + 1, rows, PITCH4, m_buf + YADDR4(row) + (x1 >> 1));
+        }
+        row += rows;
+    }
+    resetDirty();
 }
 
-void NanoCanvas8::blt()
+void NanoCanvas4::blt()
 {
-    ssd1306_drawBufferFast8(offset.x, offset.y, m_w, m_h, m_buf);
+    blt(offset.x, offset.y);
 }
 
-void NanoCanvas8::blt(const NanoRect &rect)
+void NanoCanvas4::blt(const NanoRect &rect)
 {
-    ssd1306_drawBufferEx8(offset.x + rect.p1.x,
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    lcdint_t x1 = rect.p1.x & ~1;
+    lcdint_t x2 = min((lcdint_t)(rect.p2.x | 1), (lcdint_t)(m_w - 1));
+    ssd1306_drawBufferEx4(offset.x + x1,
                           offset.y + rect.p1.y,
-                          rect.width(),
+                          x2 - x1 + 1,
                           rect.height(),
-                          m_w,
-                          m_buf + rect.p1.x + rect.p1.y * m_w );
+                          PITCH4,
+                          m_buf + (x1 >> 1) + YADDR4(rect.p1.y) );
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 //
-//                             16-BIT GRAPHICS
+//                             8-BIT GRAPHICS
 //
 /////////////////////////////////////////////////////////////////////////////////
 
 /* We need to use multiply operation, because there are displays on the market *
  * with resolution different from 2^N (160x128, 96x64, etc.)                   */
-#define YADDR16(y) (static_cast<uint32_t>(y) * (m_w << 1))
+#define YADDR8(y) (static_cast<uint32_t>(y) * m_w)
 
 template <>
-void NanoCanvasOps<16>::putPixel(lcdint_t x, lcdint_t y)
+void NanoCanvasOps<8>::putPixel(lcdint_t x, lcdint_t y)
 {
+    if (m_dirty) markDirty(x, y, x, y);
     x -= offset.x;
     y -= offset.y;
-    if ((x >= 0) && (y >= 0) && (x < (lcdint_t)m_w) && (y < (lcdint_t)m_h))
+    if (m_clip.collision({x, y}))
     {
-        m_buf[YADDR16(y) + (x<<1)] = m_color >> 8;
-        m_buf[YADDR16(y) + (x<<1) + 1] = m_color & 0xFF;
+        m_buf[YADDR8(y) + x] = m_color;
     }
 }
 
 template <>
-void NanoCanvasOps<16>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
+void NanoCanvasOps<8>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 {
+    if (m_dirty) markDirty(x1, y1, x1, y2);
     x1 -= offset.x;
     y1 -= offset.y;
     y2 -= offset.y;
@@ -905,23 +1783,24 @@ void NanoCanvasOps<16>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
     {
         ssd1306_swap_data(y1, y2, lcdint_t);
     }
-    if ((x1 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    y1 = max(y1,0);
-    uint8_t *buf = m_buf + YADDR16(y1) + (x1 << 1);
-    y2 = min(y2,(lcdint_t)m_h-1) - y1;
+    if (!m_clip.collisionX(x1)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    y1 = max(y1, m_clip.p1.y);
+    if (y1 > m_clip.p2.y) return;
+    uint8_t *buf = m_buf + YADDR8(y1) + x1;
+    y2 = min(y2, m_clip.p2.y) - y1;
     do
     {
-        buf[0] = m_color >> 8;
-        buf[1] = m_color & 0xFF;
-        buf += (m_w<<1);
+        *buf = m_color;
+        buf += m_w;
     }
     while (y2--);
 }
 
 template <>
-void NanoCanvasOps<16>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
+void NanoCanvasOps<8>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 {
+    if (m_dirty) markDirty(x1, y1, x2, y1);
     x1 -= offset.x;
     y1 -= offset.y;
     x2 -= offset.x;
@@ -929,22 +1808,19 @@ void NanoCanvasOps<16>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
     {
         ssd1306_swap_data(x1, x2, lcdint_t);
     }
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y1 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
-    uint8_t *buf = m_buf + YADDR16(y1) + (x1<<1);
-    for (lcdint_t x = 0; x <= x2 - x1; x++)
-    {
-        buf[0] = m_color >> 8;
-        buf[1] = m_color & 0xFF;
-        buf+=2;
-    }
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if (!m_clip.collisionY(y1)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    if (x1 > x2) return;
+    uint8_t *buf = m_buf + YADDR8(y1) + x1;
+    memset(buf, m_color, x2 - x1 + 1);
 }
 
 template <>
-void NanoCanvasOps<16>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+void NanoCanvasOps<8>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    if (m_dirty) markDirty(x1, y1, x2, y2);
     if (y1 > y2)
     {
         ssd1306_swap_data(y1, y2, lcdint_t);
@@ -957,28 +1833,53 @@ void NanoCanvasOps<16>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t
     y1 -= offset.y;
     x2 -= offset.x;
     y2 -= offset.y;
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
-    x1 = max(x1,0);
-    x2 = min(x2,(lcdint_t)m_w-1);
-    y1 = max(y1,0);
-    y2 = min(y2,(lcdint_t)m_h-1);
-    uint8_t *buf = m_buf + YADDR16(y1) + (x1<<1);
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    y1 = max(y1, m_clip.p1.y);
+    y2 = min(y2, m_clip.p2.y);
+    if ((x1 > x2) || (y1 > y2)) return;
+    uint8_t *buf = m_buf + YADDR8(y1) + x1;
     for (lcdint_t y = y1; y <= y2; y++)
     {
-        for (lcdint_t x = x1; x <= x2; x++)
+        memset(buf, m_color, x2 - x1 + 1);
+        buf += m_w;
+    }
+}
+
+template <>
+void NanoCanvasOps<8>::invertRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    if (m_dirty) markDirty(x1, y1, x2, y2);
+    if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
+    if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
+    x1 -= offset.x;
+    x2 -= offset.x;
+    y1 -= offset.y;
+    y2 -= offset.y;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    y1 = max(y1, m_clip.p1.y);
+    y2 = min(y2, m_clip.p2.y);
+    if ((x1 > x2) || (y1 > y2)) return;
+    uint8_t *buf = m_buf + YADDR8(y1) + x1;
+    for (lcdint_t y = y1; y <= y2; y++)
+    {
+        for (lcdint_t x = 0; x <= x2 - x1; x++)
         {
-            buf[0] = m_color >> 8;
-            buf[1] = m_color & 0xFF;
-            buf+=2;
+            buf[x] ^= 0xFF;
         }
-        buf += ( ((lcdint_t)(m_w) - (x2 - x1 + 1)) <<1 );
+        buf += m_w;
     }
 }
 
 template <>
-void NanoCanvasOps<16>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+void NanoCanvasOps<8>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    if (m_dirty) markDirty(xpos, ypos, xpos + w - 1, ypos + h - 1);
     uint8_t offs = 0;
     /* calculate char rectangle */
     lcdint_t x1 = xpos - offset.x;
@@ -986,28 +1887,29 @@ void NanoCanvasOps<16>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, l
     lcdint_t x2 = x1 + (lcdint_t)w - 1;
     lcdint_t y2 = y1 + (lcdint_t)h - 1;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < m_clip.p1.x)
     {
-        bitmap -= x1;
-        x1 = 0;
+        bitmap += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < m_clip.p1.y)
     {
-        bitmap += ((lcduint_t)(-y1) >> 3) * w;
-        offs = ((-y1) & 0x07);
-        y1 = 0;
+        bitmap += ((lcduint_t)(m_clip.p1.y - y1) >> 3) * w;
+        offs = ((m_clip.p1.y - y1) & 0x07);
+        y1 = m_clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > m_clip.p2.y)
     {
-         y2 = (lcdint_t)m_h - 1;
+         y2 = m_clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > m_clip.p2.x)
     {
-         x2 = (lcdint_t)m_w - 1;
+         x2 = m_clip.p2.x;
     }
+    if ((x1 > x2) || (y1 > y2)) return;
     uint8_t offs2 = 8 - offs;
     lcdint_t y = y1;
     while ( y <= y2)
@@ -1015,20 +1917,14 @@ void NanoCanvasOps<16>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, l
         for ( lcdint_t x = x1; x <= x2; x++ )
         {
             uint8_t data = pgm_read_byte( bitmap );
-            uint16_t addr = YADDR16(y) + (x<<1);
+            uint16_t addr = YADDR8(y) + x;
             for (uint8_t n = 0; n < min(y2 - y + 1, 8); n++)
             {
                 if ( data & (1<<(n + offs)) )
-                {
-                    m_buf[addr] = m_color >> 8;
-                    m_buf[addr+1] = m_color & 0xFF;
-                }
+                    m_buf[addr] = m_color;
                 else if (!(m_textMode & CANVAS_MODE_TRANSPARENT))
-                {
                     m_buf[addr] = 0x00;
-                    m_buf[addr+1] = 0x00;
-                }
-                addr += ((lcduint_t)m_w << 1);
+                addr += (lcduint_t)m_w;
             }
             bitmap++;
         }
@@ -1040,40 +1936,42 @@ void NanoCanvasOps<16>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, l
 }
 
 template <>
-void NanoCanvasOps<16>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+void NanoCanvasOps<8>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    if (m_dirty) markDirty(x, y, x + w - 1, y + h - 1);
     x -= offset.x;
     y -= offset.y;
     lcduint_t origin_width = w;
-    if (y + (lcdint_t)h <= 0) return;
-    if (y >= (lcdint_t)m_h) return;
-    if (x + (lcdint_t)w <= 0) return;
-    if (x >= (lcdint_t)m_w)  return;
+    if (y + (lcdint_t)h <= m_clip.p1.y) return;
+    if (y > m_clip.p2.y) return;
+    if (x + (lcdint_t)w <= m_clip.p1.x) return;
+    if (x > m_clip.p2.x) return;
 
     uint8_t start_bit = 0;
     lcduint_t pitch_delta = 0;
-    if (y < 0)
+    if (y < m_clip.p1.y)
     {
-        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(-y);
-        h += y;
-        y = 0;
+        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(m_clip.p1.y - y);
+        h -= m_clip.p1.y - y;
+        y = m_clip.p1.y;
     }
-    if (x < 0)
+    if (x < m_clip.p1.x)
     {
-        bitmap += ((lcduint_t)(-x)) / 8;
-        start_bit = ((lcduint_t)(-x)) & 0x07;
-        w += x;
-        x = 0;
+        bitmap += ((lcduint_t)(m_clip.p1.x - x)) / 8;
+        start_bit = ((lcduint_t)(m_clip.p1.x - x)) & 0x07;
+        w -= m_clip.p1.x - x;
+        x = m_clip.p1.x;
     }
-    if ((lcduint_t)(y + (lcdint_t)h) > (lcduint_t)m_h)
+    if ((y > m_clip.p2.y) || (x > m_clip.p2.x)) return;
+    if (y + (lcdint_t)h > m_clip.p2.y + 1)
     {
-        h = (lcduint_t)(m_h - (lcduint_t)y);
+        h = (lcduint_t)(m_clip.p2.y + 1 - y);
     }
-    if ((lcduint_t)(x + (lcdint_t)w) > (lcduint_t)m_w)
+    if (x + (lcdint_t)w > m_clip.p2.x + 1)
     {
-        w = (lcduint_t)(m_w - (lcduint_t)x);
+        w = (lcduint_t)(m_clip.p2.x + 1 - x);
     }
-    pitch_delta = ((origin_width + 7 - start_bit) >> 3) - ((w + 7) >> 3);
+    pitch_delta = ((origin_width + 7) >> 3) - ((start_bit + w + 7) >> 3);
 
     for(lcduint_t j = 0; j < h; j++)
     {
@@ -1084,13 +1982,11 @@ void NanoCanvasOps<16>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduin
             data = (pgm_read_byte(bitmap) >> bit) & 0x01;
             if (data)
             {
-                m_buf[YADDR16(y + j) + ((x + i)<<1)] = m_color >> 8;
-                m_buf[YADDR16(y + j) + ((x + i)<<1) + 1] = m_color & 0xFF;
+                m_buf[YADDR8(y + j) + (x + i)] = m_color;
             }
             else if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
             {
-                m_buf[YADDR16(y + j) + ((x + i)<<1)] = 0x00;
-                m_buf[YADDR16(y + j) + ((x + i)<<1) + 1] = 0x00;
+                m_buf[YADDR8(y + j) + (x + i)] = 0x00;
             }
             bit++;
             if (bit >= 8)
@@ -1108,63 +2004,130 @@ void NanoCanvasOps<16>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduin
 }
 
 template <>
-void NanoCanvasOps<16>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+void NanoCanvasOps<8>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
+    if (m_dirty) markDirty(xpos, ypos, xpos + w - 1, ypos + h - 1);
     /* calculate char rectangle */
     lcdint_t x1 = xpos - offset.x;
     lcdint_t y1 = ypos - offset.y;
     lcdint_t x2 = x1 + (lcdint_t)w - 1;
     lcdint_t y2 = y1 + (lcdint_t)h - 1;
     /* clip bitmap */
-    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
-    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
 
-    if (x1 < 0)
+    if (x1 < m_clip.p1.x)
     {
-        bitmap -= x1;
-        x1 = 0;
+        bitmap += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
     }
-    if (y1 < 0)
+    if (y1 < m_clip.p1.y)
     {
-        bitmap += (lcduint_t)(-y1) * w;
-        y1 = 0;
+        bitmap += (lcduint_t)(m_clip.p1.y - y1) * w;
+        y1 = m_clip.p1.y;
     }
-    if (y2 >= (lcdint_t)m_h)
+    if (y2 > m_clip.p2.y)
     {
-         y2 = (lcdint_t)m_h - 1;
+         y2 = m_clip.p2.y;
     }
-    if (x2 >= (lcdint_t)m_w)
+    if (x2 > m_clip.p2.x)
     {
-         x2 = (lcdint_t)m_w - 1;
+         x2 = m_clip.p2.x;
     }
+    if ((x1 > x2) || (y1 > y2)) return;
+    const lcduint_t width = x2 - x1 + 1;
     lcdint_t y = y1;
     while ( y <= y2 )
     {
-        for ( lcdint_t x = x1; x <= x2; x++ )
+        uint8_t *dst = &m_buf[YADDR8(y) + x1];
+        lcduint_t x = 0;
+#if defined(CONFIG_SIMD_AVAILABLE)
+        if ( !(m_textMode & CANVAS_MODE_TRANSPARENT) )
         {
-            uint8_t data = pgm_read_byte( bitmap );
+            memcpy( dst, bitmap, width );
+            x = width;
+        }
+        for (; x + 16 <= width; x += 16)
+        {
+            simd_copyTransparent8( dst + x, bitmap + x );
+        }
+#endif
+        for (; x < width; x++)
+        {
+            uint8_t data = pgm_read_byte( &bitmap[x] );
             if ( (data) || (!(m_textMode & CANVAS_MODE_TRANSPARENT)) )
             {
-                uint16_t color = (((uint16_t)data & 0b11100000) << 8) |
-                                 (((uint16_t)data & 0b00011100) << 6) |
-                                 (((uint16_t)data & 0b00000011) << 3);
-                m_buf[YADDR16(y) + (x<<1)] = color;
+                dst[x] = data;
             }
-            bitmap++;
         }
-        bitmap += (w - (x2 - x1 + 1));
+        bitmap += w;
         y++;
     }
 }
 
 template <>
-void NanoCanvasOps<16>::clear()
+void NanoCanvasOps<8>::drawKeyedBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h,
+                                        const uint8_t *bitmap, uint8_t key)
 {
-    memset(m_buf, 0, YADDR16(m_h));
+    if (m_dirty) markDirty(xpos, ypos, xpos + w - 1, ypos + h - 1);
+    lcdint_t x1 = xpos - offset.x;
+    lcdint_t y1 = ypos - offset.y;
+    lcdint_t x2 = x1 + (lcdint_t)w - 1;
+    lcdint_t y2 = y1 + (lcdint_t)h - 1;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    if (x1 < m_clip.p1.x)
+    {
+        bitmap += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
+    }
+    if (y1 < m_clip.p1.y)
+    {
+        bitmap += (lcduint_t)(m_clip.p1.y - y1) * w;
+        y1 = m_clip.p1.y;
+    }
+    if (y2 > m_clip.p2.y) y2 = m_clip.p2.y;
+    if (x2 > m_clip.p2.x) x2 = m_clip.p2.x;
+    if ((x1 > x2) || (y1 > y2)) return;
+    const lcduint_t width = x2 - x1 + 1;
+    for ( lcdint_t y = y1; y <= y2; y++, bitmap += w )
+    {
+        uint8_t *dst = &m_buf[YADDR8(y) + x1];
+        lcduint_t x = 0;
+#ifdef CANVAS_WORD_OPS
+        /* 4 pixels at once: bytes, equal to key, are found without branches */
+        const uint32_t keys = CANVAS_WORD(key);
+        for ( ; x + sizeof(canvas_word_t) <= width; x += sizeof(canvas_word_t) )
+        {
+            uint32_t src = canvasReadWord1(bitmap + x);
+            uint32_t diff = src ^ keys;
+            /* 0x80 in each byte, which is equal to key */
+            uint32_t same = ~(((diff & 0x7F7F7F7FUL) + 0x7F7F7F7FUL) | diff | 0x7F7F7F7FUL);
+            uint32_t keep = (same >> 7) * 0xFF;
+            uint32_t data;
+            memcpy(&data, dst + x, sizeof(data));
+            data = (data & keep) | (src & ~keep);
+            memcpy(dst + x, &data, sizeof(data));
+        }
+#endif
+        for ( ; x < width; x++ )
+        {
+            uint8_t color = pgm_read_byte(&bitmap[x]);
+            if (color != key) dst[x] = color;
+        }
+    }
 }
 
 template <>
-void NanoCanvasOps<16>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
+void NanoCanvasOps<8u>::clear()
+{
+    if (m_dirty) markDirty(offset.x, offset.y, offset.x + m_w - 1, offset.y + m_h - 1);
+    memset(m_buf, 0, YADDR8(m_h));
+}
+
+/* This method must be implemented always after clear() */
+template <>
+void NanoCanvasOps<8>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
 {
     m_w = w;
     m_h = h;
@@ -1172,44 +2135,1466 @@ void NanoCanvasOps<16>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
     offset.y = 0;
     m_cursorX = 0;
     m_cursorY = 0;
-    m_color = 0xFFFF; // white color by default
+    m_color = 0xFF; // white color by default
     m_textMode = 0;
+    m_utf8State = 0;
     m_p = 3;
     while (w >> (m_p+1)) { m_p++; };
-    m_p++;
     m_buf = bytes;
-    clear();
+    resetClip();
+    if (m_buf) clear();
+}
+
+//                NANO CANVAS 8
+
+void NanoCanvas8::blt(lcdint_t x, lcdint_t y)
+{
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    if (!m_dirty)
+    {
+        /* Uniform canvas (empty tile usually) is sent as fill command without pixel data */
+        if (!memcmp(m_buf, m_buf + 1, (uint32_t)m_w * m_h - 1))
+            ssd1306_fillBlock8(x, y, m_w, m_h, m_buf[0]);
+        else
+            ssd1306_drawBufferFast8(x, y, m_w, m_h, m_buf);
+        return;
+    }
+    for (lcduint_t row = 0; row < m_h; )
+    {
+        lcduint_t x1, x2;
+        lcduint_t rows = dirtyRows(row, x1, x2);
+        if (x1 <= x2)
+        {
+            ssd1306_drawBufferEx8(x + x1, y + row, x2 - x1 + 1, rows, m_w, m_buf + YADDR8(row) + x1);
+        }
+        row += rows;
+    }
+    resetDirty();
+}
+
+void NanoCanvas8::blt()
+{
+    blt(offset.x, offset.y);
+}
+
+void NanoCanvas8::blt(const NanoRect &rect)
+{
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    ssd1306_drawBufferEx8(offset.x + rect.p1.x,
+                          offset.y + rect.p1.y,
+                          rect.width(),
+                          rect.height(),
+                          m_w,
+                          m_buf + rect.p1.x + rect.p1.y * m_w );
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 //
-//                      NanoCanvasOps class initiation
+//                             16-BIT GRAPHICS
 //
 /////////////////////////////////////////////////////////////////////////////////
 
-template class NanoCanvasOps<1>;
-template class NanoCanvasOps<8>;
-template class NanoCanvasOps<16>;
+/* We need to use multiply operation, because there are displays on the market *
+ * with resolution different from 2^N (160x128, 96x64, etc.)                   */
+#define YADDR16(y) (static_cast<uint32_t>(y) * (m_w << 1))
 
+/* Fills count pixels starting at buf. Canvas keeps pixels in display byte order *
+ * (high byte first), so the color is swapped once per call, not per pixel.     */
+static void canvasFillPixels16(uint8_t *buf, uint32_t count, uint16_t color)
+{
+    uint8_t hi = color >> 8;
+    uint8_t lo = color & 0xFF;
+    if ( hi == lo )
+    {
+        memset(buf, hi, count << 1);
+        return;
+    }
+#if defined(CONFIG_SIMD_AVAILABLE)
+    for (; count >= SIMD_PIXELS; count -= SIMD_PIXELS)
+    {
+        simd_fill16(buf, hi | (lo << 8));
+        buf += SIMD_PIXELS << 1;
+    }
+#endif
+#if !defined(__AVR__)
+    /* 32-bit cores store 2 pixels at once, buffer must be at least 16-bit aligned */
+    if ( !(reinterpret_cast<uintptr_t>(buf) & 0x01) )
+    {
+        const uint8_t pattern[4] = { hi, lo, hi, lo };
+        if ( (reinterpret_cast<uintptr_t>(buf) & 0x02) && count )
+        {
+            buf[0] = hi;
+            buf[1] = lo;
+            buf += 2;
+            count--;
+        }
+        uint32_t word;
+        memcpy(&word, pattern, sizeof(word));
+        uint32_t *p = reinterpret_cast<uint32_t *>(buf);
+        for (; count >= 2; count -= 2)
+        {
+            *p++ = word;
+        }
+        buf = reinterpret_cast<uint8_t *>(p);
+    }
+#endif
+    while (count--)
+    {
+        *buf++ = hi;
+        *buf++ = lo;
+    }
+}
 
-//              NANO CANVAS 16
+template <>
+void NanoCanvasOps<16>::putPixel(lcdint_t x, lcdint_t y)
+{
+    if (m_dirty) markDirty(x, y, x, y);
+    x -= offset.x;
+    y -= offset.y;
+    if (m_clip.collision({x, y}))
+    {
+        uint8_t *buf = m_buf + YADDR16(y) + (x<<1);
+        buf[0] = m_color >> 8;
+        buf[1] = m_color & 0xFF;
+    }
+}
 
-void NanoCanvas16::blt(lcdint_t x, lcdint_t y)
+template <>
+void NanoCanvasOps<16>::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
 {
-    ssd1306_drawBufferFast16(x, y, m_w, m_h, m_buf);
+    if (m_dirty) markDirty(x1, y1, x1, y2);
+    x1 -= offset.x;
+    y1 -= offset.y;
+    y2 -= offset.y;
+    if (y1 > y2)
+    {
+        ssd1306_swap_data(y1, y2, lcdint_t);
+    }
+    if (!m_clip.collisionX(x1)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    y1 = max(y1, m_clip.p1.y);
+    if (y1 > m_clip.p2.y) return;
+    uint8_t *buf = m_buf + YADDR16(y1) + (x1 << 1);
+    const uint8_t hi = m_color >> 8;
+    const uint8_t lo = m_color & 0xFF;
+    const lcduint_t pitch = m_w << 1;
+    y2 = min(y2, m_clip.p2.y) - y1;
+    do
+    {
+        buf[0] = hi;
+        buf[1] = lo;
+        buf += pitch;
+    }
+    while (y2--);
 }
 
-void NanoCanvas16::blt()
+template <>
+void NanoCanvasOps<16>::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
+{
+    if (m_dirty) markDirty(x1, y1, x2, y1);
+    x1 -= offset.x;
+    y1 -= offset.y;
+    x2 -= offset.x;
+    if (x1 > x2)
+    {
+        ssd1306_swap_data(x1, x2, lcdint_t);
+    }
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if (!m_clip.collisionY(y1)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    if (x1 > x2) return;
+    canvasFillPixels16(m_buf + YADDR16(y1) + (x1<<1), x2 - x1 + 1, m_color);
+}
+
+template <>
+void NanoCanvasOps<16>::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
-    ssd1306_drawBufferFast16(offset.x, offset.y, m_w, m_h, m_buf);
+    if (m_dirty) markDirty(x1, y1, x2, y2);
+    if (y1 > y2)
+    {
+        ssd1306_swap_data(y1, y2, lcdint_t);
+    }
+    if (x1 > x2)
+    {
+        ssd1306_swap_data(x1, x2, lcdint_t);
+    }
+    x1 -= offset.x;
+    y1 -= offset.y;
+    x2 -= offset.x;
+    y2 -= offset.y;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    y1 = max(y1, m_clip.p1.y);
+    y2 = min(y2, m_clip.p2.y);
+    if ((x1 > x2) || (y1 > y2)) return;
+    uint8_t *buf = m_buf + YADDR16(y1) + (x1<<1);
+    uint32_t width = x2 - x1 + 1;
+    if ( width == m_w )
+    {
+        /* Full canvas lines are continuous block in the buffer */
+        canvasFillPixels16(buf, width * (uint32_t)(y2 - y1 + 1), m_color);
+        return;
+    }
+    for (lcdint_t y = y1; y <= y2; y++)
+    {
+        canvasFillPixels16(buf, width, m_color);
+        buf += (lcduint_t)m_w << 1;
+    }
 }
 
-void NanoCanvas16::blt(const NanoRect &rect)
+template <>
+void NanoCanvasOps<16>::invertRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
-    ssd1306_drawBufferEx16(offset.x + rect.p1.x,
-                           offset.y + rect.p1.y,
-                           rect.width(),
-                           rect.height(),
-                           m_w<<1,
-                           m_buf + (rect.p1.x<<1) + rect.p1.y * (m_w<<1) );
+    if (m_dirty) markDirty(x1, y1, x2, y2);
+    if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
+    if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
+    x1 -= offset.x;
+    x2 -= offset.x;
+    y1 -= offset.y;
+    y2 -= offset.y;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    x1 = max(x1, m_clip.p1.x);
+    x2 = min(x2, m_clip.p2.x);
+    y1 = max(y1, m_clip.p1.y);
+    y2 = min(y2, m_clip.p2.y);
+    if ((x1 > x2) || (y1 > y2)) return;
+    uint8_t *buf = m_buf + YADDR16(y1) + (x1 << 1);
+    for (lcdint_t y = y1; y <= y2; y++)
+    {
+        for (lcdint_t x = 0; x < ((x2 - x1 + 1) << 1); x++)
+        {
+            buf[x] ^= 0xFF;
+        }
+        buf += (lcduint_t)m_w << 1;
+    }
+}
+
+template <>
+void NanoCanvasOps<16>::drawBitmap1(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    if (m_dirty) markDirty(xpos, ypos, xpos + w - 1, ypos + h - 1);
+    uint8_t offs = 0;
+    /* calculate char rectangle */
+    lcdint_t x1 = xpos - offset.x;
+    lcdint_t y1 = ypos - offset.y;
+    lcdint_t x2 = x1 + (lcdint_t)w - 1;
+    lcdint_t y2 = y1 + (lcdint_t)h - 1;
+    /* clip bitmap */
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+
+    if (x1 < m_clip.p1.x)
+    {
+        bitmap += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
+    }
+    if (y1 < m_clip.p1.y)
+    {
+        bitmap += ((lcduint_t)(m_clip.p1.y - y1) >> 3) * w;
+        offs = ((m_clip.p1.y - y1) & 0x07);
+        y1 = m_clip.p1.y;
+    }
+    if (y2 > m_clip.p2.y)
+    {
+         y2 = m_clip.p2.y;
+    }
+    if (x2 > m_clip.p2.x)
+    {
+         x2 = m_clip.p2.x;
+    }
+    if ((x1 > x2) || (y1 > y2)) return;
+    uint8_t offs2 = 8 - offs;
+    lcdint_t y = y1;
+    while ( y <= y2)
+    {
+        for ( lcdint_t x = x1; x <= x2; x++ )
+        {
+            uint8_t data = pgm_read_byte( bitmap );
+            uint16_t addr = YADDR16(y) + (x<<1);
+            for (uint8_t n = 0; n < min(y2 - y + 1, 8); n++)
+            {
+                if ( data & (1<<(n + offs)) )
+                {
+                    m_buf[addr] = m_color >> 8;
+                    m_buf[addr+1] = m_color & 0xFF;
+                }
+                else if (!(m_textMode & CANVAS_MODE_TRANSPARENT))
+                {
+                    m_buf[addr] = 0x00;
+                    m_buf[addr+1] = 0x00;
+                }
+                addr += ((lcduint_t)m_w << 1);
+            }
+            bitmap++;
+        }
+        bitmap += (w - (x2 - x1 + 1));
+        y = y + offs2;
+        offs = 0;
+        offs2 = 8;
+    }
+}
+
+template <>
+void NanoCanvasOps<16>::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    if (m_dirty) markDirty(x, y, x + w - 1, y + h - 1);
+    x -= offset.x;
+    y -= offset.y;
+    lcduint_t origin_width = w;
+    if (y + (lcdint_t)h <= m_clip.p1.y) return;
+    if (y > m_clip.p2.y) return;
+    if (x + (lcdint_t)w <= m_clip.p1.x) return;
+    if (x > m_clip.p2.x) return;
+
+    uint8_t start_bit = 0;
+    lcduint_t pitch_delta = 0;
+    if (y < m_clip.p1.y)
+    {
+        bitmap += /*pitch*/((origin_width + 7) >> 3) * (lcduint_t)(m_clip.p1.y - y);
+        h -= m_clip.p1.y - y;
+        y = m_clip.p1.y;
+    }
+    if (x < m_clip.p1.x)
+    {
+        bitmap += ((lcduint_t)(m_clip.p1.x - x)) / 8;
+        start_bit = ((lcduint_t)(m_clip.p1.x - x)) & 0x07;
+        w -= m_clip.p1.x - x;
+        x = m_clip.p1.x;
+    }
+    if ((y > m_clip.p2.y) || (x > m_clip.p2.x)) return;
+    if (y + (lcdint_t)h > m_clip.p2.y + 1)
+    {
+        h = (lcduint_t)(m_clip.p2.y + 1 - y);
+    }
+    if (x + (lcdint_t)w > m_clip.p2.x + 1)
+    {
+        w = (lcduint_t)(m_clip.p2.x + 1 - x);
+    }
+    pitch_delta = ((origin_width + 7) >> 3) - ((start_bit + w + 7) >> 3);
+
+    for(lcduint_t j = 0; j < h; j++)
+    {
+        uint8_t bit = start_bit;
+        for(lcduint_t i = 0; i < w; i++)
+        {
+            uint8_t data = 0;
+            data = (pgm_read_byte(bitmap) >> bit) & 0x01;
+            if (data)
+            {
+                m_buf[YADDR16(y + j) + ((x + i)<<1)] = m_color >> 8;
+                m_buf[YADDR16(y + j) + ((x + i)<<1) + 1] = m_color & 0xFF;
+            }
+            else if (CANVAS_MODE_TRANSPARENT != (m_textMode & CANVAS_MODE_TRANSPARENT))
+            {
+                m_buf[YADDR16(y + j) + ((x + i)<<1)] = 0x00;
+                m_buf[YADDR16(y + j) + ((x + i)<<1) + 1] = 0x00;
+            }
+            bit++;
+            if (bit >= 8)
+            {
+                bitmap++;
+                bit=0;
+            }
+        }
+        if (bit)
+        {
+            bitmap++;
+        }
+        bitmap += pitch_delta;
+    }
+}
+
+template <>
+void NanoCanvasOps<16>::drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    if (m_dirty) markDirty(xpos, ypos, xpos + w - 1, ypos + h - 1);
+    /* calculate char rectangle */
+    lcdint_t x1 = xpos - offset.x;
+    lcdint_t y1 = ypos - offset.y;
+    lcdint_t x2 = x1 + (lcdint_t)w - 1;
+    lcdint_t y2 = y1 + (lcdint_t)h - 1;
+    /* clip bitmap */
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+
+    if (x1 < m_clip.p1.x)
+    {
+        bitmap += m_clip.p1.x - x1;
+        x1 = m_clip.p1.x;
+    }
+    if (y1 < m_clip.p1.y)
+    {
+        bitmap += (lcduint_t)(m_clip.p1.y - y1) * w;
+        y1 = m_clip.p1.y;
+    }
+    if (y2 > m_clip.p2.y)
+    {
+         y2 = m_clip.p2.y;
+    }
+    if (x2 > m_clip.p2.x)
+    {
+         x2 = m_clip.p2.x;
+    }
+    if ((x1 > x2) || (y1 > y2)) return;
+    lcdint_t y = y1;
+    while ( y <= y2 )
+    {
+        lcdint_t x = x1;
+#if defined(CONFIG_SIMD_AVAILABLE)
+        if ( !(m_textMode & CANVAS_MODE_TRANSPARENT) )
+        {
+            for (; x + SIMD_PIXELS - 1 <= x2; x += SIMD_PIXELS)
+            {
+                simd_rgb8To16( &m_buf[YADDR16(y) + (x<<1)], bitmap );
+                bitmap += SIMD_PIXELS;
+            }
+        }
+#endif
+        for (; x <= x2; x++ )
+        {
+            uint8_t data = pgm_read_byte( bitmap );
+            if ( (data) || (!(m_textMode & CANVAS_MODE_TRANSPARENT)) )
+            {
+                uint16_t color = (((uint16_t)data & 0b11100000) << 8) |
+                                 (((uint16_t)data & 0b00011100) << 6) |
+                                 (((uint16_t)data & 0b00000011) << 3);
+                m_buf[YADDR16(y) + (x<<1)] = color >> 8;
+                m_buf[YADDR16(y) + (x<<1) + 1] = color & 0xFF;
+            }
+            bitmap++;
+        }
+        bitmap += (w - (x2 - x1 + 1));
+        y++;
+    }
+}
+
+template <>
+void NanoCanvasOps<16>::clear()
+{
+    if (m_dirty) markDirty(offset.x, offset.y, offset.x + m_w - 1, offset.y + m_h - 1);
+    memset(m_buf, 0, YADDR16(m_h));
+}
+
+template <>
+void NanoCanvasOps<16>::begin(lcdint_t w, lcdint_t h, uint8_t *bytes)
+{
+    m_w = w;
+    m_h = h;
+    offset.x = 0;
+    offset.y = 0;
+    m_cursorX = 0;
+    m_cursorY = 0;
+    m_color = 0xFFFF; // white color by default
+    m_textMode = 0;
+    m_utf8State = 0;
+    m_p = 3;
+    while (w >> (m_p+1)) { m_p++; };
+    m_p++;
+    m_buf = bytes;
+    resetClip();
+    if (m_buf) clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                      1-BIT MEMORY-MAPPED FRAMEBUFFER
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+void NanoCanvasVga1::begin(lcduint_t w, lcduint_t h, uint8_t *buffer)
+{
+    m_w = w;
+    m_h = h;
+    m_pitch = w >> 3;
+    m_buf = buffer;
+    m_cursorX = 0;
+    m_cursorY = 0;
+    m_color = WHITE;
+    m_textMode = 0;
+    m_utf8State = 0;
+    offset.x = 0;
+    offset.y = 0;
+}
+
+inline void NanoCanvasVga1::setPixel(lcduint_t x, lcduint_t y, uint8_t on)
+{
+    uint8_t *p = &m_buf[(x >> 3) + y * m_pitch];
+    uint8_t mask = 1 << (x & 0x07);
+    if (on) *p |= mask; else *p &= ~mask;
+}
+
+void NanoCanvasVga1::putPixel(lcdint_t x, lcdint_t y)
+{
+    x -= offset.x;
+    y -= offset.y;
+    if ((x < 0) || (y < 0) || (x >= (lcdint_t)m_w) || (y >= (lcdint_t)m_h)) return;
+    setPixel(x, y, m_color);
+}
+
+void NanoCanvasVga1::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
+{
+    fillRect(x1, y1, x2, y1);
+}
+
+void NanoCanvasVga1::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
+{
+    if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
+    x1 -= offset.x;
+    y1 -= offset.y;
+    y2 -= offset.y;
+    if ((x1 < 0) || (x1 >= (lcdint_t)m_w)) return;
+    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    y1 = max(0, y1);
+    y2 = min(y2, (lcdint_t)(m_h - 1));
+    uint8_t *p = &m_buf[(x1 >> 3) + y1 * m_pitch];
+    uint8_t mask = 1 << (x1 & 0x07);
+    for (lcdint_t y = y1; y <= y2; y++)
+    {
+        if (m_color) *p |= mask; else *p &= ~mask;
+        p += m_pitch;
+    }
+}
+
+void NanoCanvasVga1::drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    if (y1 == y2)
+    {
+        drawHLine(x1, y1, x2);
+        return;
+    }
+    if (x1 == x2)
+    {
+        drawVLine(x1, y1, y2);
+        return;
+    }
+    lcdint_t dx = x1 > x2 ? (x1 - x2): (x2 - x1);
+    lcdint_t dy = y1 > y2 ? (y2 - y1): (y1 - y2);
+    lcdint_t sx = x1 < x2 ? 1 : -1;
+    lcdint_t sy = y1 < y2 ? 1 : -1;
+    lcdint_t err = dx + dy;
+    for (;;)
+    {
+        putPixel(x1, y1);
+        if ((x1 == x2) && (y1 == y2)) break;
+        lcdint_t e2 = err << 1;
+        if (e2 >= dy) { err += dy; x1 += sx; }
+        if (e2 <= dx) { err += dx; y1 += sy; }
+    }
+}
+
+void NanoCanvasVga1::drawRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    drawHLine(x1, y1, x2);
+    drawHLine(x1, y2, x2);
+    drawVLine(x1, y1, y2);
+    drawVLine(x2, y1, y2);
+}
+
+void NanoCanvasVga1::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
+    if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
+    x1 -= offset.x;
+    x2 -= offset.x;
+    y1 -= offset.y;
+    y2 -= offset.y;
+    if ((x2 < 0) || (x1 >= (lcdint_t)m_w)) return;
+    if ((y2 < 0) || (y1 >= (lcdint_t)m_h)) return;
+    x1 = max(0, x1);
+    x2 = min(x2, (lcdint_t)(m_w - 1));
+    y1 = max(0, y1);
+    y2 = min(y2, (lcdint_t)(m_h - 1));
+    /* Each row consists of partially covered first and last bytes and fully covered bytes between */
+    lcduint_t first = x1 >> 3;
+    lcduint_t last = x2 >> 3;
+    uint8_t firstMask = 0xFF << (x1 & 0x07);
+    uint8_t lastMask = 0xFF >> (0x07 - (x2 & 0x07));
+    if (first == last)
+    {
+        firstMask &= lastMask;
+    }
+    uint8_t *row = &m_buf[y1 * m_pitch];
+    for (lcdint_t y = y1; y <= y2; y++)
+    {
+        if (m_color)
+        {
+            row[first] |= firstMask;
+            if (last != first) row[last] |= lastMask;
+        }
+        else
+        {
+            row[first] &= ~firstMask;
+            if (last != first) row[last] &= ~lastMask;
+        }
+        if (last > first + 1)
+        {
+            memset(&row[first + 1], m_color ? 0xFF : 0x00, last - first - 1);
+        }
+        row += m_pitch;
+    }
+}
+
+void NanoCanvasVga1::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    x -= offset.x;
+    y -= offset.y;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    uint8_t fg = m_color != BLACK;
+    /* Bitmap is organized in pages, while framebuffer is organized in rows */
+    for (lcduint_t j = 0; j < h; j++)
+    {
+        lcdint_t py = y + (lcdint_t)j;
+        if (py < 0) continue;
+        if (py >= (lcdint_t)m_h) break;
+        const uint8_t *src = bitmap + (j >> 3) * w;
+        uint8_t mask = 1 << (j & 0x07);
+        for (lcduint_t i = 0; i < w; i++)
+        {
+            lcdint_t px = x + (lcdint_t)i;
+            if (px < 0) continue;
+            if (px >= (lcdint_t)m_w) break;
+            if (pgm_read_byte(&src[i]) & mask)
+            {
+                setPixel(px, py, fg);
+            }
+            else if (!transparent)
+            {
+                setPixel(px, py, !fg);
+            }
+        }
+    }
+}
+
+void NanoCanvasVga1::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    x -= offset.x;
+    y -= offset.y;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    uint8_t fg = m_color != BLACK;
+    lcduint_t pitch = (w + 7) >> 3;
+    for (lcduint_t j = 0; j < h; j++)
+    {
+        lcdint_t py = y + (lcdint_t)j;
+        if (py < 0) continue;
+        if (py >= (lcdint_t)m_h) break;
+        const uint8_t *src = bitmap + j * pitch;
+        for (lcduint_t i = 0; i < w; i++)
+        {
+            lcdint_t px = x + (lcdint_t)i;
+            if (px < 0) continue;
+            if (px >= (lcdint_t)m_w) break;
+            if (pgm_read_byte(&src[i >> 3]) & (1 << (i & 0x07)))
+            {
+                setPixel(px, py, fg);
+            }
+            else if (!transparent)
+            {
+                setPixel(px, py, !fg);
+            }
+        }
+    }
+}
+
+void NanoCanvasVga1::clear()
+{
+    memset(m_buf, 0, m_pitch * m_h);
+}
+
+uint8_t NanoCanvasVga1::printChar(uint8_t c)
+{
+    uint16_t unicode = ssd1306_unicode16FromUtf8Ex(&m_utf8State, c);
+    if (unicode == SSD1306_MORE_CHARS_REQUIRED) return 0;
+    SCharInfo char_info;
+    ssd1306_getCharBitmap(unicode, &char_info);
+    uint8_t mode = m_textMode;
+    for (uint8_t i = 0; i<(m_fontStyle == STYLE_BOLD ? 2: 1); i++)
+    {
+        drawBitmap1(m_cursorX + i,
+                    m_cursorY,
+                    char_info.width,
+                    char_info.height,
+                    char_info.glyph );
+        m_textMode |= CANVAS_MODE_TRANSPARENT;
+    }
+    m_textMode = mode;
+    m_cursorX += (lcdint_t)(char_info.width + char_info.spacing);
+    if ( (m_textMode & (CANVAS_TEXT_WRAP | CANVAS_TEXT_WRAP_LOCAL)) &&
+         (m_cursorX > ((lcdint_t)m_w - (lcdint_t)s_fixedFont.h.width)) )
+    {
+        m_cursorY += (lcdint_t)s_fixedFont.h.height;
+        m_cursorX = 0;
+        if ( (m_textMode & CANVAS_TEXT_WRAP_LOCAL) && (m_cursorY > ((lcdint_t)m_h - (lcdint_t)s_fixedFont.h.height)) )
+        {
+            m_cursorY = 0;
+        }
+    }
+    return 1;
+}
+
+size_t NanoCanvasVga1::write(uint8_t c)
+{
+    if (c == '\n')
+    {
+        m_cursorY += (lcdint_t)s_fixedFont.h.height;
+        m_cursorX = 0;
+    }
+    else if (c == '\r')
+    {
+        // skip non-printed char
+    }
+    else
+    {
+        return printChar( c );
+    }
+    return 1;
+}
+
+void NanoCanvasVga1::printFixed(lcdint_t xpos, lcdint_t y, const char *ch, EFontStyle style)
+{
+    m_fontStyle = style;
+    m_cursorX = xpos;
+    m_cursorY = y;
+    while (*ch)
+    {
+        write(*ch);
+        ch++;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                      RGB16 BITMAPS WITH ORDERED DITHERING
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+/* 4x4 Bayer matrix, thresholds are in range 0..15 */
+static const uint8_t s_bayer4x4[4][4] =
+{
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 },
+};
+
+/* Reduces 8-bit channel value to specified number of bits, adding part of quantization step */
+static inline uint8_t ditherChannel(uint8_t value, uint8_t bits, uint8_t threshold)
+{
+    uint16_t v = value + (((uint16_t)threshold << (8 - bits)) >> 4);
+    return v > 0xFF ? (0xFF >> (8 - bits)) : (v >> (8 - bits));
+}
+
+static inline uint8_t rgb16Red8(uint16_t c)   { return ((c >> 8) & 0xF8) | (c >> 13); }
+static inline uint8_t rgb16Green8(uint16_t c) { return ((c >> 3) & 0xFC) | ((c >> 9) & 0x03); }
+static inline uint8_t rgb16Blue8(uint16_t c)  { return ((c << 3) & 0xF8) | ((c >> 2) & 0x07); }
+
+static inline uint8_t rgb16Luma8(uint16_t c)
+{
+    return ((uint16_t)rgb16Red8(c) * 77 + (uint16_t)rgb16Green8(c) * 150 + (uint16_t)rgb16Blue8(c) * 29) >> 8;
+}
+
+template <>
+inline void NanoCanvasOps<1>::putLocal(lcduint_t x, lcduint_t y, uint16_t color)
+{
+    if (color)
+        m_buf[YADDR1(y) + x] |= (1 << (y & 0x7));
+    else
+        m_buf[YADDR1(y) + x] &= ~(1 << (y & 0x7));
+}
+
+template <>
+inline void NanoCanvasOps<4>::putLocal(lcduint_t x, lcduint_t y, uint16_t color)
+{
+    canvasPutNibble4(m_buf + YADDR4(y), x, color & 0x0F);
+}
+
+template <>
+inline void NanoCanvasOps<8>::putLocal(lcduint_t x, lcduint_t y, uint16_t color)
+{
+    m_buf[YADDR8(y) + x] = color;
+}
+
+template <>
+inline void NanoCanvasOps<16>::putLocal(lcduint_t x, lcduint_t y, uint16_t color)
+{
+    m_buf[YADDR16(y) + (x<<1)] = color >> 8;
+    m_buf[YADDR16(y) + (x<<1) + 1] = color & 0xFF;
+}
+
+template <>
+inline void NanoCanvasOps<1>::putColor16(lcduint_t x, lcduint_t y, uint16_t color)
+{
+    uint8_t threshold = s_bayer4x4[(y + offset.y) & 3][(x + offset.x) & 3];
+    if ( rgb16Luma8(color) >= (threshold << 4) + 8 )
+        m_buf[YADDR1(y) + x] |= (1 << (y & 0x7));
+    else
+        m_buf[YADDR1(y) + x] &= ~(1 << (y & 0x7));
+}
+
+template <>
+inline void NanoCanvasOps<4>::putColor16(lcduint_t x, lcduint_t y, uint16_t color)
+{
+    uint8_t threshold = s_bayer4x4[(y + offset.y) & 3][(x + offset.x) & 3];
+    canvasPutNibble4(m_buf + YADDR4(y), x, ditherChannel(rgb16Luma8(color), 4, threshold));
+}
+
+template <>
+inline void NanoCanvasOps<8>::putColor16(lcduint_t x, lcduint_t y, uint16_t color)
+{
+    uint8_t threshold = s_bayer4x4[(y + offset.y) & 3][(x + offset.x) & 3];
+    m_buf[YADDR8(y) + x] = (ditherChannel(rgb16Red8(color), 3, threshold) << 5) |
+                           (ditherChannel(rgb16Green8(color), 3, threshold) << 2) |
+                           ditherChannel(rgb16Blue8(color), 2, threshold);
+}
+
+template <>
+inline void NanoCanvasOps<16>::putColor16(lcduint_t x, lcduint_t y, uint16_t color)
+{
+    m_buf[YADDR16(y) + (x<<1)] = color >> 8;
+    m_buf[YADDR16(y) + (x<<1) + 1] = color & 0xFF;
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawBitmap16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    if (m_dirty) markDirty(xpos, ypos, xpos + w - 1, ypos + h - 1);
+    /* calculate bitmap rectangle */
+    lcdint_t x1 = xpos - offset.x;
+    lcdint_t y1 = ypos - offset.y;
+    lcdint_t x2 = x1 + (lcdint_t)w - 1;
+    lcdint_t y2 = y1 + (lcdint_t)h - 1;
+    /* clip bitmap */
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+
+    if (x1 < m_clip.p1.x)
+    {
+        bitmap += (m_clip.p1.x - x1) << 1;
+        x1 = m_clip.p1.x;
+    }
+    if (y1 < m_clip.p1.y)
+    {
+        bitmap += ((lcduint_t)(m_clip.p1.y - y1) * w) << 1;
+        y1 = m_clip.p1.y;
+    }
+    if (y2 > m_clip.p2.y)
+    {
+         y2 = m_clip.p2.y;
+    }
+    if (x2 > m_clip.p2.x)
+    {
+         x2 = m_clip.p2.x;
+    }
+    if ((x1 > x2) || (y1 > y2)) return;
+    for ( lcdint_t y = y1; y <= y2; y++ )
+    {
+        for ( lcdint_t x = x1; x <= x2; x++ )
+        {
+            uint16_t color = (pgm_read_byte( bitmap ) << 8) | pgm_read_byte( bitmap + 1 );
+            if ( (color) || (!(m_textMode & CANVAS_MODE_TRANSPARENT)) )
+            {
+                putColor16(x, y, color);
+            }
+            bitmap += 2;
+        }
+        bitmap += (w - (x2 - x1 + 1)) << 1;
+    }
+}
+
+template <>
+void NanoCanvasOps<16>::drawKeyedBitmap16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h,
+                                          const uint8_t *bitmap, uint16_t key)
+{
+    if (m_dirty) markDirty(xpos, ypos, xpos + w - 1, ypos + h - 1);
+    lcdint_t x1 = xpos - offset.x;
+    lcdint_t y1 = ypos - offset.y;
+    lcdint_t x2 = x1 + (lcdint_t)w - 1;
+    lcdint_t y2 = y1 + (lcdint_t)h - 1;
+    if ((x2 < m_clip.p1.x) || (x1 > m_clip.p2.x)) return;
+    if ((y2 < m_clip.p1.y) || (y1 > m_clip.p2.y)) return;
+    if (x1 < m_clip.p1.x)
+    {
+        bitmap += (m_clip.p1.x - x1) << 1;
+        x1 = m_clip.p1.x;
+    }
+    if (y1 < m_clip.p1.y)
+    {
+        bitmap += ((lcduint_t)(m_clip.p1.y - y1) * w) << 1;
+        y1 = m_clip.p1.y;
+    }
+    if (y2 > m_clip.p2.y) y2 = m_clip.p2.y;
+    if (x2 > m_clip.p2.x) x2 = m_clip.p2.x;
+    if ((x1 > x2) || (y1 > y2)) return;
+    const lcduint_t width = x2 - x1 + 1;
+    /* Canvas and bitmap have the same byte order, so pixels are compared as is */
+    const uint8_t keyHi = key >> 8;
+    const uint8_t keyLo = key & 0xFF;
+    for ( lcdint_t y = y1; y <= y2; y++, bitmap += w << 1 )
+    {
+        uint8_t *dst = &m_buf[YADDR16(y) + (x1 << 1)];
+        const uint8_t *src = bitmap;
+        for ( lcduint_t x = width; x > 0; x--, src += 2, dst += 2 )
+        {
+            uint8_t hi = pgm_read_byte(&src[0]);
+            uint8_t lo = pgm_read_byte(&src[1]);
+            if ( (hi != keyHi) || (lo != keyLo) )
+            {
+                dst[0] = hi;
+                dst[1] = lo;
+            }
+        }
+    }
+}
+
+/*
+ * Atlas areas are clipped once by clipArea(). Canvas column is walked down, and source
+ * byte is read again only when source row crosses page boundary.
+ */
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawBitmap1Ex(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch,
+                                       lcduint_t srcX, lcduint_t srcY, const uint8_t *bitmap)
+{
+    lcduint_t left, top;
+    if (!clipArea(x, y, w, h, left, top)) return;
+    srcX += left;
+    srcY += top;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    for (lcduint_t i = 0; i < w; i++)
+    {
+        const uint8_t *src = bitmap + (uint16_t)(srcY >> 3) * pitch + srcX + i;
+        uint8_t data = pgm_read_byte(src) >> (srcY & 0x07);
+        uint8_t bits = 8 - (srcY & 0x07);
+        for (lcduint_t j = 0; j < h; j++)
+        {
+            if (!bits)
+            {
+                src += pitch;
+                data = pgm_read_byte(src);
+                bits = 8;
+            }
+            if (data & 0x01)
+                putLocal(x + i, y + j, m_color);
+            else if (!transparent)
+                putLocal(x + i, y + j, 0);
+            data >>= 1;
+            bits--;
+        }
+    }
+}
+
+/*
+ * Glyph size is known at compile time, so page and column loops have constant
+ * trip count and are unrolled by the compiler. 1-bit canvases write each glyph
+ * page to one or two canvas pages, 8-bit and 16-bit canvases walk rows.
+ */
+template <uint8_t BPP>
+template <uint8_t GW, uint8_t GH>
+inline void NanoCanvasOps<BPP>::drawGlyphFixed(lcduint_t x, lcduint_t y, const uint8_t *glyph)
+{
+    const bool transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    if (BPP == 1)
+    {
+        const uint8_t offs = y & 0x07;
+        const bool black = m_color == BLACK;
+        uint8_t *dst = m_buf + YADDR1(y) + x;
+        for (uint8_t page = 0; page < GH / 8; page++)
+        {
+            for (uint8_t i = 0; i < GW; i++)
+            {
+                uint8_t data = pgm_read_byte(&glyph[page * GW + i]);
+                uint8_t lo = data << offs;
+                uint8_t loMask = 0xFF << offs;
+                if (transparent)
+                {
+                    if (black) dst[i] &= ~lo; else dst[i] |= lo;
+                }
+                else
+                {
+                    dst[i] = (dst[i] & ~loMask) | (black ? ~lo & loMask : lo);
+                }
+                if (offs)
+                {
+                    uint8_t hi = data >> (8 - offs);
+                    uint8_t hiMask = 0xFF >> (8 - offs);
+                    uint8_t &next = dst[BANK_ADDR1(1) + i];
+                    if (transparent)
+                    {
+                        if (black) next &= ~hi; else next |= hi;
+                    }
+                    else
+                    {
+                        next = (next & ~hiMask) | (black ? ~hi & hiMask : hi);
+                    }
+                }
+            }
+            dst += BANK_ADDR1(1);
+        }
+    }
+    else
+    {
+        const uint8_t hiColor = BPP == 16 ? m_color >> 8 : m_color;
+        const uint8_t loColor = m_color & 0xFF;
+        for (uint8_t row = 0; row < GH; row++)
+        {
+            const uint8_t *src = &glyph[(row >> 3) * GW];
+            const uint8_t bit = 1 << (row & 0x07);
+            uint8_t *dst = BPP == 16 ? m_buf + YADDR16(y + row) + (x << 1) : m_buf + YADDR8(y + row) + x;
+            for (uint8_t i = 0; i < GW; i++)
+            {
+                if (pgm_read_byte(&src[i]) & bit)
+                {
+                    dst[0] = hiColor;
+                    if (BPP == 16) dst[1] = loColor;
+                }
+                else if (!transparent)
+                {
+                    dst[0] = 0;
+                    if (BPP == 16) dst[1] = 0;
+                }
+                dst += BPP / 8;
+            }
+        }
+    }
+}
+
+template <uint8_t BPP>
+bool NanoCanvasOps<BPP>::drawGlyphFixed(lcdint_t x, lcdint_t y, const SCharInfo &info)
+{
+    if (BPP == 4) return false;
+    lcdint_t lx = x - offset.x;
+    lcdint_t ly = y - offset.y;
+    if ((lx < m_clip.p1.x) || (ly < m_clip.p1.y) ||
+        (lx + (lcdint_t)info.width - 1 > m_clip.p2.x) || (ly + (lcdint_t)info.height - 1 > m_clip.p2.y))
+    {
+        return false;
+    }
+    if (info.width == 6 && info.height == 8) drawGlyphFixed<6, 8>(lx, ly, info.glyph);
+    else if (info.width == 8 && info.height == 16) drawGlyphFixed<8, 16>(lx, ly, info.glyph);
+    else if (info.width == 12 && info.height == 16) drawGlyphFixed<12, 16>(lx, ly, info.glyph);
+    else return false;
+    if (m_dirty) markDirty(x, y, x + info.width - 1, y + info.height - 1);
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                             CANVAS TO CANVAS
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Source area is clipped once by clipArea(), so rows are copied without checks.
+ * Canvases of the same depth copy rows (or pages) directly, other combinations
+ * convert each pixel with putLocal() and putColor16().
+ */
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawCanvas(lcdint_t x, lcdint_t y, const NanoCanvasOps<1> &canvas)
+{
+    lcduint_t w = canvas.m_w, h = canvas.m_h, left, top;
+    if (!clipArea(x, y, w, h, left, top)) return;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    for (lcduint_t j = 0; j < h; j++)
+    {
+        lcduint_t sy = top + j;
+        const uint8_t *src = canvas.m_buf + CANVAS_BANK_ADDR1(canvas, sy >> 3) + left;
+        uint8_t bit = 1 << (sy & 0x07);
+        for (lcduint_t i = 0; i < w; i++)
+        {
+            if (src[i] & bit)
+                putLocal(x + i, y + j, m_color);
+            else if (!transparent)
+                putLocal(x + i, y + j, 0);
+        }
+    }
+}
+
+template <>
+void NanoCanvasOps<1>::drawCanvas(lcdint_t x, lcdint_t y, const NanoCanvasOps<1> &canvas)
+{
+    lcduint_t w = canvas.m_w, h = canvas.m_h, left, top;
+    if (!clipArea(x, y, w, h, left, top)) return;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    lcdint_t y2 = y + (lcdint_t)h - 1;
+    /* Local position of source row 0 */
+    lcdint_t origin = y - (lcdint_t)top;
+    lcdint_t srcPages = (canvas.m_h + 7) >> 3;
+    const NanoRect rows = { {x, y}, {x, y2} };
+    for (lcdint_t page = y & ~0x07; page <= y2; page += 8)
+    {
+        /* Bit 0 of the page takes source row k, so the page is built of 2 source pages */
+        lcdint_t k = page - origin;
+        uint8_t shift = k & 0x07;
+        lcdint_t a = (k - shift) / 8;
+        const uint8_t *lo = a >= 0 ? canvas.m_buf + CANVAS_BANK_ADDR1(canvas, a) + left : nullptr;
+        const uint8_t *hi = shift && (a + 1 < srcPages) ? canvas.m_buf + CANVAS_BANK_ADDR1(canvas, a + 1) + left : nullptr;
+        uint8_t mask = canvasPageClip1(page, rows);
+        uint8_t *dst = &m_buf[YADDR1(page) + x];
+        for (lcduint_t i = 0; i < w; i++)
+        {
+            uint8_t data = 0;
+            if (lo) data |= lo[i] >> shift;
+            if (hi) data |= hi[i] << (8 - shift);
+            if (!transparent)
+                dst[i] = (dst[i] & ~mask) | ((m_color == BLACK ? ~data : data) & mask);
+            else if (m_color == BLACK)
+                dst[i] &= ~(data & mask);
+            else
+                dst[i] |= data & mask;
+        }
+    }
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawCanvas(lcdint_t x, lcdint_t y, const NanoCanvasOps<8> &canvas)
+{
+    lcduint_t w = canvas.m_w, h = canvas.m_h, left, top;
+    if (!clipArea(x, y, w, h, left, top)) return;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    for (lcduint_t j = 0; j < h; j++)
+    {
+        const uint8_t *src = canvas.m_buf + (uint32_t)(top + j) * canvas.m_w + left;
+        for (lcduint_t i = 0; i < w; i++)
+        {
+            if (src[i] || !transparent) putColor16(x + i, y + j, RGB8_TO_RGB16(src[i]));
+        }
+    }
+}
+
+template <>
+void NanoCanvasOps<8>::drawCanvas(lcdint_t x, lcdint_t y, const NanoCanvasOps<8> &canvas)
+{
+    lcduint_t w = canvas.m_w, h = canvas.m_h, left, top;
+    if (!clipArea(x, y, w, h, left, top)) return;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    const uint8_t *src = canvas.m_buf + (uint32_t)top * canvas.m_w + left;
+    uint8_t *dst = m_buf + YADDR8(y) + x;
+    for (lcduint_t j = h; j > 0; j--, src += canvas.m_w, dst += m_w)
+    {
+        if (!transparent)
+        {
+            memcpy(dst, src, w);
+            continue;
+        }
+        for (lcduint_t i = 0; i < w; i++)
+        {
+            if (src[i]) dst[i] = src[i];
+        }
+    }
+}
+
+template <>
+void NanoCanvasOps<16>::drawCanvas(lcdint_t x, lcdint_t y, const NanoCanvasOps<8> &canvas)
+{
+    lcduint_t w = canvas.m_w, h = canvas.m_h, left, top;
+    if (!clipArea(x, y, w, h, left, top)) return;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    const uint8_t *src = canvas.m_buf + (uint32_t)top * canvas.m_w + left;
+    uint8_t *dst = m_buf + YADDR16(y) + (x << 1);
+    for (lcduint_t j = h; j > 0; j--, src += canvas.m_w, dst += m_w << 1)
+    {
+        for (lcduint_t i = 0; i < w; i++)
+        {
+            if (!src[i] && transparent) continue;
+            uint16_t color = RGB8_TO_RGB16(src[i]);
+            dst[i << 1] = color >> 8;
+            dst[(i << 1) + 1] = color & 0xFF;
+        }
+    }
+}
+
+template <uint8_t BPP>
+void NanoCanvasOps<BPP>::drawCanvas(lcdint_t x, lcdint_t y, const NanoCanvasOps<16> &canvas)
+{
+    lcduint_t w = canvas.m_w, h = canvas.m_h, left, top;
+    if (!clipArea(x, y, w, h, left, top)) return;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    for (lcduint_t j = 0; j < h; j++)
+    {
+        const uint8_t *src = canvas.m_buf + (((uint32_t)(top + j) * canvas.m_w + left) << 1);
+        for (lcduint_t i = 0; i < w; i++, src += 2)
+        {
+            uint16_t color = (src[0] << 8) | src[1];
+            if (color || !transparent) putColor16(x + i, y + j, color);
+        }
+    }
+}
+
+template <>
+void NanoCanvasOps<16>::drawCanvas(lcdint_t x, lcdint_t y, const NanoCanvasOps<16> &canvas)
+{
+    lcduint_t w = canvas.m_w, h = canvas.m_h, left, top;
+    if (!clipArea(x, y, w, h, left, top)) return;
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    const uint8_t *src = canvas.m_buf + (((uint32_t)top * canvas.m_w + left) << 1);
+    uint8_t *dst = m_buf + YADDR16(y) + (x << 1);
+    for (lcduint_t j = h; j > 0; j--, src += canvas.m_w << 1, dst += m_w << 1)
+    {
+        if (!transparent)
+        {
+            memcpy(dst, src, w << 1);
+            continue;
+        }
+        for (lcduint_t i = 0; i < (w << 1); i += 2)
+        {
+            if (src[i] || src[i + 1])
+            {
+                dst[i] = src[i];
+                dst[i + 1] = src[i + 1];
+            }
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                      NanoCanvasOps class initiation
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                             ROWS FONTS GLYPHS
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+template <>
+void NanoCanvasOps<8>::drawGlyphRows(lcdint_t xpos, lcdint_t ypos, const SCharInfo &info)
+{
+    if (m_dirty) markDirty(xpos, ypos, xpos + info.width - 1, ypos + info.height - 1);
+    lcdint_t x1 = xpos - offset.x;
+    lcdint_t y1 = ypos - offset.y;
+    lcduint_t left, visible, top, rows;
+    canvasGlyphClip(x1, y1, m_clip, info, left, visible, top, rows);
+    if (!visible || !rows) return;
+    SGlyphReader reader;
+    ssd1306_glyphReaderInit(&reader, &info);
+    ssd1306_glyphSkipPixels(&reader, (uint16_t)top * info.width);
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    uint8_t color = m_color;
+    uint8_t alpha = ssd1306_isAlphaFont();
+    uint8_t ramp[16];
+    if ( alpha )
+    {
+        ssd1306_alphaRamp8(ramp, 0x00, color);
+    }
+    uint8_t *row = m_buf + YADDR8(y1) + x1;
+    while (rows--)
+    {
+        uint8_t *p = row;
+        ssd1306_glyphSkipPixels(&reader, left);
+        for (lcduint_t n = visible; n > 0; n--)
+        {
+            if ( alpha )
+            {
+                uint8_t a = ssd1306_glyphReadAlpha(&reader);
+                if ( !transparent )
+                    *p = ramp[a];
+                else if ( a == 15 )
+                    *p = color;
+                else if ( a )
+                    *p = ssd1306_blendColor8(*p, color, a);
+            }
+            else if ( ssd1306_glyphReadPixel(&reader) )
+                *p = color;
+            else if ( !transparent )
+                *p = 0x00;
+            p++;
+        }
+        ssd1306_glyphSkipPixels(&reader, info.width - left - visible);
+        row += m_w;
+    }
+}
+
+template <>
+void NanoCanvasOps<16>::drawGlyphRows(lcdint_t xpos, lcdint_t ypos, const SCharInfo &info)
+{
+    if (m_dirty) markDirty(xpos, ypos, xpos + info.width - 1, ypos + info.height - 1);
+    lcdint_t x1 = xpos - offset.x;
+    lcdint_t y1 = ypos - offset.y;
+    lcduint_t left, visible, top, rows;
+    canvasGlyphClip(x1, y1, m_clip, info, left, visible, top, rows);
+    if (!visible || !rows) return;
+    SGlyphReader reader;
+    ssd1306_glyphReaderInit(&reader, &info);
+    ssd1306_glyphSkipPixels(&reader, (uint16_t)top * info.width);
+    uint8_t transparent = (m_textMode & CANVAS_MODE_TRANSPARENT) == CANVAS_MODE_TRANSPARENT;
+    uint8_t hi = m_color >> 8;
+    uint8_t lo = m_color & 0xFF;
+    uint8_t alpha = ssd1306_isAlphaFont();
+    uint16_t ramp[16];
+    if ( alpha )
+    {
+        ssd1306_alphaRamp16(ramp, 0x0000, m_color);
+    }
+    uint8_t *row = m_buf + YADDR16(y1) + (x1<<1);
+    while (rows--)
+    {
+        uint8_t *p = row;
+        ssd1306_glyphSkipPixels(&reader, left);
+        for (lcduint_t n = visible; n > 0; n--)
+        {
+            if ( alpha )
+            {
+                uint8_t a = ssd1306_glyphReadAlpha(&reader);
+                uint16_t c = ramp[a];
+                if ( transparent && a != 15 )
+                {
+                    c = a ? ssd1306_blendColor16((p[0] << 8) | p[1], m_color, a) : ((p[0] << 8) | p[1]);
+                }
+                p[0] = c >> 8;
+                p[1] = c & 0xFF;
+            }
+            else if ( ssd1306_glyphReadPixel(&reader) )
+            {
+                p[0] = hi;
+                p[1] = lo;
+            }
+            else if ( !transparent )
+            {
+                p[0] = 0x00;
+                p[1] = 0x00;
+            }
+            p += 2;
+        }
+        ssd1306_glyphSkipPixels(&reader, info.width - left - visible);
+        row += (lcduint_t)m_w << 1;
+    }
+}
+
+template class NanoCanvasOps<1>;
+template class NanoCanvasOps<4>;
+template class NanoCanvasOps<8>;
+template class NanoCanvasOps<16>;
+
+
+//              NANO CANVAS 16
+
+void NanoCanvas16::blt(lcdint_t x, lcdint_t y)
+{
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    if (!m_dirty)
+    {
+        /* Uniform canvas (empty tile usually) is sent as fill command without pixel data */
+        if (!memcmp(m_buf, m_buf + 2, ((uint32_t)m_w * m_h - 1) << 1))
+            ssd1306_fillBlock16(x, y, m_w, m_h, (m_buf[0] << 8) | m_buf[1]);
+        else
+            ssd1306_drawBufferFast16(x, y, m_w, m_h, m_buf);
+        return;
+    }
+    for (lcduint_t row = 0; row < m_h; )
+    {
+        lcduint_t x1, x2;
+        lcduint_t rows = dirtyRows(row, x1, x2);
+        if (x1 <= x2)
+        {
+            ssd1306_drawBufferEx16(x + x1, y + row, x2 - x1 + 1, rows, m_w << 1, m_buf + YADDR16(row) + (x1 << 1));
+        }
+        row += rows;
+    }
+    resetDirty();
+}
+
+void NanoCanvas16::blt()
+{
+    blt(offset.x, offset.y);
+}
+
+void NanoCanvas16::blt(const NanoRect &rect)
+{
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    ssd1306_drawBufferEx16(offset.x + rect.p1.x,
+                           offset.y + rect.p1.y,
+                           rect.width(),
+                           rect.height(),
+                           m_w<<1,
+                           m_buf + (rect.p1.x<<1) + rect.p1.y * (m_w<<1) );
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                           INDEXED COLOR GRAPHICS
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+void NanoCanvasIndexed4::blt(lcdint_t x, lcdint_t y)
+{
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    if (!m_dirty)
+    {
+        ssd1306_drawIndexedBuffer16(x, y, m_w, m_h, PITCH4, 4, m_palette, m_buf);
+        return;
+    }
+    for (lcduint_t row = 0; row < m_h; )
+    {
+        lcduint_t x1, x2;
+        lcduint_t rows = dirtyRows(row, x1, x2);
+        if (x1 <= x2)
+        {
+            x1 &= ~1;
+            x2 = min((lcduint_t)(x2 | 1), (lcduint_t)(m_w - 1));
+            ssd1306_drawIndexedBuffer16(x + x1, y + row, x2 - x1 + 1, rows, PITCH4, 4, m_palette,
+                                        m_buf + YADDR4(row) + (x1 >> 1));
+        }
+        row += rows;
+    }
+    resetDirty();
+}
+
+void NanoCanvasIndexed4::blt()
+{
+    blt(offset.x, offset.y);
+}
+
+void NanoCanvasIndexed4::blt(const NanoRect &rect)
+{
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    lcdint_t x1 = rect.p1.x & ~1;
+    lcdint_t x2 = min((lcdint_t)(rect.p2.x | 1), (lcdint_t)(m_w - 1));
+    ssd1306_drawIndexedBuffer16(offset.x + x1,
+                                offset.y + rect.p1.y,
+                                x2 - x1 + 1,
+                                rect.height(),
+                                PITCH4, 4, m_palette,
+                                m_buf + (x1 >> 1) + YADDR4(rect.p1.y) );
+}
+
+void NanoCanvasIndexed8::blt(lcdint_t x, lcdint_t y)
+{
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    if (!m_dirty)
+    {
+        ssd1306_drawIndexedBuffer16(x, y, m_w, m_h, m_w, 8, m_palette, m_buf);
+        return;
+    }
+    for (lcduint_t row = 0; row < m_h; )
+    {
+        lcduint_t x1, x2;
+        lcduint_t rows = dirtyRows(row, x1, x2);
+        if (x1 <= x2)
+        {
+            ssd1306_drawIndexedBuffer16(x + x1, y + row, x2 - x1 + 1, rows, m_w, 8, m_palette,
+                                        m_buf + YADDR8(row) + x1);
+        }
+        row += rows;
+    }
+    resetDirty();
+}
+
+void NanoCanvasIndexed8::blt()
+{
+    blt(offset.x, offset.y);
+}
+
+void NanoCanvasIndexed8::blt(const NanoRect &rect)
+{
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_CANVAS_BLT);
+    ssd1306_drawIndexedBuffer16(offset.x + rect.p1.x,
+                                offset.y + rect.p1.y,
+                                rect.width(),
+                                rect.height(),
+                                m_w, 8, m_palette,
+                                m_buf + rect.p1.x + YADDR8(rect.p1.y) );
 }
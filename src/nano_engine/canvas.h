@@ -51,9 +51,19 @@ enum
     CANVAS_TEXT_WRAP_LOCAL      = 0x04,
 };
 
+#ifndef CANVAS_CLIP_STACK_DEPTH
+#if defined(__AVR__)
+/** Max number of nested clip areas, see NanoCanvasOps::pushClipRect() */
+#define CANVAS_CLIP_STACK_DEPTH  2
+#else
+/** Max number of nested clip areas, see NanoCanvasOps::pushClipRect() */
+#define CANVAS_CLIP_STACK_DEPTH  4
+#endif
+#endif
+
 /**
  * NanoCanvasOps provides operations for drawing in memory buffer.
- * Depending on BPP argument, this class can work with 1,8,16-bit canvas areas.
+ * Depending on BPP argument, this class can work with 1,4,8,16-bit canvas areas.
  */
 template <uint8_t BPP>
 class NanoCanvasOps: public Print
@@ -101,6 +111,24 @@ public:
      */
     void begin(lcdint_t w, lcdint_t h, uint8_t *bytes);
 
+    /**
+     * Changes canvas size without clearing buffer and resetting colors, offset
+     * and text mode. New size must fit memory buffer, passed to begin().
+     * Height of 1-bit canvas should be divided by 8.
+     *
+     * @param w - width
+     * @param h - height
+     */
+    void setSize(lcduint_t w, lcduint_t h);
+
+    /**
+     * Changes memory buffer without clearing it and resetting colors, offset and
+     * text mode. New buffer must fit current canvas size.
+     *
+     * @param bytes - pointer to memory buffer to use
+     */
+    void setBuffer(uint8_t *bytes) { m_buf = bytes; }
+
     /**
      * Sets offset
      * @param ox - X offset in pixels
@@ -126,6 +154,31 @@ public:
         return { offset, offsetEnd() };
     }
 
+    /**
+     * Limits all drawing operations to the rectangle (in offset terms), intersected
+     * with current clip area. Primitives are clipped once against the clip area, so
+     * their inner loops do not check each pixel. Previous clip area is restored by
+     * popClipRect(). The area is converted to canvas coordinates here, so pop it
+     * before offset is changed. clear() ignores clip area.
+     * @param rect - clip rectangle
+     * @return false if there are CANVAS_CLIP_STACK_DEPTH nested areas already
+     */
+    bool pushClipRect(const NanoRect &rect);
+
+    /**
+     * Restores clip area, active before last pushClipRect() call.
+     */
+    void popClipRect();
+
+    /**
+     * Returns current clip area in offset terms. If there is no active clip area,
+     * returns the same as rect(). Empty area has p2 less than p1.
+     */
+    const NanoRect clipRect() const
+    {
+        return m_clip + offset;
+    }
+
     /**
      * Draws pixel on specified position
      * @param x - position X
@@ -210,6 +263,113 @@ public:
      */
     void fillRect(const NanoRect &rect);
 
+    /**
+     * @brief Inverts pixels of rectangle area.
+     *
+     * Inverts all bits of each pixel of the area, so drawing the same rectangle
+     * twice restores original content. Useful for cursors and selection highlights,
+     * which can be toggled without redrawing the scene. Color and mode are not used.
+     * @param x1 - position X
+     * @param y1 - position Y
+     * @param x2 - position X
+     * @param y2 - position Y
+     */
+    void invertRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
+
+    /**
+     * Inverts pixels of rectangle area
+     * @param rect - structure, describing rectangle area
+     */
+    void invertRect(const NanoRect &rect);
+
+    /**
+     * Draws circle
+     * @param x - position X of the center
+     * @param y - position Y of the center
+     * @param r - radius in pixels (up to 160)
+     * @note color can be set via setColor()
+     */
+    void drawCircle(lcdint_t x, lcdint_t y, lcduint_t r);
+
+    /**
+     * Fills circle. Monochrome canvas fills it by columns, other canvases by lines.
+     * @param x - position X of the center
+     * @param y - position Y of the center
+     * @param r - radius in pixels (up to 160)
+     * @note color can be set via setColor()
+     */
+    void fillCircle(lcdint_t x, lcdint_t y, lcduint_t r);
+
+    /**
+     * Draws ellipse
+     * @param x - position X of the center
+     * @param y - position Y of the center
+     * @param rx - horizontal radius in pixels (up to 160)
+     * @param ry - vertical radius in pixels (up to 160)
+     * @note color can be set via setColor()
+     */
+    void drawEllipse(lcdint_t x, lcdint_t y, lcduint_t rx, lcduint_t ry);
+
+    /**
+     * Fills ellipse
+     * @param x - position X of the center
+     * @param y - position Y of the center
+     * @param rx - horizontal radius in pixels (up to 160)
+     * @param ry - vertical radius in pixels (up to 160)
+     * @note color can be set via setColor()
+     */
+    void fillEllipse(lcdint_t x, lcdint_t y, lcduint_t rx, lcduint_t ry);
+
+    /**
+     * Draws rectangle with rounded corners
+     * @param x1 - position X
+     * @param y1 - position Y
+     * @param x2 - position X
+     * @param y2 - position Y
+     * @param r - radius of corners
+     * @note color can be set via setColor()
+     */
+    void drawRoundRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r);
+
+    /**
+     * Fills rectangle with rounded corners
+     * @param x1 - position X
+     * @param y1 - position Y
+     * @param x2 - position X
+     * @param y2 - position Y
+     * @param r - radius of corners
+     * @note color can be set via setColor()
+     */
+    void fillRoundRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r);
+
+    /**
+     * Draws triangle
+     * @note color can be set via setColor()
+     */
+    void drawTriangle(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x3, lcdint_t y3);
+
+    /**
+     * Fills triangle
+     * @note color can be set via setColor()
+     */
+    void fillTriangle(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x3, lcdint_t y3);
+
+    /**
+     * Draws closed polygon
+     * @param points - vertices of polygon
+     * @param count - number of vertices
+     * @note color can be set via setColor()
+     */
+    void drawPolygon(const NanoPoint *points, uint8_t count);
+
+    /**
+     * Fills polygon (even-odd rule), including its outline
+     * @param points - vertices of polygon
+     * @param count - number of vertices
+     * @note color can be set via setColor()
+     */
+    void fillPolygon(const NanoPoint *points, uint8_t count);
+
     /**
      * @brief Draws monochrome bitmap in color buffer using color, specified via setColor() method
      * Draws monochrome bitmap in color buffer using color, specified via setColor() method
@@ -228,6 +388,24 @@ public:
      */
     void drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
 
+    /**
+     * @brief Draws w x h area of monochrome bitmap (atlas) using color, specified via setColor() method
+     * Draws area, starting at srcX, srcY pixels of monochrome bitmap, which is pitch pixels wide.
+     * srcY may be not aligned to pages, so icons and glyphs can be taken from single sprite
+     * sheet without copying them out. Color and transparency rules are the same as for drawBitmap1().
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width of area in pixels
+     * @param h - height of area in pixels
+     * @param pitch - width of whole bitmap in pixels (length of bitmap page in bytes)
+     * @param srcX - horizontal position of area in the bitmap in pixels
+     * @param srcY - vertical position of area in the bitmap in pixels
+     * @param bitmap - monochrome bitmap data, located in flash
+     */
+    void drawBitmap1Ex(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch,
+                       lcduint_t srcX, lcduint_t srcY, const uint8_t *bitmap);
+
     /**
      * @brief Draws monochrome bitmap in color buffer using color, specified via setColor() method
      * Draws monochrome bitmap in color buffer using color, specified via setColor() method
@@ -246,6 +424,41 @@ public:
      */
     void drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
 
+    /**
+     * @brief Draws pre-shifted monochrome bitmap from RAM.
+     *
+     * Draws monochrome bitmap, which is already shifted vertically by (y & 7) pixels
+     * (in offset terms) to match canvas pages, so each column is drawn with masked
+     * byte copies only. Such bitmaps are prepared by NanoSpriteCache1. The bitmap has
+     * ((y & 7) + h + 7) / 8 pages of w bytes, row y is bit (y & 7) of the first page.
+     * Color and transparency rules are the same as for drawBitmap1().
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width in pixels
+     * @param h - height in pixels (not shifted)
+     * @param shifted - shifted bitmap data, located in RAM
+     * @note Supported only by 1-bit canvas.
+     */
+    void drawShiftedBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *shifted);
+
+    /**
+     * @brief XORs monochrome bitmap into the canvas.
+     *
+     * Inverts those pixels of the canvas, which are set in the bitmap. Drawing the
+     * same bitmap twice at the same position restores original content, so cursor
+     * sprites can be shown and hidden without redrawing the scene.
+     * Color and mode of the canvas are not used.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width in pixels
+     * @param h - height in pixels
+     * @param bitmap - monochrome bitmap data, located in flash
+     * @note Supported only by 1-bit canvas.
+     */
+    void xorBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
+
     /**
      * @brief Draws 8-bit color bitmap in color buffer.
      * Draws 8-bit color bitmap in color buffer.
@@ -257,6 +470,153 @@ public:
      */
     void drawBitmap8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
 
+    /**
+     * @brief Draws 16-bit color bitmap in canvas buffer of any depth.
+     * Draws RGB16 bitmap (2 bytes per pixel, high byte first). On canvases with less
+     * bits per pixel colors are converted with 4x4 ordered (Bayer) dithering:
+     * to RGB8 on 8-bit canvas, to 4-bit grayscale on 4-bit canvas and to black
+     * and white on 1-bit canvas. Dithering pattern is bound to screen coordinates,
+     * so bitmaps drawn by several tiles have no seams. In transparent mode
+     * black pixels are not drawn. tools/bitmapdither.py produces the same result offline.
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width in pixels
+     * @param h - height in pixels
+     * @param bitmap - 16-bit color bitmap data, located in flash
+     */
+    void drawBitmap16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
+
+    /**
+     * @brief Draws monochrome bitmap, scaled by integer factor.
+     *
+     * Nearest neighbor scaling: each run of same pixels in bitmap row is drawn as single
+     * filled rectangle of scale rows, so low resolution assets can be reused on large
+     * panels without intermediate buffer. Color and transparency rules are the same as
+     * for printFixedN(): set pixels are drawn with current color, others are black or,
+     * in transparent mode, not drawn. The bitmap is expected in native ssd1306 format.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width of the bitmap in pixels (not scaled)
+     * @param h - height of the bitmap in pixels (not scaled)
+     * @param bitmap - monochrome bitmap data, located in flash
+     * @param scale - scale factor, usually 2, 3 or 4
+     */
+    void drawBitmap1Scaled(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                           const uint8_t *bitmap, uint8_t scale);
+
+    /**
+     * @brief Draws 8-bit color bitmap, scaled by integer factor.
+     *
+     * Nearest neighbor scaling: each run of same pixels in bitmap row is drawn as single
+     * filled rectangle of scale rows. On 16-bit canvas colors are converted to RGB16.
+     * In transparent mode black pixels are not drawn.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width of the bitmap in pixels (not scaled)
+     * @param h - height of the bitmap in pixels (not scaled)
+     * @param bitmap - 8-bit color bitmap data, located in flash
+     * @param scale - scale factor, usually 2, 3 or 4
+     * @note Supported by 8-bit and 16-bit canvases.
+     */
+    void drawBitmap8Scaled(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                           const uint8_t *bitmap, uint8_t scale);
+
+    /**
+     * @brief Draws monochrome bitmap through 1-bit mask.
+     *
+     * Pixels, set in the mask, are replaced with bitmap pixels (white for 1, black
+     * for 0), other pixels of the canvas are left as is. So sprites can have black
+     * outlines over any background. Both bitmap and mask are in native ssd1306 format
+     * (see tools/bitmapdither.py -t option). Color and mode of the canvas are not used.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width in pixels
+     * @param h - height in pixels
+     * @param bitmap - monochrome bitmap data, located in flash
+     * @param mask - monochrome mask data, located in flash
+     * @note Supported only by 1-bit canvas.
+     */
+    void drawMaskedBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                           const uint8_t *bitmap, const uint8_t *mask);
+
+    /**
+     * @brief Draws 8-bit color bitmap with transparent color key.
+     *
+     * Pixels of key color are not drawn, all other colors (including black)
+     * are copied to the canvas regardless of canvas mode.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width in pixels
+     * @param h - height in pixels
+     * @param bitmap - 8-bit color bitmap data, located in flash
+     * @param key - transparent color
+     * @note Supported only by 8-bit canvas.
+     */
+    void drawKeyedBitmap8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                          const uint8_t *bitmap, uint8_t key);
+
+    /**
+     * @brief Draws 16-bit color bitmap with transparent color key.
+     *
+     * Pixels of key color are not drawn, all other colors (including black)
+     * are copied to the canvas regardless of canvas mode.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width in pixels
+     * @param h - height in pixels
+     * @param bitmap - 16-bit color bitmap data (high byte first), located in flash
+     * @param key - transparent color
+     * @note Supported only by 16-bit canvas.
+     */
+    void drawKeyedBitmap16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                           const uint8_t *bitmap, uint16_t key);
+
+    /**
+     * @brief Draws content of monochrome canvas.
+     *
+     * Whole buffer of the source canvas is drawn with top-left corner at x,y (in offset
+     * terms), offset of the source canvas is not used. Set pixels are drawn with current
+     * color, color and transparency rules are the same as for drawBitmap1(). So widget
+     * can be rendered once to off-screen canvas and composed each frame by single call.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param canvas - source canvas
+     */
+    void drawCanvas(lcdint_t x, lcdint_t y, const NanoCanvasOps<1> &canvas);
+
+    /**
+     * @brief Draws content of 8-bit color canvas.
+     *
+     * Whole buffer of the source canvas is drawn with top-left corner at x,y (in offset
+     * terms), offset of the source canvas is not used. Colors are converted to canvas depth
+     * like drawBitmap8() and drawBitmap16() do. In transparent mode black pixels are not drawn.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param canvas - source canvas
+     */
+    void drawCanvas(lcdint_t x, lcdint_t y, const NanoCanvasOps<8> &canvas);
+
+    /**
+     * @brief Draws content of 16-bit color canvas.
+     *
+     * Whole buffer of the source canvas is drawn with top-left corner at x,y (in offset
+     * terms), offset of the source canvas is not used. On canvases with less bits per
+     * pixel colors are dithered like drawBitmap16() does. In transparent mode black pixels
+     * are not drawn.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param canvas - source canvas
+     */
+    void drawCanvas(lcdint_t x, lcdint_t y, const NanoCanvasOps<16> &canvas);
+
     /**
      * Clears canvas
      */
@@ -268,6 +628,13 @@ public:
      */
     size_t write(uint8_t c) override;
 
+    /**
+     * Writes buffer to canvas
+     * @param buffer - chars to print
+     * @param size - number of chars in the buffer
+     */
+    size_t write(const uint8_t *buffer, size_t size) override;
+
     /**
      * Draws single character to canvas
      * @param c - character code to print
@@ -299,6 +666,33 @@ public:
      */
     void printFixedPgm(lcdint_t xpos, lcdint_t y, const char *ch, EFontStyle style = STYLE_NORMAL);
 
+    /**
+     * Print text at specified position to canvas, scaled 2^factor times
+     *
+     * @param xpos  position in pixels
+     * @param y     position in pixels
+     * @param ch    pointer to NULL-terminated string.
+     * @param style specific font style to use
+     * @param factor scaling factor: FONT_SIZE_NORMAL, FONT_SIZE_2X, FONT_SIZE_4X, FONT_SIZE_8X
+     *
+     * @note Supports only STYLE_NORMAL and STYLE_BOLD. Text is not wrapped.
+     */
+    void printFixedN(lcdint_t xpos, lcdint_t y, const char *ch, EFontStyle style, uint8_t factor);
+
+    /**
+     * Prints text, broken to lines by ssd1306_layoutText(), starting with specified
+     * line of the layout. Lines outside of the canvas are skipped without reading
+     * their chars, so partial redraws and scrolling of long texts are cheap.
+     *
+     * @param xpos  position of the text area in pixels
+     * @param y     position of the text area in pixels
+     * @param layout text layout, computed with active font
+     * @param firstLine index of the layout line, printed at y position
+     *
+     * @note Text wrap modes of the canvas are not used.
+     */
+    void printLayout(lcdint_t xpos, lcdint_t y, const STextLayout &layout, uint8_t firstLine = 0);
+
     /**
      * @brief Sets canvas drawing mode
      * Sets canvas drawing mode. The set flags define transparency of output images
@@ -306,12 +700,44 @@ public:
      */
     void setMode(uint8_t modeFlags) { m_textMode = modeFlags; };
 
+    /**
+     * Returns canvas drawing mode flags, set by setMode()
+     */
+    uint8_t getMode() const { return m_textMode; };
+
     /**
      * Sets color for monochrome operations
      * @param color - color to set (refer to RGB_COLOR8 definition)
      */
     void setColor(uint16_t color) { m_color = color; };
 
+    /**
+     * @brief Enables tracking of changed canvas area.
+     *
+     * Enables tracking of changed canvas area. Every drawing primitive updates
+     * min/max column of each canvas row it touches, and blt() sends to the display
+     * only changed part of each row, and then resets tracking information.
+     * Use it for canvases, which are not cleared before each frame.
+     * @param ranges array of 2 * height elements for canvas of maximum height,
+     *        or nullptr to disable tracking
+     */
+    void enableDirtyTracking(lcduint_t *ranges);
+
+    /**
+     * Marks all canvas rows as not changed.
+     */
+    void resetDirty();
+
+    /**
+     * Marks canvas area as changed. Coordinates are specified in offset terms.
+     * The function must be called only if dirty tracking is enabled.
+     * @param x1 - left position in pixels
+     * @param y1 - top position in pixels
+     * @param x2 - right position in pixels
+     * @param y2 - bottom position in pixels
+     */
+    void markDirty(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
+
 protected:
     lcduint_t m_w;    ///< width of NanoCanvas area in pixels
     lcduint_t m_h;    ///< height of NanoCanvas area in pixels
@@ -320,8 +746,66 @@ protected:
     lcdint_t  m_cursorY;  ///< current Y cursor position for text output
     uint8_t   m_textMode; ///< Flags for current NanoCanvas mode
     EFontStyle   m_fontStyle; ///< currently active font style
+    uint32_t  m_utf8State; ///< utf8 decoder state, so each canvas decodes its text independently
     uint8_t * m_buf;      ///< Canvas data
     uint16_t  m_color;    ///< current color for monochrome operations
+    lcduint_t *m_dirty = nullptr; ///< min/max changed column for each row, if tracking is enabled
+    NanoRect  m_clip;     ///< area, available for drawing, in canvas coordinates
+    NanoRect  m_clipStack[CANVAS_CLIP_STACK_DEPTH]; ///< saved clip areas
+    uint8_t   m_clipDepth = 0; ///< number of saved clip areas
+
+    /**
+     * Returns changed columns of the row, and number of sequential rows with the same range.
+     * If the row is not changed, x1 is greater than x2.
+     */
+    lcduint_t dirtyRows(lcduint_t y, lcduint_t &x1, lcduint_t &x2) const;
+
+    /** Resets clip area to whole canvas and drops saved clip areas */
+    void resetClip();
+
+    /**
+     * Clips w x h area at x,y (offset terms) once for blits. Returns false if nothing is
+     * visible, otherwise x,y become local position, w,h visible size and left,top first
+     * visible pixel of the area.
+     */
+    bool clipArea(lcdint_t &x, lcdint_t &y, lcduint_t &w, lcduint_t &h, lcduint_t &left, lcduint_t &top);
+
+    template <uint8_t> friend class NanoCanvasOps;
+
+private:
+    /** Writes RGB16 color, converted to canvas depth, to local position, used by drawBitmap16() */
+    inline void putColor16(lcduint_t x, lcduint_t y, uint16_t color);
+
+    /** Writes color to local position inside clip area without checks, used by drawGlyphRows() and drawCanvas() */
+    inline void putLocal(lcduint_t x, lcduint_t y, uint16_t color);
+
+    /** Draws single column (byte) of 1-bit bitmap page, used by drawBitmap1() */
+    inline void drawBitmapColumn1(uint16_t addr, const uint8_t *bitmap, lcduint_t pitch,
+                                  uint8_t offs, uint8_t mainFlag, uint8_t complexFlag, uint8_t clip);
+
+    /**
+     * Draws glyph of common fixed size (6x8, 8x16, 12x16) with loops, unrolled at compile
+     * time, if glyph is completely inside clip area. Returns false if the glyph is to be
+     * drawn by drawBitmap1(). Used by printChar().
+     */
+    bool drawGlyphFixed(lcdint_t x, lcdint_t y, const SCharInfo &info);
+
+    /** Draws GW x GH glyph, which is completely inside clip area, at local position */
+    template <uint8_t GW, uint8_t GH>
+    inline void drawGlyphFixed(lcduint_t x, lcduint_t y, const uint8_t *glyph);
+
+    /** Draws glyph of rows font (see ssd1306_isRowsFont()), used by printChar() */
+    void drawGlyphRows(lcdint_t x, lcdint_t y, const SCharInfo &info);
+
+    /** Draws glyph, scaled 2^factor times, with one fillRect() per run of same pixels */
+    void drawGlyphScaled(lcdint_t x, lcdint_t y, const SCharInfo &info, uint8_t factor);
+
+    /**
+     * Draws runs of scaled bitmap row, used by drawBitmap1Scaled() and drawBitmap8Scaled().
+     * Rows outside clip area are skipped without reading the bitmap.
+     */
+    template <bool MONO>
+    void drawScaledRow(lcdint_t x, lcdint_t top, lcduint_t w, const uint8_t *row, uint8_t bit, uint8_t scale);
 };
 
 /**
@@ -479,6 +963,52 @@ public:
     void blt(const NanoRect &rect) override;
 };
 
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                             4-BIT GRAPHICS
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * NanoCanvas4 represents objects for drawing in memory buffer
+ * NanoCanvas4 represents each pixel as 4-bit grayscale value (refer to GRAY_COLOR4),
+ * 2 horizontal pixels per byte, low nibble is the left pixel. Each canvas line takes
+ * (width + 1) / 2 bytes. This is native format of SSD1325 controller, so blt() sends
+ * buffer to the display without any conversion.
+ * Horizontal position and width of the canvas, passed to blt(), should be even.
+ */
+class NanoCanvas4: public NanoCanvasBase<4>
+{
+public:
+    using NanoCanvasBase::NanoCanvasBase;
+
+    /**
+     * Draws canvas on the LCD display
+     * @param x - horizontal position in pixels
+     * @param y - vertical position in pixels
+     */
+    void blt(lcdint_t x, lcdint_t y) override;
+
+    /**
+     * Draws canvas on the LCD display using offset values.
+     */
+    void blt() override;
+
+    /**
+     * Draws only part of canvas on the LCD display.
+     * This method uses Canvas offset field as top-left point of whole canvas
+     * content. First point of specified rectangle defines the actual top-left
+     * point on the screen to be refreshed.
+     * For example, `blt({{8,0},{15,7}});` will copy canvas area {8,0}-{15,7}
+     * to screen starting at {8,0} if canvas offset is {0,0}.
+     * If canvas offset is {12,3}, then canvas area {8,0}-{15,7} will be copied
+     * to screen at position {20,3}.
+     * Rectangle is extended to even columns, since 2 pixels share single byte.
+     * @param rect rectagle describing part of canvas to move to display.
+     */
+    void blt(const NanoRect &rect) override;
+};
+
 /////////////////////////////////////////////////////////////////////////////////
 //
 //                             8-BIT GRAPHICS
@@ -531,6 +1061,10 @@ public:
  * NanoCanvas16 represents objects for drawing in memory buffer
  * NanoCanvas16 represents each pixel as 2-bytes with RGB bits: RRRRRGGG-GGGBBBBB
  * For details refer to SSD1351 datasheet
+ * Pixels are stored high byte first, that is wire order of RGB16 controllers, and
+ * color is split into bytes once per drawing call. So, blt() sends the buffer via
+ * ssd1306_lcd.send_pixels_buffer16() without any conversion: continuous areas
+ * go as single ssd1306_intf.send_buffer() call.
  */
 class NanoCanvas16: public NanoCanvasBase<16>
 {
@@ -563,6 +1097,310 @@ public:
     void blt(const NanoRect &rect) override;
 };
 
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                           INDEXED COLOR GRAPHICS
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * NanoCanvasIndexed4 represents objects for drawing in memory buffer
+ * NanoCanvasIndexed4 stores each pixel as 4-bit index in the palette of 16 RGB16
+ * colors, 2 horizontal pixels per byte, low nibble is the left pixel. Colors, passed
+ * to setColor(), are palette indexes. blt() expands pixels via palette and sends
+ * them to RGB16 displays, so full-screen 128x128 buffer takes 8 KiB instead of 32 KiB.
+ * Changing palette and calling blt() again recolors the picture without redrawing.
+ */
+class NanoCanvasIndexed4: public NanoCanvasBase<4>
+{
+public:
+    using NanoCanvasBase::NanoCanvasBase;
+
+    /**
+     * Sets palette of 16 RGB16 colors, used by blt(). Palette is not copied.
+     * @param palette pointer to 16 RGB16 colors, located in SRAM.
+     */
+    void setPalette(const uint16_t *palette) { m_palette = palette; }
+
+    /** Returns palette of the canvas */
+    const uint16_t *palette() const { return m_palette; }
+
+    /**
+     * Draws canvas on the LCD display
+     * @param x - horizontal position in pixels
+     * @param y - vertical position in pixels
+     */
+    void blt(lcdint_t x, lcdint_t y) override;
+
+    /**
+     * Draws canvas on the LCD display using offset values.
+     */
+    void blt() override;
+
+    /**
+     * Draws only part of canvas on the LCD display.
+     * This method uses Canvas offset field as top-left point of whole canvas
+     * content. First point of specified rectangle defines the actual top-left
+     * point on the screen to be refreshed.
+     * Rectangle is extended to even columns, since 2 pixels share single byte.
+     * @param rect rectagle describing part of canvas to move to display.
+     */
+    void blt(const NanoRect &rect) override;
+
+private:
+    const uint16_t *m_palette = nullptr;
+};
+
+/**
+ * NanoCanvasIndexed8 represents objects for drawing in memory buffer
+ * NanoCanvasIndexed8 stores each pixel as 8-bit index in the palette of 256 RGB16
+ * colors. Colors, passed to setColor(), are palette indexes. blt() expands pixels
+ * via palette and sends them to RGB16 displays.
+ * drawBitmap8() copies bitmap bytes as indexes.
+ */
+class NanoCanvasIndexed8: public NanoCanvasBase<8>
+{
+public:
+    using NanoCanvasBase::NanoCanvasBase;
+
+    /**
+     * Sets palette of 256 RGB16 colors, used by blt(). Palette is not copied.
+     * @param palette pointer to 256 RGB16 colors, located in SRAM.
+     */
+    void setPalette(const uint16_t *palette) { m_palette = palette; }
+
+    /** Returns palette of the canvas */
+    const uint16_t *palette() const { return m_palette; }
+
+    /**
+     * Draws canvas on the LCD display
+     * @param x - horizontal position in pixels
+     * @param y - vertical position in pixels
+     */
+    void blt(lcdint_t x, lcdint_t y) override;
+
+    /**
+     * Draws canvas on the LCD display using offset values.
+     */
+    void blt() override;
+
+    /**
+     * Draws only part of canvas on the LCD display.
+     * This method uses Canvas offset field as top-left point of whole canvas
+     * content. First point of specified rectangle defines the actual top-left
+     * point on the screen to be refreshed.
+     * @param rect rectagle describing part of canvas to move to display.
+     */
+    void blt(const NanoRect &rect) override;
+
+private:
+    const uint16_t *m_palette = nullptr;
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+//
+//                      1-BIT MEMORY-MAPPED FRAMEBUFFER
+//
+/////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * NanoCanvasVga1 draws directly in memory-mapped framebuffer of VGA and composite
+ * video controllers (__vga_buffer): each row takes width/8 bytes, and least significant
+ * bit of the byte is the left pixel. There is no separate tile buffer and no blt():
+ * video output shows changes on the next frame. The canvas supports the same drawing
+ * operations as NanoCanvas1, all of them are clipped to the framebuffer size.
+ * On atmega328p pass (uint8_t *)__vga_buffer to the canvas. On ESP32 draw between
+ * ssd1306_vgaLockFrame() and ssd1306_vgaUnlockFrame(), using ssd1306_vgaGetBuffer().
+ */
+class NanoCanvasVga1: public Print
+{
+public:
+    /** Fixed offset for all operation of NanoCanvasVga1 in pixels */
+    NanoPoint offset = { 0, 0 };
+
+    /**
+     * Creates new empty canvas object.
+     * If you this constructor is used, you must call begin() method before
+     * working with canvas.
+     */
+    NanoCanvasVga1()
+    {
+    }
+
+    /**
+     * Creates new canvas object for framebuffer.
+     *
+     * @param w - width of framebuffer, should be divided by 8
+     * @param h - height of framebuffer
+     * @param buffer - pointer to framebuffer
+     */
+    NanoCanvasVga1(lcduint_t w, lcduint_t h, uint8_t *buffer)
+    {
+        begin(w, h, buffer);
+    }
+
+    /**
+     * Initializes canvas object. Unlike NanoCanvas1, framebuffer content is not cleared.
+     *
+     * @param w - width of framebuffer, should be divided by 8
+     * @param h - height of framebuffer
+     * @param buffer - pointer to framebuffer
+     */
+    void begin(lcduint_t w, lcduint_t h, uint8_t *buffer);
+
+    /**
+     * Sets offset
+     * @param ox - X offset in pixels
+     * @param oy - Y offset in pixels
+     */
+    void setOffset(lcdint_t ox, lcdint_t oy) { offset.x = ox; offset.y = oy; };
+
+    /**
+     * Draws pixel on specified position
+     * @param x - position X
+     * @param y - position Y
+     * @note color can be set via setColor()
+     */
+    void putPixel(lcdint_t x, lcdint_t y);
+
+    /**
+     * Draws horizontal line
+     * @param x1 - position X
+     * @param y1 - position Y
+     * @param x2 - position X
+     * @note color can be set via setColor()
+     */
+    void drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2);
+
+    /**
+     * Draws vertical line
+     * @param x1 - position X
+     * @param y1 - position Y
+     * @param y2 - position Y
+     * @note color can be set via setColor()
+     */
+    void drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2);
+
+    /**
+     * Draws line
+     * @param x1 - position X
+     * @param y1 - position Y
+     * @param x2 - position X
+     * @param y2 - position Y
+     * @note color can be set via setColor()
+     */
+    void drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
+
+    /**
+     * Draws rectangle
+     * @param x1 - position X
+     * @param y1 - position Y
+     * @param x2 - position X
+     * @param y2 - position Y
+     * @note color can be set via setColor()
+     */
+    void drawRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
+
+    /**
+     * Fills rectangle area
+     * @param x1 - position X
+     * @param y1 - position Y
+     * @param x2 - position X
+     * @param y2 - position Y
+     * @note color can be set via setColor()
+     */
+    void fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
+
+    /**
+     * Fills rectangle area
+     * @param rect - structure, describing rectangle area
+     * @note color can be set via setColor()
+     */
+    void fillRect(const NanoRect &rect) { fillRect(rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y); }
+
+    /**
+     * Draws monochrome bitmap in native ssd1306 format, the same way as
+     * NanoCanvas1::drawBitmap1() does.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width in pixels
+     * @param h - height in pixels
+     * @param bitmap - monochrome bitmap data, located in flash
+     */
+    void drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
+
+    /**
+     * Draws monochrome bitmap in XBMP format, the same way as
+     * NanoCanvas1::drawXBitmap1() does.
+     *
+     * @param x - position X in pixels
+     * @param y - position Y in pixels
+     * @param w - width in pixels
+     * @param h - height in pixels
+     * @param bitmap - monochrome bitmap data, located in flash
+     */
+    void drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
+
+    /**
+     * Clears framebuffer
+     */
+    void clear();
+
+    /**
+     * Writes single character to canvas
+     * @param c - character code to print
+     */
+    size_t write(uint8_t c) override;
+
+    /**
+     * Draws single character to canvas
+     * @param c - character code to print
+     * @returns 0 if char is not printed
+     */
+    uint8_t printChar(uint8_t c);
+
+    /**
+     * Print text at specified position to canvas
+     *
+     * @param xpos  position in pixels
+     * @param y     position in pixels
+     * @param ch    pointer to NULL-terminated string.
+     * @param style specific font style to use
+     *
+     * @note Supports only STYLE_NORMAL and STYLE_BOLD
+     */
+    void printFixed(lcdint_t xpos, lcdint_t y, const char *ch, EFontStyle style = STYLE_NORMAL);
+
+    /**
+     * @brief Sets canvas drawing mode
+     * Sets canvas drawing mode. The set flags define transparency of output images
+     * @param modeFlags - combination of flags: CANVAS_TEXT_WRAP, CANVAS_MODE_TRANSPARENT
+     */
+    void setMode(uint8_t modeFlags) { m_textMode = modeFlags; };
+
+    /**
+     * Sets color: BLACK or WHITE
+     * @param color - color to set
+     */
+    void setColor(uint16_t color) { m_color = color; };
+
+private:
+    lcduint_t m_w = 0;     ///< width of framebuffer in pixels
+    lcduint_t m_h = 0;     ///< height of framebuffer in pixels
+    lcduint_t m_pitch = 0; ///< number of bytes in framebuffer row
+    lcdint_t  m_cursorX = 0;
+    lcdint_t  m_cursorY = 0;
+    uint8_t   m_textMode = 0;
+    EFontStyle m_fontStyle = STYLE_NORMAL;
+    uint32_t  m_utf8State = 0;
+    uint8_t * m_buf = nullptr;
+    uint16_t  m_color = 0xFFFF;
+
+    /** Sets or clears pixel, coordinates must be already clipped */
+    inline void setPixel(lcduint_t x, lcduint_t y, uint8_t on);
+};
+
 /**
  * @}
  */
@@ -0,0 +1,224 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file collision_grid.h Uniform grid broad-phase for collision checks
+ */
+
+#ifndef _NANO_COLLISION_GRID_H_
+#define _NANO_COLLISION_GRID_H_
+
+#include "point.h"
+#include "rect.h"
+#include "ssd1306_hal/io.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+/**
+ * @brief Uniform grid broad-phase for rectangle and point collision checks.
+ *
+ * Testing every object against every other one costs O(n^2) checks per frame.
+ * NanoCollisionGrid registers object rectangles in the cells of engine tile grid
+ * (cell size is engine tile size), so queries test only objects, sharing cells
+ * with the area being checked. All storage is static: N objects with ids
+ * 0..N-1 and NODES cell records (object, covering 2x2 cells, takes 4 records).
+ * Grid should be cleared and filled again, when objects move, usually once per frame.
+ *
+ * @tparam E NanoEngine type, for example NanoEngine1
+ * @tparam N max number of objects (up to 254)
+ * @tparam NODES max number of object cell records (up to 255)
+ */
+template<typename E, uint8_t N, uint8_t NODES = 2 * N>
+class NanoCollisionGrid
+{
+public:
+    /** Number of grid columns */
+    static const uint8_t COLS = E::NE_MAX_TILES_X;
+    /** Number of grid rows */
+    static const uint8_t ROWS = E::NE_MAX_TILES_Y;
+    /** Value, meaning no object */
+    static const uint8_t NONE = 0xFF;
+
+    NanoCollisionGrid()
+    {
+        clear();
+    }
+
+    /** Removes all objects from the grid */
+    void clear()
+    {
+        for (uint16_t i = 0; i < (uint16_t)COLS * ROWS; i++)
+        {
+            m_head[i] = NONE;
+        }
+        m_nodes = 0;
+    }
+
+    /**
+     * Registers object in the grid. Objects outside the screen are kept in border cells.
+     * @param id object id in range 0..N-1
+     * @param rect object rectangle
+     * @return false if there is no free cell records for the object
+     */
+    bool add(uint8_t id, const NanoRect &rect)
+    {
+        uint8_t c1, r1, c2, r2;
+        cells(rect, c1, r1, c2, r2);
+        if ((uint16_t)m_nodes + (uint16_t)(c2 - c1 + 1) * (r2 - r1 + 1) > NODES)
+        {
+            return false;
+        }
+        m_rects[id] = rect;
+        for (uint8_t r = r1; r <= r2; r++)
+        {
+            for (uint8_t c = c1; c <= c2; c++)
+            {
+                uint16_t cell = (uint16_t)r * COLS + c;
+                m_obj[m_nodes] = id;
+                m_next[m_nodes] = m_head[cell];
+                m_head[cell] = m_nodes++;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Calls callback(id) once for each object, intersecting the rectangle.
+     * @param rect area to check
+     * @param callback function or lambda, accepting uint8_t id
+     */
+    template<typename F>
+    void query(const NanoRect &rect, F callback)
+    {
+        uint8_t c1, r1, c2, r2;
+        cells(rect, c1, r1, c2, r2);
+        newQuery();
+        for (uint8_t r = r1; r <= r2; r++)
+        {
+            for (uint8_t c = c1; c <= c2; c++)
+            {
+                for (uint8_t n = m_head[(uint16_t)r * COLS + c]; n != NONE; n = m_next[n])
+                {
+                    uint8_t id = m_obj[n];
+                    if (m_stamp[id] == m_query) continue;
+                    m_stamp[id] = m_query;
+                    if (intersects(m_rects[id], rect)) callback(id);
+                }
+            }
+        }
+    }
+
+    /**
+     * Calls callback(id) for each object, containing the point.
+     * @param p point to check
+     * @param callback function or lambda, accepting uint8_t id
+     */
+    template<typename F>
+    void query(const NanoPoint &p, F callback)
+    {
+        for (uint8_t n = m_head[cell(p.y, ROWS) * COLS + cell(p.x, COLS)]; n != NONE; n = m_next[n])
+        {
+            if (m_rects[m_obj[n]].collision(p)) callback(m_obj[n]);
+        }
+    }
+
+    /**
+     * Calls callback(a, b) once for each pair of intersecting objects.
+     * @param callback function or lambda, accepting two uint8_t ids
+     */
+    template<typename F>
+    void pairs(F callback)
+    {
+        for (uint8_t r = 0; r < ROWS; r++)
+        {
+            for (uint8_t c = 0; c < COLS; c++)
+            {
+                for (uint8_t a = m_head[(uint16_t)r * COLS + c]; a != NONE; a = m_next[a])
+                {
+                    for (uint8_t b = m_next[a]; b != NONE; b = m_next[b])
+                    {
+                        const NanoRect &ra = m_rects[m_obj[a]];
+                        const NanoRect &rb = m_rects[m_obj[b]];
+                        if (!intersects(ra, rb)) continue;
+                        /* Pair is reported only by the cell with top-left corner of intersection */
+                        lcdint_t x = ra.p1.x > rb.p1.x ? ra.p1.x : rb.p1.x;
+                        lcdint_t y = ra.p1.y > rb.p1.y ? ra.p1.y : rb.p1.y;
+                        if ((cell(x, COLS) == c) && (cell(y, ROWS) == r))
+                        {
+                            callback(m_obj[a], m_obj[b]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    uint8_t m_head[(uint16_t)COLS * ROWS];
+    uint8_t m_next[NODES];
+    uint8_t m_obj[NODES];
+    NanoRect m_rects[N];
+    uint8_t m_stamp[N] = {};
+    uint8_t m_nodes = 0;
+    uint8_t m_query = 0;
+
+    static uint8_t cell(lcdint_t v, uint8_t count)
+    {
+        if (v < 0) return 0;
+        v >>= E::NE_TILE_SIZE_BITS;
+        return v >= count ? count - 1 : v;
+    }
+
+    static void cells(const NanoRect &rect, uint8_t &c1, uint8_t &r1, uint8_t &c2, uint8_t &r2)
+    {
+        c1 = cell(rect.p1.x, COLS);
+        r1 = cell(rect.p1.y, ROWS);
+        c2 = cell(rect.p2.x, COLS);
+        r2 = cell(rect.p2.y, ROWS);
+    }
+
+    static bool intersects(const NanoRect &a, const NanoRect &b)
+    {
+        return (a.p1.x <= b.p2.x) && (b.p1.x <= a.p2.x) &&
+               (a.p1.y <= b.p2.y) && (b.p1.y <= a.p2.y);
+    }
+
+    void newQuery()
+    {
+        if (++m_query == 0)
+        {
+            /* stamps wrapped around: forget old marks */
+            for (uint8_t i = 0; i < N; i++) m_stamp[i] = 0;
+            m_query = 1;
+        }
+    }
+};
+
+/**
+ * @}
+ */
+
+#endif
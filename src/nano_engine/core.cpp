@@ -56,9 +56,24 @@ void NanoEngineInputs::connectArduboyKeys()
 
 uint8_t NanoEngineInputs::s_zkeypadPin;
 
+#if defined(CONFIG_NANO_ENGINE_INPUT_ISR_ENABLE) && defined(__AVR__) && defined(ARDUINO)
+#define NE_ZKEYPAD_FREE_RUNNING_ADC
+/** Last value, measured by free-running ADC, -1 if ADC is not started */
+static volatile int16_t s_zkeypadValue = -1;
+
+ISR(ADC_vect)
+{
+    s_zkeypadValue = ADC;
+}
+#endif
+
 uint8_t NanoEngineInputs::zkeypadButtons()
 {
+#ifdef NE_ZKEYPAD_FREE_RUNNING_ADC
+    int buttonValue = s_zkeypadValue >= 0 ? s_zkeypadValue : analogRead(s_zkeypadPin);
+#else
     int buttonValue = analogRead(s_zkeypadPin);
+#endif
     if (buttonValue < 100) return BUTTON_RIGHT;
     if (buttonValue < 200) return BUTTON_UP;
     if (buttonValue < 400) return BUTTON_DOWN;
@@ -114,38 +129,316 @@ uint8_t NanoEngineInputs::gpioButtons()
     return buttons;
 }
 
+uint8_t NanoEngineInputs::s_ky40_clk;
+uint8_t NanoEngineInputs::s_ky40_dt;
+int8_t  NanoEngineInputs::s_ky40_sw = -1;
+/** Last state of encoder pins: CLK in bit 1, DT in bit 0 */
+uint8_t NanoEngineInputs::s_ky40_state;
+/** Quadrature transitions, accumulated since last detent */
+int8_t  NanoEngineInputs::s_ky40_phase;
+/** Full encoder steps, not yet consumed: positive for BUTTON_DOWN, negative for BUTTON_UP */
+volatile int8_t NanoEngineInputs::s_ky40_steps;
+/** True if encoder pins are decoded by pin change interrupts */
+bool    NanoEngineInputs::s_ky40_isr = false;
+
 void NanoEngineInputs::connectKY40encoder(uint8_t pina_clk, uint8_t pinb_dt, int8_t pinc_sw)
 {
     s_ky40_clk = pina_clk;
     s_ky40_dt = pinb_dt;
     s_ky40_sw = pinc_sw;
+    s_ky40_state = (digitalRead( s_ky40_clk ) == HIGH ? 2 : 0) | (digitalRead( s_ky40_dt ) == HIGH ? 1 : 0);
+    s_ky40_phase = 0;
+    s_ky40_steps = 0;
+    s_ky40_isr = false;
+#if defined(ARDUINO) && defined(digitalPinToInterrupt) && defined(NOT_AN_INTERRUPT)
+    if ( (digitalPinToInterrupt( pina_clk ) != NOT_AN_INTERRUPT) &&
+         (digitalPinToInterrupt( pinb_dt ) != NOT_AN_INTERRUPT) )
+    {
+        attachInterrupt( digitalPinToInterrupt( pina_clk ), ky40Decode, CHANGE );
+        attachInterrupt( digitalPinToInterrupt( pinb_dt ), ky40Decode, CHANGE );
+        s_ky40_isr = true;
+    }
+#endif
     m_onButtons = ky40Buttons;
 }
 
+void NanoEngineInputs::ky40Decode()
+{
+    /* Valid quadrature transitions give +1 (CLK leads DT) or -1 (DT leads CLK),
+     * invalid ones (both pins changed, contact bounce) are ignored */
+    static const int8_t transitions[16] = { 0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0 };
+    uint8_t state = (digitalRead( s_ky40_clk ) == HIGH ? 2 : 0) | (digitalRead( s_ky40_dt ) == HIGH ? 1 : 0);
+    s_ky40_phase += transitions[ (s_ky40_state << 2) | state ];
+    s_ky40_state = state;
+    /* KY-040 gives full quadrature cycle per detent */
+    if ( s_ky40_phase >= 4 )
+    {
+        s_ky40_phase = 0;
+        s_ky40_steps++;
+    }
+    else if ( s_ky40_phase <= -4 )
+    {
+        s_ky40_phase = 0;
+        s_ky40_steps--;
+    }
+}
+
+uint8_t NanoEngineInputs::ky40Switch()
+{
+    return ( s_ky40_sw >= 0 && digitalRead( s_ky40_sw ) == LOW ) ? BUTTON_A : BUTTON_NONE;
+}
+
 uint8_t NanoEngineInputs::ky40Buttons()
 {
-    static uint8_t last_clk = digitalRead( s_ky40_clk );
-    uint8_t buttons = BUTTON_NONE;
-    uint8_t clk = digitalRead( s_ky40_clk );
-    if ( clk != last_clk )
+    if ( !s_ky40_isr )
+    {
+        ky40Decode();
+    }
+    uint8_t buttons = ky40Switch();
+    if ( s_ky40_steps > 0 )
+    {
+        s_ky40_steps--;
+        buttons |= BUTTON_DOWN;
+    }
+    else if ( s_ky40_steps < 0 )
+    {
+        s_ky40_steps++;
+        buttons |= BUTTON_UP;
+    }
+    return buttons;
+}
+
+/** Original buttons reader, used when events are enabled */
+TNanoEngineGetButtons NanoEngineInputs::s_rawButtons = nullptr;
+/** Number of equal samples to accept new state */
+uint8_t NanoEngineInputs::s_debounce;
+/** Last sampled state, which is not accepted yet */
+uint8_t NanoEngineInputs::s_candidate;
+/** Number of samples, candidate state is stable for */
+uint8_t NanoEngineInputs::s_samples;
+/** Debounced buttons state */
+volatile uint8_t NanoEngineInputs::s_state;
+NanoInputEvent NanoEngineInputs::s_events[NE_INPUT_QUEUE_SIZE];
+volatile uint8_t NanoEngineInputs::s_eventPut;
+volatile uint8_t NanoEngineInputs::s_eventGet;
+/** Time of last raw input edge in microseconds, kept only if latency probe is enabled */
+uint32_t NanoEngineInputs::s_edgeUs;
+NanoEngineLatency *NanoEngineInputs::m_latency = nullptr;
+volatile uint32_t NanoEngineInputs::m_latencyInputUs = 0;
+bool NanoEngineInputs::m_latencyArmed = false;
+/** True if inputs are sampled by timer interrupt */
+bool NanoEngineInputs::m_inputTimer = false;
+
+void NanoEngineInputs::enableEvents(uint8_t debounce)
+{
+    if ( m_onButtons == eventButtons || m_onButtons == nullptr )
+    {
+        return;
+    }
+    /* Encoder steps are put to the queue directly, only switch needs debouncing */
+    s_rawButtons = m_onButtons == ky40Buttons ? ky40Switch : m_onButtons;
+    s_debounce = debounce ? debounce : 1;
+    s_state = s_rawButtons();
+    s_candidate = s_state;
+    s_samples = s_debounce;
+    s_eventPut = 0;
+    s_eventGet = 0;
+    m_onButtons = eventButtons;
+    startInputTimer();
+}
+
+uint8_t NanoEngineInputs::eventButtons()
+{
+    return s_state;
+}
+
+void NanoEngineInputs::pushEvent(uint8_t button, uint8_t pressed)
+{
+    uint8_t next = (s_eventPut + 1) & (NE_INPUT_QUEUE_SIZE - 1);
+    if ( next == s_eventGet )
+    {
+        /* Queue is full, the event is lost */
+        return;
+    }
+    s_events[s_eventPut].button = button;
+    s_events[s_eventPut].pressed = pressed;
+    s_eventPut = next;
+    if ( m_latency && !m_latencyInputUs )
     {
-        if ( clk == HIGH )
+        /* 0 means no edge, so odd timestamp is used instead, 1us error doesn't matter */
+        m_latencyInputUs = s_edgeUs | 1;
+    }
+}
+
+bool NanoEngineInputs::popEvent(NanoInputEvent &event)
+{
+    uint8_t get = s_eventGet;
+    if ( get == s_eventPut )
+    {
+        return false;
+    }
+    event = s_events[get];
+    s_eventGet = (get + 1) & (NE_INPUT_QUEUE_SIZE - 1);
+    if ( m_latencyInputUs )
+    {
+        m_latencyArmed = true;
+    }
+    return true;
+}
+
+uint16_t NanoEngineInputs::inputStamp()
+{
+    /* Raw state is read, since debounced state is not updated between frames without input timer */
+    TNanoEngineGetButtons buttons = s_rawButtons ? s_rawButtons : m_onButtons;
+    return ((uint16_t)s_eventPut << 8) | (buttons ? buttons() : 0);
+}
+
+void NanoEngineInputs::enableLatencyProbe(NanoEngineLatency *latency)
+{
+    m_latency = nullptr;
+    m_latencyArmed = false;
+    m_latencyInputUs = 0;
+    if (latency)
+    {
+        memset(latency, 0, sizeof(NanoEngineLatency));
+        latency->minUs = 0xFFFFFFFF;
+    }
+    m_latency = latency;
+}
+
+void NanoEngineInputs::addLatency(uint32_t us)
+{
+    if (m_latency)
+    {
+        uint32_t bucket = us / ((uint32_t)NE_LATENCY_BUCKET_MS * 1000);
+        m_latency->buckets[bucket < NE_LATENCY_BUCKETS ? bucket : NE_LATENCY_BUCKETS - 1]++;
+        if (us < m_latency->minUs) m_latency->minUs = us;
+        if (us > m_latency->maxUs) m_latency->maxUs = us;
+        m_latency->sumUs += us;
+        m_latency->count++;
+    }
+    m_latencyArmed = false;
+    m_latencyInputUs = 0;
+}
+
+void NanoEngineInputs::sampleInputs()
+{
+    if ( !s_rawButtons )
+    {
+        return;
+    }
+    if ( s_rawButtons == ky40Switch )
+    {
+        if ( !s_ky40_isr )
         {
-            buttons = digitalRead( s_ky40_dt ) == LOW ? BUTTON_DOWN : BUTTON_UP;
+            ky40Decode();
         }
-        else
+        if ( m_latency && s_ky40_steps ) s_edgeUs = micros();
+        while ( s_ky40_steps > 0 )
+        {
+            s_ky40_steps--;
+            pushEvent( BUTTON_DOWN, 1 );
+        }
+        while ( s_ky40_steps < 0 )
         {
-            buttons = digitalRead( s_ky40_dt ) == HIGH ? BUTTON_DOWN : BUTTON_UP;
+            s_ky40_steps++;
+            pushEvent( BUTTON_UP, 1 );
         }
     }
-    last_clk = clk;
-    if ( digitalRead( s_ky40_sw ) == LOW )
+    uint8_t buttons = s_rawButtons();
+    if ( buttons != s_candidate )
     {
-        buttons |= BUTTON_A;
+        s_candidate = buttons;
+        s_samples = 1;
+        if ( m_latency ) s_edgeUs = micros();
     }
-    return buttons;
+    else if ( s_samples < s_debounce )
+    {
+        s_samples++;
+    }
+    if ( s_samples >= s_debounce && s_candidate != s_state )
+    {
+        uint8_t changed = s_candidate ^ s_state;
+        for ( uint8_t button = 1; button; button <<= 1 )
+        {
+            if ( changed & button )
+            {
+                pushEvent( button, (s_candidate & button) ? 1 : 0 );
+            }
+        }
+        s_state = s_candidate;
+    }
+}
+
+#if defined(CONFIG_NANO_ENGINE_INPUT_ISR_ENABLE) && (defined(SSD1306_ESP_PLATFORM) || defined(ESP32))
+
+#include "esp_timer.h"
+
+static void inputTimerCallback(void *arg)
+{
+    NanoEngineInputs::sampleInputs();
+}
+
+void NanoEngineInputs::startInputTimer()
+{
+    static esp_timer_handle_t timer = NULL;
+    if ( !timer )
+    {
+        esp_timer_create_args_t args = {};
+        args.callback = inputTimerCallback;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "ne_inputs";
+        if ( esp_timer_create( &args, &timer ) != ESP_OK )
+        {
+            return;
+        }
+        esp_timer_start_periodic( timer, 1000 );
+    }
+    m_inputTimer = true;
+}
+
+#elif defined(CONFIG_NANO_ENGINE_INPUT_ISR_ENABLE) && defined(__AVR__) && defined(TIMSK0) && defined(OCIE0A)
+
+ISR(TIMER0_COMPA_vect)
+{
+    NanoEngineInputs::sampleInputs();
 }
 
+void NanoEngineInputs::startInputTimer()
+{
+    /* Arduino runs TIMER0 for millis(), otherwise start it with /64 prescaler:
+     * compare match happens once per timer period */
+    if ( !(TCCR0B & 0x07) )
+    {
+        TCCR0B = (1<<CS01) | (1<<CS00);
+    }
+    OCR0A = 0x80;
+    TIMSK0 |= (1<<OCIE0A);
+#ifdef NE_ZKEYPAD_FREE_RUNNING_ADC
+    if ( s_rawButtons == zkeypadButtons )
+    {
+        uint8_t channel = s_zkeypadPin >= A0 ? s_zkeypadPin - A0 : s_zkeypadPin;
+        ADMUX = (1<<REFS0) | (channel & 0x07);
+#ifdef ADCSRB
+        ADCSRB = 0;
+#endif
+        ADCSRA = (1<<ADEN) | (1<<ADSC) | (1<<ADATE) | (1<<ADIE) |
+                 (1<<ADPS2) | (1<<ADPS1) | (1<<ADPS0);
+    }
+#endif
+    m_inputTimer = true;
+}
+
+#else
+
+void NanoEngineInputs::startInputTimer()
+{
+    /* No input timer: inputs are sampled by NanoEngineCore::nextFrame() */
+    m_inputTimer = false;
+}
+
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 ////// NANO ENGINE CORE CLASS /////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -163,6 +456,38 @@ uint8_t   NanoEngineCore::m_cpuLoad = 0;
 uint32_t  NanoEngineCore::m_lastFrameTs;
 /** Callback to call before starting oled update */
 TLoopCallback NanoEngineCore::m_loop = nullptr;
+/** Profiler statistics, set only if profiler is enabled */
+NanoEngineProfile *NanoEngineCore::m_profile = nullptr;
+/** True if engine limits tiles drawing time to frame duration */
+bool      NanoEngineCore::m_adaptivePacing = false;
+/** Timestamp in milliseconds, nextFrame() decided to start new frame at */
+uint32_t  NanoEngineCore::m_frameStartTs = 0;
+/** True if frames are scheduled by platform frame timer */
+bool      NanoEngineCore::m_frameTimer = false;
+/** Current brightness level */
+uint8_t   NanoEngineCore::m_brightness = 0xFF;
+/** Brightness level at the start of active fade */
+uint8_t   NanoEngineCore::m_fadeFrom = 0xFF;
+/** Target brightness level of active fade */
+uint8_t   NanoEngineCore::m_fadeTarget = 0xFF;
+/** Timestamp in milliseconds active fade was started at */
+uint32_t  NanoEngineCore::m_fadeStartTs = 0;
+/** Duration of active fade in milliseconds, 0 if there is no active fade */
+uint16_t  NanoEngineCore::m_fadeDurationMs = 0;
+/** Frame rate in idle state, 0 if governor is not used */
+uint8_t   NanoEngineCore::m_idleFps = 0;
+/** Time without activity before switching to idle frame rate */
+uint16_t  NanoEngineCore::m_idleDelayMs = 0;
+/** Timestamp in milliseconds of last input or refresh */
+uint32_t  NanoEngineCore::m_activityTs = 0;
+/** True if frame rate is lowered by the governor */
+bool      NanoEngineCore::m_idle = false;
+/** Input stamp, seen by the governor last time */
+uint16_t  NanoEngineCore::m_inputStamp = 0;
+/** Duty cycle statistics, set only if enabled */
+NanoEngineDuty *NanoEngineCore::m_duty = nullptr;
+/** Timestamp in microseconds of current frame start */
+uint32_t  NanoEngineCore::m_frameStartUs = 0;
 
 
 void NanoEngineCore::begin()
@@ -175,14 +500,232 @@ void NanoEngineCore::setFrameRate(uint8_t fps)
     if ( fps > 0 )
     {
         m_fps = fps;
-        m_frameDurationMs = 1000/fps;
+        applyFrameRate();
     }
 }
 
+void NanoEngineCore::applyFrameRate()
+{
+    m_frameDurationMs = 1000 / (m_idle ? m_idleFps : m_fps);
+#if defined(CONFIG_PLATFORM_TIMER_AVAILABLE) && defined(CONFIG_PLATFORM_TIMER_ENABLE)
+    if (m_frameTimer) ssd1306_platform_timerStart( m_frameDurationMs );
+#endif
+}
+
+void NanoEngineCore::useFrameGovernor(uint8_t idleFps, uint16_t idleDelayMs)
+{
+    m_idleFps = idleFps;
+    m_idleDelayMs = idleDelayMs;
+    m_activityTs = millis();
+    m_inputStamp = inputStamp();
+    wakeUp();
+}
+
+void NanoEngineCore::wakeUp()
+{
+    m_activityTs = millis();
+    if (m_idle)
+    {
+        m_idle = false;
+        applyFrameRate();
+        /* Next nextFrame() call starts the frame without waiting for idle frame period */
+        m_lastFrameTs = m_activityTs - m_frameDurationMs;
+    }
+}
+
+bool NanoEngineCore::inputActivity()
+{
+    uint16_t stamp = inputStamp();
+    bool changed = stamp != m_inputStamp;
+    m_inputStamp = stamp;
+    return changed;
+}
+
+void NanoEngineCore::enableDutyStats(NanoEngineDuty *duty)
+{
+    m_duty = duty;
+    if (duty)
+    {
+        memset(duty, 0, sizeof(NanoEngineDuty));
+        duty->windowTs = millis();
+    }
+}
+
+void NanoEngineCore::endFrame(bool sent)
+{
+    uint32_t ts = millis();
+    if (m_idleFps)
+    {
+        if (sent) wakeUp();
+        else if (!m_idle && (uint32_t)(ts - m_activityTs) >= m_idleDelayMs)
+        {
+            m_idle = true;
+            applyFrameRate();
+        }
+    }
+    if (m_duty)
+    {
+        m_duty->curActiveUs += micros() - m_frameStartUs;
+        m_duty->curFrames++;
+        if (!sent) m_duty->curIdle++;
+        if ((uint32_t)(ts - m_duty->windowTs) >= 1000)
+        {
+            m_duty->activeUs = m_duty->curActiveUs;
+            m_duty->frames = m_duty->curFrames;
+            m_duty->idleFrames = m_duty->curIdle;
+            m_duty->curActiveUs = 0;
+            m_duty->curFrames = 0;
+            m_duty->curIdle = 0;
+            m_duty->windowTs = ts;
+        }
+    }
+}
+
+#if defined(CONFIG_PLATFORM_TIMER_AVAILABLE) && defined(CONFIG_PLATFORM_TIMER_ENABLE)
+void NanoEngineCore::useFrameTimer(bool enable)
+{
+    m_frameTimer = enable;
+    if (enable) ssd1306_platform_timerStart( m_frameDurationMs );
+    else ssd1306_platform_timerStop();
+}
+#endif
+
 bool NanoEngineCore::nextFrame()
 {
-    bool needUpdate = (uint32_t)(millis() - m_lastFrameTs) >= m_frameDurationMs;
-    if (needUpdate && m_loop) m_loop();
+#if defined(CONFIG_PLATFORM_TIMER_AVAILABLE) && defined(CONFIG_PLATFORM_TIMER_ENABLE)
+    if (m_frameTimer) ssd1306_platform_timerWait();
+#endif
+    if (m_idle && inputActivity()) wakeUp();
+    uint32_t ts = millis();
+    bool needUpdate = m_frameTimer || ((uint32_t)(ts - m_lastFrameTs) >= m_frameDurationMs);
+    if (needUpdate) m_frameStartTs = ts;
+    if (needUpdate && m_duty) m_frameStartUs = micros();
+    if (needUpdate && !m_inputTimer) sampleInputs();
+    if (needUpdate && m_idleFps && !m_idle && inputActivity()) m_activityTs = ts;
+    if (needUpdate && m_fadeDurationMs) updateFade(ts);
+    if (needUpdate && m_loop)
+    {
+        if (m_profile)
+        {
+            uint32_t ts = micros();
+            m_loop();
+            m_profile->frame.loopUs = micros() - ts;
+        }
+        else
+        {
+            m_loop();
+        }
+    }
     return needUpdate;
 }
 
+void NanoEngineCore::setBrightness(uint8_t level)
+{
+    m_fadeDurationMs = 0;
+    m_brightness = level;
+    if (ssd1306_lcd.set_brightness) ssd1306_lcd.set_brightness(level);
+}
+
+void NanoEngineCore::fadeTo(uint8_t level, uint16_t durationMs)
+{
+    if (!durationMs)
+    {
+        setBrightness(level);
+        return;
+    }
+    m_fadeFrom = m_brightness;
+    m_fadeTarget = level;
+    m_fadeStartTs = millis();
+    m_fadeDurationMs = durationMs;
+}
+
+void NanoEngineCore::updateFade(uint32_t ts)
+{
+    uint32_t elapsed = ts - m_fadeStartTs;
+    uint8_t level = m_fadeTarget;
+    if (elapsed < m_fadeDurationMs)
+    {
+        level = m_fadeFrom + (int16_t)(((int32_t)(m_fadeTarget - m_fadeFrom) * (int32_t)elapsed) / m_fadeDurationMs);
+    }
+    else
+    {
+        m_fadeDurationMs = 0;
+    }
+    /* Controller is touched only when level really changes */
+    if (level != m_brightness)
+    {
+        m_brightness = level;
+        if (ssd1306_lcd.set_brightness) ssd1306_lcd.set_brightness(level);
+    }
+}
+
+void NanoEngineCore::updateProfile(uint32_t frameUs)
+{
+    m_profile->frame.loopUs = 0;
+    if (frameUs > (uint32_t)m_frameDurationMs * 1000) m_profile->missed++;
+    m_profile->sumUs += frameUs;
+    if (frameUs < m_profile->curMinUs) m_profile->curMinUs = frameUs;
+    if (frameUs > m_profile->curMaxUs) m_profile->curMaxUs = frameUs;
+    if (++m_profile->count >= NE_PROFILER_FRAMES)
+    {
+        m_profile->minUs = m_profile->curMinUs;
+        m_profile->avgUs = m_profile->sumUs / m_profile->count;
+        m_profile->maxUs = m_profile->curMaxUs;
+        m_profile->sumUs = 0;
+        m_profile->curMinUs = 0xFFFFFFFF;
+        m_profile->curMaxUs = 0;
+        m_profile->count = 0;
+    }
+}
+
+/** Appends decimal number and separator to the string, returns pointer to the end */
+static char *appendNumber(char *str, uint32_t value, char separator)
+{
+    utoa(value, str, 10);
+    while (*str) str++;
+    *str++ = separator;
+    return str;
+}
+
+char *NanoEngineCore::profileString(char *str)
+{
+    char *p = str;
+    *p++ = 'F';
+    *p++ = ' ';
+    *p = '\0';
+    if (m_profile)
+    {
+        p = appendNumber(p, m_profile->minUs / 1000, '/');
+        p = appendNumber(p, m_profile->avgUs / 1000, '/');
+        p = appendNumber(p, m_profile->maxUs / 1000, ' ');
+        *p++ = 'M';
+        *p++ = ' ';
+        utoa(m_profile->missed, p, 10);
+    }
+    return str;
+}
+
+char *NanoEngineInputs::latencyString(char *str)
+{
+    char *p = str;
+    *p++ = 'L';
+    *p++ = ' ';
+    *p = '\0';
+    if (m_latency && m_latency->count)
+    {
+        p = appendNumber(p, m_latency->minUs / 1000, '/');
+        p = appendNumber(p, m_latency->sumUs / m_latency->count / 1000, '/');
+        p = appendNumber(p, m_latency->maxUs / 1000, ' ');
+        *p++ = 'N';
+        *p++ = ' ';
+        p = appendNumber(p, m_latency->count, ' ');
+        *p++ = 'H';
+        for (uint8_t i = 0; i < NE_LATENCY_BUCKETS; i++)
+        {
+            *p++ = ' ';
+            utoa(m_latency->buckets[i], p, 10);
+            while (*p) p++;
+        }
+    }
+    return str;
+}
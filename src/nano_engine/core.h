@@ -43,6 +43,37 @@ typedef uint8_t (*TNanoEngineGetButtons)(void);
 /** Type of user-specified loop callback */
 typedef void (*TLoopCallback)(void);
 
+#ifndef NE_PROFILER_FRAMES
+/** Number of frames, min/avg/max frame time is calculated over. Can be redefined via compiler options */
+#define NE_PROFILER_FRAMES   16
+#endif
+
+/** Frame statistics, collected by the engine profiler */
+typedef struct
+{
+    NanoEngineFrameStats frame; ///< timings of the last frame
+    uint32_t minUs;    ///< min frame time over last NE_PROFILER_FRAMES frames, in microseconds
+    uint32_t avgUs;    ///< average frame time over last NE_PROFILER_FRAMES frames, in microseconds
+    uint32_t maxUs;    ///< max frame time over last NE_PROFILER_FRAMES frames, in microseconds
+    uint16_t missed;   ///< number of frames, which didn't fit frame duration, since profiler start
+    uint32_t sumUs;    ///< internal: sum of frame times of current window
+    uint32_t curMinUs; ///< internal: min frame time of current window
+    uint32_t curMaxUs; ///< internal: max frame time of current window
+    uint8_t  count;    ///< internal: number of frames in current window
+} NanoEngineProfile;
+
+/** Duty cycle statistics, collected by the engine, see NanoEngineCore::enableDutyStats() */
+typedef struct
+{
+    uint32_t activeUs;    ///< time, spent in frames (loop callback and display()) during last second, in microseconds
+    uint16_t frames;      ///< number of frames during last second
+    uint16_t idleFrames;  ///< number of frames during last second, which had nothing to send to the display
+    uint32_t curActiveUs; ///< internal: active time of current second
+    uint16_t curFrames;   ///< internal: number of frames of current second
+    uint16_t curIdle;     ///< internal: number of idle frames of current second
+    uint32_t windowTs;    ///< internal: start of current second in milliseconds
+} NanoEngineDuty;
+
 ///////////////////////////////////////////////////////////////////////////////
 ////// NANO ENGINE INPUTS CLASS ///////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -58,6 +89,38 @@ enum
     BUTTON_B      = 0B00100000,
 };
 
+#ifndef NE_INPUT_QUEUE_SIZE
+/** Size of input events queue, should be power of 2. Can be redefined via compiler options */
+#define NE_INPUT_QUEUE_SIZE   8
+#endif
+
+#ifndef NE_LATENCY_BUCKETS
+/** Number of buckets in input latency histogram. Can be redefined via compiler options */
+#define NE_LATENCY_BUCKETS    8
+#endif
+
+#ifndef NE_LATENCY_BUCKET_MS
+/** Width of input latency histogram bucket in milliseconds. Can be redefined via compiler options */
+#define NE_LATENCY_BUCKET_MS  8
+#endif
+
+/** Input-to-display latency statistics, see NanoEngineInputs::enableLatencyProbe() */
+typedef struct
+{
+    uint16_t buckets[NE_LATENCY_BUCKETS]; ///< number of samples per NE_LATENCY_BUCKET_MS range, last bucket counts all longer ones
+    uint32_t minUs;    ///< min latency since probe start, in microseconds
+    uint32_t maxUs;    ///< max latency since probe start, in microseconds
+    uint32_t sumUs;    ///< sum of all latencies, in microseconds
+    uint16_t count;    ///< number of measured samples
+} NanoEngineLatency;
+
+/** Input event, queued by NanoEngineInputs::sampleInputs() */
+typedef struct
+{
+    uint8_t button;   ///< button, which state is changed: BUTTON_DOWN, BUTTON_LEFT, ...
+    uint8_t pressed;  ///< 1 if button is pressed, 0 if button is released
+} NanoInputEvent;
+
 /**
  * Class for keys processing functionality
  */
@@ -144,20 +207,112 @@ public:
      */
     static void connectGpioKeypad(const uint8_t *gpioKeys);
 
+    /**
+     * @brief Switches connected keys to event-driven mode.
+     *
+     * Keys, connected by one of connect functions, are sampled by sampleInputs(),
+     * debounced, and changes are put to the events queue (see popEvent()).
+     * buttonsState(), pressed() and notPressed() return debounced state.
+     * Inputs are sampled every millisecond by the timer interrupt, where available:
+     * esp_timer on ESP32, TIMER0 compare interrupt on AVR (if CONFIG_NANO_ENGINE_INPUT_ISR_ENABLE
+     * is defined). On AVR the same option makes Z-keypad ADC free-running, so
+     * analogRead() doesn't stall sampling. Other platforms sample inputs once per
+     * frame in nextFrame(). Rotary encoder pins, supporting external interrupts,
+     * are decoded on each pin change, so encoder steps are never lost.
+     * Call the function after connecting keys.
+     *
+     * @param debounce number of equal samples to accept new buttons state
+     */
+    static void enableEvents(uint8_t debounce = 3);
+
+    /**
+     * @brief Gets next event from input events queue.
+     *
+     * Each rotary encoder step generates press event of BUTTON_UP or BUTTON_DOWN,
+     * there are no release events for encoder steps.
+     *
+     * @param event reference to event structure to fill
+     * @return true if event is taken from the queue, false if queue is empty
+     */
+    static bool popEvent(NanoInputEvent &event);
+
+    /**
+     * @brief Samples keys and puts changes to events queue.
+     *
+     * The function is safe to call from interrupt handler, if your platform
+     * doesn't have input timer, you can call it from your own periodic interrupt.
+     */
+    static void sampleInputs();
+
+    /**
+     * @brief Enables input-to-photon latency probe.
+     *
+     * In events mode (see enableEvents()) the engine remembers time of raw input edge,
+     * before debouncing. When the event is taken by popEvent(), the first tile, sent to
+     * the display by next display() calls, completes the sample: latency is time from
+     * the edge to the end of the tile transfer. Samples are collected to histogram.
+     * Only one sample is measured at a time, edges during measurement are not sampled.
+     * @param latency structure to collect statistics to, or nullptr to disable probe
+     * @see latencyString()
+     */
+    static void enableLatencyProbe(NanoEngineLatency *latency);
+
+    /**
+     * Writes latency statistics as short text to the buffer: "L min/avg/max N count H b0 b1 ...",
+     * times are in milliseconds, b0 b1 ... are histogram buckets. Print it to serial console.
+     * @param str - buffer of at least 24 + 6 * NE_LATENCY_BUCKETS bytes
+     * @return str
+     */
+    static char *latencyString(char *str);
+
 protected:
     /** Callback to call if buttons state needs to be updated */
     static TNanoEngineGetButtons m_onButtons;
 
+    /** Latency statistics, set only if latency probe is enabled */
+    static NanoEngineLatency *m_latency;
+    /** Time of input edge, being measured, in microseconds. 0 if there is no such edge */
+    static volatile uint32_t m_latencyInputUs;
+    /** True if the event of measured edge is taken by application */
+    static bool m_latencyArmed;
+
+    /** Adds latency sample to statistics and allows to measure next edge */
+    static void addLatency(uint32_t us);
+
+    /** Returns value, which changes on new input: raw buttons state and events queue position */
+    static uint16_t inputStamp();
+
+    /** True if inputs are sampled by timer interrupt */
+    static bool m_inputTimer;
+
 private:
     static uint8_t s_zkeypadPin;
     static const uint8_t * s_gpioKeypadPins;
     static uint8_t s_ky40_clk;
     static uint8_t s_ky40_dt;
-    static uint8_t s_ky40_sw;
+    static int8_t s_ky40_sw;
+    static uint8_t s_ky40_state;
+    static int8_t s_ky40_phase;
+    static volatile int8_t s_ky40_steps;
+    static bool s_ky40_isr;
+    static TNanoEngineGetButtons s_rawButtons;
+    static uint8_t s_debounce;
+    static uint8_t s_candidate;
+    static uint8_t s_samples;
+    static volatile uint8_t s_state;
+    static NanoInputEvent s_events[NE_INPUT_QUEUE_SIZE];
+    static volatile uint8_t s_eventPut;
+    static volatile uint8_t s_eventGet;
+    static uint32_t s_edgeUs;
     static uint8_t zkeypadButtons();
     static uint8_t arduboyButtons();
     static uint8_t gpioButtons();
     static uint8_t ky40Buttons();
+    static uint8_t ky40Switch();
+    static void ky40Decode();
+    static uint8_t eventButtons();
+    static void pushEvent(uint8_t button, uint8_t pressed);
+    static void startInputTimer();
 };
 
 
@@ -199,17 +354,109 @@ public:
     static uint8_t getCpuLoad() { return m_cpuLoad; };
 
     /**
-     * Returns true if it is time to render next frame
+     * Returns true if it is time to render next frame.
+     * If frame timer is used, the function sleeps until next frame and always returns true.
      */
     static bool nextFrame();
 
+#if defined(CONFIG_PLATFORM_TIMER_AVAILABLE) && defined(CONFIG_PLATFORM_TIMER_ENABLE)
+    /**
+     * Switches frame scheduling from millis() polling to platform frame timer
+     * (TIMER1 on AVR, esp_timer on ESP32, timerfd on Linux). nextFrame() puts cpu
+     * to sleep until the frame is due instead of returning false, this lowers power
+     * consumption and frame jitter.
+     * @param enable - true to use frame timer, false to return to millis() polling
+     */
+    static void useFrameTimer(bool enable);
+#endif
+
     /**
      * Sets user-defined loop callback. This callback will be called once every time
      * new frame needs to be refreshed on oled display.
      */
     static void loopCallback(TLoopCallback callback) { m_loop = callback; };
 
+    /**
+     * Sets display brightness immediately via ssd1306_lcd.set_brightness() and
+     * stops active fade. Does nothing on controllers without brightness register.
+     * The engine assumes brightness 255 after display init.
+     * @param level - brightness [0-255]
+     */
+    static void setBrightness(uint8_t level);
+
+    /**
+     * Starts hardware brightness fade: nextFrame() moves controller contrast /
+     * master current linearly from current level to the target during specified
+     * time. Each step costs few command bytes, GDRAM content is not redrawn.
+     * Use it for screen fades and idle dimming instead of redrawing in darker colors.
+     * @param level - target brightness [0-255]
+     * @param durationMs - fade duration in milliseconds, 0 sets level immediately
+     */
+    static void fadeTo(uint8_t level, uint16_t durationMs);
+
+    /**
+     * Returns current brightness level, set by setBrightness() or fadeTo().
+     */
+    static uint8_t getBrightness() { return m_brightness; };
+
+    /**
+     * Returns true if brightness fade is still in progress.
+     */
+    static bool isFading() { return m_fadeDurationMs != 0; };
+
+    /**
+     * Writes profiler statistics as short text to the buffer: "F min/avg/max M missed",
+     * frame times are in milliseconds. Show it via notify() or print to serial console.
+     * @param str - buffer of at least 40 bytes
+     * @return str
+     */
+    static char *profileString(char *str);
+
+    /**
+     * Enables frame rate governor for battery powered devices. If there is no input and
+     * no tiles to refresh during idleDelayMs, frame rate is lowered to idleFps, so the cpu
+     * (sleeping in nextFrame() if frame timer is used) and display bus are mostly idle.
+     * Frame rate, set by setFrameRate(), is restored immediately on input (nextFrame()
+     * checks inputs between idle frames), on refresh request, found by display(), or
+     * on wakeUp() call.
+     * @param idleFps - frame rate in idle state [1-255], 0 disables governor
+     * @param idleDelayMs - time without activity before switching to idle frame rate
+     */
+    static void useFrameGovernor(uint8_t idleFps, uint16_t idleDelayMs = 1000);
+
+    /**
+     * Restores normal frame rate if the governor lowered it. Call it, when application
+     * gets events, which engine doesn't know about (serial commands, sensors).
+     */
+    static void wakeUp();
+
+    /**
+     * Returns true if the governor lowered frame rate.
+     */
+    static bool isIdle() { return m_idle; };
+
+    /**
+     * Enables duty cycle statistics: time per second, spent in frames, and number of
+     * idle frames. Active time per second is what defines power consumption of the cpu.
+     * @param duty - structure to collect statistics to, or nullptr to disable statistics
+     */
+    static void enableDutyStats(NanoEngineDuty *duty);
+
 protected:
+    /** Profiler statistics, set only if profiler is enabled */
+    static NanoEngineProfile *m_profile;
+    /** True if engine limits tiles drawing time to frame duration */
+    static bool      m_adaptivePacing;
+    /** Timestamp in milliseconds, nextFrame() decided to start new frame at */
+    static uint32_t  m_frameStartTs;
+    /** True if frames are scheduled by platform frame timer */
+    static bool      m_frameTimer;
+
+    /**
+     * Updates profiler statistics with total frame time
+     * @param frameUs - frame time in microseconds, including loop callback
+     */
+    static void updateProfile(uint32_t frameUs);
 
     /** Duration between frames in milliseconds */
     static uint8_t   m_frameDurationMs;
@@ -221,6 +468,49 @@ protected:
     static uint32_t  m_lastFrameTs;
     /** Callback to call before starting oled update */
     static TLoopCallback m_loop;
+    /** Current brightness level */
+    static uint8_t   m_brightness;
+    /** Brightness level at the start of active fade */
+    static uint8_t   m_fadeFrom;
+    /** Target brightness level of active fade */
+    static uint8_t   m_fadeTarget;
+    /** Timestamp in milliseconds active fade was started at */
+    static uint32_t  m_fadeStartTs;
+    /** Duration of active fade in milliseconds, 0 if there is no active fade */
+    static uint16_t  m_fadeDurationMs;
+
+    /** Frame rate in idle state, 0 if governor is not used */
+    static uint8_t   m_idleFps;
+    /** Time without activity before switching to idle frame rate */
+    static uint16_t  m_idleDelayMs;
+    /** Timestamp in milliseconds of last input or refresh */
+    static uint32_t  m_activityTs;
+    /** True if frame rate is lowered by the governor */
+    static bool      m_idle;
+    /** Input stamp (see inputStamp()), seen by the governor last time */
+    static uint16_t  m_inputStamp;
+    /** Duty cycle statistics, set only if enabled */
+    static NanoEngineDuty *m_duty;
+    /** Timestamp in microseconds of current frame start, used for duty cycle statistics */
+    static uint32_t  m_frameStartUs;
+
+    /**
+     * Moves brightness to the level, active fade has at specified time
+     * @param ts - current timestamp in milliseconds
+     */
+    static void updateFade(uint32_t ts);
+
+    /** Sets frame duration to the one of active or idle state */
+    static void applyFrameRate();
+
+    /** Returns true if new input arrived since last check of the governor */
+    static bool inputActivity();
+
+    /**
+     * Finishes frame for governor and duty cycle statistics. Called by display().
+     * @param sent - true if the frame had tiles to send to the display
+     */
+    static void endFrame(bool sent);
 };
 
 /**
@@ -257,6 +547,30 @@ public:
      */
     static void notify(const char *str);
 
+    /**
+     * Enables profiler, which collects per-frame timings of loop callback,
+     * draw callbacks and sending tiles to the display, and keeps rolling
+     * min/avg/max frame time and number of frames, which missed frame duration.
+     * @param profile - structure to collect statistics to, or nullptr to disable profiler
+     * @note Profiler adds micros() calls per tile, so keep it disabled in release builds.
+     * @see profileString()
+     */
+    static void enableProfiler(NanoEngineProfile *profile);
+
+    /**
+     * Enables adaptive frame pacing. On each display() call the engine limits
+     * tiles drawing time to the rest of frame duration, left after loop callback
+     * (refer to NanoEngineTiler::setFrameBudget()). Tiles, not fitting the frame,
+     * are drawn on next frames, so overloaded frames do not delay input processing.
+     * @param enable - true to enable adaptive pacing, false to draw all tiles each frame
+     * @note display() must be called after nextFrame() returns true.
+     */
+    static void useAdaptivePacing(bool enable)
+    {
+        m_adaptivePacing = enable;
+        if (!enable) NanoEngineTiler<C,W,H,B>::setFrameBudget(0);
+    }
+
 protected:
 };
 
@@ -270,7 +584,46 @@ template<class C, uint8_t W, uint8_t H, uint8_t B>
 void NanoEngine<C,W,H,B>::display()
 {
     m_lastFrameTs = millis();
-    NanoEngineTiler<C,W,H,B>::displayBuffer();
+    if (m_adaptivePacing)
+    {
+        uint32_t elapsed = m_lastFrameTs - m_frameStartTs;
+        NanoEngineTiler<C,W,H,B>::setFrameBudget( elapsed + 1 < m_frameDurationMs ?
+                                                  m_frameDurationMs - elapsed : 1 );
+    }
+    bool sent = NanoEngineTiler<C,W,H,B>::hasRefreshFlags();
+    NanoEngineTiler<C,W,H,B>::m_probeBlt = m_latencyArmed;
+#ifdef CONFIG_SSD1306_BUS_SHARE_ENABLE
+    /* All tiles of the frame are sent without releasing shared spi bus */
+    ssd1306_busBeginBurst();
+#endif
+    if (m_profile)
+    {
+        uint32_t ts = micros();
+        m_profile->frame.drawUs = 0;
+        m_profile->frame.bltUs = 0;
+        m_profile->frame.tiles = 0;
+        m_profile->frame.skipped = 0;
+        NanoEngineTiler<C,W,H,B>::displayBuffer();
+        uint32_t frameUs = m_profile->frame.loopUs + (micros() - ts);
+        updateProfile( frameUs );
+#ifdef SDL_EMULATION
+        sdl_core_frame_end( frameUs, m_profile->frame.tiles );
+#endif
+    }
+    else
+    {
+        NanoEngineTiler<C,W,H,B>::displayBuffer();
+    }
+    if (NanoEngineTiler<C,W,H,B>::m_heatmap) NanoEngineTiler<C,W,H,B>::showHeatmap();
+#ifdef CONFIG_SSD1306_BUS_SHARE_ENABLE
+    ssd1306_busEndBurst();
+#endif
+    if (m_latencyArmed && !NanoEngineTiler<C,W,H,B>::m_probeBlt)
+    {
+        addLatency(NanoEngineTiler<C,W,H,B>::m_firstBltUs - m_latencyInputUs);
+    }
+    NanoEngineTiler<C,W,H,B>::m_probeBlt = false;
+    if (m_idleFps || m_duty) endFrame(sent);
     m_cpuLoad = ((millis() - m_lastFrameTs)*100)/m_frameDurationMs;
 }
 
@@ -278,12 +631,30 @@ template<class C, uint8_t W, uint8_t H, uint8_t B>
 void NanoEngine<C,W,H,B>::begin()
 {
     NanoEngineCore::begin();
+    NanoEngineTiler<C,W,H,B>::selectContext();
+#ifdef SDL_EMULATION
+    /* Emulator collects frame statistics for input replays */
+    static NanoEngineProfile profile;
+    if (!m_profile && sdl_core_frame_stats_enabled()) enableProfiler(&profile);
+#endif
     if (C::BITS_PER_PIXEL > 1)
     {
         ssd1306_setMode(LCD_MODE_NORMAL);
     }
 }
 
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+void NanoEngine<C,W,H,B>::enableProfiler(NanoEngineProfile *profile)
+{
+    m_profile = profile;
+    NanoEngineTiler<C,W,H,B>::m_frameStats = profile ? &profile->frame : nullptr;
+    if (profile)
+    {
+        memset(profile, 0, sizeof(NanoEngineProfile));
+        profile->curMinUs = 0xFFFFFFFF;
+    }
+}
+
 template<class C, uint8_t W, uint8_t H, uint8_t B>
 void NanoEngine<C,W,H,B>::notify(const char *str)
 {
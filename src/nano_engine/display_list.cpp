@@ -0,0 +1,174 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "display_list.h"
+#include "canvas.h"
+#include "ssd1306_fonts.h"
+
+extern "C" SFixedFontInfo s_fixedFont;
+
+/* Records are aligned to pointer size, so they can be accessed directly in the arena */
+static const uint16_t NE_LIST_ALIGN = sizeof(void *);
+
+void NanoDisplayList::clear()
+{
+    m_used = 0;
+    m_overflow = false;
+    m_mode = 0;
+    m_origin = { 0, 0 };
+}
+
+NanoDisplayList::Op *NanoDisplayList::add(uint8_t type, lcdint_t x1, lcdint_t y1,
+                                          lcdint_t x2, lcdint_t y2, uint16_t extra)
+{
+    uint16_t size = (sizeof(Op) + extra + NE_LIST_ALIGN - 1) & ~(NE_LIST_ALIGN - 1);
+    if ((uint32_t)m_used + size > m_size)
+    {
+        m_overflow = true;
+        return nullptr;
+    }
+    Op *op = reinterpret_cast<Op *>(&m_buffer[m_used]);
+    m_used += size;
+    op->type = type;
+    op->arg = 0;
+    op->size = size;
+    op->box.setRect(x1 - m_origin.x, y1 - m_origin.y, x2 - m_origin.x, y2 - m_origin.y);
+    return op;
+}
+
+void NanoDisplayList::setColor(uint16_t color)
+{
+    Op *op = add(OP_COLOR, 0, 0, 0, 0);
+    if (op) op->color = color;
+}
+
+void NanoDisplayList::setMode(uint8_t modeFlags)
+{
+    Op *op = add(OP_MODE, 0, 0, 0, 0);
+    if (op) op->arg = modeFlags;
+    m_mode = modeFlags;
+}
+
+void NanoDisplayList::clearCanvas()
+{
+    add(OP_CLEAR, 0, 0, 0, 0);
+}
+
+void NanoDisplayList::opaque(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    add(OP_OPAQUE, x1, y1, x2, y2);
+}
+
+uint16_t NanoDisplayList::coverOffset(const NanoRect &area) const
+{
+    uint16_t cover = NO_COVER;
+    uint16_t pos = 0;
+    while (pos < m_used)
+    {
+        const Op &op = *reinterpret_cast<const Op *>(&m_buffer[pos]);
+        if ((op.type == OP_CLEAR) ||
+            (((op.type == OP_FILL_RECT) || (op.type == OP_OPAQUE)) && op.box.contains(area)))
+        {
+            cover = pos;
+        }
+        pos += op.size;
+    }
+    return cover;
+}
+
+void NanoDisplayList::putPixel(lcdint_t x, lcdint_t y)
+{
+    add(OP_PIXEL, x, y, x, y);
+}
+
+void NanoDisplayList::drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2)
+{
+    if (x2 < x1) { lcdint_t t = x1; x1 = x2; x2 = t; }
+    add(OP_HLINE, x1, y1, x2, y1);
+}
+
+void NanoDisplayList::drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2)
+{
+    if (y2 < y1) { lcdint_t t = y1; y1 = y2; y2 = t; }
+    add(OP_VLINE, x1, y1, x1, y2);
+}
+
+void NanoDisplayList::drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    Op *op = add(OP_LINE, min(x1, x2), min(y1, y2), max(x1, x2), max(y1, y2));
+    if (op) op->line.setRect(x1 - m_origin.x, y1 - m_origin.y, x2 - m_origin.x, y2 - m_origin.y);
+}
+
+void NanoDisplayList::drawRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    add(OP_RECT, x1, y1, x2, y2);
+}
+
+void NanoDisplayList::fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    add(OP_FILL_RECT, x1, y1, x2, y2);
+}
+
+void NanoDisplayList::addBitmap(uint8_t type, lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                                const uint8_t *bitmap)
+{
+    Op *op = add(type, x, y, x + w - 1, y + h - 1);
+    if (!op) return;
+    op->bitmap.w = w;
+    op->bitmap.h = h;
+    op->bitmap.data = bitmap;
+}
+
+void NanoDisplayList::drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    addBitmap(OP_BITMAP1, x, y, w, h, bitmap);
+}
+
+void NanoDisplayList::drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    addBitmap(OP_XBITMAP1, x, y, w, h, bitmap);
+}
+
+void NanoDisplayList::drawBitmap8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    addBitmap(OP_BITMAP8, x, y, w, h, bitmap);
+}
+
+void NanoDisplayList::drawBitmap16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    addBitmap(OP_BITMAP16, x, y, w, h, bitmap);
+}
+
+void NanoDisplayList::printFixed(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style)
+{
+    uint16_t len = strlen(ch);
+    /* Glyphs are not wider than font width, plus 1 pixel spacing. Text, wrapped *
+     * to the next lines, is replayed to every tile.                           */
+    uint8_t type = (m_mode & (CANVAS_TEXT_WRAP | CANVAS_TEXT_WRAP_LOCAL)) ? OP_TEXT_WRAP : OP_TEXT;
+    Op *op = add(type, x, y, x + len * (s_fixedFont.h.width + 1), y + s_fixedFont.h.height - 1, len + 1);
+    if (!op) return;
+    op->arg = style;
+    op->line.p1 = op->box.p1;
+    memcpy(op + 1, ch, len + 1);
+}
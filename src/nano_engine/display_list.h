@@ -0,0 +1,316 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file display_list.h Recording of draw operations for replaying per tile
+ */
+
+#ifndef _NANO_DISPLAY_LIST_H_
+#define _NANO_DISPLAY_LIST_H_
+
+#include "point.h"
+#include "rect.h"
+#include "ssd1306_hal/io.h"
+#include "nano_gfx_types.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+/**
+ * Replays 8-bit bitmaps only on canvases, supporting drawBitmap8() (8 and 16 bits per pixel)
+ * @warning Only for internal use.
+ */
+template<bool SUPPORTED>
+struct NanoDisplayListBitmap8
+{
+    /** Draws 8-bit bitmap on the canvas */
+    template<class C>
+    static void draw(C &canvas, lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+    {
+        canvas.drawBitmap8(x, y, w, h, bitmap);
+    }
+};
+
+/** 8-bit bitmaps are skipped on 1-bit and 4-bit canvases */
+template<>
+struct NanoDisplayListBitmap8<false>
+{
+    /** Does nothing */
+    template<class C>
+    static void draw(C &, lcdint_t, lcdint_t, lcduint_t, lcduint_t, const uint8_t *)
+    {
+    }
+};
+
+/**
+ * NanoDisplayList records draw operations of the scene once per frame into
+ * user-provided memory arena, and replays to engine canvas only operations,
+ * intersecting the tile, being updated. Use it via NanoEngine::useDisplayList():
+ * the engine calls draw callback once per frame, and the callback must draw with
+ * NanoDisplayList methods instead of canvas methods. Then every tile costs only
+ * operations, actually covering it, instead of whole scene code.
+ * Each operation takes 16 bytes on AVR and 32 bytes on 32-bit platforms, text
+ * operations take length of the string in addition.
+ *
+ * Operations, hidden under opaque covers, are not replayed: clearCanvas(), fillRect()
+ * and areas, declared with opaque(), hide everything recorded before them. Record the
+ * scene from back to front and declare opaque sprites and tile layers with opaque()
+ * to save pixel writes of the background, lying beneath them.
+ *
+ * @note Coordinates are recorded as is and replayed in canvas coordinates. Call
+ *       setOrigin() with engine position to record objects in global (World) coordinates.
+ */
+class NanoDisplayList
+{
+public:
+    /**
+     * Creates display list on user memory arena
+     * @param buffer memory for recorded operations
+     * @param size size of the buffer in bytes
+     */
+    NanoDisplayList(uint8_t *buffer, uint16_t size)
+         : m_buffer( buffer )
+         , m_size( size )
+    {
+        clear();
+    }
+
+    /** Removes all recorded operations. The engine calls it before each frame */
+    void clear();
+
+    /** Returns true if some operations were dropped since last clear(), because arena is full */
+    bool overflow() const { return m_overflow; }
+
+    /** Returns number of arena bytes, used by recorded operations */
+    uint16_t used() const { return m_used; }
+
+    /**
+     * Sets the point, subtracted from coordinates of all next operations.
+     * @param origin usually engine position for objects in global (World) coordinates,
+     *        or (0,0) for objects in screen coordinates.
+     */
+    void setOrigin(const NanoPoint &origin) { m_origin = origin; }
+
+    /** Records canvas.setColor() */
+    void setColor(uint16_t color);
+
+    /** Records canvas.setMode() */
+    void setMode(uint8_t modeFlags);
+
+    /** Records canvas.clear(), applied to every tile. Hides all operations, recorded before. */
+    void clearCanvas();
+
+    /**
+     * Declares, that operations recorded after this call cover the rectangle completely,
+     * for example opaque sprite or tile map cell is drawn next. Tiles, lying inside the
+     * rectangle, skip all operations recorded before, and engine skips loading background
+     * for them.
+     * @param x1 left of the opaque area
+     * @param y1 top of the opaque area
+     * @param x2 right of the opaque area
+     * @param y2 bottom of the opaque area
+     */
+    void opaque(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
+
+    /** Declares opaque area, see opaque(lcdint_t, lcdint_t, lcdint_t, lcdint_t) */
+    void opaque(const NanoRect &rect) { opaque(rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y); }
+
+    /** Records canvas.putPixel() */
+    void putPixel(lcdint_t x, lcdint_t y);
+
+    /** Records canvas.drawHLine() */
+    void drawHLine(lcdint_t x1, lcdint_t y1, lcdint_t x2);
+
+    /** Records canvas.drawVLine() */
+    void drawVLine(lcdint_t x1, lcdint_t y1, lcdint_t y2);
+
+    /** Records canvas.drawLine() */
+    void drawLine(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
+
+    /** Records canvas.drawRect() */
+    void drawRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
+
+    /** Records canvas.drawRect() */
+    void drawRect(const NanoRect &rect) { drawRect(rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y); }
+
+    /** Records canvas.fillRect(). Filled rectangle hides all operations, recorded before. */
+    void fillRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
+
+    /** Records canvas.fillRect() */
+    void fillRect(const NanoRect &rect) { fillRect(rect.p1.x, rect.p1.y, rect.p2.x, rect.p2.y); }
+
+    /**
+     * Records canvas.drawBitmap1(). Bitmap is not copied and must remain valid until
+     * the frame is displayed.
+     */
+    void drawBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
+
+    /** Records canvas.drawXBitmap1(). Bitmap is not copied. */
+    void drawXBitmap1(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
+
+    /** Records canvas.drawBitmap8(). Bitmap is not copied. Ignored by 1-bit and 4-bit canvases. */
+    void drawBitmap8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
+
+    /** Records canvas.drawBitmap16(). Bitmap is not copied. */
+    void drawBitmap16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
+
+    /**
+     * Records canvas.printFixed(). The string is copied to the arena. Area of the text
+     * is calculated from current font, so the font must not be changed until the frame
+     * is displayed.
+     */
+    void printFixed(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style = STYLE_NORMAL);
+
+    /**
+     * Draws recorded operations, intersecting canvas area, on the canvas.
+     * Color and mode operations are always applied, so every tile is drawn
+     * with the same state as the whole frame.
+     * @param canvas canvas to draw on
+     */
+    template<class C>
+    void replay(C &canvas) const;
+
+    /**
+     * Returns true if the area is completely covered by recorded clearCanvas(), fillRect()
+     * or opaque() operation, so content under it is not visible.
+     * @param area area in canvas coordinates
+     */
+    bool covers(const NanoRect &area) const { return coverOffset(area) != NO_COVER; }
+
+private:
+    enum
+    {
+        OP_COLOR,
+        OP_MODE,
+        OP_CLEAR,
+        OP_PIXEL,
+        OP_HLINE,
+        OP_VLINE,
+        OP_LINE,
+        OP_RECT,
+        OP_FILL_RECT,
+        OP_BITMAP1,
+        OP_XBITMAP1,
+        OP_BITMAP8,
+        OP_BITMAP16,
+        OP_TEXT,
+        OP_TEXT_WRAP,
+        OP_OPAQUE,
+    };
+
+    /** Returned by coverOffset() if area is not covered */
+    static const uint16_t NO_COVER = 0xFFFF;
+
+    /** Single recorded operation. Text of OP_TEXT follows the record */
+    typedef struct
+    {
+        uint8_t  type;
+        uint8_t  arg;       ///< font style for text, flags for OP_MODE
+        uint16_t size;      ///< record size in bytes, including text
+        NanoRect box;       ///< operation coordinates, and area, covered by the operation
+        union
+        {
+            struct
+            {
+                lcduint_t w;
+                lcduint_t h;
+                const uint8_t *data;
+            } bitmap;
+            NanoRect line;
+            uint16_t color;
+        };
+    } Op;
+
+    uint8_t   *m_buffer;
+    uint16_t   m_size;
+    uint16_t   m_used;
+    bool       m_overflow;
+    uint8_t    m_mode;
+    NanoPoint  m_origin;
+
+    Op *add(uint8_t type, lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint16_t extra = 0);
+
+    void addBitmap(uint8_t type, lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
+
+    /** Returns offset of the last operation, covering the area completely, or NO_COVER */
+    uint16_t coverOffset(const NanoRect &area) const;
+};
+
+template<class C>
+void NanoDisplayList::replay(C &canvas) const
+{
+    const NanoRect area = canvas.rect();
+    /* Only color and mode are restored from operations, hidden under opaque cover */
+    uint16_t cover = coverOffset(area);
+    if (cover == NO_COVER) cover = 0;
+    uint16_t pos = 0;
+    while (pos < m_used)
+    {
+        const Op &op = *reinterpret_cast<const Op *>(&m_buffer[pos]);
+        const bool hidden = pos < cover;
+        pos += op.size;
+        if (hidden && (op.type != OP_COLOR) && (op.type != OP_MODE)) continue;
+        switch (op.type)
+        {
+            case OP_COLOR: canvas.setColor(op.color); continue;
+            case OP_MODE: canvas.setMode(op.arg); continue;
+            case OP_CLEAR: canvas.clear(); continue;
+            case OP_TEXT_WRAP:
+                canvas.printFixed(op.line.p1.x, op.line.p1.y, reinterpret_cast<const char *>(&op + 1),
+                                  static_cast<EFontStyle>(op.arg));
+                continue;
+            default: break;
+        }
+        if ((op.box.p2.x < area.p1.x) || (op.box.p1.x > area.p2.x) ||
+            (op.box.p2.y < area.p1.y) || (op.box.p1.y > area.p2.y)) continue;
+        switch (op.type)
+        {
+            case OP_PIXEL: canvas.putPixel(op.box.p1.x, op.box.p1.y); break;
+            case OP_HLINE: canvas.drawHLine(op.box.p1.x, op.box.p1.y, op.box.p2.x); break;
+            case OP_VLINE: canvas.drawVLine(op.box.p1.x, op.box.p1.y, op.box.p2.y); break;
+            case OP_LINE: canvas.drawLine(op.line.p1.x, op.line.p1.y, op.line.p2.x, op.line.p2.y); break;
+            case OP_RECT: canvas.drawRect(op.box.p1.x, op.box.p1.y, op.box.p2.x, op.box.p2.y); break;
+            case OP_FILL_RECT: canvas.fillRect(op.box.p1.x, op.box.p1.y, op.box.p2.x, op.box.p2.y); break;
+            case OP_BITMAP1: canvas.drawBitmap1(op.box.p1.x, op.box.p1.y, op.bitmap.w, op.bitmap.h, op.bitmap.data); break;
+            case OP_XBITMAP1: canvas.drawXBitmap1(op.box.p1.x, op.box.p1.y, op.bitmap.w, op.bitmap.h, op.bitmap.data); break;
+            case OP_BITMAP8:
+                NanoDisplayListBitmap8<(C::BITS_PER_PIXEL >= 8)>::draw(canvas, op.box.p1.x, op.box.p1.y,
+                                                                        op.bitmap.w, op.bitmap.h, op.bitmap.data);
+                break;
+            case OP_BITMAP16: canvas.drawBitmap16(op.box.p1.x, op.box.p1.y, op.bitmap.w, op.bitmap.h, op.bitmap.data); break;
+            case OP_TEXT:
+                canvas.printFixed(op.line.p1.x, op.line.p1.y, reinterpret_cast<const char *>(&op + 1),
+                                  static_cast<EFontStyle>(op.arg));
+                break;
+            default: break;
+        }
+    }
+}
+
+/**
+ * @}
+ */
+
+#endif
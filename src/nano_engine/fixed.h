@@ -0,0 +1,254 @@
+/*
+    MIT License
+
+    Copyright (c) 2018, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file fixed.h Fixed point types for engine physics
+ */
+
+#ifndef _NANO_FIXED_H_
+#define _NANO_FIXED_H_
+
+#include "point.h"
+#include "rect.h"
+#include "ssd1306_hal/io.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+/**
+ * Fixed point number of T type with F fractional bits. W is type, wide enough
+ * to hold product of two T values. Use it instead of float for sub-pixel
+ * positions and velocities: on AVR floating point is software emulated and very slow.
+ * Refer to NanoFixed8_8 and NanoFixed16_16 types.
+ */
+template<typename T, typename W, uint8_t F>
+class NanoFixed
+{
+public:
+    /** Type, wide enough to hold product of two raw values */
+    typedef W WideType;
+
+    /** Number of fractional bits */
+    static const uint8_t FRACTION_BITS = F;
+
+    /** Creates zero value */
+    NanoFixed(): m_raw( 0 ) {}
+
+    /**
+     * Creates fixed point value from integer
+     * @param value integer value
+     */
+    NanoFixed(int16_t value): m_raw( (T)((W)value << F) ) {}
+
+    /**
+     * Converts fixed point value of other format
+     * @param value fixed point value to convert
+     */
+    template<typename T2, typename W2, uint8_t F2>
+    explicit NanoFixed(const NanoFixed<T2, W2, F2> &value)
+        : m_raw( F2 > F ? (T)(value.raw() >> (F2 > F ? F2 - F : 0))
+                        : (T)((W)value.raw() << (F > F2 ? F - F2 : 0)) ) {}
+
+    /**
+     * Creates fixed point value from raw representation
+     * @param raw value, multiplied by 2^F
+     */
+    static NanoFixed fromRaw(T raw) { NanoFixed v; v.m_raw = raw; return v; }
+
+    /**
+     * Creates fixed point value for the fraction num/den
+     * @param num numerator
+     * @param den denominator
+     */
+    static NanoFixed fraction(int16_t num, int16_t den) { return fromRaw( (T)(((W)num << F) / den) ); }
+
+    /** Returns raw representation, i.e. value multiplied by 2^F */
+    T raw() const { return m_raw; }
+
+    /** Returns integer part of the value, rounded to negative infinity */
+    lcdint_t toInt() const { return (lcdint_t)(m_raw >> F); }
+
+    /** Returns value, rounded to the nearest integer */
+    lcdint_t round() const { return (lcdint_t)((m_raw + ((T)1 << (F - 1))) >> F); }
+
+    NanoFixed& operator+=(const NanoFixed &v) { m_raw += v.m_raw; return *this; } ///< adds value
+    NanoFixed& operator-=(const NanoFixed &v) { m_raw -= v.m_raw; return *this; } ///< subtracts value
+    NanoFixed& operator*=(const NanoFixed &v) { m_raw = mul(m_raw, v.m_raw); return *this; } ///< multiplies by value
+    NanoFixed& operator/=(const NanoFixed &v) { m_raw = div(m_raw, v.m_raw); return *this; } ///< divides by value
+
+    NanoFixed operator+(const NanoFixed &v) const { return fromRaw( m_raw + v.m_raw ); } ///< returns sum
+    NanoFixed operator-(const NanoFixed &v) const { return fromRaw( m_raw - v.m_raw ); } ///< returns difference
+    NanoFixed operator*(const NanoFixed &v) const { return fromRaw( mul(m_raw, v.m_raw) ); } ///< returns product
+    NanoFixed operator/(const NanoFixed &v) const { return fromRaw( div(m_raw, v.m_raw) ); } ///< returns quotient
+    NanoFixed operator-() const { return fromRaw( -m_raw ); } ///< returns negative value
+
+    /**
+     * Shifts right the value, i.e. divides it by 2^bits
+     * @param bits number of bits to shift
+     */
+    NanoFixed operator>>(uint8_t bits) const { return fromRaw( m_raw >> bits ); }
+
+    /**
+     * Shifts left the value, i.e. multiplies it by 2^bits
+     * @param bits number of bits to shift
+     */
+    NanoFixed operator<<(uint8_t bits) const { return fromRaw( m_raw << bits ); }
+
+    bool operator==(const NanoFixed &v) const { return m_raw == v.m_raw; } ///< compares values
+    bool operator!=(const NanoFixed &v) const { return m_raw != v.m_raw; } ///< compares values
+    bool operator<(const NanoFixed &v) const { return m_raw < v.m_raw; }   ///< compares values
+    bool operator>(const NanoFixed &v) const { return m_raw > v.m_raw; }   ///< compares values
+    bool operator<=(const NanoFixed &v) const { return m_raw <= v.m_raw; } ///< compares values
+    bool operator>=(const NanoFixed &v) const { return m_raw >= v.m_raw; } ///< compares values
+
+private:
+    T m_raw;
+
+    static T mul(T a, T b) { return (T)(((W)a * b) >> F); }
+    static T div(T a, T b) { return (T)(((W)a << F) / b); }
+};
+
+/** Fixed point number with 8 integer and 8 fractional bits (-128..127.996) */
+typedef NanoFixed<int16_t, int32_t, 8> NanoFixed8_8;
+
+/** Fixed point number with 16 integer and 16 fractional bits (-32768..32767.99998) */
+typedef NanoFixed<int32_t, int64_t, 16> NanoFixed16_16;
+
+/**
+ * Describes point (or vector) with fixed point coordinates.
+ * Use it to keep sub-pixel positions and velocities of moving objects.
+ */
+template<typename N>
+struct NanoFixedPoint
+{
+    /** x position */
+    N x;
+    /** y position */
+    N y;
+
+    /** Creates zero point */
+    NanoFixedPoint() {}
+
+    /**
+     * Creates point with specified coordinates
+     * @param px x position
+     * @param py y position
+     */
+    NanoFixedPoint(const N &px, const N &py): x( px ), y( py ) {}
+
+    /**
+     * Creates point from integer point
+     * @param p integer point
+     */
+    NanoFixedPoint(const NanoPoint &p): x( p.x ), y( p.y ) {}
+
+    /** Returns integer point, rounded to negative infinity */
+    NanoPoint toPoint() const { return { x.toInt(), y.toInt() }; }
+
+    /** Adds point */
+    NanoFixedPoint& operator+=(const NanoFixedPoint &p) { x += p.x; y += p.y; return *this; }
+    /** Subtracts point */
+    NanoFixedPoint& operator-=(const NanoFixedPoint &p) { x -= p.x; y -= p.y; return *this; }
+    /** Returns sum of points */
+    NanoFixedPoint operator+(const NanoFixedPoint &p) const { return { x + p.x, y + p.y }; }
+    /** Returns difference of points */
+    NanoFixedPoint operator-(const NanoFixedPoint &p) const { return { x - p.x, y - p.y }; }
+    /** Returns vector, multiplied by scalar */
+    NanoFixedPoint operator*(const N &k) const { return { x * k, y * k }; }
+    /** Returns dot product of vectors */
+    N dot(const NanoFixedPoint &p) const { return x * p.x + y * p.y; }
+};
+
+/** Point with NanoFixed8_8 coordinates */
+typedef NanoFixedPoint<NanoFixed8_8> NanoPoint8_8;
+
+/** Point with NanoFixed16_16 coordinates */
+typedef NanoFixedPoint<NanoFixed16_16> NanoPoint16_16;
+
+/**
+ * Returns sine of the angle, using lookup table.
+ * @param angle angle in binary units: 256 units per full turn, 64 equals to 90 degrees
+ * @return sine in range -1..1
+ */
+NanoFixed8_8 nanoSin(uint8_t angle);
+
+/**
+ * Returns cosine of the angle, using lookup table.
+ * @param angle angle in binary units: 256 units per full turn, 64 equals to 90 degrees
+ * @return cosine in range -1..1
+ */
+inline NanoFixed8_8 nanoCos(uint8_t angle) { return nanoSin( angle + 64 ); }
+
+/**
+ * Returns unit vector, directed at specified angle. Multiply it by speed
+ * to get velocity of the object.
+ * @param angle angle in binary units: 256 units per full turn, 0 is x axis direction
+ */
+inline NanoPoint8_8 nanoDirection(uint8_t angle) { return { nanoCos( angle ), nanoSin( angle ) }; }
+
+/**
+ * Returns true if two circles intersect. The function doesn't use square root.
+ * @param c1 center of first circle
+ * @param r1 radius of first circle
+ * @param c2 center of second circle
+ * @param r2 radius of second circle
+ */
+template<typename N>
+bool nanoCirclesCollision(const NanoFixedPoint<N> &c1, const N &r1,
+                          const NanoFixedPoint<N> &c2, const N &r2)
+{
+    /* Raw values are halved, so sum of squares fits wide type */
+    typedef typename N::WideType W;
+    W dx = ((W)c1.x.raw() - c2.x.raw()) >> 1;
+    W dy = ((W)c1.y.raw() - c2.y.raw()) >> 1;
+    W r = ((W)r1.raw() + r2.raw()) >> 1;
+    return dx * dx + dy * dy <= r * r;
+}
+
+/**
+ * Returns true if the area, swept by moving point during the step (bounding box
+ * of its path), intersects the rectangle. Unlike checking the new position only,
+ * it detects fast objects, passing through thin obstacles in one step.
+ * @param p point position before the step
+ * @param v point velocity (step)
+ * @param rect rectangle to check
+ */
+template<typename N>
+bool nanoSweepCollision(const NanoFixedPoint<N> &p, const NanoFixedPoint<N> &v, const NanoRect &rect)
+{
+    NanoFixedPoint<N> e = p + v;
+    lcdint_t x1 = (v.x < N()) ? e.x.toInt() : p.x.toInt();
+    lcdint_t x2 = (v.x < N()) ? p.x.toInt() : e.x.toInt();
+    lcdint_t y1 = (v.y < N()) ? e.y.toInt() : p.y.toInt();
+    lcdint_t y2 = (v.y < N()) ? p.y.toInt() : e.y.toInt();
+    return (x1 <= rect.p2.x) && (x2 >= rect.p1.x) && (y1 <= rect.p2.y) && (y2 >= rect.p1.y);
+}
+
+/**
+ * @}
+ */
+
+#endif
+
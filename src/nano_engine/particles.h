@@ -0,0 +1,219 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file particles.h Particle system for NanoEngine
+ */
+
+#ifndef _NANO_PARTICLES_H_
+#define _NANO_PARTICLES_H_
+
+#include "point.h"
+#include "rect.h"
+#include "ssd1306_hal/io.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+/**
+ * @brief Particle system, drawing up to N single pixel particles.
+ *
+ * Unlike sprites, particles are not separate objects: positions, velocities and
+ * life counters are kept in separate arrays (structure of arrays), and update()
+ * moves all particles in one loop. Positions are fixed point numbers with
+ * NanoParticles::FRACTION_BITS fractional bits (range -2048..2047 pixels), velocities
+ * are in 1/16 pixel per update() call. Tiles, touched by particles, are collected
+ * to the bitmap and passed to the engine once per update(). Particles are also
+ * sorted by tile rows, so draw() checks only particles, falling into the rows
+ * of the tile being drawn. Particles use global (world) coordinates.
+ * It requires NanoEngine type, NanoEngine instance and maximum number of particles
+ * (up to 255) as arguments.
+ */
+template<typename T, T &E, uint8_t N>
+class NanoParticles
+{
+public:
+    /** Number of fractional bits in particle positions and velocities */
+    static const uint8_t FRACTION_BITS = 4;
+
+    /**
+     * Adds new particle.
+     * @param pos position in global coordinates
+     * @param vx horizontal velocity in 1/16 pixel per update
+     * @param vy vertical velocity in 1/16 pixel per update
+     * @param life number of updates, particle lives
+     * @return false if there is no free slot
+     */
+    bool emit(const NanoPoint &pos, int8_t vx, int8_t vy, uint8_t life)
+    {
+        if ((m_count >= N) || !life) return false;
+        m_x[m_count] = pos.x << FRACTION_BITS;
+        m_y[m_count] = pos.y << FRACTION_BITS;
+        m_vx[m_count] = vx;
+        m_vy[m_count] = vy;
+        m_life[m_count] = life;
+        m_count++;
+        E.refreshWorld( pos );
+        m_sorted = false;
+        return true;
+    }
+
+    /**
+     * Sets acceleration, added to vertical velocity of all particles on each update.
+     * @param gravity acceleration in 1/16 pixel per update^2
+     */
+    void setGravity(int8_t gravity) { m_gravity = gravity; }
+
+    /**
+     * Moves all particles, removes dead ones and marks touched tiles for refresh.
+     * Call it once per frame.
+     */
+    void update()
+    {
+        uint8_t dirty[T::NE_MAX_TILES_Y][T::NE_TILES_ROW_BYTES] = {};
+        const NanoPoint &offset = E.getPosition();
+        uint8_t i = 0;
+        while (i < m_count)
+        {
+            mark( dirty, m_x[i], m_y[i], offset );
+            if (!--m_life[i])
+            {
+                m_count--;
+                m_x[i] = m_x[m_count];
+                m_y[i] = m_y[m_count];
+                m_vx[i] = m_vx[m_count];
+                m_vy[i] = m_vy[m_count];
+                m_life[i] = m_life[m_count];
+                continue;
+            }
+            int16_t vy = m_vy[i] + m_gravity;
+            m_vy[i] = vy > 127 ? 127 : (vy < -128 ? -128 : vy);
+            m_x[i] += m_vx[i];
+            m_y[i] += m_vy[i];
+            mark( dirty, m_x[i], m_y[i], offset );
+            i++;
+        }
+        E.refreshTiles( dirty );
+        m_sorted = false;
+    }
+
+    /**
+     * Draws particles, falling into canvas area being updated, with current canvas color.
+     * Call it from the engine draw callback. Particle coordinates and canvas offset must
+     * be in the same coordinates system (refer to NanoEngine worldCoordinates()).
+     */
+    void draw()
+    {
+        if (!m_sorted) sort();
+        const NanoRect area = E.canvas.rect();
+        lcdint_t first = area.p1.y >> T::NE_TILE_SIZE_BITS;
+        lcdint_t rows = (area.p2.y >> T::NE_TILE_SIZE_BITS) - first + 1;
+        if (rows > BUCKETS) rows = BUCKETS;
+        for (lcdint_t r = 0; r < rows; r++)
+        {
+            uint8_t bucket = (first + r) & (BUCKETS - 1);
+            for (uint8_t j = m_start[bucket]; j < m_start[bucket + 1]; j++)
+            {
+                uint8_t i = m_order[j];
+                lcdint_t x = m_x[i] >> FRACTION_BITS;
+                lcdint_t y = m_y[i] >> FRACTION_BITS;
+                if ((x < area.p1.x) || (x > area.p2.x) ||
+                    (y < area.p1.y) || (y > area.p2.y)) continue;
+                E.canvas.putPixel( x, y );
+            }
+        }
+    }
+
+    /** Removes all particles and marks their positions for refresh */
+    void clear()
+    {
+        for (uint8_t i = 0; i < m_count; i++)
+        {
+            E.refreshWorld( (NanoPoint){ (lcdint_t)(m_x[i] >> FRACTION_BITS),
+                                         (lcdint_t)(m_y[i] >> FRACTION_BITS) } );
+        }
+        m_count = 0;
+        m_sorted = false;
+    }
+
+    /** Returns number of live particles */
+    uint8_t count() const { return m_count; }
+
+private:
+    /** Number of tile row buckets, repeating each BUCKETS tile rows */
+    static const uint8_t BUCKETS = 32;
+
+    int16_t  m_x[N];
+    int16_t  m_y[N];
+    int8_t   m_vx[N];
+    int8_t   m_vy[N];
+    uint8_t  m_life[N];
+    uint8_t  m_order[N];
+    uint8_t  m_start[BUCKETS + 1];
+    uint8_t  m_count = 0;
+    int8_t   m_gravity = 0;
+    bool     m_sorted = false;
+
+    static void mark(uint8_t dirty[T::NE_MAX_TILES_Y][T::NE_TILES_ROW_BYTES],
+                     int16_t fx, int16_t fy, const NanoPoint &offset)
+    {
+        lcdint_t x = (fx >> FRACTION_BITS) - offset.x;
+        lcdint_t y = (fy >> FRACTION_BITS) - offset.y;
+        if ((x < 0) || (y < 0)) return;
+        x >>= T::NE_TILE_SIZE_BITS;
+        y >>= T::NE_TILE_SIZE_BITS;
+        if ((x >= T::NE_MAX_TILES_X) || (y >= T::NE_MAX_TILES_Y)) return;
+        dirty[y][x >> 3] |= (1 << (x & 0x07));
+    }
+
+    /** Sorts particles by tile row buckets (counting sort) */
+    void sort()
+    {
+        for (uint8_t b = 0; b <= BUCKETS; b++) m_start[b] = 0;
+        for (uint8_t i = 0; i < m_count; i++)
+        {
+            m_start[bucket(m_y[i]) + 1]++;
+        }
+        for (uint8_t b = 0; b < BUCKETS; b++) m_start[b + 1] += m_start[b];
+        uint8_t pos[BUCKETS];
+        for (uint8_t b = 0; b < BUCKETS; b++) pos[b] = m_start[b];
+        for (uint8_t i = 0; i < m_count; i++)
+        {
+            m_order[pos[bucket(m_y[i])]++] = i;
+        }
+        m_sorted = true;
+    }
+
+    static uint8_t bucket(int16_t fy)
+    {
+        return ((fy >> FRACTION_BITS) >> T::NE_TILE_SIZE_BITS) & (BUCKETS - 1);
+    }
+};
+
+/**
+ * @}
+ */
+
+#endif
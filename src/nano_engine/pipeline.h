@@ -0,0 +1,197 @@
+/*
+    MIT License
+
+    Copyright (c) 2018, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file pipeline.h Pipelined NanoEngine for dual-core platforms
+ */
+
+#ifndef _NANO_ENGINE_PIPELINE_H_
+#define _NANO_ENGINE_PIPELINE_H_
+
+#include "core.h"
+
+#if defined(SSD1306_ESP_PLATFORM) || defined(ESP32)
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+#ifndef NE_PIPELINE_TASK_STACK
+/** Stack size in bytes for the pipeline blit task. Can be redefined via compiler options */
+#define NE_PIPELINE_TASK_STACK  2048
+#endif
+
+/**
+ * NanoEnginePipelined works in the same way as NanoEngine, but sends tiles to the display
+ * from separate task, running on another core. While one tile is being sent to the
+ * display, the draw callback renders next tile, so rendering is hidden behind display
+ * transfers. Rendered tiles are passed to the blit task via two tile buffers, with single
+ * producer / single consumer handoff. Canvases, larger than single tile (tile runs,
+ * full-screen buffer), are sent by the drawing task itself after the queue is empty.
+ * @warning do not access the display from your code while display() is in progress.
+ */
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+class NanoEnginePipelined: public NanoEngine<C,W,H,B>
+{
+public:
+    /**
+     * Initializes engine and starts blit task on the core, which is not used by
+     * the calling task.
+     */
+    static void begin();
+
+    /**
+     * @brief refreshes content on oled display.
+     * Refreshes content on oled display. Call it, if you want to update the screen.
+     * Engine will update only those areas, which are marked by refresh()
+     * methods. The function returns after all tiles are sent to the display.
+     */
+    static void display();
+
+private:
+    typedef NanoEngineTiler<C,W,H,B> Tiler;
+
+    /** Canvases, describing tiles, ready to be sent to the display */
+    static C m_slots[2];
+    /** Tile buffers for m_slots */
+    static uint8_t m_slotBuffers[2][W * H * C::BITS_PER_PIXEL / 8];
+    /** Number of tiles, passed to blit task. Changed by drawing task only */
+    static volatile uint8_t m_head;
+    /** Number of tiles, sent to the display. Changed by blit task only */
+    static volatile uint8_t m_tail;
+    static TaskHandle_t m_producer;
+    static TaskHandle_t m_consumer;
+
+    static void handoff();
+    static void bltTask(void *arg);
+};
+
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+C NanoEnginePipelined<C,W,H,B>::m_slots[2] = { C(W, H, m_slotBuffers[0]), C(W, H, m_slotBuffers[1]) };
+
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+uint8_t NanoEnginePipelined<C,W,H,B>::m_slotBuffers[2][W * H * C::BITS_PER_PIXEL / 8];
+
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+volatile uint8_t NanoEnginePipelined<C,W,H,B>::m_head = 0;
+
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+volatile uint8_t NanoEnginePipelined<C,W,H,B>::m_tail = 0;
+
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+TaskHandle_t NanoEnginePipelined<C,W,H,B>::m_producer = nullptr;
+
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+TaskHandle_t NanoEnginePipelined<C,W,H,B>::m_consumer = nullptr;
+
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+void NanoEnginePipelined<C,W,H,B>::begin()
+{
+    NanoEngine<C,W,H,B>::begin();
+    if (!m_consumer)
+    {
+#if portNUM_PROCESSORS > 1
+        BaseType_t core = xPortGetCoreID() ^ 1;
+#else
+        BaseType_t core = 0;
+#endif
+        xTaskCreatePinnedToCore(bltTask, "ne_blt", NE_PIPELINE_TASK_STACK, nullptr,
+                                uxTaskPriorityGet(nullptr), &m_consumer, core);
+    }
+    Tiler::m_onBlt = handoff;
+}
+
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+void NanoEnginePipelined<C,W,H,B>::display()
+{
+    m_producer = xTaskGetCurrentTaskHandle();
+    NanoEngineCore::m_lastFrameTs = millis();
+    Tiler::displayBuffer();
+    while (m_tail != m_head)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    NanoEngineCore::m_cpuLoad = ((millis() - NanoEngineCore::m_lastFrameTs)*100)/NanoEngineCore::m_frameDurationMs;
+}
+
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+void NanoEnginePipelined<C,W,H,B>::handoff()
+{
+    // Wait until blit task releases one of tile buffers
+    while ((uint8_t)(m_head - m_tail) >= 2)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    NanoRect rect = Tiler::canvas.rect();
+    const uint32_t size = (uint32_t)rect.width() * rect.height() * C::BITS_PER_PIXEL / 8;
+    if (size > sizeof(m_slotBuffers[0]))
+    {
+        // Runs of tiles and full-screen canvas do not fit tile slots: the canvas
+        // is sent from this task, when blit task completes all queued tiles
+        while (m_tail != m_head)
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        __sync_synchronize();
+        Tiler::canvas.blt(Tiler::canvas.offset.x, Tiler::gdramY(Tiler::canvas.offset.y));
+        return;
+    }
+    uint8_t index = m_head & 1;
+    m_slots[index].setSize(rect.width(), rect.height());
+    m_slots[index].setOffset(rect.p1.x, Tiler::gdramY(rect.p1.y));
+    // Canvas may draw to tile runs strip or full-screen buffer instead of m_buffer
+    memcpy(m_slotBuffers[index], Tiler::canvasBuffer(), size);
+    // Tile data must be visible to another core before index is updated
+    __sync_synchronize();
+    m_head = m_head + 1;
+    xTaskNotifyGive(m_consumer);
+}
+
+template<class C, uint8_t W, uint8_t H, uint8_t B>
+void NanoEnginePipelined<C,W,H,B>::bltTask(void *arg)
+{
+    for(;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (m_tail != m_head)
+        {
+            __sync_synchronize();
+            m_slots[m_tail & 1].blt();
+            __sync_synchronize();
+            m_tail = m_tail + 1;
+            xTaskNotifyGive(m_producer);
+        }
+    }
+}
+
+/**
+ * @}
+ */
+
+#endif
+
+#endif
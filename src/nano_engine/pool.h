@@ -0,0 +1,196 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file pool.h Static pool of engine objects
+ */
+
+#ifndef _NANO_POOL_H_
+#define _NANO_POOL_H_
+
+#include "rect.h"
+#include "ssd1306_hal/io.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+/**
+ * @brief Static pool of game objects with constant time spawn and despawn.
+ *
+ * Pool keeps N objects of type O in static array, so objects, appearing and
+ * disappearing often (bullets, particles, popups), need neither heap nor search
+ * for free slot. Active and free objects are kept in one array of object ids:
+ * first count() ids are active objects, the rest is the free list. spawn() takes
+ * the first free id, despawn() swaps the id with the last active one, so both
+ * work in O(1), and forEach() walks active objects without touching free ones.
+ *
+ * Object id (0..N-1) never changes, so it can be used as object id for
+ * NanoCollisionGrid. Objects are created once by default constructor and are
+ * not constructed again by spawn(): initialize fields after spawning. Sprites,
+ * which have no default constructor, can be wrapped to a structure with default
+ * member initializers.
+ *
+ * @tparam O object type
+ * @tparam N max number of objects (up to 255)
+ */
+template<typename O, uint8_t N>
+class NanoObjectPool
+{
+public:
+    /** Value, meaning no object */
+    static const uint8_t NONE = 0xFF;
+
+    NanoObjectPool()
+    {
+        clear();
+    }
+
+    /** Returns all objects to the free list */
+    void clear()
+    {
+        for (uint8_t i = 0; i < N; i++)
+        {
+            m_order[i] = i;
+            m_index[i] = NONE;
+        }
+        m_count = 0;
+    }
+
+    /**
+     * Takes object from the free list.
+     * @return pointer to the object or nullptr if all objects are active
+     */
+    O *spawn()
+    {
+        if (m_count >= N) return nullptr;
+        uint8_t id = m_order[m_count];
+        m_index[id] = m_count++;
+        return &m_objects[id];
+    }
+
+    /**
+     * Returns active object to the free list. Last active object takes its place
+     * in the active list, so iteration order of active objects changes.
+     * @param id object id
+     */
+    void despawn(uint8_t id)
+    {
+        uint8_t i = m_index[id];
+        if (i == NONE) return;
+        uint8_t last = m_order[--m_count];
+        m_order[i] = last;
+        m_index[last] = i;
+        m_order[m_count] = id;
+        m_index[id] = NONE;
+    }
+
+    /**
+     * Returns active object to the free list.
+     * @param obj object, taken from this pool
+     */
+    void despawn(O &obj)
+    {
+        despawn( id( obj ) );
+    }
+
+    /** Returns id of the object, taken from this pool */
+    uint8_t id(const O &obj) const { return &obj - m_objects; }
+
+    /** Returns object by id */
+    O &operator[](uint8_t id) { return m_objects[id]; }
+
+    /** Returns true if object with specified id is active */
+    bool active(uint8_t id) const { return m_index[id] != NONE; }
+
+    /** Returns number of active objects */
+    uint8_t count() const { return m_count; }
+
+    /** Returns true if there are no free objects */
+    bool full() const { return m_count >= N; }
+
+    /**
+     * Calls callback(obj) for each active object. Callback may despawn the object,
+     * passed to it, and spawn new ones: new objects are not visited in this pass.
+     * @param callback function or lambda, accepting O &
+     */
+    template<typename F>
+    void forEach(F callback)
+    {
+        for (uint8_t i = m_count; i > 0; i--)
+        {
+            callback( m_objects[m_order[i - 1]] );
+        }
+    }
+
+    /**
+     * Registers all active objects in collision grid, using pool ids as grid ids.
+     * Object type must provide rect() method.
+     * @param grid NanoCollisionGrid with at least N objects
+     * @return false if grid has no free cell records for some objects
+     */
+    template<typename G>
+    bool addTo(G &grid)
+    {
+        bool result = true;
+        for (uint8_t i = 0; i < m_count; i++)
+        {
+            uint8_t id = m_order[i];
+            result = grid.add( id, m_objects[id].rect() ) && result;
+        }
+        return result;
+    }
+
+    /**
+     * Draws active objects, intersecting the area, usually canvas rect of the tile
+     * being drawn. Object type must provide rect() and draw() methods, like
+     * NanoSprite and NanoFixedSprite do.
+     * @param area area being drawn
+     */
+    void draw(const NanoRect &area)
+    {
+        for (uint8_t i = 0; i < m_count; i++)
+        {
+            O &obj = m_objects[m_order[i]];
+            const NanoRect r = obj.rect();
+            if ((r.p2.x < area.p1.x) || (r.p1.x > area.p2.x) ||
+                (r.p2.y < area.p1.y) || (r.p1.y > area.p2.y)) continue;
+            obj.draw();
+        }
+    }
+
+private:
+    O       m_objects[N];
+    /** Active object ids, followed by free object ids */
+    uint8_t m_order[N];
+    /** Position of object id in m_order for active objects, NONE for free ones */
+    uint8_t m_index[N];
+    uint8_t m_count = 0;
+};
+
+/**
+ * @}
+ */
+
+#endif
@@ -121,6 +121,19 @@ typedef struct _NanoRect
         if (p2.y > rect.p2.y) p2.y = rect.p2.y;
     }
 
+    /**
+     * Extends rectangle to cover specified area
+     *
+     * @param rect rectangle to join with
+     */
+    void join(const _NanoRect& rect)
+    {
+        if (p1.x > rect.p1.x) p1.x = rect.p1.x;
+        if (p1.y > rect.p1.y) p1.y = rect.p1.y;
+        if (p2.x < rect.p2.x) p2.x = rect.p2.x;
+        if (p2.y < rect.p2.y) p2.y = rect.p2.y;
+    }
+
     /**
      * Returns true if specified x position is between left and right borders.
      * @param x - position to check
@@ -143,6 +143,11 @@ public:
         m_bitmap = bitmap;
     }
 
+    /**
+     * Returns area, occupied by the sprite, in global coordinates
+     */
+    const NanoRect & rect() const { return m_rect; }
+
     /**
      * Returns sprite x position
      */
@@ -270,6 +275,11 @@ public:
      */
     const NanoPoint & getPosition() const { return m_pos; }
 
+    /**
+     * Returns area, occupied by the sprite, in global coordinates
+     */
+    const NanoRect rect() const { return { m_pos, m_pos + m_size - (NanoPoint){1, 1} }; }
+
     /**
      * Returns sprite x position
      */
@@ -295,6 +305,390 @@ private:
     const uint8_t *m_bitmap;
 };
 
+/**
+ * This is template class for groups of sprites, drawn by NanoEngine.
+ * Instead of drawing each sprite in each tile, NanoSpriteLayer keeps for every
+ * sprite the mask of 8-pixel rows it covers (32 row buckets, repeating each 256 pixels),
+ * and draw() checks only the sprites, which fall into the rows of the tile being drawn.
+ * It requires NanoEngine type, NanoEngine instance, sprite type (NanoSprite or
+ * NanoFixedSprite) and maximum number of sprites as arguments.
+ */
+template<typename T, T &E, typename S, uint8_t N>
+class NanoSpriteLayer
+{
+public:
+    /**
+     * Adds sprite to the layer and marks its area for refreshing.
+     * @param sprite sprite to add. The object must exist until removed from the layer.
+     * @return false if there is no free slot in the layer
+     */
+    bool add(S &sprite)
+    {
+        if (m_count >= N) return false;
+        m_sprites[m_count] = &sprite;
+        m_rows[m_count] = rowsMask( sprite.rect() );
+        m_count++;
+        sprite.refresh();
+        return true;
+    }
+
+    /**
+     * Removes sprite from the layer and marks its area for refreshing.
+     * @param sprite sprite to remove
+     */
+    void remove(S &sprite)
+    {
+        uint8_t i = find( sprite );
+        if (i >= m_count) return;
+        sprite.refresh();
+        m_count--;
+        m_sprites[i] = m_sprites[m_count];
+        m_rows[i] = m_rows[m_count];
+    }
+
+    /**
+     * Moves sprite to new position, refreshing old and new areas.
+     * @param sprite sprite, added to the layer
+     * @param p new position in global coordinates
+     */
+    void moveTo(S &sprite, const NanoPoint &p)
+    {
+        sprite.moveTo( p );
+        update( sprite );
+    }
+
+    /**
+     * Moves sprite by specified offset, refreshing old and new areas.
+     * @param sprite sprite, added to the layer
+     * @param p offset in pixels
+     */
+    void moveBy(S &sprite, const NanoPoint &p)
+    {
+        sprite.moveBy( p );
+        update( sprite );
+    }
+
+    /**
+     * Updates layer information on sprite position. Call it if sprite
+     * was moved not via layer methods.
+     * @param sprite sprite, added to the layer
+     */
+    void update(S &sprite)
+    {
+        uint8_t i = find( sprite );
+        if (i < m_count) m_rows[i] = rowsMask( sprite.rect() );
+    }
+
+    /**
+     * Draws sprites, intersecting canvas area, being updated. Call it from
+     * the engine draw callback. Sprite coordinates and canvas offset must be in
+     * the same coordinates system (refer to NanoEngine worldCoordinates()).
+     */
+    void draw()
+    {
+        const NanoRect area = E.canvas.rect();
+        const uint32_t rows = rowsMask( area );
+        for (uint8_t i = 0; i < m_count; i++)
+        {
+            if (!(m_rows[i] & rows)) continue;
+            const NanoRect r = m_sprites[i]->rect();
+            if ((r.p2.x < area.p1.x) || (r.p1.x > area.p2.x) ||
+                (r.p2.y < area.p1.y) || (r.p1.y > area.p2.y)) continue;
+            m_sprites[i]->draw();
+        }
+    }
+
+    /**
+     * Returns number of sprites in the layer
+     */
+    uint8_t count() const { return m_count; }
+
+private:
+    S       *m_sprites[N];
+    uint32_t m_rows[N];
+    uint8_t  m_count = 0;
+
+    uint8_t find(const S &sprite) const
+    {
+        uint8_t i = 0;
+        while ((i < m_count) && (m_sprites[i] != &sprite)) i++;
+        return i;
+    }
+
+    /** Returns mask of 8-pixel row buckets, covered by the rect */
+    static uint32_t rowsMask(const NanoRect &rect)
+    {
+        lcdint_t first = rect.p1.y >> 3;
+        lcdint_t rows = (rect.p2.y >> 3) - first + 1;
+        if (rows >= 32) return 0xFFFFFFFF;
+        if (rows <= 0) return 0;
+        uint32_t mask = (((uint32_t)1 << rows) - 1);
+        uint8_t shift = first & 31;
+        return shift ? (mask << shift) | (mask >> (32 - shift)) : mask;
+    }
+};
+
+/**
+ * @brief Animated sprite, drawing frames of packed sprite sheet.
+ *
+ * Sprite sheet is stored in flash memory and has the following format (bytes):
+ * frame count, frame width, frame height, flags (bit 0 - delta rects present),
+ * optional delta rects (x, y, width, height for each frame), then frames in native
+ * ssd1306 format. Delta rect of the frame describes the area, changed since previous
+ * frame (for frame 0 - since the last frame), so switching to the next frame refreshes
+ * only that area. Use tools/spritesheet.py to convert images.
+ * It requires NanoEngine type and NanoEngine instance as arguments.
+ */
+template<typename T, T &E>
+class NanoAnimatedSprite
+{
+public:
+    /** Sprite sheet header size in bytes */
+    static const uint8_t HEADER_SIZE = 4;
+
+    /**
+     * Creates animated sprite.
+     * @param pos position of the sprite in global coordinates
+     * @param sheet sprite sheet (in flash memory)
+     */
+    NanoAnimatedSprite(const NanoPoint &pos, const uint8_t *sheet)
+         : m_pos(pos)
+    {
+        load( sheet );
+    }
+
+    /**
+     * Changes sprite sheet and selects frame 0.
+     * @param sheet sprite sheet (in flash memory)
+     */
+    void setSheet(const uint8_t *sheet)
+    {
+        refresh();
+        load( sheet );
+        refresh();
+    }
+
+    /**
+     * Draws current frame on Engine canvas
+     */
+    void draw()
+    {
+        E.canvas.drawBitmap1(m_pos.x, m_pos.y, m_size.x, m_size.y, frameData( m_frame ));
+    }
+
+    /**
+     * Marks sprite location for refreshing on the new frame
+     */
+    void refresh()
+    {
+        E.refreshWorld( m_pos.x, m_pos.y, m_pos.x + m_size.x - 1, m_pos.y + m_size.y - 1 );
+    }
+
+    /**
+     * Selects frame to display. If the frame follows current one, only the area,
+     * changed between frames, is refreshed.
+     * @param frame frame index
+     */
+    void setFrame(uint8_t frame)
+    {
+        if (frame >= m_frames) frame = 0;
+        if (frame == m_frame) return;
+        uint8_t next = m_frame + 1 >= m_frames ? 0 : m_frame + 1;
+        m_frame = frame;
+        if (!m_deltas || (frame != next))
+        {
+            refresh();
+            return;
+        }
+        const uint8_t *d = &m_deltas[frame << 2];
+        uint8_t w = pgm_read_byte( &d[2] );
+        uint8_t h = pgm_read_byte( &d[3] );
+        if (!w || !h) return;
+        lcdint_t x = m_pos.x + pgm_read_byte( &d[0] );
+        lcdint_t y = m_pos.y + pgm_read_byte( &d[1] );
+        E.refreshWorld( x, y, x + w - 1, y + h - 1 );
+    }
+
+    /**
+     * Switches to the next frame, starting from the first one after the last frame.
+     */
+    void nextFrame()
+    {
+        setFrame( m_frame + 1 >= m_frames ? 0 : m_frame + 1 );
+    }
+
+    /** Returns current frame index */
+    uint8_t frame() const { return m_frame; }
+
+    /** Returns number of frames in the sprite sheet */
+    uint8_t frames() const { return m_frames; }
+
+    /**
+     * Moves sprite to new position
+     */
+    void moveTo(const NanoPoint &p)
+    {
+        refresh();
+        m_pos = p;
+        refresh();
+    }
+
+    /**
+     * Moves sprite to new position by specified offset
+     */
+    void moveBy(const NanoPoint &p)
+    {
+        refresh();
+        m_pos += p;
+        refresh();
+    }
+
+    /**
+     * Returns area, occupied by the sprite, in global coordinates
+     */
+    const NanoRect rect() const { return { m_pos, m_pos + m_size - (NanoPoint){1,1} }; }
+
+    /**
+     * Returns sprite x position
+     */
+    lcdint_t x( ) const { return m_pos.x; }
+
+    /**
+     * Returns sprite y position
+     */
+    lcdint_t y( ) const { return m_pos.y; }
+
+private:
+    NanoPoint      m_pos;
+    NanoPoint      m_size;
+    const uint8_t *m_sheet;
+    const uint8_t *m_deltas;
+    uint16_t       m_frameSize;
+    uint8_t        m_frames;
+    uint8_t        m_frame;
+
+    void load(const uint8_t *sheet)
+    {
+        m_sheet = sheet;
+        m_frames = pgm_read_byte( &sheet[0] );
+        m_size.x = pgm_read_byte( &sheet[1] );
+        m_size.y = pgm_read_byte( &sheet[2] );
+        m_deltas = (pgm_read_byte( &sheet[3] ) & 0x01) ? &sheet[HEADER_SIZE] : nullptr;
+        m_frameSize = m_size.x * ((m_size.y + 7) >> 3);
+        m_frame = 0;
+    }
+
+    const uint8_t *frameData(uint8_t frame) const
+    {
+        return &m_sheet[HEADER_SIZE + (m_deltas ? (m_frames << 2) : 0) + frame * m_frameSize];
+    }
+};
+
+/**
+ * @brief Cache of vertically shifted variants of 1-bit sprite bitmap.
+ *
+ * Drawing 1-bit bitmap at y, not aligned to 8 pixels, shifts every byte and
+ * splits it between two canvas pages. NanoSpriteCache1 shifts bitmap once for
+ * each vertical offset (y & 7) and keeps SLOTS latest variants in RAM (least recently
+ * used slot is replaced), so draw() only copies masked bytes. With SLOTS equal to
+ * 8 all variants are kept. Each slot takes W * ((H + 7) / 8 + 1) bytes.
+ *
+ * @tparam W width of the bitmap in pixels
+ * @tparam H height of the bitmap in pixels
+ * @tparam SLOTS number of cached variants
+ */
+template<lcduint_t W, lcduint_t H, uint8_t SLOTS = 2>
+class NanoSpriteCache1
+{
+public:
+    /**
+     * Creates cache for bitmap in native ssd1306 format.
+     * @param bitmap sprite content (in flash memory)
+     */
+    explicit NanoSpriteCache1(const uint8_t *bitmap)
+    {
+        setBitmap( bitmap );
+    }
+
+    /**
+     * Changes bitmap and drops all cached variants.
+     * @param bitmap sprite content (in flash memory)
+     */
+    void setBitmap(const uint8_t *bitmap)
+    {
+        m_bitmap = bitmap;
+        for (uint8_t i = 0; i < SLOTS; i++)
+        {
+            m_offs[i] = 0xFF;
+        }
+    }
+
+    /**
+     * Returns bitmap, shifted down by offs pixels (0-7), in RAM.
+     * The data has PAGES pages of W bytes.
+     */
+    const uint8_t *get(uint8_t offs)
+    {
+        uint8_t slot = 0;
+        for (uint8_t i = 0; i < SLOTS; i++)
+        {
+            if (m_offs[i] == offs)
+            {
+                slot = i;
+                break;
+            }
+            if (m_age[i] > m_age[slot]) slot = i;
+        }
+        for (uint8_t i = 0; i < SLOTS; i++)
+        {
+            if (m_age[i] < 0xFF) m_age[i]++;
+        }
+        m_age[slot] = 0;
+        if (m_offs[slot] != offs)
+        {
+            shift( m_data[slot], offs );
+            m_offs[slot] = offs;
+        }
+        return m_data[slot];
+    }
+
+    /**
+     * Draws bitmap on 1-bit canvas.
+     * @param canvas canvas to draw on (NanoCanvasOps<1> or derived)
+     * @param x position X in pixels
+     * @param y position Y in pixels
+     */
+    template<typename C>
+    void draw(C &canvas, lcdint_t x, lcdint_t y)
+    {
+        canvas.drawShiftedBitmap1( x, y, W, H, get( (y - canvas.offset.y) & 0x07 ) );
+    }
+
+    /** Number of pages in shifted bitmap */
+    static const lcduint_t PAGES = ((H + 7) >> 3) + 1;
+
+private:
+    const uint8_t *m_bitmap;
+    uint8_t m_data[SLOTS][PAGES * W];
+    uint8_t m_offs[SLOTS];
+    uint8_t m_age[SLOTS] = {};
+
+    void shift(uint8_t *dst, uint8_t offs)
+    {
+        for (lcduint_t i = 0; i < W; i++)
+        {
+            uint8_t carry = 0;
+            for (lcduint_t p = 0; p < PAGES - 1; p++)
+            {
+                uint8_t data = pgm_read_byte( &m_bitmap[p * W + i] );
+                dst[p * W + i] = (data << offs) | carry;
+                carry = offs ? (data >> (8 - offs)) : 0;
+            }
+            dst[(PAGES - 1) * W + i] = carry;
+        }
+    }
+};
+
 /**
  * @}
  */
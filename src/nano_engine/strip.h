@@ -0,0 +1,196 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file strip.h Scanline strip renderer for large displays with little RAM
+ */
+
+#ifndef _NANO_ENGINE_STRIP_H_
+#define _NANO_ENGINE_STRIP_H_
+
+#include "core.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+/**
+ * NanoEngineStrip is alternative to NanoEngine for large color displays and
+ * controllers with little RAM (ILI9341 and ATmega328p for example). Its canvas
+ * covers full display width and H rows only. On each display() call the whole
+ * screen is drawn strip by strip from top to bottom, and all strips are sent
+ * to the display as single set_block() transaction, so full-screen update
+ * is one continuous stream of pixels without window setup overhead.
+ * Template arguments are canvas class (NanoCanvas16, NanoCanvas8, NanoCanvas4,
+ * NanoCanvas1), max display width W and strip height H in pixels. Strip buffer
+ * takes W * H * bits per pixel / 8 bytes, NanoEngineStrip<NanoCanvas16,240,2>
+ * takes 960 bytes for example.
+ * @warning Draw callback is called while display transaction is open, so it must
+ *          not use direct draw functions or other devices on the same bus.
+ *          Height of 1-bit strip must be multiple of 8.
+ */
+template<class C, lcduint_t W, lcduint_t H>
+class NanoEngineStrip: public NanoEngineCore
+{
+public:
+    /** Width of strip in pixels */
+    static const lcduint_t NE_STRIP_WIDTH = W;
+    /** Height of strip in pixels */
+    static const lcduint_t NE_STRIP_HEIGHT = H;
+
+    /**
+     * object, representing canvas. Use it in your draw handler. Canvas covers
+     * single strip at a time, and canvas offset is set to the strip position.
+     */
+    static C canvas;
+
+    /** Initializes the engine */
+    NanoEngineStrip(): NanoEngineCore() {}
+
+    /**
+     * Initializes internal timestamps, engine state, and
+     * switches display to required mode (see ssd1306_setMode()).
+     */
+    static void begin()
+    {
+        NanoEngineCore::begin();
+        if (C::BITS_PER_PIXEL > 1)
+        {
+            ssd1306_setMode(LCD_MODE_NORMAL);
+        }
+        refresh();
+    }
+
+    /**
+     * Sets user-defined draw callback. The callback is called for every strip
+     * of the screen, return value is ignored.
+     */
+    static void drawCallback(TNanoEngineOnDraw callback)
+    {
+        m_onDraw = callback;
+    }
+
+    /** Marks the screen for update. Actual update will take place in display() method. */
+    static void refresh()
+    {
+        m_refresh = true;
+    }
+
+    /**
+     * Draws the whole screen strip by strip and sends it to the display,
+     * if the screen is marked by refresh().
+     */
+    static void display();
+
+private:
+    static uint8_t m_buffer[W * H * C::BITS_PER_PIXEL / 8];
+    static TNanoEngineOnDraw m_onDraw;
+    static bool m_refresh;
+
+    /** Sends rows of canvas buffer, continuing the block, set by display() */
+    static void sendStrip(lcduint_t rows);
+};
+
+template<class C, lcduint_t W, lcduint_t H>
+uint8_t NanoEngineStrip<C,W,H>::m_buffer[W * H * C::BITS_PER_PIXEL / 8];
+
+template<class C, lcduint_t W, lcduint_t H>
+C NanoEngineStrip<C,W,H>::canvas(W, H, m_buffer);
+
+template<class C, lcduint_t W, lcduint_t H>
+TNanoEngineOnDraw NanoEngineStrip<C,W,H>::m_onDraw = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H>
+bool NanoEngineStrip<C,W,H>::m_refresh = true;
+
+template<class C, lcduint_t W, lcduint_t H>
+void NanoEngineStrip<C,W,H>::sendStrip(lcduint_t rows)
+{
+    const lcduint_t width = ssd1306_lcd.width;
+    const uint8_t *buf = m_buffer;
+    if (C::BITS_PER_PIXEL == 1)
+    {
+        for (lcduint_t page = 0; page < (rows >> 3); page++)
+        {
+            ssd1306_lcd.send_pixels_buffer1(buf, width);
+            ssd1306_lcd.next_page();
+            buf += width;
+        }
+        return;
+    }
+    const uint16_t count = (uint16_t)width * rows;
+    if ((C::BITS_PER_PIXEL == 16) && ssd1306_lcd.send_pixels_buffer16)
+    {
+        ssd1306_lcd.send_pixels_buffer16(buf, count);
+    }
+    else if (C::BITS_PER_PIXEL == 16)
+    {
+        for (uint16_t i = 0; i < count; i++, buf += 2)
+        {
+            ssd1306_lcd.send_pixels16((buf[0] << 8) | buf[1]);
+        }
+    }
+    else if ((C::BITS_PER_PIXEL == 8) && ssd1306_lcd.send_pixels_buffer8)
+    {
+        ssd1306_lcd.send_pixels_buffer8(buf, count);
+    }
+    else if (C::BITS_PER_PIXEL == 8)
+    {
+        for (uint16_t i = 0; i < count; i++)
+        {
+            ssd1306_lcd.send_pixels8(buf[i]);
+        }
+    }
+    else if (ssd1306_lcd.send_pixels_buffer4)
+    {
+        ssd1306_lcd.send_pixels_buffer4(buf, count >> 1);
+    }
+}
+
+template<class C, lcduint_t W, lcduint_t H>
+void NanoEngineStrip<C,W,H>::display()
+{
+    m_lastFrameTs = millis();
+    if (!m_refresh || !m_onDraw) return;
+    m_refresh = false;
+    const lcduint_t width = min(ssd1306_lcd.width, W);
+    /* Block covers the whole screen, strips are sent one by one in the same transaction */
+    ssd1306_lcd.set_block(0, 0, 0);
+    for (lcduint_t y = 0; y < ssd1306_lcd.height; y = y + H)
+    {
+        const lcduint_t rows = min((lcduint_t)(ssd1306_lcd.height - y), H);
+        canvas.setSize(width, rows);
+        canvas.setOffset(0, y);
+        m_onDraw();
+        sendStrip(rows);
+    }
+    ssd1306_intf.stop();
+    m_cpuLoad = ((millis() - m_lastFrameTs)*100)/m_frameDurationMs;
+}
+
+/**
+ * @}
+ */
+
+#endif
@@ -0,0 +1,221 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file tile_tuner.h Benchmark of NanoEngine tile sizes
+ */
+
+#ifndef _NANO_TILE_TUNER_H_
+#define _NANO_TILE_TUNER_H_
+
+#include "core.h"
+#include "rect.h"
+#include "intf/ssd1306_interface.h"
+#include "ssd1306_hal/io.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+/** Result of benchmark for single tile size */
+typedef struct
+{
+    /** Tile width in pixels */
+    uint8_t  tileWidth;
+    /** Tile height in pixels */
+    uint8_t  tileHeight;
+    /** Size of tile buffer in bytes */
+    uint32_t bufferBytes;
+    /** Average frame time in microseconds */
+    uint32_t frameUs;
+    /** Average number of bytes, sent to display per frame. 0 if interface statistics are disabled */
+    uint32_t busBytes;
+} NanoTileBenchResult;
+
+/**
+ * @brief Runs draw callback against several tile sizes and recommends the best one.
+ *
+ * Tile size is a template argument of NanoEngine, so each tested size is separate
+ * engine instantiation. The tuner calls the same draw function for every size,
+ * replays recorded pattern of refreshed areas, and measures average frame time and
+ * bytes, sent to the display (if CONFIG_SSD1306_INTF_STATS_ENABLE is defined).
+ * Run it on the target or in the emulator with bus throttling enabled, then hardcode
+ * the recommended tile in the application.
+ * @code
+ * bool drawScene(NanoCanvas16 &canvas) { canvas.clear(); ...; return true; }
+ * NanoTileTuner<NanoCanvas16> tuner(drawScene, pattern, 32, 2);
+ * NanoTileBenchResult results[3];
+ * tuner.run<8,8,3>(results[0]);
+ * tuner.run<16,16,4>(results[1]);
+ * tuner.run<32,32,5>(results[2]);
+ * const NanoTileBenchResult *best = NanoTileTuner<NanoCanvas16>::recommend(results, 3, 1024);
+ * @endcode
+ * @note Each tested size reserves its own tile buffer, unless NE_EXTERNAL_TILE_BUFFER
+ *       is set to 1. In that case single buffer, passed to useBuffer(), is used for all
+ *       sizes, and sizes, not fitting the buffer, are skipped.
+ */
+template<class C>
+class NanoTileTuner
+{
+public:
+    /** Draw function, accepting canvas of the tile being drawn */
+    typedef bool (*TDraw)(C &canvas);
+
+    /**
+     * Creates tuner object.
+     * @param draw - function, drawing the scene on the canvas
+     * @param pattern - areas in screen coordinates, refreshed on each frame
+     * @param count - number of areas in the pattern
+     * @param rectsPerFrame - number of areas, refreshed per single frame
+     */
+    NanoTileTuner(TDraw draw, const NanoRect *pattern, uint16_t count, uint8_t rectsPerFrame = 1)
+        : m_draw(draw)
+        , m_pattern(pattern)
+        , m_count(count)
+        , m_rectsPerFrame(rectsPerFrame ? rectsPerFrame : 1)
+    {
+    }
+
+#if NE_EXTERNAL_TILE_BUFFER
+    /**
+     * Sets buffer, shared by all tested tile sizes.
+     * @param buffer - tile buffer
+     * @param size - size of the buffer in bytes
+     */
+    void useBuffer(uint8_t *buffer, uint32_t size)
+    {
+        m_buffer = buffer;
+        m_size = size;
+    }
+#endif
+
+    /**
+     * Runs benchmark for tile of W x H pixels. Whole screen is drawn once before
+     * measurement, and then the pattern is replayed.
+     * @param result - structure to fill
+     * @return false if tile size is skipped (doesn't fit external buffer)
+     */
+    template<uint8_t W, uint8_t H, uint8_t B>
+    bool run(NanoTileBenchResult &result)
+    {
+        typedef NanoEngine<C,W,H,B> E;
+        result.tileWidth = W;
+        result.tileHeight = H;
+        result.bufferBytes = E::NE_TILE_BUFFER_SIZE;
+        result.frameUs = 0;
+        result.busBytes = 0;
+#if NE_EXTERNAL_TILE_BUFFER
+        if (!m_buffer || (m_size < E::NE_TILE_BUFFER_SIZE))
+        {
+            return false;
+        }
+        E::useBuffer(m_buffer);
+#endif
+        s_draw = m_draw;
+        E::begin();
+        E::drawCallback(drawTile<E>);
+        E::refresh();
+        E::display();
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+        ssd1306_intfStatsReset();
+#endif
+        uint16_t frames = 0;
+        uint32_t ts = micros();
+        for (uint16_t i = 0; i < m_count; frames++)
+        {
+            for (uint8_t n = 0; (n < m_rectsPerFrame) && (i < m_count); n++, i++)
+            {
+                E::refresh(m_pattern[i]);
+            }
+            E::display();
+        }
+        if (frames)
+        {
+            result.frameUs = (uint32_t)(micros() - ts) / frames;
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+            ssd1306_intf_stats_t stats;
+            ssd1306_intfStatsGet(&stats);
+            result.busBytes = (stats.send_bytes + stats.buffer_bytes) / frames;
+#endif
+        }
+        E::drawCallback(nullptr);
+        return true;
+    }
+
+    /**
+     * Returns result with the lowest frame time among tile sizes, fitting RAM budget.
+     * @param results - benchmark results
+     * @param count - number of results
+     * @param ramBudget - max size of tile buffer in bytes
+     * @return best result or nullptr if no tile size fits the budget
+     */
+    static const NanoTileBenchResult *recommend(const NanoTileBenchResult *results, uint8_t count,
+                                                uint32_t ramBudget)
+    {
+        const NanoTileBenchResult *best = nullptr;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            const NanoTileBenchResult &r = results[i];
+            if ( !r.frameUs || (r.bufferBytes > ramBudget) )
+            {
+                continue;
+            }
+            if ( !best || (r.frameUs < best->frameUs) ||
+                 ((r.frameUs == best->frameUs) && (r.bufferBytes < best->bufferBytes)) )
+            {
+                best = &r;
+            }
+        }
+        return best;
+    }
+
+private:
+    TDraw            m_draw;
+    const NanoRect  *m_pattern;
+    uint16_t         m_count;
+    uint8_t          m_rectsPerFrame;
+#if NE_EXTERNAL_TILE_BUFFER
+    uint8_t         *m_buffer = nullptr;
+    uint32_t         m_size = 0;
+#endif
+
+    /** Draw function of the engine being tested */
+    static TDraw     s_draw;
+
+    /** Passes canvas of the engine being tested to the draw function */
+    template<class E>
+    static bool drawTile()
+    {
+        return s_draw(E::canvas);
+    }
+};
+
+template<class C>
+typename NanoTileTuner<C>::TDraw NanoTileTuner<C>::s_draw = nullptr;
+
+/**
+ * @}
+ */
+
+#endif
@@ -0,0 +1,217 @@
+/*
+    MIT License
+
+    Copyright (c) 2018, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file tilemap.h Tile map class
+ */
+
+#ifndef _NANO_TILEMAP_H_
+#define _NANO_TILEMAP_H_
+
+#include "point.h"
+#include "rect.h"
+#include "ssd1306_hal/io.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+/** Tile index, which is not drawn by NanoTileMap */
+#define NE_TILEMAP_EMPTY   0xFF
+
+/**
+ * This is template class for tile maps (game levels, backgrounds).
+ * NanoTileMap binds map of tile indices to monochrome tileset and draws
+ * only map cells, intersecting engine canvas area. NanoTileMap can work only
+ * as part of NanoEngine, it requires NanoEngine type and NanoEngine instance as
+ * arguments. If map cell size is equal to engine tile size, and map position is
+ * aligned to the tile size, every engine tile is drawn with single aligned
+ * bitmap copy.
+ */
+template<typename T, T &E>
+class NanoTileMap
+{
+public:
+    /**
+     * Creates tile map object.
+     * @param pos position of the map top-left corner in global coordinates
+     * @param cellSize size of single map cell (tile) in pixels
+     * @param columns number of map columns
+     * @param rows number of map rows
+     * @param map array of columns x rows tile indices, row by row.
+     *        Tile with index NE_TILEMAP_EMPTY is not drawn.
+     * @param tileset tiles bitmaps in drawBitmap1() format (in flash memory),
+     *        following one by one
+     * @param progmem true if map is located in flash memory, false if in RAM
+     */
+    NanoTileMap(const NanoPoint &pos, const NanoPoint &cellSize, uint8_t columns, uint8_t rows,
+                const uint8_t *map, const uint8_t *tileset, bool progmem = true)
+         : m_pos( pos )
+         , m_cellSize( cellSize )
+         , m_columns( columns )
+         , m_rows( rows )
+         , m_map( map )
+         , m_tileset( tileset )
+         , m_progmem( progmem )
+         , m_tileBytes( cellSize.x * ((cellSize.y + 7) >> 3) )
+    {
+    }
+
+    /**
+     * Draws map cells, intersecting canvas area, being updated. Call it from
+     * the engine draw callback. Map coordinates and canvas offset must be in
+     * the same coordinates system (refer to NanoEngine worldCoordinates()).
+     */
+    void draw()
+    {
+        const NanoRect area = E.canvas.rect();
+        lcdint_t c1 = cellColumn( area.p1.x );
+        lcdint_t c2 = cellColumn( area.p2.x );
+        lcdint_t r1 = cellRow( area.p1.y );
+        lcdint_t r2 = cellRow( area.p2.y );
+        if ((c2 < 0) || (r2 < 0) || (c1 >= m_columns) || (r1 >= m_rows)) return;
+        if (c1 < 0) c1 = 0;
+        if (r1 < 0) r1 = 0;
+        if (c2 >= m_columns) c2 = m_columns - 1;
+        if (r2 >= m_rows) r2 = m_rows - 1;
+        for (lcdint_t r = r1; r <= r2; r++)
+        {
+            lcdint_t y = m_pos.y + r * m_cellSize.y;
+            for (lcdint_t c = c1; c <= c2; c++)
+            {
+                uint8_t index = tile( c, r );
+                if (index == NE_TILEMAP_EMPTY) continue;
+                E.canvas.drawBitmap1( m_pos.x + c * m_cellSize.x, y, m_cellSize.x, m_cellSize.y,
+                                      m_tileset + index * m_tileBytes );
+            }
+        }
+    }
+
+    /**
+     * Returns tile index of the map cell.
+     * @param column map column
+     * @param row map row
+     */
+    uint8_t tile(uint8_t column, uint8_t row) const
+    {
+        uint16_t cell = row * m_columns + column;
+        return m_progmem ? pgm_read_byte( &m_map[cell] ) : m_map[cell];
+    }
+
+    /**
+     * Changes tile index of the map cell, and marks only this cell for
+     * refreshing. The map must be located in RAM.
+     * @param column map column
+     * @param row map row
+     * @param index new tile index
+     */
+    void setTile(uint8_t column, uint8_t row, uint8_t index)
+    {
+        uint8_t *cell = const_cast<uint8_t *>( &m_map[row * m_columns + column] );
+        if (*cell == index) return;
+        *cell = index;
+        refresh( column, row );
+    }
+
+    /**
+     * Marks single map cell for refreshing on the new frame
+     * @param column map column
+     * @param row map row
+     */
+    void refresh(uint8_t column, uint8_t row)
+    {
+        lcdint_t x = m_pos.x + column * m_cellSize.x;
+        lcdint_t y = m_pos.y + row * m_cellSize.y;
+        E.refreshWorld( x, y, x + m_cellSize.x - 1, y + m_cellSize.y - 1 );
+    }
+
+    /**
+     * Marks whole map area for refreshing on the new frame
+     */
+    void refresh()
+    {
+        E.refreshWorld( rect() );
+    }
+
+    /**
+     * Moves map to new position, and refreshes old and new areas.
+     * @param p new position in global coordinates
+     */
+    void moveTo(const NanoPoint &p)
+    {
+        refresh();
+        m_pos = p;
+        refresh();
+    }
+
+    /**
+     * Returns area, occupied by the map, in global coordinates
+     */
+    const NanoRect rect() const
+    {
+        return { m_pos, { (lcdint_t)(m_pos.x + m_columns * m_cellSize.x - 1),
+                          (lcdint_t)(m_pos.y + m_rows * m_cellSize.y - 1) } };
+    }
+
+    /**
+     * Returns map cell, containing specified point in global coordinates.
+     * The result can be outside of the map.
+     * @param p point in global coordinates
+     */
+    const NanoPoint cellAt(const NanoPoint &p) const
+    {
+        return { cellColumn( p.x ), cellRow( p.y ) };
+    }
+
+private:
+    NanoPoint         m_pos;
+    const NanoPoint   m_cellSize;
+    const uint8_t     m_columns;
+    const uint8_t     m_rows;
+    const uint8_t    *m_map;
+    const uint8_t    *m_tileset;
+    const bool        m_progmem;
+    const uint16_t    m_tileBytes;
+
+    /** Returns map column for x position, rounding to the floor */
+    lcdint_t cellColumn(lcdint_t x) const
+    {
+        x -= m_pos.x;
+        return x >= 0 ? x / m_cellSize.x : -(((lcdint_t)m_cellSize.x - 1 - x) / m_cellSize.x);
+    }
+
+    /** Returns map row for y position, rounding to the floor */
+    lcdint_t cellRow(lcdint_t y) const
+    {
+        y -= m_pos.y;
+        return y >= 0 ? y / m_cellSize.y : -(((lcdint_t)m_cellSize.y - 1 - y) / m_cellSize.y);
+    }
+};
+
+/**
+ * @}
+ */
+
+#endif
+
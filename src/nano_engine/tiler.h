@@ -30,7 +30,14 @@
 #define _NANO_ENGINE_TILER_H_
 
 #include "canvas.h"
+#include "display_list.h"
 #include "lcd/lcd_common.h"
+#include "ssd1306_context.h"
+#include "ssd1306_trace.h"
+
+#if defined(CONFIG_LARGE_RAM_AVAILABLE)
+#include <stdlib.h>
+#endif
 
 /**
  * @ingroup NANO_ENGINE_API
@@ -43,6 +50,9 @@
  */
 extern "C" SFixedFontInfo s_fixedFont;
 
+/** Current color of direct draw functions, used by 1-bit canvases for RGB displays */
+extern "C" uint16_t ssd1306_color;
+
 /* The table below defines arguments for NanoEngineTiler.          *
  *                            canvas        width   height  bits   */
 // Tiles for monochrome displays
@@ -55,6 +65,15 @@ extern "C" SFixedFontInfo s_fixedFont;
 #define TILE_16x16_RGB8       NanoCanvas8,  16,     16,     4    ///< Standard 8-bit RGB tile 16x16
 #define TILE_32x32_RGB8       NanoCanvas8,  32,     32,     5    ///< Standard 8-bit RGB tile 32x32
 #define TILE_8x8_MONO_8       NanoCanvas1_8,8,      8,      3    ///< Standard 1-bit tile 8x8 for RGB mode
+// Tiles for 4-bit grayscale composite video, pixels are converted from RGB8
+#define TILE_8x8_GRAY4        NanoCanvas8,  8,      8,      3    ///< 8-bit RGB tile 8x8 for 4-bit grayscale displays
+#define TILE_16x16_GRAY4      NanoCanvas8,  16,     16,     4    ///< 8-bit RGB tile 16x16 for 4-bit grayscale displays
+#define TILE_32x32_GRAY4      NanoCanvas8,  32,     32,     5    ///< 8-bit RGB tile 32x32 for 4-bit grayscale displays
+// Tiles for 4-bit grayscale displays (SSD1325), pixels are packed in native format
+#define TILE_128x64_GRAY4_PACKED NanoCanvas4, 128,  64,     7    ///< Full-screen packed 4-bit tile for SSD1325
+#define TILE_8x8_GRAY4_PACKED   NanoCanvas4, 8,     8,      3    ///< Packed 4-bit grayscale tile 8x8
+#define TILE_16x16_GRAY4_PACKED NanoCanvas4, 16,    16,     4    ///< Packed 4-bit grayscale tile 16x16
+#define TILE_32x32_GRAY4_PACKED NanoCanvas4, 32,    32,     5    ///< Packed 4-bit grayscale tile 32x32
 // Tiles for 16-bit displays
 #define TILE_8x8_RGB16        NanoCanvas16, 8,      8,      3    ///< Standard 16-bit RGB tile 8x8
 // Adafruit tiles
@@ -62,11 +81,107 @@ extern "C" SFixedFontInfo s_fixedFont;
 #define ADATILE_8x8_RGB8      AdafruitCanvas8,  8,  8,      3    ///< Use Adafruit GFX implementation as NanoEngine canvas
 #define ADATILE_8x8_RGB16     AdafruitCanvas16, 8,  8,      3    ///< Use Adafruit GFX implementation as NanoEngine canvas
 
+/*
+ * Max display size, supported by NanoEngine, can be set in pixels via compiler options
+ * NE_MAX_SCREEN_WIDTH and NE_MAX_SCREEN_HEIGHT. Refresh flags (and NanoCollisionGrid)
+ * take RAM in proportion to the number of tiles, so smaller values save RAM. If they
+ * are not defined, engine supports 16 tiles per row and 512 pixels in height, as
+ * older versions did, but not less than NE_DEFAULT_SCREEN_WIDTH pixels in width.
+ */
+#ifndef NE_DEFAULT_SCREEN_WIDTH
+#if defined(__AVR__)
+/** Min display width in pixels, supported if NE_MAX_SCREEN_WIDTH is not defined */
+#define NE_DEFAULT_SCREEN_WIDTH     0
+#else
+/** Min display width in pixels, supported if NE_MAX_SCREEN_WIDTH is not defined */
+#define NE_DEFAULT_SCREEN_WIDTH     320
+#endif
+#endif
+
+#ifndef NE_DEFAULT_SCREEN_HEIGHT
+/** Display height in pixels, supported if NE_MAX_SCREEN_HEIGHT is not defined */
+#define NE_DEFAULT_SCREEN_HEIGHT    512
+#endif
+
+#ifndef NE_FRAME_DIFF_GAP
+/** Number of unchanged columns, which are sent to join two changed runs in frame diff mode */
+#define NE_FRAME_DIFF_GAP       4
+#endif
+
+#ifndef NE_MAX_DIRTY_RECTS
+#if defined(__AVR__)
+/** Max number of areas, tracked in dirty rectangles mode. Can be redefined via compiler options */
+#define NE_MAX_DIRTY_RECTS      4
+#else
+/** Max number of areas, tracked in dirty rectangles mode. Can be redefined via compiler options */
+#define NE_MAX_DIRTY_RECTS      8
+#endif
+#endif
+
+#ifndef NE_RENDER_THREADS
+/**
+ * Number of threads, drawing tiles in parallel on multi-core hosts. Values below 2 disable
+ * threaded rendering. Can be redefined via compiler options, requires linking with -pthread.
+ */
+#define NE_RENDER_THREADS       0
+#endif
+
+#ifndef NE_EXTERNAL_TILE_BUFFER
+/**
+ * Set to 1 to not reserve tile buffer inside the engine. Application passes the buffer
+ * via useBuffer() then, and can share it with other code (image streams, menus, temporary
+ * calculations) between frames. Can be redefined via compiler options.
+ */
+#define NE_EXTERNAL_TILE_BUFFER 0
+#endif
+
+#if NE_RENDER_THREADS > 1
+#if NE_EXTERNAL_TILE_BUFFER
+#error "External tile buffer is not supported with threaded tile rendering"
+#endif
+#if !defined(CONFIG_PLATFORM_THREADS_AVAILABLE)
+#error "Threaded tile rendering is not supported on this platform"
+#endif
+/* Library min/max macros conflict with standard C++ headers */
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#pragma pop_macro("max")
+#pragma pop_macro("min")
+/* Each render thread has its own canvas and tile buffer */
+#define NE_TILE_STORAGE         thread_local
+#else
+#define NE_TILE_STORAGE
+#endif
+
 /**
  * Type of user-specified draw callback.
  */
 typedef bool (*TNanoEngineOnDraw)(void);
 
+/** Timings of single frame, collected by the engine profiler */
+typedef struct
+{
+    uint32_t loopUs;   ///< time, spent in loop callback, in microseconds
+    uint32_t drawUs;   ///< time, spent in draw callbacks (summed over tiles), in microseconds
+    uint32_t bltUs;    ///< time, spent sending tiles to the display, in microseconds
+    uint16_t tiles;    ///< number of tiles (areas), refreshed during the frame
+    uint16_t skipped;  ///< number of tiles, not sent because their content is unchanged
+} NanoEngineFrameStats;
+
+/** Single panel of video wall, see NanoEngineTiler::useVideoWall() */
+typedef struct
+{
+    SSD1306Context *ctx;  ///< display context of the panel, initialized by ssd1306_contextInit()
+    lcdint_t x;           ///< left position of the panel on the wall in pixels
+    lcdint_t y;           ///< top position of the panel on the wall in pixels
+} NanoWallPanel;
+
 /**
  * This class template is responsible for holding and updating data about areas to be refreshed
  * on LCD display. It accepts canvas class, tile width in pixels, tile height in pixels and
@@ -93,18 +208,53 @@ public:
     static const lcduint_t NE_TILE_WIDTH = W;
     /** Height of tile in pixels */
     static const lcduint_t NE_TILE_HEIGHT = H;
+#ifdef NE_MAX_SCREEN_WIDTH
+    /** Max display width in pixels, supported by the engine */
+    static const uint32_t NE_MAX_WIDTH = NE_MAX_SCREEN_WIDTH;
+#else
+    /** Max display width in pixels, supported by the engine */
+    static const uint32_t NE_MAX_WIDTH = (16UL << B) > NE_DEFAULT_SCREEN_WIDTH ? (16UL << B) : NE_DEFAULT_SCREEN_WIDTH;
+#endif
+#ifdef NE_MAX_SCREEN_HEIGHT
+    /** Max display height in pixels, supported by the engine */
+    static const uint32_t NE_MAX_HEIGHT = NE_MAX_SCREEN_HEIGHT;
+#else
+    /** Max display height in pixels, supported by the engine */
+    static const uint32_t NE_MAX_HEIGHT = NE_DEFAULT_SCREEN_HEIGHT;
+#endif
+    static_assert(((NE_MAX_WIDTH - 1) >> B) < 255, "NE_MAX_SCREEN_WIDTH is too large for this tile size");
+    static_assert(((NE_MAX_HEIGHT - 1) >> B) < 255, "NE_MAX_SCREEN_HEIGHT is too large for this tile size");
     /** Max tiles supported in X */
-    static const uint8_t NE_MAX_TILES_NUM = 64 >> (B - 3);
+    static const uint8_t NE_MAX_TILES_X = ((NE_MAX_WIDTH - 1) >> B) + 1;
+    /** Max tiles supported in Y */
+    static const uint8_t NE_MAX_TILES_Y = ((NE_MAX_HEIGHT - 1) >> B) + 1;
+    /** Max tile rows supported. Kept for compatibility, use NE_MAX_TILES_Y instead */
+    static const uint8_t NE_MAX_TILES_NUM = NE_MAX_TILES_Y;
+    /** Number of bytes, holding refresh flags for single row of tiles */
+    static const uint8_t NE_TILES_ROW_BYTES = (NE_MAX_TILES_X + 7) >> 3;
+    /** Number of bytes, holding summary flags of tile rows */
+    static const uint8_t NE_TILE_ROWS_BYTES = (NE_MAX_TILES_Y + 7) >> 3;
+    /** Size of tile buffer in bytes */
+    static const uint32_t NE_TILE_BUFFER_SIZE = (uint32_t)W * H * C::BITS_PER_PIXEL / 8;
+    /** Number of entries in the buffer, passed to useTileHashes() and useHeatmap() */
+    static const uint16_t NE_TILE_HASHES = (uint16_t)NE_MAX_TILES_X * NE_MAX_TILES_Y;
 
-    /** object, representing canvas. Use it in your draw handler */
-    static C canvas;
+    /**
+     * object, representing canvas. Use it in your draw handler.
+     * @note If NE_RENDER_THREADS is greater than 1, each render thread has its own canvas,
+     *       so the draw handler must set canvas color and mode itself.
+     */
+    static NE_TILE_STORAGE C canvas;
 
     /**
      * Marks all tiles for update. Actual update will take place in display() method.
      */
     static void refresh()
     {
-        memset(m_refreshFlags,0xFF,sizeof(uint16_t) * NanoEngineTiler<C,W,H,B>::NE_MAX_TILES_NUM);
+        memset(m_refreshFlags,0xFF,sizeof(m_refreshFlags));
+        memset(m_refreshRows,0xFF,sizeof(m_refreshRows));
+        m_rects[0].setRect(0, 0, NE_MAX_WIDTH - 1, NE_MAX_HEIGHT - 1);
+        m_rectsCount = 1;
     }
 
     /**
@@ -123,8 +273,12 @@ public:
      */
     static void refresh(const NanoPoint &point)
     {
-        if ((point.y<0) || ((point.y>>B)>=NE_MAX_TILES_NUM)) return;
-        m_refreshFlags[(point.y>>B)] |= (1<<(point.x>>B));
+        if ((point.y<0) || ((point.y>>B)>=NE_MAX_TILES_Y)) return;
+        if ((point.x<0) || ((point.x>>B)>=NE_MAX_TILES_X)) return;
+        m_refreshFlags[(point.y>>B)][(point.x>>(B+3))] |= (1<<((point.x>>B) & 0x07));
+        m_refreshRows[(point.y>>(B+3))] |= (1<<((point.y>>B) & 0x07));
+        if (m_displayRects) addDirtyRect( { point, point } );
+        if (m_frameBudgetMs) addPriority( { point, point } );
     }
 
     /**
@@ -133,18 +287,58 @@ public:
      */
     static void refresh(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
     {
-        if (y2 < 0) return;
+        if ((y2 < 0) || (x2 < 0)) return;
         if (y1 < 0) y1 = 0;
         if (x1 < 0) x1 = 0;
+        if (m_displayRects) addDirtyRect( { {x1, y1}, {x2, y2} } );
+        if (m_frameBudgetMs) addPriority( { {x1, y1}, {x2, y2} } );
         y1 = y1>>B;
-        y2 = min((y2>>B), NE_MAX_TILES_NUM - 1);
+        y2 = min((y2>>B), NE_MAX_TILES_Y - 1);
+        x1 = x1>>B;
+        x2 = min((x2>>B), NE_MAX_TILES_X - 1);
         for (uint8_t y=y1; y<=y2; y++)
         {
-            for(uint8_t x=x1>>B; x<=(x2>>B); x++)
+            m_refreshRows[y >> 3] |= (1<<(y & 0x07));
+            for(uint8_t x=x1; x<=x2; x++)
+            {
+                m_refreshFlags[y][x >> 3] |= (1<<(x & 0x07));
+            }
+        }
+    }
+
+    /**
+     * Marks for refresh tiles, which bits are set in flags (row per tile row,
+     * bit per tile, the same layout as engine uses). This allows to mark
+     * tiles, touched by many small objects, in one call.
+     * @param flags tile flags to merge with refresh flags of the engine
+     */
+    static void refreshTiles(const uint8_t flags[NE_MAX_TILES_Y][NE_TILES_ROW_BYTES])
+    {
+        lcdint_t x1 = NE_MAX_TILES_X, y1 = NE_MAX_TILES_Y, x2 = -1, y2 = -1;
+        for (uint8_t y = 0; y < NE_MAX_TILES_Y; y++)
+        {
+            for (uint8_t i = 0; i < NE_TILES_ROW_BYTES; i++)
             {
-                m_refreshFlags[y] |= (1<<x);
+                uint8_t f = flags[y][i];
+                if (!f) continue;
+                m_refreshFlags[y][i] |= f;
+                m_refreshRows[y >> 3] |= (1 << (y & 0x07));
+                if (y < y1) y1 = y;
+                y2 = y;
+                for (uint8_t b = 0; b < 8; b++)
+                {
+                    if (!(f & (1 << b))) continue;
+                    lcdint_t x = (i << 3) + b;
+                    if (x < x1) x1 = x;
+                    if (x > x2) x2 = x;
+                }
             }
         }
+        if (x2 < 0) return;
+        NanoRect rect = { {(lcdint_t)(x1 << B), (lcdint_t)(y1 << B)},
+                          {(lcdint_t)(((x2 + 1) << B) - 1), (lcdint_t)(((y2 + 1) << B) - 1)} };
+        if (m_displayRects) addDirtyRect( rect );
+        if (m_frameBudgetMs) addPriority( rect );
     }
 
     /**
@@ -214,6 +408,35 @@ public:
         refresh();
     }
 
+    /**
+     * Moves engine coordinate to new position (this sets World coordinates offset).
+     * If only vertical position is changed by multiple of tile height, and display
+     * controller supports hardware scrolling (ssd1306_lcd.set_start_line), display content
+     * is scrolled in hardware and only newly exposed strip of tiles is marked for refresh.
+     * Otherwise works as moveToAndRefresh().
+     */
+    static void moveToAndScroll(const NanoPoint & position)
+    {
+        lcdint_t dy = position.y - offset.y;
+        if ( (position.x != offset.x) || !ssd1306_lcd.set_start_line || m_wall ||
+             (dy % (lcdint_t)H) || (ssd1306_lcd.height % H) ||
+             (dy <= -(lcdint_t)ssd1306_lcd.height) || (dy >= (lcdint_t)ssd1306_lcd.height) )
+        {
+            moveToAndRefresh(position);
+            return;
+        }
+        moveTo(position);
+        if (!dy) return;
+        m_scrollLine = (m_scrollLine + ssd1306_lcd.height + dy) % ssd1306_lcd.height;
+        ssd1306_lcd.set_start_line(m_scrollLine);
+        scrollRefreshFlags(dy);
+        invalidateTileHashes();
+        if (dy > 0)
+            refresh(0, ssd1306_lcd.height - dy, ssd1306_lcd.width - 1, ssd1306_lcd.height - 1);
+        else
+            refresh(0, 0, ssd1306_lcd.width - 1, -dy - 1);
+    }
+
     /**
      * Returns current World offset
      */
@@ -242,6 +465,328 @@ public:
         m_onDraw = callback;
     }
 
+    /**
+     * Switches engine between tile mode (default) and dirty rectangles mode.
+     * In dirty rectangles mode areas, passed to refresh() methods, are merged into
+     * a small set of bounding boxes (up to NE_MAX_DIRTY_RECTS), and each box is drawn
+     * via canvas view of variable size, so the draw callback and blt() are called
+     * once per box rather than once per tile. Big boxes, not fitting tile buffer,
+     * are split into several views.
+     * @param enable - true to enable dirty rectangles mode, false to return to tile mode
+     * @note In dirty rectangles mode canvas size changes from call to call, so use
+     *       canvas.rect() in the draw callback to find out the area being updated.
+     * @warning Adafruit canvases do not support dirty rectangles mode.
+     */
+    static void useDirtyRects(bool enable)
+    {
+        m_displayRects = enable ? displayRects : nullptr;
+        refresh();
+    }
+
+    /**
+     * Enables frame diff mode. The mode is useful for the engine with single full-screen
+     * canvas (TILE_128x64_MONO for example). Instead of sending the whole canvas each
+     * frame, the engine compares it with previous frame, and sends only changed column
+     * runs of each page (row for RGB canvases).
+     * @param previous - buffer of canvas buffer size to keep previous frame,
+     *                   or nullptr to disable frame diff mode
+     * @note The mode works only if canvas covers the whole tile buffer at (0,0) and
+     *       hardware scrolling is not used. Otherwise the canvas is sent as is.
+     * @warning Adafruit canvases do not support frame diff mode.
+     */
+    static void useFrameDiff(uint8_t *previous)
+    {
+        m_previous = previous;
+        m_previousValid = false;
+        m_bltFrame = previous ? bltFrameDiff : nullptr;
+    }
+
+    /**
+     * Enables tile hash cache. After the draw callback the engine calculates hash of
+     * the tile content, and skips sending the tile if the hash matches the one, sent
+     * last time for the same tile. This saves bus traffic, when refreshed tiles often
+     * look the same as before (sprite moved back, repeated animation frames).
+     * @param hashes - buffer of NE_TILE_HASHES entries (4 bytes per tile),
+     *                 or nullptr to disable the cache
+     * @note Only whole tiles are cached, areas of other size (dirty rectangles, tile runs)
+     *       are sent as is. Call invalidateTileHashes() after drawing on the display
+     *       directly, bypassing the engine.
+     */
+    static void useTileHashes(uint32_t *hashes)
+    {
+        m_tileHashes = hashes;
+        invalidateTileHashes();
+    }
+
+    /** Forgets content of all tiles, so each tile is sent on next refresh */
+    static void invalidateTileHashes()
+    {
+        if (m_tileHashes) memset(m_tileHashes, 0, NE_TILE_HASHES * sizeof(uint32_t));
+    }
+
+    /**
+     * Enables tile refresh heatmap (debug mode). The engine counts, how many times each
+     * tile is drawn, so areas, refreshed too often or too broadly (whole-screen refresh(),
+     * oversized sprite rectangles), become visible. Counters saturate at 255.
+     * In SDL emulator counters are shown as red overlay over emulated display.
+     * @param counters - buffer of NE_TILE_HASHES bytes (NE_MAX_TILES_X per tile row),
+     *                   or nullptr to disable the heatmap
+     */
+    static void useHeatmap(uint8_t *counters)
+    {
+        m_heatmap = counters;
+        clearHeatmap();
+        showHeatmap();
+    }
+
+    /** Resets all heatmap counters to 0 */
+    static void clearHeatmap()
+    {
+        if (m_heatmap) memset(m_heatmap, 0, NE_TILE_HASHES);
+    }
+
+    /**
+     * Prints heatmap counters as text table (row per tile row) using passed callback,
+     * for example, to send them over serial port.
+     * @param func callback to use for printing single character
+     */
+    static void printHeatmap(void (*func)(uint8_t));
+
+    /**
+     * Binds the engine to display context. If context is set, the engine selects it
+     * before sending tiles to the display, so several engines (with different template
+     * arguments) can output to different displays.
+     * @param ctx display context, initialized by ssd1306_contextInit(), or nullptr
+     *            to output to currently active display (default)
+     * @note Engine selects context only in begin(), display() and notify(). Select context
+     *       manually, if you call direct draw functions between frames.
+     */
+    static void useContext(SSD1306Context *ctx)
+    {
+        m_context = ctx;
+    }
+
+    /**
+     * Makes the engine output to several displays (panels), combined into single screen.
+     * Screen size of the engine becomes the size of the whole wall, and each tile is sent
+     * to the panels it covers, selecting their contexts. Tiles, crossing panel borders, are
+     * split between the panels.
+     * @param panels array of panels, which must remain valid while the wall is used,
+     *               or nullptr to output to single display again
+     * @param count number of panels in the array
+     * @note Panel positions should be multiples of tile size, and for 1-bit canvases y must
+     *       be multiple of 8. Wall size is limited by NE_MAX_WIDTH and NE_MAX_HEIGHT.
+     *       Full screen buffer, background, frame diff and hardware scrolling are not used
+     *       with video wall, and the engine context (useContext()) is ignored.
+     */
+    static void useVideoWall(const NanoWallPanel *panels, uint8_t count)
+    {
+        m_wall = count ? panels : nullptr;
+        m_wallCount = count;
+        m_wallWidth = 0;
+        m_wallHeight = 0;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            m_wallWidth = max(m_wallWidth, (lcduint_t)(panels[i].x + panels[i].ctx->lcd.width));
+            m_wallHeight = max(m_wallHeight, (lcduint_t)(panels[i].y + panels[i].ctx->lcd.height));
+        }
+        invalidateTileHashes();
+        refresh();
+    }
+
+    /** Returns width of the engine screen: display width or video wall width */
+    static lcduint_t screenWidth()
+    {
+        return m_wall ? m_wallWidth : ssd1306_lcd.width;
+    }
+
+    /** Returns height of the engine screen: display height or video wall height */
+    static lcduint_t screenHeight()
+    {
+        return m_wall ? m_wallHeight : ssd1306_lcd.height;
+    }
+
+    /**
+     * Enables tile runs mode. In this mode consecutive tiles of the same row, marked
+     * for refresh, are drawn on canvas of run width (up to tiles * tile width), and
+     * each run is sent to the display with single blt(), i.e. single set_block() command
+     * sequence instead of one per tile. The draw callback is called once per run.
+     * @param strip - buffer for the run of tiles * W * H * bits per pixel / 8 bytes,
+     *                or nullptr to disable tile runs mode
+     * @param tiles - max number of tiles in single run
+     * @note In tile runs mode canvas size changes from call to call, so use canvas.rect()
+     *       in the draw callback to find out the area being updated. The mode is used only
+     *       in tile mode (without frame budget, dirty rectangles and render threads).
+     *       If multiplication is not supported (AVR tiny), runs are power of 2 tiles long.
+     * @warning Adafruit canvases do not support tile runs mode.
+     */
+    static void useTileRuns(uint8_t *strip, uint8_t tiles)
+    {
+        m_strip = tiles > 1 ? strip : nullptr;
+        m_runTiles = m_strip ? tiles : 1;
+        canvas.begin(W * m_runTiles, H, m_strip ? m_strip : m_buffer);
+        canvas.setSize(W, H);
+        refresh();
+    }
+
+#if NE_EXTERNAL_TILE_BUFFER
+    /**
+     * Sets tile buffer of NE_TILE_BUFFER_SIZE bytes. The engine doesn't reserve own
+     * buffer, if NE_EXTERNAL_TILE_BUFFER is set to 1, so the method must be called
+     * before the first display() call. The content of the buffer is not preserved
+     * between display() calls, so the same memory can be used by other code, while
+     * the engine is not drawing.
+     * @param buffer - buffer for the tile
+     * @warning Adafruit canvases do not support external tile buffer.
+     */
+    static void useBuffer(uint8_t *buffer)
+    {
+        m_buffer = buffer;
+        if (canvasBuffer() == m_buffer)
+        {
+            canvas.begin(W, H, m_buffer);
+        }
+        refresh();
+    }
+#endif
+
+    /**
+     * Returns tile buffer of NE_TILE_BUFFER_SIZE bytes. The content of the buffer
+     * is not preserved between display() calls, so the buffer can be used as scratch
+     * memory by other code (image streams for example), while the engine is not drawing.
+     */
+    static uint8_t *tileBuffer()
+    {
+        return m_buffer;
+    }
+
+    /**
+     * Enables display list mode. In this mode the draw callback is called once per frame,
+     * if any area is refreshed, and it must record the scene with NanoDisplayList methods
+     * instead of drawing on canvas. Then for every tile, being updated, the engine replays
+     * only recorded operations, intersecting the tile. This saves scene code (game logic,
+     * loops over objects) from running once per tile.
+     * @param list - display list to record the scene to, or nullptr to disable the mode
+     * @note All other modes (dirty rectangles, frame budget, background layer) work as usual.
+     *       Text area is calculated from the font, active during recording. Background layer
+     *       is not loaded for tiles, completely covered by opaque operations of the list.
+     * @warning Adafruit canvases do not support display list mode.
+     */
+    static void useDisplayList(NanoDisplayList *list)
+    {
+        m_displayList = list;
+        refresh();
+    }
+
+    /**
+     * Sets time budget for drawing tiles in single display() call. Once budget is
+     * spent, the engine stops, and remaining tiles are drawn on next frames. Tiles,
+     * covering areas, refreshed since last display() call (moved sprites usually), are
+     * drawn first. This keeps input processing responsive, when frame is overloaded.
+     * @param ms - time budget in milliseconds, or 0 to draw all tiles (default)
+     * @note At least one tile is drawn on each call. Only tile mode supports time budget.
+     */
+    static void setFrameBudget(uint16_t ms)
+    {
+        if (!m_frameBudgetMs) m_priority = { {0, 0}, {-1, -1} };
+        m_frameBudgetMs = ms;
+    }
+
+    /**
+     * Enables static background layer. The background is drawn by the callback
+     * once into off-screen buffer of display size, and then each area, being
+     * updated, is restored from that buffer before calling the draw callback.
+     * So, the draw callback must not clear canvas, and should draw only dynamic
+     * objects (sprites). The background callback can draw anything, a NanoTileMap
+     * for example, and is called per tile, like the draw callback.
+     * @param buffer - buffer of display size (width * height * bits per pixel / 8 bytes),
+     *                 or nullptr to disable background layer
+     * @param callback - callback, drawing static background
+     * @note Call refreshBackground() if background content is changed.
+     * @warning Adafruit canvases do not support background layer.
+     */
+    static void useBackground(uint8_t *buffer, TNanoEngineOnDraw callback)
+    {
+        m_background = buffer;
+        m_onBackground = callback;
+        m_loadBackground = buffer ? loadBackground : nullptr;
+        refreshBackground();
+    }
+
+    /**
+     * Marks background layer as changed. The background will be redrawn
+     * into off-screen buffer on next display update, and the whole screen is refreshed.
+     */
+    static void refreshBackground()
+    {
+        m_backgroundValid = false;
+        refresh();
+    }
+
+#if defined(CONFIG_LARGE_RAM_AVAILABLE)
+    /**
+     * Switches engine to full-screen buffer mode, available on hosts with plenty
+     * of RAM (Linux, Raspberry Pi). The engine allocates canvas buffer of display
+     * size and the buffer with previous frame, so drawn content stays in the canvas
+     * between frames, and there is no tile loop anymore. display() calls the draw
+     * callback once for the whole screen if any area is refreshed, then sends
+     * the band of changed scanlines as single full-width block, which goes to
+     * the display in one transfer. If draw callback is not set, display() just
+     * sends the changes, made to the canvas since previous frame.
+     * @param enable - true to allocate full-screen buffers, false to free them
+     *                 and return to tile buffer
+     * @return false if buffers cannot be allocated, the engine stays in tile mode then.
+     * @note Call the method after display is initialized. Frame budget, dirty
+     *       rectangles and frame diff settings are not used in this mode.
+     * @note If CONFIG_ESP32_PSRAM_ENABLE is defined, full-screen buffers are allocated in
+     *       PSRAM, and display() processes the screen by full-width strips of tile height:
+     *       each strip is copied to internal RAM, drawn there (draw callback is called
+     *       once per strip, like per tile), written back, compared with previous frame
+     *       and sent to the display from internal RAM.
+     * @warning Hardware scrolling and Adafruit canvases are not supported in this mode.
+     */
+    static bool useScreenBuffer(bool enable)
+    {
+        free(m_screen);
+        free(m_screenPrevious);
+        m_screen = nullptr;
+        m_screenPrevious = nullptr;
+        m_previousValid = false;
+#if defined(CONFIG_EXTERNAL_RAM_AVAILABLE)
+        free(m_screenStrip);
+        m_screenStrip = nullptr;
+#endif
+        if (enable)
+        {
+            const uint32_t size = C::BITS_PER_PIXEL == 1 ?
+                   (uint32_t)ssd1306_lcd.width * ((ssd1306_lcd.height + 7) >> 3) :
+                   (uint32_t)((ssd1306_lcd.width * C::BITS_PER_PIXEL + 7) >> 3) * ssd1306_lcd.height;
+            m_screen = static_cast<uint8_t *>(ssd1306_largeAlloc(size));
+            m_screenPrevious = static_cast<uint8_t *>(ssd1306_largeAlloc(size));
+#if defined(CONFIG_EXTERNAL_RAM_AVAILABLE)
+            m_screenStrip = static_cast<uint8_t *>(ssd1306_fastAlloc(size / ssd1306_lcd.height * H));
+            if (!m_screenStrip)
+            {
+                useScreenBuffer(false);
+                return false;
+            }
+#endif
+            if (!m_screen || !m_screenPrevious)
+            {
+                useScreenBuffer(false);
+                return false;
+            }
+            canvas.begin(ssd1306_lcd.width, ssd1306_lcd.height, m_screen);
+        }
+        else
+        {
+            canvas.begin(W, H, m_strip ? m_strip : m_buffer);
+        }
+        refresh();
+        return true;
+    }
+#endif
+
     /**
      * @brief Returns true if point is inside the rectangle area.
      * Returns true if point is inside the rectangle area.
@@ -256,11 +801,146 @@ protected:
      * Contains information on tiles to be updated.
      * Elements of array are rows and bits are columns.
      */
-    static uint16_t   m_refreshFlags[NE_MAX_TILES_NUM];
+    static uint8_t    m_refreshFlags[NE_MAX_TILES_Y][NE_TILES_ROW_BYTES];
+
+    /**
+     * Summary of refresh flags: bit per tile row. Bit is set, if the row can have
+     * tiles to update, so rows without changes are skipped without checking their flags.
+     */
+    static uint8_t    m_refreshRows[NE_TILE_ROWS_BYTES];
+
+    /** Clears all refresh flags */
+    static void clearRefreshFlags()
+    {
+        memset(m_refreshFlags, 0, sizeof(m_refreshFlags));
+        memset(m_refreshRows, 0, sizeof(m_refreshRows));
+    }
+
+    /** Returns true if any tile is marked for update */
+    static bool hasRefreshFlags()
+    {
+        for (uint8_t y = 0; y < NE_MAX_TILES_Y; y++)
+        {
+            if (!(m_refreshRows[y >> 3] & (1 << (y & 0x07)))) continue;
+            for (uint8_t x = 0; x < NE_TILES_ROW_BYTES; x++)
+            {
+                if (m_refreshFlags[y][x]) return true;
+            }
+        }
+        return false;
+    }
+
+    /** Returns index of the lowest set bit of non-zero byte */
+    static uint8_t lowestBit(uint8_t f)
+    {
+#if defined(__AVR__)
+        uint8_t b = 0;
+        while (!(f & 0x01))
+        {
+            f >>= 1;
+            b++;
+        }
+        return b;
+#else
+        return __builtin_ctz(f);
+#endif
+    }
+
+    /**
+     * Calls function for each tile, marked for update, in display order, and clears
+     * refresh flags. Tile rows without changes are skipped by summary flags, and
+     * tiles in the row are found by bit scan, so the cost is proportional to number
+     * of updated tiles rather than to number of tiles on the display.
+     * @param f - function, accepting tile position in pixels
+     */
+    template<typename F>
+    static void forEachRefreshedTile(F f)
+    {
+        const uint8_t cols = min((lcdint_t)(((screenWidth() - 1) >> B) + 1), (lcdint_t)NE_MAX_TILES_X);
+        const uint8_t rows = min((lcdint_t)(((screenHeight() - 1) >> B) + 1), (lcdint_t)NE_MAX_TILES_Y);
+        for (uint8_t r = 0; r < NE_TILE_ROWS_BYTES; r++)
+        {
+            uint8_t rowFlags = m_refreshRows[r];
+            m_refreshRows[r] = 0;
+            while (rowFlags)
+            {
+                const uint8_t ty = (r << 3) + lowestBit(rowFlags);
+                rowFlags &= rowFlags - 1;
+                uint8_t *flags = m_refreshFlags[ty];
+                if (ty >= rows)
+                {
+                    memset(flags, 0, NE_TILES_ROW_BYTES);
+                    continue;
+                }
+                for (uint8_t i = 0; i < NE_TILES_ROW_BYTES; i++)
+                {
+                    uint8_t tiles = flags[i];
+                    flags[i] = 0;
+                    while (tiles)
+                    {
+                        const uint8_t tx = (i << 3) + lowestBit(tiles);
+                        if (tx >= cols) break;
+                        tiles &= tiles - 1;
+                        f((lcdint_t)tx << B, (lcdint_t)ty << B);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Returns refresh flags for 8 tiles, starting at specified tile position,
+     * and clears them. Bit 0 corresponds to tile at (tx,ty).
+     * @param tx horizontal tile index, must be multiple of 8
+     * @param ty vertical tile index
+     */
+    static uint8_t    takeRefreshFlags(uint8_t tx, uint8_t ty)
+    {
+        if ((ty >= NE_MAX_TILES_Y) || (tx >= NE_MAX_TILES_X)) return 0;
+        uint8_t flag = m_refreshFlags[ty][tx >> 3];
+        m_refreshFlags[ty][tx >> 3] = 0;
+        return flag;
+    }
 
     /** Callback to call if specific tile needs to be updated */
     static TNanoEngineOnDraw m_onDraw;
 
+    /** Areas to be updated in dirty rectangles mode */
+    static NanoRect   m_rects[NE_MAX_DIRTY_RECTS];
+
+    /** Number of areas to be updated in dirty rectangles mode */
+    static uint8_t    m_rectsCount;
+
+    /** Dirty rectangles renderer, set only if dirty rectangles mode is active */
+    static void     (*m_displayRects)(void);
+
+    /**
+     * Adds area to the list of dirty rectangles. The area is merged with
+     * existing boxes if their bounding box is not larger than both areas together.
+     * If there is no free slot, the area is joined to the box, giving the least overdraw.
+     * @param rect - area in local screen coordinates
+     */
+    static void addDirtyRect(NanoRect rect);
+
+    /**
+     * Returns number of extra pixels, which will be redrawn if two areas are merged.
+     * Negative values mean that areas overlap.
+     */
+    static int32_t dirtyRectsWaste(const NanoRect &a, const NanoRect &b)
+    {
+        NanoRect box = a;
+        box.join(b);
+        return (int32_t)box.width() * box.height()
+               - (int32_t)a.width() * a.height()
+               - (int32_t)b.width() * b.height();
+    }
+
+    /**
+     * Draws all dirty rectangles and clears the list. Used by displayBuffer()
+     * in dirty rectangles mode.
+     */
+    static void displayRects();
+
     /**
      * @brief refreshes content on oled display.
      * Refreshes content on oled display. Call it, if you want to update the screen.
@@ -269,79 +949,1183 @@ protected:
      */
     static void displayBuffer();
 
+    /** Time budget for drawing tiles in milliseconds, 0 if not limited */
+    static uint16_t   m_frameBudgetMs;
+
+    /** Bounding box of areas, refreshed since last display, in screen coordinates */
+    static NanoRect   m_priority;
+
+    /** Adds area to the bounding box of areas, which are drawn first in time budget mode */
+    static void addPriority(const NanoRect &rect)
+    {
+        if (m_priority.p2.x < m_priority.p1.x) m_priority = rect;
+        else m_priority.join(rect);
+    }
+
+    /**
+     * Draws refreshed tiles until time budget is spent, starting with priority area.
+     * Used by displayBuffer() if time budget is set.
+     */
+    static void displayBudget();
+
+    /**
+     * Draws single area via draw callback and sends it to the display.
+     * Collects timings if profiler is enabled.
+     * @param x - left position of the area in screen coordinates
+     * @param y - top position of the area in screen coordinates
+     */
+    static void drawTile(lcdint_t x, lcdint_t y);
+
+    /** Timings of the current frame, collected only if profiler is enabled */
+    static NanoEngineFrameStats *m_frameStats;
+
+    /** Display list of the scene, set only if display list mode is active */
+    static NanoDisplayList *m_displayList;
+
+    /** Set if display list holds ready frame, i.e. the draw callback returned true */
+    static bool       m_displayListReady;
+
+    /**
+     * Records the scene into display list via draw callback, if any area is refreshed.
+     * Used by displayBuffer() in display list mode.
+     */
+    static void recordDisplayList();
+
+    /** Draws recorded operations on the canvas. Used instead of draw callback in display list mode. */
+    static bool replayDisplayList()
+    {
+        if (m_displayListReady) m_displayList->replay(canvas);
+        return m_displayListReady;
+    }
+
+    /** Draws refreshed areas via draw callback in all modes, except full-screen buffer mode */
+    static void displayAreas();
+
     /**
      * @brief prints popup message over display content
      * prints popup message over display content
      * @param msg - message to display
      */
     static void displayPopup(const char *msg);
-private:
-    /** Buffer, used by NanoCanvas */
-    static uint8_t    m_buffer[W * H * C::BITS_PER_PIXEL / 8];
 
-    static NanoPoint offset;
-};
+    /**
+     * Callback to send ready canvas content to the display instead of canvas.blt().
+     * Allows child classes to pass rendered tiles to another task or core.
+     */
+    static void     (*m_onBlt)(void);
 
-template<class C, lcduint_t W, lcduint_t H, uint8_t B>
-uint16_t NanoEngineTiler<C,W,H,B>::m_refreshFlags[NE_MAX_TILES_NUM];
+    /** Sends ready canvas content to the display */
+    static void bltCanvas()
+    {
+        if (m_tileHashes && !tileChanged()) return;
+        if (m_wall) bltWall();
+        else if (m_onBlt) m_onBlt();
+        else if (m_bltFrame) m_bltFrame();
+        else canvas.blt(canvas.offset.x, gdramY(canvas.offset.y));
+        if (m_probeBlt)
+        {
+            m_firstBltUs = micros();
+            m_probeBlt = false;
+        }
+    }
 
-template<class C, lcduint_t W, lcduint_t H, uint8_t B>
-uint8_t NanoEngineTiler<C,W,H,B>::m_buffer[W * H * C::BITS_PER_PIXEL / 8];
+    /** Set to request time of the next tile transfer, cleared when m_firstBltUs is taken */
+    static bool m_probeBlt;
+    /** Time in microseconds, when the tile, requested by m_probeBlt, is sent */
+    static uint32_t m_firstBltUs;
 
-template<class C, lcduint_t W, lcduint_t H, uint8_t B>
-C NanoEngineTiler<C,W,H,B>::canvas(W, H, m_buffer);
+    /** display context of the engine or nullptr */
+    static SSD1306Context *m_context;
 
-template<class C, lcduint_t W, lcduint_t H, uint8_t B>
-NanoPoint NanoEngineTiler<C,W,H,B>::offset = {0, 0};
+    /** selects display context of the engine if it is set */
+    static void selectContext()
+    {
+        if (m_context && !m_wall) ssd1306_contextSelect(m_context);
+    }
 
-template<class C, lcduint_t W, lcduint_t H, uint8_t B>
-TNanoEngineOnDraw NanoEngineTiler<C,W,H,B>::m_onDraw = nullptr;
+    /** Panels of video wall or nullptr */
+    static const NanoWallPanel *m_wall;
+    /** Number of panels in m_wall */
+    static uint8_t m_wallCount;
+    /** Width of video wall in pixels: right edge of the rightmost panel */
+    static lcduint_t m_wallWidth;
+    /** Height of video wall in pixels: bottom edge of the lowest panel */
+    static lcduint_t m_wallHeight;
 
-template<class C, lcduint_t W, lcduint_t H, uint8_t B>
-void NanoEngineTiler<C,W,H,B>::displayBuffer()
+    /** Sends canvas content to all video wall panels, covered by the canvas */
+    static void bltWall();
+
+    /** Buffer, holding previous frame in frame diff mode */
+    static uint8_t   *m_previous;
+
+    /** Indicates if m_previous holds content, currently displayed on the screen */
+    static bool       m_previousValid;
+
+    /** Frame diff renderer, set only if frame diff mode is active */
+    static void     (*m_bltFrame)(void);
+
+    /** Hashes of tiles content, sent to the display, or nullptr. 0 means unknown content */
+    static uint32_t  *m_tileHashes;
+
+    /** Refresh counters of tiles or nullptr */
+    static uint8_t   *m_heatmap;
+
+    /** Increments heatmap counters of tiles, covered by the area of canvas size at x,y */
+    static void countHeat(lcdint_t x, lcdint_t y);
+
+    /** Shows heatmap over emulated display, does nothing on real hardware */
+    static void showHeatmap()
+    {
+#ifdef SDL_EMULATION
+        sdl_core_set_heatmap(m_heatmap, min((lcdint_t)(((screenWidth() - 1) >> B) + 1), (lcdint_t)NE_MAX_TILES_X),
+                             min((lcdint_t)(((screenHeight() - 1) >> B) + 1), (lcdint_t)NE_MAX_TILES_Y),
+                             NE_MAX_TILES_X, W, H);
+#endif
+    }
+
+    /**
+     * Returns false if canvas holds whole tile, and its content is the same as
+     * sent last time. Otherwise remembers hash of the new content and returns true.
+     * Used by bltCanvas() if tile hash cache is active.
+     */
+    static bool tileChanged();
+
+    /**
+     * Sends to the display only those parts of canvas, which are different from
+     * the previous frame, and remembers the canvas as the new previous frame.
+     */
+    static void bltFrameDiff();
+
+    /** Off-screen buffer of display size, holding background layer */
+    static uint8_t   *m_background;
+
+    /** Callback, drawing background layer */
+    static TNanoEngineOnDraw m_onBackground;
+
+    /** Indicates if m_background holds content, drawn by m_onBackground */
+    static bool       m_backgroundValid;
+
+    /** Background loader, set only if background layer is active */
+    static void     (*m_loadBackground)(void);
+
+    /**
+     * Copies background layer content for the area, covered by canvas, into canvas
+     * buffer. Draws background into off-screen buffer first, if it is not valid.
+     */
+    static void loadBackground();
+
+    /**
+     * Copies content between canvas buffer and background buffer for the area,
+     * covered by canvas.
+     * @param toCanvas - true to copy background to canvas, false to copy canvas to background
+     */
+    static void copyBackground(bool toCanvas);
+
+#if defined(CONFIG_LARGE_RAM_AVAILABLE)
+    /** Full-screen canvas buffer, allocated in full-screen buffer mode */
+    static uint8_t   *m_screen;
+
+    /** Buffer, holding previous frame in full-screen buffer mode */
+    static uint8_t   *m_screenPrevious;
+
+#if defined(CONFIG_EXTERNAL_RAM_AVAILABLE)
+    /** Full-width strip in internal RAM, used to process full-screen buffers, located in PSRAM */
+    static uint8_t   *m_screenStrip;
+
+    /**
+     * Draws, compares and sends the whole screen by strips in internal RAM. Used by
+     * displayScreen(), if full-screen buffers are located in external RAM.
+     */
+    static void displayScreenStrips();
+#endif
+
+    /**
+     * Draws the whole screen in full-screen buffer mode, and sends to the display
+     * the band of scanlines, changed since previous frame.
+     */
+    static void displayScreen();
+#endif
+
+    /** Buffer for runs of tiles in tile runs mode, or nullptr */
+    static uint8_t   *m_strip;
+
+    /** Max number of tiles in single run, 1 if tile runs mode is not active */
+    static uint8_t    m_runTiles;
+
+    /**
+     * Draws runs of consecutive refreshed tiles in each tile row, and sends
+     * each run via single blt(). Used by displayBuffer() in tile runs mode.
+     */
+    static void displayRuns();
+
+    /** Returns buffer, currently used by canvas */
+    static uint8_t *canvasBuffer()
+    {
+#if defined(CONFIG_LARGE_RAM_AVAILABLE)
+        if (m_screen) return m_screen;
+#endif
+        if (m_strip) return m_strip;
+        return m_buffer;
+    }
+
+    /** Current hardware scroll position: GDRAM line, displayed at the top of the screen */
+    static lcduint_t  m_scrollLine;
+
+    /**
+     * Converts screen row to GDRAM row, according to hardware scroll position.
+     * @param y - screen row in pixels
+     */
+    static lcdint_t gdramY(lcdint_t y)
+    {
+        if (!m_scrollLine) return y;
+        uint16_t line = (uint16_t)y + m_scrollLine;
+        return line >= ssd1306_lcd.height ? line - ssd1306_lcd.height : line;
+    }
+
+    /**
+     * Moves areas, pending for refresh, after display content is scrolled by dy pixels.
+     * @param dy - scroll distance in pixels, multiple of tile height
+     */
+    static void scrollRefreshFlags(lcdint_t dy)
+    {
+        lcdint_t rows = dy / (lcdint_t)H;
+        for (uint8_t y = 0; y < NE_MAX_TILES_Y; y++)
+        {
+            lcdint_t src = rows > 0 ? y + rows : NE_MAX_TILES_Y - 1 - y + rows;
+            lcdint_t dst = rows > 0 ? y : NE_MAX_TILES_Y - 1 - y;
+            if ((src >= 0) && (src < NE_MAX_TILES_Y))
+                memcpy(m_refreshFlags[dst], m_refreshFlags[src], NE_TILES_ROW_BYTES);
+            else
+                memset(m_refreshFlags[dst], 0, NE_TILES_ROW_BYTES);
+        }
+        memset(m_refreshRows, 0, sizeof(m_refreshRows));
+        for (uint8_t y = 0; y < NE_MAX_TILES_Y; y++)
+        {
+            for (uint8_t i = 0; i < NE_TILES_ROW_BYTES; i++)
+            {
+                if (m_refreshFlags[y][i]) m_refreshRows[y >> 3] |= (1 << (y & 0x07));
+            }
+        }
+        for (uint8_t i = 0; i < m_rectsCount; i++)
+        {
+            m_rects[i].addV(-dy);
+        }
+    }
+
+#if NE_EXTERNAL_TILE_BUFFER
+    /** Buffer, used by NanoCanvas, passed by useBuffer() */
+    static uint8_t *m_buffer;
+#else
+    /** Buffer, used by NanoCanvas */
+    static NE_TILE_STORAGE uint8_t m_buffer[NE_TILE_BUFFER_SIZE];
+#endif
+
+#if NE_RENDER_THREADS > 1
+    /** Render threads and the queue of tiles to draw in current frame */
+    struct TileWorkers
+    {
+        /** Tiles of current frame in display order */
+        NanoPoint tiles[NE_MAX_TILES_X * NE_MAX_TILES_Y];
+        /** Number of tiles in current frame */
+        uint16_t count = 0;
+        /** Index of next tile to draw, lock-free work queue head */
+        std::atomic<uint16_t> next{0};
+        /** Index of next tile to send to the display, protected by lock */
+        uint16_t blt = 0;
+        /** Number of render threads, still working on current frame */
+        uint8_t active = 0;
+        /** Frame number, changes when new frame is started */
+        uint32_t frame = 0;
+        /** Set, when render threads must exit */
+        bool stop = false;
+        std::mutex lock;
+        std::condition_variable started;
+        std::condition_variable finished;
+        std::condition_variable sent;
+        std::thread *threads[NE_RENDER_THREADS - 1] = {};
+
+        ~TileWorkers()
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stop = true;
+            }
+            started.notify_all();
+            for (uint8_t i = 0; i < NE_RENDER_THREADS - 1; i++)
+            {
+                if (threads[i]) threads[i]->join();
+                delete threads[i];
+            }
+        }
+    };
+
+    static TileWorkers m_workers;
+
+    /** Draws tiles from the queue, and sends them to the display in tile order */
+    static void renderTiles();
+
+    /** Main function of render thread */
+    static void renderThread();
+
+    /** Draws refreshed tiles using all render threads */
+    static void displayTilesParallel();
+#endif
+
+private:
+    static NanoPoint offset;
+};
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t NanoEngineTiler<C,W,H,B>::m_refreshFlags[NE_MAX_TILES_Y][NE_TILES_ROW_BYTES];
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t NanoEngineTiler<C,W,H,B>::m_refreshRows[NE_TILE_ROWS_BYTES];
+
+#if NE_EXTERNAL_TILE_BUFFER
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t *NanoEngineTiler<C,W,H,B>::m_buffer = nullptr;
+#else
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+NE_TILE_STORAGE uint8_t NanoEngineTiler<C,W,H,B>::m_buffer[NE_TILE_BUFFER_SIZE];
+#endif
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+NE_TILE_STORAGE C NanoEngineTiler<C,W,H,B>::canvas(W, H, m_buffer);
+
+#if NE_RENDER_THREADS > 1
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+typename NanoEngineTiler<C,W,H,B>::TileWorkers NanoEngineTiler<C,W,H,B>::m_workers;
+#endif
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+NanoPoint NanoEngineTiler<C,W,H,B>::offset = {0, 0};
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+TNanoEngineOnDraw NanoEngineTiler<C,W,H,B>::m_onDraw = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+NanoRect NanoEngineTiler<C,W,H,B>::m_rects[NE_MAX_DIRTY_RECTS];
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t NanoEngineTiler<C,W,H,B>::m_rectsCount = 0;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void (*NanoEngineTiler<C,W,H,B>::m_displayRects)(void) = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void (*NanoEngineTiler<C,W,H,B>::m_onBlt)(void) = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+lcduint_t NanoEngineTiler<C,W,H,B>::m_scrollLine = 0;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+SSD1306Context *NanoEngineTiler<C,W,H,B>::m_context = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+bool NanoEngineTiler<C,W,H,B>::m_probeBlt = false;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint32_t NanoEngineTiler<C,W,H,B>::m_firstBltUs = 0;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+const NanoWallPanel *NanoEngineTiler<C,W,H,B>::m_wall = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t NanoEngineTiler<C,W,H,B>::m_wallCount = 0;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+lcduint_t NanoEngineTiler<C,W,H,B>::m_wallWidth = 0;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+lcduint_t NanoEngineTiler<C,W,H,B>::m_wallHeight = 0;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t *NanoEngineTiler<C,W,H,B>::m_previous = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+bool NanoEngineTiler<C,W,H,B>::m_previousValid = false;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void (*NanoEngineTiler<C,W,H,B>::m_bltFrame)(void) = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint32_t *NanoEngineTiler<C,W,H,B>::m_tileHashes = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t *NanoEngineTiler<C,W,H,B>::m_heatmap = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+NanoEngineFrameStats *NanoEngineTiler<C,W,H,B>::m_frameStats = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+NanoDisplayList *NanoEngineTiler<C,W,H,B>::m_displayList = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+bool NanoEngineTiler<C,W,H,B>::m_displayListReady = false;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint16_t NanoEngineTiler<C,W,H,B>::m_frameBudgetMs = 0;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+NanoRect NanoEngineTiler<C,W,H,B>::m_priority = { {0, 0}, {-1, -1} };
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t *NanoEngineTiler<C,W,H,B>::m_strip = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t NanoEngineTiler<C,W,H,B>::m_runTiles = 1;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t *NanoEngineTiler<C,W,H,B>::m_background = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+TNanoEngineOnDraw NanoEngineTiler<C,W,H,B>::m_onBackground = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+bool NanoEngineTiler<C,W,H,B>::m_backgroundValid = false;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void (*NanoEngineTiler<C,W,H,B>::m_loadBackground)(void) = nullptr;
+
+#if defined(CONFIG_LARGE_RAM_AVAILABLE)
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t *NanoEngineTiler<C,W,H,B>::m_screen = nullptr;
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t *NanoEngineTiler<C,W,H,B>::m_screenPrevious = nullptr;
+
+#if defined(CONFIG_EXTERNAL_RAM_AVAILABLE)
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+uint8_t *NanoEngineTiler<C,W,H,B>::m_screenStrip = nullptr;
+#endif
+#endif
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::copyBackground(bool toCanvas)
 {
-    if (!m_onDraw)  // If onDraw handler is not set, just output current canvas
+    /* Background buffer has the same layout as full screen canvas. Offsets and sizes *
+     * of 4-bit canvas are even, since tile width is always even.                   */
+    const uint8_t  pixelBytes = C::BITS_PER_PIXEL == 16 ? 2 : 1;
+    const uint8_t  unitPixels = C::BITS_PER_PIXEL == 4 ? 2 : 1;
+    const uint8_t  unitRows = C::BITS_PER_PIXEL == 1 ? 8 : 1;
+    const NanoRect rect = canvas.rect();
+    lcdint_t x2 = min(rect.p2.x, (lcdint_t)(ssd1306_lcd.width - 1));
+    lcdint_t y2 = min(rect.p2.y, (lcdint_t)(ssd1306_lcd.height - 1));
+    if ((x2 < rect.p1.x) || (y2 < rect.p1.y)) return;
+    const uint16_t len = (x2 - rect.p1.x + 1) / unitPixels * pixelBytes;
+    const uint16_t pitch = rect.width() / unitPixels * pixelBytes;
+    uint8_t *buf = canvasBuffer();
+    for (lcdint_t y = rect.p1.y; y <= y2; y = y + unitRows)
+    {
+        uint8_t *bg = &m_background[((uint32_t)(y / unitRows) * ssd1306_lcd.width + rect.p1.x) / unitPixels * pixelBytes];
+        if (toCanvas) memcpy(buf, bg, len);
+        else memcpy(bg, buf, len);
+        buf += pitch;
+    }
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::loadBackground()
+{
+    /* Background is not visible under opaque cover of the recorded scene */
+    if (m_displayList && m_displayListReady && m_displayList->covers(canvas.rect())) return;
+    if (!m_backgroundValid)
     {
+        const NanoRect rect = canvas.rect();
+        canvas.setSize(W, H);
+        for (lcduint_t y = 0; y < ssd1306_lcd.height; y = y + NE_TILE_HEIGHT)
+        {
+            for (lcduint_t x = 0; x < ssd1306_lcd.width; x = x + NE_TILE_WIDTH)
+            {
+                canvas.setOffset(x, y);
+                canvas.clear();
+                m_onBackground();
+                canvas.setOffset(x, y);
+                copyBackground(false);
+            }
+        }
+        canvas.setSize(rect.width(), rect.height());
+        canvas.setOffset(rect.p1.x, rect.p1.y);
+        m_backgroundValid = true;
+    }
+    copyBackground(true);
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+bool NanoEngineTiler<C,W,H,B>::tileChanged()
+{
+    const NanoRect rect = canvas.rect();
+    const lcdint_t tx = rect.p1.x >> B;
+    const lcdint_t ty = rect.p1.y >> B;
+    if ( (rect.width() != (lcdint_t)W) || (rect.height() != (lcdint_t)H) ||
+         (rect.p1.x != (tx << B)) || (rect.p1.y != (ty << B)) ||
+         (tx < 0) || (ty < 0) || (tx >= NE_MAX_TILES_X) || (ty >= NE_MAX_TILES_Y) )
+    {
+        /* Content of the tiles, covered by the area, is not known anymore */
+        for (lcdint_t y = max((lcdint_t)(rect.p1.y >> B), (lcdint_t)0);
+             y <= min((lcdint_t)(rect.p2.y >> B), (lcdint_t)(NE_MAX_TILES_Y - 1)); y++)
+        {
+            for (lcdint_t x = max((lcdint_t)(rect.p1.x >> B), (lcdint_t)0);
+                 x <= min((lcdint_t)(rect.p2.x >> B), (lcdint_t)(NE_MAX_TILES_X - 1)); x++)
+            {
+                m_tileHashes[y * NE_MAX_TILES_X + x] = 0;
+            }
+        }
+        return true;
+    }
+    /* FNV-1a hash of the tile buffer. 0 is reserved for unknown content.  *
+     * 1-bit canvases are sent in current color, so it is hashed as well.  */
+    const uint8_t *data = canvasBuffer();
+    uint32_t hash = 2166136261UL ^ (C::BITS_PER_PIXEL == 1 ? ssd1306_color : 0);
+    for (uint32_t i = 0; i < NE_TILE_BUFFER_SIZE; i++)
+    {
+        hash = (hash ^ data[i]) * 16777619UL;
+    }
+    if (!hash) hash = 1;
+    uint32_t &cached = m_tileHashes[ty * NE_MAX_TILES_X + tx];
+    if (cached == hash)
+    {
+        if (m_frameStats) m_frameStats->skipped++;
+        return false;
+    }
+    cached = hash;
+    return true;
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::bltWall()
+{
+    const NanoRect rect = canvas.rect();
+    const NanoPoint origin = canvas.offset;
+    for (uint8_t i = 0; i < m_wallCount; i++)
+    {
+        const NanoWallPanel &panel = m_wall[i];
+        NanoRect area = { {panel.x, panel.y},
+                          {(lcdint_t)(panel.x + panel.ctx->lcd.width - 1),
+                           (lcdint_t)(panel.y + panel.ctx->lcd.height - 1)} };
+        area.crop(rect);
+        if ((area.p2.x < area.p1.x) || (area.p2.y < area.p1.y)) continue;
+        ssd1306_contextSelect(panel.ctx);
+        /* Canvas offset becomes position on the panel, area becomes canvas local */
+        canvas.setOffset(origin.x - panel.x, origin.y - panel.y);
+        canvas.blt(area - origin);
+    }
+    canvas.setOffset(origin.x, origin.y);
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::bltFrameDiff()
+{
+    const NanoRect rect = canvas.rect();
+    if ( m_scrollLine || m_strip || rect.p1.x || rect.p1.y ||
+         (rect.width() != (lcdint_t)W) || (rect.height() != (lcdint_t)H) )
+    {
+        m_previousValid = false;
+        canvas.blt(canvas.offset.x, gdramY(canvas.offset.y));
+        return;
+    }
+    if (!m_previousValid)
+    {
+        canvas.blt(0, 0);
+        memcpy(m_previous, m_buffer, NE_TILE_BUFFER_SIZE);
+        m_previousValid = true;
+        return;
+    }
+    /* 1-bit canvas is compared by pages, other canvases are compared by rows. *
+     * 4-bit canvas is compared by bytes, holding 2 pixels each.               */
+    const uint8_t  pixelBytes = C::BITS_PER_PIXEL == 16 ? 2 : 1;
+    const uint8_t  unitPixels = C::BITS_PER_PIXEL == 4 ? 2 : 1;
+    const uint8_t  unitRows = C::BITS_PER_PIXEL == 1 ? 8 : 1;
+    const uint16_t unitBytes = W / unitPixels * pixelBytes;
+    for (lcduint_t y = 0; y < H; y += unitRows)
+    {
+        const uint8_t *cur = &m_buffer[(uint32_t)(y / unitRows) * unitBytes];
+        uint8_t *prev = &m_previous[(uint32_t)(y / unitRows) * unitBytes];
+        uint16_t i = 0;
+        while (i < unitBytes)
+        {
+            /* Skip unchanged part 4 bytes at once, compilers turn it into single word compare */
+            while ((i + 4 <= unitBytes) && !memcmp(&cur[i], &prev[i], 4)) i += 4;
+            while ((i < unitBytes) && (cur[i] == prev[i])) i++;
+            if (i >= unitBytes) break;
+            lcduint_t x1 = i / pixelBytes;
+            lcduint_t x2 = x1;
+            for (lcduint_t x = x1 + 1, gap = 0; (x < W / unitPixels) && (gap < NE_FRAME_DIFF_GAP); x++)
+            {
+                if (memcmp(&cur[x * pixelBytes], &prev[x * pixelBytes], pixelBytes))
+                {
+                    x2 = x;
+                    gap = 0;
+                }
+                else
+                {
+                    gap++;
+                }
+            }
+            canvas.blt( { {(lcdint_t)(x1 * unitPixels), (lcdint_t)y},
+                          {(lcdint_t)((x2 + 1) * unitPixels - 1), (lcdint_t)(y + unitRows - 1)} } );
+            memcpy(&prev[x1 * pixelBytes], &cur[x1 * pixelBytes], (x2 - x1 + 1) * pixelBytes);
+            i = (x2 + 1) * pixelBytes;
+        }
+    }
+}
+
+#if defined(CONFIG_LARGE_RAM_AVAILABLE)
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::displayScreen()
+{
+#if defined(CONFIG_EXTERNAL_RAM_AVAILABLE)
+    if (m_screenStrip)
+    {
+        displayScreenStrips();
+        return;
+    }
+#endif
+    bool changed = hasRefreshFlags();
+    clearRefreshFlags();
+    m_rectsCount = 0;
+    if (m_onDraw)
+    {
+        if (!changed) return;
+        uint32_t ts = m_frameStats ? micros() : 0;
+        canvas.setOffset(0, 0);
+        if (m_loadBackground) m_loadBackground();
+        SSD1306_TRACE_BEGIN(SSD1306_TRACE_ENGINE_DRAW);
+        bool ready = m_onDraw();
+        SSD1306_TRACE_END(SSD1306_TRACE_ENGINE_DRAW);
+        canvas.setOffset(0, 0);
+        if (m_frameStats)
+        {
+            m_frameStats->drawUs += micros() - ts;
+            m_frameStats->tiles++;
+        }
+        if (m_heatmap) countHeat(0, 0);
+        if (!ready) return;
+    }
+    uint32_t ts = m_frameStats ? micros() : 0;
+    /* 1-bit canvas is compared by pages, other canvases are compared by rows */
+    const uint8_t  unitRows = C::BITS_PER_PIXEL == 1 ? 8 : 1;
+    const uint32_t unitBytes = C::BITS_PER_PIXEL == 1 ? ssd1306_lcd.width :
+                               (ssd1306_lcd.width * C::BITS_PER_PIXEL + 7) >> 3;
+    const lcduint_t units = (ssd1306_lcd.height + unitRows - 1) / unitRows;
+    lcduint_t first = 0;
+    lcduint_t last = units - 1;
+    if (m_previousValid)
+    {
+        while ((first < units) && !memcmp(&m_screen[first * unitBytes], &m_screenPrevious[first * unitBytes], unitBytes)) first++;
+        if (first >= units) return;
+        while (!memcmp(&m_screen[last * unitBytes], &m_screenPrevious[last * unitBytes], unitBytes)) last--;
+    }
+    /* Full-width band is continuous block in canvas buffer, so it is sent at once */
+    ssd1306_waitVSync();
+    canvas.blt( { {0, (lcdint_t)(first * unitRows)},
+                  {(lcdint_t)(ssd1306_lcd.width - 1), (lcdint_t)((last + 1) * unitRows - 1)} } );
+    memcpy(&m_screenPrevious[first * unitBytes], &m_screen[first * unitBytes], (last - first + 1) * unitBytes);
+    m_previousValid = true;
+    if (m_frameStats) m_frameStats->bltUs += micros() - ts;
+}
+
+#if defined(CONFIG_EXTERNAL_RAM_AVAILABLE)
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::displayScreenStrips()
+{
+    bool changed = hasRefreshFlags();
+    clearRefreshFlags();
+    m_rectsCount = 0;
+    if (m_onDraw && !changed) return;
+    const uint32_t rowBytes = C::BITS_PER_PIXEL == 1 ? ssd1306_lcd.width >> 3 :
+                              (ssd1306_lcd.width * C::BITS_PER_PIXEL + 7) >> 3;
+    bool sent = false;
+    bool complete = true;
+    for (lcduint_t y = 0; y < ssd1306_lcd.height; y += H)
+    {
+        const lcduint_t rows = min((lcduint_t)H, (lcduint_t)(ssd1306_lcd.height - y));
+        const uint32_t pos = rowBytes * y;
+        const uint32_t bytes = rowBytes * rows;
+        /* Strip is read from PSRAM and written back by sequential bursts */
+        memcpy(m_screenStrip, &m_screen[pos], bytes);
+        canvas.setBuffer(m_screenStrip);
+        canvas.setSize(ssd1306_lcd.width, rows);
+        canvas.setOffset(0, y);
+        bool ready = true;
+        if (m_onDraw)
+        {
+            uint32_t ts = m_frameStats ? micros() : 0;
+            if (m_loadBackground) m_loadBackground();
+            SSD1306_TRACE_BEGIN(SSD1306_TRACE_ENGINE_DRAW);
+            ready = m_onDraw();
+            SSD1306_TRACE_END(SSD1306_TRACE_ENGINE_DRAW);
+            canvas.setOffset(0, y);
+            memcpy(&m_screen[pos], m_screenStrip, bytes);
+            if (m_frameStats)
+            {
+                m_frameStats->drawUs += micros() - ts;
+                m_frameStats->tiles++;
+            }
+            if (m_heatmap) countHeat(0, y);
+        }
+        complete = complete && ready;
+        if (!ready || (m_previousValid && !memcmp(m_screenStrip, &m_screenPrevious[pos], bytes))) continue;
+        uint32_t ts = m_frameStats ? micros() : 0;
+        if (!sent) ssd1306_waitVSync();
+        sent = true;
         canvas.blt();
+        memcpy(&m_screenPrevious[pos], m_screenStrip, bytes);
+        if (m_frameStats) m_frameStats->bltUs += micros() - ts;
+    }
+    canvas.setBuffer(m_screen);
+    canvas.setSize(ssd1306_lcd.width, ssd1306_lcd.height);
+    canvas.setOffset(0, 0);
+    /* Previous frame is known only when all strips were sent at least once */
+    m_previousValid = m_previousValid || complete;
+}
+#endif
+#endif
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::addDirtyRect(NanoRect rect)
+{
+    uint8_t i = 0;
+    while (i < m_rectsCount)
+    {
+        if (dirtyRectsWaste(m_rects[i], rect) <= 0)
+        {
+            rect.join(m_rects[i]);
+            m_rects[i] = m_rects[--m_rectsCount];
+            // Grown box can overlap the boxes, checked before
+            i = 0;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    if (m_rectsCount < NE_MAX_DIRTY_RECTS)
+    {
+        m_rects[m_rectsCount++] = rect;
         return;
     }
-    for (lcduint_t y = 0; y < ssd1306_lcd.height; y = y + NE_TILE_HEIGHT)
+    uint8_t best = 0;
+    int32_t bestWaste = dirtyRectsWaste(m_rects[0], rect);
+    for (i = 1; i < m_rectsCount; i++)
     {
-        uint16_t flag = m_refreshFlags[y >> NE_TILE_SIZE_BITS];
-        m_refreshFlags[y >> NE_TILE_SIZE_BITS] = 0;
-        for (lcduint_t x = 0; x < ssd1306_lcd.width; x = x + NE_TILE_WIDTH)
+        int32_t waste = dirtyRectsWaste(m_rects[i], rect);
+        if (waste < bestWaste)
         {
-            if (flag & 0x01)
+            bestWaste = waste;
+            best = i;
+        }
+    }
+    m_rects[best].join(rect);
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::displayRects()
+{
+    /* Number of pixels, tile buffer can hold. 1-bit canvases require height to be *
+     * multiple of 8, since they are sent to lcd by pages. 4-bit canvases require  *
+     * even width and position, since 2 pixels share single byte.                  */
+    const uint32_t pixels = (uint32_t)W * H;
+    const uint8_t  rowAlign = C::BITS_PER_PIXEL == 1 ? 8 : 1;
+    const uint8_t  colAlign = C::BITS_PER_PIXEL == 4 ? 2 : 1;
+    const NanoRect screen = { {0, 0}, {(lcdint_t)(screenWidth() - 1), (lcdint_t)(screenHeight() - 1)} };
+    clearRefreshFlags();
+    for (uint8_t i = 0; i < m_rectsCount; i++)
+    {
+        NanoRect rect = m_rects[i];
+        rect.crop(screen);
+        if ((rect.p2.x < rect.p1.x) || (rect.p2.y < rect.p1.y)) continue;
+        if (rowAlign > 1)
+        {
+            rect.p1.y &= ~(rowAlign - 1);
+            rect.p2.y |= (rowAlign - 1);
+        }
+        if (colAlign > 1)
+        {
+            rect.p1.x &= ~(colAlign - 1);
+            rect.p2.x |= (colAlign - 1);
+        }
+        /* Select view width, giving the least number of views for the box */
+        lcduint_t vw = 0;
+        uint32_t best = 0xFFFFFFFF;
+        for (uint32_t nx = ((uint32_t)rect.width() * rowAlign + pixels - 1) / pixels; nx <= (uint32_t)rect.width(); nx++)
+        {
+            uint32_t w = ((((uint32_t)rect.width() + nx - 1) / nx) + colAlign - 1) & ~(uint32_t)(colAlign - 1);
+            uint32_t rows = (pixels / w) & ~(uint32_t)(rowAlign - 1);
+            if (!rows) continue;
+            uint32_t views = nx * (((uint32_t)rect.height() + rows - 1) / rows);
+            if (views < best)
             {
-                canvas.setOffset(x, y);
-                if (m_onDraw())
+                best = views;
+                vw = w;
+            }
+            // Adding more columns only increases number of views
+            if (rows >= (uint32_t)rect.height()) break;
+        }
+#ifdef CONFIG_MULTIPLICATION_NOT_SUPPORTED
+        if (rowAlign > 1)
+        {
+            /* 1-bit canvas uses shifts instead of multiplication, so width must be *
+             * power of 2, and right views are moved left to stay inside the box.  */
+            vw = 8;
+            while ((vw << 1) <= (lcduint_t)rect.width() && (uint32_t)(vw << 1) * rowAlign <= pixels) vw <<= 1;
+            if (rect.width() < (lcdint_t)vw)
+            {
+                rect.p2.x = min((lcdint_t)(rect.p1.x + vw - 1), screen.p2.x);
+                rect.p1.x = max((lcdint_t)(rect.p2.x - vw + 1), 0);
+            }
+        }
+#endif
+        lcduint_t vh = 0;
+        for (lcdint_t y = rect.p1.y; y <= rect.p2.y; y = y + vh)
+        {
+            vh = min((uint32_t)(rect.p2.y - y + 1), (pixels / vw) & ~(uint32_t)(rowAlign - 1));
+            // Views must not cross the line, where GDRAM wraps due to hardware scrolling
+            lcdint_t wrap = (lcdint_t)(ssd1306_lcd.height - m_scrollLine);
+            if (m_scrollLine && (y < wrap) && (y + (lcdint_t)vh > wrap)) vh = wrap - y;
+            lcduint_t cw = 0;
+            for (lcdint_t x = rect.p1.x; x <= rect.p2.x; x = x + cw)
+            {
+                cw = min((lcdint_t)vw, (lcdint_t)(rect.p2.x - x + 1));
+#ifdef CONFIG_MULTIPLICATION_NOT_SUPPORTED
+                if ((rowAlign > 1) && (cw < vw))
                 {
-                    canvas.setOffset(x, y);
-                    canvas.blt();
+                    x = rect.p2.x - vw + 1;
+                    cw = vw;
                 }
+#endif
+                canvas.setSize(cw, vh);
+                drawTile(x, y);
             }
-            flag >>=1;
         }
     }
+    m_rectsCount = 0;
+    canvas.setSize(W, H);
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::drawTile(lcdint_t x, lcdint_t y)
+{
+    SSD1306_TRACE_SCOPE(SSD1306_TRACE_TILE);
+    if (m_heatmap) countHeat(x, y);
+    if (!m_frameStats)
+    {
+        canvas.setOffset(x, y);
+        if (m_loadBackground) m_loadBackground();
+        SSD1306_TRACE_BEGIN(SSD1306_TRACE_ENGINE_DRAW);
+        bool ready = m_onDraw();
+        SSD1306_TRACE_END(SSD1306_TRACE_ENGINE_DRAW);
+        if (ready)
+        {
+            canvas.setOffset(x, y);
+            bltCanvas();
+        }
+        return;
+    }
+    uint32_t ts = micros();
+    canvas.setOffset(x, y);
+    if (m_loadBackground) m_loadBackground();
+    SSD1306_TRACE_BEGIN(SSD1306_TRACE_ENGINE_DRAW);
+    bool ready = m_onDraw();
+    SSD1306_TRACE_END(SSD1306_TRACE_ENGINE_DRAW);
+    uint32_t drawTs = micros();
+    m_frameStats->drawUs += drawTs - ts;
+    m_frameStats->tiles++;
+    if (ready)
+    {
+        canvas.setOffset(x, y);
+        bltCanvas();
+        m_frameStats->bltUs += micros() - drawTs;
+    }
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::countHeat(lcdint_t x, lcdint_t y)
+{
+    const NanoPoint size = canvas.offsetEnd() - canvas.offset;
+    const lcdint_t x2 = min((lcdint_t)(x + size.x), (lcdint_t)(NE_MAX_TILES_X << B) - 1);
+    const lcdint_t y2 = min((lcdint_t)(y + size.y), (lcdint_t)(NE_MAX_TILES_Y << B) - 1);
+    for (lcdint_t ty = max(y, (lcdint_t)0) >> B; ty <= (y2 >> B); ty++)
+    {
+        for (lcdint_t tx = max(x, (lcdint_t)0) >> B; tx <= (x2 >> B); tx++)
+        {
+            uint8_t &counter = m_heatmap[ty * NE_MAX_TILES_X + tx];
+            if (counter != 0xFF) counter++;
+        }
+    }
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::printHeatmap(void (*func)(uint8_t))
+{
+    if (!m_heatmap) return;
+    const uint8_t cols = min((lcdint_t)(((screenWidth() - 1) >> B) + 1), (lcdint_t)NE_MAX_TILES_X);
+    const uint8_t rows = min((lcdint_t)(((screenHeight() - 1) >> B) + 1), (lcdint_t)NE_MAX_TILES_Y);
+    for (uint8_t ty = 0; ty < rows; ty++)
+    {
+        for (uint8_t tx = 0; tx < cols; tx++)
+        {
+            uint8_t counter = m_heatmap[ty * NE_MAX_TILES_X + tx];
+            func(' ');
+            func(counter >= 100 ? '0' + counter / 100 : ' ');
+            func(counter >= 10 ? '0' + (counter / 10) % 10 : ' ');
+            func('0' + counter % 10);
+        }
+        func('\n');
+    }
+    func('\n');
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::displayBudget()
+{
+    const uint32_t start = millis();
+    const NanoRect priority = m_priority;
+    bool drawn = false;
+    m_priority = { {0, 0}, {-1, -1} };
+    /* First pass draws tiles near recently refreshed areas, second pass draws the rest */
+    for (uint8_t pass = 0; pass < 2; pass++)
+    {
+        if (!pass && (priority.p2.x < priority.p1.x)) continue;
+        for (lcduint_t y = 0; y < screenHeight(); y = y + NE_TILE_HEIGHT)
+        {
+            if (!pass && (((lcdint_t)(y + NE_TILE_HEIGHT - 1) < priority.p1.y) || ((lcdint_t)y > priority.p2.y))) continue;
+            if ((y >> NE_TILE_SIZE_BITS) >= NE_MAX_TILES_Y) break;
+            for (lcduint_t x = 0; x < screenWidth(); x = x + NE_TILE_WIDTH)
+            {
+                if (!pass && (((lcdint_t)(x + NE_TILE_WIDTH - 1) < priority.p1.x) || ((lcdint_t)x > priority.p2.x))) continue;
+                uint8_t tx = x >> NE_TILE_SIZE_BITS;
+                if (tx >= NE_MAX_TILES_X) break;
+                uint8_t &flags = m_refreshFlags[y >> NE_TILE_SIZE_BITS][tx >> 3];
+                if (!(flags & (1 << (tx & 0x07)))) continue;
+                if (drawn && ((uint32_t)(millis() - start) >= m_frameBudgetMs)) return;
+                flags &= ~(1 << (tx & 0x07));
+                drawTile(x, y);
+                drawn = true;
+            }
+        }
+    }
+}
+
+#if NE_RENDER_THREADS > 1
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::renderTiles()
+{
+    for (;;)
+    {
+        uint16_t index = m_workers.next.fetch_add(1);
+        if (index >= m_workers.count) break;
+        const NanoPoint tile = m_workers.tiles[index];
+        uint32_t ts = m_frameStats ? micros() : 0;
+        canvas.setOffset(tile.x, tile.y);
+        if (m_loadBackground) m_loadBackground();
+        bool ready = m_onDraw();
+        uint32_t drawTs = m_frameStats ? micros() : 0;
+        // Tiles are drawn in parallel, but sent to the bus one by one in display order
+        std::unique_lock<std::mutex> guard(m_workers.lock);
+        m_workers.sent.wait(guard, [index]{ return m_workers.blt == index; });
+        if (m_heatmap) countHeat(tile.x, tile.y);
+        if (ready)
+        {
+            canvas.setOffset(tile.x, tile.y);
+            bltCanvas();
+        }
+        if (m_frameStats)
+        {
+            m_frameStats->drawUs += drawTs - ts;
+            m_frameStats->tiles++;
+            if (ready) m_frameStats->bltUs += micros() - drawTs;
+        }
+        m_workers.blt++;
+        guard.unlock();
+        m_workers.sent.notify_all();
+    }
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::renderThread()
+{
+    uint32_t frame = 0;
+    std::unique_lock<std::mutex> guard(m_workers.lock);
+    for (;;)
+    {
+        m_workers.started.wait(guard, [&frame]{ return m_workers.stop || m_workers.frame != frame; });
+        if (m_workers.stop) break;
+        frame = m_workers.frame;
+        guard.unlock();
+        renderTiles();
+        guard.lock();
+        if (!--m_workers.active) m_workers.finished.notify_all();
+    }
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::displayTilesParallel()
+{
+    uint16_t count = 0;
+    forEachRefreshedTile([&count](lcdint_t x, lcdint_t y) { m_workers.tiles[count++] = { x, y }; });
+    if (!count) return;
+    // Background buffer is shared by all threads, so it is drawn before the tiles
+    if (m_loadBackground) m_loadBackground();
+    std::unique_lock<std::mutex> guard(m_workers.lock);
+    if (!m_workers.threads[0])
+    {
+        for (uint8_t i = 0; i < NE_RENDER_THREADS - 1; i++)
+        {
+            m_workers.threads[i] = new std::thread(renderThread);
+        }
+    }
+    m_workers.count = count;
+    m_workers.next = 0;
+    m_workers.blt = 0;
+    m_workers.active = NE_RENDER_THREADS - 1;
+    m_workers.frame++;
+    guard.unlock();
+    m_workers.started.notify_all();
+    // Calling thread works as one of render threads
+    renderTiles();
+    guard.lock();
+    m_workers.finished.wait(guard, []{ return m_workers.active == 0; });
+}
+#endif
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::recordDisplayList()
+{
+    m_displayListReady = false;
+    if (!m_rectsCount && !hasRefreshFlags()) return;
+    uint32_t ts = m_frameStats ? micros() : 0;
+    m_displayList->clear();
+    SSD1306_TRACE_BEGIN(SSD1306_TRACE_ENGINE_DRAW);
+    m_displayListReady = m_onDraw();
+    SSD1306_TRACE_END(SSD1306_TRACE_ENGINE_DRAW);
+    if (m_frameStats) m_frameStats->drawUs += micros() - ts;
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::displayBuffer()
+{
+    selectContext();
+#if defined(CONFIG_LARGE_RAM_AVAILABLE)
+    if (m_screen)
+    {
+        displayScreen();
+        return;
+    }
+#endif
+    if (!m_onDraw)  // If onDraw handler is not set, just output current canvas
+    {
+        if (m_wall) bltWall();
+        else canvas.blt(canvas.offset.x, gdramY(canvas.offset.y));
+        return;
+    }
+    if (m_displayList)
+    {
+        recordDisplayList();
+        /* Tiles are drawn from the display list instead of the scene callback */
+        TNanoEngineOnDraw scene = m_onDraw;
+        m_onDraw = replayDisplayList;
+        displayAreas();
+        m_onDraw = scene;
+        return;
+    }
+    displayAreas();
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::displayAreas()
+{
+    if (m_displayRects)
+    {
+        m_displayRects();
+        return;
+    }
+    if (m_frameBudgetMs)
+    {
+        displayBudget();
+        return;
+    }
+#if NE_RENDER_THREADS > 1
+    displayTilesParallel();
+#else
+    if (m_strip)
+    {
+        displayRuns();
+        return;
+    }
+    forEachRefreshedTile(drawTile);
+#endif
+}
+
+template<class C, lcduint_t W, lcduint_t H, uint8_t B>
+void NanoEngineTiler<C,W,H,B>::displayRuns()
+{
+    for (lcduint_t y = 0; y < screenHeight(); y = y + NE_TILE_HEIGHT)
+    {
+        const uint8_t ty = y >> NE_TILE_SIZE_BITS;
+        if (ty >= NE_MAX_TILES_Y) break;
+        if (!(m_refreshRows[ty >> 3] & (1 << (ty & 0x07)))) continue;
+        uint8_t *flags = m_refreshFlags[ty];
+        lcduint_t x = 0;
+        while (x < screenWidth())
+        {
+            const uint8_t tx = x >> NE_TILE_SIZE_BITS;
+            if (tx >= NE_MAX_TILES_X) break;
+            if (!(flags[tx >> 3] & (1 << (tx & 0x07))))
+            {
+                x = x + NE_TILE_WIDTH;
+                continue;
+            }
+            uint8_t n = 1;
+            while ((n < m_runTiles) && (tx + n < NE_MAX_TILES_X) &&
+                   ((lcduint_t)(x + n * NE_TILE_WIDTH) < screenWidth()) &&
+                   (flags[(tx + n) >> 3] & (1 << ((tx + n) & 0x07))))
+            {
+                n++;
+            }
+#ifdef CONFIG_MULTIPLICATION_NOT_SUPPORTED
+            /* Canvas width must be power of 2 */
+            while (n & (n - 1)) n &= n - 1;
+#endif
+            for (uint8_t i = 0; i < n; i++)
+            {
+                flags[(tx + i) >> 3] &= ~(1 << ((tx + i) & 0x07));
+            }
+            canvas.setSize(n * NE_TILE_WIDTH, NE_TILE_HEIGHT);
+            drawTile(x, y);
+            x = x + n * NE_TILE_WIDTH;
+        }
+    }
+    canvas.setSize(W, H);
 }
 
 template<class C, lcduint_t W, lcduint_t H, uint8_t B>
 void NanoEngineTiler<C,W,H,B>::displayPopup(const char *msg)
 {
-    NanoRect rect = { {8, (ssd1306_lcd.height>>1) - 8}, {ssd1306_lcd.width - 8, (ssd1306_lcd.height>>1) + 8} };
+    selectContext();
+    NanoRect rect = { {8, (screenHeight()>>1) - 8}, {screenWidth() - 8, (screenHeight()>>1) + 8} };
     // TODO: It would be nice to calculate message height
-    NanoPoint textPos = { (ssd1306_lcd.width - (lcdint_t)strlen(msg)*s_fixedFont.h.width) >> 1, (ssd1306_lcd.height>>1) - 4 };
+    NanoPoint textPos = { (screenWidth() - (lcdint_t)strlen(msg)*s_fixedFont.h.width) >> 1, (screenHeight()>>1) - 4 };
     refresh(rect);
-    for (lcduint_t y = 0; y < ssd1306_lcd.height; y = y + NE_TILE_HEIGHT)
+#if defined(CONFIG_LARGE_RAM_AVAILABLE)
+    // Popup is drawn by tiles, full-screen buffer has enough space for any tile
+    if (m_screen) canvas.setSize(W, H);
+#endif
+    for (lcduint_t y = 0; y < screenHeight(); y = y + NE_TILE_HEIGHT)
     {
-        uint16_t flag = m_refreshFlags[y >> NE_TILE_SIZE_BITS];
-        m_refreshFlags[y >> NE_TILE_SIZE_BITS] = 0;
-        for (lcduint_t x = 0; x < ssd1306_lcd.width; x = x + NE_TILE_WIDTH)
+        uint8_t flag = 0;
+        for (lcduint_t x = 0; x < screenWidth(); x = x + NE_TILE_WIDTH)
         {
+            if (!((x >> NE_TILE_SIZE_BITS) & 0x07))
+            {
+                flag = takeRefreshFlags(x >> NE_TILE_SIZE_BITS, y >> NE_TILE_SIZE_BITS);
+            }
             if (flag & 0x01)
             {
                 canvas.setOffset(x, y);
-                if (m_onDraw) m_onDraw();
+                if (m_loadBackground) m_loadBackground();
+                if (m_displayList) replayDisplayList();
+                else if (m_onDraw) m_onDraw();
                 canvas.setOffset(x, y);
                 canvas.setColor(RGB_COLOR8(0,0,0));
                 canvas.fillRect(rect);
@@ -349,11 +2133,19 @@ void NanoEngineTiler<C,W,H,B>::displayPopup(const char *msg)
                 canvas.drawRect(rect);
                 canvas.printFixed( textPos.x, textPos.y, msg);
 
-                canvas.blt();
+                if (m_wall) bltWall();
+                else canvas.blt(x, gdramY(y));
             }
             flag >>=1;
         }
     }
+    m_rectsCount = 0;
+    // Screen content now differs from the frame, kept in frame diff mode
+    m_previousValid = false;
+    invalidateTileHashes();
+#if defined(CONFIG_LARGE_RAM_AVAILABLE)
+    if (m_screen) canvas.setSize(ssd1306_lcd.width, ssd1306_lcd.height);
+#endif
 }
 
 /**
@@ -0,0 +1,529 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file widgets.h Retained-mode widgets for NanoEngine
+ */
+
+#ifndef _NANO_WIDGETS_H_
+#define _NANO_WIDGETS_H_
+
+#include "point.h"
+#include "rect.h"
+#include "ssd1306_hal/io.h"
+#include "ssd1306_generic.h"
+
+/**
+ * @ingroup NANO_ENGINE_API
+ * @{
+ */
+
+/**
+ * This is base template class for widgets, drawn by NanoEngine.
+ * Widgets form a tree without dynamic memory: each widget keeps pointers to its
+ * parent, first child and next sibling. Every widget marks only its own area for
+ * refreshing, when its state is changed, so the engine redraws only tiles, covering
+ * changed widgets. Call drawTree() of root widget from the engine draw callback.
+ * It requires NanoEngine type and NanoEngine instance as arguments.
+ * Widget rectangles are in screen coordinates (engine local coordinates).
+ * Children must be placed inside parent rectangle.
+ */
+template<typename T, T &E>
+class NanoWidget
+{
+public:
+    /**
+     * Creates widget, occupying specified area of screen.
+     * @param rect widget area in screen coordinates
+     */
+    explicit NanoWidget(const NanoRect &rect)
+         : m_rect( rect )
+    {
+    }
+
+    /**
+     * Draws widget content on engine canvas. Base widget draws nothing,
+     * so it can be used as container for other widgets.
+     */
+    virtual void draw() { }
+
+    /**
+     * Draws widget and all its children, if they intersect canvas area, being updated.
+     * Hidden widgets and their children are not drawn.
+     */
+    void drawTree()
+    {
+        if (!m_visible) return;
+        const NanoRect area = E.canvas.rect();
+        if ((m_rect.p2.x < area.p1.x) || (m_rect.p1.x > area.p2.x) ||
+            (m_rect.p2.y < area.p1.y) || (m_rect.p1.y > area.p2.y)) return;
+        draw();
+        for (NanoWidget *child = m_child; child; child = child->m_next)
+        {
+            child->drawTree();
+        }
+    }
+
+    /**
+     * Adds child widget to the end of children list and marks its area for refreshing.
+     * Children are drawn in the order of adding, over the parent.
+     * @param child widget to add. The object must exist until removed from the parent.
+     */
+    void add(NanoWidget &child)
+    {
+        NanoWidget **last = &m_child;
+        while (*last) last = &(*last)->m_next;
+        *last = &child;
+        child.m_parent = this;
+        child.m_next = nullptr;
+        child.refresh();
+    }
+
+    /**
+     * Removes child widget and marks its area for refreshing.
+     * @param child widget to remove
+     */
+    void remove(NanoWidget &child)
+    {
+        for (NanoWidget **p = &m_child; *p; p = &(*p)->m_next)
+        {
+            if (*p == &child)
+            {
+                child.refresh();
+                *p = child.m_next;
+                child.m_parent = nullptr;
+                child.m_next = nullptr;
+                return;
+            }
+        }
+    }
+
+    /**
+     * Marks the whole widget area for refreshing
+     */
+    void refresh()
+    {
+        E.refresh( m_rect );
+    }
+
+    /**
+     * Moves widget to new position, refreshing old and new areas.
+     * Children are not moved.
+     * @param p new top-left corner of the widget in screen coordinates
+     */
+    void moveTo(const NanoPoint &p)
+    {
+        refresh();
+        m_rect = { p, p + (m_rect.p2 - m_rect.p1) };
+        refresh();
+    }
+
+    /**
+     * Shows or hides the widget with its children.
+     * @param visible true to show the widget
+     */
+    void setVisible(bool visible)
+    {
+        if (visible == m_visible) return;
+        m_visible = visible;
+        refresh();
+    }
+
+    /** Returns true if the widget is not hidden */
+    bool isVisible() const { return m_visible; }
+
+    /** Returns widget area in screen coordinates */
+    const NanoRect & rect() const { return m_rect; }
+
+    /** Returns parent widget or nullptr for root and detached widgets */
+    NanoWidget * parent() const { return m_parent; }
+
+protected:
+    /** widget area in screen coordinates */
+    NanoRect    m_rect;
+
+private:
+    NanoWidget *m_parent = nullptr;
+    NanoWidget *m_child = nullptr;
+    NanoWidget *m_next = nullptr;
+    bool        m_visible = true;
+};
+
+/**
+ * Widget, filling its area with background color, and optionally drawing frame.
+ * Usually it is used as root or group widget.
+ */
+template<typename T, T &E>
+class NanoPanel: public NanoWidget<T, E>
+{
+public:
+    /**
+     * Creates panel widget.
+     * @param rect widget area in screen coordinates
+     * @param background background color
+     * @param frame frame color, the same as background for no frame
+     */
+    NanoPanel(const NanoRect &rect, uint16_t background, uint16_t frame)
+         : NanoWidget<T, E>( rect )
+         , m_background( background )
+         , m_frame( frame )
+    {
+    }
+
+    void draw() override
+    {
+        E.canvas.setColor( m_background );
+        E.canvas.fillRect( this->m_rect );
+        if (m_frame != m_background)
+        {
+            E.canvas.setColor( m_frame );
+            E.canvas.drawRect( this->m_rect );
+        }
+    }
+
+private:
+    uint16_t m_background;
+    uint16_t m_frame;
+};
+
+/**
+ * Widget, printing single line of text with active font.
+ */
+template<typename T, T &E>
+class NanoLabel: public NanoWidget<T, E>
+{
+public:
+    /**
+     * Creates label widget.
+     * @param rect widget area in screen coordinates, text is clipped by the engine
+     *        only to refreshed areas, so the rect must cover the longest text
+     * @param text null-terminated string. The string must exist until replaced.
+     * @param color text color
+     */
+    NanoLabel(const NanoRect &rect, const char *text, uint16_t color)
+         : NanoWidget<T, E>( rect )
+         , m_text( text )
+         , m_color( color )
+    {
+    }
+
+    void draw() override
+    {
+        E.canvas.setColor( m_color );
+        E.canvas.printFixed( this->m_rect.p1.x, this->m_rect.p1.y, m_text );
+    }
+
+    /**
+     * Sets new text and marks label area for refreshing. Call it also, if content
+     * of the string is changed.
+     * @param text null-terminated string. The string must exist until replaced.
+     */
+    void setText(const char *text)
+    {
+        m_text = text;
+        this->refresh();
+    }
+
+private:
+    const char *m_text;
+    uint16_t    m_color;
+};
+
+/**
+ * Widget, printing multi-line text with word wrap. Line breaks are computed once
+ * for the text and active font (see ssd1306_layoutText()), redraws of single tiles
+ * and scrolling reuse cached layout. Text is clipped by widget area.
+ * N is maximum number of text lines, the widget can keep.
+ */
+template<typename T, T &E, uint8_t N>
+class NanoTextBox: public NanoWidget<T, E>
+{
+public:
+    /**
+     * Creates text box widget.
+     * @param rect widget area in screen coordinates
+     * @param text null-terminated utf8 string. The string must exist until replaced.
+     * @param color text color
+     */
+    NanoTextBox(const NanoRect &rect, const char *text, uint16_t color)
+         : NanoWidget<T, E>( rect )
+         , m_text( text )
+         , m_color( color )
+    {
+        m_layout.text = nullptr;
+        m_layout.lines = m_lines;
+        m_layout.maxLines = N;
+        m_layout.count = 0;
+    }
+
+    void draw() override
+    {
+        updateLayout();
+        E.canvas.setColor( m_color );
+        if ( E.canvas.pushClipRect( this->m_rect ) )
+        {
+            E.canvas.printLayout( this->m_rect.p1.x, this->m_rect.p1.y, m_layout, m_firstLine );
+            E.canvas.popClipRect();
+        }
+    }
+
+    /**
+     * Sets new text, scrolls to the first line and marks widget area for refreshing.
+     * Call it also, if content of the string is changed.
+     * @param text null-terminated utf8 string. The string must exist until replaced.
+     */
+    void setText(const char *text)
+    {
+        m_text = text;
+        m_layout.text = nullptr;
+        m_firstLine = 0;
+        this->refresh();
+    }
+
+    /**
+     * Sets line of the text, displayed at the top of the widget.
+     * @param line index of the line
+     */
+    void scrollTo(uint8_t line)
+    {
+        if (line == m_firstLine) return;
+        m_firstLine = line;
+        this->refresh();
+    }
+
+    /** Returns index of the line, displayed at the top of the widget */
+    uint8_t firstLine() const { return m_firstLine; }
+
+    /** Returns number of text lines, computing the layout if needed */
+    uint8_t lineCount()
+    {
+        updateLayout();
+        return m_layout.count;
+    }
+
+private:
+    const char *m_text;
+    uint16_t    m_color;
+    uint8_t     m_firstLine = 0;
+    STextLine   m_lines[N];
+    STextLayout m_layout;
+
+    void updateLayout()
+    {
+        if ( !ssd1306_isTextLayoutValid( &m_layout, m_text ) )
+        {
+            ssd1306_layoutText( &m_layout, m_text, this->m_rect.width() );
+        }
+    }
+};
+
+/**
+ * Widget, drawing monochrome bitmap (in flash memory) in specified color.
+ */
+template<typename T, T &E>
+class NanoIcon: public NanoWidget<T, E>
+{
+public:
+    /**
+     * Creates icon widget.
+     * @param pos position of the icon in screen coordinates
+     * @param size size of the bitmap
+     * @param bitmap icon content in ssd1306 monochrome format (in flash memory)
+     * @param color icon color
+     */
+    NanoIcon(const NanoPoint &pos, const NanoPoint &size, const uint8_t *bitmap, uint16_t color)
+         : NanoWidget<T, E>( { pos, pos + size - NanoPoint{1, 1} } )
+         , m_bitmap( bitmap )
+         , m_color( color )
+    {
+    }
+
+    void draw() override
+    {
+        E.canvas.setColor( m_color );
+        E.canvas.drawBitmap1( this->m_rect.p1.x, this->m_rect.p1.y,
+                              this->m_rect.width(), this->m_rect.height(), m_bitmap );
+    }
+
+    /**
+     * Sets new icon bitmap of the same size and marks icon area for refreshing.
+     * @param bitmap icon content (in flash memory)
+     */
+    void setBitmap(const uint8_t *bitmap)
+    {
+        if (bitmap == m_bitmap) return;
+        m_bitmap = bitmap;
+        this->refresh();
+    }
+
+private:
+    const uint8_t *m_bitmap;
+    uint16_t       m_color;
+};
+
+/**
+ * Horizontal progress bar widget. When value is changed, only columns
+ * between old and new fill boundaries are marked for refreshing.
+ */
+template<typename T, T &E>
+class NanoProgressBar: public NanoWidget<T, E>
+{
+public:
+    /**
+     * Creates progress bar widget.
+     * @param rect widget area in screen coordinates, including 1-pixel frame
+     * @param color frame and bar color
+     * @param maxValue value, corresponding to completely filled bar
+     */
+    NanoProgressBar(const NanoRect &rect, uint16_t color, uint16_t maxValue)
+         : NanoWidget<T, E>( rect )
+         , m_color( color )
+         , m_max( maxValue ? maxValue : 1 )
+    {
+    }
+
+    void draw() override
+    {
+        E.canvas.setColor( m_color );
+        E.canvas.drawRect( this->m_rect );
+        lcdint_t x = fillX( m_value );
+        if (x > this->m_rect.p1.x + 1)
+        {
+            E.canvas.fillRect( this->m_rect.p1.x + 1, this->m_rect.p1.y + 1,
+                               x - 1, this->m_rect.p2.y - 1 );
+        }
+    }
+
+    /**
+     * Sets new value and marks changed part of the bar for refreshing.
+     * @param value new value, values above maxValue fill the whole bar
+     */
+    void setValue(uint16_t value)
+    {
+        if (value > m_max) value = m_max;
+        lcdint_t x1 = fillX( m_value );
+        lcdint_t x2 = fillX( value );
+        m_value = value;
+        if (x1 == x2) return;
+        if (x1 > x2)
+        {
+            lcdint_t t = x1; x1 = x2; x2 = t;
+        }
+        E.refresh( x1, this->m_rect.p1.y + 1, x2 - 1, this->m_rect.p2.y - 1 );
+    }
+
+    /** Returns current value */
+    uint16_t value() const { return m_value; }
+
+private:
+    uint16_t m_color;
+    uint16_t m_max;
+    uint16_t m_value = 0;
+
+    /** Returns the first column after filled part of the bar */
+    lcdint_t fillX(uint16_t value) const
+    {
+        lcdint_t inner = this->m_rect.width() - 2;
+        return this->m_rect.p1.x + 1 + (lcdint_t)((uint32_t)inner * value / m_max);
+    }
+};
+
+/**
+ * List widget, showing strings one below another with highlighted selection.
+ * When selection is changed, only old and new selected items are marked for refreshing.
+ */
+template<typename T, T &E>
+class NanoListBox: public NanoWidget<T, E>
+{
+public:
+    /**
+     * Creates list widget. Height of items is equal to height of active font.
+     * @param rect widget area in screen coordinates
+     * @param items array of null-terminated strings, must exist until widget is no longer needed
+     * @param count number of items
+     * @param color text and selection color
+     */
+    NanoListBox(const NanoRect &rect, const char **items, uint8_t count, uint16_t color)
+         : NanoWidget<T, E>( rect )
+         , m_items( items )
+         , m_count( count )
+         , m_color( color )
+    {
+    }
+
+    void draw() override
+    {
+        const NanoRect area = E.canvas.rect();
+        uint8_t mode = E.canvas.getMode();
+        for (uint8_t i = 0; i < m_count; i++)
+        {
+            NanoRect r = itemRect( i );
+            if (r.p1.y > this->m_rect.p2.y) break;
+            if ((r.p2.y < area.p1.y) || (r.p1.y > area.p2.y)) continue;
+            E.canvas.setColor( m_color );
+            if (i == m_selection)
+            {
+                /* Selected item is printed with background color over filled bar */
+                E.canvas.fillRect( r );
+                E.canvas.setColor( 0 );
+                E.canvas.setMode( mode | CANVAS_MODE_TRANSPARENT );
+            }
+            E.canvas.printFixed( r.p1.x, r.p1.y, m_items[i] );
+            E.canvas.setMode( mode );
+        }
+    }
+
+    /**
+     * Selects item and marks old and new selected items for refreshing.
+     * @param index index of item to select
+     */
+    void setSelection(uint8_t index)
+    {
+        if ((index == m_selection) || (index >= m_count)) return;
+        E.refresh( itemRect( m_selection ) );
+        m_selection = index;
+        E.refresh( itemRect( index ) );
+    }
+
+    /** Returns index of selected item */
+    uint8_t selection() const { return m_selection; }
+
+private:
+    const char **m_items;
+    uint8_t      m_count;
+    uint16_t     m_color;
+    uint8_t      m_selection = 0;
+
+    NanoRect itemRect(uint8_t index) const
+    {
+        lcdint_t y = this->m_rect.p1.y + (lcdint_t)index * s_fixedFont.h.height;
+        return { { this->m_rect.p1.x, y },
+                 { this->m_rect.p2.x, (lcdint_t)(y + s_fixedFont.h.height - 1) } };
+    }
+};
+
+/**
+ * @}
+ */
+
+#endif
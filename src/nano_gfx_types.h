@@ -46,6 +46,9 @@
 /** Macro to generate 16-bit color for SSD1351 OLED display */
 #define RGB_COLOR16(r,g,b)   ( ((r<<8) & 0xF800) | ((g << 3)&0x07E0) | (b>>3) )
 
+/** Macro to generate 4-bit grayscale color for SSD1325 OLED display from 0-255 brightness */
+#define GRAY_COLOR4(gray)    ( ((gray) >> 4) & 0x0F )
+
 /** Macro to convert 3-3-2 color to 5-6-5 color */
 #define RGB8_TO_RGB16(c)     ( (((uint16_t)c & 0b11100000) << 8) | \
                                (((uint16_t)c & 0b00011100) << 6) | \
@@ -117,6 +120,42 @@ typedef struct
     const uint8_t *glyph; ///< char data, located in progmem.
 } SCharInfo;
 
+/**
+ * Describes single line of text layout
+ */
+typedef struct
+{
+    /// offset of the first byte of the line in the string
+    uint16_t offset;
+    /// number of string bytes, printed on the line
+    uint8_t length;
+    /// width of the line in pixels, not including spacing after the last char
+    lcduint_t width;
+} STextLine;
+
+/**
+ * Describes text, broken to lines for the text area of specified width.
+ * The layout is computed once by ssd1306_layoutText(), and redrawn, partially redrawn
+ * or scrolled line by line without measuring glyphs and searching for line breaks again.
+ */
+typedef struct
+{
+    /// string, the layout is computed for
+    const char *text;
+    /// primary table of the font, the layout is computed with
+    const uint8_t *font;
+    /// array of lines, provided by the user
+    STextLine *lines;
+    /// number of elements in lines array
+    uint8_t maxLines;
+    /// number of lines in the layout
+    uint8_t count;
+    /// height of single line in pixels
+    uint8_t lineHeight;
+    /// width of text area in pixels, the layout is computed for
+    lcduint_t width;
+} STextLayout;
+
 /**
  * Rectangle region. not used now
  */
@@ -0,0 +1,195 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "sprite_layer.h"
+#include "ssd1306.h"
+
+#include <string.h>
+
+SpriteLayer::SpriteLayer( )
+   : m_canvasBuf{0}
+   , m_sprites{0}
+   , m_count( 0 )
+   , m_dirty{0}
+{
+    setRect( (SSD1306_RECT){ 0, 0,
+                             (uint8_t)((ssd1306_displayWidth() >> 3) - 1),
+                             (uint8_t)((ssd1306_displayHeight() >> 3) - 1) } );
+}
+
+void SpriteLayer::setRect(SSD1306_RECT rect)
+{
+    m_rect = rect;
+    m_rect.right = min(m_rect.right, (uint8_t)(MAX_BLOCK_COLUMNS - 1));
+    m_rect.bottom = min(m_rect.bottom, (uint8_t)(MAX_BLOCK_ROWS - 1));
+}
+
+void SpriteLayer::drawBackground(NanoCanvas &canvas, uint8_t x, uint8_t row)
+{
+}
+
+void SpriteLayer::markDirty(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+    /* Coordinates wrap around 256 as in SPRITE, so sprite at x=252 touches column 0 */
+    for (uint16_t py = y & ~0x07; py <= (uint16_t)(y + h - 1); py += 8)
+    {
+        uint8_t row = (uint8_t)py >> 3;
+        if ( row >= MAX_BLOCK_ROWS )
+        {
+            continue;
+        }
+        for (uint16_t px = x & ~0x07; px <= (uint16_t)(x + w - 1); px += 8)
+        {
+            uint8_t column = (uint8_t)px >> 3;
+            if ( column < MAX_BLOCK_COLUMNS )
+            {
+                m_dirty[row] |= (1U << column);
+            }
+        }
+    }
+}
+
+void SpriteLayer::invalidate(SSD1306_RECT rect)
+{
+    markDirty( rect.left, rect.top, rect.right - rect.left + 1, rect.bottom - rect.top + 1 );
+}
+
+void SpriteLayer::drawRun(uint8_t column, uint8_t row, uint8_t blocks)
+{
+    NanoCanvas canvas( blocks << 3, 8, m_canvasBuf );
+    uint8_t x = column << 3;
+    uint8_t y = row << 3;
+    drawBackground( canvas, x, row );
+    for (uint8_t i = 0; i < m_count; i++)
+    {
+        /* Skip sprites, which are not in this block row */
+        if ( (uint8_t)(m_y[i] - y + 7) >= 15 )
+        {
+            continue;
+        }
+        canvas.drawBitmap( m_x[i] - x, m_y[i] - y, m_w[i], 8, m_data[i] );
+    }
+    canvas.blt( x, row );
+}
+
+void SpriteLayer::drawSprites()
+{
+    for (uint8_t i = 0; i < m_count; i++)
+    {
+        SPRITE * sprite = m_sprites[i];
+        if ( sprite->x != m_x[i] || sprite->y != m_y[i] ||
+             sprite->w != m_w[i] || sprite->data != m_data[i] )
+        {
+            markDirty( m_x[i], m_y[i], m_w[i], 8 );
+            m_x[i] = sprite->x;
+            m_y[i] = sprite->y;
+            m_w[i] = sprite->w;
+            m_data[i] = sprite->data;
+            markDirty( m_x[i], m_y[i], m_w[i], 8 );
+        }
+        sprite->lx = sprite->x;
+        sprite->ly = sprite->y;
+    }
+    for (uint8_t row = m_rect.top; row <= m_rect.bottom; row++)
+    {
+        uint16_t mask = m_dirty[row];
+        m_dirty[row] = 0;
+        uint8_t column = m_rect.left;
+        while ( column <= m_rect.right )
+        {
+            if ( !(mask & (1U << column)) )
+            {
+                column++;
+                continue;
+            }
+            uint8_t blocks = 1;
+            while ( (blocks < CANVAS_BLOCKS) && (column + blocks <= m_rect.right) &&
+                    (mask & (1U << (column + blocks))) )
+            {
+                blocks++;
+            }
+            drawRun( column, row, blocks );
+            column += blocks;
+        }
+    }
+}
+
+void SpriteLayer::refreshScreen()
+{
+    for (uint8_t row = m_rect.top; row <= m_rect.bottom; row++)
+    {
+        for (uint8_t column = m_rect.left; column <= m_rect.right; column++)
+        {
+            m_dirty[row] |= (1U << column);
+        }
+    }
+    drawSprites();
+}
+
+uint8_t SpriteLayer::add( SPRITE &sprite )
+{
+    uint8_t index = m_count;
+    if (index >= MAX_SPRITES)
+    {
+        return SpriteLayer::SP_ERR_NO_SPACE;
+    }
+    m_sprites[index] = &sprite;
+    m_x[index] = sprite.x;
+    m_y[index] = sprite.y;
+    m_w[index] = sprite.w;
+    m_data[index] = sprite.data;
+    markDirty( sprite.x, sprite.y, sprite.w, 8 );
+    m_count++;
+    return index;
+}
+
+void SpriteLayer::clear()
+{
+    for (uint8_t i = 0; i < m_count; i++)
+    {
+        markDirty( m_x[i], m_y[i], m_w[i], 8 );
+    }
+    m_count = 0;
+}
+
+void SpriteLayer::remove( SPRITE &sprite )
+{
+    for (uint8_t i=0; i<m_count; i++)
+    {
+        if (m_sprites[i] == &sprite)
+        {
+            markDirty( m_x[i], m_y[i], m_w[i], 8 );
+            m_count--;
+            for (uint8_t j=i; j<m_count; j++)
+            {
+                m_sprites[j] = m_sprites[j+1];
+                m_x[j] = m_x[j+1];
+                m_y[j] = m_y[j+1];
+                m_w[j] = m_w[j+1];
+                m_data[j] = m_data[j+1];
+            }
+            break;
+        }
+    }
+}
@@ -0,0 +1,160 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file sprite_layer.h Dirty-block based sprite layer for SPRITE objects
+ */
+
+
+#ifndef _SPRITE_LAYER_H_
+#define _SPRITE_LAYER_H_
+
+#include "nano_gfx.h"
+
+/**
+ * SpriteLayer is drop-in replacement for SpritePool, working with the same
+ * SPRITE objects. Unlike SpritePool it remembers geometry and bitmap of each
+ * sprite as it was drawn last time, so sprites, which are not moved or
+ * changed, cost nothing. Areas of changed sprites are merged into single
+ * map of dirty 8x8 blocks, and each dirty block is drawn only once per frame,
+ * even if several sprites cover it. Horizontal runs of dirty blocks are composed
+ * in one shared canvas and sent to the display with single blt() call.
+ */
+class SpriteLayer
+{
+public:
+    /// No free space for new sprite error
+    static const uint8_t SP_ERR_NO_SPACE = 0xFF;
+
+#if defined(ESP32) || defined(ESP8266)
+    /// Defines max sprites number supported by SpriteLayer
+    static const uint8_t MAX_SPRITES = 32;
+#else
+    /// Defines max sprites number supported by SpriteLayer
+    static const uint8_t MAX_SPRITES = 10;
+#endif
+
+    /// Max number of block rows (pixels / 8), tracked by SpriteLayer
+    static const uint8_t MAX_BLOCK_ROWS = 8;
+
+    /// Max number of block columns (pixels / 8), tracked by SpriteLayer
+    static const uint8_t MAX_BLOCK_COLUMNS = 16;
+
+    /// Width of shared canvas in blocks, longer runs are sent in several parts
+    static const uint8_t CANVAS_BLOCKS = 4;
+
+    /**
+     * Creates empty SpriteLayer object, covering whole display.
+     */
+    SpriteLayer( );
+
+    /**
+     * Draws all areas, touched by the sprites since last call.
+     * Sprites, which position, width and bitmap are not changed, are not redrawn.
+     */
+    void drawSprites();
+
+    /**
+     * Redraws whole area, used by the sprites.
+     */
+    void refreshScreen();
+
+    /**
+     * Marks area as requiring redraw on next drawSprites() call.
+     * Use it when background under the sprites is changed.
+     * @param rect - area in pixels
+     */
+    void invalidate(SSD1306_RECT rect);
+
+    /**
+     * Adds SPRITE object to the internal list of SpriteLayer
+     * @param sprite - reference to SPRITE object
+     * @return index of added object or SP_ERR_NO_SPACE in case of error.
+     */
+    uint8_t add( SPRITE &sprite );
+
+    /**
+     * Removes all SPRITE objects from internal list of SpriteLayer.
+     * Areas, used by the sprites, are redrawn on next drawSprites() call.
+     */
+    void clear();
+
+    /**
+     * Removes specific SPRITE object from the SpriteLayer.
+     * Area, used by the sprite, is redrawn on next drawSprites() call.
+     */
+    void remove( SPRITE &sprite );
+
+    /**
+     * Sets active paint area region in blocks (pixels / 8)
+     * @param rect - region in blocks (pixels / 8)
+     */
+    void setRect(SSD1306_RECT rect);
+
+protected:
+    /// Rectangle, which specifies part of the display, used by the sprites
+    SSD1306_RECT  m_rect;
+
+    /**
+     * This method is called every time the run of 8-pixel high blocks is needed
+     * to be drawn. Draw background to the canvas, starting at 0,0 position in it.
+     * Default implementation leaves canvas clear.
+     *
+     * @param canvas - canvas, representing blocks to update
+     * @param x      - horizontal position of the canvas on the display in pixels
+     * @param row    - row of the blocks to redraw
+     */
+    virtual void drawBackground(NanoCanvas &canvas, uint8_t x, uint8_t row);
+
+private:
+    /// Internal buffer for shared canvas
+    uint8_t m_canvasBuf[CANVAS_BLOCKS * 8];
+
+    /// Sprites container
+    SPRITE *m_sprites[MAX_SPRITES];
+
+    /// position X of each sprite, when it was drawn last time
+    uint8_t m_x[MAX_SPRITES];
+
+    /// position Y of each sprite, when it was drawn last time
+    uint8_t m_y[MAX_SPRITES];
+
+    /// width of each sprite, when it was drawn last time
+    uint8_t m_w[MAX_SPRITES];
+
+    /// bitmap of each sprite, when it was drawn last time
+    const uint8_t *m_data[MAX_SPRITES];
+
+    /// Count of registered sprites
+    uint8_t m_count;
+
+    /// Dirty blocks: one bit per block column for each block row
+    uint16_t m_dirty[MAX_BLOCK_ROWS];
+
+    void markDirty(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+
+    void drawRun(uint8_t column, uint8_t row, uint8_t blocks);
+};
+
+#endif
+
@@ -31,9 +31,13 @@
 #include "nano_gfx_types.h"
 #include "ssd1306_generic.h"
 #include "ssd1306_1bit.h"
+#include "ssd1306_4bit.h"
 #include "ssd1306_8bit.h"
 #include "ssd1306_16bit.h"
 #include "ssd1306_fonts.h"
+#include "ssd1306_assets.h"
+#include "ssd1306_stream.h"
+#include "ssd1306_trace.h"
 
 #include "lcd/lcd_common.h"
 #include "lcd/oled_ssd1306.h"
@@ -47,6 +51,7 @@
 #include "lcd/composite_video.h"
 
 #include "lcd/oled_template.h"
+#include "ssd1306_context.h"
 
 #ifdef __cplusplus
 extern "C" {
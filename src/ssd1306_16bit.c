@@ -45,6 +45,29 @@ void    ssd1306_setRgbColor16(uint8_t r, uint8_t g, uint8_t b)
 static void ssd1306_drawBufferPitch16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch, const uint8_t *data)
 {
     ssd1306_lcd.set_block(x, y, w);
+    if (ssd1306_lcd.send_pixels_buffer16)
+    {
+        if (pitch == (w << 1))
+        {
+            /* Continuous block is sent at once, large frames in 64K-pixel chunks */
+            uint32_t count = (uint32_t)w * h;
+            while (count)
+            {
+                uint16_t len = count > 0xFFFF ? 0xFFFF : count;
+                ssd1306_lcd.send_pixels_buffer16( data, len );
+                data += (uint32_t)len << 1;
+                count -= len;
+            }
+            h = 0;
+        }
+        while (h--)
+        {
+            ssd1306_lcd.send_pixels_buffer16( data, w );
+            data += pitch;
+        }
+        ssd1306_intf.stop();
+        return;
+    }
     while (h--)
     {
         lcduint_t line = w << 1;
@@ -58,16 +81,73 @@ static void ssd1306_drawBufferPitch16(lcdint_t x, lcdint_t y, lcduint_t w, lcdui
     ssd1306_intf.stop();
 }
 
+static void ssd1306_fillPixelsEx16(uint16_t color, uint32_t count)
+{
+    if (ssd1306_lcd.fill_pixels16)
+    {
+        ssd1306_lcd.fill_pixels16( color, count );
+        return;
+    }
+    while (count--)
+    {
+        ssd1306_lcd.send_pixels16( color );
+    }
+}
+
 void ssd1306_drawBufferFast16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *data)
 {
     ssd1306_drawBufferPitch16(x, y, w, h, w<<1, data);
 }
 
-void ssd1306_drawBufferEx16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch, const uint8_t *data)
+void SSD1306_IRAM ssd1306_drawBufferEx16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch, const uint8_t *data)
 {
     ssd1306_drawBufferPitch16( x, y, w, h, pitch, data );
 }
 
+void ssd1306_fillBlock16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, uint16_t color)
+{
+    ssd1306_lcd.set_block(x, y, w);
+    ssd1306_fillPixelsEx16( color, (uint32_t)w * h );
+    ssd1306_intf.stop();
+}
+
+void ssd1306_drawIndexedBuffer16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch,
+                                 uint8_t bits, const uint16_t *palette, const uint8_t *data)
+{
+    /* Pixels are expanded via palette to small stack buffer, sent by a single bulk call */
+    uint8_t line[64];
+    ssd1306_lcd.set_block(x, y, w);
+    while (h--)
+    {
+        const uint8_t *src = data;
+        lcduint_t col = 0;
+        while (col < w)
+        {
+            uint8_t count = 0;
+            while ((col < w) && (count < sizeof(line)/2))
+            {
+                uint8_t index = (bits == 4) ? ((col & 1) ? (src[col >> 1] >> 4) : (src[col >> 1] & 0x0F))
+                                            : src[col];
+                uint16_t color = palette[index];
+                if (!ssd1306_lcd.send_pixels_buffer16)
+                {
+                    ssd1306_lcd.send_pixels16( color );
+                }
+                line[count*2] = color >> 8;
+                line[count*2 + 1] = color & 0xFF;
+                count++;
+                col++;
+            }
+            if (ssd1306_lcd.send_pixels_buffer16)
+            {
+                ssd1306_lcd.send_pixels_buffer16( line, count );
+            }
+        }
+        data += pitch;
+    }
+    ssd1306_intf.stop();
+}
+
 // IMPORTANT: ALL 16-BIT OLED DISPLAYS ALSO SUPPORT 8-BIT DIRECT DRAW FUNCTIONS
 //            REFER TO ssd1306_8bit.c
 
@@ -105,11 +185,7 @@ void ssd1306_drawMonoBuffer16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint
 void ssd1306_fillScreen16(uint16_t fill_Data)
 {
     ssd1306_lcd.set_block(0, 0, 0);
-    uint32_t count = (uint32_t)ssd1306_lcd.width * (uint32_t)ssd1306_lcd.height;
-    while (count--)
-    {
-        ssd1306_lcd.send_pixels16( fill_Data );
-    }
+    ssd1306_fillPixelsEx16( fill_Data, (uint32_t)ssd1306_lcd.width * (uint32_t)ssd1306_lcd.height );
     ssd1306_intf.stop();
 }
 
@@ -156,6 +232,10 @@ void ssd1306_drawHLine16(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 
 void ssd1306_drawLine16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    if (ssd1306_lcd.draw_line && ssd1306_lcd.draw_line( x1, y1, x2, y2, ssd1306_color ))
+    {
+        return;
+    }
     lcduint_t  dx = x1 > x2 ? (x1 - x2): (x2 - x1);
     lcduint_t  dy = y1 > y2 ? (y1 - y2): (y2 - y1);
     lcduint_t  err = 0;
@@ -199,6 +279,10 @@ void ssd1306_drawLine16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 
 void ssd1306_drawRect16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    if (ssd1306_lcd.draw_rect && ssd1306_lcd.draw_rect( x1, y1, x2, y2, ssd1306_color ))
+    {
+        return;
+    }
     ssd1306_drawHLine16(x1,y1,x2);
     ssd1306_drawHLine16(x1,y2,x2);
     ssd1306_drawVLine16(x1,y1,y2);
@@ -216,11 +300,7 @@ void ssd1306_fillRect16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
         ssd1306_swap_data(x1, x2, lcdint_t);
     }
     ssd1306_lcd.set_block(x1, y1, x2 - x1 + 1);
-    uint16_t count = (x2 - x1 + 1) * (y2 - y1 + 1);
-    while (count--)
-    {
-        ssd1306_lcd.send_pixels16( ssd1306_color );
-    }
+    ssd1306_fillPixelsEx16( ssd1306_color, (uint32_t)(x2 - x1 + 1) * (uint32_t)(y2 - y1 + 1) );
     ssd1306_intf.stop();
 }
 
@@ -255,46 +335,212 @@ void ssd1306_drawMonoBitmap16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint
     ssd1306_intf.stop();
 }
 
+void ssd1306_drawMonoBitmapScaled16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h,
+                                    const uint8_t *bitmap, uint8_t scale)
+{
+    uint16_t blackColor = s_ssd1306_invertByte ? ssd1306_color : 0x00;
+    uint16_t color = s_ssd1306_invertByte ? 0x00 : ssd1306_color;
+    ssd1306_lcd.set_block(xpos, ypos, w * scale);
+    for (lcduint_t j = 0; j < h; j++)
+    {
+        const uint8_t *row = &bitmap[(j >> 3) * w];
+        uint8_t bit = 1 << (j & 0x07);
+        for (uint8_t n = scale; n > 0; n--)
+        {
+            /* Runs of the same pixels are sent as single fill */
+            lcduint_t start = 0;
+            uint8_t value = pgm_read_byte( &row[0] ) & bit;
+            for (lcduint_t i = 1; i <= w; i++)
+            {
+                uint8_t set = (i < w) ? (pgm_read_byte( &row[i] ) & bit) : !value;
+                if (set != value)
+                {
+                    ssd1306_fillPixelsEx16( value ? color : blackColor, (uint32_t)(i - start) * scale );
+                    start = i;
+                    value = set;
+                }
+            }
+        }
+    }
+    ssd1306_intf.stop();
+}
+
+void ssd1306_drawBitmap8Scaled16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h,
+                                 const uint8_t *bitmap, uint8_t scale)
+{
+    /* Replicated pixels are collected to small stack buffer, sent by a single bulk call */
+    uint8_t line[64];
+    ssd1306_lcd.set_block(xpos, ypos, w * scale);
+    while (h--)
+    {
+        for (uint8_t n = scale; n > 0; n--)
+        {
+            uint8_t count = 0;
+            for (lcduint_t i = 0; i < w; i++)
+            {
+                uint8_t data = pgm_read_byte( &bitmap[i] );
+                uint16_t color = RGB8_TO_RGB16( data );
+                if (!ssd1306_lcd.send_pixels_buffer16)
+                {
+                    ssd1306_fillPixelsEx16( color, scale );
+                    continue;
+                }
+                for (uint8_t z = scale; z > 0; z--)
+                {
+                    line[count*2] = color >> 8;
+                    line[count*2 + 1] = color & 0xFF;
+                    if (++count == sizeof(line)/2)
+                    {
+                        ssd1306_lcd.send_pixels_buffer16( line, count );
+                        count = 0;
+                    }
+                }
+            }
+            if (count)
+            {
+                ssd1306_lcd.send_pixels_buffer16( line, count );
+            }
+        }
+        bitmap += w;
+    }
+    ssd1306_intf.stop();
+}
+
 void ssd1306_drawBitmap16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
     ssd1306_lcd.set_block(xpos, ypos, w);
-    uint32_t count = (w) * (h);
-    while (count--)
+    uint32_t count = (uint32_t)w * h;
+    if (ssd1306_lcd.send_pixels_buffer16)
     {
-        ssd1306_lcd.send_pixels16( (pgm_read_byte( &bitmap[0] ) << 8) | pgm_read_byte( &bitmap[1] ) );
-        bitmap += 2;
+        ssd1306_sendProgmemPixels(ssd1306_lcd.send_pixels_buffer16, bitmap, count, 2);
+    }
+    else
+    {
+        while (count--)
+        {
+            ssd1306_lcd.send_pixels16( (pgm_read_byte( &bitmap[0] ) << 8) | pgm_read_byte( &bitmap[1] ) );
+            bitmap += 2;
+        }
     }
     ssd1306_intf.stop();
 }
 
-void ssd1306_clearBlock16(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+void ssd1306_drawCompressedBitmap16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
-    ssd1306_lcd.set_block(x, y, w);
-    uint32_t count = w * h;
-    while (count--)
+    ssd1306_lcd.set_block(xpos, ypos, w);
+    uint32_t left = (uint32_t)w * h;
+    while (left)
     {
-        ssd1306_lcd.send_pixels16( 0x0000 );
+        /* Bit 7 of header means repeated color, the rest is number of pixels - 1 */
+        uint8_t header = pgm_read_byte( bitmap++ );
+        uint8_t count = (header & 0x7F) + 1;
+        if (count > left) count = left;
+        left -= count;
+        if (header & 0x80)
+        {
+            ssd1306_fillPixelsEx16( (pgm_read_byte( &bitmap[0] ) << 8) | pgm_read_byte( &bitmap[1] ), count );
+            bitmap += 2;
+            continue;
+        }
+        while (count--)
+        {
+            ssd1306_lcd.send_pixels16( (pgm_read_byte( &bitmap[0] ) << 8) | pgm_read_byte( &bitmap[1] ) );
+            bitmap += 2;
+        }
     }
     ssd1306_intf.stop();
 }
 
+static const uint8_t *s_bootSplash16;
+static lcduint_t s_bootSplashW16;
+static lcduint_t s_bootSplashH16;
+
+static void ssd1306_clearBootSplashBlock16(lcduint_t x, lcduint_t y, lcduint_t w, lcduint_t h)
+{
+    if (!w || !h)
+    {
+        return;
+    }
+    ssd1306_lcd.set_block(x, y, w);
+    ssd1306_fillPixelsEx16( 0x0000, (uint32_t)w * h );
+    ssd1306_intf.stop();
+}
+
+static void ssd1306_drawBootSplash16(void)
+{
+    lcduint_t x = (ssd1306_lcd.width - s_bootSplashW16) >> 1;
+    lcduint_t y = (ssd1306_lcd.height - s_bootSplashH16) >> 1;
+    lcduint_t right = x + s_bootSplashW16;
+    lcduint_t bottom = y + s_bootSplashH16;
+    /* Margins are cleared here, so every GDRAM pixel is written exactly once */
+    ssd1306_clearBootSplashBlock16(0, 0, ssd1306_lcd.width, y);
+    ssd1306_clearBootSplashBlock16(0, y, x, s_bootSplashH16);
+    ssd1306_drawCompressedBitmap16(x, y, s_bootSplashW16, s_bootSplashH16, s_bootSplash16);
+    ssd1306_clearBootSplashBlock16(right, y, ssd1306_lcd.width - right, s_bootSplashH16);
+    ssd1306_clearBootSplashBlock16(0, bottom, ssd1306_lcd.width, ssd1306_lcd.height - bottom);
+}
+
+void ssd1306_setBootSplash16(lcduint_t w, lcduint_t h, const uint8_t *bitmap)
+{
+    s_bootSplash16 = bitmap;
+    s_bootSplashW16 = w;
+    s_bootSplashH16 = h;
+    ssd1306_setDisplayOnHook(ssd1306_drawBootSplash16);
+}
+
+void ssd1306_clearBlock16(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+    ssd1306_lcd.set_block(x, y, w);
+    ssd1306_fillPixelsEx16( 0x0000, (uint32_t)w * h );
+    ssd1306_intf.stop();
+}
+
 void ssd1306_setCursor16(lcduint_t x, lcduint_t y)
 {
     ssd1306_cursorX = x;
     ssd1306_cursorY = y;
 }
 
+/*
+ * Draws glyph of active font. Glyphs of rows fonts are sent as is, row by row.
+ * Pixels of anti-aliased fonts are taken from color ramp between background and color.
+ */
+static void ssd1306_drawGlyph16(lcdint_t x, lcdint_t y, const SCharInfo *info)
+{
+    if (!ssd1306_isRowsFont())
+    {
+        ssd1306_drawMonoBitmap16(x, y, info->width, info->height, info->glyph);
+        return;
+    }
+    uint16_t blackColor = s_ssd1306_invertByte ? ssd1306_color : 0x00;
+    uint16_t color = s_ssd1306_invertByte ? 0x00 : ssd1306_color;
+    SGlyphReader reader;
+    ssd1306_glyphReaderInit(&reader, info);
+    ssd1306_lcd.set_block(x, y, info->width);
+    uint16_t count = (uint16_t)info->width * info->height;
+    if ( ssd1306_isAlphaFont() )
+    {
+        uint16_t ramp[16];
+        ssd1306_alphaRamp16(ramp, blackColor, color);
+        for (; count > 0; count--)
+        {
+            ssd1306_lcd.send_pixels16( ramp[ssd1306_glyphReadAlpha(&reader)] );
+        }
+    }
+    for (; count > 0; count--)
+    {
+        ssd1306_lcd.send_pixels16( ssd1306_glyphReadPixel(&reader) ? color : blackColor );
+    }
+    ssd1306_intf.stop();
+}
+
 void ssd1306_printChar16(uint8_t c)
 {
     uint16_t unicode = ssd1306_unicode16FromUtf8(c);
     if (unicode == SSD1306_MORE_CHARS_REQUIRED) return;
     SCharInfo char_info;
     ssd1306_getCharBitmap(unicode, &char_info);
-    ssd1306_drawMonoBitmap16(ssd1306_cursorX,
-                ssd1306_cursorY,
-                char_info.width,
-                char_info.height,
-                char_info.glyph );
+    ssd1306_drawGlyph16(ssd1306_cursorX, ssd1306_cursorY, &char_info);
 }
 
 size_t ssd1306_write16(uint8_t ch)
@@ -322,11 +568,7 @@ size_t ssd1306_write16(uint8_t ch)
     if (unicode == SSD1306_MORE_CHARS_REQUIRED) return 0;
     SCharInfo char_info;
     ssd1306_getCharBitmap(unicode, &char_info);
-    ssd1306_drawMonoBitmap16( ssd1306_cursorX,
-                              ssd1306_cursorY,
-                              char_info.width,
-                              char_info.height,
-                              char_info.glyph);
+    ssd1306_drawGlyph16(ssd1306_cursorX, ssd1306_cursorY, &char_info);
     ssd1306_cursorX += char_info.width + char_info.spacing;
     return 1;
 }
@@ -342,11 +584,165 @@ size_t ssd1306_print16(const char ch[])
     return n;
 }
 
+void ssd1306_drawTextRun16(lcdint_t x, lcdint_t y, const STextRun *run)
+{
+    uint16_t blackColor = s_ssd1306_invertByte ? ssd1306_color : 0x00;
+    uint16_t color = s_ssd1306_invertByte ? 0x00 : ssd1306_color;
+    uint8_t rows = ssd1306_isRowsFont();
+    uint8_t alpha = ssd1306_isAlphaFont();
+    SGlyphReader readers[SSD1306_TEXT_RUN_SIZE];
+    uint16_t ramp[16];
+    for (uint8_t i = 0; rows && (i < run->count); i++)
+    {
+        ssd1306_glyphReaderInit(&readers[i], &run->chars[i]);
+    }
+    if ( alpha )
+    {
+        ssd1306_alphaRamp16(ramp, blackColor, color);
+    }
+    ssd1306_lcd.set_block(x, y, run->width);
+    for (uint8_t row = 0; row < run->height; row++)
+    {
+        uint8_t bit = 1 << (row & 0x07);
+        for (uint8_t i = 0; i < run->count; i++)
+        {
+            const SCharInfo *info = &run->chars[i];
+            if ( alpha )
+            {
+                for (uint8_t wx = info->width; wx > 0; wx--)
+                {
+                    ssd1306_lcd.send_pixels16( row < info->height ? ramp[ssd1306_glyphReadAlpha( &readers[i] )]
+                                                                 : blackColor );
+                }
+            }
+            else if ( rows )
+            {
+                for (uint8_t wx = info->width; wx > 0; wx--)
+                {
+                    if ( (row < info->height) && ssd1306_glyphReadPixel( &readers[i] ) )
+                        ssd1306_lcd.send_pixels16( color );
+                    else
+                        ssd1306_lcd.send_pixels16( blackColor );
+                }
+            }
+            else
+            {
+                const uint8_t *glyph = &info->glyph[(row >> 3) * info->width];
+                for (uint8_t wx = info->width; wx > 0; wx--)
+                {
+                    if ( (row < info->height) && (pgm_read_byte( glyph ) & bit) )
+                        ssd1306_lcd.send_pixels16( color );
+                    else
+                        ssd1306_lcd.send_pixels16( blackColor );
+                    glyph++;
+                }
+            }
+            if (i + 1 < run->count)
+            {
+                for (uint8_t wx = info->spacing; wx > 0; wx--)
+                {
+                    ssd1306_lcd.send_pixels16( blackColor );
+                }
+            }
+        }
+    }
+    ssd1306_intf.stop();
+}
+
 uint8_t ssd1306_printFixed16(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style)
 {
+    uint8_t count = 0;
+    ssd1306_cursorX = x;
+    ssd1306_cursorY = y;
+    while (*ch)
+    {
+        if ( (*ch == '\r') || (*ch == '\n') )
+        {
+            ssd1306_write16(*ch);
+            ch++;
+            continue;
+        }
+        if ( ssd1306_cursorX > ssd1306_lcd.width - s_fixedFont.h.width )
+        {
+            ssd1306_write16('\n');
+        }
+        STextRun run;
+        ch += ssd1306_getTextRun(&run, ch, ssd1306_cursorX, ssd1306_lcd.width);
+        ssd1306_drawTextRun16(ssd1306_cursorX, ssd1306_cursorY, &run);
+        ssd1306_cursorX += run.width + run.spacing;
+        count += run.count;
+    }
+    return count;
+}
+
+/*
+ * Draws glyph, scaled 2^factor times. Each glyph row is sent 2^factor times, each
+ * glyph pixel is repeated 2^factor times, so no pixels are read back from display.
+ */
+static void ssd1306_drawGlyphN16(lcdint_t x, lcdint_t y, const SCharInfo *info, uint8_t factor)
+{
+    uint16_t blackColor = s_ssd1306_invertByte ? ssd1306_color : 0x00;
+    uint16_t color = s_ssd1306_invertByte ? 0x00 : ssd1306_color;
+    uint8_t rows = ssd1306_isRowsFont();
+    uint8_t scale = 1 << factor;
+    SGlyphReader reader;
+    ssd1306_glyphReaderInit(&reader, info);
+    ssd1306_lcd.set_block(x, y, (info->width + info->spacing) << factor);
+    for (uint8_t row = 0; row < info->height; row++)
+    {
+        SGlyphReader rowStart = reader;
+        const uint8_t *glyph = &info->glyph[(row >> 3) * info->width];
+        uint8_t bit = 1 << (row & 0x07);
+        for (uint8_t n = scale; n > 0; n--)
+        {
+            reader = rowStart;
+            for (uint8_t wx = 0; wx < info->width; wx++)
+            {
+                uint8_t set = rows ? ssd1306_glyphReadPixel(&reader) : (pgm_read_byte(&glyph[wx]) & bit);
+                for (uint8_t z = scale; z > 0; z--)
+                {
+                    ssd1306_lcd.send_pixels16( set ? color : blackColor );
+                }
+            }
+            for (uint8_t wx = info->spacing << factor; wx > 0; wx--)
+            {
+                ssd1306_lcd.send_pixels16( blackColor );
+            }
+        }
+    }
+    ssd1306_intf.stop();
+}
+
+uint8_t ssd1306_printFixedN16(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style, uint8_t factor)
+{
+    uint8_t count = 0;
     ssd1306_cursorX = x;
     ssd1306_cursorY = y;
-    return ssd1306_print16(ch);
+    for (; *ch; ch++)
+    {
+        if ( *ch == '\r' )
+        {
+            ssd1306_cursorX = x;
+            continue;
+        }
+        if ( (*ch == '\n') || (ssd1306_cursorX > ssd1306_lcd.width - (s_fixedFont.h.width << factor)) )
+        {
+            ssd1306_cursorX = x;
+            ssd1306_cursorY += s_fixedFont.h.height << factor;
+            if ( *ch == '\n' )
+            {
+                continue;
+            }
+        }
+        uint16_t unicode = ssd1306_unicode16FromUtf8(*ch);
+        if (unicode == SSD1306_MORE_CHARS_REQUIRED) continue;
+        SCharInfo char_info;
+        ssd1306_getCharBitmap(unicode, &char_info);
+        ssd1306_drawGlyphN16(ssd1306_cursorX, ssd1306_cursorY, &char_info, factor);
+        ssd1306_cursorX += (char_info.width + char_info.spacing) << factor;
+        count++;
+    }
+    return count;
 }
 
 
@@ -29,6 +29,7 @@
 #define _SSD1306_16BIT_H_
 
 #include "nano_gfx_types.h"
+#include "ssd1306_generic.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -96,6 +97,36 @@ static inline void ssd1331_drawBufferFast16(lcdint_t x, lcdint_t y, lcduint_t w,
  */
 void ssd1306_drawBufferEx16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch, const uint8_t *data);
 
+/**
+ * Fills w x h block with the color, using fill primitive of the display driver
+ * (hardware fill on SSD1331), so no pixel data is sent for the block.
+ *
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in pixels
+ * @param w - width of block in pixels
+ * @param h - height of block in pixels
+ * @param color - 16-bit color of the block
+ */
+void ssd1306_fillBlock16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, uint16_t color);
+
+/**
+ * Draws 4-bit or 8-bit indexed bitmap, located in SRAM, on the display.
+ * Each pixel is an index in the palette of RGB16 colors, refer to RGB_COLOR16.
+ * In 4-bit mode 2 horizontal pixels share single byte, low nibble is the left pixel.
+ * Pixels are expanded line by line and sent via ssd1306_lcd.send_pixels_buffer16().
+ *
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in pixels
+ * @param w - width of bitmap in pixels
+ * @param h - height of bitmap in pixels
+ * @param pitch length of bitmap buffer line in bytes
+ * @param bits bits per pixel: 4 or 8
+ * @param palette pointer to 16 (4-bit) or 256 (8-bit) RGB16 colors, located in SRAM.
+ * @param data - pointer to data, located in SRAM. For 4-bit mode data should start at even pixel.
+ */
+void ssd1306_drawIndexedBuffer16(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch,
+                                 uint8_t bits, const uint16_t *palette, const uint8_t *data);
+
 /**
  * Draws 1-bit bitmap, located in SRAM, on the display
  * Each bit represents separate pixel: refer to ssd1306 datasheet for more information.
@@ -217,6 +248,40 @@ void ssd1306_fillRect16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
  */
 void ssd1306_drawMonoBitmap16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
 
+/**
+ * Draw monochrome bitmap, located in Flash, directly to OLED display GDRAM, scaled
+ * by integer factor (nearest neighbor). Each run of same pixels in the bitmap row is
+ * sent as single fill of the display, and each row is repeated scale times, so
+ * scaled bitmap is streamed without intermediate buffer.
+ * The bitmap should be in ssd1306 format (each byte represents 8 vertical pixels)
+ *
+ * @param xpos start horizontal position in pixels
+ * @param ypos start vertical position in pixels
+ * @param w bitmap width in pixels (not scaled)
+ * @param h bitmap height in pixels (not scaled)
+ * @param bitmap pointer to Flash data, containing monochrome bitmap.
+ * @param scale scale factor, usually 2, 3 or 4
+ *
+ * @note set color with ssd1306_setColor() function.
+ */
+void ssd1306_drawMonoBitmapScaled16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h,
+                                    const uint8_t *bitmap, uint8_t scale);
+
+/**
+ * Draw 8-bit color bitmap, located in Flash, directly to OLED display GDRAM, scaled
+ * by integer factor (nearest neighbor). Pixels are converted to 5-6-5 format, replicated
+ * to small stack buffer and sent by bulk calls, each row is repeated scale times.
+ *
+ * @param xpos start horizontal position in pixels
+ * @param ypos start vertical position in pixels
+ * @param w bitmap width in pixels (not scaled)
+ * @param h bitmap height in pixels (not scaled)
+ * @param bitmap pointer to Flash data, containing 8-bit (RGB 3-3-2) color bitmap.
+ * @param scale scale factor, usually 2, 3 or 4
+ */
+void ssd1306_drawBitmap8Scaled16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h,
+                                 const uint8_t *bitmap, uint8_t scale);
+
 /**
  * Draw 16-bit color bitmap, located in Flash, directly to OLED display GDRAM.
  * Each pixel of the bitmap is expected in 5-6-5 format.
@@ -229,6 +294,33 @@ void ssd1306_drawMonoBitmap16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint
  */
 void ssd1306_drawBitmap16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
 
+/**
+ * Draw compressed 16-bit color bitmap, located in Flash, directly to OLED display GDRAM.
+ * The bitmap should be compressed by `tools/bitmapcompress.py -16`. Runs of the same
+ * color are sent via fast fill operation of the display if it is supported.
+ *
+ * @param xpos start horizontal position in pixels
+ * @param ypos start vertical position in pixels
+ * @param w bitmap width in pixels
+ * @param h bitmap height in pixels
+ * @param bitmap pointer to Flash data, containing compressed 16-bit color bitmap.
+ */
+void ssd1306_drawCompressedBitmap16(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap);
+
+/**
+ * Sets compressed 16-bit color bitmap, located in Flash, to show as boot splash.
+ * Must be called before display init function (for example, ili9341_240x320_spi_init()).
+ * The bitmap is streamed to GDRAM centered, with the margins filled with black color,
+ * right after init sequence while the panel is still off, and display-on command
+ * is sent only when the frame is complete.
+ * The bitmap should be compressed by `tools/bitmapcompress.py -16`.
+ *
+ * @param w bitmap width in pixels
+ * @param h bitmap height in pixels
+ * @param bitmap pointer to Flash data, containing compressed 16-bit color bitmap.
+ */
+void ssd1306_setBootSplash16(lcduint_t w, lcduint_t h, const uint8_t *bitmap);
+
 /**
  * Clears block, filling it with black pixels, directly in OLED display GDRAM.
  *
@@ -289,9 +381,38 @@ size_t ssd1306_print16(const char ch[]);
  *
  * @see ssd1306_setFixedFont
  * @note set color with ssd1306_setColor() function.
+ * @note Chars of the line are sent to display in one block, so spacing between chars
+ *       is filled with background color.
  */
 uint8_t ssd1306_printFixed16(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style);
 
+/**
+ * @brief Draws run of chars, collected by ssd1306_getTextRun(), in one block.
+ *
+ * Sends all chars of the run in one block, row by row. Spacing between chars is filled
+ * with background color.
+ * @param x horizontal position in pixels
+ * @param y vertical position in pixels
+ * @param run run of chars to draw
+ * @note set color with ssd1306_setColor() function.
+ */
+void ssd1306_drawTextRun16(lcdint_t x, lcdint_t y, const STextRun *run);
+
+/**
+ * Prints text to screen using fixed font, scaled 2^factor times.
+ * @param x horizontal position in pixels
+ * @param y vertical position in pixels
+ * @param ch NULL-terminated string to print
+ * @param style font style (EFontStyle), normal by default (not implemented).
+ * @param factor scaling factor: FONT_SIZE_NORMAL, FONT_SIZE_2X, FONT_SIZE_4X, FONT_SIZE_8X
+ * @returns number of chars in string
+ *
+ * @see ssd1306_setFixedFont
+ * @note set color with ssd1306_setColor() function.
+ * @note Text wraps to x position, when it doesn't fit display width.
+ */
+uint8_t ssd1306_printFixedN16(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style, uint8_t factor);
+
 /**
  * @}
  */
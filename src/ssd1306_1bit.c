@@ -46,6 +46,16 @@ extern SFixedFontInfo s_fixedFont;
 extern uint8_t g_ssd1306_unicode;
 #endif
 
+/* Each bit of nibble is doubled: used to scale glyphs 2 times */
+static const uint8_t s_spread2x[16] PROGMEM =
+{
+    0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+    0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF,
+};
+
+/* Each bit of 2-bit value is repeated 4 times: used to scale glyphs 4 times */
+static const uint8_t s_spread4x[4] PROGMEM = { 0x00, 0x0F, 0xF0, 0xFF };
+
 void ssd1306_fillScreen(uint8_t fill_Data)
 {
     fill_Data ^= s_ssd1306_invertByte;
@@ -54,7 +64,7 @@ void ssd1306_fillScreen(uint8_t fill_Data)
     {
         for(uint8_t n=ssd1306_lcd.width; n>0; n--)
         {
-            ssd1306_lcd.send_pixels1(fill_Data);
+            ssd1306_lcdSendPixels1(fill_Data);
         }
         ssd1306_lcd.next_page();
     }
@@ -68,7 +78,7 @@ void ssd1306_clearScreen()
     {
         for(uint8_t n=ssd1306_lcd.width; n>0; n--)
         {
-            ssd1306_lcd.send_pixels1( s_ssd1306_invertByte );
+            ssd1306_lcdSendPixels1( s_ssd1306_invertByte );
         }
         ssd1306_lcd.next_page();
     }
@@ -111,12 +121,9 @@ uint8_t ssd1306_printFixed(uint8_t xpos, uint8_t y, const char *ch, EFontStyle s
             ssd1306_intf.stop();
             ssd1306_lcd.set_block(xpos, y, ssd1306_lcd.width - xpos);
         }
-        uint16_t unicode;
-        do
-        {
-            unicode = ssd1306_unicode16FromUtf8(ch[j]);
-            j++;
-        } while ( unicode == SSD1306_MORE_CHARS_REQUIRED );
+        uint8_t len;
+        uint16_t unicode = ssd1306_unicode16FromUtf8Str(&ch[j], &len);
+        j += len;
         SCharInfo char_info;
         ssd1306_getCharBitmap(unicode, &char_info);
         ldata = 0;
@@ -124,27 +131,30 @@ uint8_t ssd1306_printFixed(uint8_t xpos, uint8_t y, const char *ch, EFontStyle s
         if (char_info.height > page_offset * 8)
         {
             char_info.glyph += page_offset * char_info.width;
-            for( i = char_info.width; i>0; i--)
+            if ( style == STYLE_NORMAL )
             {
-                uint8_t data;
-                if ( style == STYLE_NORMAL )
-                {
-                    data = pgm_read_byte(&char_info.glyph[0]);
-                }
-                else if ( style == STYLE_BOLD )
-                {
-                    uint8_t temp = pgm_read_byte(&char_info.glyph[0]);
-                    data = temp | ldata;
-                    ldata = temp;
-                }
-                else
+                ssd1306_sendProgmemPixels1(char_info.glyph, char_info.width, s_ssd1306_invertByte);
+            }
+            else
+            {
+                for( i = char_info.width; i>0; i--)
                 {
-                    uint8_t temp = pgm_read_byte(&char_info.glyph[1]);
-                    data = (temp & 0xF0) | ldata;
-                    ldata = (temp & 0x0F);
+                    uint8_t data;
+                    if ( style == STYLE_BOLD )
+                    {
+                        uint8_t temp = pgm_read_byte(&char_info.glyph[0]);
+                        data = temp | ldata;
+                        ldata = temp;
+                    }
+                    else
+                    {
+                        uint8_t temp = pgm_read_byte(&char_info.glyph[1]);
+                        data = (temp & 0xF0) | ldata;
+                        ldata = (temp & 0x0F);
+                    }
+                    ssd1306_lcdSendPixels1(data^s_ssd1306_invertByte);
+                    char_info.glyph++;
                 }
-                ssd1306_lcd.send_pixels1(data^s_ssd1306_invertByte);
-                char_info.glyph++;
             }
         }
         else
@@ -152,12 +162,48 @@ uint8_t ssd1306_printFixed(uint8_t xpos, uint8_t y, const char *ch, EFontStyle s
             char_info.spacing += char_info.width;
         }
         for (i = 0; i < char_info.spacing; i++)
-            ssd1306_lcd.send_pixels1(s_ssd1306_invertByte);
+            ssd1306_lcdSendPixels1(s_ssd1306_invertByte);
     }
     ssd1306_intf.stop();
     return j;
 }
 
+void ssd1306_drawTextRun(lcdint_t x, lcdint_t y, const STextRun *run)
+{
+    lcduint_t w = run->width;
+    if ( w > ssd1306_lcd.width - x )
+    {
+        w = ssd1306_lcd.width - x;
+    }
+    ssd1306_lcd.set_block(x, y >> 3, w);
+    for (uint8_t page = 0; page < ((run->height + 7) >> 3); page++)
+    {
+        lcduint_t left = w;
+        for (uint8_t i = 0; (i < run->count) && left; i++)
+        {
+            const SCharInfo *info = &run->chars[i];
+            uint8_t len = min(info->width, left);
+            if ( info->height > (page << 3) )
+            {
+                ssd1306_sendProgmemPixels1(&info->glyph[page * info->width], len, s_ssd1306_invertByte);
+            }
+            else
+            {
+                for (uint8_t n = len; n > 0; n--) ssd1306_lcdSendPixels1(s_ssd1306_invertByte);
+            }
+            left -= len;
+            if (i + 1 < run->count)
+            {
+                len = min(info->spacing, left);
+                for (uint8_t n = len; n > 0; n--) ssd1306_lcdSendPixels1(s_ssd1306_invertByte);
+                left -= len;
+            }
+        }
+        ssd1306_lcd.next_page();
+    }
+    ssd1306_intf.stop();
+}
+
 uint8_t ssd1306_printFixed_oldStyle(uint8_t xpos, uint8_t y, const char *ch, EFontStyle style)
 {
     uint8_t i, j=0;
@@ -222,7 +268,7 @@ uint8_t ssd1306_printFixed_oldStyle(uint8_t xpos, uint8_t y, const char *ch, EFo
                 data = (temp & 0xF0) | ldata;
                 ldata = (temp & 0x0F);
             }
-            ssd1306_lcd.send_pixels1(data^s_ssd1306_invertByte);
+            ssd1306_lcdSendPixels1(data^s_ssd1306_invertByte);
             offset++;
         }
         x += s_fixedFont.h.width;
@@ -297,12 +343,9 @@ uint8_t ssd1306_printFixed2x(uint8_t xpos, uint8_t y, const char ch[], EFontStyl
                 ldata = (temp & 0x0F);
             }
             if (page_offset & 1) data >>= 4;
-            data = ((data & 0x01) ? 0x03: 0x00) |
-                   ((data & 0x02) ? 0x0C: 0x00) |
-                   ((data & 0x04) ? 0x30: 0x00) |
-                   ((data & 0x08) ? 0xC0: 0x00);
-            ssd1306_lcd.send_pixels1(data^s_ssd1306_invertByte);
-            ssd1306_lcd.send_pixels1(data^s_ssd1306_invertByte);
+            data = pgm_read_byte(&s_spread2x[data & 0x0F]);
+            ssd1306_lcdSendPixels1(data^s_ssd1306_invertByte);
+            ssd1306_lcdSendPixels1(data^s_ssd1306_invertByte);
             offset++;
         }
         x += (s_fixedFont.h.width << 1);
@@ -349,12 +392,9 @@ uint8_t ssd1306_printFixedN(uint8_t xpos, uint8_t y, const char ch[], EFontStyle
             ssd1306_intf.stop();
             ssd1306_lcd.set_block(xpos, y, ssd1306_lcd.width - xpos);
         }
-        uint16_t unicode;
-        do
-        {
-            unicode = ssd1306_unicode16FromUtf8(ch[j]);
-            j++;
-        } while ( unicode == SSD1306_MORE_CHARS_REQUIRED );
+        uint8_t len;
+        uint16_t unicode = ssd1306_unicode16FromUtf8Str(&ch[j], &len);
+        j += len;
         SCharInfo char_info;
         ssd1306_getCharBitmap(unicode, &char_info);
         ldata = 0;
@@ -381,24 +421,25 @@ uint8_t ssd1306_printFixedN(uint8_t xpos, uint8_t y, const char ch[], EFontStyle
                     data = (temp & 0xF0) | ldata;
                     ldata = (temp & 0x0F);
                 }
-                if ( factor > 0 )
+                // Output page takes 8 >> factor bits of glyph byte:
+                // N=1  ->   right shift goes through 0, 4
+                // N=2  ->   right shift goes through 0, 2, 4, 6
+                // N=3  ->   right shift goes through 0, 1, 2, 3, 4, 5, 6, 7
+                if ( factor == 1 )
                 {
-                    uint8_t accum = 0;
-                    uint8_t mask = ~((0xFF) << (1<<factor));
-                    // N=0  ->   right shift is always 0
-                    // N=1  ->   right shift goes through 0, 4
-                    // N=2  ->   right shift goes through 0, 2, 4, 6
-                    // N=3  ->   right shift goes through 0, 1, 2, 3, 4, 5, 6, 7
-                    data >>= ((page_offset & ((1<<factor) - 1))<<(3-factor));
-                    for (uint8_t idx = 0; idx < 1<<(3-factor); idx++)
-                    {
-                         accum |= (((data>>idx) & 0x01) ? (mask<<(idx<<factor)) : 0);
-                    }
-                    data = accum;
+                    data = pgm_read_byte(&s_spread2x[(data >> ((page_offset & 0x01) << 2)) & 0x0F]);
+                }
+                else if ( factor == 2 )
+                {
+                    data = pgm_read_byte(&s_spread4x[(data >> ((page_offset & 0x03) << 1)) & 0x03]);
+                }
+                else if ( factor == 3 )
+                {
+                    data = ((data >> (page_offset & 0x07)) & 0x01) ? 0xFF : 0x00;
                 }
                 for (uint8_t z=(1<<factor); z>0; z--)
                 {
-                    ssd1306_lcd.send_pixels1(data^s_ssd1306_invertByte);
+                    ssd1306_lcdSendPixels1(data^s_ssd1306_invertByte);
                 }
                 char_info.glyph++;
             }
@@ -408,7 +449,7 @@ uint8_t ssd1306_printFixedN(uint8_t xpos, uint8_t y, const char ch[], EFontStyle
             char_info.spacing += char_info.width;
         }
         for (i = 0; i < (char_info.spacing << factor); i++)
-            ssd1306_lcd.send_pixels1(s_ssd1306_invertByte);
+            ssd1306_lcdSendPixels1(s_ssd1306_invertByte);
     }
     ssd1306_intf.stop();
     return j;
@@ -496,7 +537,7 @@ uint8_t ssd1306_charF6x8(uint8_t x, uint8_t y, const char ch[], EFontStyle style
                 data = (temp & 0xF0) | ldata;
                 ldata = (temp & 0x0F);
             }
-            ssd1306_lcd.send_pixels1(data^s_ssd1306_invertByte);
+            ssd1306_lcdSendPixels1(data^s_ssd1306_invertByte);
         }
         x += 6;
         j++;
@@ -570,8 +611,8 @@ uint8_t ssd1306_charF12x16(uint8_t xpos, uint8_t y, const char ch[], EFontStyle
                    ((data & 0x02) ? 0x0C: 0x00) |
                    ((data & 0x04) ? 0x30: 0x00) |
                    ((data & 0x08) ? 0xC0: 0x00);
-            ssd1306_lcd.send_pixels1(data^s_ssd1306_invertByte);
-            ssd1306_lcd.send_pixels1(data^s_ssd1306_invertByte);
+            ssd1306_lcdSendPixels1(data^s_ssd1306_invertByte);
+            ssd1306_lcdSendPixels1(data^s_ssd1306_invertByte);
         }
         x += 12;
         j++;
@@ -598,14 +639,14 @@ uint8_t      ssd1306_charF6x8_eol(uint8_t left,
 void         ssd1306_putPixel(uint8_t x, uint8_t y)
 {
     ssd1306_lcd.set_block(x, y >> 3, 1);
-    ssd1306_lcd.send_pixels1((1 << (y & 0x07))^s_ssd1306_invertByte);
+    ssd1306_lcdSendPixels1((1 << (y & 0x07))^s_ssd1306_invertByte);
     ssd1306_intf.stop();
 }
 
 void         ssd1306_putPixels(uint8_t x, uint8_t y, uint8_t pixels)
 {
     ssd1306_lcd.set_block(x, y >> 3, 1);
-    ssd1306_lcd.send_pixels1(pixels^s_ssd1306_invertByte);
+    ssd1306_lcdSendPixels1(pixels^s_ssd1306_invertByte);
     ssd1306_intf.stop();
 }
 
@@ -631,6 +672,18 @@ void         ssd1306_putPixel_delayed(uint8_t x, uint8_t y, uint8_t complete)
 
 void         ssd1306_drawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
 {
+    if (y1 == y2)
+    {
+        if (x1 > x2) ssd1306_swap_data(x1, x2, uint8_t);
+        ssd1306_drawHLine(x1, y1, x2);
+        return;
+    }
+    if (x1 == x2)
+    {
+        if (y1 > y2) ssd1306_swap_data(y1, y2, uint8_t);
+        ssd1306_drawVLine(x1, y1, y2);
+        return;
+    }
     lcduint_t  dx = x1 > x2 ? (x1 - x2): (x2 - x1);
     lcduint_t  dy = y1 > y2 ? (y1 - y2): (y2 - y1);
     lcduint_t  err = 0;
@@ -660,6 +713,8 @@ void         ssd1306_drawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
             ssd1306_swap_data(x1, x2, uint8_t);
             ssd1306_swap_data(y1, y2, uint8_t);
         }
+        /* Sequential columns of the same page are sent as single block */
+        uint8_t page = 0xFF;
         for(; x1<=x2; x1++)
         {
             err += dy;
@@ -668,8 +723,15 @@ void         ssd1306_drawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
                  err -= dx;
                  if (y1 < y2) y1++; else y1--;
             }
-            ssd1306_putPixel( x1, y1 );
+            if ((y1 >> 3) != page)
+            {
+                if (page != 0xFF) ssd1306_intf.stop();
+                page = y1 >> 3;
+                ssd1306_lcd.set_block(x1, page, x2 - x1 + 1);
+            }
+            ssd1306_lcdSendPixels1((1 << (y1 & 0x07))^s_ssd1306_invertByte);
         }
+        ssd1306_intf.stop();
     }
 }
 
@@ -678,7 +740,7 @@ void         ssd1306_drawHLine(uint8_t x1, uint8_t y1, uint8_t x2)
     ssd1306_lcd.set_block(x1, y1 >> 3, x2 - x1 + 1);
     for (uint8_t x = x1; x <= x2; x++)
     {
-        ssd1306_lcd.send_pixels1((1 << (y1 & 0x07))^s_ssd1306_invertByte);
+        ssd1306_lcdSendPixels1((1 << (y1 & 0x07))^s_ssd1306_invertByte);
     }
     ssd1306_intf.stop();
 }
@@ -692,18 +754,18 @@ void         ssd1306_drawVLine(uint8_t x1, uint8_t y1, uint8_t y2)
     ssd1306_lcd.set_block(x1, topPage, 1);
     if (topPage == bottomPage)
     {
-        ssd1306_lcd.send_pixels1( ((0xFF >> (0x07 - height)) << (y1 & 0x07))^s_ssd1306_invertByte );
+        ssd1306_lcdSendPixels1( ((0xFF >> (0x07 - height)) << (y1 & 0x07))^s_ssd1306_invertByte );
         ssd1306_intf.stop();
         return;
     }
-    ssd1306_lcd.send_pixels1( (0xFF << (y1 & 0x07))^s_ssd1306_invertByte );
+    ssd1306_lcdSendPixels1( (0xFF << (y1 & 0x07))^s_ssd1306_invertByte );
     for ( y = (topPage + 1); y <= (bottomPage - 1); y++)
     {
         ssd1306_lcd.next_page();
-        ssd1306_lcd.send_pixels1( 0xFF^s_ssd1306_invertByte );
+        ssd1306_lcdSendPixels1( 0xFF^s_ssd1306_invertByte );
     }
     ssd1306_lcd.next_page();
-    ssd1306_lcd.send_pixels1( (0xFF >> (0x07 - (y2 & 0x07)))^s_ssd1306_invertByte );
+    ssd1306_lcdSendPixels1( (0xFF >> (0x07 - (y2 & 0x07)))^s_ssd1306_invertByte );
     ssd1306_intf.stop();
 }
 
@@ -715,20 +777,61 @@ void         ssd1306_drawRect(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
     ssd1306_drawVLine(x2, y1, y2);
 }
 
-void ssd1306_drawBufferFast(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buf)
+void SSD1306_IRAM ssd1306_drawBufferFast(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buf)
 {
     uint8_t j;
     ssd1306_lcd.set_block(x, y >> 3, w);
     for(j=(h >> 3); j>0; j--)
     {
-        ssd1306_lcd.send_pixels_buffer1(buf,w);
+        ssd1306_lcdSendPixelsBuffer1(buf,w);
         buf+=w;
         ssd1306_lcd.next_page();
     }
     ssd1306_intf.stop();
 }
 
-void ssd1306_drawBuffer(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *buf)
+void SSD1306_IRAM ssd1306_displayPageBuffer(const uint8_t *buffer, uint8_t *previous)
+{
+    uint8_t pages = ssd1306_lcd.height >> 3;
+    if (!previous)
+    {
+        ssd1306_lcd.set_block(0, 0, 0);
+        if (ssd1306_lcd.type == LCD_TYPE_SSD1306)
+        {
+            /* Horizontal addressing wraps pages itself: whole frame is a single transfer */
+            ssd1306_lcdSendPixelsBuffer1(buffer, (uint16_t)ssd1306_lcd.width * pages);
+        }
+        else
+        {
+            for(uint8_t page = pages; page > 0; page--)
+            {
+                ssd1306_lcdSendPixelsBuffer1(buffer, ssd1306_lcd.width);
+                buffer += ssd1306_lcd.width;
+                ssd1306_lcd.next_page();
+            }
+        }
+        ssd1306_intf.stop();
+        return;
+    }
+    for(uint8_t page = 0; page < pages; page++)
+    {
+        lcduint_t x1 = 0;
+        lcduint_t x2 = ssd1306_lcd.width;
+        while ((x1 < x2) && (buffer[x1] == previous[x1])) x1++;
+        if (x1 < x2)
+        {
+            while (buffer[x2 - 1] == previous[x2 - 1]) x2--;
+            ssd1306_lcd.set_block(x1, page, x2 - x1);
+            ssd1306_lcdSendPixelsBuffer1(&buffer[x1], x2 - x1);
+            ssd1306_intf.stop();
+            memcpy(&previous[x1], &buffer[x1], x2 - x1);
+        }
+        buffer += ssd1306_lcd.width;
+        previous += ssd1306_lcd.width;
+    }
+}
+
+void SSD1306_IRAM ssd1306_drawBuffer(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *buf)
 {
     uint8_t i, j;
     ssd1306_lcd.set_block(x, y, w);
@@ -736,7 +839,35 @@ void ssd1306_drawBuffer(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_
     {
         for(i=w;i>0;i--)
         {
-            ssd1306_lcd.send_pixels1(s_ssd1306_invertByte^*buf++);
+            ssd1306_lcdSendPixels1(s_ssd1306_invertByte^*buf++);
+        }
+        ssd1306_lcd.next_page();
+    }
+    ssd1306_intf.stop();
+}
+
+void ssd1306_drawColumns(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *buf)
+{
+    uint8_t pages = h >> 3;
+    if (ssd1306_lcd.set_column_block)
+    {
+        uint16_t len = (uint16_t)w * pages;
+        ssd1306_lcd.set_column_block(x, y, w, pages);
+        while (len--)
+        {
+            ssd1306_lcdSendPixels1(s_ssd1306_invertByte^*buf++);
+        }
+        ssd1306_intf.stop();
+        return;
+    }
+    ssd1306_lcd.set_block(x, y, w);
+    for (uint8_t page = 0; page < pages; page++)
+    {
+        const uint8_t *column = buf + page;
+        for (uint8_t i = w; i > 0; i--)
+        {
+            ssd1306_lcdSendPixels1(s_ssd1306_invertByte^*column);
+            column += pages;
         }
         ssd1306_lcd.next_page();
     }
@@ -745,50 +876,126 @@ void ssd1306_drawBuffer(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_
 
 void ssd1306_drawBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *buf)
 {
-    uint8_t i, j;
+    uint8_t j;
     uint8_t remainder = (ssd1306_lcd.width - x) < w ? (w + x - ssd1306_lcd.width): 0;
     w -= remainder;
     ssd1306_lcd.set_block(x, y, w);
     for(j=(h >> 3); j>0; j--)
     {
-        for(i=w;i>0;i--)
+        ssd1306_sendProgmemPixels1(buf, w, s_ssd1306_invertByte);
+        buf += w + remainder;
+        ssd1306_lcd.next_page();
+    }
+    ssd1306_intf.stop();
+}
+
+void ssd1306_drawBitmapEx(uint8_t x, uint8_t y, uint8_t w, uint8_t h, lcduint_t pitch,
+                          lcduint_t srcX, lcduint_t srcY, const uint8_t *buf)
+{
+    uint8_t j;
+    uint8_t shift = srcY & 0x07;
+    if (w > ssd1306_lcd.width - x) w = ssd1306_lcd.width - x;
+    buf += (uint16_t)(srcY >> 3) * pitch + srcX;
+    ssd1306_lcd.set_block(x, y, w);
+    for(j=(h >> 3); j>0; j--)
+    {
+        if (!shift)
         {
-            ssd1306_lcd.send_pixels1(s_ssd1306_invertByte^pgm_read_byte(buf++));
+            ssd1306_sendProgmemPixels1(buf, w, s_ssd1306_invertByte);
         }
-        buf += remainder;
+        else
+        {
+            /* Display page takes upper bits of one source page and lower bits of the next one */
+            for (uint8_t i = 0; i < w; i++)
+            {
+                uint8_t data = (pgm_read_byte(&buf[i]) >> shift) |
+                               (pgm_read_byte(&buf[pitch + i]) << (8 - shift));
+                ssd1306_lcdSendPixels1(s_ssd1306_invertByte^data);
+            }
+        }
+        buf += pitch;
         ssd1306_lcd.next_page();
     }
     ssd1306_intf.stop();
 }
 
+void ssd1306_drawCompressedBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *buf)
+{
+    uint16_t left = (uint16_t)w * (h >> 3);
+    uint8_t column = w;
+    ssd1306_lcd.set_block(x, y, w);
+    while (left)
+    {
+        /* Bit 7 of header means repeated byte, the rest is number of bytes - 1 */
+        uint8_t header = pgm_read_byte(buf++);
+        uint8_t count = (header & 0x7F) + 1;
+        uint8_t data = pgm_read_byte(buf);
+        if (header & 0x80) buf++;
+        while (count-- && left)
+        {
+            if (!(header & 0x80)) data = pgm_read_byte(buf++);
+            ssd1306_lcdSendPixels1(s_ssd1306_invertByte^data);
+            left--;
+            if (!--column)
+            {
+                column = w;
+                ssd1306_lcd.next_page();
+            }
+        }
+    }
+    ssd1306_intf.stop();
+}
+
+static const uint8_t *s_bootSplash;
+static uint8_t s_bootSplashW;
+static uint8_t s_bootSplashH;
+
+static void ssd1306_drawBootSplash(void)
+{
+    uint8_t x = (ssd1306_lcd.width - s_bootSplashW) >> 1;
+    uint8_t y = ((ssd1306_lcd.height - s_bootSplashH) >> 1) & ~0x07;
+    uint8_t right = x + s_bootSplashW;
+    uint8_t bottom = y + s_bootSplashH;
+    /* Margins are cleared here, so every GDRAM byte is written exactly once */
+    if (y) ssd1306_clearBlock(0, 0, ssd1306_lcd.width, y);
+    if (x) ssd1306_clearBlock(0, y >> 3, x, s_bootSplashH);
+    ssd1306_drawCompressedBitmap(x, y >> 3, s_bootSplashW, s_bootSplashH, s_bootSplash);
+    if (right < ssd1306_lcd.width) ssd1306_clearBlock(right, y >> 3, ssd1306_lcd.width - right, s_bootSplashH);
+    if (bottom < ssd1306_lcd.height) ssd1306_clearBlock(0, bottom >> 3, ssd1306_lcd.width, ssd1306_lcd.height - bottom);
+}
+
+void ssd1306_setBootSplash(uint8_t w, uint8_t h, const uint8_t *buf)
+{
+    s_bootSplash = buf;
+    s_bootSplashW = w;
+    s_bootSplashH = h;
+    ssd1306_setDisplayOnHook(ssd1306_drawBootSplash);
+}
+
 void ssd1306_drawXBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *buf)
 {
-    uint8_t i, j;
+    uint8_t i, j, k;
+    uint8_t block[8];
     lcduint_t pitch = (w + 7) >> 3;
     ssd1306_lcd.set_block(x, y, w);
     for(j=(h >> 3); j>0; j--)
     {
-        uint8_t bit = 0;
-        for(i=w;i>0;i--)
+        /* Each 8x8 block of bitmap rows becomes 8 page bytes */
+        for(i=0; i<pitch; i++)
         {
-            uint8_t data = 0;
-            for (uint8_t k = 0; k<8; k++)
+            uint8_t n = (w - (i << 3)) < 8 ? (w - (i << 3)) : 8;
+            for (k = 0; k<8; k++)
             {
-                data |= ( ((pgm_read_byte(&buf[k*pitch]) >> bit) & 0x01) << k );
+                block[k] = pgm_read_byte(&buf[k*pitch + i]);
             }
-            ssd1306_lcd.send_pixels1(s_ssd1306_invertByte^data);
-            bit++;
-            if (bit >= 8)
+            ssd1306_transpose8x8(block);
+            for (k = 0; k<n; k++)
             {
-                buf++;
-                bit=0;
+                block[k] ^= s_ssd1306_invertByte;
             }
+            ssd1306_lcdSendPixelsBuffer1(block, n);
         }
-        if (bit)
-        {
-            buf++;
-        }
-        buf += pitch * 7;
+        buf += pitch * 8;
         ssd1306_lcd.next_page();
     }
     ssd1306_intf.stop();
@@ -841,7 +1048,7 @@ void gfx_drawMonoBitmap(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const
             if ( mainFlag )    data |= (pgm_read_byte(buf) << offset);
             if ( complexFlag ) data |= (pgm_read_byte(buf - origin_width) >> (8 - offset));
             buf++;
-            ssd1306_lcd.send_pixels1(s_ssd1306_invertByte^data);
+            ssd1306_lcdSendPixels1(s_ssd1306_invertByte^data);
         }
         buf += origin_width - w;
         complexFlag = offset;
@@ -859,7 +1066,7 @@ void ssd1306_clearBlock(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
     {
         for(i=w;i>0;i--)
         {
-            ssd1306_lcd.send_pixels1(s_ssd1306_invertByte);
+            ssd1306_lcdSendPixels1(s_ssd1306_invertByte);
         }
         ssd1306_lcd.next_page();
     }
@@ -873,7 +1080,7 @@ void ssd1306_drawSpriteEx(uint8_t x, uint8_t y, uint8_t w, const uint8_t *sprite
    ssd1306_lcd.set_block(x,y,w);
    for(i=0;i<w;i++)
    {
-       ssd1306_lcd.send_pixels1(s_ssd1306_invertByte^pgm_read_byte(&sprite[i]));
+       ssd1306_lcdSendPixels1(s_ssd1306_invertByte^pgm_read_byte(&sprite[i]));
    }
    ssd1306_intf.stop();
 }
@@ -887,7 +1094,7 @@ void ssd1306_drawSprite(SPRITE *sprite)
         ssd1306_lcd.set_block(sprite->x, sprite->y >> 3, sprite->w);
         for (uint8_t i=0; i < sprite->w; i++)
         {
-            ssd1306_lcd.send_pixels1( s_ssd1306_invertByte^(pgm_read_byte( &sprite->data[i] ) << offsety) );
+            ssd1306_lcdSendPixels1( s_ssd1306_invertByte^(pgm_read_byte( &sprite->data[i] ) << offsety) );
         }
         ssd1306_intf.stop();
     }
@@ -896,7 +1103,7 @@ void ssd1306_drawSprite(SPRITE *sprite)
         ssd1306_lcd.set_block(sprite->x, (sprite->y >> 3) + 1, sprite->w);
         for (uint8_t i=0; i < sprite->w; i++)
         {
-            ssd1306_lcd.send_pixels1( s_ssd1306_invertByte^(pgm_read_byte( &sprite->data[i] ) >> (8 - offsety)) );
+            ssd1306_lcdSendPixels1( s_ssd1306_invertByte^(pgm_read_byte( &sprite->data[i] ) >> (8 - offsety)) );
         }
         ssd1306_intf.stop();
     }
@@ -912,7 +1119,7 @@ void ssd1306_eraseSprite(SPRITE *sprite)
     ssd1306_lcd.set_block(sprite->x, posy, sprite->w);
     for (uint8_t i=sprite->w; i > 0; i--)
     {
-       ssd1306_lcd.send_pixels1( s_ssd1306_invertByte );
+       ssd1306_lcdSendPixels1( s_ssd1306_invertByte );
     }
     ssd1306_intf.stop();
     if (offsety)
@@ -920,7 +1127,7 @@ void ssd1306_eraseSprite(SPRITE *sprite)
         ssd1306_lcd.set_block(sprite->x, posy + 1, sprite->w);
         for (uint8_t i=sprite->w; i > 0; i--)
         {
-           ssd1306_lcd.send_pixels1( s_ssd1306_invertByte );
+           ssd1306_lcdSendPixels1( s_ssd1306_invertByte );
         }
     }
     ssd1306_intf.stop();
@@ -940,7 +1147,7 @@ void ssd1306_eraseTrace(SPRITE *sprite)
         ssd1306_lcd.set_block(sprite->lx, y, sprite->w);
         for(uint8_t x = sprite->w; x > 0; x--)
         {
-            ssd1306_lcd.send_pixels1( s_ssd1306_invertByte );
+            ssd1306_lcdSendPixels1( s_ssd1306_invertByte );
         }
         ssd1306_intf.stop();
     }
@@ -957,7 +1164,7 @@ void ssd1306_eraseTrace(SPRITE *sprite)
             ssd1306_lcd.set_block(x1, y, x2 - x1 + 1 );
             for(uint8_t x = x2 - x1 + 1; x > 0; x--)
             {
-                ssd1306_lcd.send_pixels1( s_ssd1306_invertByte );
+                ssd1306_lcdSendPixels1( s_ssd1306_invertByte );
             }
             ssd1306_intf.stop();
         }
@@ -989,3 +1196,253 @@ void ssd1306_setFont6x8(const uint8_t * progmemFont)
     s_font6x8 = progmemFont + 4;
 }
 
+
+///////////////////////////////////////////////////////////////////////////////
+////// SHADOW BUFFER MODE /////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+/** Max number of pages supported by shadow buffer mode */
+#define SHADOW_MAX_PAGES       8
+/** Max number of extra bytes allowed to send to merge 2 pages into single window */
+#define SHADOW_MERGE_GAP       16
+
+static uint8_t *s_shadow = NULL;
+static uint8_t s_shadow_min[SHADOW_MAX_PAGES];
+static uint8_t s_shadow_max[SHADOW_MAX_PAGES];
+static uint8_t s_shadow_x;
+static uint8_t s_shadow_rx;
+static uint8_t s_shadow_column;
+static uint8_t s_shadow_page;
+static uint8_t s_shadow_session = 0;
+static ssd1306_lcd_t s_shadow_lcd;
+static void (*s_shadow_stop)(void);
+
+static void ssd1306_shadowSetBlock(lcduint_t x, lcduint_t y, lcduint_t w)
+{
+    uint8_t rx = w ? (x + w - 1) : (ssd1306_lcd.width - 1);
+    s_shadow_x = x;
+    s_shadow_rx = rx < ssd1306_lcd.width ? rx : (ssd1306_lcd.width - 1);
+    s_shadow_column = x;
+    s_shadow_page = y;
+    s_shadow_session = 1;
+}
+
+static void ssd1306_shadowNextPage(void)
+{
+    /* ssd1306 moves to next page automatically at the end of the block */
+    if (s_shadow_column != s_shadow_x)
+    {
+        s_shadow_column = s_shadow_x;
+        s_shadow_page++;
+    }
+}
+
+static void ssd1306_shadowSendPixels(uint8_t data)
+{
+    if ((s_shadow_page < (ssd1306_lcd.height >> 3)) && (s_shadow_column < ssd1306_lcd.width))
+    {
+        uint8_t *ptr = &s_shadow[s_shadow_page * ssd1306_lcd.width + s_shadow_column];
+        if (*ptr != data)
+        {
+            *ptr = data;
+            if (s_shadow_column < s_shadow_min[s_shadow_page]) s_shadow_min[s_shadow_page] = s_shadow_column;
+            if (s_shadow_column > s_shadow_max[s_shadow_page]) s_shadow_max[s_shadow_page] = s_shadow_column;
+        }
+    }
+    if (++s_shadow_column > s_shadow_rx)
+    {
+        s_shadow_column = s_shadow_x;
+        s_shadow_page++;
+    }
+}
+
+static void ssd1306_shadowSendPixelsBuffer(const uint8_t *buffer, uint16_t len)
+{
+    while (len--)
+    {
+        ssd1306_shadowSendPixels(*buffer);
+        buffer++;
+    }
+}
+
+static void ssd1306_shadowStop(void)
+{
+    /* Commands, sent to the controller, still use real interface */
+    if (!s_shadow_session)
+    {
+        s_shadow_stop();
+    }
+    s_shadow_session = 0;
+}
+
+static void ssd1306_shadowClean(void)
+{
+    for (uint8_t page = 0; page < SHADOW_MAX_PAGES; page++)
+    {
+        s_shadow_min[page] = 0xFF;
+        s_shadow_max[page] = 0;
+    }
+}
+
+static void ssd1306_shadowSendWindow(uint8_t page, uint8_t count, uint8_t x1, uint8_t x2)
+{
+    s_shadow_lcd.set_block(x1, page, x2 - x1 + 1);
+    while (count--)
+    {
+        s_shadow_lcd.send_pixels_buffer1(&s_shadow[page * ssd1306_lcd.width + x1], x2 - x1 + 1);
+        s_shadow_lcd.next_page();
+        page++;
+    }
+    s_shadow_stop();
+}
+
+void ssd1306_flush(void)
+{
+    if (!s_shadow)
+    {
+        return;
+    }
+    uint8_t first = 0;
+    uint8_t count = 0;
+    uint8_t x1 = 0, x2 = 0;
+    uint16_t bytes = 0;
+    ssd1306_intf.stop = s_shadow_stop;
+    for (uint8_t page = 0; page <= (ssd1306_lcd.height >> 3); page++)
+    {
+        uint8_t dirty = (page < (ssd1306_lcd.height >> 3)) && (s_shadow_min[page] <= s_shadow_max[page]);
+        if (dirty && count)
+        {
+            uint8_t n1 = min(x1, s_shadow_min[page]);
+            uint8_t n2 = max(x2, s_shadow_max[page]);
+            uint16_t len = bytes + s_shadow_max[page] - s_shadow_min[page] + 1;
+            if ((uint16_t)(n2 - n1 + 1) * (count + 1) <= len + SHADOW_MERGE_GAP)
+            {
+                x1 = n1;
+                x2 = n2;
+                bytes = len;
+                count++;
+                continue;
+            }
+        }
+        if (count)
+        {
+            ssd1306_shadowSendWindow(first, count, x1, x2);
+            count = 0;
+        }
+        if (dirty)
+        {
+            first = page;
+            count = 1;
+            x1 = s_shadow_min[page];
+            x2 = s_shadow_max[page];
+            bytes = x2 - x1 + 1;
+        }
+    }
+    ssd1306_intf.stop = ssd1306_shadowStop;
+    ssd1306_shadowClean();
+}
+
+void ssd1306_enableShadowBuffer(uint8_t *buffer)
+{
+    if (s_shadow)
+    {
+        ssd1306_disableShadowBuffer();
+    }
+    s_shadow_lcd = ssd1306_lcd;
+    s_shadow_stop = ssd1306_intf.stop;
+    s_shadow = buffer;
+    ssd1306_shadowClean();
+    ssd1306_lcd.set_block = ssd1306_shadowSetBlock;
+    ssd1306_lcd.next_page = ssd1306_shadowNextPage;
+    ssd1306_lcd.send_pixels1 = ssd1306_shadowSendPixels;
+    ssd1306_lcd.send_pixels_buffer1 = ssd1306_shadowSendPixelsBuffer;
+    ssd1306_intf.stop = ssd1306_shadowStop;
+}
+
+void ssd1306_disableShadowBuffer(void)
+{
+    if (!s_shadow)
+    {
+        return;
+    }
+    ssd1306_flush();
+    ssd1306_lcd.set_block = s_shadow_lcd.set_block;
+    ssd1306_lcd.next_page = s_shadow_lcd.next_page;
+    ssd1306_lcd.send_pixels1 = s_shadow_lcd.send_pixels1;
+    ssd1306_lcd.send_pixels_buffer1 = s_shadow_lcd.send_pixels_buffer1;
+    ssd1306_intf.stop = s_shadow_stop;
+    s_shadow = NULL;
+}
+
+static void ssd1306_shadowXor(uint8_t page, uint8_t column, uint8_t data)
+{
+    if (!data)
+    {
+        return;
+    }
+    s_shadow[page * ssd1306_lcd.width + column] ^= data;
+    if (column < s_shadow_min[page]) s_shadow_min[page] = column;
+    if (column > s_shadow_max[page]) s_shadow_max[page] = column;
+}
+
+void ssd1306_invertRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
+{
+    if (!s_shadow)
+    {
+        return;
+    }
+    if (x2 < x1) ssd1306_swap_data(x2, x1, lcdint_t);
+    if (y2 < y1) ssd1306_swap_data(y2, y1, lcdint_t);
+    x1 = max(x1, 0);
+    y1 = max(y1, 0);
+    x2 = min(x2, (lcdint_t)ssd1306_lcd.width - 1);
+    y2 = min(y2, (lcdint_t)ssd1306_lcd.height - 1);
+    if ((x1 > x2) || (y1 > y2))
+    {
+        return;
+    }
+    for (uint8_t page = y1 >> 3; page <= (y2 >> 3); page++)
+    {
+        uint8_t mask = 0xFF;
+        if (page == (y1 >> 3)) mask <<= (y1 & 0x07);
+        if (page == (y2 >> 3)) mask &= 0xFF >> (7 - (y2 & 0x07));
+        for (lcdint_t x = x1; x <= x2; x++)
+        {
+            ssd1306_shadowXor(page, x, mask);
+        }
+    }
+}
+
+void ssd1306_xorBitmap(lcdint_t x, lcdint_t y, uint8_t w, uint8_t h, const uint8_t *buf)
+{
+    if (!s_shadow)
+    {
+        return;
+    }
+    lcdint_t x1 = max(x, 0);
+    lcdint_t y1 = max(y, 0);
+    lcdint_t x2 = min(x + (lcdint_t)w - 1, (lcdint_t)ssd1306_lcd.width - 1);
+    lcdint_t y2 = min(y + (lcdint_t)h - 1, (lcdint_t)ssd1306_lcd.height - 1);
+    if ((x1 > x2) || (y1 > y2))
+    {
+        return;
+    }
+    uint8_t pages = (h + 7) >> 3;
+    /* Display page p gets bits of bitmap pages k and k + 1, shifted by s */
+    uint8_t s = (uint8_t)(-y) & 0x07;
+    for (uint8_t page = y1 >> 3; page <= (y2 >> 3); page++)
+    {
+        lcdint_t k = ((lcdint_t)(page << 3) - y - s) / 8;
+        uint8_t mask = 0xFF;
+        if (page == (y1 >> 3)) mask <<= (y1 & 0x07);
+        if (page == (y2 >> 3)) mask &= 0xFF >> (7 - (y2 & 0x07));
+        for (lcdint_t col = x1; col <= x2; col++)
+        {
+            const uint8_t *src = buf + (col - x);
+            uint8_t data = 0;
+            if ((k >= 0) && (k < pages)) data = pgm_read_byte(src + k * w) >> s;
+            if (s && (k + 1 >= 0) && (k + 1 < pages)) data |= pgm_read_byte(src + (k + 1) * w) << (8 - s);
+            ssd1306_shadowXor(page, col, data & mask);
+        }
+    }
+}
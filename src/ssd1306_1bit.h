@@ -30,6 +30,7 @@
 #define _SSD1306_1BIT_H_
 
 #include "nano_gfx_types.h"
+#include "ssd1306_generic.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -90,6 +91,17 @@ void         ssd1306_positiveMode(void);
  */
 uint8_t     ssd1306_printFixed(uint8_t xpos, uint8_t y, const char *ch, EFontStyle style);
 
+/**
+ * @brief Draws run of chars, collected by ssd1306_getTextRun(), in one block.
+ *
+ * Each page of the run is sent via single window, spacing between chars is filled
+ * with background. Text consoles use it to print strings without addressing each char.
+ * @param x horizontal position in pixels
+ * @param y vertical position in pixels, must be aligned to pages (multiple of 8)
+ * @param run run of chars to draw
+ */
+void        ssd1306_drawTextRun(lcdint_t x, lcdint_t y, const STextRun *run);
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 uint8_t ssd1306_printFixed_oldStyle(uint8_t xpos, uint8_t y, const char *ch, EFontStyle style);
 #endif
@@ -308,6 +320,51 @@ void         ssd1306_drawBuffer(uint8_t x, uint8_t y, uint8_t w, uint8_t h, cons
  */
 void         ssd1306_drawBufferFast(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *buf);
 
+/**
+ * @brief Sends full-screen page-format buffer to the display.
+ *
+ * Sends Arduboy-style frame buffer (ssd1306_lcd.width * ssd1306_lcd.height / 8 bytes,
+ * each byte represents 8 vertical pixels, pages go one after another) to the display.
+ * On SSD1306 the whole frame is sent as single data transfer after one addressing
+ * sequence, so on AVR at F_CPU/2 SPI clock 128x64 frame takes 1024 x 16 cpu cycles.
+ *
+ * If previous is not NULL, it must hold the frame, sent last time. In this case only
+ * changed column range of each page is sent, and previous is updated with new content.
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+ * static uint8_t frame[128*64/8];
+ * static uint8_t shown[128*64/8];
+ * ...
+ * ssd1306_displayPageBuffer(frame, shown);
+ * ~~~~~~~~~~~~~~~
+ *
+ * @param buffer pointer to frame data, located in SRAM.
+ * @param previous pointer to last sent frame in SRAM, or NULL to send whole frame.
+ * @note negative draw mode is not supported.
+ */
+void         ssd1306_displayPageBuffer(const uint8_t *buffer, uint8_t *previous);
+
+/**
+ * Draws bitmap, located in SRAM, stored column by column: h/8 bytes of the first
+ * column from top to bottom, then bytes of the next column and so on.
+ * Each byte represents 8 vertical pixels. This is natural layout for bar graphs,
+ * scrolling charts and rotated text. If display supports vertical addressing
+ * (ssd1306_lcd.set_column_block), whole bitmap is sent in single GDRAM window.
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+ * // Draw 2 columns of 16 pixels at position 10,8
+ * uint8_t buffer[4] = { 0xFF, 0x01, 0x80, 0xFF };
+ * ssd1306_drawColumns(10, 1, 2, 16, buffer);
+ * ~~~~~~~~~~~~~~~
+ *
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in blocks (pixels/8)
+ * @param w - width of bitmap in pixels
+ * @param h - height of bitmap in pixels (must be divided by 8)
+ * @param buf - pointer to data, located in SRAM.
+ */
+void         ssd1306_drawColumns(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *buf);
+
 /**
  * @copydoc ssd1306_drawBuffer
  */
@@ -325,6 +382,53 @@ void         ssd1306_drawBufferFast(lcdint_t x, lcdint_t y, lcduint_t w, lcduint
  */
 void         ssd1306_drawBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *buf);
 
+/**
+ * Draws w x h area of bitmap (atlas), located in Flash, on the display.
+ * The bitmap should be in native ssd1306 format. Source area starts at srcX, srcY pixels
+ * of the bitmap and srcY may be not aligned to pages, so single sprite sheet or
+ * font image can be used without copying sub-images out of it.
+ *
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in blocks (pixels/8)
+ * @param w - width of area in pixels
+ * @param h - height of area in pixels (must be divided by 8)
+ * @param pitch - width of whole bitmap in pixels (length of bitmap page in bytes)
+ * @param srcX - horizontal position of area in the bitmap in pixels
+ * @param srcY - vertical position of area in the bitmap in pixels
+ * @param buf - pointer to bitmap data, located in Flash: each byte represents 8 vertical pixels.
+ */
+void         ssd1306_drawBitmapEx(uint8_t x, uint8_t y, uint8_t w, uint8_t h, lcduint_t pitch,
+                                  lcduint_t srcX, lcduint_t srcY, const uint8_t *buf);
+
+/**
+ * Draws compressed bitmap, located in Flash, on the display
+ * The bitmap should be in native ssd1306 format, compressed by tools/bitmapcompress.py.
+ * The bitmap is decompressed directly to the display, so no RAM buffer is required.
+ *
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in blocks (pixels/8)
+ * @param w - width of bitmap in pixels
+ * @param h - height of bitmap in pixels (must be divided by 8)
+ * @param buf - pointer to compressed data, located in Flash.
+ * @note The bitmap must fit the display, it is not clipped.
+ */
+void         ssd1306_drawCompressedBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *buf);
+
+/**
+ * Sets compressed bitmap, located in Flash, to show as boot splash.
+ * Must be called before display init function (for example, ssd1306_128x64_i2c_init()).
+ * The bitmap is streamed to GDRAM centered, with the margins cleared, right after
+ * init sequence while the panel is still off, and display-on command is sent only
+ * when the frame is complete. Thus, there is no need to clear the screen before
+ * drawing the logo, and the first visible frame is the splash itself.
+ * The bitmap should be in native ssd1306 format, compressed by tools/bitmapcompress.py.
+ *
+ * @param w - width of bitmap in pixels
+ * @param h - height of bitmap in pixels (must be divided by 8)
+ * @param buf - pointer to compressed data, located in Flash.
+ */
+void         ssd1306_setBootSplash(uint8_t w, uint8_t h, const uint8_t *buf);
+
 /**
  * Draws bitmap, located in Flash, on the display
  * The bitmap should be in XBMP format
@@ -404,6 +508,74 @@ SPRITE       ssd1306_createSprite(uint8_t x, uint8_t y, uint8_t w, const uint8_t
  */
 void         ssd1306_replaceSprite(SPRITE *sprite, const uint8_t *data);
 
+/**
+ * @brief Redirects all direct draw functions to shadow buffer.
+ *
+ * Redirects all 1-bit direct draw functions to shadow buffer in RAM. The functions
+ * stop sending data to the display and only remember which columns of each page
+ * were changed. Call ssd1306_flush() to send all changes to the display at once.
+ * This mode is intended for SSD1306/SH1106 displays, and allows to avoid separate
+ * addressing sequence for each small object being drawn.
+ *
+ * @param buffer buffer of ssd1306_lcd.width * ssd1306_lcd.height / 8 bytes.
+ *        Buffer content is considered to be equal to display GDRAM content.
+ * @note Display height must be not greater than 64 pixels.
+ * @see ssd1306_flush()
+ * @see ssd1306_disableShadowBuffer()
+ */
+void         ssd1306_enableShadowBuffer(uint8_t *buffer);
+
+/**
+ * Sends all pending changes to the display and returns direct draw functions
+ * to normal mode, when they send data directly to GDRAM.
+ */
+void         ssd1306_disableShadowBuffer(void);
+
+/**
+ * @brief Sends changed areas of shadow buffer to the display.
+ *
+ * Sends changed areas of shadow buffer to the display. The function emits
+ * minimal set of ssd1306_lcd.set_block() windows: consecutive changed pages
+ * with close column ranges are sent via single window.
+ * Does nothing, if shadow buffer is not enabled.
+ * @see ssd1306_enableShadowBuffer()
+ */
+void         ssd1306_flush(void);
+
+/**
+ * @brief Inverts rectangle area in the shadow buffer.
+ *
+ * Inverts pixels of the area right in the shadow buffer, so cursors and selection
+ * bars can be shown and hidden without redrawing underlying content: calling the
+ * function twice restores original image. Only changed columns are marked dirty,
+ * and next ssd1306_flush() sends single small window to the display.
+ * Does nothing, if shadow buffer is not enabled.
+ *
+ * @param x1 - left boundary in pixels
+ * @param y1 - top boundary in pixels
+ * @param x2 - right boundary in pixels
+ * @param y2 - bottom boundary in pixels
+ * @see ssd1306_enableShadowBuffer()
+ */
+void         ssd1306_invertRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2);
+
+/**
+ * @brief XORs monochrome bitmap into the shadow buffer.
+ *
+ * Inverts those pixels of the shadow buffer, which are set in the bitmap. Calling
+ * the function twice with the same arguments restores original image.
+ * y position can be not aligned to pages.
+ * Does nothing, if shadow buffer is not enabled.
+ *
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in pixels
+ * @param w - width of bitmap in pixels
+ * @param h - height of bitmap in pixels
+ * @param buf - monochrome bitmap data, located in flash: each byte represents 8 vertical pixels.
+ * @see ssd1306_flush()
+ */
+void         ssd1306_xorBitmap(lcdint_t x, lcdint_t y, uint8_t w, uint8_t h, const uint8_t *buf);
+
 /**
  * @}
  */
@@ -0,0 +1,54 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_4bit.h"
+#include "intf/ssd1306_interface.h"
+#include "lcd/lcd_common.h"
+
+void SSD1306_IRAM ssd1306_drawBufferEx4(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch, const uint8_t *data)
+{
+    lcduint_t len = (w + 1) >> 1;
+    if (!ssd1306_lcd.send_pixels_buffer4)
+    {
+        return;
+    }
+    ssd1306_lcd.set_block(x, y, w);
+    if ((pitch == len) && ((uint32_t)len * h <= 0xFFFF))
+    {
+        /* Continuous block can be sent at once */
+        ssd1306_lcd.send_pixels_buffer4( data, len * h );
+        h = 0;
+    }
+    while (h--)
+    {
+        ssd1306_lcd.send_pixels_buffer4( data, len );
+        data += pitch;
+    }
+    ssd1306_intf.stop();
+}
+
+void ssd1306_drawBufferFast4(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *data)
+{
+    ssd1306_drawBufferEx4( x, y, w, h, (w + 1) >> 1, data );
+}
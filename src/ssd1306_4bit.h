@@ -0,0 +1,86 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file ssd1306_4bit.h 4-bit grayscale specific draw functions
+ */
+
+#ifndef _SSD1306_4BIT_H_
+#define _SSD1306_4BIT_H_
+
+#include "nano_gfx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///////////////////////////////////////////////////////////////////////
+//                 DIRECT GRAPH FUNCTIONS
+///////////////////////////////////////////////////////////////////////
+
+/**
+ * @defgroup LCD_4BIT_GRAPHICS DIRECT DRAW: 4-bit API functions only for grayscale displays
+ * @{
+ *
+ * @brief LCD direct draw functions only for 4-bit grayscale displays (SSD1325).
+ *
+ * @details These functions work only in normal mode of the displays, which provide
+ *        ssd1306_lcd.send_pixels_buffer4(). Use ssd1306_setMode() function to change
+ *        display mode to NORMAL. Each byte of the buffer holds 2 pixels: low nibble is
+ *        the left pixel, high nibble is the right one (refer to GRAY_COLOR4).
+ *        The functions do nothing, if current display doesn't support 4-bit pixels.
+ */
+
+/**
+ * Draws 4-bit grayscale bitmap, located in SRAM, on the display
+ *
+ * @param x - horizontal position in pixels, should be even
+ * @param y - vertical position in pixels
+ * @param w - width of bitmap in pixels
+ * @param h - height of bitmap in pixels
+ * @param data - pointer to data, located in SRAM, (w + 1) / 2 bytes per line.
+ */
+void ssd1306_drawBufferFast4(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *data);
+
+/**
+ * Draws 4-bit grayscale bitmap, located in SRAM, on the display, taking into account
+ * pitch parameter. pitch parameter specifies, length of single line in bytes.
+ *
+ * @param x - horizontal position in pixels, should be even
+ * @param y - vertical position in pixels
+ * @param w - width of bitmap in pixels
+ * @param h - height of bitmap in pixels
+ * @param pitch length of bitmap buffer line in bytes
+ * @param data - pointer to data, located in SRAM.
+ */
+void ssd1306_drawBufferEx4(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch, const uint8_t *data);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SSD1306_4BIT_H_
@@ -90,6 +90,23 @@ void ssd1306_drawMonoBuffer8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_
 static void ssd1306_drawBufferPitch8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch, const uint8_t *data)
 {
     ssd1306_lcd.set_block(x, y, w);
+    if (ssd1306_lcd.send_pixels_buffer8)
+    {
+        uint32_t count = (uint32_t)w * h;
+        if ((pitch == w) && (count <= 0xFFFF))
+        {
+            /* Continuous block can be sent at once */
+            ssd1306_lcd.send_pixels_buffer8( data, count );
+            h = 0;
+        }
+        while (h--)
+        {
+            ssd1306_lcd.send_pixels_buffer8( data, w );
+            data += pitch;
+        }
+        ssd1306_intf.stop();
+        return;
+    }
     while (h--)
     {
         lcduint_t line = w;
@@ -103,24 +120,40 @@ static void ssd1306_drawBufferPitch8(lcdint_t x, lcdint_t y, lcduint_t w, lcduin
     ssd1306_intf.stop();
 }
 
+static void ssd1306_fillPixelsEx8(uint8_t color, uint32_t count)
+{
+    if (ssd1306_lcd.fill_pixels8)
+    {
+        ssd1306_lcd.fill_pixels8( color, count );
+        return;
+    }
+    while (count--)
+    {
+        ssd1306_lcd.send_pixels8( color );
+    }
+}
+
 void ssd1306_drawBufferFast8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, const uint8_t *data)
 {
     ssd1306_drawBufferPitch8( x, y, w, h, w, data );
 }
 
-void ssd1306_drawBufferEx8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch, const uint8_t *data)
+void SSD1306_IRAM ssd1306_drawBufferEx8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch, const uint8_t *data)
 {
     ssd1306_drawBufferPitch8( x, y, w, h, pitch, data );
 }
 
+void ssd1306_fillBlock8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, uint8_t color)
+{
+    ssd1306_lcd.set_block(x, y, w);
+    ssd1306_fillPixelsEx8( color, (uint32_t)w * h );
+    ssd1306_intf.stop();
+}
+
 void ssd1306_fillScreen8(uint8_t fill_Data)
 {
     ssd1306_lcd.set_block(0, 0, 0);
-    uint32_t count = (uint32_t)ssd1306_lcd.width * (uint32_t)ssd1306_lcd.height;
-    while (count--)
-    {
-        ssd1306_lcd.send_pixels8( fill_Data );
-    }
+    ssd1306_fillPixelsEx8( fill_Data, (uint32_t)ssd1306_lcd.width * (uint32_t)ssd1306_lcd.height );
     ssd1306_intf.stop();
 }
 
@@ -167,6 +200,10 @@ void ssd1306_drawHLine8(lcdint_t x1, lcdint_t y1, lcdint_t x2)
 
 void ssd1306_drawLine8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    if (ssd1306_lcd.draw_line && ssd1306_lcd.draw_line( x1, y1, x2, y2, RGB8_TO_RGB16(ssd1306_color) ))
+    {
+        return;
+    }
     lcduint_t  dx = x1 > x2 ? (x1 - x2): (x2 - x1);
     lcduint_t  dy = y1 > y2 ? (y1 - y2): (y2 - y1);
     lcduint_t  err = 0;
@@ -210,6 +247,10 @@ void ssd1306_drawLine8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 
 void ssd1306_drawRect8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
 {
+    if (ssd1306_lcd.draw_rect && ssd1306_lcd.draw_rect( x1, y1, x2, y2, RGB8_TO_RGB16(ssd1306_color) ))
+    {
+        return;
+    }
     ssd1306_drawHLine8(x1,y1,x2);
     ssd1306_drawHLine8(x1,y2,x2);
     ssd1306_drawVLine8(x1,y1,y2);
@@ -227,11 +268,7 @@ void ssd1306_fillRect8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2)
         ssd1306_swap_data(x1, x2, lcdint_t);
     }
     ssd1306_lcd.set_block(x1, y1, x2 - x1 + 1);
-    uint16_t count = (x2 - x1 + 1) * (y2 - y1 + 1);
-    while (count--)
-    {
-        ssd1306_lcd.send_pixels8( ssd1306_color );
-    }
+    ssd1306_fillPixelsEx8( ssd1306_color, (uint32_t)(x2 - x1 + 1) * (uint32_t)(y2 - y1 + 1) );
     ssd1306_intf.stop();
 }
 
@@ -269,11 +306,18 @@ void ssd1306_drawMonoBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_
 void ssd1306_drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h, const uint8_t *bitmap)
 {
     ssd1306_lcd.set_block(xpos, ypos, w);
-    uint32_t count = (w) * (h);
-    while (count--)
+    uint32_t count = (uint32_t)w * h;
+    if (ssd1306_lcd.send_pixels_buffer8)
+    {
+        ssd1306_sendProgmemPixels(ssd1306_lcd.send_pixels_buffer8, bitmap, count, 1);
+    }
+    else
     {
-        ssd1306_lcd.send_pixels8( pgm_read_byte( bitmap ) );
-        bitmap++;
+        while (count--)
+        {
+            ssd1306_lcd.send_pixels8( pgm_read_byte( bitmap ) );
+            bitmap++;
+        }
     }
     ssd1306_intf.stop();
 }
@@ -281,11 +325,7 @@ void ssd1306_drawBitmap8(lcdint_t xpos, lcdint_t ypos, lcduint_t w, lcduint_t h,
 void ssd1306_clearBlock8(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
 {
     ssd1306_lcd.set_block(x, y, w);
-    uint32_t count = w * h;
-    while (count--)
-    {
-        ssd1306_lcd.send_pixels8( 0x00 );
-    }
+    ssd1306_fillPixelsEx8( 0x00, (uint32_t)w * h );
     ssd1306_intf.stop();
 }
 
@@ -295,17 +335,46 @@ void ssd1306_setCursor8(lcduint_t x, lcduint_t y)
     ssd1306_cursorY = y;
 }
 
+/*
+ * Draws glyph of active font. Glyphs of rows fonts are sent as is, row by row.
+ * Pixels of anti-aliased fonts are taken from color ramp between background and color.
+ */
+static void ssd1306_drawGlyph8(lcdint_t x, lcdint_t y, const SCharInfo *info)
+{
+    if (!ssd1306_isRowsFont())
+    {
+        ssd1306_drawMonoBitmap8(x, y, info->width, info->height, info->glyph);
+        return;
+    }
+    uint8_t blackColor = s_ssd1306_invertByte ? ssd1306_color : 0x00;
+    uint8_t color = s_ssd1306_invertByte ? 0x00 : ssd1306_color;
+    SGlyphReader reader;
+    ssd1306_glyphReaderInit(&reader, info);
+    ssd1306_lcd.set_block(x, y, info->width);
+    uint16_t count = (uint16_t)info->width * info->height;
+    if ( ssd1306_isAlphaFont() )
+    {
+        uint8_t ramp[16];
+        ssd1306_alphaRamp8(ramp, blackColor, color);
+        for (; count > 0; count--)
+        {
+            ssd1306_lcd.send_pixels8( ramp[ssd1306_glyphReadAlpha(&reader)] );
+        }
+    }
+    for (; count > 0; count--)
+    {
+        ssd1306_lcd.send_pixels8( ssd1306_glyphReadPixel(&reader) ? color : blackColor );
+    }
+    ssd1306_intf.stop();
+}
+
 void ssd1306_printChar8(uint8_t c)
 {
     uint16_t unicode = ssd1306_unicode16FromUtf8(c);
     if (unicode == SSD1306_MORE_CHARS_REQUIRED) return;
     SCharInfo char_info;
     ssd1306_getCharBitmap(unicode, &char_info);
-    ssd1306_drawMonoBitmap8(ssd1306_cursorX,
-                ssd1306_cursorY,
-                char_info.width,
-                char_info.height,
-                char_info.glyph );
+    ssd1306_drawGlyph8(ssd1306_cursorX, ssd1306_cursorY, &char_info);
 }
 
 size_t ssd1306_write8(uint8_t ch)
@@ -333,11 +402,7 @@ size_t ssd1306_write8(uint8_t ch)
     if (unicode == SSD1306_MORE_CHARS_REQUIRED) return 0;
     SCharInfo char_info;
     ssd1306_getCharBitmap(unicode, &char_info);
-    ssd1306_drawMonoBitmap8( ssd1306_cursorX,
-                             ssd1306_cursorY,
-                             char_info.width,
-                             char_info.height,
-                             char_info.glyph);
+    ssd1306_drawGlyph8(ssd1306_cursorX, ssd1306_cursorY, &char_info);
     ssd1306_cursorX += char_info.width + char_info.spacing;
     return 1;
 }
@@ -353,11 +418,169 @@ size_t ssd1306_print8(const char ch[])
     return n;
 }
 
+/*
+ * Sends all chars of the run in one block, row by row. Spacing between chars is filled
+ * with background color.
+ */
+static void ssd1306_drawTextRun8(lcdint_t x, lcdint_t y, const STextRun *run)
+{
+    uint8_t blackColor = s_ssd1306_invertByte ? ssd1306_color : 0x00;
+    uint8_t color = s_ssd1306_invertByte ? 0x00 : ssd1306_color;
+    uint8_t rows = ssd1306_isRowsFont();
+    uint8_t alpha = ssd1306_isAlphaFont();
+    SGlyphReader readers[SSD1306_TEXT_RUN_SIZE];
+    uint8_t ramp[16];
+    for (uint8_t i = 0; rows && (i < run->count); i++)
+    {
+        ssd1306_glyphReaderInit(&readers[i], &run->chars[i]);
+    }
+    if ( alpha )
+    {
+        ssd1306_alphaRamp8(ramp, blackColor, color);
+    }
+    ssd1306_lcd.set_block(x, y, run->width);
+    for (uint8_t row = 0; row < run->height; row++)
+    {
+        uint8_t bit = 1 << (row & 0x07);
+        for (uint8_t i = 0; i < run->count; i++)
+        {
+            const SCharInfo *info = &run->chars[i];
+            if ( alpha )
+            {
+                for (uint8_t wx = info->width; wx > 0; wx--)
+                {
+                    ssd1306_lcd.send_pixels8( row < info->height ? ramp[ssd1306_glyphReadAlpha( &readers[i] )]
+                                                                : blackColor );
+                }
+            }
+            else if ( rows )
+            {
+                for (uint8_t wx = info->width; wx > 0; wx--)
+                {
+                    if ( (row < info->height) && ssd1306_glyphReadPixel( &readers[i] ) )
+                        ssd1306_lcd.send_pixels8( color );
+                    else
+                        ssd1306_lcd.send_pixels8( blackColor );
+                }
+            }
+            else
+            {
+                const uint8_t *glyph = &info->glyph[(row >> 3) * info->width];
+                for (uint8_t wx = info->width; wx > 0; wx--)
+                {
+                    if ( (row < info->height) && (pgm_read_byte( glyph ) & bit) )
+                        ssd1306_lcd.send_pixels8( color );
+                    else
+                        ssd1306_lcd.send_pixels8( blackColor );
+                    glyph++;
+                }
+            }
+            if (i + 1 < run->count)
+            {
+                for (uint8_t wx = info->spacing; wx > 0; wx--)
+                {
+                    ssd1306_lcd.send_pixels8( blackColor );
+                }
+            }
+        }
+    }
+    ssd1306_intf.stop();
+}
+
 uint8_t ssd1306_printFixed8(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style)
 {
+    uint8_t count = 0;
     ssd1306_cursorX = x;
     ssd1306_cursorY = y;
-    return ssd1306_print8(ch);
+    while (*ch)
+    {
+        if ( (*ch == '\r') || (*ch == '\n') )
+        {
+            ssd1306_write8(*ch);
+            ch++;
+            continue;
+        }
+        if ( ssd1306_cursorX > ssd1306_lcd.width - s_fixedFont.h.width )
+        {
+            ssd1306_write8('\n');
+        }
+        STextRun run;
+        ch += ssd1306_getTextRun(&run, ch, ssd1306_cursorX, ssd1306_lcd.width);
+        ssd1306_drawTextRun8(ssd1306_cursorX, ssd1306_cursorY, &run);
+        ssd1306_cursorX += run.width + run.spacing;
+        count += run.count;
+    }
+    return count;
+}
+
+/*
+ * Draws glyph, scaled 2^factor times. Each glyph row is sent 2^factor times, each
+ * glyph pixel is repeated 2^factor times, so no pixels are read back from display.
+ */
+static void ssd1306_drawGlyphN8(lcdint_t x, lcdint_t y, const SCharInfo *info, uint8_t factor)
+{
+    uint8_t blackColor = s_ssd1306_invertByte ? ssd1306_color : 0x00;
+    uint8_t color = s_ssd1306_invertByte ? 0x00 : ssd1306_color;
+    uint8_t rows = ssd1306_isRowsFont();
+    uint8_t scale = 1 << factor;
+    SGlyphReader reader;
+    ssd1306_glyphReaderInit(&reader, info);
+    ssd1306_lcd.set_block(x, y, (info->width + info->spacing) << factor);
+    for (uint8_t row = 0; row < info->height; row++)
+    {
+        SGlyphReader rowStart = reader;
+        const uint8_t *glyph = &info->glyph[(row >> 3) * info->width];
+        uint8_t bit = 1 << (row & 0x07);
+        for (uint8_t n = scale; n > 0; n--)
+        {
+            reader = rowStart;
+            for (uint8_t wx = 0; wx < info->width; wx++)
+            {
+                uint8_t set = rows ? ssd1306_glyphReadPixel(&reader) : (pgm_read_byte(&glyph[wx]) & bit);
+                for (uint8_t z = scale; z > 0; z--)
+                {
+                    ssd1306_lcd.send_pixels8( set ? color : blackColor );
+                }
+            }
+            for (uint8_t wx = info->spacing << factor; wx > 0; wx--)
+            {
+                ssd1306_lcd.send_pixels8( blackColor );
+            }
+        }
+    }
+    ssd1306_intf.stop();
+}
+
+uint8_t ssd1306_printFixedN8(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style, uint8_t factor)
+{
+    uint8_t count = 0;
+    ssd1306_cursorX = x;
+    ssd1306_cursorY = y;
+    for (; *ch; ch++)
+    {
+        if ( *ch == '\r' )
+        {
+            ssd1306_cursorX = x;
+            continue;
+        }
+        if ( (*ch == '\n') || (ssd1306_cursorX > ssd1306_lcd.width - (s_fixedFont.h.width << factor)) )
+        {
+            ssd1306_cursorX = x;
+            ssd1306_cursorY += s_fixedFont.h.height << factor;
+            if ( *ch == '\n' )
+            {
+                continue;
+            }
+        }
+        uint16_t unicode = ssd1306_unicode16FromUtf8(*ch);
+        if (unicode == SSD1306_MORE_CHARS_REQUIRED) continue;
+        SCharInfo char_info;
+        ssd1306_getCharBitmap(unicode, &char_info);
+        ssd1306_drawGlyphN8(ssd1306_cursorX, ssd1306_cursorY, &char_info, factor);
+        ssd1306_cursorX += (char_info.width + char_info.spacing) << factor;
+        count++;
+    }
+    return count;
 }
 
 
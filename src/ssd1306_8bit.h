@@ -123,6 +123,18 @@ void ssd1306_drawBufferFast8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, c
  */
 void ssd1306_drawBufferEx8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, lcduint_t pitch, const uint8_t *data);
 
+/**
+ * Fills w x h block with the color, using fill primitive of the display driver
+ * (hardware fill on SSD1331), so no pixel data is sent for the block.
+ *
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in pixels
+ * @param w - width of block in pixels
+ * @param h - height of block in pixels
+ * @param color - 8-bit color of the block
+ */
+void ssd1306_fillBlock8(lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, uint8_t color);
+
 /**
  * Fills screen with pattern byte
  *
@@ -304,9 +316,26 @@ size_t ssd1306_print8(const char ch[]);
  *
  * @see ssd1306_setFixedFont
  * @note set color with ssd1306_setColor() function.
+ * @note Chars of the line are sent to display in one block, so spacing between chars
+ *       is filled with background color.
  */
 uint8_t ssd1306_printFixed8(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style);
 
+/**
+ * Prints text to screen using fixed font, scaled 2^factor times.
+ * @param x horizontal position in pixels
+ * @param y vertical position in pixels
+ * @param ch NULL-terminated string to print
+ * @param style font style (EFontStyle), normal by default (not implemented).
+ * @param factor scaling factor: FONT_SIZE_NORMAL, FONT_SIZE_2X, FONT_SIZE_4X, FONT_SIZE_8X
+ * @returns number of chars in string
+ *
+ * @see ssd1306_setFixedFont
+ * @note set color with ssd1306_setColor() function.
+ * @note Text wraps to x position, when it doesn't fit display width.
+ */
+uint8_t ssd1306_printFixedN8(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style, uint8_t factor);
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
@@ -0,0 +1,225 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include "ssd1306_assets.h"
+
+#if defined(__linux__) && !defined(ARDUINO) && !defined(__KERNEL__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define ASSETS_MMAP_FILE
+#elif defined(SSD1306_ESP_PLATFORM)
+#include "esp_partition.h"
+#include "esp_spi_flash.h"
+#define ASSETS_MMAP_PARTITION
+#endif
+
+#define ASSETS_HEADER_SIZE  16
+#define ASSETS_ENTRY_SIZE   32
+#define ASSETS_VERSION      1
+
+static uint16_t assetRead16(const uint8_t *p)
+{
+    return pgm_read_byte(&p[0]) | (pgm_read_byte(&p[1]) << 8);
+}
+
+static uint32_t assetRead32(const uint8_t *p)
+{
+    return (uint32_t)assetRead16(p) | ((uint32_t)assetRead16(p + 2) << 16);
+}
+
+int ssd1306_assetPackOpen(SAssetPack *pack, const uint8_t *data, uint32_t size)
+{
+    pack->data = 0;
+    pack->count = 0;
+    pack->mapSize = 0;
+    pack->mapHandle = 0;
+    if ( (size && size < ASSETS_HEADER_SIZE) ||
+         pgm_read_byte(&data[0]) != 'S' || pgm_read_byte(&data[1]) != 'A' ||
+         pgm_read_byte(&data[2]) != 'P' || pgm_read_byte(&data[3]) != 'K' ||
+         pgm_read_byte(&data[4]) != ASSETS_VERSION )
+    {
+        return -1;
+    }
+    uint16_t count = assetRead16(&data[6]);
+    if ( size )
+    {
+        if ( (uint32_t)ASSETS_HEADER_SIZE + (uint32_t)count * ASSETS_ENTRY_SIZE > size )
+        {
+            return -1;
+        }
+        for (uint16_t i = 0; i < count; i++)
+        {
+            const uint8_t *entry = &data[ASSETS_HEADER_SIZE + (uint32_t)i * ASSETS_ENTRY_SIZE];
+            uint32_t offset = assetRead32(&entry[24]);
+            uint32_t len = assetRead32(&entry[28]);
+            if ( offset > size || len > size - offset )
+            {
+                return -1;
+            }
+        }
+    }
+    pack->data = data;
+    pack->count = count;
+    return 0;
+}
+
+const uint8_t *ssd1306_assetAt(const SAssetPack *pack, uint16_t index, SAssetInfo *info)
+{
+    if ( index >= pack->count )
+    {
+        return 0;
+    }
+    const uint8_t *entry = &pack->data[ASSETS_HEADER_SIZE + (uint32_t)index * ASSETS_ENTRY_SIZE];
+    const uint8_t *data = pack->data + assetRead32(&entry[24]);
+    if ( info )
+    {
+        info->data = data;
+        info->size = assetRead32(&entry[28]);
+        info->width = assetRead16(&entry[18]);
+        info->height = assetRead16(&entry[20]);
+        info->type = pgm_read_byte(&entry[16]);
+        info->flags = pgm_read_byte(&entry[17]);
+    }
+    return data;
+}
+
+const uint8_t *ssd1306_assetFind(const SAssetPack *pack, const char *name, SAssetInfo *info)
+{
+    for (uint16_t i = 0; i < pack->count; i++)
+    {
+        const uint8_t *entry = &pack->data[ASSETS_HEADER_SIZE + (uint32_t)i * ASSETS_ENTRY_SIZE];
+        uint8_t n = 0;
+        /* Names in the index are zero-padded, but not terminated, if they are 16 chars long */
+        while ( n < SSD1306_ASSET_NAME_LEN && name[n] && (char)pgm_read_byte(&entry[n]) == name[n] )
+        {
+            n++;
+        }
+        if ( !name[n] && (n == SSD1306_ASSET_NAME_LEN || !pgm_read_byte(&entry[n])) )
+        {
+            return ssd1306_assetAt(pack, i, info);
+        }
+    }
+    return 0;
+}
+
+#if defined(ASSETS_MMAP_FILE)
+
+int ssd1306_assetPackMapFile(SAssetPack *pack, const char *path)
+{
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if ( fd < 0 )
+    {
+        return -1;
+    }
+    if ( fstat(fd, &st) < 0 || st.st_size < ASSETS_HEADER_SIZE )
+    {
+        close(fd);
+        return -1;
+    }
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if ( data == MAP_FAILED )
+    {
+        return -1;
+    }
+    if ( ssd1306_assetPackOpen(pack, (const uint8_t *)data, st.st_size) < 0 )
+    {
+        munmap(data, st.st_size);
+        return -1;
+    }
+    pack->mapSize = st.st_size;
+    return 0;
+}
+
+#else
+
+int ssd1306_assetPackMapFile(SAssetPack *pack, const char *path)
+{
+    (void)path;
+    pack->data = 0;
+    pack->count = 0;
+    pack->mapSize = 0;
+    return -1;
+}
+
+#endif
+
+#if defined(ASSETS_MMAP_PARTITION)
+
+int ssd1306_assetPackMapPartition(SAssetPack *pack, const char *label)
+{
+    const void *data;
+    spi_flash_mmap_handle_t handle;
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           ESP_PARTITION_SUBTYPE_ANY, label);
+    if ( !part )
+    {
+        return -1;
+    }
+    if ( esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &data, &handle) != ESP_OK )
+    {
+        return -1;
+    }
+    if ( ssd1306_assetPackOpen(pack, (const uint8_t *)data, part->size) < 0 )
+    {
+        spi_flash_munmap(handle);
+        return -1;
+    }
+    pack->mapSize = part->size;
+    pack->mapHandle = handle;
+    return 0;
+}
+
+#else
+
+int ssd1306_assetPackMapPartition(SAssetPack *pack, const char *label)
+{
+    (void)label;
+    pack->data = 0;
+    pack->count = 0;
+    pack->mapSize = 0;
+    return -1;
+}
+
+#endif
+
+void ssd1306_assetPackClose(SAssetPack *pack)
+{
+    if ( pack->mapSize )
+    {
+#if defined(ASSETS_MMAP_FILE)
+        munmap((void *)pack->data, pack->mapSize);
+#elif defined(ASSETS_MMAP_PARTITION)
+        spi_flash_munmap(pack->mapHandle);
+#endif
+    }
+    pack->data = 0;
+    pack->count = 0;
+    pack->mapSize = 0;
+    pack->mapHandle = 0;
+}
@@ -0,0 +1,175 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/**
+ * @file ssd1306_assets.h Asset pack: fonts, bitmaps and sprite sheets in single blob
+ */
+
+#ifndef _SSD1306_ASSETS_H_
+#define _SSD1306_ASSETS_H_
+
+#include "ssd1306_hal/io.h"
+#include "nano_gfx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_ASSETS_API ASSETS: Asset pack access
+ * @{
+ *
+ * @brief Fonts, bitmaps and sprite sheets, packed to single blob by tools/assetpack.py
+ *
+ * @details Asset pack is single binary blob with index and data of all assets (see
+ *          tools/format.txt). Every asset is stored exactly in the same format as
+ *          PROGMEM arrays, generated by other tools, so pointers, returned by
+ *          ssd1306_assetFind() can be passed directly to ssd1306_setFixedFont(),
+ *          ssd1306_drawBitmap(), ssd1306_drawCompressedBitmap() and other functions
+ *          without copying data to RAM. The pack can be compiled in as PROGMEM array
+ *          (assetpack.py -c), mapped from the file on Linux or mapped from flash
+ *          data partition on ESP32.
+ */
+
+/** Raw data blob */
+#define SSD1306_ASSET_RAW           0
+/** Font in any format, supported by ssd1306_setFixedFont() and ssd1306_setFreeFont() */
+#define SSD1306_ASSET_FONT          1
+/** Monochrome bitmap in native ssd1306 format */
+#define SSD1306_ASSET_BITMAP1       2
+/** 8-bit RGB bitmap */
+#define SSD1306_ASSET_BITMAP8       3
+/** 16-bit RGB565 bitmap */
+#define SSD1306_ASSET_BITMAP16      4
+/** Sprite sheet, generated by tools/spritesheet.py */
+#define SSD1306_ASSET_SPRITE_SHEET  5
+
+/** Asset data are compressed by tools/bitmapcompress.py */
+#define SSD1306_ASSET_FLAG_COMPRESSED  0x01
+
+/** Maximum length of asset name */
+#define SSD1306_ASSET_NAME_LEN      16
+
+/**
+ * Opened asset pack
+ */
+typedef struct
+{
+    /// pointer to the start of the pack (Flash or mapped memory)
+    const uint8_t *data;
+    /// number of assets in the pack
+    uint16_t count;
+    /// size of mapped area, 0 if pack is not mapped by the library
+    uint32_t mapSize;
+    /// platform specific handle of mapped area
+    uint32_t mapHandle;
+} SAssetPack;
+
+/**
+ * Asset description
+ */
+typedef struct
+{
+    /// pointer to asset data inside the pack
+    const uint8_t *data;
+    /// size of asset data in bytes
+    uint32_t size;
+    /// width of bitmap or frame in pixels, 0 for fonts and raw data
+    uint16_t width;
+    /// height of bitmap or frame in pixels, 0 for fonts and raw data
+    uint16_t height;
+    /// asset type: SSD1306_ASSET_RAW, SSD1306_ASSET_FONT, ...
+    uint8_t type;
+    /// asset flags: SSD1306_ASSET_FLAG_COMPRESSED
+    uint8_t flags;
+} SAssetInfo;
+
+/**
+ * Opens asset pack, located in Flash or in RAM. The data are not copied.
+ *
+ * @param pack pointer to pack structure to initialize
+ * @param data pointer to asset pack data
+ * @param size size of the pack in bytes or 0 if unknown. If size is specified,
+ *        index entries, pointing outside the pack, are rejected.
+ * @return 0 on success, -1 if data is not valid asset pack
+ */
+int ssd1306_assetPackOpen(SAssetPack *pack, const uint8_t *data, uint32_t size);
+
+/**
+ * Maps asset pack file to the memory (Linux only). Asset data are read
+ * directly from the page cache, no copy is made.
+ *
+ * @param pack pointer to pack structure to initialize
+ * @param path path to the pack file
+ * @return 0 on success, -1 on error
+ */
+int ssd1306_assetPackMapFile(SAssetPack *pack, const char *path);
+
+/**
+ * Maps asset pack from flash data partition (ESP32 only), so assets are
+ * read through flash cache without copying them to RAM.
+ *
+ * @param pack pointer to pack structure to initialize
+ * @param label label of data partition, containing the pack
+ * @return 0 on success, -1 on error
+ */
+int ssd1306_assetPackMapPartition(SAssetPack *pack, const char *label);
+
+/**
+ * Releases mapped asset pack. Pointers to asset data become invalid.
+ * Does nothing for packs, opened by ssd1306_assetPackOpen().
+ *
+ * @param pack pointer to opened pack
+ */
+void ssd1306_assetPackClose(SAssetPack *pack);
+
+/**
+ * Returns description of asset by its index.
+ *
+ * @param pack pointer to opened pack
+ * @param index index of asset from 0 to pack->count - 1
+ * @param info pointer to structure to fill, can be NULL
+ * @return pointer to asset data or NULL if index is out of range
+ */
+const uint8_t *ssd1306_assetAt(const SAssetPack *pack, uint16_t index, SAssetInfo *info);
+
+/**
+ * Looks up asset by name.
+ *
+ * @param pack pointer to opened pack
+ * @param name asset name
+ * @param info pointer to structure to fill, can be NULL
+ * @return pointer to asset data or NULL if asset is not found
+ */
+const uint8_t *ssd1306_assetFind(const SAssetPack *pack, const char *name, SAssetInfo *info);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SSD1306_ASSETS_H_
@@ -26,7 +26,6 @@
 
 extern lcduint_t ssd1306_cursorX;
 extern lcduint_t ssd1306_cursorY;
-extern SFixedFontInfo s_fixedFont;
 
 #define SSD1306_MAX_SCAN_LINES  64
 
@@ -78,6 +77,141 @@ size_t ssd1306_consoleWriter(uint8_t ch)
     return 1;
 }
 
+uint8_t ssd1306_consolePrintLine(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style)
+{
+    return ssd1306_printFixed(x, y, ch, style);
+}
+
+void ssd1306_textModeDrawCells(uint8_t col, uint8_t row, const uint8_t *cells, uint8_t count, uint32_t inverse)
+{
+    uint8_t width = s_fixedFont.h.width;
+    uint8_t pages = s_fixedFont.h.height >> 3;
+    ssd1306_lcd.set_block((lcduint_t)col * width, (lcduint_t)row * pages, (lcduint_t)count * width);
+    for (uint8_t page = 0; page < pages; page++)
+    {
+        uint32_t mask = inverse;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            SCharInfo char_info;
+            ssd1306_getCharBitmap(cells[i], &char_info);
+            uint8_t invert = (mask & 1) ? 0xFF : 0x00;
+            const uint8_t *glyph = &char_info.glyph[page * char_info.width];
+            for (uint8_t x = 0; x < width; x++)
+            {
+                uint8_t data = x < char_info.width ? pgm_read_byte(&glyph[x]) : 0x00;
+                ssd1306_lcdSendPixels1(data ^ invert);
+            }
+            mask >>= 1;
+        }
+        ssd1306_lcd.next_page();
+    }
+    ssd1306_intf.stop();
+}
+
+/* GDRAM line, displayed at the top of the screen by 16-bit console */
+static lcduint_t s_consoleStartLine = 0;
+
+size_t ssd1306_consoleWriter16(uint8_t ch)
+{
+    if (ch == '\r')
+    {
+        ssd1306_cursorX = 0;
+        return 0;
+    }
+    else if ( (ssd1306_cursorX > ssd1306_lcd.width - s_fixedFont.h.width) || (ch == '\n') )
+    {
+        ssd1306_cursorX = 0;
+        ssd1306_cursorY += s_fixedFont.h.height;
+        if ( ssd1306_lcd.set_start_line && !(ssd1306_lcd.height % s_fixedFont.h.height) )
+        {
+            /* Hardware scrolling: GDRAM wraps around, so the new line replaces the top one */
+            if ( ssd1306_cursorY >= ssd1306_lcd.height )
+            {
+                ssd1306_cursorY -= ssd1306_lcd.height;
+            }
+            if ( ssd1306_cursorY == s_consoleStartLine )
+            {
+                s_consoleStartLine += s_fixedFont.h.height;
+                if ( s_consoleStartLine >= ssd1306_lcd.height )
+                {
+                    s_consoleStartLine -= ssd1306_lcd.height;
+                }
+                ssd1306_lcd.set_start_line( s_consoleStartLine );
+            }
+        }
+        else if ( ssd1306_cursorY > ssd1306_lcd.height - s_fixedFont.h.height )
+        {
+            ssd1306_cursorY = 0;
+        }
+        ssd1306_clearBlock16(0, ssd1306_cursorY, ssd1306_lcd.width, s_fixedFont.h.height);
+        if (ch == '\n')
+        {
+            return 0;
+        }
+    }
+    uint16_t unicode = ssd1306_unicode16FromUtf8(ch);
+    if (unicode == SSD1306_MORE_CHARS_REQUIRED) return 0;
+    SCharInfo char_info;
+    ssd1306_getCharBitmap(unicode, &char_info);
+    ssd1306_drawMonoBitmap16( ssd1306_cursorX,
+                              ssd1306_cursorY,
+                              char_info.width,
+                              char_info.height,
+                              char_info.glyph );
+    ssd1306_cursorX += char_info.width + char_info.spacing;
+    return 1;
+}
+
+/*
+ * Collects ASCII chars, which fit the current line, to runs and draws each run in one
+ * block. Line feeds, wrapping and utf8 sequences are passed to single char writer.
+ */
+static size_t ssd1306_consoleWriteRuns(const uint8_t *buffer, size_t size, LcdWriter writer,
+                                       void (*draw)(lcdint_t x, lcdint_t y, const STextRun *run))
+{
+    size_t n = 0;
+    while (size)
+    {
+        char text[SSD1306_TEXT_RUN_SIZE + 1];
+        uint8_t len = 0;
+        if ( !(ssd1306_cursorX > ssd1306_lcd.width - s_fixedFont.h.width) )
+        {
+            while ( (len < size) && (len < SSD1306_TEXT_RUN_SIZE) &&
+                    (buffer[len] >= ' ') && (buffer[len] < 0x80) )
+            {
+                text[len] = buffer[len];
+                len++;
+            }
+        }
+        if ( !len )
+        {
+            n += writer(*buffer);
+            buffer++;
+            size--;
+            continue;
+        }
+        text[len] = '\0';
+        STextRun run;
+        len = ssd1306_getTextRun(&run, text, ssd1306_cursorX, ssd1306_lcd.width);
+        draw(ssd1306_cursorX, ssd1306_cursorY, &run);
+        ssd1306_cursorX += run.width + run.spacing;
+        n += run.count;
+        buffer += len;
+        size -= len;
+    }
+    return n;
+}
+
+size_t ssd1306_consoleWrite(const uint8_t *buffer, size_t size)
+{
+    return ssd1306_consoleWriteRuns(buffer, size, ssd1306_consoleWriter, ssd1306_drawTextRun);
+}
+
+size_t ssd1306_consoleWrite16(const uint8_t *buffer, size_t size)
+{
+    return ssd1306_consoleWriteRuns(buffer, size, ssd1306_consoleWriter16, ssd1306_drawTextRun16);
+}
+
 void Ssd1306Console::clear()
 {
     ssd1306_clearScreen();
@@ -89,3 +223,19 @@ void Ssd1306Console::setCursor(lcduint_t x, lcduint_t y)
     ssd1306_setCursor8(x,y);
 }
 
+void Ssd1306Console16::clear()
+{
+    ssd1306_clearScreen16();
+    if ( ssd1306_lcd.set_start_line )
+    {
+        ssd1306_lcd.set_start_line( 0 );
+    }
+    s_consoleStartLine = 0;
+    setCursor(0,0);
+}
+
+void Ssd1306Console16::setCursor(lcduint_t x, lcduint_t y)
+{
+    ssd1306_setCursor16(x,y);
+}
+
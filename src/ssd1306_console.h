@@ -32,6 +32,8 @@
 #include "ssd1306_hal/io.h"
 #include "ssd1306_hal/Print_internal.h"
 
+extern "C" SFixedFontInfo s_fixedFont;
+
 /**
  * Callback function to print text to the LCD display
  */
@@ -76,6 +78,16 @@ private:
  */
 size_t ssd1306_consoleWriter(uint8_t ch);
 
+/**
+ * Prints buffer to ssd1306 console. Chars, which fit the current line, are
+ * collected to runs, and each run is sent to the display via single window.
+ * Line feeds and wrapping work as in ssd1306_consoleWriter().
+ * @param buffer chars to print
+ * @param size number of chars in the buffer
+ * @return number of printed chars
+ */
+size_t ssd1306_consoleWrite(const uint8_t *buffer, size_t size);
+
 /**
  * Ssd1306Console represents object to work with LCD display.
  * Easy to use:
@@ -93,6 +105,17 @@ class Ssd1306Console: public LcdConsole<ssd1306_consoleWriter>
 {
 public:
     using LcdConsole::LcdConsole;
+    using LcdConsole::write;
+
+    /**
+     * Writes buffer to the display, sending runs of chars via single window.
+     * @param buffer - chars to write
+     * @param size - number of chars to write
+     */
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        return ssd1306_consoleWrite(buffer, size);
+    }
 
     /**
      * Fills screen with zero-byte and sets
@@ -112,5 +135,468 @@ private:
 
 };
 
+/**
+ * Callback function to print line of text to the LCD display, like ssd1306_printFixed8()
+ */
+typedef uint8_t (*LcdLinePrinter)(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style);
+
+/**
+ * Prints line of text to monochrome display via ssd1306_printFixed().
+ * @param x horizontal position in pixels
+ * @param y vertical position in pixels
+ * @param ch NULL-terminated string to print
+ * @param style font style
+ * @returns number of chars in string
+ */
+uint8_t ssd1306_consolePrintLine(lcdint_t x, lcdint_t y, const char *ch, EFontStyle style);
+
+/**
+ * Buffered console keeps text in RAM ring of ROWS lines of COLS chars each. Writing to
+ * the console only updates RAM and marks changed lines. Changed lines are sent to the
+ * display by update(), which should be called from main loop or engine frame: bursts of
+ * output are drawn once, and the producer is not blocked by the bus. Each changed line
+ * is printed as a whole via printer P, padded with spaces to COLS chars, so old text is
+ * overwritten without clearing. Lines are counted in bytes, thus utf8 strings wrap
+ * earlier than ascii ones.
+ *
+ * ~~~~~~~~~~~~~~~{.cpp}
+ * LcdBufferedConsole<21, 8, ssd1306_consolePrintLine> console;
+ * void loop()
+ * {
+ *      console.println( millis() );
+ *      console.update();
+ * }
+ * ~~~~~~~~~~~~~~~
+ */
+template <uint8_t COLS, uint8_t ROWS, LcdLinePrinter P>
+class LcdBufferedConsole: public Print
+{
+public:
+    /**
+     * Creates buffered console.
+     * @param intervalMs minimal interval between display updates in milliseconds
+     */
+    explicit LcdBufferedConsole(uint16_t intervalMs = 0): m_interval( intervalMs )
+    {
+        clear();
+    }
+
+    /**
+     * Sets minimal interval between display updates.
+     * @param intervalMs interval in milliseconds, 0 to draw changes on each update() call.
+     */
+    void setRefreshInterval(uint16_t intervalMs)
+    {
+        m_interval = intervalMs;
+    }
+
+    /**
+     * Clears text buffer. Display content is replaced with empty lines on next update().
+     */
+    void clear()
+    {
+        for (uint8_t row = 0; row < ROWS; row++)
+        {
+            clearLine( row );
+        }
+        m_first = 0;
+        m_row = 0;
+        m_col = 0;
+        markAll();
+    }
+
+    /**
+     * Writes single character to text buffer.
+     * @param ch - character to write
+     */
+    size_t write(uint8_t ch) override
+    {
+        if (ch == '\r')
+        {
+            m_col = 0;
+            return 0;
+        }
+        if ( (ch == '\n') || (m_col >= COLS) )
+        {
+            newLine();
+            if (ch == '\n')
+            {
+                return 0;
+            }
+        }
+        uint8_t index = lineIndex( m_row );
+        m_text[index][m_col++] = ch;
+        m_dirty[index >> 3] |= (1 << (index & 0x07));
+        return 1;
+    }
+
+    /**
+     * Sends changed lines to the display, if refresh interval has passed since last update.
+     * @param force true to send changed lines regardless of refresh interval
+     * @return true if changed lines were sent
+     */
+    bool update(bool force = false)
+    {
+        uint32_t ts = millis();
+        if ( !force && m_interval && ((uint32_t)(ts - m_lastUpdate) < m_interval) )
+        {
+            return false;
+        }
+        m_lastUpdate = ts;
+        for (uint8_t row = 0; row < ROWS; row++)
+        {
+            uint8_t index = lineIndex( row );
+            if ( m_dirty[index >> 3] & (1 << (index & 0x07)) )
+            {
+                m_dirty[index >> 3] &= ~(1 << (index & 0x07));
+                P( 0, (lcdint_t)row * s_fixedFont.h.height, m_text[index], STYLE_NORMAL );
+            }
+        }
+        return true;
+    }
+
+private:
+    char m_text[ROWS][COLS + 1];
+    uint8_t m_dirty[(ROWS + 7) >> 3];
+    uint8_t m_first;
+    uint8_t m_row;
+    uint8_t m_col;
+    uint16_t m_interval;
+    uint32_t m_lastUpdate = 0;
+
+    uint8_t lineIndex(uint8_t row)
+    {
+        row += m_first;
+        return row >= ROWS ? row - ROWS : row;
+    }
+
+    void clearLine(uint8_t index)
+    {
+        for (uint8_t i = 0; i < COLS; i++)
+        {
+            m_text[index][i] = ' ';
+        }
+        m_text[index][COLS] = '\0';
+    }
+
+    void markAll()
+    {
+        for (uint8_t i = 0; i < sizeof(m_dirty); i++)
+        {
+            m_dirty[i] = 0xFF;
+        }
+    }
+
+    void newLine()
+    {
+        m_col = 0;
+        if ( m_row + 1 < ROWS )
+        {
+            m_row++;
+            return;
+        }
+        /* The top line leaves the ring and becomes new bottom line, all lines are moved */
+        clearLine( m_first );
+        m_first = lineIndex( 1 );
+        markAll();
+    }
+};
+
+/** Text mode cell attribute: normal text */
+#define TEXT_ATTR_NORMAL   0x00
+/** Text mode cell attribute: inverse text */
+#define TEXT_ATTR_INVERSE  0x01
+
+/**
+ * Draws run of text mode cells on monochrome display via single window.
+ * Each cell takes s_fixedFont.h.width pixels, narrow glyphs are padded with blank columns.
+ * @param col column of the first cell
+ * @param row row of the cells
+ * @param cells chars of the cells
+ * @param count number of cells in the run
+ * @param inverse inverse attributes of the cells, bit 0 is for the first cell
+ */
+void ssd1306_textModeDrawCells(uint8_t col, uint8_t row, const uint8_t *cells, uint8_t count, uint32_t inverse);
+
+/**
+ * Text mode keeps screen as COLS x ROWS grid of chars with attributes in RAM (21x8 cells
+ * of 6x8 font for 128x64 display take 168 bytes of chars plus 8 bytes per row for flags),
+ * instead of full frame buffer. Writes only update the grid and mark cells, which
+ * really change. flush() sends changed cells only: contiguous changed cells of the row
+ * are sent via single display window. Cell size is taken from active fixed font, font
+ * height must be multiple of 8. Chars are stored as 8-bit codes: utf8 input is decoded,
+ * codes above 255 are replaced with '?'.
+ *
+ * ~~~~~~~~~~~~~~~{.cpp}
+ * LcdTextMode<21, 8> screen;
+ * void loop()
+ * {
+ *      screen.setCursor(0, 2);
+ *      screen.print( millis() );
+ *      screen.flush();
+ * }
+ * ~~~~~~~~~~~~~~~
+ */
+template <uint8_t COLS, uint8_t ROWS>
+class LcdTextMode: public Print
+{
+    static_assert(COLS <= 32, "Text mode supports up to 32 columns");
+
+public:
+    /**
+     * Creates text mode screen. All cells are blank and will be sent on first flush().
+     */
+    LcdTextMode()
+    {
+        for (uint8_t row = 0; row < ROWS; row++)
+        {
+            for (uint8_t col = 0; col < COLS; col++)
+            {
+                m_cells[row][col] = ' ';
+            }
+        }
+        invalidate();
+    }
+
+    /**
+     * Fills all cells with spaces of normal attribute and moves cursor to top-left cell.
+     * Only cells, which were not blank, are sent on next flush().
+     */
+    void clear()
+    {
+        for (uint8_t row = 0; row < ROWS; row++)
+        {
+            for (uint8_t col = 0; col < COLS; col++)
+            {
+                putChar(col, row, ' ', TEXT_ATTR_NORMAL);
+            }
+        }
+        m_col = 0;
+        m_row = 0;
+    }
+
+    /**
+     * Marks all cells as changed, so next flush() redraws whole screen. Use it
+     * after display content was changed by other functions.
+     */
+    void invalidate()
+    {
+        for (uint8_t row = 0; row < ROWS; row++)
+        {
+            m_dirty[row] = ALL_CELLS;
+        }
+    }
+
+    /**
+     * Sets cursor position for write() in cells.
+     * @param col column [0, COLS-1]
+     * @param row row [0, ROWS-1]
+     */
+    void setCursor(uint8_t col, uint8_t row)
+    {
+        m_col = col;
+        m_row = row;
+    }
+
+    /**
+     * Sets attribute for chars, printed by write().
+     * @param attr TEXT_ATTR_NORMAL or TEXT_ATTR_INVERSE
+     */
+    void setAttribute(uint8_t attr)
+    {
+        m_attr = attr;
+    }
+
+    /**
+     * Puts char to specified cell. The cell is marked changed only if char or
+     * attribute is different.
+     * @param col column [0, COLS-1]
+     * @param row row [0, ROWS-1]
+     * @param ch 8-bit char code
+     * @param attr TEXT_ATTR_NORMAL or TEXT_ATTR_INVERSE
+     */
+    void putChar(uint8_t col, uint8_t row, uint8_t ch, uint8_t attr)
+    {
+        if ( (col >= COLS) || (row >= ROWS) )
+        {
+            return;
+        }
+        uint32_t bit = (uint32_t)1 << col;
+        uint32_t inverse = (attr & TEXT_ATTR_INVERSE) ? bit : 0;
+        if ( (m_cells[row][col] != ch) || ((m_inverse[row] & bit) != inverse) )
+        {
+            m_cells[row][col] = ch;
+            m_inverse[row] = (m_inverse[row] & ~bit) | inverse;
+            m_dirty[row] |= bit;
+        }
+    }
+
+    /**
+     * Returns char of specified cell.
+     * @param col column [0, COLS-1]
+     * @param row row [0, ROWS-1]
+     */
+    uint8_t getChar(uint8_t col, uint8_t row) const
+    {
+        return m_cells[row][col];
+    }
+
+    /**
+     * Writes single character at cursor position. Cursor wraps to the next row at the
+     * end of the row, and the grid scrolls up after the last row.
+     * @param ch - character to write
+     */
+    size_t write(uint8_t ch) override
+    {
+        if (ch == '\r')
+        {
+            m_col = 0;
+            return 0;
+        }
+        if ( (ch == '\n') || (m_col >= COLS) )
+        {
+            newLine();
+            if (ch == '\n')
+            {
+                return 0;
+            }
+        }
+        uint16_t unicode = ssd1306_unicode16FromUtf8Ex(&m_utf8State, ch);
+        if (unicode == SSD1306_MORE_CHARS_REQUIRED) return 0;
+        putChar(m_col++, m_row, unicode > 0xFF ? '?' : (uint8_t)unicode, m_attr);
+        return 1;
+    }
+
+    /**
+     * Sends changed cells to the display.
+     */
+    void flush()
+    {
+        for (uint8_t row = 0; row < ROWS; row++)
+        {
+            uint32_t dirty = m_dirty[row];
+            m_dirty[row] = 0;
+            uint8_t col = 0;
+            while ( dirty )
+            {
+                while ( !(dirty & 1) )
+                {
+                    dirty >>= 1;
+                    col++;
+                }
+                uint8_t count = 0;
+                while ( dirty & 1 )
+                {
+                    dirty >>= 1;
+                    count++;
+                }
+                ssd1306_textModeDrawCells(col, row, &m_cells[row][col], count, m_inverse[row] >> col);
+                col += count;
+            }
+        }
+    }
+
+private:
+    static const uint32_t ALL_CELLS = (uint32_t)0xFFFFFFFF >> (32 - COLS);
+
+    uint8_t  m_cells[ROWS][COLS];
+    uint32_t m_inverse[ROWS] = {};
+    uint32_t m_dirty[ROWS] = {};
+    uint32_t m_utf8State = 0;
+    uint8_t  m_col = 0;
+    uint8_t  m_row = 0;
+    uint8_t  m_attr = TEXT_ATTR_NORMAL;
+
+    void newLine()
+    {
+        m_col = 0;
+        if ( m_row + 1 < ROWS )
+        {
+            m_row++;
+            return;
+        }
+        /* Rows are moved up cell by cell, so only cells, which really change, are sent */
+        for (uint8_t row = 0; row + 1 < ROWS; row++)
+        {
+            for (uint8_t col = 0; col < COLS; col++)
+            {
+                putChar(col, row, m_cells[row + 1][col],
+                        (m_inverse[row + 1] >> col) & 1 ? TEXT_ATTR_INVERSE : TEXT_ATTR_NORMAL);
+            }
+        }
+        for (uint8_t col = 0; col < COLS; col++)
+        {
+            putChar(col, ROWS - 1, ' ', TEXT_ATTR_NORMAL);
+        }
+    }
+};
+
+/**
+ * Console support function for RGB displays in 16-bit mode.
+ * If display controller supports hardware scrolling (ssd1306_lcd.set_start_line),
+ * and display height is multiple of font height, the console scrolls display content
+ * in hardware, and only new line is cleared and drawn. Otherwise, the console
+ * continues printing from the top of the screen.
+ * @param ch character to print
+ */
+size_t ssd1306_consoleWriter16(uint8_t ch);
+
+/**
+ * Prints buffer to 16-bit console. Chars, which fit the current line, are
+ * collected to runs, and each run is sent to the display via single window.
+ * Line feeds, wrapping and scrolling work as in ssd1306_consoleWriter16().
+ * @param buffer chars to print
+ * @param size number of chars in the buffer
+ * @return number of printed chars
+ */
+size_t ssd1306_consoleWrite16(const uint8_t *buffer, size_t size);
+
+/**
+ * Ssd1306Console16 represents console on RGB display in 16-bit mode (ssd1351, ili9341).
+ * ~~~~~~~~~~~~~~~{.cpp}
+ * Ssd1306Console16  console;
+ * void setup()
+ * {
+ *      ssd1351_128x128_spi_init(3, 4, 5);
+ *      ssd1306_setMode(LCD_MODE_NORMAL);
+ *      console.clear();
+ *      console.print( "Hello" );
+ * }
+ * ~~~~~~~~~~~~~~~
+ */
+class Ssd1306Console16: public LcdConsole<ssd1306_consoleWriter16>
+{
+public:
+    using LcdConsole::LcdConsole;
+    using LcdConsole::write;
+
+    /**
+     * Writes buffer to the display, sending runs of chars via single window.
+     * @param buffer - chars to write
+     * @param size - number of chars to write
+     */
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        return ssd1306_consoleWrite16(buffer, size);
+    }
+
+    /**
+     * Fills screen with black color, resets hardware scrolling and sets
+     * cursor position to top-left corner of the screen.
+     */
+    void   clear();
+
+    /**
+     * Set cursor position for text functions
+     *
+     * @param x horizontal position in pixels.
+     * @param y vertical position in GDRAM rows.
+     */
+    void   setCursor(lcduint_t x, lcduint_t y);
+
+private:
+
+};
+
 #endif
 
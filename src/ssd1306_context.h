@@ -0,0 +1,143 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+/**
+ * @file ssd1306_context.h Display contexts to drive several displays at once
+ */
+
+#ifndef _SSD1306_CONTEXT_H_
+#define _SSD1306_CONTEXT_H_
+
+#include "nano_gfx_types.h"
+#include "intf/ssd1306_interface.h"
+#include "lcd/lcd_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_CONTEXT_API DIRECT DRAW: Display contexts
+ * @{
+ * @brief Functions to switch the library between several displays.
+ *
+ * @details All direct draw functions work with active display: interface (ssd1306_intf),
+ *          display driver (ssd1306_lcd), color, cursor and font. Display context holds
+ *          a copy of that state for one display. Initialize each display as usual, and
+ *          save its state to own context right after init function. Then select context
+ *          before drawing to the display:
+ * @code{.c}
+ * SSD1306Context left, right;
+ *
+ * ssd1306_128x64_spi_init(-1, 4, 5);     // first display uses CS pin 4
+ * ssd1306_contextInit(&left);
+ * ssd1351_128x128_spi_init(-1, 3, 5);    // second display uses CS pin 3
+ * ssd1306_contextInit(&right);
+ *
+ * ssd1306_contextSelect(&left);
+ * ssd1306_clearScreen();
+ * ssd1306_contextSelect(&right);
+ * ssd1306_setColor(RGB_COLOR16(255,0,0));
+ * ssd1306_clearScreen16();
+ * @endcode
+ *
+ * @warning Only state, exported by the library, is switched. Some display drivers and
+ *          platform interfaces keep private state (i2c address and device handle of
+ *          Linux, ESP and Arduino i2c, rotation of RGB displays, mirror interface).
+ *          So displays, using the same interface type, can be combined only via SPI
+ *          with different CS pins, or hardware and software interfaces of different
+ *          types (for example, hardware i2c and software i2c).
+ */
+
+/**
+ * Holds state of the library for single display.
+ * @warning Fields are for internal use only. Use ssd1306_contextInit() and
+ *          ssd1306_contextSelect() to work with contexts.
+ */
+typedef struct
+{
+    /** interface of the display */
+    ssd1306_interface_t intf;
+    /** display driver and dimensions */
+    ssd1306_lcd_t lcd;
+    /** current color for direct draw functions */
+    uint16_t color;
+    /** mask to invert 1-bit output */
+    uint8_t invertByte;
+    /** cursor position for text print functions */
+    lcduint_t cursorX;
+    /** cursor position for text print functions */
+    lcduint_t cursorY;
+    /** current font */
+    SFixedFontInfo font;
+    /** glyph decoder of the font */
+    void (*getCharBitmap)(uint16_t unicode, SCharInfo *info);
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+    /** non-zero if utf-8 decoding is enabled */
+    uint8_t unicode;
+#endif
+    /** chip select pin of spi interface */
+    int8_t cs;
+    /** data/command pin of spi interface */
+    int8_t dc;
+    /** spi clock frequency */
+    uint32_t spiClock;
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+    /** interface statistics of the display */
+    ssd1306_intf_stats_state_t stats;
+#endif
+#ifdef CONFIG_SSD1306_WINDOW_CACHE_ENABLE
+    /** functions, wrapped by window cache for the display */
+    ssd1306_window_cache_t window;
+#endif
+} SSD1306Context;
+
+/**
+ * Saves state of last initialized display to the context and makes the context
+ * active. Call this function right after display init function.
+ * @param ctx context to initialize
+ */
+void ssd1306_contextInit(SSD1306Context *ctx);
+
+/**
+ * Makes context active: saves state of currently active display (color, cursor,
+ * font and etc.) to its context and restores the state of the display, holding by ctx.
+ * All further draw functions work with selected display.
+ * @param ctx context to select. If ctx is already active, functions does nothing.
+ */
+void ssd1306_contextSelect(SSD1306Context *ctx);
+
+/**
+ * Returns active context or NULL if no context is initialized.
+ */
+SSD1306Context *ssd1306_contextActive(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SSD1306_CONTEXT_H_
@@ -0,0 +1,410 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306.h"
+#include "lcd/lcd_common.h"
+#include "intf/ssd1306_interface.h"
+
+extern uint16_t ssd1306_color;
+extern uint8_t s_ssd1306_invertByte;
+
+/* Returns bits of display page, covered by rows from top to bottom */
+static uint8_t pageMask(uint8_t page, lcdint_t top, lcdint_t bottom)
+{
+    lcdint_t y0 = page << 3;
+    if ( (top > bottom) || (bottom < y0) || (top > y0 + 7) )
+    {
+        return 0;
+    }
+    uint8_t mask = 0xFF;
+    if ( top > y0 ) mask <<= (top - y0);
+    if ( bottom < y0 + 7 ) mask &= 0xFF >> (y0 + 7 - bottom);
+    return mask;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  PROGRESS BAR
+///////////////////////////////////////////////////////////////////////////////
+
+void ssd1306_createProgressBar(SProgressBar *bar, lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, uint16_t maxValue)
+{
+    bar->x = x;
+    bar->y = y;
+    bar->width = w;
+    bar->height = h;
+    bar->maxValue = maxValue;
+    bar->fill = 0;
+    bar->vertical = 0;
+}
+
+void ssd1306_createGauge(SProgressBar *bar, lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, uint16_t maxValue)
+{
+    ssd1306_createProgressBar(bar, x, y, w, h, maxValue);
+    bar->vertical = 1;
+}
+
+/* Draws columns for bar or rows for gauge. Bar state is already updated */
+static void drawBar(const SProgressBar *bar, lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint8_t fill)
+{
+    lcdint_t bottom = bar->y + bar->height - 1;
+    lcdint_t top = bar->vertical ? bottom - bar->fill + 1 : ( fill ? bar->y : bottom + 1 );
+    ssd1306_lcd.set_block(x1, y1 >> 3, x2 - x1 + 1);
+    for (uint8_t page = y1 >> 3; page <= (y2 >> 3); page++)
+    {
+        uint8_t data = pageMask(page, top, bottom) ^ s_ssd1306_invertByte;
+        for (lcdint_t x = x1; x <= x2; x++)
+        {
+            ssd1306_lcdSendPixels1(data);
+        }
+        ssd1306_lcd.next_page();
+    }
+    ssd1306_intf.stop();
+}
+
+static void drawBar8(const SProgressBar *bar, lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint8_t fill)
+{
+    if ( fill )
+        ssd1306_fillRect8(x1, y1, x2, y2);
+    else
+        ssd1306_clearBlock8(x1, y1, x2 - x1 + 1, y2 - y1 + 1);
+}
+
+static void drawBar16(const SProgressBar *bar, lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, uint8_t fill)
+{
+    if ( fill )
+        ssd1306_fillRect16(x1, y1, x2, y2);
+    else
+        ssd1306_clearBlock16(x1, y1, x2 - x1 + 1, y2 - y1 + 1);
+}
+
+static void updateProgressBar(SProgressBar *bar, uint16_t value,
+                              void (*draw)(const SProgressBar *bar, lcdint_t x1, lcdint_t y1,
+                                           lcdint_t x2, lcdint_t y2, uint8_t fill))
+{
+    lcduint_t size = bar->vertical ? bar->height : bar->width;
+    lcduint_t fill = value >= bar->maxValue ? size : (uint32_t)size * value / bar->maxValue;
+    if ( fill == bar->fill )
+    {
+        return;
+    }
+    lcduint_t from = fill > bar->fill ? bar->fill : fill;
+    lcduint_t to = fill > bar->fill ? fill : bar->fill;
+    uint8_t grow = fill > bar->fill;
+    bar->fill = fill;
+    if ( bar->vertical )
+    {
+        lcdint_t bottom = bar->y + bar->height - 1;
+        draw(bar, bar->x, bottom - to + 1, bar->x + bar->width - 1, bottom - from, grow);
+    }
+    else
+    {
+        draw(bar, bar->x + from, bar->y, bar->x + to - 1, bar->y + bar->height - 1, grow);
+    }
+}
+
+void ssd1306_updateProgressBar(SProgressBar *bar, uint16_t value)
+{
+    updateProgressBar(bar, value, drawBar);
+}
+
+void ssd1306_updateProgressBar8(SProgressBar *bar, uint16_t value)
+{
+    updateProgressBar(bar, value, drawBar8);
+}
+
+void ssd1306_updateProgressBar16(SProgressBar *bar, uint16_t value)
+{
+    updateProgressBar(bar, value, drawBar16);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  SPARKLINE
+///////////////////////////////////////////////////////////////////////////////
+
+void ssd1306_createSparkline(SSparkline *line, lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                             int16_t minValue, int16_t maxValue)
+{
+    line->x = x;
+    line->y = y;
+    line->width = w;
+    line->height = h;
+    line->minValue = minValue;
+    line->maxValue = maxValue;
+    line->pos = 0;
+    line->last = y + h - 1;
+    line->count = 0;
+}
+
+/* Sends single column of the chart area from y to y + h - 1 with pixels from top to bottom set */
+static void drawColumn(lcdint_t x, lcdint_t y, lcduint_t h, lcdint_t top, lcdint_t bottom)
+{
+    uint8_t lastPage = (y + h - 1) >> 3;
+    ssd1306_lcd.set_block(x, y >> 3, 1);
+    for (uint8_t page = y >> 3; page <= lastPage; page++)
+    {
+        if ( page != (y >> 3) )
+        {
+            ssd1306_lcd.next_page();
+        }
+        ssd1306_lcdSendPixels1(pageMask(page, top, bottom) ^ s_ssd1306_invertByte);
+    }
+    ssd1306_intf.stop();
+}
+
+static void drawColumn8(lcdint_t x, lcdint_t y, lcduint_t h, lcdint_t top, lcdint_t bottom)
+{
+    ssd1306_lcd.set_block(x, y, 1);
+    for (lcdint_t row = y; row < y + (lcdint_t)h; row++)
+    {
+        ssd1306_lcd.send_pixels8( (row >= top) && (row <= bottom) ? ssd1306_color : 0x00 );
+    }
+    ssd1306_intf.stop();
+}
+
+static void drawColumn16(lcdint_t x, lcdint_t y, lcduint_t h, lcdint_t top, lcdint_t bottom)
+{
+    ssd1306_lcd.set_block(x, y, 1);
+    for (lcdint_t row = y; row < y + (lcdint_t)h; row++)
+    {
+        ssd1306_lcd.send_pixels16( (row >= top) && (row <= bottom) ? ssd1306_color : 0x0000 );
+    }
+    ssd1306_intf.stop();
+}
+
+/*
+ * When the chart is full, it is shifted by display controller if shift is allowed
+ * and supported. Otherwise new values overwrite the oldest ones from left to right,
+ * and the column ahead of the last value is cleared.
+ */
+static void addSparklineValue(SSparkline *line, int16_t value, uint8_t shift,
+                              void (*draw)(lcdint_t x, lcdint_t y, lcduint_t h, lcdint_t top, lcdint_t bottom))
+{
+    if ( value < line->minValue ) value = line->minValue;
+    if ( value > line->maxValue ) value = line->maxValue;
+    lcdint_t y = line->y + line->height - 1;
+    if ( line->maxValue > line->minValue )
+    {
+        y -= (int32_t)(value - line->minValue) * (line->height - 1) / (line->maxValue - line->minValue);
+    }
+    lcdint_t prev = line->count ? line->last : y;
+    uint8_t sweep = 0;
+    if ( line->count >= line->width )
+    {
+        if ( shift && ssd1306_copyBlock(line->x + 1, line->y, line->x + line->width - 1,
+                                        line->y + line->height - 1, line->x, line->y) )
+        {
+            line->pos = line->width - 1;
+        }
+        else
+        {
+            sweep = 1;
+        }
+    }
+    else
+    {
+        line->count++;
+    }
+    draw(line->x + line->pos, line->y, line->height, prev < y ? prev : y, prev < y ? y : prev);
+    line->last = y;
+    if ( ++line->pos >= line->width )
+    {
+        line->pos = 0;
+    }
+    if ( sweep )
+    {
+        draw(line->x + line->pos, line->y, line->height, 1, 0);
+    }
+}
+
+void ssd1306_addSparklineValue(SSparkline *line, int16_t value)
+{
+    addSparklineValue(line, value, 0, drawColumn);
+}
+
+void ssd1306_addSparklineValue8(SSparkline *line, int16_t value)
+{
+    addSparklineValue(line, value, 1, drawColumn8);
+}
+
+void ssd1306_addSparklineValue16(SSparkline *line, int16_t value)
+{
+    addSparklineValue(line, value, 1, drawColumn16);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  PLOT
+///////////////////////////////////////////////////////////////////////////////
+
+void ssd1306_createPlot(SPlot *plot, lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                        uint8_t *buffer, int16_t minValue, int16_t maxValue)
+{
+    plot->x = x;
+    plot->y = y;
+    plot->width = w;
+    plot->height = h;
+    plot->minValue = minValue;
+    plot->maxValue = maxValue;
+    plot->samples = buffer;
+    plot->head = 0;
+    plot->count = 0;
+}
+
+/* Returns vertical span of the column: from previous sample to the sample of the column */
+static uint8_t plotSpan(const SPlot *plot, lcduint_t column, lcdint_t *top, lcdint_t *bottom)
+{
+    if ( column >= plot->count )
+    {
+        return 0;
+    }
+    lcduint_t index = plot->head + column;
+    if ( index >= plot->width ) index -= plot->width;
+    uint8_t current = plot->samples[index];
+    uint8_t prev = current;
+    if ( column )
+    {
+        prev = plot->samples[index ? index - 1 : plot->width - 1];
+    }
+    *top = plot->y + (prev < current ? prev : current);
+    *bottom = plot->y + (prev < current ? current : prev);
+    return 1;
+}
+
+/* Sends the whole plot page by page as single block */
+static void redrawPlot(const SPlot *plot)
+{
+    uint8_t firstPage = plot->y >> 3;
+    uint8_t lastPage = (plot->y + plot->height - 1) >> 3;
+    ssd1306_lcd.set_block(plot->x, firstPage, plot->width);
+    for (uint8_t page = firstPage; page <= lastPage; page++)
+    {
+        for (lcduint_t column = 0; column < plot->width; column++)
+        {
+            lcdint_t top, bottom;
+            uint8_t data = plotSpan(plot, column, &top, &bottom) ? pageMask(page, top, bottom) : 0x00;
+            ssd1306_lcdSendPixels1(data ^ s_ssd1306_invertByte);
+        }
+        ssd1306_lcd.next_page();
+    }
+    ssd1306_intf.stop();
+}
+
+/* Sends the whole plot row by row as single block */
+static void redrawPlot8(const SPlot *plot)
+{
+    ssd1306_lcd.set_block(plot->x, plot->y, plot->width);
+    for (lcdint_t row = plot->y; row < plot->y + (lcdint_t)plot->height; row++)
+    {
+        for (lcduint_t column = 0; column < plot->width; column++)
+        {
+            lcdint_t top, bottom;
+            uint8_t set = plotSpan(plot, column, &top, &bottom) && (row >= top) && (row <= bottom);
+            ssd1306_lcd.send_pixels8( set ? ssd1306_color : 0x00 );
+        }
+    }
+    ssd1306_intf.stop();
+}
+
+static void redrawPlot16(const SPlot *plot)
+{
+    ssd1306_lcd.set_block(plot->x, plot->y, plot->width);
+    for (lcdint_t row = plot->y; row < plot->y + (lcdint_t)plot->height; row++)
+    {
+        for (lcduint_t column = 0; column < plot->width; column++)
+        {
+            lcdint_t top, bottom;
+            uint8_t set = plotSpan(plot, column, &top, &bottom) && (row >= top) && (row <= bottom);
+            ssd1306_lcd.send_pixels16( set ? ssd1306_color : 0x0000 );
+        }
+    }
+    ssd1306_intf.stop();
+}
+
+/*
+ * Until the plot is full, each sample takes next column. After that the oldest
+ * sample is replaced, and the plot is shifted by display controller if possible.
+ * Otherwise it is resent from samples buffer.
+ */
+static void addPlotSample(SPlot *plot, int16_t value, uint8_t shift,
+                          void (*draw)(lcdint_t x, lcdint_t y, lcduint_t h, lcdint_t top, lcdint_t bottom),
+                          void (*redraw)(const SPlot *plot))
+{
+    if ( value < plot->minValue ) value = plot->minValue;
+    if ( value > plot->maxValue ) value = plot->maxValue;
+    uint8_t row = plot->height - 1;
+    if ( plot->maxValue > plot->minValue )
+    {
+        row -= (int32_t)(value - plot->minValue) * (plot->height - 1) / (plot->maxValue - plot->minValue);
+    }
+    lcdint_t top, bottom;
+    if ( plot->count < plot->width )
+    {
+        plot->samples[plot->count++] = row;
+        plotSpan(plot, plot->count - 1, &top, &bottom);
+        draw(plot->x + plot->count - 1, plot->y, plot->height, top, bottom);
+        return;
+    }
+    plot->samples[plot->head] = row;
+    if ( ++plot->head >= plot->width )
+    {
+        plot->head = 0;
+    }
+    if ( shift && ssd1306_copyBlock(plot->x + 1, plot->y, plot->x + plot->width - 1,
+                                    plot->y + plot->height - 1, plot->x, plot->y) )
+    {
+        plotSpan(plot, plot->width - 1, &top, &bottom);
+        draw(plot->x + plot->width - 1, plot->y, plot->height, top, bottom);
+        return;
+    }
+    redraw(plot);
+}
+
+void ssd1306_addPlotSample(SPlot *plot, int16_t value)
+{
+    addPlotSample(plot, value, 0, drawColumn, redrawPlot);
+}
+
+void ssd1306_addPlotSample8(SPlot *plot, int16_t value)
+{
+    addPlotSample(plot, value, 1, drawColumn8, redrawPlot8);
+}
+
+void ssd1306_addPlotSample16(SPlot *plot, int16_t value)
+{
+    addPlotSample(plot, value, 1, drawColumn16, redrawPlot16);
+}
+
+void ssd1306_drawPlot(const SPlot *plot)
+{
+    redrawPlot(plot);
+}
+
+void ssd1306_drawPlot8(const SPlot *plot)
+{
+    redrawPlot8(plot);
+}
+
+void ssd1306_drawPlot16(const SPlot *plot)
+{
+    redrawPlot16(plot);
+}
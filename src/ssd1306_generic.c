@@ -34,6 +34,7 @@
 #include "intf/ssd1306_interface.h"
 #include "ssd1306_hal/io.h"
 #include "nano_gfx_types.h"
+#include <stdlib.h>
 
 enum
 {
@@ -41,6 +42,10 @@ enum
     SSD1306_NEW_FIXED_FORMAT = 0x01,
     SSD1306_NEW_FORMAT       = 0x02,
     SSD1306_SQUIX_FORMAT     = 0x03,
+    SSD1306_ROWS_FORMAT      = 0x04,
+    SSD1306_ROWS_RLE_FORMAT  = 0x05,
+    SSD1306_ALPHA2_FORMAT    = 0x06,
+    SSD1306_ALPHA4_FORMAT    = 0x07,
 };
 
 uint16_t ssd1306_color = 0xFFFF;
@@ -78,6 +83,66 @@ static const uint8_t * ssd1306_readUnicodeRecord(SUnicodeBlockRecord *r, const u
     return (r->count > 0) ? (&p[3]): NULL;
 }
 
+/*
+ * Unicode record with this start code marks subset block, generated by fontgenerator.py --subset:
+ * first code (2 bytes) | span | remap table of span bytes (glyph index or 0xFF) are placed
+ * before usual jump table, so sparse chars are found by single table read.
+ */
+#define UNICODE_SUBSET_MARKER  0xFFFE
+/* Value of remap table for the chars, missing in the subset */
+#define UNICODE_SUBSET_NONE    0xFF
+
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+/* Unicode record with this start code marks sorted index of unicode blocks */
+#define UNICODE_INDEX_MARKER   0xFFFF
+/* Index entry: start code (2 bytes) | count | offset of unicode record (3 bytes) */
+#define UNICODE_INDEX_ENTRY_SIZE  6
+
+/**
+ * Looks for unicode block, containing the char, via block index of the table.
+ * Returns 0 if the table has no index, and linear search should be used.
+ * Otherwise *block points to the block data, following unicode record, or
+ * NULL if there is no such char in the table.
+ */
+static uint8_t ssd1306_searchUnicodeIndex(const uint8_t *table, uint16_t unicode,
+                                          SUnicodeBlockRecord *r, const uint8_t **block)
+{
+    SUnicodeBlockRecord index;
+    ssd1306_readUnicodeRecord( &index, table );
+    if ( index.start_code != UNICODE_INDEX_MARKER )
+    {
+        return 0;
+    }
+    const uint8_t *entries = table + sizeof(SUnicodeBlockRecord);
+    uint8_t lo = 0;
+    uint8_t hi = index.count;
+    *block = NULL;
+    while (lo < hi)
+    {
+        uint8_t mid = (lo + hi) >> 1;
+        const uint8_t *e = &entries[ (uint16_t)mid * UNICODE_INDEX_ENTRY_SIZE ];
+        ssd1306_readUnicodeRecord( r, e );
+        if ( unicode < r->start_code )
+        {
+            hi = mid;
+        }
+        else if ( unicode >= r->start_code + r->count )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            uint32_t offset = ((uint32_t)pgm_read_byte(&e[3]) << 16) |
+                              (pgm_read_byte(&e[4]) << 8) | pgm_read_byte(&e[5]);
+            *block = entries + (uint16_t)index.count * UNICODE_INDEX_ENTRY_SIZE +
+                     offset + sizeof(SUnicodeBlockRecord);
+            break;
+        }
+    }
+    return 1;
+}
+#endif
+
 
 void ssd1306_setSecondaryFont(const uint8_t * progmemUnicode)
 {
@@ -90,38 +155,279 @@ void ssd1306_setSecondaryFont(const uint8_t * progmemUnicode)
 #endif
 }
 
+#if defined(CONFIG_SSD1306_GLYPH_CACHE_SIZE) && (CONFIG_SSD1306_GLYPH_CACHE_SIZE > 0)
+typedef struct
+{
+    const uint8_t *font;
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+    const uint8_t *secondary;
+#endif
+    uint16_t unicode;
+    SCharInfo info;
+} SGlyphCacheRecord;
+
+/* Records are kept in LRU order: most recently used record goes first */
+static SGlyphCacheRecord s_glyphCache[CONFIG_SSD1306_GLYPH_CACHE_SIZE];
+static uint8_t s_glyphCacheCount = 0;
+
+static void ssd1306_resetGlyphCache(void)
+{
+    s_glyphCacheCount = 0;
+}
+#else
+#define ssd1306_resetGlyphCache()
+#endif
+
 void ssd1306_getCharBitmap(uint16_t unicode, SCharInfo *info)
 {
+#if defined(CONFIG_SSD1306_GLYPH_CACHE_SIZE) && (CONFIG_SSD1306_GLYPH_CACHE_SIZE > 0)
+    if (!info)
+    {
+        return;
+    }
+    uint8_t i;
+    for (i = 0; i < s_glyphCacheCount; i++)
+    {
+        if ((s_glyphCache[i].unicode == unicode) && (s_glyphCache[i].font == s_fixedFont.primary_table)
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+            && (s_glyphCache[i].secondary == s_fixedFont.secondary_table)
+#endif
+           )
+        {
+            break;
+        }
+    }
+    SGlyphCacheRecord record;
+    if (i < s_glyphCacheCount)
+    {
+        record = s_glyphCache[i];
+    }
+    else
+    {
+        record.font = s_fixedFont.primary_table;
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+        record.secondary = s_fixedFont.secondary_table;
+#endif
+        record.unicode = unicode;
+        record.info.glyph = NULL;
+        s_ssd1306_getCharBitmap( unicode, &record.info );
+        if (s_glyphCacheCount < CONFIG_SSD1306_GLYPH_CACHE_SIZE)
+        {
+            s_glyphCacheCount++;
+        }
+        i = s_glyphCacheCount - 1;
+    }
+    /* Move the record to the head of the list */
+    for (; i > 0; i--)
+    {
+        s_glyphCache[i] = s_glyphCache[i - 1];
+    }
+    s_glyphCache[0] = record;
+    *info = record.info;
+#else
     return s_ssd1306_getCharBitmap( unicode, info );
+#endif
 }
 
-uint16_t ssd1306_unicode16FromUtf8(uint8_t ch)
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+/* Returns number of continuation bytes, expected after utf8 lead byte, or 0 for single byte char */
+static inline uint8_t ssd1306_utf8Continuation(uint8_t ch)
+{
+    if ( (ch & 0xE0) == 0xC0 ) return 1;
+    if ( (ch & 0xF0) == 0xE0 ) return 2;
+    if ( (ch & 0xF8) == 0xF0 ) return 3;
+    return 0;
+}
+
+static inline uint16_t ssd1306_utf8Result(uint32_t code)
+{
+    /* Library fonts support only 16-bit codes, and 0xFFFF is reserved */
+    return code < SSD1306_MORE_CHARS_REQUIRED ? (uint16_t)code : SSD1306_UNICODE_REPLACEMENT;
+}
+#endif
+
+uint16_t ssd1306_unicode16FromUtf8Ex(uint32_t *state, uint8_t ch)
 {
 #ifdef CONFIG_SSD1306_UNICODE_ENABLE
-    static uint16_t unicode = 0;
-    ch &= 0x000000FF;
-    if (!unicode)
+    /* state holds number of expected bytes in bits 24-25, and decoded bits in bits 0-20 */
+    uint8_t remaining = *state >> 24;
+    if ( remaining && ((ch & 0xC0) == 0x80) )
     {
-        if ( ch >= 0xc0 )
+        uint32_t code = ((*state & 0x001FFFFF) << 6) | (ch & 0x3F);
+        if ( --remaining )
         {
-            unicode = ch;
+            *state = ((uint32_t)remaining << 24) | code;
             return SSD1306_MORE_CHARS_REQUIRED;
         }
-        return ch;
+        *state = 0;
+        return ssd1306_utf8Result( code );
+    }
+    /* Broken sequences are dropped, and the byte is decoded as new char */
+    remaining = ssd1306_utf8Continuation( ch );
+    if ( remaining )
+    {
+        *state = ((uint32_t)remaining << 24) | (ch & (0x3F >> remaining));
+        return SSD1306_MORE_CHARS_REQUIRED;
+    }
+    *state = 0;
+    return ch;
+#else
+    return ch;
+#endif
+}
+
+uint16_t ssd1306_unicode16FromUtf8(uint8_t ch)
+{
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+    static uint32_t state = 0;
+    return ssd1306_unicode16FromUtf8Ex( &state, ch );
+#else
+    return ch;
+#endif
+}
+
+uint16_t ssd1306_unicode16FromUtf8Str(const char *str, uint8_t *len)
+{
+    uint8_t ch = str[0];
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+    uint8_t remaining = ssd1306_utf8Continuation( ch );
+    uint32_t code = ch & (0x3F >> remaining);
+    uint8_t i;
+    for (i = 1; i <= remaining; i++)
+    {
+        ch = str[i];
+        if ( (ch & 0xC0) != 0x80 )
+        {
+            /* Broken sequence: do not consume the byte, it starts next char */
+            *len = i;
+            return SSD1306_UNICODE_REPLACEMENT;
+        }
+        code = (code << 6) | (ch & 0x3F);
     }
-    uint16_t code = ((unicode & 0x1f) << 6) | (ch & 0x3f);
-    unicode = 0;
-    return code;
+    *len = i;
+    return remaining ? ssd1306_utf8Result( code ) : (uint8_t)str[0];
 #else
+    *len = 1;
     return ch;
 #endif
 }
 
+uint16_t ssd1306_utf8ToUnicode16(uint16_t *codes, uint16_t count, const char *str)
+{
+    uint16_t n = 0;
+    while ( *str && (n < count) )
+    {
+        uint8_t len;
+        codes[n++] = ssd1306_unicode16FromUtf8Str( str, &len );
+        str += len;
+    }
+    return n;
+}
+
+uint8_t ssd1306_getTextRun(STextRun *run, const char *str, lcdint_t x, lcdint_t maxX)
+{
+    uint8_t taken = 0;
+    run->count = 0;
+    run->height = 0;
+    run->width = 0;
+    run->spacing = 0;
+    do
+    {
+        uint8_t len;
+        SCharInfo *info = &run->chars[run->count++];
+        ssd1306_getCharBitmap( ssd1306_unicode16FromUtf8Str( &str[taken], &len ), info );
+        taken += len;
+        run->width += run->spacing + info->width;
+        run->spacing = info->spacing;
+        if ( info->height > run->height )
+        {
+            run->height = info->height;
+        }
+        x += info->width + info->spacing;
+    } while ( (run->count < SSD1306_TEXT_RUN_SIZE) && str[taken] && (str[taken] != '\r') &&
+              (str[taken] != '\n') && (x <= maxX - (lcdint_t)s_fixedFont.h.width) );
+    return taken;
+}
+
+uint8_t ssd1306_layoutText(STextLayout *layout, const char *str, lcduint_t width)
+{
+    uint16_t pos = 0;
+    layout->text = str;
+    layout->font = s_fixedFont.primary_table;
+    layout->count = 0;
+    layout->lineHeight = s_fixedFont.h.height;
+    layout->width = width;
+    while ( str[pos] && (layout->count < layout->maxLines) )
+    {
+        STextLine *line = &layout->lines[layout->count++];
+        /* Position and width of the line at the last space, the line can be broken at */
+        uint16_t spacePos = 0;
+        lcduint_t spaceWidth = 0;
+        lcduint_t x = 0;
+        line->offset = pos;
+        line->width = 0;
+        while ( str[pos] && (str[pos] != '\n') )
+        {
+            uint8_t len;
+            SCharInfo info;
+            if ( str[pos] == '\r' )
+            {
+                pos++;
+                continue;
+            }
+            ssd1306_getCharBitmap( ssd1306_unicode16FromUtf8Str( &str[pos], &len ), &info );
+            if ( (pos != line->offset) &&
+                 ( (x + info.width > width) || (pos - line->offset + len > 0xFF) ) )
+            {
+                if ( (spacePos > line->offset) && (str[pos] != ' ') )
+                {
+                    pos = spacePos;
+                    line->width = spaceWidth;
+                }
+                break;
+            }
+            if ( str[pos] == ' ' )
+            {
+                spacePos = pos;
+                spaceWidth = line->width;
+            }
+            else
+            {
+                line->width = x + info.width;
+            }
+            x += info.width + info.spacing;
+            pos += len;
+        }
+        line->length = pos - line->offset;
+        /* Trailing spaces are not printed, and line break chars are not part of any line */
+        while ( line->length && (str[line->offset + line->length - 1] == ' ') )
+        {
+            line->length--;
+        }
+        if ( str[pos] == '\n' )
+        {
+            pos++;
+        }
+        else
+        {
+            while ( str[pos] == ' ' ) pos++;
+        }
+    }
+    return layout->count;
+}
+
+uint8_t ssd1306_isTextLayoutValid(const STextLayout *layout, const char *str)
+{
+    return (layout->text == str) && (layout->font == s_fixedFont.primary_table) &&
+           (layout->lineHeight == s_fixedFont.h.height);
+}
+
 void ssd1306_enableUtf8Mode(void)
 {
 #ifdef CONFIG_SSD1306_UNICODE_ENABLE
     g_ssd1306_unicode = 1;
 #endif
+    ssd1306_resetGlyphCache();
 }
 
 void ssd1306_enableAsciiMode(void)
@@ -129,6 +435,7 @@ void ssd1306_enableAsciiMode(void)
 #ifdef CONFIG_SSD1306_UNICODE_ENABLE
     g_ssd1306_unicode = 0;
 #endif
+    ssd1306_resetGlyphCache();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -151,6 +458,10 @@ static const uint8_t *ssd1306_searchCharGlyph(const uint8_t * unicode_table, uin
 {
     SUnicodeBlockRecord r;
     const uint8_t *data = unicode_table;
+    if ( ssd1306_searchUnicodeIndex( unicode_table, unicode, &r, &data ) )
+    {
+        return data ? &data[ (unicode - r.start_code) * s_fixedFont.glyph_size ] : NULL;
+    }
     // looking for required unicode table
     while (1)
     {
@@ -232,6 +543,31 @@ void ssd1306_setFixedFont(const uint8_t * progmemFont)
 #endif
 }
 
+#if defined(CONFIG_FONT_RAM_CACHE_ENABLE)
+#if defined(__AVR__)
+#error "Font RAM cache is not supported on AVR"
+#endif
+
+static uint8_t *s_fontCache = NULL;
+
+uint8_t ssd1306_setFixedFontCached(const uint8_t * progmemFont, uint16_t chars)
+{
+    ssd1306_setFixedFont(progmemFont);
+    free(s_fontCache);
+    /* New copy can get address of the old one, so cached glyphs are not valid anymore */
+    ssd1306_resetGlyphCache();
+    uint32_t size = (uint32_t)chars * s_fixedFont.glyph_size;
+    s_fontCache = (uint8_t *)malloc(size);
+    if (!s_fontCache)
+    {
+        return 0;
+    }
+    memcpy_P(s_fontCache, s_fixedFont.primary_table, size);
+    s_fixedFont.primary_table = s_fontCache;
+    return 1;
+}
+#endif
+
 void ssd1306_setFixedFont_oldStyle(const uint8_t * progmemFont)
 {
     s_fixedFont.h.type   = pgm_read_byte( &progmemFont[0] );
@@ -255,9 +591,23 @@ static void __ssd1306_newFormatGetBitmap(uint16_t unicode, SCharInfo *info)
         uint8_t table_index = 0;
 #endif
         const uint8_t *data = s_fixedFont.primary_table;
+        info->glyph = NULL;
         while (data)
         {
             SUnicodeBlockRecord r;
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+            const uint8_t *block;
+            if ( ssd1306_searchUnicodeIndex( data, unicode, &r, &block ) )
+            {
+                if ( !block )
+                {
+                    /* The char is not in indexed table, try secondary table */
+                    data = table_index++ ? NULL : s_fixedFont.secondary_table;
+                    continue;
+                }
+                data = block - sizeof(SUnicodeBlockRecord);
+            }
+#endif
             data = ssd1306_readUnicodeRecord( &r, data );
             if (!data)
             {
@@ -271,8 +621,27 @@ static void __ssd1306_newFormatGetBitmap(uint16_t unicode, SCharInfo *info)
 #endif
                 break;
             }
+            /* Index of the char in the block, the block doesn't contain the char if index >= r.count */
+            uint16_t index = unicode - r.start_code;
+            if ( unicode < r.start_code )
+            {
+                index = r.count;
+            }
+            if ( r.start_code == UNICODE_SUBSET_MARKER )
+            {
+                uint16_t first = (pgm_read_byte(&data[0]) << 8) | (pgm_read_byte(&data[1]));
+                uint8_t span = pgm_read_byte(&data[2]);
+                index = r.count;
+                if ( (unicode >= first) && (unicode - first < span) &&
+                     (pgm_read_byte(&data[3 + unicode - first]) != UNICODE_SUBSET_NONE) )
+                {
+                    index = pgm_read_byte(&data[3 + unicode - first]);
+                }
+                // skip remap table
+                data += 3 + span;
+            }
             /* Check that unicode in the section being processed */
-            if ( ( unicode < r.start_code) || ( unicode >= (r.start_code + r.count) ) )
+            if ( index >= r.count )
             {
                 // skip jump table
                 data += r.count * 4;
@@ -281,15 +650,14 @@ static void __ssd1306_newFormatGetBitmap(uint16_t unicode, SCharInfo *info)
                 continue;
             }
             /* At this point data points to jump table (offset|offset|bytes|width) */
-            unicode -= r.start_code;
-            data += unicode * 4;
+            data += index * 4;
             uint16_t offset = (pgm_read_byte(&data[0]) << 8) | (pgm_read_byte(&data[1]));
             uint8_t glyph_width = pgm_read_byte(&data[2]);
             uint8_t glyph_height = pgm_read_byte(&data[3]);
             info->width = glyph_width;
             info->height = glyph_height;
             info->spacing = glyph_width ? 1 : (s_fixedFont.h.width >> 1);
-            info->glyph = data + (r.count - unicode) * 4 + 2 + offset;
+            info->glyph = data + (r.count - index) * 4 + 2 + offset;
             break;
         }
         if (!info->glyph)
@@ -302,6 +670,143 @@ static void __ssd1306_newFormatGetBitmap(uint16_t unicode, SCharInfo *info)
     }
 }
 
+uint8_t ssd1306_isRowsFont(void)
+{
+    return (s_fixedFont.h.type >= SSD1306_ROWS_FORMAT) &&
+           (s_fixedFont.h.type <= SSD1306_ALPHA4_FORMAT);
+}
+
+uint8_t ssd1306_isAlphaFont(void)
+{
+    return (s_fixedFont.h.type == SSD1306_ALPHA2_FORMAT) ||
+           (s_fixedFont.h.type == SSD1306_ALPHA4_FORMAT);
+}
+
+void ssd1306_glyphReaderInit(SGlyphReader *reader, const SCharInfo *info)
+{
+    reader->data = info->glyph;
+    reader->count = 0;
+    reader->rle = s_fixedFont.h.type == SSD1306_ROWS_RLE_FORMAT;
+    reader->bits = s_fixedFont.h.type == SSD1306_ALPHA4_FORMAT ? 4 :
+                   (s_fixedFont.h.type == SSD1306_ALPHA2_FORMAT ? 2 : 1);
+}
+
+void ssd1306_glyphSkipPixels(SGlyphReader *reader, uint16_t count)
+{
+    if (!reader->rle)
+    {
+        /* Whole bytes of packed pixels are skipped at once */
+        uint8_t shift = 3 - (reader->bits >> 1);
+        if (count >= reader->count)
+        {
+            count -= reader->count;
+            reader->data += count >> shift;
+            count &= (1 << shift) - 1;
+            reader->count = 0;
+        }
+        while (count--)
+        {
+            ssd1306_glyphReadAlpha(reader);
+        }
+        return;
+    }
+    while (count)
+    {
+        if (!reader->count)
+        {
+            uint8_t data = pgm_read_byte(reader->data++);
+            reader->value = data & 0x80;
+            reader->count = (data & 0x7F) + 1;
+        }
+        uint8_t n = count < reader->count ? count : reader->count;
+        reader->count -= n;
+        count -= n;
+    }
+}
+
+/*
+ * Alpha 0-15 is mapped to weight 0-16 (15 gives solid foreground), so channels are
+ * blended without division.
+ */
+static inline uint16_t ssd1306_blendChannel(uint16_t bg, uint16_t fg, uint8_t alpha, uint16_t mask)
+{
+    uint8_t weight = alpha + (alpha >> 3);
+    return (((uint32_t)(fg & mask) * weight + (uint32_t)(bg & mask) * (16 - weight)) >> 4) & mask;
+}
+
+uint16_t ssd1306_blendColor16(uint16_t bg, uint16_t fg, uint8_t alpha)
+{
+    return ssd1306_blendChannel(bg, fg, alpha, 0xF800) |
+           ssd1306_blendChannel(bg, fg, alpha, 0x07E0) |
+           ssd1306_blendChannel(bg, fg, alpha, 0x001F);
+}
+
+uint8_t ssd1306_blendColor8(uint8_t bg, uint8_t fg, uint8_t alpha)
+{
+    return ssd1306_blendChannel(bg, fg, alpha, 0xE0) |
+           ssd1306_blendChannel(bg, fg, alpha, 0x1C) |
+           ssd1306_blendChannel(bg, fg, alpha, 0x03);
+}
+
+void ssd1306_alphaRamp16(uint16_t *ramp, uint16_t bg, uint16_t fg)
+{
+    for (uint8_t alpha = 0; alpha < 16; alpha++)
+    {
+        ramp[alpha] = ssd1306_blendColor16(bg, fg, alpha);
+    }
+}
+
+void ssd1306_alphaRamp8(uint8_t *ramp, uint8_t bg, uint8_t fg)
+{
+    for (uint8_t alpha = 0; alpha < 16; alpha++)
+    {
+        ramp[alpha] = ssd1306_blendColor8(bg, fg, alpha);
+    }
+}
+
+void ssd1306_transpose8x8(uint8_t *block)
+{
+#if defined(__AVR__)
+    uint8_t out[8] = { 0 };
+    for (uint8_t k = 0; k < 8; k++)
+    {
+        uint8_t row = block[k];
+        for (uint8_t c = 0; c < 8; c++)
+        {
+            out[c] = (out[c] >> 1) | (row << 7);
+            row >>= 1;
+        }
+    }
+    memcpy(block, out, 8);
+#elif UINTPTR_MAX > 0xFFFFFFFFUL
+    /* Bit 8 * row + column is swapped with bit 8 * column + row: 2x2, 4x4 and 8x8 blocks */
+    uint64_t x = 0;
+    uint64_t t;
+    for (uint8_t k = 0; k < 8; k++) x |= (uint64_t)block[k] << (k * 8);
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;  x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL; x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL; x ^= t ^ (t << 28);
+    for (uint8_t k = 0; k < 8; k++) block[k] = (uint8_t)(x >> (k * 8));
+#else
+    /* Rows 0-3 are in x, rows 4-7 are in y, 4x4 blocks are swapped between them at the end */
+    uint32_t x = (uint32_t)block[0] | ((uint32_t)block[1] << 8) | ((uint32_t)block[2] << 16) | ((uint32_t)block[3] << 24);
+    uint32_t y = (uint32_t)block[4] | ((uint32_t)block[5] << 8) | ((uint32_t)block[6] << 16) | ((uint32_t)block[7] << 24);
+    uint32_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AAUL;  x ^= t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AAUL;  y ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCCUL; x ^= t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCCUL; y ^= t ^ (t << 14);
+    t = (x & 0x0F0F0F0FUL) | ((y << 4) & 0xF0F0F0F0UL);
+    y = ((x >> 4) & 0x0F0F0F0FUL) | (y & 0xF0F0F0F0UL);
+    x = t;
+    for (uint8_t k = 0; k < 4; k++)
+    {
+        block[k] = (uint8_t)(x >> (k * 8));
+        block[k + 4] = (uint8_t)(y >> (k * 8));
+    }
+#endif
+}
+
 void ssd1306_setFreeFont(const uint8_t * progmemFont)
 {
     s_fixedFont.h.type   = pgm_read_byte( &progmemFont[0] );
@@ -318,7 +823,8 @@ void ssd1306_setFreeFont(const uint8_t * progmemFont)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 /// SQUIX FORMAT: 1.7.8 and later
-/// SQUIX FORMAT is not fully supported. Use it at your own risk
+/// Glyphs are stored column by column, so they match library format only for
+/// fonts up to 8 pixels height. Taller fonts must be converted with fontgenerator.py
 
 static void __ssd1306_squixFormatGetBitmap(uint16_t unicode, SCharInfo *info)
 {
@@ -334,22 +840,26 @@ static void __ssd1306_squixFormatGetBitmap(uint16_t unicode, SCharInfo *info)
             info->glyph = s_fixedFont.primary_table;
             return;
         }
-        /* At this point data points to jump table (offset|offset|bytes|width) */
+        /* At this point data points to jump table (offset|offset|bytes|advance) */
         const uint8_t * bitmap_data = data + (uint16_t)s_fixedFont.count * 4;
         unicode -= s_fixedFont.h.ascii_offset;
         data += (unicode * 4);
         uint16_t offset = (pgm_read_byte(&data[0]) << 8) | pgm_read_byte(&data[1]);
         uint8_t glyph_bytes = pgm_read_byte(&data[2]);
-//        uint8_t width = pgm_read_byte(&data[3]);
-        info->width = glyph_bytes; //(glyph_bytes + s_fixedFont.pages - 1)  / s_fixedFont.pages;
-        info->height = s_fixedFont.h.height / 2;
-        info->spacing = 1;
-//        uint8_t index=0;
+        uint8_t advance = pgm_read_byte(&data[3]);
         info->glyph = bitmap_data;
-        if ( offset != 0xFFFF )
+        if ( offset == 0xFFFF )
+        {
+            glyph_bytes = 0;
+        }
+        else
         {
-             info->glyph += offset;
+            info->glyph += offset;
         }
+        /* Trailing empty columns are not stored in squix fonts */
+        info->width = (glyph_bytes + s_fixedFont.pages - 1) / s_fixedFont.pages;
+        info->height = info->width ? s_fixedFont.h.height : 0;
+        info->spacing = advance > info->width ? advance - info->width : 0;
     }
 }
 
@@ -368,3 +878,83 @@ void ssd1306_setSquixFont(const uint8_t * progmemFont)
     s_fixedFont.secondary_table = NULL;
 #endif
 }
+
+///////////////////////////////////////////////////////////////////////
+//                 DISPLAY CONTEXTS
+///////////////////////////////////////////////////////////////////////
+
+extern uint8_t s_ssd1306_invertByte;
+
+static SSD1306Context *s_activeContext = NULL;
+
+static void ssd1306_contextSave(SSD1306Context *ctx)
+{
+    ctx->intf = ssd1306_intf;
+    ctx->lcd = ssd1306_lcd;
+    ctx->color = ssd1306_color;
+    ctx->invertByte = s_ssd1306_invertByte;
+    ctx->cursorX = ssd1306_cursorX;
+    ctx->cursorY = ssd1306_cursorY;
+    ctx->font = s_fixedFont;
+    ctx->getCharBitmap = s_ssd1306_getCharBitmap;
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+    ctx->unicode = g_ssd1306_unicode;
+#endif
+    ctx->cs = s_ssd1306_cs;
+    ctx->dc = s_ssd1306_dc;
+    ctx->spiClock = s_ssd1306_spi_clock;
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+    ssd1306_intfStatsSave(&ctx->stats);
+#endif
+#ifdef CONFIG_SSD1306_WINDOW_CACHE_ENABLE
+    ssd1306_windowCacheSave(&ctx->window);
+#endif
+}
+
+void ssd1306_contextInit(SSD1306Context *ctx)
+{
+    ssd1306_contextSave(ctx);
+    s_activeContext = ctx;
+}
+
+void ssd1306_contextSelect(SSD1306Context *ctx)
+{
+    if (ctx == s_activeContext)
+    {
+        return;
+    }
+    if (s_activeContext)
+    {
+        /* asynchronous transfer must complete before pins and interface are switched */
+        ssd1306_intf.wait();
+        ssd1306_contextSave(s_activeContext);
+    }
+    ssd1306_intf = ctx->intf;
+    ssd1306_lcd = ctx->lcd;
+    ssd1306_color = ctx->color;
+    s_ssd1306_invertByte = ctx->invertByte;
+    ssd1306_cursorX = ctx->cursorX;
+    ssd1306_cursorY = ctx->cursorY;
+    s_fixedFont = ctx->font;
+    s_ssd1306_getCharBitmap = ctx->getCharBitmap;
+#ifdef CONFIG_SSD1306_UNICODE_ENABLE
+    g_ssd1306_unicode = ctx->unicode;
+#endif
+    s_ssd1306_cs = ctx->cs;
+    s_ssd1306_dc = ctx->dc;
+    s_ssd1306_spi_clock = ctx->spiClock;
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+    ssd1306_intfStatsRestore(&ctx->stats);
+#endif
+#ifdef CONFIG_SSD1306_WINDOW_CACHE_ENABLE
+    ssd1306_windowCacheRestore(&ctx->window);
+#endif
+    /* mode, rotation and address window, cached by the library, belong to previous display */
+    ssd1306_lcdInvalidateState();
+    s_activeContext = ctx;
+}
+
+SSD1306Context *ssd1306_contextActive(void)
+{
+    return s_activeContext;
+}
@@ -41,6 +41,8 @@ extern "C" {
 
 /** Flag means that more chars are required to decode utf-8 */
 #define SSD1306_MORE_CHARS_REQUIRED  0xffff
+/** Unicode char, returned by utf8 decoders for the chars, not supported by the library */
+#define SSD1306_UNICODE_REPLACEMENT  0xfffd
 
 /**
  * @defgroup LCD_GENERIC_API DIRECT DRAW: Generic API functions, common for all displays and all display modes.
@@ -74,6 +76,21 @@ void ssd1306_setCursor(lcdint_t x, lcdint_t y);
  */
 void ssd1306_setFixedFont(const uint8_t * progmemFont);
 
+#if defined(CONFIG_FONT_RAM_CACHE_ENABLE)
+/**
+ * Sets fixed font like ssd1306_setFixedFont() does, and copies glyphs of the font
+ * from flash to RAM, allocated from heap. Text output reads glyphs from RAM then, and
+ * doesn't stall on flash cache misses (ESP32). RAM, taken by previously cached font,
+ * is released.
+ * @param progmemFont - font to setup located in Flash area
+ * @param chars - number of chars in the font, starting from first char of the font
+ *                (96 for ssd1306xled_font6x8)
+ * @return 1 if the font is copied to RAM, 0 if there is no memory, and the font is
+ *         used from flash
+ */
+uint8_t ssd1306_setFixedFontCached(const uint8_t * progmemFont, uint16_t chars);
+#endif
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 void ssd1306_setFixedFont_oldStyle(const uint8_t * progmemFont);
 #endif
@@ -84,6 +101,9 @@ void ssd1306_setFixedFont_oldStyle(const uint8_t * progmemFont);
  * Please refer to github wiki on how to generate new fonts.
  * @param progmemFont - font to setup located in Flash area
  * @note This function supports new fonts of ssd1306 library 1.7.8 and above
+ * @note Free fonts with glyphs stored row by row (tools/fontgenerator.py -f rows)
+ *       are supported by 8-bit and 16-bit direct draw text functions and by
+ *       NanoCanvas text functions only.
  */
 void ssd1306_setFreeFont(const uint8_t * progmemFont);
 
@@ -140,7 +160,9 @@ void ssd1306_enableAsciiMode(void);
  * Function allows to set and use squix font.
  * @param progmemFont - font to setup located in Flash area
  * @note This function supports squix fonts for ssd1306 library 1.7.8 and above
- * @warning Squix fonts are not fully supported, use them at your own risk
+ * @note Squix fonts store glyphs column by column, so this function can be used
+ *       only with fonts up to 8 pixels height. Taller squix fonts should be converted
+ *       to library format: tools/fontgenerator.py --squix font.h -f new
  */
 void ssd1306_setSquixFont(const uint8_t * progmemFont);
 
@@ -154,11 +176,276 @@ void ssd1306_setSquixFont(const uint8_t * progmemFont);
 uint16_t ssd1306_unicode16FromUtf8(uint8_t ch);
 #endif
 
+/**
+ * @brief Decodes utf8 stream byte by byte, keeping decoder state in user variable.
+ *
+ * Decodes utf8 stream byte by byte. Unlike ssd1306_unicode16FromUtf8() the function
+ * keeps decoder state in the variable, provided by the caller, so several text
+ * streams (consoles, canvases) can be decoded at the same time.
+ * 2-, 3- and 4-byte sequences are supported. Chars above 0xFFFE are returned as
+ * SSD1306_UNICODE_REPLACEMENT, since library fonts support only 16-bit unicode.
+ * @param state pointer to decoder state, must be initialized with 0
+ * @param ch character byte to decode
+ * @return 16-bit unicode char, encoded in utf8
+ *         SSD1306_MORE_CHARS_REQUIRED if more characters is expected
+ */
+uint16_t ssd1306_unicode16FromUtf8Ex(uint32_t *state, uint8_t ch);
+
+/**
+ * @brief Decodes single char from utf8 string.
+ *
+ * Decodes single char from utf8 string. The function has no internal state,
+ * and can be called from different contexts.
+ * @param str pointer to utf8 string, must not point to terminating zero
+ * @param len pointer to variable to store number of bytes, taken by the char
+ * @return 16-bit unicode char or SSD1306_UNICODE_REPLACEMENT for invalid sequences
+ */
+uint16_t ssd1306_unicode16FromUtf8Str(const char *str, uint8_t *len);
+
+/**
+ * @brief Decodes utf8 string to array of 16-bit unicode chars.
+ *
+ * Decodes utf8 string to array of 16-bit unicode chars. Decoded array can be passed
+ * to ssd1306_getCharBitmap() char by char, so the text can be rendered many times
+ * without decoding.
+ * @param codes array to store unicode chars to
+ * @param count maximum number of chars to store
+ * @param str pointer to NULL-terminated utf8 string
+ * @return number of decoded chars
+ */
+uint16_t ssd1306_utf8ToUnicode16(uint16_t *codes, uint16_t count, const char *str);
+
+/** Maximum number of chars, collected to single text run */
+#define SSD1306_TEXT_RUN_SIZE  8
+
+/**
+ * Describes run of chars, printed to lcd display in one block
+ */
+typedef struct
+{
+    /// glyphs of chars in the run
+    SCharInfo chars[SSD1306_TEXT_RUN_SIZE];
+    /// number of chars in the run
+    uint8_t count;
+    /// height of the run in pixels: the height of the highest glyph
+    uint8_t height;
+    /// width of the run in pixels, including spacing between chars
+    lcduint_t width;
+    /// spacing after the last char of the run
+    uint8_t spacing;
+} STextRun;
+
+/**
+ * @brief Collects chars of utf8 string, which can be printed in one block.
+ *
+ * Collects glyphs of chars from the string, starting at specified position. The first
+ * char is always taken. Collecting stops at the end of string, at '\r' or '\n' chars,
+ * or when the next char starts beyond maxX - font width, i.e. when text functions
+ * must wrap the line.
+ * @param run pointer to structure to fill
+ * @param str pointer to utf8 string, must not point to terminating zero
+ * @param x position of the first char in pixels
+ * @param maxX right boundary of text area in pixels
+ * @return number of string bytes, taken by collected chars
+ */
+uint8_t ssd1306_getTextRun(STextRun *run, const char *str, lcdint_t x, lcdint_t maxX);
+
+/**
+ * @brief Breaks utf8 string to lines, fitting text area of specified width.
+ *
+ * Measures chars of the string with active font once, and stores line breaks to
+ * layout->lines array. Lines are broken at '\n' chars and at spaces before the word,
+ * which doesn't fit the line. Words, longer than the line, are broken char by char.
+ * Spaces at line breaks are not printed. Layout must be computed again, if the string
+ * content or active font are changed (see ssd1306_isTextLayoutValid()).
+ * @param layout layout to fill, lines and maxLines fields must be set by the caller
+ * @param str pointer to NULL-terminated utf8 string, the string must exist while
+ *        layout is used
+ * @param width width of text area in pixels
+ * @return number of lines in the layout. If lines array is too small, the rest of
+ *         the string is not included to the layout.
+ */
+uint8_t ssd1306_layoutText(STextLayout *layout, const char *str, lcduint_t width);
+
+/**
+ * Returns non-zero if layout was computed for specified string and active font.
+ * @param layout layout to check
+ * @param str string to check
+ */
+uint8_t ssd1306_isTextLayoutValid(const STextLayout *layout, const char *str);
+
+/**
+ * Reads glyph pixels of fonts, which store glyphs row by row (see ssd1306_isRowsFont()).
+ * Pixels are read from left to right, from top row to bottom row.
+ */
+typedef struct
+{
+    /// next byte of glyph data
+    const uint8_t *data;
+    /// remaining bits of current byte or pixel value of current RLE run
+    uint8_t value;
+    /// number of pixels, left in current byte or RLE run
+    uint8_t count;
+    /// non-zero if glyph pixels are RLE-compressed
+    uint8_t rle;
+    /// bits per pixel: 1 for monochrome fonts, 2 or 4 for anti-aliased fonts
+    uint8_t bits;
+} SGlyphReader;
+
+/**
+ * Returns non-zero if active font stores glyphs row by row, as generated by
+ * tools/fontgenerator.py with "-f rows" option. Glyphs of such fonts must be
+ * read with SGlyphReader.
+ */
+uint8_t ssd1306_isRowsFont(void);
+
+/**
+ * Returns non-zero if active font is anti-aliased rows font, generated by
+ * tools/fontgenerator.py with "-aa 2" or "-aa 4" option. Pixels of such fonts
+ * should be read with ssd1306_glyphReadAlpha().
+ */
+uint8_t ssd1306_isAlphaFont(void);
+
+/**
+ * Prepares reader for glyph of active rows font.
+ * @param reader reader to initialize
+ * @param info glyph information, returned by ssd1306_getCharBitmap()
+ */
+void ssd1306_glyphReaderInit(SGlyphReader *reader, const SCharInfo *info);
+
+/**
+ * Skips specified number of glyph pixels.
+ * @param reader glyph reader
+ * @param count number of pixels to skip
+ */
+void ssd1306_glyphSkipPixels(SGlyphReader *reader, uint16_t count);
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+static inline uint8_t __ssd1306_glyphReadMono(SGlyphReader *reader)
+{
+    if (!reader->count)
+    {
+        uint8_t data = pgm_read_byte(reader->data++);
+        if (reader->rle)
+        {
+            /* RLE byte: pixel value in bit 7, run length - 1 in bits 0-6 */
+            reader->value = data & 0x80;
+            reader->count = (data & 0x7F) + 1;
+        }
+        else
+        {
+            reader->value = data;
+            reader->count = 8;
+        }
+    }
+    reader->count--;
+    if (reader->rle)
+    {
+        return reader->value;
+    }
+    uint8_t pixel = reader->value & 0x80;
+    reader->value <<= 1;
+    return pixel;
+}
+#endif
+
+/**
+ * Reads alpha value of the next glyph pixel.
+ * @param reader glyph reader
+ * @return alpha in range 0 (transparent) - 15 (solid), monochrome pixels give 0 or 15
+ */
+static inline uint8_t ssd1306_glyphReadAlpha(SGlyphReader *reader)
+{
+    if (reader->bits == 1)
+    {
+        return __ssd1306_glyphReadMono(reader) ? 15 : 0;
+    }
+    if (!reader->count)
+    {
+        reader->value = pgm_read_byte(reader->data++);
+        reader->count = 8 >> (reader->bits >> 1);
+    }
+    reader->count--;
+    uint8_t alpha = reader->value >> (8 - reader->bits);
+    reader->value <<= reader->bits;
+    /* 2-bit alpha 0,1,2,3 is scaled to 0,5,10,15 */
+    return reader->bits == 4 ? alpha : alpha * 5;
+}
+
+/**
+ * Reads next pixel of the glyph.
+ * Pixels of anti-aliased fonts are set, if they are covered by half or more.
+ * @param reader glyph reader
+ * @return non-zero if pixel is set
+ */
+static inline uint8_t ssd1306_glyphReadPixel(SGlyphReader *reader)
+{
+    if (reader->bits == 1)
+    {
+        return __ssd1306_glyphReadMono(reader);
+    }
+    return ssd1306_glyphReadAlpha(reader) & 0x08;
+}
+
+/**
+ * Blends two RGB565 colors.
+ * @param bg background color
+ * @param fg foreground color
+ * @param alpha foreground weight in range 0 - 15
+ * @return blended color
+ */
+uint16_t ssd1306_blendColor16(uint16_t bg, uint16_t fg, uint8_t alpha);
+
+/**
+ * Blends two RGB332 colors.
+ * @param bg background color
+ * @param fg foreground color
+ * @param alpha foreground weight in range 0 - 15
+ * @return blended color
+ */
+uint8_t ssd1306_blendColor8(uint8_t bg, uint8_t fg, uint8_t alpha);
+
+/**
+ * Fills 16 entries of ramp with RGB565 colors for all alpha values, from bg to fg.
+ * Ramp is built once per text output, so anti-aliased pixels cost the same as
+ * monochrome ones.
+ * @param ramp array of 16 colors to fill
+ * @param bg background color
+ * @param fg foreground color
+ */
+void ssd1306_alphaRamp16(uint16_t *ramp, uint16_t bg, uint16_t fg);
+
+/**
+ * Fills 16 entries of ramp with RGB332 colors for all alpha values, from bg to fg.
+ * @param ramp array of 16 colors to fill
+ * @param bg background color
+ * @param fg foreground color
+ */
+void ssd1306_alphaRamp8(uint8_t *ramp, uint8_t bg, uint8_t fg);
+
+/**
+ * Transposes 8x8 block of mono pixels in place: converts 8 rows of row-major
+ * (XBM) data, lsb is the left pixel, to 8 columns of vertical page data,
+ * lsb is the top pixel, as used by ssd1306 GDRAM. The transform is symmetric,
+ * so it also converts page data back to rows.
+ * AVR uses byte loop, 32-bit cores use shift/mask butterfly on two 32-bit halves,
+ * 64-bit cores process the whole block as single 64-bit word.
+ * @param block 8 bytes to transpose
+ */
+void ssd1306_transpose8x8(uint8_t *block);
+
 
 ///////////////////////////////////////////////////////////////////////
 //                 HIGH-LEVEL GRAPH FUNCTIONS
 ///////////////////////////////////////////////////////////////////////
 
+/**
+ * Callback, returning text of menu item. Returned string must be located in SRAM
+ * and stay valid until next call of the callback, so static buffer can be used.
+ * @param index index of menu item
+ */
+typedef const char *(*TMenuItemProvider)(uint16_t index);
+
 /**
  * Describes menu object
  */
@@ -167,13 +454,17 @@ typedef struct
     /// list of menu items of the menu
     const char **items;
     /// count of menu items in the menu
-    uint8_t     count;
+    uint16_t    count;
     /// currently selected item. Internally updated.
-    uint8_t     selection;
+    uint16_t    selection;
     /// selected item, when last redraw operation was performed. Internally updated.
-    uint8_t     oldSelection;
+    uint16_t    oldSelection;
     /// position of menu scrolling. Internally updated
-    uint8_t     scrollPosition;
+    uint16_t    scrollPosition;
+    /// callback, returning text of items, or NULL if items list is used
+    TMenuItemProvider getItem;
+    /// non-zero if items list and strings are located in flash
+    uint8_t     progmem;
 } SAppMenu;
 
 /**
@@ -187,6 +478,29 @@ typedef struct
  */
 void ssd1306_createMenu(SAppMenu *menu, const char **items, uint8_t count);
 
+/**
+ * Creates menu object with the list of menu items, located in flash. Both the list
+ * and the strings must be in flash (PROGMEM). Only visible items are read from flash
+ * while drawing, so SRAM usage doesn't depend on number of items.
+ * Items are drawn up to 31 chars long.
+ *
+ * @param menu - Pointer to SAppMenu structure
+ * @param items - array of pointers to null-termintated strings (located in flash)
+ * @param count - count of menu items in the array
+ */
+void ssd1306_createMenuP(SAppMenu *menu, const char * const *items, uint16_t count);
+
+/**
+ * Creates virtual menu object. Menu doesn't keep items, text of each visible item
+ * is requested from getItem callback when the item is drawn. So menus can have
+ * large generated lists (channels, files) without keeping them in SRAM.
+ *
+ * @param menu - Pointer to SAppMenu structure
+ * @param getItem - callback, returning text of menu item by index
+ * @param count - count of menu items
+ */
+void ssd1306_createMenuEx(SAppMenu *menu, TMenuItemProvider getItem, uint16_t count);
+
 /**
  * Shows menu items on the display. If menu items cannot fit the display,
  * the function provides scrolling.
@@ -227,6 +541,9 @@ static inline void ssd1331_showMenu8(SAppMenu *menu)
 /**
  * Updates menu items on the display. That is if selection is changed,
  * the function will update only those areas, affected by the change.
+ * If menu is scrolled, visible items are moved by display controller
+ * (ssd1306_lcd.copy_block) when supported, and only new items are drawn.
+ * Otherwise visible items are redrawn without clearing the screen.
  *
  * @param menu - Pointer to SAppMenu structure
  */
@@ -235,6 +552,9 @@ void ssd1306_updateMenu(SAppMenu *menu);
 /**
  * Updates menu items on the display. That is if selection is changed,
  * the function will update only those areas, affected by the change.
+ * If menu is scrolled, visible items are moved by display controller
+ * (ssd1306_lcd.copy_block) when supported, and only new items are drawn.
+ * Otherwise visible items are redrawn without clearing the screen.
  *
  * @param menu - Pointer to SAppMenu structure
  *
@@ -245,6 +565,9 @@ void ssd1306_updateMenu8(SAppMenu *menu);
 /**
  * Updates menu items on the display. That is if selection is changed,
  * the function will update only those areas, affected by the change.
+ * If menu is scrolled, visible items are moved by display controller
+ * (ssd1306_lcd.copy_block) when supported, and only new items are drawn.
+ * Otherwise visible items are redrawn without clearing the screen.
  *
  * @param menu - Pointer to SAppMenu structure
  *
@@ -267,7 +590,7 @@ static inline void ssd1331_updateMenu8(SAppMenu *menu)
  *
  * @warning works only in 8-bit RGB normal mode.
  */
-uint8_t ssd1306_menuSelection(SAppMenu *menu);
+uint16_t ssd1306_menuSelection(SAppMenu *menu);
 
 /**
  * Moves selection pointer down by 1 item. If there are no items below,
@@ -287,6 +610,453 @@ void ssd1306_menuDown(SAppMenu *menu);
  */
 void ssd1306_menuUp(SAppMenu *menu);
 
+/**
+ * Describes text field, which redraws only changed chars
+ */
+typedef struct
+{
+    /// string, drawn last time. Buffer is provided by user. Internally updated.
+    char       *text;
+    /// size of text buffer, including terminating zero
+    uint8_t     size;
+    /// horizontal position of the field in pixels
+    lcdint_t    x;
+    /// vertical position of the field in pixels
+    lcdint_t    y;
+    /// width of the text, drawn last time, in pixels. Internally updated.
+    lcduint_t   width;
+} STextField;
+
+/**
+ * Creates text field at specified position. Nothing is drawn until the first update.
+ *
+ * @param field - Pointer to STextField structure
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in pixels (must be multiple of 8 for monochrome displays)
+ * @param buffer - buffer to keep drawn text, must exist all until field is no longer needed
+ * @param size - size of buffer, longer strings are truncated
+ */
+void ssd1306_createTextField(STextField *field, lcdint_t x, lcdint_t y, char *buffer, uint8_t size);
+
+/**
+ * Draws new text of the field, using active font. Only chars, which differ from
+ * chars at the same position in the previous text, are sent to the display. If char
+ * width changes, all chars after it are redrawn. The rest of the old text is cleared.
+ *
+ * @param field - Pointer to STextField structure
+ * @param text - new text of the field
+ */
+void ssd1306_updateTextField(STextField *field, const char *text);
+
+/**
+ * Draws new text of the field on 8-bit RGB display.
+ * @see ssd1306_updateTextField()
+ *
+ * @param field - Pointer to STextField structure
+ * @param text - new text of the field
+ */
+void ssd1306_updateTextField8(STextField *field, const char *text);
+
+/**
+ * Draws new text of the field on 16-bit RGB display.
+ * @see ssd1306_updateTextField()
+ *
+ * @param field - Pointer to STextField structure
+ * @param text - new text of the field
+ */
+void ssd1306_updateTextField16(STextField *field, const char *text);
+
+/**
+ * Formats number to string of fixed width, aligned to the right. If number needs
+ * more chars than width, only lowest digits are kept. Fixed width text fields redraw
+ * only changed digits.
+ *
+ * @param buffer - buffer of at least width + 1 bytes
+ * @param value - number to format
+ * @param width - number of chars in the string
+ * @param fill - char for unused positions, usually ' ' or '0'
+ * @return buffer
+ */
+char *ssd1306_formatNumber(char *buffer, int32_t value, uint8_t width, char fill);
+
+/**
+ * Describes progress bar or gauge, which redraws only changed part of the bar
+ */
+typedef struct
+{
+    /// horizontal position of left-top corner in pixels
+    lcdint_t    x;
+    /// vertical position of left-top corner in pixels
+    lcdint_t    y;
+    /// width of the bar in pixels
+    lcduint_t   width;
+    /// height of the bar in pixels
+    lcduint_t   height;
+    /// value, corresponding to completely filled bar
+    uint16_t    maxValue;
+    /// number of filled columns (rows for gauge), drawn last time. Internally updated.
+    lcduint_t   fill;
+    /// 0 for bar, filled from left to right, 1 for gauge, filled from bottom to top
+    uint8_t     vertical;
+} SProgressBar;
+
+/**
+ * Creates horizontal progress bar, filled from left to right. The area of the bar
+ * is expected to be clear. Nothing is drawn until the first update.
+ * Frame around the bar, if needed, must be drawn by application once.
+ *
+ * @param bar - Pointer to SProgressBar structure
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in pixels
+ * @param w - width of the bar in pixels
+ * @param h - height of the bar in pixels
+ * @param maxValue - value, corresponding to completely filled bar
+ */
+void ssd1306_createProgressBar(SProgressBar *bar, lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, uint16_t maxValue);
+
+/**
+ * Creates vertical gauge, filled from bottom to top.
+ * @see ssd1306_createProgressBar()
+ *
+ * @param bar - Pointer to SProgressBar structure
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in pixels
+ * @param w - width of the gauge in pixels
+ * @param h - height of the gauge in pixels
+ * @param maxValue - value, corresponding to completely filled gauge
+ */
+void ssd1306_createGauge(SProgressBar *bar, lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h, uint16_t maxValue);
+
+/**
+ * Sets new value of progress bar or gauge on monochrome display. Only columns
+ * (rows for gauge) between old and new fill boundaries are sent to the display.
+ * Pixels of display pages, partially covered by the bar, are cleared, so place
+ * the bar on page boundaries, if other content shares the same pages.
+ *
+ * @param bar - Pointer to SProgressBar structure
+ * @param value - new value, values above maxValue fill the whole bar
+ */
+void ssd1306_updateProgressBar(SProgressBar *bar, uint16_t value);
+
+/**
+ * Sets new value of progress bar or gauge on 8-bit RGB display, using active color.
+ * Emptied part of the bar is filled with black color.
+ * @see ssd1306_updateProgressBar()
+ *
+ * @param bar - Pointer to SProgressBar structure
+ * @param value - new value, values above maxValue fill the whole bar
+ */
+void ssd1306_updateProgressBar8(SProgressBar *bar, uint16_t value);
+
+/**
+ * Sets new value of progress bar or gauge on 16-bit RGB display, using active color.
+ * Emptied part of the bar is filled with black color.
+ * @see ssd1306_updateProgressBar()
+ *
+ * @param bar - Pointer to SProgressBar structure
+ * @param value - new value, values above maxValue fill the whole bar
+ */
+void ssd1306_updateProgressBar16(SProgressBar *bar, uint16_t value);
+
+/**
+ * Describes sparkline: small chart of recent values, one column per value
+ */
+typedef struct
+{
+    /// horizontal position of left-top corner in pixels
+    lcdint_t    x;
+    /// vertical position of left-top corner in pixels
+    lcdint_t    y;
+    /// width of the chart in pixels
+    lcduint_t   width;
+    /// height of the chart in pixels
+    lcduint_t   height;
+    /// value, drawn at the bottom of the chart
+    int16_t     minValue;
+    /// value, drawn at the top of the chart
+    int16_t     maxValue;
+    /// column for the next value, relative to x. Internally updated.
+    lcduint_t   pos;
+    /// vertical position of the last value. Internally updated.
+    lcdint_t    last;
+    /// number of added values, saturated at width. Internally updated.
+    lcduint_t   count;
+} SSparkline;
+
+/**
+ * Creates sparkline in specified area. The area is expected to be clear.
+ *
+ * @param line - Pointer to SSparkline structure
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in pixels
+ * @param w - width of the chart in pixels
+ * @param h - height of the chart in pixels
+ * @param minValue - value, drawn at the bottom of the chart
+ * @param maxValue - value, drawn at the top of the chart
+ */
+void ssd1306_createSparkline(SSparkline *line, lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                             int16_t minValue, int16_t maxValue);
+
+/**
+ * Adds new value to sparkline on monochrome display. Only single column is sent
+ * to the display: vertical span between previous and new values. When the chart is
+ * full, drawing continues from the left side, and the column after the new one is
+ * cleared to show the current position.
+ * Pixels of display pages, partially covered by the chart, are cleared.
+ *
+ * @param line - Pointer to SSparkline structure
+ * @param value - new value
+ */
+void ssd1306_addSparklineValue(SSparkline *line, int16_t value);
+
+/**
+ * Adds new value to sparkline on 8-bit RGB display, using active color.
+ * When the chart is full, its content is shifted left by one column with
+ * ssd1306_copyBlock(), if display supports it, and new value is drawn
+ * in the rightmost column. Otherwise drawing continues from the left side.
+ * @see ssd1306_addSparklineValue()
+ *
+ * @param line - Pointer to SSparkline structure
+ * @param value - new value
+ */
+void ssd1306_addSparklineValue8(SSparkline *line, int16_t value);
+
+/**
+ * Adds new value to sparkline on 16-bit RGB display, using active color.
+ * @see ssd1306_addSparklineValue8()
+ *
+ * @param line - Pointer to SSparkline structure
+ * @param value - new value
+ */
+void ssd1306_addSparklineValue16(SSparkline *line, int16_t value);
+
+/**
+ * Describes scrolling plot, which keeps recent samples in ring buffer
+ */
+typedef struct
+{
+    /// horizontal position of left-top corner in pixels
+    lcdint_t    x;
+    /// vertical position of left-top corner in pixels
+    lcdint_t    y;
+    /// width of the plot in pixels, equal to number of samples in the buffer
+    lcduint_t   width;
+    /// height of the plot in pixels, up to 256
+    lcduint_t   height;
+    /// value, drawn at the bottom of the plot
+    int16_t     minValue;
+    /// value, drawn at the top of the plot
+    int16_t     maxValue;
+    /// ring buffer of width bytes, provided by user. Keeps rows of samples.
+    uint8_t    *samples;
+    /// index of the oldest sample in the buffer. Internally updated.
+    lcduint_t   head;
+    /// number of samples in the buffer. Internally updated.
+    lcduint_t   count;
+} SPlot;
+
+/**
+ * Creates scrolling plot in specified area. The area is expected to be clear.
+ *
+ * @param plot - Pointer to SPlot structure
+ * @param x - horizontal position in pixels
+ * @param y - vertical position in pixels
+ * @param w - width of the plot in pixels
+ * @param h - height of the plot in pixels
+ * @param buffer - buffer of w bytes for samples, must exist all until plot is no longer needed
+ * @param minValue - value, drawn at the bottom of the plot
+ * @param maxValue - value, drawn at the top of the plot
+ */
+void ssd1306_createPlot(SPlot *plot, lcdint_t x, lcdint_t y, lcduint_t w, lcduint_t h,
+                        uint8_t *buffer, int16_t minValue, int16_t maxValue);
+
+/**
+ * Adds new sample to the plot on monochrome display. Until the plot is full,
+ * only new column is sent: vertical span between previous and new samples.
+ * When the plot is full, the oldest sample is dropped and the plot is scrolled
+ * left by resending it from samples buffer, single block per display page.
+ * Pixels of display pages, partially covered by the plot, are cleared.
+ *
+ * @param plot - Pointer to SPlot structure
+ * @param value - new sample
+ */
+void ssd1306_addPlotSample(SPlot *plot, int16_t value);
+
+/**
+ * Adds new sample to the plot on 8-bit RGB display, using active color.
+ * When the plot is full, it is scrolled with ssd1306_copyBlock(), if display
+ * supports it, and only new column is sent. Otherwise the plot is resent
+ * from samples buffer as single block.
+ * @see ssd1306_addPlotSample()
+ *
+ * @param plot - Pointer to SPlot structure
+ * @param value - new sample
+ */
+void ssd1306_addPlotSample8(SPlot *plot, int16_t value);
+
+/**
+ * Adds new sample to the plot on 16-bit RGB display, using active color.
+ * @see ssd1306_addPlotSample8()
+ *
+ * @param plot - Pointer to SPlot structure
+ * @param value - new sample
+ */
+void ssd1306_addPlotSample16(SPlot *plot, int16_t value);
+
+/**
+ * Redraws the whole plot on monochrome display, for example, after the screen is cleared.
+ *
+ * @param plot - Pointer to SPlot structure
+ */
+void ssd1306_drawPlot(const SPlot *plot);
+
+/**
+ * Redraws the whole plot on 8-bit RGB display, using active color.
+ *
+ * @param plot - Pointer to SPlot structure
+ */
+void ssd1306_drawPlot8(const SPlot *plot);
+
+/**
+ * Redraws the whole plot on 16-bit RGB display, using active color.
+ *
+ * @param plot - Pointer to SPlot structure
+ */
+void ssd1306_drawPlot16(const SPlot *plot);
+
+/**
+ * Callback, receiving span of pixels, produced by shape rasterizers.
+ * For horizontal spans line is y and a, b are x of the first and the last pixel.
+ * For vertical spans (GFX_SPANS_COLUMNS flag) line is x and a, b are y coordinates.
+ */
+typedef void (*gfx_span_cb)(void *ctx, lcdint_t line, lcdint_t a, lcdint_t b);
+
+/** Shape rasterizer flag: emit spans, filling the shape, instead of outline spans */
+#define GFX_SPANS_FILL      0x01
+/** Shape rasterizer flag: emit vertical spans (columns) instead of horizontal ones */
+#define GFX_SPANS_COLUMNS   0x02
+
+/**
+ * Rasterizes rectangle with elliptic corners into spans. Ellipse is the rectangle
+ * with corner radii equal to half of its size, circle is the ellipse with equal radii.
+ * Each pixel is emitted once. Radii are limited to half of the rectangle size
+ * and must not exceed 160 pixels.
+ *
+ * @param x1 - left position in pixels
+ * @param y1 - top position in pixels
+ * @param x2 - right position in pixels
+ * @param y2 - bottom position in pixels
+ * @param rx - horizontal radius of corners
+ * @param ry - vertical radius of corners
+ * @param flags - GFX_SPANS_FILL, GFX_SPANS_COLUMNS
+ * @param span - callback, receiving spans
+ * @param ctx - argument to pass to callback
+ */
+void gfx_roundRectSpans(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2,
+                        lcduint_t rx, lcduint_t ry, uint8_t flags, gfx_span_cb span, void *ctx);
+
+/**
+ * Rasterizes filled triangle into spans, one span per line.
+ *
+ * @param xy - 3 vertices as x, y pairs
+ * @param flags - GFX_SPANS_COLUMNS or 0
+ * @param span - callback, receiving spans
+ * @param ctx - argument to pass to callback
+ */
+void gfx_triangleSpans(const lcdint_t *xy, uint8_t flags, gfx_span_cb span, void *ctx);
+
+/**
+ * Rasterizes filled polygon into spans, using even-odd rule. Pixel is filled if its
+ * center lies inside the polygon, so the result should be combined with polygon
+ * outline to cover the edges. Up to 16 edges may cross single line.
+ *
+ * @param xy - vertices as x, y pairs
+ * @param count - number of vertices
+ * @param flags - GFX_SPANS_COLUMNS or 0
+ * @param span - callback, receiving spans
+ * @param ctx - argument to pass to callback
+ */
+void gfx_polygonSpans(const lcdint_t *xy, uint8_t count, uint8_t flags, gfx_span_cb span, void *ctx);
+
+/**
+ * Draws circle outline on monochrome display.
+ * Pixels of display pages, touched by the outline, are cleared.
+ *
+ * @param x - horizontal position of the center
+ * @param y - vertical position of the center
+ * @param r - radius in pixels
+ */
+void ssd1306_drawCircle(lcdint_t x, lcdint_t y, lcduint_t r);
+
+/**
+ * Draws filled circle on monochrome display. Circle is drawn as vertical
+ * column runs, so other pixels of the touched display pages are cleared.
+ *
+ * @param x - horizontal position of the center
+ * @param y - vertical position of the center
+ * @param r - radius in pixels
+ */
+void ssd1306_fillCircle(lcdint_t x, lcdint_t y, lcduint_t r);
+
+/**
+ * Draws rectangle with rounded corners on monochrome display.
+ *
+ * @param x1 - left position in pixels
+ * @param y1 - top position in pixels
+ * @param x2 - right position in pixels
+ * @param y2 - bottom position in pixels
+ * @param r - radius of corners
+ */
+void ssd1306_drawRoundRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r);
+
+/**
+ * Draws filled rectangle with rounded corners on monochrome display.
+ * @see ssd1306_fillCircle()
+ *
+ * @param x1 - left position in pixels
+ * @param y1 - top position in pixels
+ * @param x2 - right position in pixels
+ * @param y2 - bottom position in pixels
+ * @param r - radius of corners
+ */
+void ssd1306_fillRoundRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r);
+
+/**
+ * Draws filled triangle on monochrome display.
+ * @see ssd1306_fillCircle()
+ */
+void ssd1306_fillTriangle(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x3, lcdint_t y3);
+
+/** Draws circle outline on 8-bit RGB display, using active color */
+void ssd1306_drawCircle8(lcdint_t x, lcdint_t y, lcduint_t r);
+
+/** Draws filled circle on 8-bit RGB display, using active color */
+void ssd1306_fillCircle8(lcdint_t x, lcdint_t y, lcduint_t r);
+
+/** Draws rectangle with rounded corners on 8-bit RGB display, using active color */
+void ssd1306_drawRoundRect8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r);
+
+/** Draws filled rectangle with rounded corners on 8-bit RGB display, using active color */
+void ssd1306_fillRoundRect8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r);
+
+/** Draws filled triangle on 8-bit RGB display, using active color */
+void ssd1306_fillTriangle8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x3, lcdint_t y3);
+
+/** Draws circle outline on 16-bit RGB display, using active color */
+void ssd1306_drawCircle16(lcdint_t x, lcdint_t y, lcduint_t r);
+
+/** Draws filled circle on 16-bit RGB display, using active color */
+void ssd1306_fillCircle16(lcdint_t x, lcdint_t y, lcduint_t r);
+
+/** Draws rectangle with rounded corners on 16-bit RGB display, using active color */
+void ssd1306_drawRoundRect16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r);
+
+/** Draws filled rectangle with rounded corners on 16-bit RGB display, using active color */
+void ssd1306_fillRoundRect16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r);
+
+/** Draws filled triangle on 16-bit RGB display, using active color */
+void ssd1306_fillTriangle16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x3, lcdint_t y3);
+
 /**
  * @}
  */
@@ -38,6 +38,7 @@
 
 #include "ssd1306_hal/io.h"
 #include <stdio.h>
+#include <string.h>
 
 /** Implements own Print class for plain AVR and Linux environment */
 class Print
@@ -54,21 +55,32 @@ public:
     virtual size_t write(uint8_t ch) = 0;
 
     /**
-     * Prints string via write()
-     * @param str string to print
+     * Writes buffer via write(uint8_t). Inherited classes can override it to
+     * output whole buffer at once.
+     * @param buffer chars to print
+     * @param size number of chars in the buffer
      * @return returns number of printed symbols
      */
-    size_t print(const char* str)
+    virtual size_t write(const uint8_t *buffer, size_t size)
     {
         size_t n = 0;
-        while (*str)
+        while (size--)
         {
-            n += write(*str);
-            str++;
+            n += write(*buffer++);
         }
         return n;
     }
 
+    /**
+     * Prints string via write(const uint8_t *, size_t)
+     * @param str string to print
+     * @return returns number of printed symbols
+     */
+    size_t print(const char* str)
+    {
+        return write(reinterpret_cast<const uint8_t *>(str), strlen(str));
+    }
+
     /**
      * Prints number via write()
      * @param n integer to print
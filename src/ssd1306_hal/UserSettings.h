@@ -51,21 +51,75 @@
 /** Define this macro if you need to enable software I2C module for compilation */
 #define CONFIG_SOFTWARE_I2C_ENABLE
 
+/**
+ * Define this macro to switch software I2C module to fast mode. Fast mode ignores
+ * datasheet timings, keeps interrupts disabled only while single byte is sent, and
+ * requires external pull-up resistors on SCL and SDA lines. Bus clock is limited by
+ * CONFIG_SOFTWARE_I2C_FAST_DELAY (number of 4-cycle delay loops per half-clock, 0 by
+ * default, giving about 1 MHz at 8 MHz). Define CONFIG_SOFTWARE_I2C_FAST_NO_ACK to
+ * skip SDA release before confirmation impulse for write-only devices.
+ */
+#ifndef CONFIG_SOFTWARE_I2C_FAST_ENABLE
+//#define CONFIG_SOFTWARE_I2C_FAST_ENABLE
+#endif
+
 /** Define this macro if you need to enable TWI I2C module for compilation */
 #define CONFIG_TWI_I2C_ENABLE
 
+/**
+ * Define this macro to make TWI I2C module interrupt-driven. Bytes are put to the queue
+ * of CONFIG_TWI_I2C_QUEUE_SIZE entries (power of 2, 32 by default) and sent in background,
+ * ssd1306_intf.stop() doesn't wait for transfer to complete, use ssd1306_intf.wait() for
+ * that. Global interrupts must be enabled. The module takes TWI interrupt vector, so it
+ * cannot be used together with Wire library (disable CONFIG_PLATFORM_I2C_ENABLE).
+ */
+#ifndef CONFIG_TWI_I2C_ISR_ENABLE
+//#define CONFIG_TWI_I2C_ISR_ENABLE
+#endif
+
 /** Define this macro if you need to enable AVR SPI module for compilation */
 #define CONFIG_AVR_SPI_ENABLE
 
 /** Define this macro if you need to enable USI SPI module for compilation */
 #define CONFIG_USI_SPI_ENABLE
 
+/**
+ * Define this macro if you need to enable USI I2C module for compilation. If enabled,
+ * ssd1306_i2cInit() uses USI hardware pins instead of Wire library or software i2c.
+ */
+#ifndef CONFIG_USI_I2C_ENABLE
+//#define CONFIG_USI_I2C_ENABLE
+#endif
+
+/** Define this macro if you need to enable USART SPI (master SPI mode) module for compilation */
+#define CONFIG_USART_SPI_ENABLE
+
+/**
+ * Define this macro to enable 3-wire 9-bit SPI mode for displays without D/C line.
+ * If enabled, negative dcPin, passed to ssd1306_spiInit() or xxx_spi_init() functions
+ * of displays, selects 3-wire mode (see ssd1306_spi3WireAttach()).
+ */
+#ifndef CONFIG_SPI_3WIRE_ENABLE
+//#define CONFIG_SPI_3WIRE_ENABLE
+#endif
+
 /** Define this macro if you need to enable AVR UART module for compilation */
 #define CONFIG_AVR_UART_ENABLE
 
 /** Define this macro if you need to enable VGA module for compilation */
 #define CONFIG_VGA_ENABLE
 
+/** Define this macro if you need to enable network mirroring module for compilation */
+#define CONFIG_NET_MIRROR_ENABLE
+
+/**
+ * Define this macro if you need to enable deferred interface module for compilation
+ * (see ssd1306_deferredAttach()). On Linux the application must be linked with -pthread.
+ */
+#ifndef CONFIG_DEFERRED_INTF_ENABLE
+//#define CONFIG_DEFERRED_INTF_ENABLE
+#endif
+
 /** Define this macro if you need to enable Adafruit GFX canvas support for compilation */
 #ifndef CONFIG_ADAFRUIT_GFX_ENABLE
 //#define CONFIG_ADAFRUIT_GFX_ENABLE
@@ -77,12 +131,204 @@
  */
 #define CONFIG_PLATFORM_I2C_ENABLE
 
+/**
+ * Define this macro to i2c clock frequency in Hz, used by platform specific i2c
+ * implementation (ESP32 IDF, Arduino Wire). 400000 is used by default. Many displays
+ * work at 800000-1000000 (Fast-mode Plus) with short wires and strong pull-ups.
+ */
+#ifndef CONFIG_PLATFORM_I2C_FREQ
+//#define CONFIG_PLATFORM_I2C_FREQ 1000000
+#endif
+
 /**
  * Define this macro if platform specific spi interface is implemented in SSD1306 HAL
  * If you use Arduino platform, this macro enables Arduino SPI library module for compilation.
  */
 #define CONFIG_PLATFORM_SPI_ENABLE
 
+/**
+ * Define this macro to enable platform specific 8080 parallel interface
+ * (ESP32 I2S in LCD mode via esp_lcd, STM32 FSMC). See ssd1306_platform_parallelInit().
+ */
+#ifndef CONFIG_PLATFORM_PARALLEL_ENABLE
+//#define CONFIG_PLATFORM_PARALLEL_ENABLE
+#endif
+
+/**
+ * Define this macro if platform specific frame timer is implemented in SSD1306 HAL
+ * and should be used by NanoEngine (see NanoEngineCore::useFrameTimer()).
+ * On AVR the timer takes TIMER1 and its compare interrupt, so it cannot be used
+ * together with VGA module or other libraries, using TIMER1.
+ */
+#ifndef CONFIG_PLATFORM_TIMER_ENABLE
+//#define CONFIG_PLATFORM_TIMER_ENABLE
+#endif
+
+/**
+ * Define this macro to sample NanoEngine inputs in background, when events are enabled
+ * (see NanoEngineInputs::enableEvents()). Inputs are sampled every millisecond by esp_timer
+ * on ESP32 and by TIMER0 compare interrupt on AVR (TIMER0 overflow is still free for
+ * millis()). On AVR Z-keypad ADC is switched to free-running mode, and takes ADC interrupt.
+ */
+#ifndef CONFIG_NANO_ENGINE_INPUT_ISR_ENABLE
+//#define CONFIG_NANO_ENGINE_INPUT_ISR_ENABLE
+#endif
+
+/**
+ * Define this macro to control Linux gpio pins (D/C, reset) via gpio character device
+ * instead of sysfs. Pin numbers are line offsets of SSD1306_LINUX_GPIOCHIP chip
+ * (/dev/gpiochip0 by default). Each line is requested once and kept open.
+ * Without this macro sysfs value files are used, and they are also kept open.
+ */
+#ifndef CONFIG_LINUX_GPIOCHIP_ENABLE
+//#define CONFIG_LINUX_GPIOCHIP_ENABLE
+#endif
+
+/**
+ * Define this macro to control gpio pins of Raspberry Pi (BCM2835-BCM2711) via
+ * memory mapped registers of /dev/gpiomem. Pin numbers are BCM gpio numbers.
+ * This is the fastest way to toggle D/C pin, but it works only on Raspberry Pi.
+ */
+#ifndef CONFIG_LINUX_RPI_GPIO_ENABLE
+//#define CONFIG_LINUX_RPI_GPIO_ENABLE
+#endif
+
+/**
+ * Define this macro to collect statistics on interface usage: number of transactions,
+ * bytes sent, commands vs data, time spent on the bus. See ssd1306_intfStatsGet().
+ * Statistics collection slows down communication with the display.
+ */
+#ifndef CONFIG_SSD1306_INTF_STATS_ENABLE
+//#define CONFIG_SSD1306_INTF_STATS_ENABLE
+#endif
+
+/**
+ * Define this macro to share spi bus with other devices (SD card, radio) in bursts:
+ * display transactions between ssd1306_busBeginBurst() and ssd1306_busEndBurst()
+ * keep the bus and chip select, so transaction setup is not paid on each set_block().
+ * NanoEngine holds the bus for the whole frame. See ssd1306_busShareAttach().
+ */
+#ifndef CONFIG_SSD1306_BUS_SHARE_ENABLE
+//#define CONFIG_SSD1306_BUS_SHARE_ENABLE
+#endif
+
+/**
+ * Define this macro to compile tracepoints around driver and NanoEngine hot paths
+ * (see ssd1306_trace.h). Without this macro tracepoints have no overhead.
+ */
+#ifndef CONFIG_SSD1306_TRACE_ENABLE
+//#define CONFIG_SSD1306_TRACE_ENABLE
+#endif
+
+/**
+ * Define this macro to track GDRAM pointer of monochrome displays with horizontal
+ * addressing mode (ssd1306). If the next block starts exactly where the previous write
+ * ended, set_block() does not send address commands again. This saves few bytes per
+ * drawing call on i2c, but every byte sent to the display is counted. Do not use
+ * it with CONFIG_SSD1306_STATIC_AVR_SPI or CONFIG_SSD1306_STATIC_MONO_LCD.
+ */
+#ifndef CONFIG_SSD1306_WINDOW_CACHE_ENABLE
+//#define CONFIG_SSD1306_WINDOW_CACHE_ENABLE
+#endif
+
+/**
+ * Define this macro to send window commands and pixels to i2c controllers with ssd1306
+ * style control byte (ssd1306, ssd1325) in single transaction, like sh1106 driver does. Each command byte
+ * is preceded by control byte with continuation (Co) bit, and GDRAM data follows
+ * without STOP and new address phase. Commands take 2 bytes each, so the option pays
+ * off when i2c transaction itself is expensive (Wire library, Linux i2c-dev, ESP32 driver).
+ * Custom i2c backends, which split long transactions to chunks, must restart chunks
+ * with the control byte, tracked by ssd1306_i2cControlTrack(), as built-in backends do.
+ */
+#ifndef CONFIG_SSD1306_I2C_INTERLEAVE_ENABLE
+//#define CONFIG_SSD1306_I2C_INTERLEAVE_ENABLE
+#endif
+
+/**
+ * Define this macro to number of glyphs to cache. Glyph cache keeps information on
+ * recently printed chars, so fonts with unicode tables do not need to be searched
+ * each time the same char is printed. Each cache entry takes 10-16 bytes of RAM.
+ */
+#ifndef CONFIG_SSD1306_GLYPH_CACHE_SIZE
+//#define CONFIG_SSD1306_GLYPH_CACHE_SIZE 16
+#endif
+
+/**
+ * Define this macro to place interface send functions, buffer blit loops and composite
+ * video output loop of ESP32 to internal RAM (IRAM_ATTR). Code in IRAM doesn't stall
+ * on flash cache misses, so frame time doesn't jitter during heavy SPI transfers.
+ * Takes about 3 KiB of IRAM, ignored on other platforms.
+ */
+#ifndef CONFIG_ESP32_IRAM_ENABLE
+//#define CONFIG_ESP32_IRAM_ENABLE
+#endif
+
+/**
+ * Define this macro to allocate full-screen buffers of NanoEngine (see useScreenBuffer())
+ * in ESP32 PSRAM. Then the frame is drawn, compared and sent by strips, copied to
+ * internal RAM with sequential bursts, so PSRAM latency doesn't slow down drawing and
+ * DMA transfers. Ignored on other platforms.
+ */
+#ifndef CONFIG_ESP32_PSRAM_ENABLE
+//#define CONFIG_ESP32_PSRAM_ENABLE
+#endif
+
+/**
+ * Define this macro to enable ssd1306_setFixedFontCached(), which copies glyphs of
+ * the font from flash to RAM, so text output doesn't read flash through the cache.
+ * Not available on AVR, where fonts are read from program memory by special instructions.
+ */
+#ifndef CONFIG_FONT_RAM_CACHE_ENABLE
+//#define CONFIG_FONT_RAM_CACHE_ENABLE
+#endif
+
+/**
+ * Define this macro to bind the library to hardware AVR SPI at compile time. Drawing
+ * functions send data bytes directly via inline SPI functions instead of ssd1306_intf
+ * table. Use it only if display is always connected via ssd1306_spiInit_avr().
+ * Interface statistics do not count bytes, sent this way.
+ */
+#ifndef CONFIG_SSD1306_STATIC_AVR_SPI
+//#define CONFIG_SSD1306_STATIC_AVR_SPI
+#endif
+
+/**
+ * Define these macros to bind D/C and chip select lines of AVR SPI interfaces to port
+ * bits at compile time, for example PORTD and 5. Then each line switch is single sbi/cbi
+ * instruction instead of digitalWrite() call. Pins, passed to init functions, must refer
+ * to the same lines, since they are still used to configure pins as outputs.
+ * Undefined lines are switched via runtime pin numbers.
+ */
+#ifndef CONFIG_AVR_SPI_DC_PORT
+//#define CONFIG_AVR_SPI_DC_PORT  PORTD
+//#define CONFIG_AVR_SPI_DC_BIT   5
+#endif
+#ifndef CONFIG_AVR_SPI_CS_PORT
+//#define CONFIG_AVR_SPI_CS_PORT  PORTD
+//#define CONFIG_AVR_SPI_CS_BIT   4
+#endif
+
+/**
+ * Define these macros to bind SCL and SDA lines of software I2C module to bits of its
+ * port (PORTB on ATtiny25/45/85, PORTA on ATtiny24/44/84, PORTC on ATmega) at compile
+ * time. Then each bus edge is single sbi/cbi instruction, and pins, passed to
+ * ssd1306_i2cInit_Embedded(), are ignored.
+ */
+#ifndef CONFIG_SOFTWARE_I2C_SCL_BIT
+//#define CONFIG_SOFTWARE_I2C_SCL_BIT  SSD1306_SCL
+//#define CONFIG_SOFTWARE_I2C_SDA_BIT  SSD1306_SDA
+#endif
+
+/**
+ * Define this macro if the only display, used by application, is monochrome
+ * ssd1306, sh1106 or pcd8544 controller. 1-bit drawing functions send pixels to the
+ * interface directly, bypassing ssd1306_lcd table. Shadow buffer mode
+ * (ssd1306_enableShadowBuffer()) is not supported in this configuration.
+ */
+#ifndef CONFIG_SSD1306_STATIC_MONO_LCD
+//#define CONFIG_SSD1306_STATIC_MONO_LCD
+#endif
+
 /**
  * Defines, whenever ssd1306 library supports unicode.
  * Support of unicode increases RAM and Flasg memory consumption
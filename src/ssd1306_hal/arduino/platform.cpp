@@ -40,13 +40,38 @@
 
 #include <Wire.h>
 
+#ifndef CONFIG_PLATFORM_I2C_FREQ
+#define CONFIG_PLATFORM_I2C_FREQ  400000
+#endif
+
+/* Max number of bytes in single transmission, including control byte. *
+ * Do not write too many bytes for standard Wire.h. It may become broken */
+#if defined(ESP32) || defined(ESP31B)
+    #if defined(I2C_BUFFER_LENGTH)
+        #define SSD1306_WIRE_CHUNK  I2C_BUFFER_LENGTH
+    #else
+        #define SSD1306_WIRE_CHUNK  128
+    #endif
+#elif defined(ARDUINO_ARCH_SAMD)
+    #define SSD1306_WIRE_CHUNK  255
+#elif defined(BUFFER_LENGTH)
+    #define SSD1306_WIRE_CHUNK  (BUFFER_LENGTH - 2)
+#elif defined(SERIAL_BUFFER_LENGTH)
+    #define SSD1306_WIRE_CHUNK  (SERIAL_BUFFER_LENGTH - 2)
+#elif defined(USI_BUF_SIZE)
+    #define SSD1306_WIRE_CHUNK  (USI_BUF_SIZE - 2)
+#endif
+
 static uint8_t s_bytesWritten = 0;
 static uint8_t s_sa = SSD1306_SA;
+/* Control byte to restart transmission with, see ssd1306_i2cControlTrack() */
+static uint8_t s_control = SSD1306_I2C_CONTROL_NEXT;
 
 static void ssd1306_i2cStart_Wire(void)
 {
     Wire.beginTransmission(s_sa);
     s_bytesWritten = 0;
+    s_control = SSD1306_I2C_CONTROL_NEXT;
 }
 
 static void ssd1306_i2cStop_Wire(void)
@@ -54,47 +79,72 @@ static void ssd1306_i2cStop_Wire(void)
     Wire.endTransmission();
 }
 
+/* Restarts transmission, when Wire buffer is full. New transmission starts *
+ * with control byte, which is active at the point, where data were cut.   */
+static void ssd1306_i2cRestart_Wire(void)
+{
+    ssd1306_i2cStop_Wire();
+    Wire.beginTransmission(s_sa);
+    s_bytesWritten = 0;
+    if (s_control != SSD1306_I2C_CONTROL_NEXT)
+    {
+        Wire.write(s_control);
+        s_bytesWritten = 1;
+    }
+}
+
 /**
  * Inputs: SCL is LOW, SDA is has no meaning
  * Outputs: SCL is LOW
  */
 static void ssd1306_i2cSendByte_Wire(uint8_t data)
 {
-    // Do not write too many bytes for standard Wire.h. It may become broken
-#if defined(ESP32) || defined(ESP31B)
-    if (s_bytesWritten >= (I2C_BUFFER_LENGTH >> 4))
-#elif defined(ARDUINO_ARCH_SAMD)
-    if (s_bytesWritten >= 64)
-#elif defined(BUFFER_LENGTH)
-    if (s_bytesWritten >= (BUFFER_LENGTH - 2))
-#elif defined(SERIAL_BUFFER_LENGTH)
-    if (s_bytesWritten >= (SERIAL_BUFFER_LENGTH - 2))
-#elif defined(USI_BUF_SIZE)
-    if (s_bytesWritten >= (USI_BUF_SIZE -2))
+#if defined(SSD1306_WIRE_CHUNK)
+    if (s_bytesWritten >= SSD1306_WIRE_CHUNK)
+    {
+        ssd1306_i2cRestart_Wire();
+    }
 #else
     if ( Wire.write(data) != 0 )
     {
         s_bytesWritten++;
+        s_control = ssd1306_i2cControlTrack(s_control, &data, 1);
         return;
     }
+    ssd1306_i2cRestart_Wire();
 #endif
-    {
-        ssd1306_i2cStop_Wire();
-        ssd1306_i2cStart_Wire();
-        ssd1306_i2cSendByte_Wire(0x40);
-        /* Commands never require many bytes. Thus assume that user tries to send data */
-    }
     Wire.write(data);
     s_bytesWritten++;
+    s_control = ssd1306_i2cControlTrack(s_control, &data, 1);
 }
 
 static void ssd1306_i2cSendBytes_Wire(const uint8_t *buffer, uint16_t size)
 {
+#if defined(SSD1306_WIRE_CHUNK)
+    while (size)
+    {
+        if (s_bytesWritten >= SSD1306_WIRE_CHUNK)
+        {
+            ssd1306_i2cRestart_Wire();
+        }
+        uint8_t len = SSD1306_WIRE_CHUNK - s_bytesWritten;
+        if (len > size)
+        {
+            len = size;
+        }
+        Wire.write(buffer, len);
+        s_bytesWritten += len;
+        s_control = ssd1306_i2cControlTrack(s_control, buffer, len);
+        buffer += len;
+        size -= len;
+    }
+#else
     while (size--)
     {
         ssd1306_i2cSendByte_Wire(*buffer);
         buffer++;
     }
+#endif
 }
 
 static void ssd1306_i2cClose_Wire()
@@ -114,7 +164,7 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t addr, ssd1306_platform_i2cCo
         Wire.begin();
     }
     #ifdef SSD1306_WIRE_CLOCK_CONFIGURABLE
-        Wire.setClock(400000);
+        Wire.setClock(CONFIG_PLATFORM_I2C_FREQ);
     #endif
 
     if (addr) s_sa = addr;
@@ -166,21 +216,41 @@ static void ssd1306_spiStop_hw()
     SPI.endTransaction();
 }
 
-static void ssd1306_spiSendByte_hw(uint8_t data)
+static void SSD1306_IRAM ssd1306_spiSendByte_hw(uint8_t data)
 {
     SPI.transfer(data);
 }
 
+#if defined(ESP8266) || defined(ESP32) || defined(ESP31B)
+
+static void SSD1306_IRAM ssd1306_spiSendBytes_hw(const uint8_t *buffer, uint16_t size)
+{
+    /* writeBytes() doesn't read back data, and loads hardware FIFO (64 bytes) at once */
+    SPI.writeBytes((uint8_t *)buffer, size);
+}
+
+#else
+
+/* Size of stack buffer, used for block transfers */
+#define SSD1306_SPI_BOUNCE_SIZE  32
+
 static void ssd1306_spiSendBytes_hw(const uint8_t *buffer, uint16_t size)
 {
-    /* Do not use SPI.transfer(buffer, size)! this method corrupts buffer content */
-    while (size--)
+    /* SPI.transfer(buffer, size) replaces buffer content with received bytes, *
+     * so data are copied to small bounce buffer first                        */
+    uint8_t bounce[SSD1306_SPI_BOUNCE_SIZE];
+    while (size)
     {
-        SPI.transfer(*buffer);
-        buffer++;
-    };
+        uint8_t len = size < sizeof(bounce) ? size : sizeof(bounce);
+        memcpy(bounce, buffer, len);
+        SPI.transfer(bounce, len);
+        buffer += len;
+        size -= len;
+    }
 }
 
+#endif
+
 void ssd1306_platform_spiInit(int8_t busId, int8_t cesPin, int8_t dcPin)
 {
     if (cesPin >=0) pinMode(cesPin, OUTPUT);
@@ -50,6 +50,8 @@
     #define CONFIG_SOFTWARE_I2C_AVAILABLE
     /** The macro is defined when USI module is available for use */
     #define CONFIG_USI_SPI_AVAILABLE
+    /** The macro is defined when USI module is available for use as i2c master */
+    #define CONFIG_USI_I2C_AVAILABLE
     /* Define lcdint as smallest types to reduce memo usage on tiny controllers. *
      * Remember, that this can cause issues with large lcd displays, i.e. 320x240*/
     #define LCDINT_TYPES_DEFINED
@@ -66,8 +68,12 @@
     #define CONFIG_AVR_SPI_AVAILABLE
     /** The macro is defined when UART module is available */
     #define CONFIG_AVR_UART_AVAILABLE
+    /** The macro is defined when USART module can be used in master SPI mode */
+    #define CONFIG_USART_SPI_AVAILABLE
     /** The macro is defined when VGA monitor control is available directly from controller */
     #define CONFIG_VGA_AVAILABLE
+    /** The macro is defined when periodic frame timer is available (TIMER1) */
+    #define CONFIG_PLATFORM_TIMER_AVAILABLE
 
 #else
     /** The macro is defined when software i2c implementation is available */
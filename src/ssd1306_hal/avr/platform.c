@@ -94,3 +94,62 @@ void pinMode(int pin, int mode)
 
 #endif
 
+/* Frame timer is shared by plain avr and Arduino AVR builds */
+#if defined(__AVR__) && defined(CONFIG_PLATFORM_TIMER_AVAILABLE) && \
+    defined(CONFIG_PLATFORM_TIMER_ENABLE)
+
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+static volatile uint8_t s_timerTick = 0;
+
+ISR(TIMER1_COMPA_vect)
+{
+    s_timerTick = 1;
+}
+
+void ssd1306_platform_timerStart(uint16_t periodMs)
+{
+    /* CTC mode, 1024 prescaler: period up to 4 seconds at 16MHz */
+    uint32_t ticks = ((uint32_t)(F_CPU / 1024) * periodMs) / 1000;
+    if (ticks > 0xFFFF) ticks = 0xFFFF;
+    if (!ticks) ticks = 1;
+    uint8_t sreg = SREG;
+    cli();
+    TCCR1A = 0;
+    TCCR1B = (1<<WGM12) | (1<<CS12) | (1<<CS10);
+    OCR1A = ticks - 1;
+    TCNT1 = 0;
+    TIMSK1 |= (1<<OCIE1A);
+    s_timerTick = 0;
+    SREG = sreg;
+}
+
+void ssd1306_platform_timerWait(void)
+{
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    for(;;)
+    {
+        cli();
+        if (s_timerTick)
+        {
+            s_timerTick = 0;
+            sei();
+            break;
+        }
+        sleep_enable();
+        /* sei() guarantees that sleep instruction is executed before pending interrupt */
+        sei();
+        sleep_cpu();
+        sleep_disable();
+    }
+}
+
+void ssd1306_platform_timerStop(void)
+{
+    TIMSK1 &= ~(1<<OCIE1A);
+    TCCR1B = 0;
+}
+
+#endif
+
@@ -53,6 +53,12 @@
 /** The macro is defined when STM32 i2c implementation is available */
 #define CONFIG_PLATFORM_I2C_AVAILABLE
 #define CONFIG_PLATFORM_SPI_AVAILABLE
+/** spi implementation sets D/C line from pre-transaction callback */
+#define CONFIG_PLATFORM_SPI_DC_AVAILABLE
+#define CONFIG_PLATFORM_PARALLEL_AVAILABLE
+#define CONFIG_PLATFORM_TIMER_AVAILABLE
+#define CONFIG_NET_MIRROR_AVAILABLE
+#define CONFIG_DEFERRED_INTF_AVAILABLE
 
 #ifdef __cplusplus
 extern "C" {
@@ -99,6 +105,11 @@ static inline uint8_t pgm_read_byte(const void *ptr)  // pgm_read_byte() - can b
     return *((const uint8_t *)ptr);
 }
 
+static inline void *memcpy_P(void *dest, const void *src, size_t n)  // memcpy_P() - can be skipped
+{
+    return memcpy(dest, src, n);
+}
+
 static inline uint16_t eeprom_read_word(const void *ptr)  // eeprom_read_word() - can be skipped
 {
     return 0;
@@ -70,32 +70,92 @@ void delay(uint32_t ms)     // delay()
 
 #include <stdio.h>
 #include "driver/i2c.h"
+#if defined(__has_include)
+#if __has_include("esp_idf_version.h")
+#include "esp_idf_version.h"
+#endif
+#endif
+
+#if defined(ESP_IDF_VERSION_VAL) && (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 4, 0))
+// Command links can be allocated in user memory
+#define ESP_I2C_STATIC_LINK
+#endif
+
+#ifndef CONFIG_PLATFORM_I2C_FREQ
+#define CONFIG_PLATFORM_I2C_FREQ  400000
+#endif
+
+// Max number of bytes, sent as single i2c transaction
+#define ESP_I2C_CHUNK_SIZE  256
 
 static uint8_t s_i2c_addr = 0x3C;
 static int8_t s_bus_id;
 
-static i2c_cmd_handle_t s_cmd_handle;
+// Bytes are gathered to static buffer, because command link keeps pointers to data
+// until the transaction is executed, and caller buffers may be temporary.
+static uint8_t s_i2c_buffer[ESP_I2C_CHUNK_SIZE];
+static uint16_t s_i2c_len = 0;
+// Control byte to restart transmission with and number of bytes, already passed
+// to the tracker, see ssd1306_i2cControlTrack()
+static uint8_t s_i2c_control = SSD1306_I2C_CONTROL_NEXT;
+static uint16_t s_i2c_tracked = 0;
+
+#ifdef ESP_I2C_STATIC_LINK
+// Link has always the same structure: start, address, data block and stop
+static uint8_t s_i2c_link[I2C_LINK_RECOMMENDED_SIZE(1)];
+#endif
+
+static void SSD1306_IRAM platform_i2c_flush(void)
+{
+#ifdef ESP_I2C_STATIC_LINK
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(s_i2c_link, sizeof(s_i2c_link));
+#else
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+#endif
+    s_i2c_control = ssd1306_i2cControlTrack(s_i2c_control, &s_i2c_buffer[s_i2c_tracked], s_i2c_len - s_i2c_tracked);
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, ( s_i2c_addr << 1 ) | I2C_MASTER_WRITE, 0x1);
+    i2c_master_write(cmd, s_i2c_buffer, s_i2c_len, 0x1);
+    i2c_master_stop(cmd);
+    /*esp_err_t ret =*/ i2c_master_cmd_begin(s_bus_id, cmd, 1000 / portTICK_PERIOD_MS);
+#ifdef ESP_I2C_STATIC_LINK
+    i2c_cmd_link_delete_static(cmd);
+#else
+    i2c_cmd_link_delete(cmd);
+#endif
+    // Restart transmission with control byte, active at the point, where data were cut
+    s_i2c_len = 0;
+    if (s_i2c_control != SSD1306_I2C_CONTROL_NEXT)
+    {
+        s_i2c_buffer[s_i2c_len++] = s_i2c_control;
+    }
+    s_i2c_tracked = s_i2c_len;
+}
 
 static void platform_i2c_start(void)
 {
-    // ... Open i2c channel for your device with specific s_i2c_addr
-    s_cmd_handle = i2c_cmd_link_create();
-    i2c_master_start(s_cmd_handle);
-    i2c_master_write_byte(s_cmd_handle, ( s_i2c_addr << 1 ) | I2C_MASTER_WRITE, 0x1);
+    s_i2c_len = 0;
+    s_i2c_tracked = 0;
+    s_i2c_control = SSD1306_I2C_CONTROL_NEXT;
 }
 
 static void platform_i2c_stop(void)
 {
-    // ... Complete i2c communication
-    i2c_master_stop(s_cmd_handle);
-    /*esp_err_t ret =*/ i2c_master_cmd_begin(s_bus_id, s_cmd_handle, 1000 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(s_cmd_handle);
+    // Control byte alone, left after restart, has no meaning
+    if (s_i2c_len > s_i2c_tracked)
+    {
+        platform_i2c_flush();
+    }
+    s_i2c_len = 0;
 }
 
-static void platform_i2c_send(uint8_t data)
+static void SSD1306_IRAM platform_i2c_send(uint8_t data)
 {
-    // ... Send byte to i2c communication channel
-    i2c_master_write_byte(s_cmd_handle, data, 0x1);
+    s_i2c_buffer[s_i2c_len++] = data;
+    if (s_i2c_len == ESP_I2C_CHUNK_SIZE)
+    {
+        platform_i2c_flush();
+    }
 }
 
 static void platform_i2c_close(void)
@@ -104,15 +164,24 @@ static void platform_i2c_close(void)
     i2c_driver_delete(s_bus_id);
 }
 
-static void platform_i2c_send_buffer(const uint8_t *data, uint16_t len)
+static void SSD1306_IRAM platform_i2c_send_buffer(const uint8_t *data, uint16_t len)
 {
-    // ... Send len bytes to i2c communication channel here
-    while (len--)
+    while (len)
     {
-        platform_i2c_send(*data);
-        data++;
+        uint16_t size = ESP_I2C_CHUNK_SIZE - s_i2c_len;
+        if (size > len)
+        {
+            size = len;
+        }
+        memcpy(&s_i2c_buffer[s_i2c_len], data, size);
+        s_i2c_len += size;
+        data += size;
+        len -= size;
+        if (s_i2c_len == ESP_I2C_CHUNK_SIZE)
+        {
+            platform_i2c_flush();
+        }
     }
-//    i2c_master_write(cmd, data_wr, size, ACK_CHECK_EN);
 }
 
 void ssd1306_platform_i2cInit(int8_t busId, uint8_t addr, ssd1306_platform_i2cConfig_t * cfg)
@@ -133,7 +202,7 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t addr, ssd1306_platform_i2cCo
     conf.sda_pullup_en = GPIO_PULLUP_ENABLE;
     conf.scl_io_num = cfg->scl >= 0 ? cfg->scl : 22;
     conf.scl_pullup_en = GPIO_PULLUP_ENABLE;
-    conf.master.clk_speed = 400000; //I2C_EXAMPLE_MASTER_FREQ_HZ;
+    conf.master.clk_speed = CONFIG_PLATFORM_I2C_FREQ;
     i2c_param_config(s_bus_id, &conf);
     i2c_driver_install(s_bus_id, conf.mode, 0, 0, 0);
 //                       I2C_EXAMPLE_MASTER_RX_BUF_DISABLE,
@@ -147,6 +216,8 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t addr, ssd1306_platform_i2cCo
 
 #include "intf/spi/ssd1306_spi.h"
 #include "driver/spi_master.h"
+#include "esp_heap_caps.h"
+#include "esp_attr.h"
 
 // Store spi handle globally for all spi callbacks
 static spi_device_handle_t s_spi;
@@ -156,6 +227,85 @@ static int8_t s_spi_bus_id;
 // spi frequency s_ssd1306_spi_clock. Register device, only when frequency is known.
 static uint8_t s_first_spi_session = 0;
 
+// Max number of transactions, which can be queued to spi driver
+#define ESP_SPI_QUEUE_SIZE     7
+// Size of DMA-capable chunk, used to gather bytes before sending them to spi driver
+#define ESP_SPI_CHUNK_SIZE     4096
+
+// Transactions, queued to spi driver, are completed in FIFO order,
+// so the descriptors are reused in the ring manner.
+static spi_transaction_t s_spi_trans[ESP_SPI_QUEUE_SIZE];
+static uint8_t s_spi_trans_next = 0;
+static uint32_t s_spi_trans_queued = 0;
+static uint32_t s_spi_trans_completed = 0;
+
+// Two DMA-capable chunks: one is filled by the library, while another one is being sent
+static uint8_t *s_spi_chunk[2] = { NULL, NULL };
+static uint32_t s_spi_chunk_trans[2] = { 0, 0 };
+static uint8_t s_spi_chunk_id = 0;
+static uint16_t s_spi_chunk_len = 0;
+
+// D/C value of gathered bytes. Each transaction carries D/C value in user field,
+// and the pin is set by pre-transaction callback, so command and data transactions
+// are queued back-to-back without waiting for the queue to drain.
+static uint8_t s_spi_dc = 0;
+static uint8_t s_spi_active = 0;
+
+static void IRAM_ATTR platform_spi_pre_transfer(spi_transaction_t *t)
+{
+    gpio_set_level(s_ssd1306_dc, (int)(intptr_t)t->user);
+}
+
+static void platform_spi_wait_one(void)
+{
+    spi_transaction_t *t;
+    spi_device_get_trans_result(s_spi, &t, portMAX_DELAY);
+    s_spi_trans_completed++;
+}
+
+static void SSD1306_IRAM platform_spi_queue(const uint8_t *data, uint16_t len)
+{
+    if (s_spi_trans_queued - s_spi_trans_completed == ESP_SPI_QUEUE_SIZE)
+    {
+        // the oldest descriptor becomes free
+        platform_spi_wait_one();
+    }
+    spi_transaction_t *t = &s_spi_trans[s_spi_trans_next];
+    memset(t, 0, sizeof(spi_transaction_t));
+    t->length=8*len;          // 8 bits
+    t->tx_buffer=data;
+    t->user=(void *)(intptr_t)s_spi_dc;
+    spi_device_queue_trans(s_spi, t, portMAX_DELAY);
+    s_spi_trans_next = (s_spi_trans_next + 1) % ESP_SPI_QUEUE_SIZE;
+    s_spi_trans_queued++;
+}
+
+static void SSD1306_IRAM platform_spi_flush_chunk(void)
+{
+    if (!s_spi_chunk_len)
+    {
+        return;
+    }
+    platform_spi_queue(s_spi_chunk[s_spi_chunk_id], s_spi_chunk_len);
+    s_spi_chunk_trans[s_spi_chunk_id] = s_spi_trans_queued;
+    s_spi_chunk_id ^= 1;
+    s_spi_chunk_len = 0;
+    // wait until DMA completes sending of previous content of the next chunk
+    while ((int32_t)(s_spi_chunk_trans[s_spi_chunk_id] - s_spi_trans_completed) > 0)
+    {
+        platform_spi_wait_one();
+    }
+}
+
+static void platform_spi_wait(void)
+{
+    platform_spi_flush_chunk();
+    while (s_spi_trans_queued != s_spi_trans_completed)
+    {
+        platform_spi_wait_one();
+    }
+}
+
 static void platform_spi_start(void)
 {
     // ... Open spi channel for your device with specific s_ssd1306_cs, s_ssd1306_dc
@@ -166,7 +316,8 @@ static void platform_spi_start(void)
             .clock_speed_hz = s_ssd1306_spi_clock,
             .mode=0,
             .spics_io_num=s_ssd1306_cs,
-            .queue_size=7,       // max 7 transactions at a time
+            .queue_size=ESP_SPI_QUEUE_SIZE,
+            .pre_cb=s_spi_active ? platform_spi_pre_transfer : NULL,
         };
         spi_bus_add_device(s_spi_bus_id ? VSPI_HOST : HSPI_HOST, &devcfg, &s_spi);
         s_first_spi_session = 0;
@@ -176,19 +327,21 @@ static void platform_spi_start(void)
 static void platform_spi_stop(void)
 {
     // ... Complete spi communication
-    // no complete actions required for this implementation
+    // Gathered bytes are passed to spi driver, buffers are synchronized
+    // via platform_spi_wait(). DC line is set by the driver for each transaction
+    platform_spi_flush_chunk();
 }
 
-static void platform_spi_send(uint8_t data)
+static void SSD1306_IRAM platform_spi_send(uint8_t data)
 {
     // ... Send byte to spi communication channel
     // We do not care here about DC line state, because
-    // ssd1306 library already set DC pin via ssd1306_spiDataMode() before call to send().
-    spi_transaction_t t;
-    memset(&t, 0, sizeof(t));
-    t.length = 8;          // 8 bits
-    t.tx_buffer=&data;
-    spi_device_transmit(s_spi, &t);  // Transmit!
+    // ssd1306 library already selected DC value via ssd1306_spiDataMode() before call to send().
+    s_spi_chunk[s_spi_chunk_id][s_spi_chunk_len++] = data;
+    if (s_spi_chunk_len == ESP_SPI_CHUNK_SIZE)
+    {
+        platform_spi_flush_chunk();
+    }
 }
 
 static void platform_spi_close(void)
@@ -196,27 +349,63 @@ static void platform_spi_close(void)
     // ... free all spi resources here
     if (!s_first_spi_session)
     {
+        platform_spi_wait();
         spi_bus_remove_device( s_spi );
     }
     spi_bus_free( s_spi_bus_id ? VSPI_HOST : HSPI_HOST );
+    heap_caps_free( s_spi_chunk[0] );
+    heap_caps_free( s_spi_chunk[1] );
+    s_spi_chunk[0] = s_spi_chunk[1] = NULL;
+    s_spi_active = 0;
 }
 
-static void platform_spi_send_buffer(const uint8_t *data, uint16_t len)
+static void SSD1306_IRAM platform_spi_send_buffer_async(const uint8_t *data, uint16_t len)
+{
+    // ... Queue len bytes to spi communication channel here
+    platform_spi_flush_chunk();
+    while (len)
+    {
+        size_t sz = len > ESP_SPI_CHUNK_SIZE ? ESP_SPI_CHUNK_SIZE: len;
+        platform_spi_queue(data, sz);
+        data+=sz;
+        len-=sz;
+    }
+}
+
+static void SSD1306_IRAM platform_spi_send_buffer(const uint8_t *data, uint16_t len)
 {
     // ... Send len bytes to spi communication channel here
     while (len)
     {
-        size_t sz = len > 32 ? 32: len;
-        spi_transaction_t t;
-        memset(&t, 0, sizeof(t));
-        t.length=8*sz;          // 8 bits
-        t.tx_buffer=data;
-        spi_device_transmit(s_spi, &t);
+        size_t sz = ESP_SPI_CHUNK_SIZE - s_spi_chunk_len;
+        if (sz > len) sz = len;
+        memcpy(&s_spi_chunk[s_spi_chunk_id][s_spi_chunk_len], data, sz);
+        s_spi_chunk_len += sz;
+        if (s_spi_chunk_len == ESP_SPI_CHUNK_SIZE)
+        {
+            platform_spi_flush_chunk();
+        }
         data+=sz;
         len-=sz;
     }
 }
 
+uint8_t SSD1306_IRAM ssd1306_platform_spiDataMode(uint8_t mode)
+{
+    if (!s_spi_active)
+    {
+        return 0;
+    }
+    mode = mode ? 1 : 0;
+    if (mode != s_spi_dc)
+    {
+        // Gathered bytes are queued with previous D/C value
+        platform_spi_flush_chunk();
+        s_spi_dc = mode;
+    }
+    return 1;
+}
+
 void ssd1306_platform_spiInit(int8_t busId,
                               int8_t cesPin,
                               int8_t dcPin)
@@ -236,12 +425,28 @@ void ssd1306_platform_spiInit(int8_t busId,
     if (cesPin >=0) pinMode(cesPin, OUTPUT);
     if (dcPin >= 0) pinMode(dcPin, OUTPUT);
 
+    if (!s_spi_chunk[0])
+    {
+        s_spi_chunk[0] = heap_caps_malloc(ESP_SPI_CHUNK_SIZE, MALLOC_CAP_DMA);
+        s_spi_chunk[1] = heap_caps_malloc(ESP_SPI_CHUNK_SIZE, MALLOC_CAP_DMA);
+    }
+    s_spi_chunk_len = 0;
+    s_spi_dc = 0;
+#ifdef CONFIG_SPI_3WIRE_ENABLE
+    // D/C bit is sent with each byte, if there is no D/C pin
+    s_spi_active = dcPin >= 0;
+#else
+    s_spi_active = 1;
+#endif
+
     ssd1306_intf.spi = 1;
     ssd1306_intf.start = &platform_spi_start;
     ssd1306_intf.stop  = &platform_spi_stop;
     ssd1306_intf.send  = &platform_spi_send;
     ssd1306_intf.close = &platform_spi_close;
     ssd1306_intf.send_buffer = &platform_spi_send_buffer;
+    ssd1306_intf.send_buffer_async = &platform_spi_send_buffer_async;
+    ssd1306_intf.wait = &platform_spi_wait;
 
     // init your interface here
     spi_bus_config_t buscfg=
@@ -251,11 +456,313 @@ void ssd1306_platform_spiInit(int8_t busId,
         .sclk_io_num= s_spi_bus_id ? 18 : 14,
         .quadwp_io_num=-1,
         .quadhd_io_num=-1,
-        .max_transfer_sz=32
+        .max_transfer_sz=ESP_SPI_CHUNK_SIZE
     };
-    spi_bus_initialize(s_spi_bus_id ? VSPI_HOST : HSPI_HOST, &buscfg, 0); // 0 -no dma
+    spi_bus_initialize(s_spi_bus_id ? VSPI_HOST : HSPI_HOST, &buscfg, 1); // 1 - dma channel
     s_first_spi_session = 1;
 }
 #endif
 
+////////////////////////////////////////////////////////////////////////////////////////
+// !!! PLATFORM PARALLEL IMPLEMENTATION OPTIONAL !!!
+#if defined(CONFIG_PLATFORM_PARALLEL_AVAILABLE) && defined(CONFIG_PLATFORM_PARALLEL_ENABLE)
+
+#include "intf/spi/ssd1306_spi.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_heap_caps.h"
+#include "esp_idf_version.h"
+
+// esp_lcd i80 bus runs I2S0 peripheral of ESP32 in LCD mode with DMA.
+// D/C and WR lines are driven by the peripheral.
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
+#error "ssd1306 library: parallel interface requires ESP-IDF 5.0 or later"
+#endif
+
+#define ESP_PARALLEL_QUEUE_SIZE   7
+#define ESP_PARALLEL_CHUNK_SIZE   4096
+#define ESP_PARALLEL_DEFAULT_CLOCK 10000000
+
+static esp_lcd_i80_bus_handle_t s_parallel_bus = NULL;
+static esp_lcd_panel_io_handle_t s_parallel_io = NULL;
+static uint8_t s_parallel_width = 8;
+static uint8_t s_parallel_data = 0;
+/* Set when pixel data follow Memory Write command */
+static uint8_t s_parallel_ram = 0;
+
+static uint32_t s_parallel_queued = 0;
+static volatile uint32_t s_parallel_completed = 0;
+
+// Two DMA-capable chunks: one is filled by the library, while another one is being sent
+static uint8_t *s_parallel_chunk[2] = { NULL, NULL };
+static uint32_t s_parallel_chunk_trans[2] = { 0, 0 };
+static uint8_t s_parallel_chunk_id = 0;
+static uint16_t s_parallel_chunk_len = 0;
+
+static bool platform_parallel_done(esp_lcd_panel_io_handle_t io,
+                                   esp_lcd_panel_io_event_data_t *edata, void *ctx)
+{
+    s_parallel_completed++;
+    return false;
+}
+
+static void platform_parallel_wait_for(uint32_t trans)
+{
+    while ((int32_t)(trans - s_parallel_completed) > 0)
+    {
+        taskYIELD();
+    }
+}
+
+static void SSD1306_IRAM platform_parallel_queue(const uint8_t *data, uint16_t len)
+{
+    if (s_parallel_data && (s_parallel_width == 8 || s_parallel_ram))
+    {
+        // pixel data are sent via DMA, 16-bit words are swapped by the peripheral
+        esp_lcd_panel_io_tx_color(s_parallel_io, -1, data, len);
+        s_parallel_queued++;
+        return;
+    }
+    // Commands and their parameters are short, they are sent in polling mode
+    // after all queued DMA transfers are complete.
+    for (uint16_t i = 0; i < len; i++)
+    {
+        if (s_parallel_data)
+        {
+            uint16_t param = data[i];
+            esp_lcd_panel_io_tx_param(s_parallel_io, -1, &param, sizeof(param));
+        }
+        else
+        {
+            esp_lcd_panel_io_tx_param(s_parallel_io, data[i], NULL, 0);
+            s_parallel_ram = (data[i] == 0x2C) || (data[i] == 0x3C);
+        }
+    }
+}
+
+static void SSD1306_IRAM platform_parallel_flush_chunk(void)
+{
+    if (!s_parallel_chunk_len)
+    {
+        return;
+    }
+    platform_parallel_queue(s_parallel_chunk[s_parallel_chunk_id], s_parallel_chunk_len);
+    s_parallel_chunk_trans[s_parallel_chunk_id] = s_parallel_queued;
+    s_parallel_chunk_id ^= 1;
+    s_parallel_chunk_len = 0;
+    // wait until DMA completes sending of previous content of the next chunk
+    platform_parallel_wait_for(s_parallel_chunk_trans[s_parallel_chunk_id]);
+}
+
+static void platform_parallel_wait(void)
+{
+    platform_parallel_flush_chunk();
+    platform_parallel_wait_for(s_parallel_queued);
+}
+
+static void platform_parallel_start(void)
+{
+}
+
+static void platform_parallel_stop(void)
+{
+    platform_parallel_flush_chunk();
+}
+
+static void SSD1306_IRAM platform_parallel_send(uint8_t data)
+{
+    if (!s_parallel_data && s_parallel_width == 8)
+    {
+        // 8-bit commands are sent in polling mode, keep the order with queued data
+        platform_parallel_flush_chunk();
+        platform_parallel_queue(&data, 1);
+        return;
+    }
+    s_parallel_chunk[s_parallel_chunk_id][s_parallel_chunk_len++] = data;
+    if (s_parallel_chunk_len == ESP_PARALLEL_CHUNK_SIZE)
+    {
+        platform_parallel_flush_chunk();
+    }
+}
+
+static void SSD1306_IRAM platform_parallel_send_buffer(const uint8_t *data, uint16_t len)
+{
+    while (len)
+    {
+        size_t sz = ESP_PARALLEL_CHUNK_SIZE - s_parallel_chunk_len;
+        if (sz > len) sz = len;
+        memcpy(&s_parallel_chunk[s_parallel_chunk_id][s_parallel_chunk_len], data, sz);
+        s_parallel_chunk_len += sz;
+        if (s_parallel_chunk_len == ESP_PARALLEL_CHUNK_SIZE)
+        {
+            platform_parallel_flush_chunk();
+        }
+        data+=sz;
+        len-=sz;
+    }
+}
+
+static void SSD1306_IRAM platform_parallel_send_buffer_async(const uint8_t *data, uint16_t len)
+{
+    platform_parallel_flush_chunk();
+    if (!s_parallel_data || (s_parallel_width == 16 && !s_parallel_ram))
+    {
+        platform_parallel_queue(data, len);
+        return;
+    }
+    while (len)
+    {
+        size_t sz = len > ESP_PARALLEL_CHUNK_SIZE ? ESP_PARALLEL_CHUNK_SIZE: len;
+        platform_parallel_queue(data, sz);
+        data+=sz;
+        len-=sz;
+    }
+}
+
+static void platform_parallel_close(void)
+{
+    platform_parallel_wait();
+    esp_lcd_panel_io_del(s_parallel_io);
+    esp_lcd_del_i80_bus(s_parallel_bus);
+    s_parallel_io = NULL;
+    s_parallel_bus = NULL;
+    heap_caps_free( s_parallel_chunk[0] );
+    heap_caps_free( s_parallel_chunk[1] );
+    s_parallel_chunk[0] = s_parallel_chunk[1] = NULL;
+}
+
+uint8_t ssd1306_platform_parallelDataMode(uint8_t mode)
+{
+    if (!s_parallel_io)
+    {
+        return 0;
+    }
+    // bytes, collected in previous mode, must be sent with previous D/C level
+    platform_parallel_flush_chunk();
+    s_parallel_data = mode ? 1 : 0;
+    return 1;
+}
+
+void ssd1306_platform_parallelInit(int8_t cesPin, int8_t dcPin,
+                                   const ssd1306_platform_parallelConfig_t *cfg)
+{
+    s_parallel_width = cfg->width == 16 ? 16 : 8;
+    esp_lcd_i80_bus_config_t buscfg =
+    {
+        .dc_gpio_num = dcPin,
+        .wr_gpio_num = cfg->wr,
+        .clk_src = LCD_CLK_SRC_DEFAULT,
+        .bus_width = s_parallel_width,
+        .max_transfer_bytes = ESP_PARALLEL_CHUNK_SIZE,
+    };
+    for (int i = 0; i < s_parallel_width; i++)
+    {
+        buscfg.data_gpio_nums[i] = cfg->data[i];
+    }
+    esp_lcd_new_i80_bus(&buscfg, &s_parallel_bus);
+
+    esp_lcd_panel_io_i80_config_t iocfg =
+    {
+        .cs_gpio_num = cesPin,
+        .pclk_hz = cfg->clock ? cfg->clock : ESP_PARALLEL_DEFAULT_CLOCK,
+        .trans_queue_depth = ESP_PARALLEL_QUEUE_SIZE,
+        .on_color_trans_done = &platform_parallel_done,
+        .lcd_cmd_bits = s_parallel_width,
+        .lcd_param_bits = s_parallel_width,
+        .dc_levels =
+        {
+            .dc_idle_level = 0,
+            .dc_cmd_level = 0,
+            .dc_dummy_level = 0,
+            .dc_data_level = 1,
+        },
+        .flags =
+        {
+            .swap_color_bytes = s_parallel_width == 16,
+        },
+    };
+    esp_lcd_new_panel_io_i80(s_parallel_bus, &iocfg, &s_parallel_io);
+
+    if (!s_parallel_chunk[0])
+    {
+        s_parallel_chunk[0] = heap_caps_malloc(ESP_PARALLEL_CHUNK_SIZE, MALLOC_CAP_DMA);
+        s_parallel_chunk[1] = heap_caps_malloc(ESP_PARALLEL_CHUNK_SIZE, MALLOC_CAP_DMA);
+    }
+    s_parallel_chunk_len = 0;
+    s_parallel_data = 0;
+    s_parallel_ram = 0;
+    s_ssd1306_cs = cesPin;
+    s_ssd1306_dc = dcPin;
+
+    ssd1306_intf.spi = 1;
+    ssd1306_intf.start = &platform_parallel_start;
+    ssd1306_intf.stop  = &platform_parallel_stop;
+    ssd1306_intf.send  = &platform_parallel_send;
+    ssd1306_intf.close = &platform_parallel_close;
+    ssd1306_intf.send_buffer = &platform_parallel_send_buffer;
+    ssd1306_intf.send_buffer_async = &platform_parallel_send_buffer_async;
+    ssd1306_intf.wait = &platform_parallel_wait;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                   ESP32 FRAME TIMER IMPLEMENTATION
+////////////////////////////////////////////////////////////////////////////////
+#if defined(CONFIG_PLATFORM_TIMER_AVAILABLE) && defined(CONFIG_PLATFORM_TIMER_ENABLE)
+
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+
+static esp_timer_handle_t s_frameTimer = NULL;
+static SemaphoreHandle_t s_frameSemaphore = NULL;
+
+static void frameTimerCallback(void *arg)
+{
+    /* esp_timer callbacks are called from esp_timer task, not from ISR */
+    xSemaphoreGive(s_frameSemaphore);
+}
+
+void ssd1306_platform_timerStart(uint16_t periodMs)
+{
+    if (!s_frameSemaphore)
+    {
+        s_frameSemaphore = xSemaphoreCreateBinary();
+    }
+    if (!s_frameTimer)
+    {
+        esp_timer_create_args_t args =
+        {
+            .callback = frameTimerCallback,
+            .arg = NULL,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "ssd1306_frame",
+        };
+        esp_timer_create(&args, &s_frameTimer);
+    }
+    else
+    {
+        esp_timer_stop(s_frameTimer);
+    }
+    esp_timer_start_periodic(s_frameTimer, (uint64_t)periodMs * 1000);
+}
+
+void ssd1306_platform_timerWait(void)
+{
+    if (s_frameSemaphore)
+    {
+        xSemaphoreTake(s_frameSemaphore, portMAX_DELAY);
+    }
+}
+
+void ssd1306_platform_timerStop(void)
+{
+    if (s_frameTimer)
+    {
+        esp_timer_stop(s_frameTimer);
+        esp_timer_delete(s_frameTimer);
+        s_frameTimer = NULL;
+    }
+}
+
+#endif
+
 #endif // SSD1306_ESP_PLATFORM
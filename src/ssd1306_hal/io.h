@@ -47,6 +47,8 @@
 #include "esp/io.h"
 #elif defined(STM32F1) || defined(STM32F2) || defined(STM32F4)
 #include "stm32/io.h"
+#elif (defined(PICO_ON_DEVICE) && PICO_ON_DEVICE) || defined(PICO_RP2040)
+#include "rp2040/io.h"
 #elif defined(__linux__)
 #include "linux/io.h"
 #elif defined(__MINGW32__)
@@ -56,6 +58,33 @@
 #include "template/io.h"
 #endif
 
+#if defined(CONFIG_ESP32_IRAM_ENABLE) && (defined(ESP32) || defined(SSD1306_ESP_PLATFORM))
+#include "esp_attr.h"
+/** Places hot function to ESP32 internal RAM, so it doesn't stall on flash cache misses */
+#define SSD1306_IRAM  IRAM_ATTR
+#else
+/** Places hot function to ESP32 internal RAM, if CONFIG_ESP32_IRAM_ENABLE is defined */
+#define SSD1306_IRAM
+#endif
+
+#if defined(CONFIG_ESP32_PSRAM_ENABLE) && (defined(ESP32) || defined(SSD1306_ESP_PLATFORM))
+#include "esp_heap_caps.h"
+#ifndef CONFIG_LARGE_RAM_AVAILABLE
+#define CONFIG_LARGE_RAM_AVAILABLE
+#endif
+/** The macro is defined when large buffers are allocated in slow external RAM */
+#define CONFIG_EXTERNAL_RAM_AVAILABLE
+/** Allocates large buffer (full-screen canvas) in ESP32 PSRAM */
+#define ssd1306_largeAlloc(size)  heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+/** Allocates buffer in internal RAM, accessible by DMA */
+#define ssd1306_fastAlloc(size)   heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA)
+#else
+/** Allocates large buffer (full-screen canvas), external RAM is used if enabled */
+#define ssd1306_largeAlloc(size)  malloc(size)
+/** Allocates buffer in fast internal RAM */
+#define ssd1306_fastAlloc(size)   malloc(size)
+#endif
+
 #ifndef LCDINT_TYPES_DEFINED
 /** Macro informs if lcdint_t type is defined */
 #define LCDINT_TYPES_DEFINED
@@ -77,6 +106,12 @@ extern "C" {
 typedef struct {
     int8_t sda;
     int8_t scl;
+    /**
+     * Max number of bytes in single i2c message. Has meaning for Linux-like
+     * platforms only. Pass 0 to use platform default value. Values less than 2
+     * are rounded up to 2.
+     */
+    uint16_t chunk;
 } ssd1306_platform_i2cConfig_t;
 
 /**
@@ -91,7 +126,8 @@ typedef struct {
  * @param addr i2c address of oled driver, connected to i2c bus. If you want to use default
  *        i2c display address, please, pass 0.
  * @param cfg Specify scl and sda for the platform. If you want to use default pin numbers,
- *        please pass -1 for both members.
+ *        please pass -1 for both members. chunk member defines max size of i2c message,
+ *        pass 0 to use default size.
  */
 void ssd1306_platform_i2cInit(int8_t busId, uint8_t addr, ssd1306_platform_i2cConfig_t * cfg);
 #endif
@@ -118,6 +154,87 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t addr, ssd1306_platform_i2cCo
 void ssd1306_platform_spiInit(int8_t busId, int8_t cesPin, int8_t dcPin);
 #endif
 
+// !!! PLATFORM PARALLEL IMPLEMENTATION OPTIONAL !!!
+#if defined(CONFIG_PLATFORM_PARALLEL_AVAILABLE) && defined(CONFIG_PLATFORM_PARALLEL_ENABLE)
+typedef struct {
+    /** Data bus width: 8 or 16 bits. Pass 0 to use 8-bit bus. */
+    uint8_t width;
+    /**
+     * Pixel clock in Hz. Pass 0 to use platform default value.
+     * Not used by memory-mapped implementations (FSMC timings are set by
+     * STM32CubeMX generated code).
+     */
+    uint32_t clock;
+    /** WR strobe pin. Not used by memory-mapped implementations. */
+    int8_t wr;
+    /** Data pins D0-D15. Not used by memory-mapped implementations. */
+    int8_t data[16];
+} ssd1306_platform_parallelConfig_t;
+
+/**
+ * @brief Initializes 8080 parallel interface for platform being used.
+ *
+ * Initializes 8080 parallel interface and attaches it to ssd1306_intf. The
+ * interface behaves like spi interface (ssd1306_intf.spi is set), so display
+ * init functions without interface suffix (like ili9341_240x320_init())
+ * can be called after this function. RD pin of the display must be tied high.
+ * For 16-bit bus, commands and parameters are sent on D0-D7, and pixel data,
+ * following Memory Write (0x2C) and Memory Write Continue (0x3C) commands,
+ * are packed to 16-bit words, high byte first.
+ *
+ * @param cesPin chip select pin. Pass -1 if chip select is controlled by hardware
+ *        (FSMC NE line) or tied low.
+ * @param dcPin data/command pin. Pass -1 if D/C is driven by address line (FSMC).
+ * @param cfg bus width and pins of the parallel bus.
+ */
+void ssd1306_platform_parallelInit(int8_t cesPin, int8_t dcPin,
+                                   const ssd1306_platform_parallelConfig_t *cfg);
+
+/**
+ * Switches parallel bus between command (0) and data (1) mode, if parallel
+ * interface is active. Called by ssd1306_spiDataMode().
+ * @return 1 if D/C is handled by parallel interface, 0 otherwise.
+ */
+uint8_t ssd1306_platform_parallelDataMode(uint8_t mode);
+#endif
+
+#if defined(CONFIG_PLATFORM_SPI_DC_AVAILABLE) && defined(CONFIG_PLATFORM_SPI_ENABLE)
+/**
+ * Switches spi bus between command (0) and data (1) mode, if platform spi
+ * interface drives D/C line itself (RP2040 PIO program, ESP32 pre-transaction
+ * callback). D/C value is queued along with the bytes, so ssd1306_spiDataMode()
+ * doesn't wait for the bus.
+ * @return 1 if D/C is handled by platform spi interface, 0 otherwise.
+ */
+uint8_t ssd1306_platform_spiDataMode(uint8_t mode);
+#endif
+
+// !!! PLATFORM FRAME TIMER IMPLEMENTATION OPTIONAL !!!
+#if defined(CONFIG_PLATFORM_TIMER_AVAILABLE) && defined(CONFIG_PLATFORM_TIMER_ENABLE)
+/**
+ * @brief Starts periodic hardware timer.
+ *
+ * Starts periodic timer, used to schedule frames. If the timer is already
+ * started, its period is changed.
+ *
+ * @param periodMs timer period in milliseconds
+ */
+void ssd1306_platform_timerStart(uint16_t periodMs);
+
+/**
+ * @brief Waits for next timer period.
+ *
+ * Puts cpu (or calling task) to sleep until next timer period starts. If
+ * the period has already elapsed since last call, returns immediately.
+ */
+void ssd1306_platform_timerWait(void);
+
+/**
+ * @brief Stops periodic timer.
+ */
+void ssd1306_platform_timerStop(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -42,6 +42,17 @@
 
 #else                       // LINUX includes
 
+/** The macro is defined when periodic frame timer is available */
+#define CONFIG_PLATFORM_TIMER_AVAILABLE
+/** The macro is defined when display content can be mirrored over udp sockets */
+#define CONFIG_NET_MIRROR_AVAILABLE
+/** The macro is defined when platform has enough RAM for full-screen buffers */
+#define CONFIG_LARGE_RAM_AVAILABLE
+/** The macro is defined when C++11 threads can be used */
+#define CONFIG_PLATFORM_THREADS_AVAILABLE
+/** The macro is defined when display transfers can be moved to separate bus thread */
+#define CONFIG_DEFERRED_INTF_AVAILABLE
+
 #include <stdio.h>
 #include <stdint.h>
 #include <unistd.h>
@@ -72,7 +83,12 @@ static inline uint32_t micros(void) { return 0; };
 static inline void pinMode(int pin, int mode) {};
 
 #else                         // ============== LINUX
+#if defined(SDL_EMULATION)
+/* Emulator shows pending changes before sleeping and stops at SDL_EXIT_AFTER_DELAYS checkpoint */
+static inline void delay(unsigned long ms) { sdl_core_delay(ms);  };
+#else
 static inline void delay(unsigned long ms) { usleep(ms*1000);  };
+#endif
 static inline void delayMicroseconds(unsigned long us) { usleep(us); };
 static inline uint32_t millis(void)
 {
@@ -114,6 +130,7 @@ void digitalWrite(int pin, int level);
 static inline void randomSeed(int seed) { };
 static inline void attachInterrupt(int pin, void (*interrupt)(void), int level) { };
 static inline uint8_t pgm_read_byte(const void *ptr) { return *((const uint8_t *)ptr); };
+static inline void *memcpy_P(void *dest, const void *src, size_t n) { return memcpy(dest, src, n); };
 static inline uint16_t eeprom_read_word(const void *ptr) { return 0; };
 static inline void eeprom_write_word(const void *ptr, uint16_t val) { };
 
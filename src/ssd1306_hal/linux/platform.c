@@ -41,7 +41,13 @@
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <linux/i2c-dev.h>
+#include <linux/i2c.h>
 #include <linux/spi/spidev.h>
+#if defined(CONFIG_LINUX_RPI_GPIO_ENABLE)
+#include <sys/mman.h>
+#elif defined(CONFIG_LINUX_GPIOCHIP_ENABLE)
+#include <linux/gpio.h>
+#endif
 
 #if defined(CONFIG_PLATFORM_SPI_AVAILABLE) && defined(CONFIG_PLATFORM_SPI_ENABLE) \
     && !defined(SDL_EMULATION)
@@ -64,6 +70,28 @@
 static void platform_spi_send_cache();
 #endif
 
+/* Value files are opened once and kept open, so each access is single system call. *
+ * The array keeps file descriptor plus one, 0 means that the file is not opened.    */
+static int s_value_fd[MAX_GPIO_COUNT] = {0};
+
+static int gpio_value_fd(int pin)
+{
+    if (!s_value_fd[pin])
+    {
+        char path[64];
+        int fd;
+
+        snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", pin);
+        fd = open(path, O_RDWR);
+        if (-1 == fd)
+        {
+            return -1;
+        }
+        s_value_fd[pin] = fd + 1;
+    }
+    return s_value_fd[pin] - 1;
+}
+
 int gpio_export(int pin)
 {
     char buffer[4];
@@ -104,6 +132,11 @@ int gpio_unexport(int pin)
     ssize_t bytes_written;
     int fd;
 
+    if (s_value_fd[pin])
+    {
+        close(s_value_fd[pin] - 1);
+        s_value_fd[pin] = 0;
+    }
     fd = open("/sys/class/gpio/unexport", O_WRONLY);
     if (-1 == fd)
     {
@@ -149,26 +182,22 @@ int gpio_direction(int pin, int dir)
 
 int gpio_read(int pin)
 {
-    char path[32];
-    char value_str[3];
-    int fd;
+    char value_str[3] = {0};
+    int fd = gpio_value_fd(pin);
 
-    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", pin);
-    fd = open(path, O_RDONLY);
     if (-1 == fd)
     {
         fprintf(stderr, "Failed to read gpio pin value!\n");
         return(-1);
     }
 
-    if (-1 == read(fd, value_str, 3))
+    /* sysfs attributes are read from the beginning each time */
+    if (-1 == pread(fd, value_str, 2, 0))
     {
         fprintf(stderr, "Failed to read gpio pin value!\n");
         return(-1);
     }
 
-    close(fd);
-
     return(atoi(value_str));
 }
 
@@ -176,11 +205,8 @@ int gpio_write(int pin, int value)
 {
     static const char s_values_str[] = "01";
 
-    char path[64];
-    int fd;
+    int fd = gpio_value_fd(pin);
 
-    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", pin);
-    fd = open(path, O_WRONLY);
     if (-1 == fd)
     {
         fprintf(stderr, "Failed to set gpio pin value[%d]: %s%s!\n",
@@ -188,14 +214,13 @@ int gpio_write(int pin, int value)
         return(-1);
     }
 
-    if (1 != write(fd, &s_values_str[LOW == value ? 0 : 1], 1))
+    if (1 != pwrite(fd, &s_values_str[LOW == value ? 0 : 1], 1, 0))
     {
         fprintf(stderr, "Failed to set gpio pin value[%d]: %s%s!\n",
                 pin, strerror (errno), getuid() == 0 ? "" : ", need to be root");
         return(-1);
     }
 
-    close(fd);
     return(0);
 }
 
@@ -203,12 +228,147 @@ int gpio_write(int pin, int value)
 
 static uint8_t s_exported_pin[MAX_GPIO_COUNT] = {0};
 static uint8_t s_pin_mode[MAX_GPIO_COUNT] = {0};
+/* Level of output pin plus one, 0 if unknown. The same level is not written twice */
+static uint8_t s_pin_level[MAX_GPIO_COUNT] = {0};
+
+#if defined(CONFIG_LINUX_RPI_GPIO_ENABLE)
+
+/* BCM2835-BCM2711 gpio registers in 32-bit words */
+#define RPI_GPFSEL0   0
+#define RPI_GPSET0    7
+#define RPI_GPCLR0    10
+#define RPI_BLOCK_SIZE 4096
+
+static volatile uint32_t *s_gpio_regs = NULL;
+
+static int platform_gpio_open(int pin)
+{
+    int fd;
+    void *regs;
+
+    if (s_gpio_regs)
+    {
+        return 0;
+    }
+    fd = open("/dev/gpiomem", O_RDWR | O_SYNC);
+    if (-1 == fd)
+    {
+        fprintf(stderr, "Failed to open /dev/gpiomem: %s!\n", strerror(errno));
+        return -1;
+    }
+    regs = mmap(NULL, RPI_BLOCK_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == regs)
+    {
+        fprintf(stderr, "Failed to map gpio registers: %s!\n", strerror(errno));
+        return -1;
+    }
+    s_gpio_regs = (volatile uint32_t *)regs;
+    return 0;
+}
+
+static int platform_gpio_direction(int pin, int dir)
+{
+    volatile uint32_t *reg = &s_gpio_regs[RPI_GPFSEL0 + pin / 10];
+    uint8_t shift = (pin % 10) * 3;
+    *reg = (*reg & ~(7 << shift)) | ((OUT == dir ? 1 : 0) << shift);
+    return 0;
+}
+
+static int platform_gpio_write(int pin, int value)
+{
+    s_gpio_regs[(LOW == value ? RPI_GPCLR0 : RPI_GPSET0) + (pin >> 5)] = 1u << (pin & 0x1F);
+    return 0;
+}
+
+#elif defined(CONFIG_LINUX_GPIOCHIP_ENABLE)
+
+#ifndef SSD1306_LINUX_GPIOCHIP
+/** Path to gpio character device, pin numbers are line offsets of this chip */
+#define SSD1306_LINUX_GPIOCHIP "/dev/gpiochip0"
+#endif
+
+static int s_chip_fd = -1;
+/* Line handle descriptors plus one, 0 if line is not requested */
+static int s_line_fd[MAX_GPIO_COUNT] = {0};
+
+static int platform_gpio_open(int pin)
+{
+    if (s_chip_fd < 0)
+    {
+        s_chip_fd = open(SSD1306_LINUX_GPIOCHIP, O_RDWR);
+        if (s_chip_fd < 0)
+        {
+            fprintf(stderr, "Failed to open %s: %s%s!\n", SSD1306_LINUX_GPIOCHIP,
+                    strerror (errno), getuid() == 0 ? "" : ", need to be root");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Line direction is fixed for the handle, so the line is requested again */
+static int platform_gpio_direction(int pin, int dir)
+{
+    struct gpiohandle_request req;
+
+    if (s_line_fd[pin])
+    {
+        close(s_line_fd[pin] - 1);
+        s_line_fd[pin] = 0;
+    }
+    memset(&req, 0, sizeof(req));
+    req.lineoffsets[0] = pin;
+    req.lines = 1;
+    req.flags = OUT == dir ? GPIOHANDLE_REQUEST_OUTPUT : GPIOHANDLE_REQUEST_INPUT;
+    strncpy(req.consumer_label, "ssd1306", sizeof(req.consumer_label) - 1);
+    if (ioctl(s_chip_fd, GPIO_GET_LINEHANDLE_IOCTL, &req) < 0)
+    {
+        fprintf(stderr, "Failed to request gpio line[%d]: %s!\n", pin, strerror(errno));
+        return -1;
+    }
+    s_line_fd[pin] = req.fd + 1;
+    return 0;
+}
+
+static int platform_gpio_write(int pin, int value)
+{
+    struct gpiohandle_data data;
+
+    memset(&data, 0, sizeof(data));
+    data.values[0] = LOW == value ? 0 : 1;
+    if (!s_line_fd[pin] || ioctl(s_line_fd[pin] - 1, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data) < 0)
+    {
+        fprintf(stderr, "Failed to set gpio line value[%d]: %s!\n", pin, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+#else
+
+static int platform_gpio_open(int pin)
+{
+    return gpio_export(pin);
+}
+
+static int platform_gpio_direction(int pin, int dir)
+{
+    return gpio_direction(pin, dir);
+}
+
+static int platform_gpio_write(int pin, int value)
+{
+    return gpio_write(pin, value);
+}
+
+#endif
 
 void pinMode(int pin, int mode)
 {
     if (!s_exported_pin[pin])
     {
-        if ( gpio_export(pin)<0 )
+        if ( platform_gpio_open(pin)<0 )
         {
             return;
         }
@@ -216,18 +376,24 @@ void pinMode(int pin, int mode)
     }
     if (mode == OUTPUT)
     {
-        gpio_direction(pin, OUT);
+        platform_gpio_direction(pin, OUT);
         s_pin_mode[pin] = 1;
     }
     if (mode == INPUT)
     {
-        gpio_direction(pin, IN);
+        platform_gpio_direction(pin, IN);
         s_pin_mode[pin] = 0;
     }
+    s_pin_level[pin] = 0;
 }
 
 void digitalWrite(int pin, int level)
 {
+    level = LOW == level ? LOW : HIGH;
+    if (s_pin_level[pin] == level + 1)
+    {
+        return;
+    }
 #ifdef LINUX_SPI_AVAILABLE
     if (s_ssd1306_dc == pin)
     {
@@ -237,7 +403,7 @@ void digitalWrite(int pin, int level)
 
     if (!s_exported_pin[pin])
     {
-        if ( gpio_export(pin)<0 )
+        if ( platform_gpio_open(pin)<0 )
         {
             return;
         }
@@ -247,7 +413,10 @@ void digitalWrite(int pin, int level)
     {
         pinMode(pin, OUTPUT);
     }
-    gpio_write( pin, level );
+    if ( platform_gpio_write( pin, level ) == 0 )
+    {
+        s_pin_level[pin] = level + 1;
+    }
 }
 
 #endif // SDL_EMULATION
@@ -262,21 +431,73 @@ void digitalWrite(int pin, int level)
 #if !defined(SDL_EMULATION)
 
 
+#define LINUX_I2C_DEFAULT_CHUNK   128
+/* Each chunk may start with repeated control byte, so at least one more byte is needed */
+#define LINUX_I2C_MIN_CHUNK       2
+
 static uint8_t s_sa = SSD1306_SA;
 static int     s_fd = -1;
-static uint8_t s_buffer[128];
-static uint8_t s_dataSize = 0;
+static uint8_t *s_buffer = NULL;
+static uint16_t s_chunk = 0;
+static uint16_t s_dataSize = 0;
+static uint8_t s_nostart = 0;
+/* Control byte to start the next chunk with, see ssd1306_i2cControlTrack() */
+static uint8_t s_control = SSD1306_I2C_CONTROL_NEXT;
+/* Number of bytes at the buffer start, already passed to the control byte tracker */
+static uint16_t s_tracked = 0;
+
+static void platform_i2c_write(struct i2c_msg *msgs, int count)
+{
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs = msgs;
+    data.nmsgs = count;
+    if (ioctl(s_fd, I2C_RDWR, &data) < 0)
+    {
+        fprintf(stderr, "Failed to write to the i2c bus: %s.\n", strerror(errno));
+    }
+}
+
+static void platform_i2c_fill_msg(struct i2c_msg *msg, uint8_t *buffer, uint16_t len, uint16_t flags)
+{
+    msg->addr = s_sa;
+    msg->flags = flags;
+    msg->len = len;
+    msg->buf = buffer;
+}
+
+/* Starts new chunk with control byte, matching the point, where the previous chunk was cut */
+static void platform_i2c_restart(void)
+{
+    s_dataSize = 0;
+    if (s_control != SSD1306_I2C_CONTROL_NEXT)
+    {
+        s_buffer[s_dataSize++] = s_control;
+    }
+    s_tracked = s_dataSize;
+}
+
+static void platform_i2c_flush(void)
+{
+    struct i2c_msg msg;
+    s_control = ssd1306_i2cControlTrack(s_control, &s_buffer[s_tracked], s_dataSize - s_tracked);
+    platform_i2c_fill_msg(&msg, s_buffer, s_dataSize, 0);
+    platform_i2c_write(&msg, 1);
+    platform_i2c_restart();
+}
 
 static void platform_i2c_start(void)
 {
     s_dataSize = 0;
+    s_tracked = 0;
+    s_control = SSD1306_I2C_CONTROL_NEXT;
 }
 
 static void platform_i2c_stop(void)
 {
-    if (write(s_fd, s_buffer, s_dataSize) != s_dataSize)
+    /* Control byte alone, left after restart, has no meaning */
+    if (s_dataSize > s_tracked)
     {
-        fprintf(stderr, "Failed to write to the i2c bus: %s.\n", strerror(errno));
+        platform_i2c_flush();
     }
     s_dataSize = 0;
 }
@@ -285,23 +506,63 @@ static void platform_i2c_send(uint8_t data)
 {
     s_buffer[s_dataSize] = data;
     s_dataSize++;
-    if (s_dataSize == sizeof(s_buffer))
+    if (s_dataSize == s_chunk)
     {
         /* Send function puts all data to internal buffer.  *
          * Restart transmission if internal buffer is full. */
-        ssd1306_intf.stop();
-        ssd1306_intf.start();
-        ssd1306_intf.send(0x40);
+        platform_i2c_flush();
     }
 }
 
 static void platform_i2c_send_buffer(const uint8_t *buffer, uint16_t size)
 {
-    while (size--)
+    if (!s_nostart || s_dataSize + size < s_chunk)
     {
-        platform_i2c_send(*buffer);
-        buffer++;
+        while (size)
+        {
+            uint16_t sz = s_chunk - s_dataSize;
+            if (sz > size) sz = size;
+            memcpy(&s_buffer[s_dataSize], buffer, sz);
+            s_dataSize += sz;
+            if (s_dataSize == s_chunk)
+            {
+                platform_i2c_flush();
+            }
+            buffer += sz;
+            size -= sz;
+        }
+        return;
+    }
+    /* Adapter supports I2C_M_NOSTART: buffered bytes and the caller buffer are sent *
+     * as single i2c transaction without copying data to internal buffer.           */
+    struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    int count = 0;
+    s_control = ssd1306_i2cControlTrack(s_control, &s_buffer[s_tracked], s_dataSize - s_tracked);
+    if (s_dataSize)
+    {
+        platform_i2c_fill_msg(&msgs[count++], s_buffer, s_dataSize, 0);
+    }
+    while (size)
+    {
+        uint16_t sz = size > s_chunk ? s_chunk : size;
+        platform_i2c_fill_msg(&msgs[count], (uint8_t *)buffer, sz, count ? I2C_M_NOSTART : 0);
+        count++;
+        s_control = ssd1306_i2cControlTrack(s_control, buffer, sz);
+        buffer += sz;
+        size -= sz;
+        if (size && count == I2C_RDWR_IOCTL_MAX_MSGS)
+        {
+            platform_i2c_write(msgs, count);
+            count = 0;
+            if (s_control != SSD1306_I2C_CONTROL_NEXT)
+            {
+                s_buffer[0] = s_control;
+                platform_i2c_fill_msg(&msgs[count++], s_buffer, 1, 0);
+            }
+        }
     }
+    platform_i2c_write(msgs, count);
+    platform_i2c_restart();
 }
 
 static void platform_i2c_close()
@@ -311,6 +572,8 @@ static void platform_i2c_close()
         close(s_fd);
         s_fd = -1;
     }
+    free(s_buffer);
+    s_buffer = NULL;
 }
 
 static void empty_function()
@@ -353,6 +616,22 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConf
         fprintf(stderr, "Failed to acquire bus access and/or talk to slave.\n");
         return;
     }
+    unsigned long funcs = 0;
+    if (ioctl(s_fd, I2C_FUNCS, &funcs) >= 0)
+    {
+        s_nostart = (funcs & I2C_FUNC_NOSTART) ? 1 : 0;
+    }
+    s_chunk = (cfg && cfg->chunk) ? cfg->chunk : LINUX_I2C_DEFAULT_CHUNK;
+    if (s_chunk < LINUX_I2C_MIN_CHUNK)
+    {
+        s_chunk = LINUX_I2C_MIN_CHUNK;
+    }
+    free(s_buffer);
+    if (!(s_buffer = malloc(s_chunk)))
+    {
+        fprintf(stderr, "Failed to allocate i2c buffer\n");
+        return;
+    }
     ssd1306_intf.start = platform_i2c_start;
     ssd1306_intf.stop = platform_i2c_stop;
     ssd1306_intf.send = platform_i2c_send;
@@ -364,15 +643,6 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConf
 
 #include "sdl_core.h"
 
-static void platform_i2c_send_buffer(const uint8_t *buffer, uint16_t size)
-{
-    while (size--)
-    {
-        sdl_send_byte(*buffer);
-        buffer++;
-    };
-}
-
 void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConfig_t * cfg)
 {
     sdl_core_init();
@@ -380,7 +650,7 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConf
     ssd1306_intf.start = sdl_send_init;
     ssd1306_intf.stop = sdl_send_stop;
     ssd1306_intf.send = sdl_send_byte;
-    ssd1306_intf.send_buffer = platform_i2c_send_buffer;
+    ssd1306_intf.send_buffer = sdl_send_bytes;
     ssd1306_intf.close = sdl_core_close;
 }
 
@@ -401,6 +671,28 @@ extern uint32_t s_ssd1306_spi_clock;
 static uint8_t s_spi_cache[1024];
 static int s_spi_cached_count = 0;
 
+/* spidev rejects SPI_IOC_MESSAGE(n) calls, which have more than bufsiz bytes in *
+ * all segments together. bufsiz is module parameter, 4096 bytes by default.      */
+#define LINUX_SPI_DEFAULT_BUFSIZ   4096
+#define LINUX_SPI_BUFSIZ_PATH      "/sys/module/spidev/parameters/bufsiz"
+
+static uint32_t s_spi_bufsiz = LINUX_SPI_DEFAULT_BUFSIZ;
+
+static uint32_t platform_spi_read_bufsiz(void)
+{
+    unsigned int bufsiz = 0;
+    FILE *f = fopen(LINUX_SPI_BUFSIZ_PATH, "r");
+    if (f)
+    {
+        if (fscanf(f, "%u", &bufsiz) != 1)
+        {
+            bufsiz = 0;
+        }
+        fclose(f);
+    }
+    return bufsiz ? bufsiz : LINUX_SPI_DEFAULT_BUFSIZ;
+}
+
 static void platform_spi_start(void)
 {
     s_spi_cached_count = 0;
@@ -411,28 +703,49 @@ static void platform_spi_stop(void)
     platform_spi_send_cache();
 }
 
-static void platform_spi_send_cache()
+static void platform_spi_fill_segment(struct spi_ioc_transfer *mesg, const uint8_t *data, uint32_t len)
+{
+    memset(mesg, 0, sizeof(struct spi_ioc_transfer));
+    mesg->tx_buf = (unsigned long)data;
+    mesg->rx_buf = 0;
+    mesg->len = len;
+    mesg->delay_usecs = 0;
+    mesg->speed_hz = 0;
+    mesg->bits_per_word = 8;
+    mesg->cs_change = 0;
+}
+
+static void platform_spi_transfer(struct spi_ioc_transfer *mesg, int count)
 {
-    /* TODO: Yeah, sending single bytes is too slow, but *
-     * need to figure out how to detect data/command bytes *
-     * to send bytes as one block */
-    if ( s_spi_cached_count == 0 )
+    if ( count == 0 )
     {
         return;
     }
-    struct spi_ioc_transfer mesg;
-    memset(&mesg, 0, sizeof mesg);
-    mesg.tx_buf = (unsigned long)&s_spi_cache[0];
-    mesg.rx_buf = 0;
-    mesg.len = s_spi_cached_count;
-    mesg.delay_usecs = 0;
-    mesg.speed_hz = 0;
-    mesg.bits_per_word = 8;
-    mesg.cs_change = 0;
-    if (ioctl(s_spi_fd, SPI_IOC_MESSAGE(1), &mesg) < 1)
+    if (ioctl(s_spi_fd, SPI_IOC_MESSAGE(count), mesg) < 1)
     {
         fprintf(stderr, "SPI failed to send SPI message: %s\n", strerror (errno)) ;
     }
+}
+
+/* Sends bytes of the same D/C state, single SPI_IOC_MESSAGE per bufsiz bytes */
+static void platform_spi_write(const uint8_t *data, uint32_t len)
+{
+    while (len)
+    {
+        struct spi_ioc_transfer mesg;
+        uint32_t sz = len > s_spi_bufsiz ? s_spi_bufsiz : len;
+        platform_spi_fill_segment(&mesg, data, sz);
+        platform_spi_transfer(&mesg, 1);
+        data += sz;
+        len -= sz;
+    }
+}
+
+static void platform_spi_send_cache()
+{
+    /* Cache always contains bytes of the same type (data or command): digitalWrite() *
+     * flushes the cache before D/C pin changes its state.                           */
+    platform_spi_write(&s_spi_cache[0], s_spi_cached_count);
     s_spi_cached_count = 0;
 }
 
@@ -457,11 +770,30 @@ static void platform_spi_close(void)
 
 static void platform_spi_send_buffer(const uint8_t *data, uint16_t len)
 {
-    while (len--)
+    /* Small blocks are merged with other bytes of the same D/C state */
+    if ( s_spi_cached_count + len <= sizeof( s_spi_cache ) )
     {
-        platform_spi_send(*data);
-        data++;
+        memcpy(&s_spi_cache[s_spi_cached_count], data, len);
+        s_spi_cached_count += len;
+        return;
+    }
+    /* Large blocks are passed to spidev directly from the caller buffer. All bytes  *
+     * here have the same D/C state, so cached bytes go in the same message with the *
+     * head of the block, as long as the message fits spidev bufsiz.                 */
+    if ( s_spi_cached_count && s_spi_cached_count < s_spi_bufsiz )
+    {
+        struct spi_ioc_transfer mesg[2];
+        uint32_t sz = s_spi_bufsiz - s_spi_cached_count;
+        if ( sz > len ) sz = len;
+        platform_spi_fill_segment(&mesg[0], &s_spi_cache[0], s_spi_cached_count);
+        platform_spi_fill_segment(&mesg[1], data, sz);
+        platform_spi_transfer(mesg, 2);
+        s_spi_cached_count = 0;
+        data += sz;
+        len -= sz;
     }
+    platform_spi_send_cache();
+    platform_spi_write(data, len);
 }
 
 static void empty_function_spi(void)
@@ -499,6 +831,7 @@ void ssd1306_platform_spiInit(int8_t busId,
     ssd1306_intf.close = empty_function;
 
     snprintf(filename, 19, "/dev/spidev%d.%d", busId, ces);
+    s_spi_bufsiz = platform_spi_read_bufsiz();
     if ((s_spi_fd = open(filename, O_RDWR)) < 0)
     {
         printf("Failed to initialize SPI: %s%s!\n",
@@ -533,15 +866,6 @@ void ssd1306_platform_spiInit(int8_t busId,
 
 #include "sdl_core.h"
 
-static void sdl_send_bytes(const uint8_t *buffer, uint16_t size)
-{
-    while (size--)
-    {
-        sdl_send_byte(*buffer);
-        buffer++;
-    };
-}
-
 void ssd1306_platform_spiInit(int8_t busId, int8_t ces, int8_t dcPin)
 {
     sdl_core_init();
@@ -566,6 +890,55 @@ void ssd1306_platform_spiInit(int8_t busId, int8_t ces, int8_t dcPin)
 
 #endif // CONFIG_PLATFORM_SPI_AVAILABLE
 
+#if defined(CONFIG_PLATFORM_TIMER_AVAILABLE) && defined(CONFIG_PLATFORM_TIMER_ENABLE)
+
+#include <sys/timerfd.h>
+
+static int s_timerFd = -1;
+
+void ssd1306_platform_timerStart(uint16_t periodMs)
+{
+    struct itimerspec spec;
+    if (s_timerFd < 0)
+    {
+        s_timerFd = timerfd_create(CLOCK_MONOTONIC, 0);
+        if (s_timerFd < 0)
+        {
+            fprintf(stderr, "Failed to create frame timer: %i\n", errno);
+            return;
+        }
+    }
+    spec.it_interval.tv_sec = periodMs / 1000;
+    spec.it_interval.tv_nsec = (long)(periodMs % 1000) * 1000000;
+    spec.it_value = spec.it_interval;
+    timerfd_settime(s_timerFd, 0, &spec, NULL);
+}
+
+void ssd1306_platform_timerWait(void)
+{
+    uint64_t expirations;
+    if (s_timerFd < 0)
+    {
+        return;
+    }
+    /* read() blocks until timer expires, and returns immediately if it has already expired */
+    if (read(s_timerFd, &expirations, sizeof(expirations)) < 0)
+    {
+        fprintf(stderr, "Failed to wait for frame timer: %i\n", errno);
+    }
+}
+
+void ssd1306_platform_timerStop(void)
+{
+    if (s_timerFd >= 0)
+    {
+        close(s_timerFd);
+        s_timerFd = -1;
+    }
+}
+
+#endif // CONFIG_PLATFORM_TIMER_AVAILABLE
+
 #else  // end of !KERNEL, KERNEL is below
 
 void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConfig_t * cfg)
@@ -32,6 +32,8 @@
 // Use the same library interface as for Linux
 #define CONFIG_PLATFORM_I2C_AVAILABLE
 #define CONFIG_PLATFORM_SPI_AVAILABLE
+/** The macro is defined when platform has enough RAM for full-screen buffers */
+#define CONFIG_LARGE_RAM_AVAILABLE
 
 #if defined(SDL_EMULATION)  // SDL Emulation mode includes
 #include "sdl_core.h"
@@ -57,7 +59,12 @@ extern "C" {
 #endif
 
 static inline int  digitalRead(int pin) { return sdl_read_digital(pin); };
+#if defined(SDL_EMULATION)
+/* Emulator shows pending changes before sleeping and stops at SDL_EXIT_AFTER_DELAYS checkpoint */
+static inline void delay(unsigned long ms) { sdl_core_delay(ms);  };
+#else
 static inline void delay(unsigned long ms) { Sleep(ms);  };
+#endif
 static inline void delayMicroseconds(unsigned long us) { Sleep((us+500)/1000); };
 static inline uint32_t millis(void)
 {
@@ -78,6 +85,7 @@ static inline void pinMode(int pin, int mode) { };
 static inline void randomSeed(int seed) { };
 static inline void attachInterrupt(int pin, void (*interrupt)(void), int level) { };
 static inline uint8_t pgm_read_byte(const void *ptr) { return *((const uint8_t *)ptr); };
+static inline void *memcpy_P(void *dest, const void *src, size_t n) { return memcpy(dest, src, n); };
 static inline uint16_t eeprom_read_word(const void *ptr) { return 0; };
 static inline void eeprom_write_word(const void *ptr, uint16_t val) { };
 
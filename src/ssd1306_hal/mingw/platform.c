@@ -57,10 +57,13 @@ static uint8_t s_sa = SSD1306_SA;
 static int     s_fd = -1;
 static uint8_t s_buffer[128];
 static uint8_t s_dataSize = 0;
+/* Control byte to restart transmission with, see ssd1306_i2cControlTrack() */
+static uint8_t s_control = SSD1306_I2C_CONTROL_NEXT;
 
 static void platform_i2c_start(void)
 {
     s_dataSize = 0;
+    s_control = SSD1306_I2C_CONTROL_NEXT;
 }
 
 static void platform_i2c_stop(void)
@@ -76,13 +79,18 @@ static void platform_i2c_send(uint8_t data)
 {
     s_buffer[s_dataSize] = data;
     s_dataSize++;
+    s_control = ssd1306_i2cControlTrack(s_control, &data, 1);
     if (s_dataSize == sizeof(s_buffer))
     {
         /* Send function puts all data to internal buffer.  *
          * Restart transmission if internal buffer is full. */
+        uint8_t control = s_control;
         ssd1306_intf.stop();
         ssd1306_intf.start();
-        ssd1306_intf.send(0x40);
+        if (control != SSD1306_I2C_CONTROL_NEXT)
+        {
+            ssd1306_intf.send(control);
+        }
     }
 }
 
@@ -154,15 +162,6 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConf
 
 #include "sdl_core.h"
 
-static void platform_i2c_send_buffer(const uint8_t *buffer, uint16_t size)
-{
-    while (size--)
-    {
-        sdl_send_byte(*buffer);
-        buffer++;
-    };
-}
-
 void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConfig_t * cfg)
 {
     sdl_core_init();
@@ -170,7 +169,7 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t sa, ssd1306_platform_i2cConf
     ssd1306_intf.start = sdl_send_init;
     ssd1306_intf.stop = sdl_send_stop;
     ssd1306_intf.send = sdl_send_byte;
-    ssd1306_intf.send_buffer = platform_i2c_send_buffer;
+    ssd1306_intf.send_buffer = sdl_send_bytes;
     ssd1306_intf.close = sdl_core_close;
 }
 
@@ -305,15 +304,6 @@ void ssd1306_platform_spiInit(int8_t busId,
 
 #include "sdl_core.h"
 
-static void sdl_send_bytes(const uint8_t *buffer, uint16_t size)
-{
-    while (size--)
-    {
-        sdl_send_byte(*buffer);
-        buffer++;
-    };
-}
-
 void ssd1306_platform_spiInit(int8_t busId, int8_t ces, int8_t dcPin)
 {
     sdl_core_init();
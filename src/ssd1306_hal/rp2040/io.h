@@ -0,0 +1,157 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * @file ssd1306_hal/rp2040/io.h This is RP2040 (Raspberry Pi Pico SDK) platform file
+ */
+
+#ifndef _SSD1306_RP2040_IO_H_
+#define _SSD1306_RP2040_IO_H_
+
+#define SSD1306_RP2040_PLATFORM
+//========================== I. Include libraries =========================
+/* 1. Include all required headers, specific for your platform here */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOW  0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+/* Progmem attribute for data, located in Flash */
+#define PROGMEM
+
+//========================== II. Define options ===========================
+/* 2. Uncomment all options, you have support for on your platform   *
+ *    Remember that you will need to implement low level intf/i2c or *
+ *    intf/spi layers for your platform                              */
+
+/** The macro is defined when RP2040 i2c implementation is available */
+#define CONFIG_PLATFORM_I2C_AVAILABLE
+#define CONFIG_PLATFORM_SPI_AVAILABLE
+/** spi implementation drives D/C line itself (from PIO program) */
+#define CONFIG_PLATFORM_SPI_DC_AVAILABLE
+/** Deferred interface runs bus loop on core 1 */
+#define CONFIG_DEFERRED_INTF_AVAILABLE
+
+/**
+ * Size of staging buffers, used by RP2040 i2c and spi implementations. Single bytes
+ * are collected to the buffer and sent via DMA, while the next buffer is filled.
+ */
+#ifndef RP2040_STAGING_BUFFER_SIZE
+#define RP2040_STAGING_BUFFER_SIZE  129
+#endif
+
+/** Default SCK and MOSI pins of PIO spi implementation */
+#ifndef RP2040_SPI_SCK_PIN
+#define RP2040_SPI_SCK_PIN   18
+#endif
+#ifndef RP2040_SPI_MOSI_PIN
+#define RP2040_SPI_MOSI_PIN  19
+#endif
+
+/** Default SDA and SCL pins of i2c implementation */
+#ifndef RP2040_I2C_SDA_PIN
+#define RP2040_I2C_SDA_PIN  4
+#endif
+#ifndef RP2040_I2C_SCL_PIN
+#define RP2040_I2C_SCL_PIN  5
+#endif
+
+/** SCL frequency of i2c implementation in Hz */
+#ifndef RP2040_I2C_FREQUENCY
+#define RP2040_I2C_FREQUENCY  400000
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//========================== III. Implement functions =====================
+/* Implement functions below the way you like. You can make them non-static */
+// !!!  MANDATORY !!!
+int  digitalRead(int pin);
+
+void digitalWrite(int pin, int level);
+
+void pinMode(int pin, int mode);
+
+/** Reads ADC input for GPIO26-GPIO29, returns 0 for other pins */
+int  analogRead(int pin);
+
+uint32_t millis(void);
+
+uint32_t micros(void);
+
+void delay(uint32_t ms);
+
+void delayMicroseconds(uint32_t us);
+
+// !!!  OPTIONAL !!!
+static inline void randomSeed(int seed)   // randomSeed() -  can be skipped
+{
+    srand(seed);
+}
+
+static inline void attachInterrupt(int pin, void (*interrupt)(), int level)  // attachInterrupt() - can be skipped
+{
+}
+
+static inline uint8_t pgm_read_byte(const void *ptr)  // pgm_read_byte() - can be skipped
+{
+    return *((const uint8_t *)ptr);
+}
+
+static inline void *memcpy_P(void *dest, const void *src, size_t n)  // memcpy_P() - can be skipped
+{
+    return memcpy(dest, src, n);
+}
+
+static inline uint16_t eeprom_read_word(const void *ptr)  // eeprom_read_word() - can be skipped
+{
+    return 0;
+}
+
+static inline void eeprom_write_word(const void *ptr, uint16_t val) // eeprom_write_word() - can be skipped
+{
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+static inline int random(int max)   // random(n) - can be skipped if you don't use it
+{
+    return max > 0 ? rand() % max : 0;
+}
+
+static inline int random(int min, int max)  // random(a,b) - can be skipped if you don't use it
+{
+    return max > min ? min + rand() % (max - min) : min;
+}
+#endif
+
+#endif
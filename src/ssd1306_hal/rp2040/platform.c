@@ -0,0 +1,488 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306_hal/io.h"
+
+#if defined(SSD1306_RP2040_PLATFORM)
+
+#include "intf/ssd1306_interface.h"
+
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+
+int  digitalRead(int pin)
+{
+    return gpio_get(pin) ? HIGH : LOW;
+}
+
+void digitalWrite(int pin, int level)
+{
+    gpio_put(pin, level ? 1 : 0);
+}
+
+void pinMode(int pin, int mode)
+{
+    gpio_init(pin);
+    gpio_set_dir(pin, mode == OUTPUT ? GPIO_OUT : GPIO_IN);
+}
+
+int  analogRead(int pin)
+{
+    static uint8_t s_adc_ready = 0;
+    if ( pin < 26 || pin > 29 )
+    {
+        return 0;
+    }
+    if (!s_adc_ready)
+    {
+        adc_init();
+        s_adc_ready = 1;
+    }
+    adc_gpio_init(pin);
+    adc_select_input(pin - 26);
+    return adc_read();
+}
+
+uint32_t millis(void)
+{
+    return to_ms_since_boot(get_absolute_time());
+}
+
+uint32_t micros(void)
+{
+    return time_us_32();
+}
+
+void delay(uint32_t ms)
+{
+    sleep_ms(ms);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    busy_wait_us_32(us);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// !!! PLATFORM I2C IMPLEMENTATION OPTIONAL !!!
+#if defined(CONFIG_PLATFORM_I2C_AVAILABLE) && defined(CONFIG_PLATFORM_I2C_ENABLE)
+
+#include "hardware/i2c.h"
+
+/*
+ * Bytes are staged as IC_DATA_CMD register values and written to the register via DMA.
+ * The controller holds SCL low while TX FIFO is empty, so single i2c transaction can
+ * span several DMA transfers. The last staged byte is always kept back until stop(),
+ * since STOP bit must be set on it.
+ */
+static i2c_inst_t *s_i2c = NULL;
+static int s_i2c_dma = -1;
+static uint16_t s_i2c_buffer[2][RP2040_STAGING_BUFFER_SIZE];
+static uint8_t s_i2c_active = 0;
+static uint16_t s_i2c_size = 0;
+/* Set on NACK: the rest of transaction is dropped */
+static uint8_t s_i2c_abort = 0;
+
+static uint8_t platform_i2c_check_abort(void)
+{
+    i2c_hw_t *hw = i2c_get_hw(s_i2c);
+    if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+    {
+        dma_channel_abort(s_i2c_dma);
+        (void)hw->clr_tx_abrt;
+        s_i2c_abort = 1;
+    }
+    return s_i2c_abort;
+}
+
+static void platform_i2c_wait(void)
+{
+    while (dma_channel_is_busy(s_i2c_dma))
+    {
+        if (platform_i2c_check_abort())
+        {
+            break;
+        }
+    }
+}
+
+static void platform_i2c_flush(uint8_t last)
+{
+    uint16_t *buffer = s_i2c_buffer[s_i2c_active];
+    uint16_t size = last ? s_i2c_size : s_i2c_size - 1;
+    platform_i2c_wait();
+    if (s_i2c_abort)
+    {
+        s_i2c_size = 0;
+        return;
+    }
+    if (last)
+    {
+        buffer[size - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    }
+    dma_channel_transfer_from_buffer_now(s_i2c_dma, buffer, size);
+    s_i2c_active ^= 1;
+    s_i2c_size = 0;
+    if (!last)
+    {
+        s_i2c_buffer[s_i2c_active][s_i2c_size++] = buffer[size];
+    }
+}
+
+static void platform_i2c_start(void)
+{
+    platform_i2c_wait();
+    (void)i2c_get_hw(s_i2c)->clr_stop_det;
+    s_i2c_abort = 0;
+    s_i2c_size = 0;
+}
+
+static void platform_i2c_stop(void)
+{
+    i2c_hw_t *hw = i2c_get_hw(s_i2c);
+    /* Nothing is sent since start(), or transaction is aborted */
+    if (!s_i2c_size)
+    {
+        platform_i2c_wait();
+        return;
+    }
+    platform_i2c_flush(1);
+    platform_i2c_wait();
+    if (s_i2c_abort)
+    {
+        return;
+    }
+    while (!(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS))
+    {
+        if (platform_i2c_check_abort())
+        {
+            return;
+        }
+    }
+    (void)hw->clr_stop_det;
+}
+
+static void platform_i2c_send(uint8_t data)
+{
+    s_i2c_buffer[s_i2c_active][s_i2c_size++] = data;
+    if (s_i2c_size == RP2040_STAGING_BUFFER_SIZE)
+    {
+        platform_i2c_flush(0);
+    }
+}
+
+static void platform_i2c_close(void)
+{
+    platform_i2c_wait();
+}
+
+static void platform_i2c_send_buffer(const uint8_t *data, uint16_t len)
+{
+    while (len--)
+    {
+        platform_i2c_send(*data++);
+    }
+}
+
+void ssd1306_platform_i2cInit(int8_t busId, uint8_t addr, ssd1306_platform_i2cConfig_t * cfg)
+{
+    int8_t sda = (cfg && cfg->sda >= 0) ? cfg->sda : RP2040_I2C_SDA_PIN;
+    int8_t scl = (cfg && cfg->scl >= 0) ? cfg->scl : RP2040_I2C_SCL_PIN;
+    dma_channel_config config;
+    s_i2c = busId == 1 ? i2c1 : i2c0;
+    i2c_init(s_i2c, RP2040_I2C_FREQUENCY);
+    gpio_set_function(sda, GPIO_FUNC_I2C);
+    gpio_set_function(scl, GPIO_FUNC_I2C);
+    gpio_pull_up(sda);
+    gpio_pull_up(scl);
+    /* Target address can be changed only while the controller is disabled */
+    i2c_get_hw(s_i2c)->enable = 0;
+    i2c_get_hw(s_i2c)->tar = addr ? addr : 0x3C;
+    i2c_get_hw(s_i2c)->enable = 1;
+    if (s_i2c_dma < 0)
+    {
+        s_i2c_dma = dma_claim_unused_channel(true);
+    }
+    config = dma_channel_get_default_config(s_i2c_dma);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, i2c_get_dreq(s_i2c, true));
+    dma_channel_configure(s_i2c_dma, &config, &i2c_get_hw(s_i2c)->data_cmd, NULL, 0, false);
+    s_i2c_active = 0;
+    s_i2c_size = 0;
+    ssd1306_intf.spi = 0;
+    ssd1306_intf.start = &platform_i2c_start;
+    ssd1306_intf.stop  = &platform_i2c_stop;
+    ssd1306_intf.send  = &platform_i2c_send;
+    ssd1306_intf.close = &platform_i2c_close;
+    ssd1306_intf.send_buffer = &platform_i2c_send_buffer;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+// !!! PLATFORM SPI IMPLEMENTATION OPTIONAL !!!
+#if defined(CONFIG_PLATFORM_SPI_AVAILABLE) && defined(CONFIG_PLATFORM_SPI_ENABLE)
+
+#include "intf/spi/ssd1306_spi.h"
+#include "hardware/pio.h"
+
+extern uint32_t s_ssd1306_spi_clock;
+
+/*
+ * PIO program, sending blocks of bytes with D/C line set by the state machine:
+ *
+ *  .side_set 1             ; SCK
+ *  .wrap_target
+ *      pull block          ; header: bit 31 - D/C, bits 30..0 - number of bytes - 1
+ *      out y, 1
+ *      jmp !y cmd
+ *      set pins, 1         ; D/C
+ *      jmp hdr
+ *  cmd:
+ *      set pins, 0
+ *  hdr:
+ *      out x, 31
+ *  byte:
+ *      pull block          ; data byte in bits 31..24
+ *      set y, 7
+ *  bit:
+ *      out pins, 1   side 0 [1]   ; MOSI
+ *      jmp y-- bit   side 1 [1]
+ *      jmp x-- byte
+ *  .wrap
+ *
+ * D/C changes only between blocks, after the last bit of previous block is shifted
+ * out, so CPU never waits for the bus to switch between commands and data.
+ */
+static const uint16_t s_spi_program_instructions[] =
+{
+    0x80a0, //  0: pull   block           side 0
+    0x6041, //  1: out    y, 1            side 0
+    0x0065, //  2: jmp    !y, 5           side 0
+    0xe001, //  3: set    pins, 1         side 0
+    0x0006, //  4: jmp    6               side 0
+    0xe000, //  5: set    pins, 0         side 0
+    0x603f, //  6: out    x, 31           side 0
+    0x80a0, //  7: pull   block           side 0
+    0xe047, //  8: set    y, 7            side 0
+    0x6101, //  9: out    pins, 1         side 0 [1]
+    0x1189, // 10: jmp    y--, 9          side 1 [1]
+    0x0047, // 11: jmp    x--, 7          side 0
+};
+
+static const struct pio_program s_spi_program =
+{
+    .instructions = s_spi_program_instructions,
+    .length = sizeof(s_spi_program_instructions) / sizeof(s_spi_program_instructions[0]),
+    .origin = -1,
+};
+
+static PIO s_spi_pio = NULL;
+static uint s_spi_sm = 0;
+static int s_spi_offset = -1;
+static int s_spi_dma = -1;
+/* Two staging buffers: one is sent via DMA while the other one is being filled */
+static uint8_t s_spi_buffer[2][RP2040_STAGING_BUFFER_SIZE];
+static uint8_t s_spi_index = 0;
+static uint16_t s_spi_size = 0;
+static uint8_t s_spi_data = 0;
+static uint8_t s_spi_active = 0;
+
+/*
+ * Pushes block header to state machine and starts DMA for block bytes. Header
+ * must follow all bytes of previous block, so previous DMA is waited for.
+ */
+static void platform_spi_transmit(const uint8_t *data, uint16_t len)
+{
+    dma_channel_wait_for_finish_blocking(s_spi_dma);
+    pio_sm_put_blocking(s_spi_pio, s_spi_sm, ((uint32_t)s_spi_data << 31) | (uint32_t)(len - 1));
+    dma_channel_transfer_from_buffer_now(s_spi_dma, data, len);
+}
+
+static void platform_spi_flush(void)
+{
+    if (s_spi_size)
+    {
+        platform_spi_transmit(s_spi_buffer[s_spi_index], s_spi_size);
+        s_spi_index ^= 1;
+        s_spi_size = 0;
+    }
+}
+
+static void platform_spi_wait(void)
+{
+    platform_spi_flush();
+    dma_channel_wait_for_finish_blocking(s_spi_dma);
+}
+
+static void platform_spi_start(void)
+{
+    if (s_ssd1306_cs >= 0)
+    {
+        digitalWrite(s_ssd1306_cs, LOW);
+    }
+}
+
+static void platform_spi_stop(void)
+{
+    uint32_t stall = 1u << (PIO_FDEBUG_TXSTALL_LSB + s_spi_sm);
+    platform_spi_wait();
+    /* Wait until state machine shifts out the last bit and stalls on empty FIFO */
+    s_spi_pio->fdebug = stall;
+    while (!(s_spi_pio->fdebug & stall))
+    {
+    }
+    if (s_ssd1306_cs >= 0)
+    {
+        digitalWrite(s_ssd1306_cs, HIGH);
+    }
+}
+
+static void platform_spi_send(uint8_t data)
+{
+    s_spi_buffer[s_spi_index][s_spi_size++] = data;
+    if (s_spi_size == RP2040_STAGING_BUFFER_SIZE)
+    {
+        platform_spi_flush();
+    }
+}
+
+static void platform_spi_close(void)
+{
+    platform_spi_wait();
+    s_spi_active = 0;
+}
+
+static void platform_spi_send_buffer(const uint8_t *data, uint16_t len)
+{
+    if (!len)
+    {
+        return;
+    }
+    if (s_spi_size + len <= RP2040_STAGING_BUFFER_SIZE)
+    {
+        memcpy(&s_spi_buffer[s_spi_index][s_spi_size], data, len);
+        s_spi_size += len;
+        return;
+    }
+    /* Large blocks are sent directly from caller buffer, which is valid until return */
+    platform_spi_flush();
+    platform_spi_transmit(data, len);
+    dma_channel_wait_for_finish_blocking(s_spi_dma);
+}
+
+static void platform_spi_send_buffer_async(const uint8_t *data, uint16_t len)
+{
+    if (len)
+    {
+        platform_spi_flush();
+        platform_spi_transmit(data, len);
+    }
+}
+
+uint8_t ssd1306_platform_spiDataMode(uint8_t mode)
+{
+    if (!s_spi_active)
+    {
+        return 0;
+    }
+    mode = mode ? 1 : 0;
+    if (mode != s_spi_data)
+    {
+        /* Staged bytes are sent with previous D/C value, no need to wait for DMA */
+        platform_spi_flush();
+        s_spi_data = mode;
+    }
+    return 1;
+}
+
+void ssd1306_platform_spiInit(int8_t busId,
+                              int8_t cesPin,
+                              int8_t dcPin)
+{
+    pio_sm_config config;
+    dma_channel_config dma_config;
+    if (cesPin>=0) s_ssd1306_cs = cesPin;
+    if (dcPin>=0) s_ssd1306_dc = dcPin;
+    if (cesPin >=0)
+    {
+        pinMode(cesPin, OUTPUT);
+        digitalWrite(cesPin, HIGH);
+    }
+    if (s_spi_offset < 0)
+    {
+        s_spi_pio = busId == 1 ? pio1 : pio0;
+        s_spi_offset = pio_add_program(s_spi_pio, &s_spi_program);
+        s_spi_sm = pio_claim_unused_sm(s_spi_pio, true);
+        s_spi_dma = dma_claim_unused_channel(true);
+    }
+    pio_sm_set_enabled(s_spi_pio, s_spi_sm, false);
+    pio_gpio_init(s_spi_pio, RP2040_SPI_SCK_PIN);
+    pio_gpio_init(s_spi_pio, RP2040_SPI_MOSI_PIN);
+    pio_gpio_init(s_spi_pio, s_ssd1306_dc);
+    pio_sm_set_consecutive_pindirs(s_spi_pio, s_spi_sm, RP2040_SPI_SCK_PIN, 1, true);
+    pio_sm_set_consecutive_pindirs(s_spi_pio, s_spi_sm, RP2040_SPI_MOSI_PIN, 1, true);
+    pio_sm_set_consecutive_pindirs(s_spi_pio, s_spi_sm, s_ssd1306_dc, 1, true);
+
+    config = pio_get_default_sm_config();
+    sm_config_set_wrap(&config, s_spi_offset, s_spi_offset + s_spi_program.length - 1);
+    sm_config_set_sideset(&config, 1, false, false);
+    sm_config_set_sideset_pins(&config, RP2040_SPI_SCK_PIN);
+    sm_config_set_out_pins(&config, RP2040_SPI_MOSI_PIN, 1);
+    sm_config_set_set_pins(&config, s_ssd1306_dc, 1);
+    /* MSB first: 8-bit writes to TX FIFO put the byte to bits 31..24 */
+    sm_config_set_out_shift(&config, false, false, 32);
+    sm_config_set_fifo_join(&config, PIO_FIFO_JOIN_TX);
+    /* Each bit takes 4 state machine cycles. Display init functions set s_ssd1306_spi_clock */
+    sm_config_set_clkdiv(&config, (float)clock_get_hz(clk_sys) / (4.0f * s_ssd1306_spi_clock));
+    pio_sm_init(s_spi_pio, s_spi_sm, s_spi_offset, &config);
+    pio_sm_set_enabled(s_spi_pio, s_spi_sm, true);
+
+    dma_config = dma_channel_get_default_config(s_spi_dma);
+    channel_config_set_transfer_data_size(&dma_config, DMA_SIZE_8);
+    channel_config_set_read_increment(&dma_config, true);
+    channel_config_set_write_increment(&dma_config, false);
+    channel_config_set_dreq(&dma_config, pio_get_dreq(s_spi_pio, s_spi_sm, true));
+    dma_channel_configure(s_spi_dma, &dma_config, &s_spi_pio->txf[s_spi_sm], NULL, 0, false);
+
+    s_spi_index = 0;
+    s_spi_size = 0;
+    s_spi_data = 0;
+    s_spi_active = 1;
+    ssd1306_intf.spi = 1;
+    ssd1306_intf.start = &platform_spi_start;
+    ssd1306_intf.stop  = &platform_spi_stop;
+    ssd1306_intf.send  = &platform_spi_send;
+    ssd1306_intf.close = &platform_spi_close;
+    ssd1306_intf.send_buffer = &platform_spi_send_buffer;
+    ssd1306_intf.send_buffer_async = &platform_spi_send_buffer_async;
+    ssd1306_intf.wait = &platform_spi_wait;
+}
+#endif
+
+#endif // SSD1306_RP2040_PLATFORM
@@ -29,8 +29,6 @@
 #ifndef _SSD1306_STM32_IO_H_
 #define _SSD1306_STM32_IO_H_
 
-// TODO: To add support. Any help is welcome
-
 #define SSD1306_STM32_PLATFORM
 //========================== I. Include libraries =========================
 /* 1. Include all required headers, specific for your platform here */
@@ -53,6 +51,39 @@
 /** The macro is defined when STM32 i2c implementation is available */
 #define CONFIG_PLATFORM_I2C_AVAILABLE
 #define CONFIG_PLATFORM_SPI_AVAILABLE
+#define CONFIG_PLATFORM_PARALLEL_AVAILABLE
+
+/**
+ * Size of staging buffers, used by STM32 i2c and spi implementations. Single bytes
+ * are collected to the buffer and sent via DMA, while the next buffer is filled.
+ * For i2c one byte of the buffer is occupied by control byte.
+ */
+#ifndef STM32_STAGING_BUFFER_SIZE
+#define STM32_STAGING_BUFFER_SIZE  129
+#endif
+
+/**
+ * FSMC bank address, used by 8080 parallel implementation. Display CS should be
+ * connected to NE line of the bank (NE1 by default).
+ */
+#ifndef STM32_FSMC_BANK_ADDR
+#define STM32_FSMC_BANK_ADDR  0x60000000
+#endif
+
+/**
+ * FSMC address line, connected to D/C pin of the display (A16 by default).
+ * Commands are written to the bank address, data - to the address with this line set.
+ */
+#ifndef STM32_FSMC_DC_LINE
+#define STM32_FSMC_DC_LINE  16
+#endif
+
+/**
+ * Converts STM32 port letter and pin number to pin index, accepted by pinMode(),
+ * digitalWrite() and digitalRead(), and ssd1306 interface init functions.
+ * For example, STM32_PIN('B', 1) is PB1.
+ */
+#define STM32_PIN(port, num)  ((((port) - 'A') << 4) | (num))
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,41 +92,24 @@ extern "C" {
 //========================== III. Implement functions =====================
 /* Implement functions below the way you like. You can make them non-static */
 // !!!  MANDATORY !!!
-static inline int  digitalRead(int pin)   // digitalRead()
-{
-    return LOW;
-}
+int  digitalRead(int pin);
 
-static inline void digitalWrite(int pin, int level)  // digitalWrite()
-{
-}
+void digitalWrite(int pin, int level);
 
-static inline void pinMode(int pin, int mode) // pinMode()
-{
-}
+void pinMode(int pin, int mode);
 
 static inline int  analogRead(int pin)    // analogRead()
 {
     return 0;
 }
 
-static inline uint32_t millis(void)       // millis()
-{
-    return 0;
-}
+uint32_t millis(void);
 
-static inline uint32_t micros(void)       // micros()
-{
-    return 0;
-};
+uint32_t micros(void);
 
-static inline void delay(uint32_t ms)     // delay()
-{
-}
+void delay(uint32_t ms);
 
-static inline void delayMicroseconds(uint32_t us)  // delayMicroseconds()
-{
-}
+void delayMicroseconds(uint32_t us);
 
 // !!!  OPTIONAL !!!
 static inline void randomSeed(int seed)   // randomSeed() -  can be skipped
@@ -111,6 +125,11 @@ static inline uint8_t pgm_read_byte(const void *ptr)  // pgm_read_byte() - can b
     return *((const uint8_t *)ptr);
 }
 
+static inline void *memcpy_P(void *dest, const void *src, size_t n)  // memcpy_P() - can be skipped
+{
+    return memcpy(dest, src, n);
+}
+
 static inline uint16_t eeprom_read_word(const void *ptr)  // eeprom_read_word() - can be skipped
 {
     return 0;
@@ -27,55 +27,213 @@
 #if defined(SSD1306_STM32_PLATFORM)
 
 #include "intf/ssd1306_interface.h"
+
+#if defined(STM32F4)
+#include "stm32f4xx_hal.h"
+#elif defined(STM32F2)
+#include "stm32f2xx_hal.h"
+#else
 #include "stm32f1xx_hal.h"
+#endif
+
+static GPIO_TypeDef * const s_ports[] =
+{
+    GPIOA,
+    GPIOB,
+    GPIOC,
+#ifdef GPIOD
+    GPIOD,
+#endif
+#ifdef GPIOE
+    GPIOE,
+#endif
+};
+
+static GPIO_TypeDef *platform_pin_port(int pin)
+{
+    if ( pin < 0 || (pin >> 4) >= (int)(sizeof(s_ports) / sizeof(s_ports[0])) )
+    {
+        return NULL;
+    }
+    return s_ports[pin >> 4];
+}
+
+int  digitalRead(int pin)
+{
+    GPIO_TypeDef *port = platform_pin_port(pin);
+    if (!port)
+    {
+        return LOW;
+    }
+    return HAL_GPIO_ReadPin(port, 1 << (pin & 0x0F)) == GPIO_PIN_SET ? HIGH : LOW;
+}
+
+void digitalWrite(int pin, int level)
+{
+    GPIO_TypeDef *port = platform_pin_port(pin);
+    if (port)
+    {
+        HAL_GPIO_WritePin(port, 1 << (pin & 0x0F), level ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    }
+}
+
+void pinMode(int pin, int mode)
+{
+    GPIO_TypeDef *port = platform_pin_port(pin);
+    GPIO_InitTypeDef init = {0};
+    if (!port)
+    {
+        return;
+    }
+    // Port clock is enabled by STM32CubeMX generated MX_GPIO_Init()
+    init.Pin = 1 << (pin & 0x0F);
+    init.Mode = mode == OUTPUT ? GPIO_MODE_OUTPUT_PP : GPIO_MODE_INPUT;
+    init.Pull = GPIO_NOPULL;
+    init.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(port, &init);
+}
+
+uint32_t millis(void)
+{
+    return HAL_GetTick();
+}
 
-// TODO: To add support. Any help is welcome
+uint32_t micros(void)
+{
+    uint32_t ms, ticks;
+    do
+    {
+        ms = HAL_GetTick();
+        ticks = SysTick->LOAD - SysTick->VAL;
+    } while (ms != HAL_GetTick());
+    return ms * 1000 + ticks * 1000 / (SysTick->LOAD + 1);
+}
+
+void delay(uint32_t ms)
+{
+    HAL_Delay(ms);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    uint32_t start = micros();
+    while ((uint32_t)(micros() - start) < us)
+    {
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////
 // !!! PLATFORM I2C IMPLEMENTATION OPTIONAL !!!
 #if defined(CONFIG_PLATFORM_I2C_AVAILABLE) && defined(CONFIG_PLATFORM_I2C_ENABLE)
+
+// I2C handle is defined by STM32CubeMX generated code. DMA TX channel should be
+// linked to the handle, otherwise blocking transfers are used.
+extern I2C_HandleTypeDef hi2c1;
+
 static uint8_t s_i2c_addr = 0x3C;
+/* Two staging buffers: one is sent via DMA while the other one is being filled */
+static uint8_t s_i2c_buffer[2][STM32_STAGING_BUFFER_SIZE];
+static uint8_t s_i2c_active = 0;
+static uint16_t s_i2c_size = 0;
+/* Control byte to restart transmission with, see ssd1306_i2cControlTrack() */
+static uint8_t s_i2c_control = SSD1306_I2C_CONTROL_NEXT;
+/* Number of bytes at the buffer start, already passed to the tracker */
+static uint16_t s_i2c_tracked = 0;
+
+static void platform_i2c_wait(void)
+{
+    while (HAL_I2C_GetState(&hi2c1) != HAL_I2C_STATE_READY)
+    {
+    }
+}
+
+/*
+ * Sends active staging buffer as separate i2c transaction and switches to the
+ * next buffer. The next buffer starts with the control byte, active at the point,
+ * where data were cut, unless the next byte is control byte itself.
+ */
+static void platform_i2c_flush(void)
+{
+    uint8_t *buffer = s_i2c_buffer[s_i2c_active];
+    s_i2c_control = ssd1306_i2cControlTrack(s_i2c_control, &buffer[s_i2c_tracked], s_i2c_size - s_i2c_tracked);
+    platform_i2c_wait();
+    if (HAL_I2C_Master_Transmit_DMA(&hi2c1, s_i2c_addr << 1, buffer, s_i2c_size) != HAL_OK)
+    {
+        HAL_I2C_Master_Transmit(&hi2c1, s_i2c_addr << 1, buffer, s_i2c_size, HAL_MAX_DELAY);
+    }
+    s_i2c_active ^= 1;
+    s_i2c_size = 0;
+    if (s_i2c_control != SSD1306_I2C_CONTROL_NEXT)
+    {
+        s_i2c_buffer[s_i2c_active][s_i2c_size++] = s_i2c_control;
+    }
+    s_i2c_tracked = s_i2c_size;
+}
 
 static void platform_i2c_start(void)
 {
-    // ... Open i2c channel for your device with specific s_i2c_addr
+    s_i2c_size = 0;
+    s_i2c_tracked = 0;
+    s_i2c_control = SSD1306_I2C_CONTROL_NEXT;
 }
 
 static void platform_i2c_stop(void)
 {
-    // ... Complete i2c communication
+    /* Control byte alone, left after restart, has no meaning */
+    if (s_i2c_size > s_i2c_tracked)
+    {
+        platform_i2c_flush();
+    }
+    s_i2c_size = 0;
+    platform_i2c_wait();
 }
 
 static void platform_i2c_send(uint8_t data)
 {
-    // ... Send byte to i2c communication channel
+    s_i2c_buffer[s_i2c_active][s_i2c_size++] = data;
+    if (s_i2c_size == STM32_STAGING_BUFFER_SIZE)
+    {
+        platform_i2c_flush();
+    }
 }
 
 static void platform_i2c_close(void)
 {
-    // ... free all i2c resources here
+    platform_i2c_wait();
 }
 
 static void platform_i2c_send_buffer(const uint8_t *data, uint16_t len)
 {
-    // ... Send len bytes to i2c communication channel here
+    while (len)
+    {
+        uint16_t size = STM32_STAGING_BUFFER_SIZE - s_i2c_size;
+        if (size > len) size = len;
+        memcpy(&s_i2c_buffer[s_i2c_active][s_i2c_size], data, size);
+        s_i2c_size += size;
+        if (s_i2c_size == STM32_STAGING_BUFFER_SIZE)
+        {
+            platform_i2c_flush();
+        }
+        data += size;
+        len -= size;
+    }
 }
 
 void ssd1306_platform_i2cInit(int8_t busId, uint8_t addr, ssd1306_platform_i2cConfig_t * cfg)
 {
     if (addr) s_i2c_addr = addr;
-    if (HAL_I2C_IsDeviceReady(&hi2c1, s_i2c_addr, 1, 20000) != HAL_OK)
+    if (HAL_I2C_IsDeviceReady(&hi2c1, s_i2c_addr << 1, 1, 20000) != HAL_OK)
     {
         return;
     }
+    s_i2c_active = 0;
+    s_i2c_size = 0;
     ssd1306_intf.spi = 0;
     ssd1306_intf.start = &platform_i2c_start;
     ssd1306_intf.stop  = &platform_i2c_stop;
     ssd1306_intf.send  = &platform_i2c_send;
     ssd1306_intf.close = &platform_i2c_close;
     ssd1306_intf.send_buffer = &platform_i2c_send_buffer;
-    // init your interface here
-    //...
 }
 #endif
 
@@ -85,29 +243,98 @@ void ssd1306_platform_i2cInit(int8_t busId, uint8_t addr, ssd1306_platform_i2cCo
 
 #include "intf/spi/ssd1306_spi.h"
 
+// SPI handle is defined by STM32CubeMX generated code. DMA TX channel must be
+// linked to the handle to use asynchronous transfers.
+extern SPI_HandleTypeDef hspi1;
+
+/* Two staging buffers: one is sent via DMA while the other one is being filled */
+static uint8_t s_spi_buffer[2][STM32_STAGING_BUFFER_SIZE];
+static uint8_t s_spi_active = 0;
+static uint16_t s_spi_size = 0;
+
+static void platform_spi_transmit(const uint8_t *data, uint16_t len)
+{
+    while (HAL_SPI_GetState(&hspi1) != HAL_SPI_STATE_READY)
+    {
+    }
+    if (HAL_SPI_Transmit_DMA(&hspi1, (uint8_t *)data, len) != HAL_OK)
+    {
+        HAL_SPI_Transmit(&hspi1, (uint8_t *)data, len, HAL_MAX_DELAY);
+    }
+}
+
+static void platform_spi_flush(void)
+{
+    if (s_spi_size)
+    {
+        platform_spi_transmit(s_spi_buffer[s_spi_active], s_spi_size);
+        s_spi_active ^= 1;
+        s_spi_size = 0;
+    }
+}
+
+/*
+ * Sends staged bytes and waits until all transfers are complete. D/C line is
+ * switched by ssd1306_spiDataMode() only after this call, so command and data
+ * segments never mix in one DMA transfer.
+ */
+static void platform_spi_wait(void)
+{
+    platform_spi_flush();
+    while (HAL_SPI_GetState(&hspi1) != HAL_SPI_STATE_READY)
+    {
+    }
+}
+
 static void platform_spi_start(void)
 {
-    // ... Open spi channel for your device with specific s_ssd1306_cs, s_ssd1306_dc
+    if (s_ssd1306_cs >= 0)
+    {
+        digitalWrite(s_ssd1306_cs, LOW);
+    }
 }
 
 static void platform_spi_stop(void)
 {
-    // ... Complete spi communication
+    platform_spi_wait();
+    if (s_ssd1306_cs >= 0)
+    {
+        digitalWrite(s_ssd1306_cs, HIGH);
+    }
 }
 
 static void platform_spi_send(uint8_t data)
 {
-    // ... Send byte to spi communication channel
+    s_spi_buffer[s_spi_active][s_spi_size++] = data;
+    if (s_spi_size == STM32_STAGING_BUFFER_SIZE)
+    {
+        platform_spi_flush();
+    }
 }
 
 static void platform_spi_close(void)
 {
-    // ... free all spi resources here
+    platform_spi_wait();
 }
 
 static void platform_spi_send_buffer(const uint8_t *data, uint16_t len)
 {
-    // ... Send len bytes to spi communication channel here
+    if (s_spi_size + len <= STM32_STAGING_BUFFER_SIZE)
+    {
+        memcpy(&s_spi_buffer[s_spi_active][s_spi_size], data, len);
+        s_spi_size += len;
+        return;
+    }
+    /* Large blocks are sent directly from caller buffer, which is valid until return */
+    platform_spi_flush();
+    platform_spi_transmit(data, len);
+    platform_spi_wait();
+}
+
+static void platform_spi_send_buffer_async(const uint8_t *data, uint16_t len)
+{
+    platform_spi_flush();
+    platform_spi_transmit(data, len);
 }
 
 void ssd1306_platform_spiInit(int8_t busId,
@@ -116,15 +343,186 @@ void ssd1306_platform_spiInit(int8_t busId,
 {
     if (cesPin>=0) s_ssd1306_cs = cesPin;
     if (dcPin>=0) s_ssd1306_dc = dcPin;
+    if (cesPin >=0) pinMode(cesPin, OUTPUT);
+    if (dcPin >= 0) pinMode(dcPin, OUTPUT);
+    s_spi_active = 0;
+    s_spi_size = 0;
     ssd1306_intf.spi = 1;
     ssd1306_intf.start = &platform_spi_start;
     ssd1306_intf.stop  = &platform_spi_stop;
     ssd1306_intf.send  = &platform_spi_send;
     ssd1306_intf.close = &platform_spi_close;
     ssd1306_intf.send_buffer = &platform_spi_send_buffer;
-    // init your interface here
-    //...
+    ssd1306_intf.send_buffer_async = &platform_spi_send_buffer_async;
+    ssd1306_intf.wait = &platform_spi_wait;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+// !!! PLATFORM PARALLEL IMPLEMENTATION OPTIONAL !!!
+#if defined(CONFIG_PLATFORM_PARALLEL_AVAILABLE) && defined(CONFIG_PLATFORM_PARALLEL_ENABLE)
+
+#include "intf/spi/ssd1306_spi.h"
+
+// FSMC bank and timings are configured by STM32CubeMX generated code (MX_FSMC_Init()).
+// D/C pin is driven by FSMC address line, so each byte is a single store to
+// command or data address, and no gpio is toggled during transfers.
+
+#define STM32_FSMC_CMD8   (*(volatile uint8_t *)STM32_FSMC_BANK_ADDR)
+#define STM32_FSMC_CMD16  (*(volatile uint16_t *)STM32_FSMC_BANK_ADDR)
+/* for 16-bit bus FSMC puts address line An to bit n+1 of the memory address */
+#define STM32_FSMC_DATA8  (*(volatile uint8_t *)(STM32_FSMC_BANK_ADDR + (1UL << STM32_FSMC_DC_LINE)))
+#define STM32_FSMC_DATA16 (*(volatile uint16_t *)(STM32_FSMC_BANK_ADDR + (2UL << STM32_FSMC_DC_LINE)))
+
+static uint8_t s_parallel_width = 8;
+static uint8_t s_parallel_active = 0;
+static uint8_t s_parallel_data = 0;
+/* Set when pixel data follow Memory Write command and are packed to 16-bit words */
+static uint8_t s_parallel_ram = 0;
+static int16_t s_parallel_hi = -1;
+
+static void platform_parallel_flush_byte(void)
+{
+    if (s_parallel_hi >= 0)
+    {
+        /* odd number of pixel bytes: send the last one as a whole word */
+        STM32_FSMC_DATA16 = (uint16_t)s_parallel_hi << 8;
+        s_parallel_hi = -1;
+    }
+}
+
+static void platform_parallel_start(void)
+{
+    if (s_ssd1306_cs >= 0)
+    {
+        digitalWrite(s_ssd1306_cs, LOW);
+    }
+}
+
+static void platform_parallel_wait(void)
+{
+    platform_parallel_flush_byte();
+    __DSB();
+}
+
+static void platform_parallel_stop(void)
+{
+    platform_parallel_wait();
+    if (s_ssd1306_cs >= 0)
+    {
+        digitalWrite(s_ssd1306_cs, HIGH);
+    }
+}
+
+static void platform_parallel_send(uint8_t data)
+{
+    if (s_parallel_width == 8)
+    {
+        if (s_parallel_data)
+        {
+            STM32_FSMC_DATA8 = data;
+        }
+        else
+        {
+            STM32_FSMC_CMD8 = data;
+            s_parallel_ram = (data == 0x2C) || (data == 0x3C);
+        }
+        return;
+    }
+    if (!s_parallel_data)
+    {
+        STM32_FSMC_CMD16 = data;
+        s_parallel_ram = (data == 0x2C) || (data == 0x3C);
+    }
+    else if (!s_parallel_ram)
+    {
+        STM32_FSMC_DATA16 = data;
+    }
+    else if (s_parallel_hi < 0)
+    {
+        s_parallel_hi = data;
+    }
+    else
+    {
+        STM32_FSMC_DATA16 = ((uint16_t)s_parallel_hi << 8) | data;
+        s_parallel_hi = -1;
+    }
+}
+
+static void platform_parallel_send_buffer(const uint8_t *data, uint16_t len)
+{
+    if (s_parallel_width == 8 && s_parallel_data)
+    {
+        while (len--)
+        {
+            STM32_FSMC_DATA8 = *data++;
+        }
+        return;
+    }
+    if (s_parallel_width == 16 && s_parallel_data && s_parallel_ram)
+    {
+        if (s_parallel_hi >= 0 && len)
+        {
+            STM32_FSMC_DATA16 = ((uint16_t)s_parallel_hi << 8) | *data++;
+            s_parallel_hi = -1;
+            len--;
+        }
+        while (len >= 2)
+        {
+            STM32_FSMC_DATA16 = ((uint16_t)data[0] << 8) | data[1];
+            data += 2;
+            len -= 2;
+        }
+        if (len)
+        {
+            s_parallel_hi = *data;
+        }
+        return;
+    }
+    while (len--)
+    {
+        platform_parallel_send(*data++);
+    }
+}
+
+static void platform_parallel_close(void)
+{
+    platform_parallel_wait();
+    s_parallel_active = 0;
+}
+
+uint8_t ssd1306_platform_parallelDataMode(uint8_t mode)
+{
+    if (!s_parallel_active)
+    {
+        return 0;
+    }
+    platform_parallel_flush_byte();
+    s_parallel_data = mode ? 1 : 0;
+    return 1;
+}
+
+void ssd1306_platform_parallelInit(int8_t cesPin, int8_t dcPin,
+                                   const ssd1306_platform_parallelConfig_t *cfg)
+{
+    (void)dcPin;
+    s_parallel_width = (cfg && cfg->width == 16) ? 16 : 8;
+    s_ssd1306_cs = cesPin;
+    if (cesPin >= 0) pinMode(cesPin, OUTPUT);
+    s_parallel_data = 0;
+    s_parallel_ram = 0;
+    s_parallel_hi = -1;
+    s_parallel_active = 1;
+    ssd1306_intf.spi = 1;
+    ssd1306_intf.start = &platform_parallel_start;
+    ssd1306_intf.stop  = &platform_parallel_stop;
+    ssd1306_intf.send  = &platform_parallel_send;
+    ssd1306_intf.close = &platform_parallel_close;
+    ssd1306_intf.send_buffer = &platform_parallel_send_buffer;
+    /* Stores to FSMC complete in order, so asynchronous send is the same as synchronous one */
+    ssd1306_intf.send_buffer_async = &platform_parallel_send_buffer;
+    ssd1306_intf.wait = &platform_parallel_wait;
 }
 #endif
 
-#endif // YOUR_PLATFORM
+#endif // SSD1306_STM32_PLATFORM
@@ -124,6 +124,11 @@ static inline uint8_t pgm_read_byte(const void *ptr)  // pgm_read_byte() - can b
     return *((const uint8_t *)ptr);
 }
 
+static inline void *memcpy_P(void *dest, const void *src, size_t n)  // memcpy_P() - can be left as is
+{
+    return memcpy(dest, src, n);
+}
+
 static inline uint16_t eeprom_read_word(const void *ptr)  // eeprom_read_word() - can be skipped
 {
     return 0;
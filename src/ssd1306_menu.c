@@ -33,11 +33,16 @@
 #define max(x,y) ((x)>(y)?(x):(y))
 #endif
 
+extern SFixedFontInfo s_fixedFont;
+
 static uint8_t getMaxScreenItems(void)
 {
     return (ssd1306_displayHeight() >> 3) - 2;
 }
 
+/* Max length of item text, copied from flash, including terminating zero */
+#define MENU_ITEM_TEXT_SIZE  32
+
 void ssd1306_createMenu(SAppMenu *menu, const char **items, uint8_t count)
 {
     menu->items = items;
@@ -45,9 +50,47 @@ void ssd1306_createMenu(SAppMenu *menu, const char **items, uint8_t count)
     menu->selection = 0;
     menu->oldSelection = 0;
     menu->scrollPosition = 0;
+    menu->getItem = NULL;
+    menu->progmem = 0;
+}
+
+void ssd1306_createMenuP(SAppMenu *menu, const char * const *items, uint16_t count)
+{
+    ssd1306_createMenu(menu, (const char **)items, 0);
+    menu->count = count;
+    menu->progmem = 1;
+}
+
+void ssd1306_createMenuEx(SAppMenu *menu, TMenuItemProvider getItem, uint16_t count)
+{
+    ssd1306_createMenu(menu, NULL, 0);
+    menu->count = count;
+    menu->getItem = getItem;
+}
+
+/* Returns text of the item in SRAM. Flash strings are copied to buf of MENU_ITEM_TEXT_SIZE bytes */
+static const char *menuItemText(SAppMenu *menu, uint16_t index, char *buf)
+{
+    if (menu->getItem)
+    {
+        return menu->getItem(index);
+    }
+    if (!menu->progmem)
+    {
+        return menu->items[index];
+    }
+    const char *text;
+    memcpy_P(&text, &menu->items[index], sizeof(text));
+    uint8_t i = 0;
+    while ( (i < MENU_ITEM_TEXT_SIZE - 1) && (buf[i] = pgm_read_byte(&text[i])) )
+    {
+        i++;
+    }
+    buf[i] = '\0';
+    return buf;
 }
 
-static uint8_t calculateScrollPosition(SAppMenu *menu, uint8_t selection)
+static uint16_t calculateScrollPosition(SAppMenu *menu, uint16_t selection)
 {
     if ( selection < menu->scrollPosition )
     {
@@ -60,8 +103,9 @@ static uint8_t calculateScrollPosition(SAppMenu *menu, uint8_t selection)
     return menu->scrollPosition;
 }
 
-static void drawMenuItem(SAppMenu *menu, uint8_t index)
+static void drawMenuItem(SAppMenu *menu, uint16_t index, uint8_t redraw)
 {
+    char buf[MENU_ITEM_TEXT_SIZE];
     if (index == menu->selection)
     {
         ssd1306_negativeMode();
@@ -70,12 +114,20 @@ static void drawMenuItem(SAppMenu *menu, uint8_t index)
     {
         ssd1306_positiveMode();
     }
-    ssd1306_printFixed(8, (index - menu->scrollPosition + 1)*8, menu->items[index], STYLE_NORMAL );
+    uint8_t x = 8 + ssd1306_printFixed(8, (index - menu->scrollPosition + 1)*8, menuItemText(menu, index, buf), STYLE_NORMAL ) *
+                    s_fixedFont.h.width;
     ssd1306_positiveMode();
+    /* Clear the rest of the line, when the item is redrawn over previous content.
+     * showMenu() draws on the cleared screen, so it doesn't need that */
+    if ( redraw && x < ssd1306_displayWidth() - 5 )
+    {
+        ssd1306_clearBlock(x, (index - menu->scrollPosition + 1), ssd1306_displayWidth() - 5 - x, 8);
+    }
 }
 
-static void drawMenuItem8(SAppMenu *menu, uint8_t index)
+static void drawMenuItem8(SAppMenu *menu, uint16_t index, uint8_t redraw)
 {
+    char buf[MENU_ITEM_TEXT_SIZE];
     if (index == menu->selection)
     {
         ssd1306_negativeMode();
@@ -84,12 +136,20 @@ static void drawMenuItem8(SAppMenu *menu, uint8_t index)
     {
         ssd1306_positiveMode();
     }
-    ssd1306_printFixed8(8, (index - menu->scrollPosition + 1)*8, menu->items[index], STYLE_NORMAL );
+    uint8_t x = 8 + ssd1306_printFixed8(8, (index - menu->scrollPosition + 1)*8, menuItemText(menu, index, buf), STYLE_NORMAL ) *
+                    s_fixedFont.h.width;
     ssd1306_positiveMode();
+    /* Clear the rest of the line, when the item is redrawn over previous content.
+     * showMenu() draws on the cleared screen, so it doesn't need that */
+    if ( redraw && x < ssd1306_displayWidth() - 5 )
+    {
+        ssd1306_clearBlock8(x, (index - menu->scrollPosition + 1)*8, ssd1306_displayWidth() - 5 - x, 8);
+    }
 }
 
-static void drawMenuItem16(SAppMenu *menu, uint8_t index)
+static void drawMenuItem16(SAppMenu *menu, uint16_t index, uint8_t redraw)
 {
+    char buf[MENU_ITEM_TEXT_SIZE];
     if (index == menu->selection)
     {
         ssd1306_negativeMode();
@@ -98,17 +158,24 @@ static void drawMenuItem16(SAppMenu *menu, uint8_t index)
     {
         ssd1306_positiveMode();
     }
-    ssd1306_printFixed16(8, (index - menu->scrollPosition + 1)*8, menu->items[index], STYLE_NORMAL );
+    uint8_t x = 8 + ssd1306_printFixed16(8, (index - menu->scrollPosition + 1)*8, menuItemText(menu, index, buf), STYLE_NORMAL ) *
+                    s_fixedFont.h.width;
     ssd1306_positiveMode();
+    /* Clear the rest of the line, when the item is redrawn over previous content.
+     * showMenu() draws on the cleared screen, so it doesn't need that */
+    if ( redraw && x < ssd1306_displayWidth() - 5 )
+    {
+        ssd1306_clearBlock16(x, (index - menu->scrollPosition + 1)*8, ssd1306_displayWidth() - 5 - x, 8);
+    }
 }
 
 void ssd1306_showMenu(SAppMenu *menu)
 {
     ssd1306_drawRect(4, 4, ssd1306_displayWidth() - 5, ssd1306_displayHeight() - 5);
     menu->scrollPosition = calculateScrollPosition( menu, menu->selection );
-    for (uint8_t i = menu->scrollPosition; i < min(menu->count, menu->scrollPosition + getMaxScreenItems()); i++)
+    for (uint16_t i = menu->scrollPosition; i < min(menu->count, menu->scrollPosition + getMaxScreenItems()); i++)
     {
-        drawMenuItem(menu, i);
+        drawMenuItem(menu, i, 0);
     }
     menu->oldSelection = menu->selection;
 }
@@ -117,9 +184,9 @@ void ssd1306_showMenu8(SAppMenu *menu)
 {
     ssd1306_drawRect8(4, 4, ssd1306_displayWidth() - 5, ssd1306_displayHeight() - 5);
     menu->scrollPosition = calculateScrollPosition( menu, menu->selection );
-    for (uint8_t i = menu->scrollPosition; i < min(menu->count, menu->scrollPosition + getMaxScreenItems()); i++)
+    for (uint16_t i = menu->scrollPosition; i < min(menu->count, menu->scrollPosition + getMaxScreenItems()); i++)
     {
-        drawMenuItem8(menu, i);
+        drawMenuItem8(menu, i, 0);
     }
     menu->oldSelection = menu->selection;
 }
@@ -128,71 +195,81 @@ void ssd1306_showMenu16(SAppMenu *menu)
 {
     ssd1306_drawRect16(4, 4, ssd1306_displayWidth() - 5, ssd1306_displayHeight() - 5);
     menu->scrollPosition = calculateScrollPosition( menu, menu->selection );
-    for (uint8_t i = menu->scrollPosition; i < min(menu->count, menu->scrollPosition + getMaxScreenItems()); i++)
+    for (uint16_t i = menu->scrollPosition; i < min(menu->count, menu->scrollPosition + getMaxScreenItems()); i++)
     {
-        drawMenuItem16(menu, i);
+        drawMenuItem16(menu, i, 0);
     }
     menu->oldSelection = menu->selection;
 }
 
-void ssd1306_updateMenu(SAppMenu *menu)
+/*
+ * Moves visible items by delta rows using display controller accelerator. Items are copied
+ * row by row in the order, which never overwrites rows not yet copied.
+ */
+static uint8_t moveMenuItems(int8_t delta)
 {
-    if (menu->selection != menu->oldSelection)
+    uint8_t count = getMaxScreenItems() - (delta > 0 ? delta : -delta);
+    for (uint8_t i = 0; i < count; i++)
     {
-        uint8_t scrollPosition = calculateScrollPosition( menu, menu->selection );
-        if ( scrollPosition != menu->scrollPosition )
-        {
-            ssd1306_clearScreen();
-            ssd1306_showMenu(menu);
-        }
-        else
+        /* dst is row on the screen, where item is moved to */
+        uint8_t dst = delta > 0 ? i : getMaxScreenItems() - 1 - i;
+        lcdint_t y = (dst + 1) * 8;
+        if ( !ssd1306_copyBlock( 8, y + delta * 8, ssd1306_displayWidth() - 6, y + delta * 8 + 7, 8, y ) )
         {
-            drawMenuItem(menu, menu->oldSelection);
-            drawMenuItem(menu, menu->selection);
-            menu->oldSelection = menu->selection;
+            return 0;
         }
     }
+    return 1;
 }
 
-void ssd1306_updateMenu8(SAppMenu *menu)
+static void updateMenu(SAppMenu *menu, void (*drawItem)(SAppMenu *menu, uint16_t index, uint8_t redraw))
 {
-    if (menu->selection != menu->oldSelection)
+    if (menu->selection == menu->oldSelection)
     {
-        uint8_t scrollPosition = calculateScrollPosition( menu, menu->selection );
-        if ( scrollPosition != menu->scrollPosition )
-        {
-            ssd1306_clearScreen8();
-            ssd1306_showMenu8(menu);
-        }
-        else
+        return;
+    }
+    uint16_t scrollPosition = calculateScrollPosition( menu, menu->selection );
+    if ( scrollPosition == menu->scrollPosition )
+    {
+        drawItem(menu, menu->oldSelection, 1);
+        drawItem(menu, menu->selection, 1);
+    }
+    else
+    {
+        int16_t delta = (int16_t)(scrollPosition - menu->scrollPosition);
+        uint16_t oldFirst = menu->scrollPosition;
+        uint8_t moved = (delta > -(int16_t)getMaxScreenItems()) && (delta < (int16_t)getMaxScreenItems()) &&
+                        moveMenuItems( delta );
+        menu->scrollPosition = scrollPosition;
+        for (uint16_t i = scrollPosition; i < min(menu->count, scrollPosition + getMaxScreenItems()); i++)
         {
-            drawMenuItem8(menu, menu->oldSelection);
-            drawMenuItem8(menu, menu->selection);
-            menu->oldSelection = menu->selection;
+            /* Only items, which were not visible before, and changed selection need redrawing */
+            if ( !moved || (i < oldFirst) || (i >= oldFirst + getMaxScreenItems()) ||
+                 (i == menu->selection) || (i == menu->oldSelection) )
+            {
+                drawItem(menu, i, 1);
+            }
         }
     }
+    menu->oldSelection = menu->selection;
+}
+
+void ssd1306_updateMenu(SAppMenu *menu)
+{
+    updateMenu(menu, drawMenuItem);
+}
+
+void ssd1306_updateMenu8(SAppMenu *menu)
+{
+    updateMenu(menu, drawMenuItem8);
 }
 
 void ssd1306_updateMenu16(SAppMenu *menu)
 {
-    if (menu->selection != menu->oldSelection)
-    {
-        uint8_t scrollPosition = calculateScrollPosition( menu, menu->selection );
-        if ( scrollPosition != menu->scrollPosition )
-        {
-            ssd1306_clearScreen16();
-            ssd1306_showMenu16(menu);
-        }
-        else
-        {
-            drawMenuItem16(menu, menu->oldSelection);
-            drawMenuItem16(menu, menu->selection);
-            menu->oldSelection = menu->selection;
-        }
-    }
+    updateMenu(menu, drawMenuItem16);
 }
 
-uint8_t ssd1306_menuSelection(SAppMenu *menu)
+uint16_t ssd1306_menuSelection(SAppMenu *menu)
 {
     return menu->selection;
 }
@@ -0,0 +1,333 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306.h"
+#include "lcd/lcd_common.h"
+
+#define GFX_POLYGON_MAX_NODES  16
+
+/* Returns x of the edge at line y as fixed point number with 8 fractional bits */
+static int32_t gfx_edgeX(lcdint_t xa, lcdint_t ya, lcdint_t xb, lcdint_t yb, lcdint_t y)
+{
+    int32_t num = ((int32_t)(y - ya) * (xb - xa)) << 8;
+    int32_t den = yb - ya;
+    if (den < 0)
+    {
+        num = -num;
+        den = -den;
+    }
+    /* floor division */
+    return ((int32_t)xa << 8) + (num >= 0 ? num / den : -((-num + den - 1) / den));
+}
+
+/* Emits pixels, which centers lie between fixed point positions lo and hi */
+static void gfx_fixedSpan(lcdint_t line, int32_t lo, int32_t hi, uint8_t thin, gfx_span_cb span, void *ctx)
+{
+    lcdint_t a = (lcdint_t)((lo + 255) >> 8);
+    lcdint_t b = (lcdint_t)(hi >> 8);
+    if ( a <= b )
+    {
+        span(ctx, line, a, b);
+    }
+    else if ( thin )
+    {
+        /* too thin to cover pixel centers, draw the nearest pixel to keep the shape visible */
+        a = (lcdint_t)(((lo + hi) / 2 + 128) >> 8);
+        span(ctx, line, a, a);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  SPAN RASTERIZERS
+///////////////////////////////////////////////////////////////////////////////
+
+/* Emits spans of one line of rounded rect: left and right corner parts, or the whole line */
+static void gfx_roundRectLine(lcdint_t line, lcdint_t xl, lcdint_t xr, lcdint_t w, lcdint_t wnext,
+                              uint8_t fill, gfx_span_cb span, void *ctx)
+{
+    if ( fill || (wnext < 0) )
+    {
+        span(ctx, line, xl - w, xr + w);
+        return;
+    }
+    lcdint_t inner = wnext + 1 > w ? w : wnext + 1;
+    if ( xl - inner >= xr + inner )
+    {
+        /* left and right parts meet */
+        span(ctx, line, xl - w, xr + w);
+        return;
+    }
+    span(ctx, line, xl - w, xl - inner);
+    span(ctx, line, xr + inner, xr + w);
+}
+
+void gfx_roundRectSpans(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2,
+                        lcduint_t rx, lcduint_t ry, uint8_t flags, gfx_span_cb span, void *ctx)
+{
+    if ( flags & GFX_SPANS_COLUMNS )
+    {
+        ssd1306_swap_data(x1, y1, lcdint_t);
+        ssd1306_swap_data(x2, y2, lcdint_t);
+        ssd1306_swap_data(rx, ry, lcduint_t);
+    }
+    if ( (x2 < x1) || (y2 < y1) )
+    {
+        return;
+    }
+    uint8_t fill = flags & GFX_SPANS_FILL;
+    if ( rx > (lcduint_t)((x2 - x1) >> 1) ) rx = (x2 - x1) >> 1;
+    if ( ry > (lcduint_t)((y2 - y1) >> 1) ) ry = (y2 - y1) >> 1;
+    /* keep calculations below in 32 bits */
+    if ( rx > 160 ) rx = 160;
+    if ( ry > 160 ) ry = 160;
+    lcdint_t xl = x1 + rx;
+    lcdint_t xr = x2 - rx;
+    lcdint_t yt = y1 + ry;
+    lcdint_t yb = y2 - ry;
+    for (lcdint_t y = yt + 1; y < yb; y++)
+    {
+        if ( fill || (x2 - x1 < 2) )
+        {
+            span(ctx, y, x1, x2);
+        }
+        else
+        {
+            span(ctx, y, x1, x1);
+            span(ctx, y, x2, x2);
+        }
+    }
+    /* Pixel (x, d) is inside the corner if x^2 * (2ry+1)^2 + d^2 * (2rx+1)^2 <= (2rx+1)^2 * (2ry+1)^2 / 4.
+     * Half-width w of each line is updated incrementally, while moving from the middle to the top. */
+    uint32_t a = (uint32_t)(2 * rx + 1) * (2 * rx + 1);
+    uint32_t b = (uint32_t)(2 * ry + 1) * (2 * ry + 1);
+    /* a is odd square, so a * b / 4 == (a >> 2) * b + (b >> 2) */
+    uint32_t limit = (a >> 2) * b + (b >> 2);
+    uint32_t f = (uint32_t)rx * rx * b;
+    lcdint_t w = rx;
+    for (lcduint_t d = 0; d <= ry; d++)
+    {
+        lcdint_t wnext = -1;
+        if ( d < ry )
+        {
+            /* f(w, d + 1) */
+            f += (uint32_t)(2 * d + 1) * a;
+            wnext = w;
+            while ( f > limit )
+            {
+                f -= (uint32_t)(2 * wnext - 1) * b;
+                wnext--;
+            }
+        }
+        gfx_roundRectLine(yt - d, xl, xr, w, wnext, fill, span, ctx);
+        if ( yb + (lcdint_t)d != yt - (lcdint_t)d )
+        {
+            gfx_roundRectLine(yb + d, xl, xr, w, wnext, fill, span, ctx);
+        }
+        w = wnext;
+    }
+}
+
+void gfx_triangleSpans(const lcdint_t *xy, uint8_t flags, gfx_span_cb span, void *ctx)
+{
+    uint8_t t = (flags & GFX_SPANS_COLUMNS) ? 1 : 0;
+    lcdint_t top = xy[1 - t], bottom = top;
+    for (uint8_t i = 1; i < 3; i++)
+    {
+        lcdint_t y = xy[i * 2 + 1 - t];
+        if (y < top) top = y;
+        if (y > bottom) bottom = y;
+    }
+    for (lcdint_t y = top; y <= bottom; y++)
+    {
+        int32_t lo = INT32_MAX, hi = INT32_MIN;
+        for (uint8_t i = 0; i < 3; i++)
+        {
+            uint8_t j = i < 2 ? i + 1 : 0;
+            lcdint_t xa = xy[i * 2 + t], ya = xy[i * 2 + 1 - t];
+            lcdint_t xb = xy[j * 2 + t], yb = xy[j * 2 + 1 - t];
+            if ( (y < ya) == (y < yb) && (y != ya) && (y != yb) )
+            {
+                continue;
+            }
+            int32_t x1 = (ya == yb) ? ((int32_t)xa << 8) : gfx_edgeX(xa, ya, xb, yb, y);
+            int32_t x2 = (ya == yb) ? ((int32_t)xb << 8) : x1;
+            if (x1 > x2) ssd1306_swap_data(x1, x2, int32_t);
+            if (x1 < lo) lo = x1;
+            if (x2 > hi) hi = x2;
+        }
+        gfx_fixedSpan(y, lo, hi, 1, span, ctx);
+    }
+}
+
+void gfx_polygonSpans(const lcdint_t *xy, uint8_t count, uint8_t flags, gfx_span_cb span, void *ctx)
+{
+    uint8_t t = (flags & GFX_SPANS_COLUMNS) ? 1 : 0;
+    int32_t nodes[GFX_POLYGON_MAX_NODES];
+    if (count < 3) return;
+    lcdint_t top = xy[1 - t], bottom = top;
+    for (uint8_t i = 1; i < count; i++)
+    {
+        lcdint_t y = xy[i * 2 + 1 - t];
+        if (y < top) top = y;
+        if (y > bottom) bottom = y;
+    }
+    for (lcdint_t y = top; y < bottom; y++)
+    {
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            uint8_t j = (i + 1 < count) ? i + 1 : 0;
+            lcdint_t xa = xy[i * 2 + t], ya = xy[i * 2 + 1 - t];
+            lcdint_t xb = xy[j * 2 + t], yb = xy[j * 2 + 1 - t];
+            if ( (ya == yb) || ((y < ya) == (y < yb)) || (n >= GFX_POLYGON_MAX_NODES) )
+            {
+                continue;
+            }
+            /* Sort crossing points with insertion sort: there are few of them */
+            int32_t x = gfx_edgeX(xa, ya, xb, yb, y);
+            uint8_t k = n++;
+            while ( k && (nodes[k - 1] > x) )
+            {
+                nodes[k] = nodes[k - 1];
+                k--;
+            }
+            nodes[k] = x;
+        }
+        for (uint8_t k = 0; k + 1 < n; k += 2)
+        {
+            gfx_fixedSpan(y, nodes[k], nodes[k + 1], 0, span, ctx);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  DIRECT DRAW SHAPES
+///////////////////////////////////////////////////////////////////////////////
+
+/* Clips span to the display. Returns 0, if nothing is left */
+static uint8_t ssd1306_clipSpan(lcdint_t line, lcdint_t *a, lcdint_t *b, lcduint_t lines, lcduint_t length)
+{
+    if ( (line < 0) || (line >= (lcdint_t)lines) ) return 0;
+    if ( *a < 0 ) *a = 0;
+    if ( *b >= (lcdint_t)length ) *b = length - 1;
+    return *a <= *b;
+}
+
+static void ssd1306_hspan1(void *ctx, lcdint_t y, lcdint_t a, lcdint_t b)
+{
+    if ( ssd1306_clipSpan(y, &a, &b, ssd1306_lcd.height, ssd1306_lcd.width) ) ssd1306_drawHLine(a, y, b);
+}
+
+static void ssd1306_vspan1(void *ctx, lcdint_t x, lcdint_t a, lcdint_t b)
+{
+    if ( ssd1306_clipSpan(x, &a, &b, ssd1306_lcd.width, ssd1306_lcd.height) ) ssd1306_drawVLine(x, a, b);
+}
+
+static void ssd1306_hspan8(void *ctx, lcdint_t y, lcdint_t a, lcdint_t b)
+{
+    if ( ssd1306_clipSpan(y, &a, &b, ssd1306_lcd.height, ssd1306_lcd.width) ) ssd1306_fillRect8(a, y, b, y);
+}
+
+static void ssd1306_hspan16(void *ctx, lcdint_t y, lcdint_t a, lcdint_t b)
+{
+    if ( ssd1306_clipSpan(y, &a, &b, ssd1306_lcd.height, ssd1306_lcd.width) ) ssd1306_fillRect16(a, y, b, y);
+}
+
+void ssd1306_drawCircle(lcdint_t x, lcdint_t y, lcduint_t r)
+{
+    gfx_roundRectSpans(x - r, y - r, x + r, y + r, r, r, 0, ssd1306_hspan1, 0);
+}
+
+void ssd1306_fillCircle(lcdint_t x, lcdint_t y, lcduint_t r)
+{
+    gfx_roundRectSpans(x - r, y - r, x + r, y + r, r, r, GFX_SPANS_FILL | GFX_SPANS_COLUMNS, ssd1306_vspan1, 0);
+}
+
+void ssd1306_drawRoundRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r)
+{
+    gfx_roundRectSpans(x1, y1, x2, y2, r, r, 0, ssd1306_hspan1, 0);
+}
+
+void ssd1306_fillRoundRect(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r)
+{
+    gfx_roundRectSpans(x1, y1, x2, y2, r, r, GFX_SPANS_FILL | GFX_SPANS_COLUMNS, ssd1306_vspan1, 0);
+}
+
+void ssd1306_fillTriangle(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x3, lcdint_t y3)
+{
+    lcdint_t xy[6] = { x1, y1, x2, y2, x3, y3 };
+    gfx_triangleSpans(xy, GFX_SPANS_COLUMNS, ssd1306_vspan1, 0);
+}
+
+void ssd1306_drawCircle8(lcdint_t x, lcdint_t y, lcduint_t r)
+{
+    gfx_roundRectSpans(x - r, y - r, x + r, y + r, r, r, 0, ssd1306_hspan8, 0);
+}
+
+void ssd1306_fillCircle8(lcdint_t x, lcdint_t y, lcduint_t r)
+{
+    gfx_roundRectSpans(x - r, y - r, x + r, y + r, r, r, GFX_SPANS_FILL, ssd1306_hspan8, 0);
+}
+
+void ssd1306_drawRoundRect8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r)
+{
+    gfx_roundRectSpans(x1, y1, x2, y2, r, r, 0, ssd1306_hspan8, 0);
+}
+
+void ssd1306_fillRoundRect8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r)
+{
+    gfx_roundRectSpans(x1, y1, x2, y2, r, r, GFX_SPANS_FILL, ssd1306_hspan8, 0);
+}
+
+void ssd1306_fillTriangle8(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x3, lcdint_t y3)
+{
+    lcdint_t xy[6] = { x1, y1, x2, y2, x3, y3 };
+    gfx_triangleSpans(xy, 0, ssd1306_hspan8, 0);
+}
+
+void ssd1306_drawCircle16(lcdint_t x, lcdint_t y, lcduint_t r)
+{
+    gfx_roundRectSpans(x - r, y - r, x + r, y + r, r, r, 0, ssd1306_hspan16, 0);
+}
+
+void ssd1306_fillCircle16(lcdint_t x, lcdint_t y, lcduint_t r)
+{
+    gfx_roundRectSpans(x - r, y - r, x + r, y + r, r, r, GFX_SPANS_FILL, ssd1306_hspan16, 0);
+}
+
+void ssd1306_drawRoundRect16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r)
+{
+    gfx_roundRectSpans(x1, y1, x2, y2, r, r, 0, ssd1306_hspan16, 0);
+}
+
+void ssd1306_fillRoundRect16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcduint_t r)
+{
+    gfx_roundRectSpans(x1, y1, x2, y2, r, r, GFX_SPANS_FILL, ssd1306_hspan16, 0);
+}
+
+void ssd1306_fillTriangle16(lcdint_t x1, lcdint_t y1, lcdint_t x2, lcdint_t y2, lcdint_t x3, lcdint_t y3)
+{
+    lcdint_t xy[6] = { x1, y1, x2, y2, x3, y3 };
+    gfx_triangleSpans(xy, 0, ssd1306_hspan16, 0);
+}
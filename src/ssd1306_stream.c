@@ -0,0 +1,330 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include "ssd1306_stream.h"
+#include "lcd/lcd_common.h"
+#include "intf/ssd1306_interface.h"
+
+#if (defined(__linux__) && !defined(ARDUINO) && !defined(__KERNEL__)) || \
+    defined(SSD1306_ESP_PLATFORM)
+#include <stdio.h>
+#endif
+
+#define STREAM_HEADER_SIZE  16
+#define STREAM_FRAME_SIZE   13
+#define STREAM_VERSION      1
+#define STREAM_FLAG_RLE     0x01
+
+extern uint8_t s_ssd1306_invertByte;
+
+static uint16_t streamRead16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+/* Reads exactly size bytes, returns -1 if stream ends earlier */
+static int streamReadAll(SImageStream *s, uint8_t *buffer, uint16_t size)
+{
+    while (size)
+    {
+        int len = s->read(s->arg, buffer, size);
+        if (len <= 0)
+        {
+            return -1;
+        }
+        buffer += len;
+        size -= len;
+    }
+    return 0;
+}
+
+int ssd1306_streamOpen(SImageStream *stream, ssd1306_stream_read_t read, void *arg,
+                       uint8_t *buffer, uint16_t size)
+{
+    stream->read = read;
+    stream->arg = arg;
+    stream->buffer = buffer;
+    stream->size = size;
+    stream->frame = 0;
+    stream->frames = 0;
+    if ( size < 32 || streamReadAll(stream, buffer, STREAM_HEADER_SIZE) < 0 ||
+         buffer[0] != 'S' || buffer[1] != 'I' || buffer[2] != 'M' || buffer[3] != 'G' ||
+         buffer[4] != STREAM_VERSION ||
+         (buffer[5] != 1 && buffer[5] != 8 && buffer[5] != 16) )
+    {
+        return -1;
+    }
+    stream->bpp = buffer[5];
+    stream->width = streamRead16(&buffer[6]);
+    stream->height = streamRead16(&buffer[8]);
+    stream->frames = streamRead16(&buffer[10]);
+    stream->frameTime = streamRead16(&buffer[12]);
+    return 0;
+}
+
+/* Sends chunk of frame data. Monochrome data are split at page boundaries */
+static void streamSend(SImageStream *s, uint8_t *data, uint16_t len)
+{
+    if ( s_ssd1306_invertByte && s->bpp == 1 )
+    {
+        for (uint16_t i = 0; i < len; i++) data[i] ^= s_ssd1306_invertByte;
+    }
+    if ( s->bpp == 8 )
+    {
+        if ( s->async ) ssd1306_intf.send_buffer_async(data, len);
+        else ssd1306_lcd.send_pixels_buffer8(data, len);
+        return;
+    }
+    if ( s->bpp == 16 )
+    {
+        if ( s->async ) ssd1306_intf.send_buffer_async(data, len);
+        else ssd1306_lcd.send_pixels_buffer16(data, len >> 1);
+        return;
+    }
+    while (len)
+    {
+        uint16_t count = s->pageWidth - s->column;
+        if ( count > len ) count = len;
+        if ( s->async ) ssd1306_intf.send_buffer_async(data, count);
+        else ssd1306_lcd.send_pixels_buffer1(data, count);
+        data += count;
+        len -= count;
+        s->column += count;
+        if ( s->column == s->pageWidth )
+        {
+            s->column = 0;
+            ssd1306_intf.wait();
+            ssd1306_lcd.next_page();
+        }
+    }
+}
+
+/* Sends filled output half of the buffer and switches to another half */
+static void streamFlush(SImageStream *s)
+{
+    if ( !s->outLen )
+    {
+        return;
+    }
+    /* Previous chunk must be sent before the next one is started */
+    ssd1306_intf.wait();
+    streamSend(s, s->out, s->outLen);
+    s->out = (s->out == s->buffer + s->inSize) ? s->out + s->outSize : s->buffer + s->inSize;
+    s->outLen = 0;
+}
+
+static int streamByte(SImageStream *s)
+{
+    if ( s->inPos == s->inLen )
+    {
+        uint16_t len = s->payload < s->inSize ? s->payload : s->inSize;
+        if ( !len || streamReadAll(s, s->in, len) < 0 )
+        {
+            return -1;
+        }
+        s->payload -= len;
+        s->inLen = len;
+        s->inPos = 0;
+    }
+    return s->in[s->inPos++];
+}
+
+static int streamDecodeRaw(SImageStream *s, uint32_t total)
+{
+    if ( s->payload != total )
+    {
+        return -1;
+    }
+    while (s->payload)
+    {
+        uint16_t len = s->payload < s->outSize ? s->payload : s->outSize;
+        /* Reading to free half overlaps with sending of another one */
+        if ( streamReadAll(s, s->out, len) < 0 )
+        {
+            return -1;
+        }
+        s->payload -= len;
+        s->outLen = len;
+        streamFlush(s);
+    }
+    return 0;
+}
+
+static int streamDecodeRle(SImageStream *s, uint32_t total)
+{
+    uint8_t unit = s->bpp == 16 ? 2 : 1;
+    uint8_t value[2];
+    while (total)
+    {
+        /* Bit 7 of header means repeated unit, the rest is number of units - 1 */
+        int header = streamByte(s);
+        if ( header < 0 )
+        {
+            return -1;
+        }
+        uint8_t count = (header & 0x7F) + 1;
+        for (uint8_t i = 0; i < count && total; i++)
+        {
+            if ( !(header & 0x80) || !i )
+            {
+                for (uint8_t n = 0; n < unit; n++)
+                {
+                    int data = streamByte(s);
+                    if ( data < 0 )
+                    {
+                        return -1;
+                    }
+                    value[n] = data;
+                }
+            }
+            for (uint8_t n = 0; n < unit; n++)
+            {
+                s->out[s->outLen++] = value[n];
+            }
+            if ( s->outLen == s->outSize )
+            {
+                streamFlush(s);
+            }
+            total -= unit;
+        }
+    }
+    streamFlush(s);
+    return 0;
+}
+
+int ssd1306_streamDrawFrame(SImageStream *stream, lcdint_t x, lcdint_t y)
+{
+    uint8_t header[STREAM_FRAME_SIZE];
+    if ( stream->frame >= stream->frames )
+    {
+        return 0;
+    }
+    if ( streamReadAll(stream, header, STREAM_FRAME_SIZE) < 0 )
+    {
+        return -1;
+    }
+    uint16_t fx = streamRead16(&header[1]);
+    uint16_t fy = streamRead16(&header[3]);
+    uint16_t fw = streamRead16(&header[5]);
+    uint16_t fh = streamRead16(&header[7]);
+    stream->payload = (uint32_t)streamRead16(&header[9]) | ((uint32_t)streamRead16(&header[11]) << 16);
+    if ( (uint32_t)fx + fw > stream->width || (uint32_t)fy + fh > stream->height ||
+         (stream->bpp == 1 && ((fy | fh | y) & 7)) )
+    {
+        return -1;
+    }
+    stream->frame++;
+    if ( !fw || !fh )
+    {
+        /* Frame without changes, only keeps the frame period */
+        return stream->payload ? -1 : 1;
+    }
+    uint8_t rle = header[0] & STREAM_FLAG_RLE;
+    uint8_t unit = stream->bpp == 16 ? 2 : 1;
+    /* RLE input takes quarter of the buffer, the rest is split to 2 output halves */
+    stream->inSize = rle ? (stream->size >> 2) : 0;
+    stream->outSize = ((stream->size - stream->inSize) >> 1) & ~(uint16_t)(unit - 1);
+    stream->in = stream->buffer;
+    stream->inPos = 0;
+    stream->inLen = 0;
+    stream->out = stream->buffer + stream->inSize;
+    stream->outLen = 0;
+    stream->column = 0;
+    stream->pageWidth = fw;
+    switch (stream->bpp)
+    {
+        case 1:
+            stream->async = ssd1306_lcd.send_pixels_buffer1 == ssd1306_intf.send_buffer;
+            break;
+        case 8:
+            stream->async = ssd1306_lcd.send_pixels_buffer8 == ssd1306_intf.send_buffer;
+            break;
+        default:
+            stream->async = ssd1306_lcd.send_pixels_buffer16 == ssd1306_sendPixelsBuffer16 &&
+                            !ssd1306_isColorCorrection16();
+            break;
+    }
+    uint32_t total = (uint32_t)fw * (stream->bpp == 1 ? (fh >> 3) : fh) * unit;
+    ssd1306_lcd.set_block(x + fx, stream->bpp == 1 ? ((y + fy) >> 3) : (y + fy), fw);
+    int result = rle ? streamDecodeRle(stream, total) : streamDecodeRaw(stream, total);
+    ssd1306_intf.wait();
+    ssd1306_intf.stop();
+    if ( result < 0 )
+    {
+        return -1;
+    }
+    /* Skip unused data, so next frame header is read from the right position */
+    while (stream->payload)
+    {
+        uint16_t len = stream->payload < stream->size ? stream->payload : stream->size;
+        if ( streamReadAll(stream, stream->buffer, len) < 0 )
+        {
+            return -1;
+        }
+        stream->payload -= len;
+    }
+    return 1;
+}
+
+int ssd1306_streamPlay(SImageStream *stream, lcdint_t x, lcdint_t y)
+{
+    int count = 0;
+    uint32_t ts = millis();
+    for (;;)
+    {
+        int result = ssd1306_streamDrawFrame(stream, x, y);
+        if ( result <= 0 )
+        {
+            return result < 0 ? -1 : count;
+        }
+        count++;
+        ts += stream->frameTime;
+        int32_t wait = (int32_t)(ts - millis());
+        if ( wait > 0 )
+        {
+            delay(wait);
+        }
+        else
+        {
+            /* Too slow source or interface: don't try to catch up */
+            ts = millis();
+        }
+    }
+}
+
+#if (defined(__linux__) && !defined(ARDUINO) && !defined(__KERNEL__)) || \
+    defined(SSD1306_ESP_PLATFORM)
+
+int ssd1306_streamReadFile(void *file, uint8_t *buffer, uint16_t size)
+{
+    size_t len = fread(buffer, 1, size, (FILE *)file);
+    if ( !len && ferror((FILE *)file) )
+    {
+        return -1;
+    }
+    return len;
+}
+
+#endif
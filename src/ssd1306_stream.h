@@ -0,0 +1,175 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/**
+ * @file ssd1306_stream.h Streamed image and animation playback from file or SD card
+ */
+
+#ifndef _SSD1306_STREAM_H_
+#define _SSD1306_STREAM_H_
+
+#include "ssd1306_hal/io.h"
+#include "nano_gfx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_STREAM_API STREAM: Image streaming
+ * @{
+ *
+ * @brief Fullscreen images and animations, streamed from file directly to the display
+ *
+ * @details Image stream (see tools/format.txt, created by tools/streamencode.py) is
+ *          a sequence of frames, each frame updates single rectangle of the display.
+ *          Frame data are read in chunks to the half of the buffer, passed by the
+ *          application, while another half is sent to the display, so neither
+ *          RAM for the whole frame, nor Flash for the images is needed. If the
+ *          interface supports asynchronous transfers (ssd1306_intf.send_buffer_async())
+ *          and data don't need conversion, reading of next chunk overlaps sending of
+ *          previous one. Frame data can be raw or RLE-compressed in bitmapcompress.py
+ *          format, and only changed area can be stored for animations.
+ *          Monochrome streams are sent with ssd1306_lcd.send_pixels_buffer1(), 8-bit
+ *          streams with ssd1306_lcd.send_pixels_buffer8() and RGB565 streams with
+ *          ssd1306_lcd.send_pixels_buffer16(), so display mode must match stream format.
+ */
+
+/**
+ * Reads up to size bytes from stream source.
+ * @param arg argument, passed to ssd1306_streamOpen()
+ * @param buffer buffer to read data to
+ * @param size number of bytes to read
+ * @return number of bytes read, 0 at the end of the stream or negative value on error
+ */
+typedef int (*ssd1306_stream_read_t)(void *arg, uint8_t *buffer, uint16_t size);
+
+/**
+ * Opened image stream
+ */
+typedef struct
+{
+    /// width of the stream images in pixels
+    uint16_t width;
+    /// height of the stream images in pixels
+    uint16_t height;
+    /// bits per pixel: 1, 8 or 16
+    uint8_t bpp;
+    /// number of frames in the stream
+    uint16_t frames;
+    /// frame period in milliseconds
+    uint16_t frameTime;
+    /// index of the next frame to draw
+    uint16_t frame;
+
+    /// function to read stream data
+    ssd1306_stream_read_t read;
+    /// argument of read function
+    void *arg;
+    /// buffer for stream data, passed to ssd1306_streamOpen()
+    uint8_t *buffer;
+    /// size of the buffer in bytes
+    uint16_t size;
+
+    // Decoder state, internally updated
+    uint8_t *in;
+    uint16_t inSize;
+    uint16_t inPos;
+    uint16_t inLen;
+    uint32_t payload;
+    uint8_t *out;
+    uint16_t outSize;
+    uint16_t outLen;
+    uint16_t column;
+    uint16_t pageWidth;
+    uint8_t async;
+} SImageStream;
+
+/**
+ * Opens image stream and reads its header.
+ *
+ * @param stream pointer to stream structure to initialize
+ * @param read function to read stream data
+ * @param arg argument to pass to read function (FILE pointer, SD File, etc.)
+ * @param buffer buffer for data chunks, twice larger than single chunk. 512 bytes
+ *        to 1 KiB is enough to keep the interface busy.
+ * @param size size of the buffer, at least 32 bytes
+ * @return 0 on success, -1 on error
+ */
+int ssd1306_streamOpen(SImageStream *stream, ssd1306_stream_read_t read, void *arg,
+                       uint8_t *buffer, uint16_t size);
+
+/**
+ * Draws next frame of the stream.
+ *
+ * @param stream pointer to opened stream
+ * @param x left position of the stream images on the display in pixels
+ * @param y top position of the stream images on the display in pixels,
+ *        should be multiple of 8 for monochrome streams
+ * @return 1 if frame is drawn, 0 if there are no more frames, -1 on error
+ */
+int ssd1306_streamDrawFrame(SImageStream *stream, lcdint_t x, lcdint_t y);
+
+/**
+ * Draws all remaining frames of the stream, keeping frame period of the stream.
+ *
+ * @param stream pointer to opened stream
+ * @param x left position of the stream images on the display in pixels
+ * @param y top position of the stream images on the display in pixels
+ * @return number of drawn frames or -1 on error
+ */
+int ssd1306_streamPlay(SImageStream *stream, lcdint_t x, lcdint_t y);
+
+#if (defined(__linux__) && !defined(ARDUINO) && !defined(__KERNEL__)) || \
+    defined(SSD1306_ESP_PLATFORM)
+/**
+ * Read function for ssd1306_streamOpen() to read stream from stdio file
+ * (Linux files, ESP32 VFS: SPIFFS, FAT on SD card).
+ * @param file pointer to FILE, opened in binary mode
+ */
+int ssd1306_streamReadFile(void *file, uint8_t *buffer, uint16_t size);
+#endif
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(ARDUINO) && defined(__cplusplus)
+/**
+ * @ingroup LCD_STREAM_API
+ * Read function for ssd1306_streamOpen() to read stream from Arduino Stream
+ * object: SD File, Serial, etc.
+ * @param stream pointer to Stream object
+ */
+static inline int ssd1306_streamReadArduino(void *stream, uint8_t *buffer, uint16_t size)
+{
+    return static_cast<Stream *>(stream)->readBytes(buffer, size);
+}
+#endif
+
+#endif // _SSD1306_STREAM_H_
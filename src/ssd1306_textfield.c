@@ -0,0 +1,184 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306.h"
+
+extern SFixedFontInfo s_fixedFont;
+
+void ssd1306_createTextField(STextField *field, lcdint_t x, lcdint_t y, char *buffer, uint8_t size)
+{
+    field->text = buffer;
+    field->size = size;
+    field->x = x;
+    field->y = y;
+    field->width = 0;
+    buffer[0] = '\0';
+}
+
+/* Draws single char, its spacing and background below glyph */
+static void drawChar(lcdint_t x, lcdint_t y, const char *ch, const SCharInfo *info)
+{
+    ssd1306_printFixed(x, y, ch, STYLE_NORMAL);
+}
+
+static void clearArea(lcdint_t x, lcdint_t y, lcduint_t w)
+{
+    ssd1306_clearBlock(x, y >> 3, w, s_fixedFont.pages << 3);
+}
+
+static void drawChar8(lcdint_t x, lcdint_t y, const char *ch, const SCharInfo *info)
+{
+    ssd1306_printFixed8(x, y, ch, STYLE_NORMAL);
+    ssd1306_clearBlock8(x + info->width, y, info->spacing, s_fixedFont.h.height);
+    if ( info->height < s_fixedFont.h.height )
+    {
+        ssd1306_clearBlock8(x, y + info->height, info->width, s_fixedFont.h.height - info->height);
+    }
+}
+
+static void clearArea8(lcdint_t x, lcdint_t y, lcduint_t w)
+{
+    ssd1306_clearBlock8(x, y, w, s_fixedFont.h.height);
+}
+
+static void drawChar16(lcdint_t x, lcdint_t y, const char *ch, const SCharInfo *info)
+{
+    ssd1306_printFixed16(x, y, ch, STYLE_NORMAL);
+    ssd1306_clearBlock16(x + info->width, y, info->spacing, s_fixedFont.h.height);
+    if ( info->height < s_fixedFont.h.height )
+    {
+        ssd1306_clearBlock16(x, y + info->height, info->width, s_fixedFont.h.height - info->height);
+    }
+}
+
+static void clearArea16(lcdint_t x, lcdint_t y, lcduint_t w)
+{
+    ssd1306_clearBlock16(x, y, w, s_fixedFont.h.height);
+}
+
+/*
+ * Walks old and new strings together. Chars are redrawn if they differ or if their
+ * positions differ, which happens after the first char of different width.
+ */
+static void updateTextField(STextField *field, const char *text,
+                            void (*draw)(lcdint_t x, lcdint_t y, const char *ch, const SCharInfo *info),
+                            void (*clear)(lcdint_t x, lcdint_t y, lcduint_t w))
+{
+    const char *old = field->text;
+    lcdint_t oldX = field->x;
+    lcdint_t x = field->x;
+    uint8_t oldIndex = 0;
+    uint8_t index = 0;
+    while ( text[index] )
+    {
+        uint8_t len;
+        uint16_t unicode = ssd1306_unicode16FromUtf8Str(&text[index], &len);
+        if ( index + len >= field->size )
+        {
+            break;
+        }
+        SCharInfo info;
+        ssd1306_getCharBitmap(unicode, &info);
+        uint8_t changed = (x != oldX) || !old[oldIndex];
+        if ( old[oldIndex] )
+        {
+            uint8_t oldLen;
+            uint16_t oldUnicode = ssd1306_unicode16FromUtf8Str(&old[oldIndex], &oldLen);
+            if ( oldUnicode != unicode )
+            {
+                SCharInfo oldInfo;
+                ssd1306_getCharBitmap(oldUnicode, &oldInfo);
+                oldX += oldInfo.width + oldInfo.spacing;
+                changed = 1;
+            }
+            else
+            {
+                oldX += info.width + info.spacing;
+            }
+            oldIndex += oldLen;
+        }
+        if ( changed )
+        {
+            char ch[5];
+            for (uint8_t i = 0; i < len; i++) ch[i] = text[index + i];
+            ch[len] = '\0';
+            draw(x, field->y, ch, &info);
+        }
+        x += info.width + info.spacing;
+        index += len;
+    }
+    if ( x < field->x + (lcdint_t)field->width )
+    {
+        clear(x, field->y, field->x + field->width - x);
+    }
+    field->width = x - field->x;
+    for (uint8_t i = 0; i < index; i++)
+    {
+        field->text[i] = text[i];
+    }
+    field->text[index] = '\0';
+}
+
+void ssd1306_updateTextField(STextField *field, const char *text)
+{
+    updateTextField(field, text, drawChar, clearArea);
+}
+
+void ssd1306_updateTextField8(STextField *field, const char *text)
+{
+    updateTextField(field, text, drawChar8, clearArea8);
+}
+
+void ssd1306_updateTextField16(STextField *field, const char *text)
+{
+    updateTextField(field, text, drawChar16, clearArea16);
+}
+
+char *ssd1306_formatNumber(char *buffer, int32_t value, uint8_t width, char fill)
+{
+    uint32_t number = value < 0 ? -(uint32_t)value : (uint32_t)value;
+    uint8_t pos = width;
+    buffer[width] = '\0';
+    do
+    {
+        buffer[--pos] = '0' + number % 10;
+        number /= 10;
+    } while ( number && pos );
+    if ( (value < 0) && pos )
+    {
+        /* Minus goes right before digits for spaces and before zeroes for zero fill */
+        if ( fill != ' ' )
+        {
+            while ( pos ) buffer[--pos] = fill;
+            buffer[0] = '-';
+            return buffer;
+        }
+        buffer[--pos] = '-';
+    }
+    while ( pos )
+    {
+        buffer[--pos] = fill;
+    }
+    return buffer;
+}
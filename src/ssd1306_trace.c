@@ -0,0 +1,276 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+
+#include "ssd1306_trace.h"
+#include "lcd/lcd_common.h"
+#include "intf/ssd1306_interface.h"
+
+#if defined(__linux__) && !defined(ARDUINO) && !defined(__KERNEL__)
+#include <stdio.h>
+#include <time.h>
+#endif
+
+static SSD1306TraceEntry s_trace[CONFIG_SSD1306_TRACE_SIZE];
+static uint16_t s_traceFirst = 0;
+static uint16_t s_traceCount = 0;
+static uint32_t s_traceBegin[SSD1306_TRACE_MAX_ID];
+
+static void (*s_setBlock)(lcduint_t x, lcduint_t y, lcduint_t w) = 0;
+static void (*s_sendPixels1)(const uint8_t *buffer, uint16_t len) = 0;
+static void (*s_intfStart)(void) = 0;
+static void (*s_intfStop)(void) = 0;
+
+#if !defined(__AVR__) && !defined(__XTENSA__) && !defined(__ARM_ARCH_7M__) && !defined(__ARM_ARCH_7EM__)
+uint32_t ssd1306_traceCycles(void)
+{
+#if defined(__linux__) && !defined(ARDUINO) && !defined(__KERNEL__)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)ts.tv_sec * 1000000000UL + ts.tv_nsec;
+#else
+    return micros();
+#endif
+}
+#endif
+
+void ssd1306_traceStart(void)
+{
+#if defined(__AVR__)
+    /* Run TIMER1 from cpu clock, if nobody else uses it */
+    if ( !(TCCR1B & 0x07) )
+    {
+        TCCR1A = 0;
+        TCCR1B = (1<<CS10);
+    }
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+    /* DEMCR.TRCENA enables DWT, DWT_CTRL.CYCCNTENA starts cycle counter */
+    *(volatile uint32_t *)0xE000EDFC |= (1UL << 24);
+    *(volatile uint32_t *)0xE0001000 |= 1;
+#endif
+    s_traceFirst = 0;
+    s_traceCount = 0;
+}
+
+void ssd1306_traceBegin(uint8_t id)
+{
+    s_traceBegin[id] = ssd1306_traceCycles();
+}
+
+void ssd1306_traceEnd(uint8_t id)
+{
+    uint32_t cycles = ssd1306_traceCycles() - s_traceBegin[id];
+#if defined(__AVR__)
+    /* TCNT1 is 16-bit counter */
+    cycles = (uint16_t)cycles;
+#endif
+    uint16_t index = s_traceFirst + s_traceCount;
+    if ( index >= CONFIG_SSD1306_TRACE_SIZE )
+    {
+        index -= CONFIG_SSD1306_TRACE_SIZE;
+    }
+    if ( s_traceCount < CONFIG_SSD1306_TRACE_SIZE )
+    {
+        s_traceCount++;
+    }
+    else if ( ++s_traceFirst >= CONFIG_SSD1306_TRACE_SIZE )
+    {
+        s_traceFirst = 0;
+    }
+    s_trace[index].start = s_traceBegin[id];
+    s_trace[index].cycles = cycles;
+    s_trace[index].id = id;
+}
+
+static void traceSetBlock(lcduint_t x, lcduint_t y, lcduint_t w)
+{
+    ssd1306_traceBegin(SSD1306_TRACE_SET_BLOCK);
+    s_setBlock(x, y, w);
+    ssd1306_traceEnd(SSD1306_TRACE_SET_BLOCK);
+}
+
+static void traceSendPixels1(const uint8_t *buffer, uint16_t len)
+{
+    ssd1306_traceBegin(SSD1306_TRACE_SEND_PIXELS1);
+    s_sendPixels1(buffer, len);
+    ssd1306_traceEnd(SSD1306_TRACE_SEND_PIXELS1);
+}
+
+void ssd1306_traceLcd(void)
+{
+    if ( ssd1306_lcd.set_block != traceSetBlock )
+    {
+        s_setBlock = ssd1306_lcd.set_block;
+        ssd1306_lcd.set_block = traceSetBlock;
+    }
+    if ( ssd1306_lcd.send_pixels_buffer1 != traceSendPixels1 )
+    {
+        s_sendPixels1 = ssd1306_lcd.send_pixels_buffer1;
+        ssd1306_lcd.send_pixels_buffer1 = traceSendPixels1;
+    }
+}
+
+static void traceIntfStart(void)
+{
+    ssd1306_traceBegin(SSD1306_TRACE_BUS);
+    s_intfStart();
+}
+
+static void traceIntfStop(void)
+{
+    s_intfStop();
+    ssd1306_traceEnd(SSD1306_TRACE_BUS);
+}
+
+void ssd1306_traceIntf(void)
+{
+    if ( ssd1306_intf.start != traceIntfStart )
+    {
+        s_intfStart = ssd1306_intf.start;
+        ssd1306_intf.start = traceIntfStart;
+    }
+    if ( ssd1306_intf.stop != traceIntfStop )
+    {
+        s_intfStop = ssd1306_intf.stop;
+        ssd1306_intf.stop = traceIntfStop;
+    }
+}
+
+const SSD1306TraceEntry *ssd1306_traceRing(uint16_t *first, uint16_t *count)
+{
+    *first = s_traceFirst;
+    *count = s_traceCount;
+    return s_trace;
+}
+
+/* utoa() takes unsigned int, which is 16-bit on AVR */
+static char *traceNumber(uint32_t value, char *buf)
+{
+    char *p = &buf[11];
+    *p = '\0';
+    do
+    {
+        *--p = '0' + (value % 10);
+        value /= 10;
+    } while ( value );
+    return p;
+}
+
+static const char *traceName(uint8_t id, char *buf)
+{
+    switch ( id )
+    {
+        case SSD1306_TRACE_SET_BLOCK: return "set_block";
+        case SSD1306_TRACE_SEND_PIXELS1: return "send_pixels1";
+        case SSD1306_TRACE_CANVAS_BLT: return "canvas_blt";
+        case SSD1306_TRACE_ENGINE_DRAW: return "engine_draw";
+        case SSD1306_TRACE_TILE: return "tile";
+        case SSD1306_TRACE_BUS: return "bus";
+        default: break;
+    }
+    char *p = traceNumber(id, buf);
+    *--p = 'u';
+    return p;
+}
+
+void ssd1306_traceDump(void (*print)(void *arg, const char *str), void *arg)
+{
+    char buf[12];
+    uint16_t index = s_traceFirst;
+    while ( s_traceCount )
+    {
+        const SSD1306TraceEntry *entry = &s_trace[index];
+        print(arg, traceName(entry->id, buf));
+        print(arg, " ");
+        print(arg, traceNumber(entry->start, buf));
+        print(arg, " ");
+        print(arg, traceNumber(entry->cycles, buf));
+        print(arg, "\n");
+        if ( ++index >= CONFIG_SSD1306_TRACE_SIZE )
+        {
+            index = 0;
+        }
+        s_traceCount--;
+    }
+    s_traceFirst = 0;
+}
+
+#if defined(__linux__) && !defined(ARDUINO) && !defined(__KERNEL__)
+int ssd1306_traceSaveChrome(const char *filename)
+{
+    char buf[12];
+    FILE *f = fopen(filename, "w");
+    if ( !f )
+    {
+        return -1;
+    }
+    /* Linux cycle counter is in nanoseconds, trace viewers expect microseconds */
+    /* Entries are ordered by end time, so outer spans start before the first entry */
+    uint32_t base = s_trace[s_traceFirst].start;
+    uint32_t last = 0;
+    uint16_t index = s_traceFirst;
+    for ( uint16_t n = 0; n < s_traceCount; n++ )
+    {
+        if ( (int32_t)(s_trace[index].start - base) < 0 )
+        {
+            base = s_trace[index].start;
+        }
+        if ( ++index >= CONFIG_SSD1306_TRACE_SIZE )
+        {
+            index = 0;
+        }
+    }
+    index = s_traceFirst;
+    fprintf(f, "{\"traceEvents\":[\n");
+    for ( uint16_t n = 0; n < s_traceCount; n++ )
+    {
+        const SSD1306TraceEntry *entry = &s_trace[index];
+        uint32_t ts = entry->start - base;
+        fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                   "\"ts\":%u.%03u,\"dur\":%u.%03u}",
+                n ? ",\n" : "", traceName(entry->id, buf),
+                ts / 1000, ts % 1000, entry->cycles / 1000, entry->cycles % 1000);
+        if ( ts + entry->cycles > last )
+        {
+            last = ts + entry->cycles;
+        }
+        if ( ++index >= CONFIG_SSD1306_TRACE_SIZE )
+        {
+            index = 0;
+        }
+    }
+#ifdef CONFIG_SSD1306_INTF_STATS_ENABLE
+    ssd1306_intf_stats_t stats;
+    ssd1306_intfStatsGet(&stats);
+    fprintf(f, "%s{\"name\":\"intf\",\"ph\":\"C\",\"pid\":1,\"ts\":%u.%03u,\"args\":{"
+               "\"transactions\":%u,\"command_bytes\":%u,\"data_bytes\":%u,\"bus_time_us\":%u}}",
+            s_traceCount ? ",\n" : "", last / 1000, last % 1000,
+            stats.transactions, stats.command_bytes, stats.data_bytes, stats.bus_time_us);
+#endif
+    fprintf(f, "\n]}\n");
+    s_traceFirst = 0;
+    s_traceCount = 0;
+    return fclose(f) ? -1 : 0;
+}
+#endif
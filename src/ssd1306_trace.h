@@ -0,0 +1,223 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/**
+ * @file ssd1306_trace.h Cycle-accurate tracepoints for driver and engine hot paths
+ */
+
+#ifndef _SSD1306_TRACE_H_
+#define _SSD1306_TRACE_H_
+
+#include "ssd1306_hal/io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup LCD_TRACE_API TRACE: Cycle counter tracepoints
+ * @{
+ *
+ * @brief Measures duration of library hot paths in cpu cycles
+ *
+ * @details Tracepoints are compiled only if CONFIG_SSD1306_TRACE_ENABLE is defined,
+ *          otherwise SSD1306_TRACE_BEGIN() / SSD1306_TRACE_END() expand to nothing.
+ *          Each completed tracepoint puts its id, start timestamp and duration to the
+ *          ring of CONFIG_SSD1306_TRACE_SIZE entries in RAM, oldest entries are
+ *          overwritten. The ring can be printed with ssd1306_traceDump(), for example,
+ *          to serial port. Durations are measured with native cycle counter:
+ *          DWT CYCCNT on Cortex-M3/M4 (STM32), CCOUNT on ESP32, TCNT1 on AVR (16-bit,
+ *          in TIMER1 ticks), clock_gettime() on Linux (nanoseconds), and micros() on
+ *          other platforms.
+ *
+ *          Library has tracepoints around NanoEngine draw callback and canvas blt()
+ *          functions. set_block() and send_pixels_buffer1() of the display driver are
+ *          traced after ssd1306_traceLcd() call, bus transactions after ssd1306_traceIntf().
+ *          Application can use own ids, starting with SSD1306_TRACE_USER.
+ *          On Linux (including SDL emulation) the ring can be saved in Chrome trace event
+ *          format with ssd1306_traceSaveChrome() and opened in chrome://tracing or
+ *          Perfetto UI: nested tracepoints are shown as nested spans.
+ */
+
+#ifndef CONFIG_SSD1306_TRACE_SIZE
+#if defined(__AVR__)
+/** Number of entries in the trace ring */
+#define CONFIG_SSD1306_TRACE_SIZE  16
+#elif defined(__linux__) && !defined(ARDUINO) && !defined(__KERNEL__)
+#define CONFIG_SSD1306_TRACE_SIZE  4096
+#else
+#define CONFIG_SSD1306_TRACE_SIZE  256
+#endif
+#endif
+
+/** Tracepoint ids of the library */
+enum
+{
+    SSD1306_TRACE_SET_BLOCK = 0,     ///< ssd1306_lcd.set_block()
+    SSD1306_TRACE_SEND_PIXELS1 = 1,  ///< ssd1306_lcd.send_pixels_buffer1()
+    SSD1306_TRACE_CANVAS_BLT = 2,    ///< canvas blt() functions
+    SSD1306_TRACE_ENGINE_DRAW = 3,   ///< NanoEngine draw callback
+    SSD1306_TRACE_TILE = 4,          ///< NanoEngine tile: draw callback and blt
+    SSD1306_TRACE_BUS = 5,           ///< interface transaction: start() to stop()
+    SSD1306_TRACE_USER = 8,          ///< first id, available for application
+    SSD1306_TRACE_MAX_ID = 16,       ///< number of supported ids
+};
+
+/**
+ * Single trace ring entry
+ */
+typedef struct
+{
+    uint32_t start;   ///< cycle counter value at the tracepoint start
+    uint32_t cycles;  ///< duration in cycle counter ticks
+    uint8_t id;       ///< tracepoint id
+} SSD1306TraceEntry;
+
+#if defined(__AVR__)
+static inline uint32_t ssd1306_traceCycles(void) { return TCNT1; }
+#elif defined(__XTENSA__)
+static inline uint32_t ssd1306_traceCycles(void)
+{
+    uint32_t ccount;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+    return ccount;
+}
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+static inline uint32_t ssd1306_traceCycles(void) { return *(volatile uint32_t *)0xE0001004; }
+#else
+/**
+ * Returns current value of native cycle counter
+ */
+uint32_t ssd1306_traceCycles(void);
+#endif
+
+/**
+ * Clears the trace ring and starts cycle counter if it is not running
+ * (TIMER1 without prescaler on AVR, DWT on Cortex-M).
+ */
+void ssd1306_traceStart(void);
+
+/**
+ * Marks start of the tracepoint, use SSD1306_TRACE_BEGIN() instead.
+ * @param id tracepoint id, less than SSD1306_TRACE_MAX_ID
+ */
+void ssd1306_traceBegin(uint8_t id);
+
+/**
+ * Puts completed tracepoint to the ring, use SSD1306_TRACE_END() instead.
+ * @param id tracepoint id, less than SSD1306_TRACE_MAX_ID
+ */
+void ssd1306_traceEnd(uint8_t id);
+
+/**
+ * Replaces set_block() and send_pixels_buffer1() of current display driver with
+ * traced versions. Must be called after display initialization.
+ */
+void ssd1306_traceLcd(void);
+
+/**
+ * Replaces start() and stop() of current interface with traced versions, so each
+ * transaction is recorded with SSD1306_TRACE_BUS id. Must be called after interface
+ * initialization and before display initialization.
+ */
+void ssd1306_traceIntf(void);
+
+/**
+ * Returns number of entries in the trace ring and pointer to the oldest one.
+ * Entries are stored continuously starting with *first, wrapping at the end
+ * of the ring of CONFIG_SSD1306_TRACE_SIZE entries.
+ * @param first pointer to store index of the oldest entry to
+ * @param count pointer to store number of entries to
+ * @return pointer to the ring
+ */
+const SSD1306TraceEntry *ssd1306_traceRing(uint16_t *first, uint16_t *count);
+
+/**
+ * Prints trace ring as text lines "name start cycles", starting with the oldest entry,
+ * and clears the ring.
+ * @param print function to print zero-terminated string
+ * @param arg argument to pass to print function
+ */
+void ssd1306_traceDump(void (*print)(void *arg, const char *str), void *arg);
+
+#if defined(__linux__) && !defined(ARDUINO) && !defined(__KERNEL__)
+/**
+ * Saves trace ring as Chrome trace event JSON, and clears the ring.
+ * Tracepoints become complete ("X") events with microsecond timestamps, relative to
+ * the oldest entry. If CONFIG_SSD1306_INTF_STATS_ENABLE is defined, interface
+ * statistics are added as counter ("C") event at the end of the trace.
+ * @param filename name of the file to create
+ * @return 0 on success, -1 if file cannot be written
+ */
+int ssd1306_traceSaveChrome(const char *filename);
+#endif
+
+#ifdef CONFIG_SSD1306_TRACE_ENABLE
+/** Starts tracepoint with specified id */
+#define SSD1306_TRACE_BEGIN(id)  ssd1306_traceBegin(id)
+/** Completes tracepoint with specified id */
+#define SSD1306_TRACE_END(id)    ssd1306_traceEnd(id)
+#else
+#define SSD1306_TRACE_BEGIN(id)
+#define SSD1306_TRACE_END(id)
+#endif
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+
+#ifdef CONFIG_SSD1306_TRACE_ENABLE
+/** Tracepoint, completed at the end of the scope */
+class SSD1306TraceScope
+{
+public:
+    explicit SSD1306TraceScope(uint8_t id): m_id(id) { ssd1306_traceBegin(id); }
+    ~SSD1306TraceScope() { ssd1306_traceEnd(m_id); }
+private:
+    uint8_t m_id;
+};
+/** Traces the rest of the current scope with specified id */
+#define SSD1306_TRACE_SCOPE(id)  SSD1306TraceScope ssd1306_trace_scope_(id)
+#else
+#define SSD1306_TRACE_SCOPE(id)
+#endif
+
+#if defined(ARDUINO)
+/**
+ * @ingroup LCD_TRACE_API
+ * Print function for ssd1306_traceDump() to print trace to Arduino Print object: Serial, etc.
+ * @param out pointer to Print object
+ */
+static inline void ssd1306_tracePrintArduino(void *out, const char *str)
+{
+    static_cast<Print *>(out)->print(str);
+}
+#endif
+
+#endif
+
+#endif // _SSD1306_TRACE_H_
@@ -30,8 +30,12 @@
 #if defined(CONFIG_AVR_UART_AVAILABLE) && defined(CONFIG_AVR_UART_ENABLE)
 
 volatile uint8_t g_uart_put_ptr = 0;
+volatile uint8_t g_uart_get_ptr = 0;
 volatile uint8_t g_uart_buf[UART_BUFFER_RX];
-static uint8_t s_uart_get_ptr = 0;
+volatile uint8_t g_uart_tx_put_ptr = 0;
+volatile uint8_t g_uart_tx_get_ptr = 0;
+volatile uint8_t g_uart_tx_buf[UART_BUFFER_TX];
+volatile uint8_t g_uart_overruns = 0;
 static uint8_t s_uart_interrupt = 0;
 
 #undef BAUD
@@ -108,6 +112,14 @@ void uart_init_internal(uint32_t baud, uint8_t interrupt)
             if (u2x0_115200) UCSR0A |= _BV(U2X0); else UCSR0A &= ~(_BV(U2X0));
             break;
         default:
+            if (baud)
+            {
+                /* Double speed mode gives the best accuracy for Mbaud rates */
+                uint16_t ubrr = (F_CPU / 8 + baud / 2) / baud - 1;
+                UBRR0H = ubrr >> 8;
+                UBRR0L = ubrr & 0xFF;
+                UCSR0A |= _BV(U2X0);
+            }
             break;
     }
     UCSR0C = _BV(UCSZ01) | _BV(UCSZ00); /* 8-bit data */
@@ -116,10 +128,33 @@ void uart_init_internal(uint32_t baud, uint8_t interrupt)
 
 void uart_send_byte(uint8_t c)
 {
+    if (s_uart_interrupt)
+    {
+        uint8_t next = (g_uart_tx_put_ptr + 1) & (UART_BUFFER_TX - 1);
+        while (next == g_uart_tx_get_ptr); /* Wait until USART_UDRE ISR frees space */
+        g_uart_tx_buf[g_uart_tx_put_ptr] = c;
+        g_uart_tx_put_ptr = next;
+        UCSR0B |= _BV(UDRIE0);
+        return;
+    }
     loop_until_bit_is_set(UCSR0A, UDRE0); /* Wait until data register empty. */
     UDR0 = c;
 }
 
+void uart_send_buffer(const uint8_t *buffer, uint16_t len)
+{
+    while (len--)
+    {
+        uart_send_byte(*buffer++);
+    }
+}
+
+void uart_flush(void)
+{
+    while (g_uart_tx_put_ptr != g_uart_tx_get_ptr);
+    loop_until_bit_is_set(UCSR0A, UDRE0);
+}
+
 static inline uint8_t uart_byte_available_direct(void)
 {
     return bit_is_set(UCSR0A, RXC0);
@@ -131,13 +166,13 @@ uint8_t uart_byte_available(void)
     {
         while (uart_byte_available_direct()) __uart_read_byte();
     }
-    return g_uart_put_ptr != s_uart_get_ptr;
+    return g_uart_put_ptr != g_uart_get_ptr;
 }
 
 uint8_t uart_read_byte(void)
 {
-    uint8_t data = g_uart_buf[s_uart_get_ptr];
-    s_uart_get_ptr = (s_uart_get_ptr + 1) & (UART_BUFFER_RX - 1);
+    uint8_t data = g_uart_buf[g_uart_get_ptr];
+    g_uart_get_ptr = (g_uart_get_ptr + 1) & (UART_BUFFER_RX - 1);
     return data;
 }
 
@@ -45,13 +45,24 @@ extern "C" {
 
 #include <stdint.h>
 
-/** Rx buffer size, used by AVR USART implementation */
+#ifndef UART_BUFFER_RX
+/** Rx buffer size, used by AVR USART implementation, should be power of 2 */
 #define UART_BUFFER_RX  32  // :( Still need large buffer to process USART RX bytes
+#endif
+
+#ifndef UART_BUFFER_TX
+/** Tx buffer size, used by AVR USART implementation in interrupt mode, should be power of 2 */
+#define UART_BUFFER_TX  32
+#endif
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 extern volatile uint8_t g_uart_put_ptr;
-
+extern volatile uint8_t g_uart_get_ptr;
 extern volatile uint8_t g_uart_buf[];
+extern volatile uint8_t g_uart_tx_put_ptr;
+extern volatile uint8_t g_uart_tx_get_ptr;
+extern volatile uint8_t g_uart_tx_buf[];
+extern volatile uint8_t g_uart_overruns;
 
 void uart_init_internal(uint32_t baud, uint8_t interrupt);
 #endif
@@ -62,8 +73,14 @@ void uart_init_internal(uint32_t baud, uint8_t interrupt);
  * Initializes uart module. Depending on UART_INTERRUPT_ENABLE define,
  * module will be initialized in interrupt mode or synchronouse mode.
  *
+ * In interrupt mode received bytes are put to RX ring buffer by USART_RX ISR,
+ * and uart_send_byte() puts bytes to TX ring buffer, which is drained by
+ * USART_UDRE ISR, so the CPU doesn't spin on UDR0 while the data are sent.
+ *
  * @param baud baud rate for the uart module
- * @note only 115200, 57600, 38400 and 19200 are supported.
+ * @note 115200, 57600, 38400 and 19200 use precalculated settings, other baud
+ *       rates (up to F_CPU / 8, that is 2000000 for 16 MHz) are calculated in
+ *       double speed mode.
  */
 static inline void uart_init(uint32_t baud)
 {
@@ -77,13 +94,27 @@ static inline void uart_init(uint32_t baud)
 /**
  * @brief Sends single byte over UART
  *
- * Sends single byte over UART. The function doesn't use any
- * internal buffers, so it returns control once byte is sent.
+ * Sends single byte over UART. In synchronous mode the function doesn't use
+ * any internal buffers, so it returns control once byte is sent. In interrupt
+ * mode the byte is put to TX buffer, and the function waits only if the buffer is full.
  *
  * @param c byte to send.
  */
 void uart_send_byte(uint8_t c);
 
+/**
+ * @brief Sends bytes over UART
+ *
+ * @param buffer bytes to send
+ * @param len number of bytes to send
+ */
+void uart_send_buffer(const uint8_t *buffer, uint16_t len);
+
+/**
+ * @brief Waits until all bytes from TX buffer are sent.
+ */
+void uart_flush(void);
+
 /**
  * @brief Returns non-zero code if there are bytes in RX buffer
  *
@@ -102,8 +133,16 @@ uint8_t uart_read_byte(void);
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 static inline void __uart_read_byte(void)
 {
-    g_uart_buf[g_uart_put_ptr] = UDR0;
-    g_uart_put_ptr = (g_uart_put_ptr+1) & (UART_BUFFER_RX - 1);
+    uint8_t data = UDR0;
+    uint8_t next = (g_uart_put_ptr+1) & (UART_BUFFER_RX - 1);
+    /* Bytes are dropped if RX buffer is full, otherwise whole buffer is lost */
+    if (next == g_uart_get_ptr)
+    {
+        g_uart_overruns++;
+        return;
+    }
+    g_uart_buf[g_uart_put_ptr] = data;
+    g_uart_put_ptr = next;
 }
 
 
@@ -120,6 +159,17 @@ ISR(USART_RX_vect, ISR_BLOCK)
         volatile unsigned char data __attribute__((unused)) = UDR0;
     }
 }
+
+ISR(USART_UDRE_vect, ISR_BLOCK)
+{
+    if (g_uart_tx_get_ptr == g_uart_tx_put_ptr)
+    {
+        UCSR0B &= ~_BV(UDRIE0);
+        return;
+    }
+    UDR0 = g_uart_tx_buf[g_uart_tx_get_ptr];
+    g_uart_tx_get_ptr = (g_uart_tx_get_ptr + 1) & (UART_BUFFER_TX - 1);
+}
 #endif
 
 #endif // DOXYGEN_SHOULD_SKIP_THIS
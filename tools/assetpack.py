@@ -0,0 +1,147 @@
+#    MIT License
+#
+#    Copyright (c) 2019, Alexey Dynda
+#
+#    Permission is hereby granted, free of charge, to any person obtaining a copy
+#    of this software and associated documentation files (the "Software"), to deal
+#    in the Software without restriction, including without limitation the rights
+#    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#    copies of the Software, and to permit persons to whom the Software is
+#    furnished to do so, subject to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be included in all
+#    copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#    SOFTWARE.
+#
+###################################################################################
+# Packs fonts, bitmaps and sprite sheets to single asset pack (see format.txt),
+# which can be mapped to memory and read by ssd1306_assetPackOpen(),
+# ssd1306_assetPackMapFile() and ssd1306_assetPackMapPartition().
+# Manifest file has one asset per line:
+#    <name> <type> <file>[:<array>] [<width> <height>] [compress]
+# type is one of: raw, font, bitmap1, bitmap8, bitmap16, sheet
+# file is C source with PROGMEM array (array name selects one of several arrays)
+# or any other file, which is packed as is.
+# compress keyword compresses bitmap1/bitmap16 data as bitmapcompress.py does.
+#
+
+import struct
+import sys
+
+import bitmapcompress
+from modules import carray
+
+TYPES = { "raw": 0, "font": 1, "bitmap1": 2, "bitmap8": 3, "bitmap16": 4, "sheet": 5 }
+FLAG_COMPRESSED = 0x01
+NAME_LEN = 16
+HEADER_SIZE = 16
+ENTRY_SIZE = 32
+VERSION = 1
+
+def print_help_and_exit():
+    print("Usage: assetpack.py [args] manifestFile")
+    print("args:")
+    print("      -o <F>    output binary pack to file F")
+    print("      -c        output pack as C array to stdout")
+    print("      -n <S>    name of output C array (default: assetPack)")
+    print("Examples:")
+    print("   [create pack to flash to ESP32 data partition]")
+    print("      assetpack.py -o assets.bin assets.txt")
+    print("      parttool.py write_partition --partition-name=assets --input=assets.bin")
+    print("   [create pack to compile into the sketch]")
+    print("      assetpack.py -c -n gameAssets assets.txt > assets.h")
+    exit(1)
+
+def read_asset(spec):
+    name, _, array = spec.partition(':')
+    if name.endswith(('.c', '.h', '.cpp', '.ino')):
+        return carray.read_array(name, array or None)
+    with open(name, 'rb') as f:
+        return list(bytearray(f.read()))
+
+def parse_manifest(name):
+    assets = []
+    with open(name) as f:
+        for line_no, line in enumerate(f, 1):
+            fields = line.split('#')[0].split()
+            if not fields:
+                continue
+            flags = 0
+            if fields[-1] == "compress":
+                flags |= FLAG_COMPRESSED
+                fields.pop()
+            if len(fields) not in (3, 5) or fields[1] not in TYPES or len(fields[0]) > NAME_LEN:
+                sys.stderr.write("%s:%d: invalid asset description\n" % (name, line_no))
+                exit(1)
+            width, height = (int(fields[3], 0), int(fields[4], 0)) if len(fields) == 5 else (0, 0)
+            data = read_asset(fields[2])
+            if flags & FLAG_COMPRESSED:
+                unit_size = { "bitmap1": 1, "bitmap16": 2 }.get(fields[1])
+                if unit_size is None or len(data) % unit_size:
+                    sys.stderr.write("%s:%d: only bitmap1 and bitmap16 can be compressed\n" % (name, line_no))
+                    exit(1)
+                data = bitmapcompress.compress([tuple(data[n:n + unit_size])
+                                                for n in range(0, len(data), unit_size)])
+            assets.append((fields[0], TYPES[fields[1]], flags, width, height, data))
+    return assets
+
+def build_pack(assets):
+    # Data are 4-byte aligned, so 16-bit bitmaps can be read from mapped flash
+    data_start = HEADER_SIZE + ENTRY_SIZE * len(assets)
+    offset = data_start
+    index = b''
+    blob = b''
+    for name, kind, flags, width, height, data in assets:
+        offset = (offset + 3) & ~3
+        index += struct.pack('<16sBBHHHII', name.encode(), kind, flags, width, height, 0,
+                             offset, len(data))
+        blob += b'\0' * (offset - data_start - len(blob))
+        blob += bytes(bytearray(data))
+        offset += len(data)
+    return struct.pack('<4sBBH8x', b'SAPK', VERSION, 0, len(assets)) + index + blob
+
+def main():
+    output = None
+    c_array = False
+    name = "assetPack"
+    manifest = None
+    i = 1
+    while i < len(sys.argv):
+        if sys.argv[i] == "-o":
+            i += 1
+            output = sys.argv[i]
+        elif sys.argv[i] == "-c":
+            c_array = True
+        elif sys.argv[i] == "-n":
+            i += 1
+            name = sys.argv[i]
+        elif sys.argv[i].startswith("-"):
+            print_help_and_exit()
+        else:
+            manifest = sys.argv[i]
+        i += 1
+
+    if manifest is None or (output is None and not c_array):
+        print_help_and_exit()
+
+    pack = bytearray(build_pack(parse_manifest(manifest)))
+    if output is not None:
+        with open(output, 'wb') as f:
+            f.write(pack)
+    if c_array:
+        print("// Asset pack, %d bytes" % len(pack))
+        print("const PROGMEM uint8_t %s[] =" % name)
+        print("{")
+        for n in range(0, len(pack), 16):
+            print("    " + ", ".join("0x%02X" % v for v in pack[n:n + 16]) + ",")
+        print("};")
+
+if __name__ == "__main__":
+    main()
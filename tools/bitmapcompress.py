@@ -0,0 +1,111 @@
+#    MIT License
+#
+#    Copyright (c) 2018, Alexey Dynda
+#
+#    Permission is hereby granted, free of charge, to any person obtaining a copy
+#    of this software and associated documentation files (the "Software"), to deal
+#    in the Software without restriction, including without limitation the rights
+#    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#    copies of the Software, and to permit persons to whom the Software is
+#    furnished to do so, subject to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be included in all
+#    copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#    SOFTWARE.
+#
+###################################################################################
+# Converts bitmap C array to ssd1306 compressed bitmap format (see format.txt).
+# Output can be drawn with ssd1306_drawCompressedBitmap() and
+# ssd1306_drawCompressedBitmap16().
+#
+
+import sys
+
+from modules import carray
+
+MAX_PACKET = 128
+
+def print_help_and_exit():
+    print("Usage: bitmapcompress.py [args] inputFile > outputFile")
+    print("args:")
+    print("      -16       input is RGB565 bitmap (2 bytes per pixel, MSB first)")
+    print("      -n <S>    name of output array (default: compressedBitmap)")
+    print("Input file should contain C array of bitmap bytes, for example output of LCDAssistant")
+    print("Examples:")
+    print("   [compress monochrome bitmap in ssd1306 format]")
+    print("      bitmapcompress.py -n logo logo.c > logo_compressed.h")
+    exit(1)
+
+def compress(units):
+    out = []
+    literal = []
+    def flush():
+        while literal:
+            chunk = literal[:MAX_PACKET]
+            del literal[:MAX_PACKET]
+            out.append(len(chunk) - 1)
+            for unit in chunk:
+                out.extend(unit)
+    i = 0
+    while i < len(units):
+        run = 1
+        while i + run < len(units) and units[i + run] == units[i] and run < MAX_PACKET:
+            run += 1
+        # Short runs inside literal packet take more space than literal data itself
+        if run >= 3 or (run == 2 and not literal):
+            flush()
+            out.append(0x80 | (run - 1))
+            out.extend(units[i])
+            i += run
+        else:
+            literal.append(units[i])
+            i += 1
+    flush()
+    return out
+
+def main():
+    if len(sys.argv) < 2:
+        print_help_and_exit()
+
+    unit_size = 1
+    name = "compressedBitmap"
+    source = None
+    i = 1
+    while i < len(sys.argv):
+        if sys.argv[i] == "-16":
+            unit_size = 2
+        elif sys.argv[i] == "-n":
+            i += 1
+            name = sys.argv[i]
+        elif sys.argv[i].startswith("-"):
+            print_help_and_exit()
+        else:
+            source = sys.argv[i]
+        i += 1
+
+    if source is None:
+        print_help_and_exit()
+
+    data = carray.read_array(source)
+    if len(data) % unit_size:
+        sys.stderr.write("Input size is not multiple of %d bytes\n" % unit_size)
+        exit(1)
+    units = [tuple(data[n:n + unit_size]) for n in range(0, len(data), unit_size)]
+    packed = compress(units)
+
+    print("// Compressed from %d to %d bytes" % (len(data), len(packed)))
+    print("const PROGMEM uint8_t %s[] =" % name)
+    print("{")
+    for n in range(0, len(packed), 16):
+        print("    " + ", ".join("0x%02X" % v for v in packed[n:n + 16]) + ",")
+    print("};")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,229 @@
+#    MIT License
+#
+#    Copyright (c) 2019, Alexey Dynda
+#
+#    Permission is hereby granted, free of charge, to any person obtaining a copy
+#    of this software and associated documentation files (the "Software"), to deal
+#    in the Software without restriction, including without limitation the rights
+#    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#    copies of the Software, and to permit persons to whom the Software is
+#    furnished to do so, subject to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be included in all
+#    copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#    SOFTWARE.
+#
+###################################################################################
+# Converts RGB image to ssd1306 library bitmap formats using 4x4 ordered
+# (Bayer) dithering. The result is the same as produced at runtime by
+# NanoCanvasOps::drawBitmap16() for bitmap placed at coordinates multiple of 4.
+#
+
+import sys
+
+from modules import carray
+
+BAYER4X4 = [
+    [  0,  8,  2, 10 ],
+    [ 12,  4, 14,  6 ],
+    [  3, 11,  1,  9 ],
+    [ 15,  7, 13,  5 ],
+]
+
+def print_help_and_exit():
+    print("Usage: bitmapdither.py [args] inputFile > outputFile")
+    print("args:")
+    print("      -f <F>    output format: mono, gray4, rgb8, rgb16 (default: mono)")
+    print("      -w <N>    width of input C array bitmap (RGB565, 2 bytes per pixel, MSB first)")
+    print("      -n <S>    name of output array (default: ditheredBitmap)")
+    print("      -t <C>    transparent RGB565 color, for example 0xF81F. mono format gets")
+    print("                <name>Mask array for drawMaskedBitmap1(), rgb8 and rgb16 formats")
+    print("                get <name>Key constant for drawKeyedBitmap8()/drawKeyedBitmap16()")
+    print("Input file is binary PPM (P6) image or C array of RGB565 bitmap bytes")
+    print("Examples:")
+    print("   [convert photo to monochrome bitmap in ssd1306 format]")
+    print("      bitmapdither.py -n photo photo.ppm > photo.h")
+    print("   [convert RGB565 bitmap to RGB8 format for 8-bit displays]")
+    print("      bitmapdither.py -f rgb8 -w 32 -n sprite sprite.c > sprite8.h")
+    exit(1)
+
+def read_ppm(name):
+    with open(name, 'rb') as f:
+        data = f.read()
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            while data[pos:pos + 1] not in (b'\n', b''):
+                pos += 1
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    if fields[0] != b'P6' or int(fields[3]) != 255:
+        sys.stderr.write("Only 8-bit binary PPM (P6) images are supported\n")
+        exit(1)
+    width = int(fields[1])
+    height = int(fields[2])
+    pixels = data[pos + 1:]
+    # Keep only RGB565 precision, so offline and runtime conversions are the same
+    colors = []
+    for n in range(width * height):
+        r, g, b = pixels[n * 3], pixels[n * 3 + 1], pixels[n * 3 + 2]
+        colors.append(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3))
+    return width, height, colors
+
+def rgb16_to_rgb888(c):
+    r = ((c >> 8) & 0xF8) | (c >> 13)
+    g = ((c >> 3) & 0xFC) | ((c >> 9) & 0x03)
+    b = ((c << 3) & 0xF8) | ((c >> 2) & 0x07)
+    return r, g, b
+
+def luma(r, g, b):
+    return (r * 77 + g * 150 + b * 29) >> 8
+
+def dither_channel(value, bits, threshold):
+    v = value + ((threshold << (8 - bits)) >> 4)
+    return (0xFF >> (8 - bits)) if v > 0xFF else (v >> (8 - bits))
+
+def mono_mask(width, height, colors, key):
+    out = []
+    for page in range((height + 7) // 8):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < height and colors[y * width + x] != key:
+                    byte |= 1 << bit
+            out.append(byte)
+    return out
+
+def apply_key(width, height, colors, packed, fmt, key):
+    # Transparent pixels get key value, opaque pixels, equal to the key, are changed
+    # by the least significant bit, so they are not lost at runtime
+    size = 2 if fmt == "rgb16" else 1
+    r, g, b = rgb16_to_rgb888(key)
+    value = key if fmt == "rgb16" else (r & 0xE0) | ((g >> 3) & 0x1C) | (b >> 6)
+    for n in range(width * height):
+        if size == 2:
+            c = (packed[n * 2] << 8) | packed[n * 2 + 1]
+        else:
+            c = packed[n]
+        if colors[n] == key:
+            c = value
+        elif c == value:
+            c ^= 1
+        if size == 2:
+            packed[n * 2], packed[n * 2 + 1] = c >> 8, c & 0xFF
+        else:
+            packed[n] = c
+    return value
+
+def convert(width, height, colors, fmt):
+    out = []
+    if fmt == "mono":
+        for page in range((height + 7) // 8):
+            for x in range(width):
+                byte = 0
+                for bit in range(8):
+                    y = page * 8 + bit
+                    if y >= height:
+                        break
+                    threshold = BAYER4X4[y & 3][x & 3]
+                    if luma(*rgb16_to_rgb888(colors[y * width + x])) >= (threshold << 4) + 8:
+                        byte |= 1 << bit
+                out.append(byte)
+        return out
+    for y in range(height):
+        line = []
+        for x in range(width):
+            c = colors[y * width + x]
+            threshold = BAYER4X4[y & 3][x & 3]
+            r, g, b = rgb16_to_rgb888(c)
+            if fmt == "rgb16":
+                line.extend([c >> 8, c & 0xFF])
+            elif fmt == "rgb8":
+                line.append((dither_channel(r, 3, threshold) << 5) |
+                            (dither_channel(g, 3, threshold) << 2) |
+                            dither_channel(b, 2, threshold))
+            else:
+                line.append(dither_channel(luma(r, g, b), 4, threshold))
+        if fmt == "gray4":
+            # 2 pixels per byte, left pixel in low nibble as in NanoCanvas4
+            if len(line) & 1:
+                line.append(0)
+            line = [line[n] | (line[n + 1] << 4) for n in range(0, len(line), 2)]
+        out.extend(line)
+    return out
+
+if len(sys.argv) < 2:
+    print_help_and_exit()
+
+fmt = "mono"
+width = 0
+name = "ditheredBitmap"
+source = None
+key = None
+i = 1
+while i < len(sys.argv):
+    if sys.argv[i] == "-f":
+        i += 1
+        fmt = sys.argv[i]
+    elif sys.argv[i] == "-w":
+        i += 1
+        width = int(sys.argv[i])
+    elif sys.argv[i] == "-n":
+        i += 1
+        name = sys.argv[i]
+    elif sys.argv[i] == "-t":
+        i += 1
+        key = int(sys.argv[i], 0) & 0xFFFF
+    elif sys.argv[i].startswith("-"):
+        print_help_and_exit()
+    else:
+        source = sys.argv[i]
+    i += 1
+
+if source is None or fmt not in ("mono", "gray4", "rgb8", "rgb16"):
+    print_help_and_exit()
+if key is not None and fmt == "gray4":
+    sys.stderr.write("Transparent color is not supported for gray4 format\n")
+    exit(1)
+
+if source.lower().endswith(".ppm"):
+    width, height, colors = read_ppm(source)
+else:
+    data = carray.read_array(source)
+    if width <= 0 or len(data) % (width * 2):
+        sys.stderr.write("Specify valid width of RGB565 bitmap with -w\n")
+        exit(1)
+    colors = [(data[n] << 8) | data[n + 1] for n in range(0, len(data), 2)]
+    height = len(colors) // width
+
+def print_array(name, packed):
+    print("const PROGMEM uint8_t %s[] =" % name)
+    print("{")
+    for n in range(0, len(packed), 16):
+        print("    " + ", ".join("0x%02X" % v for v in packed[n:n + 16]) + ",")
+    print("};")
+
+packed = convert(width, height, colors, fmt)
+
+print("// %dx%d bitmap, %s format" % (width, height, fmt))
+if key is not None and fmt != "mono":
+    value = apply_key(width, height, colors, packed, fmt, key)
+    print("const %s %sKey = 0x%0*X;" % ("uint16_t" if fmt == "rgb16" else "uint8_t",
+                                       name, 4 if fmt == "rgb16" else 2, value))
+print_array(name, packed)
+if key is not None and fmt == "mono":
+    print_array(name + "Mask", mono_mask(width, height, colors, key))
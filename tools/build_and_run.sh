@@ -39,6 +39,8 @@ print_help_and_exit()
     echo "        -e      start OLED emulation mode with SDL (Linux only)"
     echo "                OLED emulation allows to run simple demo without OLED hardware"
     echo "                OLED emulation mode requires installed libsdl2-dev package"
+    echo "        -H      start OLED emulation mode without SDL window (Linux only)"
+    echo "                sdl_core_dump_frame() can be used to save display content"
     echo "add_build_opts: (additional options)"
     echo "        FREQUENCY=<num>  frequency in Hz, passed as -DF_CPU=<num> to gcc/g++"
     echo "        ADAFRUIT=y       add Adafruit GFX support to ssd1306 library"
@@ -54,13 +56,14 @@ print_help_and_exit()
     exit 1
 }
 
-while getopts "fep:m:" opt; do
+while getopts "fHep:m:" opt; do
   # echo $opt, $OPTARG
   case $opt in
     p) platform=$OPTARG;;
     m) mcu=$OPTARG;;
     f) flash_target=flash;;
     e) extra_args="$extra_args SDL_EMULATION=y";;
+    H) extra_args="$extra_args SDL_EMULATION=y SDL_HEADLESS=y";;
     \?)
       echo "Invalid option: -$OPTARG" >&2
       print_help_and_exit
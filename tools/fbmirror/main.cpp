@@ -0,0 +1,482 @@
+/*
+    MIT License
+
+    Copyright (c) 2018, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "ssd1306.h"
+#include "intf/ssd1306_interface.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/fb.h>
+
+enum
+{
+    FORMAT_MONO = 1,
+    FORMAT_RGB8 = 8,
+    FORMAT_RGB16 = 16,
+};
+
+/* Captured framebuffer: linux fbdev device or raw file with known geometry */
+typedef struct
+{
+    int fd;
+    const uint8_t *map;     /* mapped fbdev memory, NULL for raw files */
+    uint8_t *copy;          /* last content of raw file */
+    size_t size;
+    int width;
+    int height;
+    int bpp;                /* bytes per pixel: 2 (RGB565), 3 or 4 */
+    int pitch;
+    int red;                /* byte positions of color components in 24/32-bit pixels */
+    int green;
+    int blue;
+} source_t;
+
+static volatile sig_atomic_t s_stop = 0;
+
+/* Offsets of left and right sample of each display column in source row */
+static uint32_t *s_xoff[2];
+/* Color components of one display row, accumulated from 4 samples */
+static uint16_t *s_r, *s_g, *s_b;
+
+/* Ordered dithering is stable from frame to frame, so static areas never become damaged */
+static const uint8_t s_bayer[4][4] =
+{
+    {   8, 136,  40, 168 },
+    { 200,  72, 232, 104 },
+    {  56, 184,  24, 152 },
+    { 248, 120, 216,  88 },
+};
+
+int init_interface(char *intf, char *bus, char *devId, int dcPin)
+{
+    if (!strcmp(intf, "spi"))
+    {
+        ssd1306_platform_spiInit(bus[0] - '0', strtol(devId, NULL, 16), dcPin);
+    }
+    else if (!strcmp(intf, "i2c"))
+    {
+        ssd1306_platform_i2cInit(bus[0] - '0', strtol(devId, NULL, 16), NULL);
+    }
+    else
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int init_driver(char *driver)
+{
+    if (!strcmp(driver, "ssd1306_128x64")) ssd1306_128x64_init();
+    else if (!strcmp(driver, "ssd1306_128x32")) ssd1306_128x32_init();
+    else if (!strcmp(driver, "sh1106_128x64")) sh1106_128x64_init();
+    else if (!strcmp(driver, "ssd1331_96x64")) ssd1331_96x64_init();
+    else if (!strcmp(driver, "ssd1351_128x128")) ssd1351_128x128_init();
+    else if (!strcmp(driver, "il9163_128x128")) il9163_128x128_init();
+    else if (!strcmp(driver, "st7735_128x160")) st7735_128x160_init();
+    else if (!strcmp(driver, "ili9341_240x320")) ili9341_240x320_init();
+    else return -1;
+    return 0;
+}
+
+/* Opens fbdev device, or raw file if geometry is given as WxHxBPP */
+int open_source(source_t *src, const char *path, const char *geometry)
+{
+    memset(src, 0, sizeof(*src));
+    src->fd = open(path, O_RDONLY);
+    if (src->fd < 0)
+    {
+        perror(path);
+        return -1;
+    }
+    int bits = 0;
+    if (geometry)
+    {
+        if (sscanf(geometry, "%dx%dx%d", &src->width, &src->height, &bits) != 3)
+        {
+            return -1;
+        }
+        /* Raw files keep pixels in fbdev little endian order: B, G, R, X */
+        src->red = 2;
+        src->green = 1;
+        src->blue = 0;
+    }
+    else
+    {
+        struct fb_var_screeninfo var;
+        struct fb_fix_screeninfo fix;
+        if (ioctl(src->fd, FBIOGET_VSCREENINFO, &var) < 0 || ioctl(src->fd, FBIOGET_FSCREENINFO, &fix) < 0)
+        {
+            perror(path);
+            return -1;
+        }
+        src->width = var.xres;
+        src->height = var.yres;
+        src->pitch = fix.line_length;
+        bits = var.bits_per_pixel;
+        src->red = var.red.offset >> 3;
+        src->green = var.green.offset >> 3;
+        src->blue = var.blue.offset >> 3;
+        src->size = fix.smem_len;
+        src->map = (const uint8_t *)mmap(NULL, src->size, PROT_READ, MAP_SHARED, src->fd, 0);
+        if (src->map == MAP_FAILED)
+        {
+            perror(path);
+            return -1;
+        }
+    }
+    src->bpp = bits >> 3;
+    if ((src->bpp < 2 || src->bpp > 4) || src->width <= 0 || src->height <= 0)
+    {
+        fprintf(stderr, "Unsupported framebuffer format: %dx%dx%d\n", src->width, src->height, bits);
+        return -1;
+    }
+    if (!src->map)
+    {
+        src->pitch = src->width * src->bpp;
+        src->size = (size_t)src->pitch * src->height;
+        src->copy = (uint8_t *)malloc(src->size);
+        if (!src->copy) return -1;
+    }
+    return 0;
+}
+
+/* Returns first visible line of the framebuffer, following panning of double-buffered fbdev */
+const uint8_t *capture_source(source_t *src)
+{
+    if (!src->map)
+    {
+        return pread(src->fd, src->copy, src->size, 0) == (ssize_t)src->size ? src->copy : NULL;
+    }
+    struct fb_var_screeninfo var;
+    size_t offset = 0;
+    if (ioctl(src->fd, FBIOGET_VSCREENINFO, &var) == 0)
+    {
+        offset = (size_t)var.yoffset * src->pitch + (size_t)var.xoffset * src->bpp;
+    }
+    if (offset + (size_t)src->pitch * (src->height - 1) + (size_t)src->width * src->bpp > src->size)
+    {
+        offset = 0;
+    }
+    return src->map + offset;
+}
+
+/* Each display pixel is average of 2x2 samples, taken at quarters of its area in the source */
+int init_scaler(const source_t *src, lcduint_t w)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        s_xoff[i] = (uint32_t *)malloc(w * sizeof(uint32_t));
+        if (!s_xoff[i]) return -1;
+        for (lcduint_t x = 0; x < w; x++)
+        {
+            s_xoff[i][x] = (uint32_t)(((4 * x + 1 + 2 * i) * src->width) / (4 * w)) * src->bpp;
+        }
+    }
+    s_r = (uint16_t *)malloc(w * sizeof(uint16_t));
+    s_g = (uint16_t *)malloc(w * sizeof(uint16_t));
+    s_b = (uint16_t *)malloc(w * sizeof(uint16_t));
+    return (s_r && s_g && s_b) ? 0 : -1;
+}
+
+/* Adds samples of source line to color components of display row */
+void sample_line(const source_t *src, const uint8_t *line, lcduint_t w)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        const uint32_t *xoff = s_xoff[i];
+        if (src->bpp == 2)
+        {
+            for (lcduint_t x = 0; x < w; x++)
+            {
+                uint16_t p = line[xoff[x]] | (line[xoff[x] + 1] << 8);
+                s_r[x] += (p >> 8) & 0xF8;
+                s_g[x] += (p >> 3) & 0xFC;
+                s_b[x] += (p << 3) & 0xF8;
+            }
+        }
+        else
+        {
+            for (lcduint_t x = 0; x < w; x++)
+            {
+                const uint8_t *p = &line[xoff[x]];
+                s_r[x] += p[src->red];
+                s_g[x] += p[src->green];
+                s_b[x] += p[src->blue];
+            }
+        }
+    }
+}
+
+/*
+ * Converts sampled display row to panel format. The loops work on plain arrays
+ * without branches, so the compiler vectorizes them.
+ */
+void convert_row(uint8_t *frame, lcduint_t y, lcduint_t w, int format)
+{
+    if (format == FORMAT_RGB16)
+    {
+        uint8_t *dst = &frame[(size_t)y * w * 2];
+        for (lcduint_t x = 0; x < w; x++)
+        {
+            uint8_t r = s_r[x] >> 2;
+            uint8_t g = s_g[x] >> 2;
+            uint8_t b = s_b[x] >> 2;
+            dst[2 * x] = (r & 0xF8) | (g >> 5);
+            dst[2 * x + 1] = ((g << 3) & 0xE0) | (b >> 3);
+        }
+    }
+    else if (format == FORMAT_RGB8)
+    {
+        uint8_t *dst = &frame[(size_t)y * w];
+        for (lcduint_t x = 0; x < w; x++)
+        {
+            uint8_t r = s_r[x] >> 2;
+            uint8_t g = s_g[x] >> 2;
+            uint8_t b = s_b[x] >> 2;
+            dst[x] = RGB_COLOR8(r, g, b);
+        }
+    }
+    else
+    {
+        uint8_t *dst = &frame[(size_t)(y >> 3) * w];
+        const uint8_t *threshold = s_bayer[y & 3];
+        uint8_t bit = 1 << (y & 7);
+        if ((y & 7) == 0)
+        {
+            memset(dst, 0, w);
+        }
+        for (lcduint_t x = 0; x < w; x++)
+        {
+            uint16_t luma = (77 * s_r[x] + 150 * s_g[x] + 29 * s_b[x]) >> 10;
+            dst[x] |= luma > threshold[x & 3] ? bit : 0;
+        }
+    }
+}
+
+/* Scales source framebuffer down to the display size and converts it to panel format */
+void render_frame(const source_t *src, const uint8_t *pixels, uint8_t *frame, lcduint_t w, lcduint_t h, int format)
+{
+    for (lcduint_t y = 0; y < h; y++)
+    {
+        memset(s_r, 0, w * sizeof(uint16_t));
+        memset(s_g, 0, w * sizeof(uint16_t));
+        memset(s_b, 0, w * sizeof(uint16_t));
+        for (int i = 0; i < 2; i++)
+        {
+            int sy = ((4 * y + 1 + 2 * i) * src->height) / (4 * h);
+            sample_line(src, pixels + (size_t)sy * src->pitch, w);
+        }
+        convert_row(frame, y, w, format);
+    }
+}
+
+/* Sends only changed part of each display page, returns number of sent windows */
+int push_mono(const uint8_t *pages, const uint8_t *last, lcduint_t w, lcduint_t h)
+{
+    int windows = 0;
+    for (lcduint_t page = 0; page < (h >> 3); page++)
+    {
+        const uint8_t *src = &pages[page * w];
+        lcdint_t x0 = 0;
+        lcdint_t x1 = w - 1;
+        if (last)
+        {
+            while (x0 < w && src[x0] == last[page * w + x0]) x0++;
+            if (x0 == w) continue;
+            while (src[x1] == last[page * w + x1]) x1--;
+        }
+        ssd1306_lcd.set_block(x0, page, x1 - x0 + 1);
+        ssd1306_lcd.send_pixels_buffer1(&src[x0], x1 - x0 + 1);
+        ssd1306_intf.stop();
+        windows++;
+    }
+    return windows;
+}
+
+/* Sends changed windows of color frame: columns range of each band of 8 rows */
+int push_color(const uint8_t *pixels, const uint8_t *last, lcduint_t w, lcduint_t h, int format)
+{
+    int windows = 0;
+    size_t size = format == FORMAT_RGB16 ? 2 : 1;
+    size_t pitch = w * size;
+    for (lcduint_t y0 = 0; y0 < h; y0 += 8)
+    {
+        lcduint_t y1 = y0 + 8 < h ? y0 + 8 : h;
+        lcdint_t x0 = last ? w : 0;
+        lcdint_t x1 = last ? -1 : w - 1;
+        for (lcduint_t y = y0; last && y < y1; y++)
+        {
+            const uint8_t *src = &pixels[y * pitch];
+            const uint8_t *old = &last[y * pitch];
+            if (!memcmp(src, old, pitch)) continue;
+            size_t l = 0;
+            size_t r = pitch - 1;
+            while (src[l] == old[l]) l++;
+            while (src[r] == old[r]) r--;
+            if ((lcdint_t)(l / size) < x0) x0 = l / size;
+            if ((lcdint_t)(r / size) > x1) x1 = r / size;
+        }
+        if (x1 < x0) continue;
+        ssd1306_lcd.set_block(x0, y0, x1 - x0 + 1);
+        for (lcduint_t y = y0; y < y1; y++)
+        {
+            const uint8_t *src = &pixels[y * pitch + x0 * size];
+            if (format == FORMAT_RGB16) ssd1306_lcd.send_pixels_buffer16(src, x1 - x0 + 1);
+            else ssd1306_lcd.send_pixels_buffer8(src, x1 - x0 + 1);
+        }
+        ssd1306_intf.stop();
+        windows++;
+    }
+    return windows;
+}
+
+static void on_signal(int sig)
+{
+    s_stop = 1;
+}
+
+void print_usage(void)
+{
+    fprintf(stderr, "Usage: fbmirror [options] [interface] [bus] [devId] [oled_driver]\n");
+    fprintf(stderr, "        -f device     - framebuffer device, /dev/fb0 by default\n");
+    fprintf(stderr, "        -g WxHxBPP    - read raw image file of given geometry instead of fbdev\n");
+    fprintf(stderr, "        -m format     - mono, rgb8 or rgb565, by default rgb565 for color displays\n");
+    fprintf(stderr, "        -i ms         - capture interval, 100 ms by default\n");
+    fprintf(stderr, "        -n frames     - stop after specified number of frames\n");
+    fprintf(stderr, "        -d pin        - gpio number of D/C line for spi displays\n");
+    fprintf(stderr, "        interface     - spi, i2c\n");
+    fprintf(stderr, "        bus           - i2c-bus number or spidev  bus number\n");
+    fprintf(stderr, "        devId         - i2c-bus device address or spi device number in hex\n");
+    fprintf(stderr, "        oled_driver   - Oled driver name\n");
+    fprintf(stderr, "Example: fbmirror -m mono i2c 1 0x3c ssd1306_128x64\n");
+    fprintf(stderr, "         fbmirror -d 24 spi 0 0 ssd1351_128x128\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *device = "/dev/fb0";
+    const char *geometry = NULL;
+    const char *mode = NULL;
+    uint32_t interval = 100;
+    long limit = -1;
+    int dcPin = -1;
+    int opt;
+    while ((opt = getopt(argc, argv, "f:g:m:i:n:d:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'f': device = optarg; break;
+            case 'g': geometry = optarg; break;
+            case 'm': mode = optarg; break;
+            case 'i': interval = strtoul(optarg, NULL, 10); break;
+            case 'n': limit = strtol(optarg, NULL, 10); break;
+            case 'd': dcPin = strtol(optarg, NULL, 10); break;
+            default: print_usage(); return 1;
+        }
+    }
+    argc -= optind - 1;
+    argv += optind - 1;
+    if (argc < 5)
+    {
+        print_usage();
+        return 1;
+    }
+    source_t src;
+    if (open_source(&src, device, geometry) < 0)
+    {
+        fprintf(stderr, "Error\n");
+        return 1;
+    }
+    if (init_interface(argv[1], argv[2], argv[3], dcPin) < 0 || init_driver(argv[4]) < 0)
+    {
+        fprintf(stderr, "Error2\n");
+        return 1;
+    }
+    int format = ssd1306_lcd.send_pixels_buffer16 ? FORMAT_RGB16 : FORMAT_MONO;
+    if (mode)
+    {
+        format = !strcmp(mode, "rgb565") ? FORMAT_RGB16 : !strcmp(mode, "rgb8") ? FORMAT_RGB8 :
+                 !strcmp(mode, "mono") ? FORMAT_MONO : 0;
+    }
+    if (!format || (format == FORMAT_RGB16 && !ssd1306_lcd.send_pixels_buffer16) ||
+                   (format == FORMAT_RGB8 && !ssd1306_lcd.send_pixels_buffer8))
+    {
+        fprintf(stderr, "Format is not supported by the display\n");
+        return 1;
+    }
+    /* Monochrome frames are sent to color displays in ssd1306 compatible mode */
+    ssd1306_setMode(format == FORMAT_MONO && ssd1306_lcd.send_pixels_buffer16 ? LCD_MODE_SSD1306_COMPAT
+                                                                                : LCD_MODE_NORMAL);
+    lcduint_t w = ssd1306_displayWidth();
+    lcduint_t h = ssd1306_displayHeight();
+    size_t size = format == FORMAT_MONO ? (size_t)w * (h >> 3) : (size_t)w * h * (format >> 3);
+    uint8_t *frame = (uint8_t *)malloc(size);
+    uint8_t *last = (uint8_t *)malloc(size);
+    if (!frame || !last || init_scaler(&src, w) < 0)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    long frames = 0;
+    long windows = 0;
+    bool valid = false;
+    while (!s_stop && frames != limit)
+    {
+        uint32_t ts = millis();
+        const uint8_t *pixels = capture_source(&src);
+        if (pixels)
+        {
+            render_frame(&src, pixels, frame, w, h, format);
+            if (!valid || memcmp(frame, last, size))
+            {
+                windows += format == FORMAT_MONO ? push_mono(frame, valid ? last : NULL, w, h)
+                                                 : push_color(frame, valid ? last : NULL, w, h, format);
+                uint8_t *tmp = last;
+                last = frame;
+                frame = tmp;
+                valid = true;
+            }
+        }
+        frames++;
+        uint32_t spent = millis() - ts;
+        if (spent < interval && frames != limit)
+        {
+            delay(interval - spent);
+        }
+    }
+    fprintf(stderr, "%ld frames captured, %ld windows sent\n", frames, windows);
+    ssd1306_intf.close();
+    return 0;
+}
@@ -35,6 +35,7 @@
 
 import re
 import sys
+import codecs
 from modules import glcdsource
 from modules import fontgenerator
 
@@ -43,6 +44,7 @@ def print_help_and_exit():
     print "args:"
     print "      --ttf S   use ttf name as source"
     print "      --glcd S  use glcd file as as source"
+    print "      --squix S use squix (ThingPulse) font file as source"
     print "      -s <N>    font size (this is not pixels!) "
     print "      -SB <N>   limit size in pixels to value (pixels will be cut)"
     print "      -fh       fixed height"
@@ -50,6 +52,13 @@ def print_help_and_exit():
     print "      -g <S> <E> add chars group to the font"
     print "      -f old    old format 1.7.6 and below"
     print "      -f new    new format 1.7.8 and above"
+    print "      -f rows   new format with glyphs stored row by row (for color displays)"
+    print "      -rle      compress glyphs of rows format with RLE"
+    print "      -aa <N>   anti-aliased rows format with N bits alpha (2 or 4, ttf only)"
+    print "      -i        add sorted unicode blocks index (new format only)"
+    print "      --subset S  keep only chars of utf8 string S (new format only)"
+    print "      --subset-scan F  keep only chars of string and char literals,"
+    print "                found in source file F (new format only)"
     print "      -d        Print demo text to console"
     print "      --demo-only Prints demo text to console and exits"
     print "Examples:"
@@ -59,13 +68,40 @@ def print_help_and_exit():
     print "      ttf_fonts.py --ttf FreeSans.ttf -d -f new"
     print "   [convert GLCD font generated file to new format]"
     print "      ttf_fonts.py --glcd font.c -f new > ssd1306font.h"
+    print "   [convert squix font to new format]"
+    print "      ttf_fonts.py --squix OLEDDisplayFonts.h -f new > ssd1306font.h"
+    print "   [convert ttf font to rows format with RLE for 16-bit displays]"
+    print "      ttf_fonts.py --ttf FreeSans.ttf -s 16 -f rows -rle > ssd1306font.h"
+    print "   [convert ttf font to font with digits and chars, used by the sketch only]"
+    print "      ttf_fonts.py --ttf FreeSans.ttf -s 12 --subset 0123456789 --subset-scan app.ino > ssd1306font.h"
+    print "   [convert ttf font to anti-aliased font with 4-bit alpha]"
+    print "      ttf_fonts.py --ttf FreeSans.ttf -s 12 -aa 4 > ssd1306font.h"
     exit(1)
 
+# Returns set of chars, used in string and char literals of C/C++ source file
+def scan_source_chars(filename):
+    chars = set()
+    with codecs.open(filename, 'r', encoding="utf-8") as f:
+        content = f.read()
+    # file names of include directives are not printed
+    content = re.sub(r'^\s*#\s*include.*$', '', content, flags=re.M)
+    for m in re.finditer(r'"((?:[^"\\\n]|\\.)*)"|\'((?:[^\'\\\n]|\\.)+)\'', content):
+        literal = m.group(1) if m.group(1) is not None else m.group(2)
+        # escaped quotes and backslash are chars of the string, other escapes are not printed
+        literal = re.sub(r'\\x[0-9a-fA-F]+|\\[0-7]{1,3}|\\.',
+                         lambda e: e.group(0)[1] if e.group(0)[1] in '\\"\'' else '', literal)
+        chars |= set(literal)
+    return chars
+
 if len(sys.argv) < 2:
     print_help_and_exit()
 
 fsize = 8
 fold = False
+frows = False
+frle = False
+falpha = 0
+findex = False
 flimit_bottom = 0
 fwidth = False
 fheight = False
@@ -73,8 +109,10 @@ fname = ""
 fgroups = []
 TTF = False
 GLCD = False
+SQUIX = False
 demo_text = False
 demo_text_ = "World!q01"
+fsubset = None
 generate_font = True
 source = None
 
@@ -90,6 +128,10 @@ while idx < len(sys.argv):
         GLCD = True
         idx += 1
         fname = sys.argv[idx]
+    elif opt == "--squix":
+        SQUIX = True
+        idx += 1
+        fname = sys.argv[idx]
     elif opt == "-s":
         idx += 1
         fsize = int(sys.argv[idx])
@@ -104,6 +146,18 @@ while idx < len(sys.argv):
         idx += 1
         if sys.argv[idx] == "old":
             fold = True
+        elif sys.argv[idx] == "rows":
+            frows = True
+    elif opt == "-rle":
+        frows = True
+        frle = True
+    elif opt == "-aa":
+        idx += 1
+        falpha = int(sys.argv[idx])
+        if falpha != 2 and falpha != 4:
+            print "Unsupported alpha bits: ", falpha
+            print_help_and_exit()
+        frows = True
     elif opt == "-g":
         idx += 1
         _start_char = sys.argv[idx]
@@ -121,6 +175,14 @@ while idx < len(sys.argv):
         else:
             _end_char = _end_char.decode("utf-8")
         fgroups.append( (_start_char, _end_char ) )
+    elif opt == "-i":
+        findex = True
+    elif opt == "--subset":
+        idx += 1
+        fsubset = (fsubset or set()) | set(sys.argv[idx].decode("utf-8"))
+    elif opt == "--subset-scan":
+        idx += 1
+        fsubset = (fsubset or set()) | scan_source_chars(sys.argv[idx])
     elif opt == "-d":
         demo_text = True
     elif opt == "-t":
@@ -136,7 +198,15 @@ while idx < len(sys.argv):
 
 if TTF:
     from modules import ttfsource
-    source = ttfsource.TTFSource(fname, fsize)
+    source = ttfsource.TTFSource(fname, fsize, falpha > 0)
+    if len(fgroups) == 0 and fsubset is not None:
+        # render only chars of the subset, each contiguous run as separate group
+        codes = sorted(ord(c) for c in fsubset)
+        for code in codes:
+            if len(fgroups) > 0 and ord(fgroups[-1][1]) + 1 == code:
+                fgroups[-1] = (fgroups[-1][0], unichr(code))
+            else:
+                fgroups.append((unichr(code), unichr(code)))
     if len(fgroups) == 0:
         fgroups.append((' ', unichr(127)))
     for g in fgroups:
@@ -145,6 +215,10 @@ if TTF:
 if GLCD:
     source = glcdsource.GLCDSource(fname, fsize, "utf8")
 
+if SQUIX:
+    from modules import squixsource
+    source = squixsource.SquixSource(fname, fsize, "utf8")
+
 if source is None:
     print_help_and_exit()
 
@@ -156,7 +230,14 @@ if flimit_bottom > 0:
     source.deflate_chars_bottom( flimit_bottom )
 
 font = fontgenerator.Generator( source )
+font.rows = frows
+font.rle = frle
+font.alpha = falpha
+font.subset = fsubset
 if fold:
+    if fsubset is not None:
+        print "Subset fonts are supported in new format only"
+        exit(1)
     source.expand_chars()
     if demo_text:
         source.printString(demo_text_.decode("utf-8"))
@@ -166,5 +247,5 @@ else:
     if demo_text:
         source.printString(demo_text_.decode("utf-8"))
     if generate_font:
-        font.generate_new_format()
+        font.generate_new_format( findex )
 
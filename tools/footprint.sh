@@ -0,0 +1,200 @@
+#!/bin/sh
+#    MIT License
+#
+#    Copyright (c) 2019, Alexey Dynda
+#
+#    Permission is hereby granted, free of charge, to any person obtaining a copy
+#    of this software and associated documentation files (the "Software"), to deal
+#    in the Software without restriction, including without limitation the rights
+#    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#    copies of the Software, and to permit persons to whom the Software is
+#    furnished to do so, subject to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be included in all
+#    copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#    SOFTWARE.
+#
+# Builds footprint probes (examples/benchmark/footprint) and prints flash/SRAM usage
+# of each library API relative to empty program.
+
+platform=avr
+mcus=
+output=
+compare=
+threshold=0
+adafruit=
+bld=${BLD:-/tmp/ssd1306_footprint}
+
+all_probes="I2C_INIT SPI_INIT TEXT TEXT_2X TEXT_UTF8 BITMAP SPRITE MENU CANVAS1 ENGINE_8X8 ENGINE_16X16 ENGINE_32X32"
+
+print_help_and_exit()
+{
+    echo "Usage: ./footprint.sh [options] [probe ...]"
+    echo "options:"
+    echo "        -p      platform to compile for: avr (default), esp32, linux"
+    echo "        -m      comma separated list of mcus (avr only), attiny85,atmega328p by default"
+    echo "        -o      write table to file"
+    echo "        -c      compare with table, created earlier, and fail if any probe grows"
+    echo "        -t      allowed growth in bytes for -c option, 0 by default"
+    echo "        -a      add Adafruit GFX probe (requires ADAFRUIT_DIR for avr and linux)"
+    echo "probes: ${all_probes} ENGINE_ADAFRUIT"
+    echo ""
+    echo "# example: save current footprint of all probes"
+    echo "    ./footprint.sh -o footprint.txt"
+    echo "# example: check that attiny85 footprint didn't grow"
+    echo "    ./footprint.sh -m attiny85 -c footprint.txt"
+    exit 1
+}
+
+while getopts "p:m:o:c:t:a" opt; do
+  case $opt in
+    p) platform=$OPTARG;;
+    m) mcus=$OPTARG;;
+    o) output=$OPTARG;;
+    c) compare=$OPTARG;;
+    t) threshold=$OPTARG;;
+    a) adafruit=y;;
+    \?)
+      echo "Invalid option: -$OPTARG" >&2
+      print_help_and_exit
+      ;;
+    :)
+      echo "Option -$OPTARG requires an argument." >&2
+      print_help_and_exit
+      ;;
+  esac
+done
+
+shift $((OPTIND-1))
+probes="$*"
+if [ "$probes" = "" ]; then
+    probes="$all_probes"
+    if [ "$adafruit" = "y" ]; then
+        probes="$probes ENGINE_ADAFRUIT"
+    fi
+fi
+
+case $platform in
+    avr)
+        mcus=${mcus:-attiny85,atmega328p}
+        size_tool=avr-size
+        ;;
+    esp32)
+        mcus=esp32
+        size_tool=xtensa-esp32-elf-size
+        ;;
+    linux)
+        mcus=linux
+        size_tool=size
+        ;;
+    *)
+        echo "Platform $platform is not supported" >&2
+        print_help_and_exit
+        ;;
+esac
+
+examples=$(cd "$(dirname "$0")/../examples" && pwd)
+
+# Prints "flash sram" for elf file, using section sizes
+elf_size()
+{
+    $size_tool -A "$1" | awk -v platform=$platform '
+        platform == "avr"   && $1 == ".text"                   { flash += $2 }
+        platform == "avr"   && $1 == ".data"                   { flash += $2; sram += $2 }
+        platform == "avr"   && $1 == ".bss"                    { sram += $2 }
+        platform == "esp32" && $1 ~ /^\.(flash\.text|flash\.rodata|iram0\.text)$/ { flash += $2 }
+        platform == "esp32" && $1 == ".dram0.data"             { flash += $2; sram += $2 }
+        platform == "esp32" && $1 == ".dram0.bss"              { sram += $2 }
+        platform == "linux" && $1 ~ /^\.(text|rodata)$/        { flash += $2 }
+        platform == "linux" && $1 == ".data"                   { flash += $2; sram += $2 }
+        platform == "linux" && $1 == ".bss"                    { sram += $2 }
+        END { printf "%d %d\n", flash, sram }'
+}
+
+# Builds probe and prints "flash sram", or "- -" if probe doesn't fit the mcu
+build_probe()
+{
+    mcu=$1
+    probe=$2
+    dir=$bld/$platform/$mcu
+    flags=
+    args=
+    if [ "$probe" != "EMPTY" ]; then
+        flags="-DFOOTPRINT_$probe"
+    fi
+    if [ "$probe" = "ENGINE_ADAFRUIT" ]; then
+        args="ADAFRUIT=y"
+    fi
+    case $platform in
+        avr)
+            rm -rf $dir/benchmark
+            make -C "$examples" -f Makefile.avr MCU=$mcu BLD=$dir PROJECT=benchmark/footprint \
+                 EXTRA_CCFLAGS="$flags" $args >$dir.log 2>&1 || { echo "- -"; return; }
+            elf=$dir/benchmark/footprint.out
+            ;;
+        esp32)
+            rm -rf $dir/esp32/build/sketch
+            EXTRA_CPPFLAGS="$flags" make -C "$examples" -f Makefile.esp32 BLD=$dir \
+                 PROJECT=benchmark/footprint >$dir.log 2>&1 || { echo "- -"; return; }
+            elf=$dir/esp32/build/footprint.elf
+            ;;
+        linux)
+            rm -rf $dir/benchmark
+            make -C "$examples" -f Makefile.linux BLD=$dir PROJECT=benchmark/footprint \
+                 EXTRA_CCFLAGS="$flags" $args >$dir.log 2>&1 || { echo "- -"; return; }
+            elf=$dir/benchmark/footprint.out
+            ;;
+    esac
+    elf_size $elf
+}
+
+table=$bld/footprint.txt
+mkdir -p $bld
+echo "# mcu            probe              flash     sram   +flash    +sram" > $table
+for mcu in $(echo $mcus | tr ',' ' '); do
+    mkdir -p $bld/$platform/$mcu
+    base=$(build_probe $mcu EMPTY)
+    if [ "$base" = "- -" ]; then
+        echo "Failed to build empty program for $mcu, see $bld/$platform/$mcu.log" >&2
+        exit 1
+    fi
+    set -- $base
+    base_flash=$1
+    base_sram=$2
+    printf "%-16s %-16s %8d %8d %8d %8d\n" $mcu EMPTY $base_flash $base_sram 0 0 >> $table
+    for probe in $probes; do
+        set -- $(build_probe $mcu $probe)
+        if [ "$1" = "-" ]; then
+            printf "%-16s %-16s %8s %8s %8s %8s\n" $mcu $probe - - - - >> $table
+        else
+            printf "%-16s %-16s %8d %8d %8d %8d\n" $mcu $probe $1 $2 \
+                   $(($1 - base_flash)) $(($2 - base_sram)) >> $table
+        fi
+    done
+done
+
+cat $table
+if [ "$output" != "" ]; then
+    cp $table "$output"
+fi
+
+if [ "$compare" != "" ]; then
+    # Probes, which grew more than threshold (or stopped to fit), fail the check
+    awk -v threshold=$threshold '
+        FNR == NR && !/^#/ { flash[$1 " " $2] = $3; sram[$1 " " $2] = $4; next }
+        !/^#/ && (($1 " " $2) in flash) {
+            key = $1 " " $2
+            if ($3 == "-" && flash[key] != "-") { print key ": does not fit anymore"; failed = 1; next }
+            if ($3 == "-" || flash[key] == "-") next
+            if ($3 - flash[key] > threshold) { print key ": flash " flash[key] " -> " $3; failed = 1 }
+            if ($4 - sram[key] > threshold) { print key ": sram " sram[key] " -> " $4; failed = 1 }
+        }
+        END { exit failed }' "$compare" $table || exit 1
+fi
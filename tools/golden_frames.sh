@@ -0,0 +1,123 @@
+#!/bin/sh
+#    MIT License
+#
+#    Copyright (c) 2019, Alexey Dynda
+#
+#    Permission is hereby granted, free of charge, to any person obtaining a copy
+#    of this software and associated documentation files (the "Software"), to deal
+#    in the Software without restriction, including without limitation the rights
+#    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#    copies of the Software, and to permit persons to whom the Software is
+#    furnished to do so, subject to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be included in all
+#    copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#    SOFTWARE.
+#
+# Runs demos (examples/demos) in headless emulator up to delay() checkpoints and
+# prints checksum of display content, bytes sent and time spent at each checkpoint.
+# Compared with table, created earlier, it fails if any frame differs or more bytes are sent.
+
+output=
+compare=
+threshold=0
+checkpoints="2 4 8 16 300"
+bld=${BLD:-/tmp/ssd1306_golden}
+
+print_help_and_exit()
+{
+    echo "Usage: ./golden_frames.sh [options] [demo ...]"
+    echo "options:"
+    echo "        -o      write table to file"
+    echo "        -c      compare with table, created earlier, and fail if any frame differs"
+    echo "                or more bytes are sent"
+    echo "        -t      allowed growth in bytes for -c option, 0 by default"
+    echo "        -n      space separated list of checkpoints (number of delay() calls),"
+    echo "                \"${checkpoints}\" by default"
+    echo "demos: names of examples/demos projects, all by default"
+    echo ""
+    echo "# example: save golden frames before optimization"
+    echo "    ./golden_frames.sh -o golden.txt"
+    echo "# example: check that ssd1306 output is the same and is not sent slower"
+    echo "    ./golden_frames.sh -c golden.txt ssd1306_demo sh1106_demo"
+    exit 1
+}
+
+while getopts "o:c:t:n:" opt; do
+  case $opt in
+    o) output=$OPTARG;;
+    c) compare=$OPTARG;;
+    t) threshold=$OPTARG;;
+    n) checkpoints=$OPTARG;;
+    \?)
+      echo "Invalid option: -$OPTARG" >&2
+      print_help_and_exit
+      ;;
+    :)
+      echo "Option -$OPTARG requires an argument." >&2
+      print_help_and_exit
+      ;;
+  esac
+done
+
+shift $((OPTIND-1))
+examples=$(cd "$(dirname "$0")/../examples" && pwd)
+demos="$*"
+if [ "$demos" = "" ]; then
+    demos=$(cd "$examples/demos" && ls -d */ | tr -d '/')
+fi
+
+# Runs demo to the checkpoint and prints "checksum bytes us"
+run_checkpoint()
+{
+    frame=$bld/demos/$1.$2.ppm
+    rm -f $frame
+    report=$(SDL_NO_DELAY=y SDL_EXIT_AFTER_DELAYS=$2 SDL_DUMP_FRAME=$frame \
+             $bld/demos/$1.out 2>&1 | grep "^Checkpoint:")
+    if [ ! -f $frame ] || [ "$report" = "" ]; then
+        echo "- - -"
+        return
+    fi
+    set -- $report
+    echo "$(md5sum < $frame | cut -d' ' -f1) $4 $8"
+}
+
+table=$bld/golden.txt
+mkdir -p $bld
+echo "# demo                   checkpoint checksum                            bytes         us" > $table
+for demo in $demos; do
+    if ! make -C "$examples" -f Makefile.linux SDL_EMULATION=y SDL_HEADLESS=y BLD=$bld \
+              PROJECT=demos/$demo >$bld/$demo.log 2>&1; then
+        echo "Failed to build $demo, see $bld/$demo.log" >&2
+        exit 1
+    fi
+    for n in $checkpoints; do
+        printf "%-24s %10s %-32s %10s %10s\n" $demo $n $(run_checkpoint $demo $n) >> $table
+    done
+done
+
+cat $table
+if [ "$output" != "" ]; then
+    cp $table "$output"
+fi
+
+if [ "$compare" != "" ]; then
+    # Frames must be identical, bytes may not grow more than threshold, time is informational
+    awk -v threshold=$threshold '
+        FNR == NR && !/^#/ { sum[$1 " " $2] = $3; bytes[$1 " " $2] = $4; us[$1 " " $2] = $5; next }
+        !/^#/ && (($1 " " $2) in sum) {
+            key = $1 " " $2
+            if ($3 != sum[key]) { print key ": frame differs"; failed = 1 }
+            if ($4 == "-" || bytes[key] == "-") next
+            if ($4 - bytes[key] > threshold) { print key ": bytes " bytes[key] " -> " $4; failed = 1 }
+            if (us[key] > 0) printf "%s: time %d -> %d us (%+.1f%%)\n", key, us[key], $5, ($5 - us[key]) * 100.0 / us[key]
+        }
+        END { exit failed }' "$compare" $table || exit 1
+fi
@@ -29,154 +29,299 @@
 #include <linux/mutex.h>
 #include <linux/err.h>
 #include <linux/string.h>
+#include <linux/fb.h>
+#include <linux/mm.h>
+#include <linux/uaccess.h>
 
 #include "ssd1306.h"
 #include "intf/ssd1306_interface.h"
 #include "intf/i2c/ssd1306_i2c.h"
-#include "font6x8.h"
 
 #define DEVICE_CLASS_NAME "ssd1306_lcd"
 
+/// Maximum display size, supported by the driver
+#define SSD1306_FB_MAX_WIDTH   128
+#define SSD1306_FB_MAX_HEIGHT  64
+#define SSD1306_FB_PAGES_SIZE  (SSD1306_FB_MAX_WIDTH * SSD1306_FB_MAX_HEIGHT / 8)
+
 static int bus = 1;
 static int addr = 0x3C;
+static int fps = 20;
 static struct i2c_client *s_client = NULL;
 static struct ssd1306_data *s_data = NULL;
-//static struct class *ssd1306_class = NULL;
 
 module_param(bus, int, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
 module_param(addr, int, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+module_param(fps, int, S_IRUSR | S_IRGRP);
 
 MODULE_PARM_DESC(bus, " I2C Bus number, default 1");
 MODULE_PARM_DESC(addr, " I2C device address, default 0x3C");
+MODULE_PARM_DESC(fps, " Maximum framebuffer refresh rate, default 20");
 
 struct ssd1306_data {
 	struct mutex lock;
-	u8 index;
-	/// According to https://www.kernel.org/doc/Documentation/i2c/dev-interface
-	/// block buffers need not be longer than 32 bytes
-	u8 data[24];
+	struct fb_info *info;
+	/// framebuffer memory, mapped by user-space applications
+	u8 *vmem;
+	u32 vmem_size;
+	/// pages, last sent to the display
+	u8 pages[SSD1306_FB_PAGES_SIZE];
+	/// pages of the frame being flushed
+	u8 frame[SSD1306_FB_PAGES_SIZE];
+	u16 index;
+	/// Control byte plus whole display memory: the frame goes in single i2c transfer
+	u8 data[1 + SSD1306_FB_PAGES_SIZE];
 };
 
 
-static void ssd1306_smbus_end(void);
+static void ssd1306_i2c_end(void);
 
-static void ssd1306_smbus_start(void) {
+static void ssd1306_i2c_start(void) {
 	s_data->index = 0;
 }
 
-static void ssd1306_smbus_send(u8 data) {
+static void ssd1306_i2c_send(u8 data) {
 	if (s_data->index >= sizeof(s_data->data)) {
-		ssd1306_smbus_end();
-		ssd1306_smbus_start();
-		s_data->data[0] = 0x40;
+		u8 control = s_data->data[0];
+		ssd1306_i2c_end();
+		ssd1306_i2c_start();
+		s_data->data[0] = control;
 		s_data->index++;
 	}
 	s_data->data[s_data->index] = data;
 	s_data->index++;
 }
 
-static void ssd1306_smbus_send_bytes(const u8 *buffer, u16 size)
+static void ssd1306_i2c_send_bytes(const u8 *buffer, u16 size)
 {
 	while (size--) {
-		ssd1306_smbus_send(*buffer);
+		ssd1306_i2c_send(*buffer);
 		buffer++;
 	}
 }
 
-static void ssd1306_smbus_end(void) {
+static void ssd1306_i2c_end(void) {
 	if (s_data->index) {
-		i2c_smbus_write_i2c_block_data(s_client, s_data->data[0], s_data->index - 1, &s_data->data[1]);
+		int ret = i2c_master_send(s_client, s_data->data, s_data->index);
+		if (ret < 0)
+			dev_err(&s_client->dev, "i2c transfer failed: %d\n", ret);
 		s_data->index=0;
 	}
 }
 
-static void ssd1306_smbus_close(void) {
+static void ssd1306_i2c_close(void) {
 }
 
+/*
+ * Framebuffer is 1 bit per pixel, row by row, least significant bit is the left pixel
+ * (the same layout as mainline ssd1307fb uses). The function converts it to the
+ * display pages, compares them with the pages sent last time and sends only changed
+ * pages band in single transfer.
+ */
+static void ssd1306_fb_flush(struct ssd1306_data *data)
+{
+	struct fb_info *info = data->info;
+	u32 width = info->var.xres;
+	u32 page_count = info->var.yres / 8;
+	u32 line_length = info->fix.line_length;
+	int first = -1, last = -1;
+	u32 page, x, k;
+
+	for (page = 0; page < page_count; page++) {
+		u8 *dst = &data->frame[page * width];
+		const u8 *src = data->vmem + page * 8 * line_length;
+		for (x = 0; x < width; x++) {
+			u8 bits = 0;
+			for (k = 0; k < 8; k++) {
+				if ((src[k * line_length + (x >> 3)] >> (x & 7)) & 0x01)
+					bits |= 1 << k;
+			}
+			dst[x] = bits;
+		}
+		if (memcmp(dst, &data->pages[page * width], width)) {
+			if (first < 0)
+				first = page;
+			last = page;
+		}
+	}
+	if (first < 0)
+		return;
+
+	mutex_lock(&data->lock);
+	s_data = data;
+	s_client = to_i2c_client(info->device);
+	memcpy(&data->pages[first * width], &data->frame[first * width],
+	       (last - first + 1) * width);
+	ssd1306_lcd.set_block(0, first, 0);
+	ssd1306_lcd.send_pixels_buffer1(&data->pages[first * width],
+					(last - first + 1) * width);
+	ssd1306_intf.stop();
+	mutex_unlock(&data->lock);
+}
 
-static ssize_t show_commands(struct device *dev,
-				struct device_attribute *attr, char *buf)
+static void ssd1306_fb_deferred_io(struct fb_info *info,
+				   struct list_head *pagelist)
 {
-//	struct ssd1306_data *data = i2c_get_clientdata(to_i2c_client(dev));
-	return sprintf(buf, 	"clear\n"
-				"pixel x,y\n"
-	);
+	/* Whole display fits single memory page, so dirty pages are found by comparison */
+	ssd1306_fb_flush(info->par);
 }
 
-static ssize_t execute_command(struct device *dev,
-			       struct device_attribute *attr,
-			       const char *buf, size_t count)
+static void ssd1306_fb_schedule(struct fb_info *info)
 {
-	char cmd[16];
-	s_client = to_i2c_client(dev);
-	s_data = i2c_get_clientdata(s_client);
-
-	mutex_lock(&s_data->lock);
-	sscanf(buf, "%15s", cmd);
-	if (!strcmp(cmd, "clear"))
-		ssd1306_clearScreen();
-	else if (!strcmp(cmd, "pixel")) {
-		int x, y;
-		sscanf(&buf[strlen(cmd) + 1], "%d,%d", &x, &y);
-		ssd1306_putPixel(x,y);
-	}
-	mutex_unlock(&s_data->lock);
-	return count;
+	schedule_delayed_work(&info->deferred_work, info->fbdefio->delay);
 }
 
-static DEVICE_ATTR(command, S_IWUSR | S_IWGRP | S_IRUGO, show_commands, execute_command);
+static ssize_t ssd1306_fb_write(struct fb_info *info, const char __user *buf,
+				size_t count, loff_t *ppos)
+{
+	ssize_t ret = fb_sys_write(info, buf, count, ppos);
+	if (ret > 0)
+		ssd1306_fb_schedule(info);
+	return ret;
+}
+
+static void ssd1306_fb_fillrect(struct fb_info *info,
+				const struct fb_fillrect *rect)
+{
+	sys_fillrect(info, rect);
+	ssd1306_fb_schedule(info);
+}
 
-static struct attribute *ssd1306_attributes[] = {
-	&dev_attr_command.attr,
-	NULL
+static void ssd1306_fb_copyarea(struct fb_info *info,
+				const struct fb_copyarea *area)
+{
+	sys_copyarea(info, area);
+	ssd1306_fb_schedule(info);
+}
+
+static void ssd1306_fb_imageblit(struct fb_info *info,
+				 const struct fb_image *image)
+{
+	sys_imageblit(info, image);
+	ssd1306_fb_schedule(info);
+}
+
+static int ssd1306_fb_blank(int blank_mode, struct fb_info *info)
+{
+	struct ssd1306_data *data = info->par;
+
+	mutex_lock(&data->lock);
+	s_data = data;
+	s_client = to_i2c_client(info->device);
+	if (blank_mode == FB_BLANK_UNBLANK)
+		ssd1306_displayOn();
+	else
+		ssd1306_displayOff();
+	mutex_unlock(&data->lock);
+	return 0;
+}
+
+static struct fb_ops ssd1306_fb_ops = {
+	.owner = THIS_MODULE,
+	.fb_read = fb_sys_read,
+	.fb_write = ssd1306_fb_write,
+	.fb_blank = ssd1306_fb_blank,
+	.fb_fillrect = ssd1306_fb_fillrect,
+	.fb_copyarea = ssd1306_fb_copyarea,
+	.fb_imageblit = ssd1306_fb_imageblit,
 };
 
-static const struct attribute_group ssd1306_attr_group = {
-	.attrs = ssd1306_attributes,
+static struct fb_deferred_io ssd1306_fb_defio = {
+	.deferred_io = ssd1306_fb_deferred_io,
 };
 
 static int ssd1306_probe(struct i2c_client *client,
 			 const struct i2c_device_id *id)
 {
+	struct fb_info *info;
 	struct ssd1306_data *data;
 	int err;
 
-	data = devm_kzalloc(&client->dev, sizeof(struct ssd1306_data),
-			    GFP_KERNEL);
-	if (!data)
+	info = framebuffer_alloc(sizeof(struct ssd1306_data), &client->dev);
+	if (!info)
 		return -ENOMEM;
 
+	data = info->par;
+	data->info = info;
 	i2c_set_clientdata(client, data);
 	mutex_init(&data->lock);
 	s_data = data;
-	ssd1306_startTransmission = ssd1306_smbus_start;
-	ssd1306_endTransmission = ssd1306_smbus_end;
-	ssd1306_sendByte = ssd1306_smbus_send;
-	ssd1306_sendBytes = ssd1306_smbus_send_bytes;
-	ssd1306_closeInterface = ssd1306_smbus_close;
+	ssd1306_startTransmission = ssd1306_i2c_start;
+	ssd1306_endTransmission = ssd1306_i2c_end;
+	ssd1306_sendByte = ssd1306_i2c_send;
+	ssd1306_sendBytes = ssd1306_i2c_send_bytes;
+	ssd1306_closeInterface = ssd1306_i2c_close;
 
 	mutex_lock(&data->lock);
 	s_client = client;
 	ssd1306_128x64_init();
 	ssd1306_fillScreen(0x00);
-	ssd1306_setFixedFont(ssd1306xled_font6x8);
-	ssd1306_printFixed (0,  8, "Line 1. text", 0); // STYLE_NORMAL
 	mutex_unlock(&data->lock);
 
+	data->vmem_size = PAGE_ALIGN(ssd1306_lcd.width * ssd1306_lcd.height / 8);
+	data->vmem = (u8 *)__get_free_pages(GFP_KERNEL | __GFP_ZERO,
+					    get_order(data->vmem_size));
+	if (!data->vmem) {
+		err = -ENOMEM;
+		goto release_fb;
+	}
 
-//	ssd1306_class = class_create(THIS_MODULE, DEVICE_CLASS_NAME);
-	/* Register sysfs hooks */
-	err = sysfs_create_group(&client->dev.kobj, &ssd1306_attr_group);
-	if (err)
-		return err;
-
+	info->fbops = &ssd1306_fb_ops;
+	strlcpy(info->fix.id, "ssd1306", sizeof(info->fix.id));
+	info->fix.type = FB_TYPE_PACKED_PIXELS;
+	info->fix.visual = FB_VISUAL_MONO10;
+	info->fix.accel = FB_ACCEL_NONE;
+	info->fix.line_length = ssd1306_lcd.width / 8;
+	info->fix.smem_start = __pa(data->vmem);
+	info->fix.smem_len = data->vmem_size;
+
+	info->var.xres = ssd1306_lcd.width;
+	info->var.xres_virtual = ssd1306_lcd.width;
+	info->var.yres = ssd1306_lcd.height;
+	info->var.yres_virtual = ssd1306_lcd.height;
+	info->var.bits_per_pixel = 1;
+	info->var.red.length = 1;
+	info->var.green.length = 1;
+	info->var.blue.length = 1;
+
+	info->screen_base = (u8 __force __iomem *)data->vmem;
+	info->screen_size = data->vmem_size;
+
+	ssd1306_fb_defio.delay = HZ / (fps > 0 ? fps : 1);
+	info->fbdefio = &ssd1306_fb_defio;
+	fb_deferred_io_init(info);
+
+	err = register_framebuffer(info);
+	if (err) {
+		dev_err(&client->dev, "failed to register framebuffer: %d\n", err);
+		goto cleanup_defio;
+	}
+	dev_info(&client->dev, "fb%d: %dx%d framebuffer\n", info->node,
+		 info->var.xres, info->var.yres);
 	return 0;
+
+cleanup_defio:
+	fb_deferred_io_cleanup(info);
+	free_pages((unsigned long)data->vmem, get_order(data->vmem_size));
+release_fb:
+	framebuffer_release(info);
+	return err;
 }
 
 static int ssd1306_remove(struct i2c_client *client)
 {
-//	struct ssd1306_data *data = i2c_get_clientdata(client);
-	sysfs_remove_group(&client->dev.kobj, &ssd1306_attr_group);
+	struct ssd1306_data *data = i2c_get_clientdata(client);
+	struct fb_info *info = data->info;
+
+	unregister_framebuffer(info);
+	fb_deferred_io_cleanup(info);
+	mutex_lock(&data->lock);
+	s_data = data;
+	s_client = client;
+	ssd1306_displayOff();
+	mutex_unlock(&data->lock);
+	free_pages((unsigned long)data->vmem, get_order(data->vmem_size));
+	framebuffer_release(info);
 	return 0;
 }
 
@@ -240,7 +385,7 @@ static void __exit ssd1306_driver_exit(void)
 
 MODULE_LICENSE("Dual MIT/GPL");
 MODULE_AUTHOR("Aleksei Dynda <alexey.dynda@gmail.com>");
-MODULE_DESCRIPTION("ssd1306 oled control driver");
+MODULE_DESCRIPTION("ssd1306 oled framebuffer driver");
 
 module_init(ssd1306_driver_init);
 module_exit(ssd1306_driver_exit);
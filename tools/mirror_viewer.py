@@ -0,0 +1,155 @@
+#    MIT License
+#
+#    Copyright (c) 2018, Alexey Dynda
+#
+#    Permission is hereby granted, free of charge, to any person obtaining a copy
+#    of this software and associated documentation files (the "Software"), to deal
+#    in the Software without restriction, including without limitation the rights
+#    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#    copies of the Software, and to permit persons to whom the Software is
+#    furnished to do so, subject to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be included in all
+#    copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#    SOFTWARE.
+#
+###################################################################################
+# Shows display content, mirrored by ssd1306_mirrorAttach() over udp.
+# Framebuffer is updated only with received rectangles, so start viewer before
+# the device to see complete picture.
+#
+
+import socket
+import struct
+import sys
+
+HEADER = struct.Struct('<2sBBHHHHHIH')
+
+def print_help_and_exit():
+    print("Usage: mirror_viewer.py [args]")
+    print("args:")
+    print("      -p <N>    udp port to listen on (default: 8888)")
+    print("      -s <N>    scale of the window (default: 4)")
+    print("      -o <S>    do not open window, but write each update to ppm file")
+    print("Examples:")
+    print("   [show display of the device, attached with ssd1306_mirrorAttach(host, 8888, 1)]")
+    print("      mirror_viewer.py -p 8888")
+    exit(1)
+
+def decompress(data, count, unit):
+    out = bytearray()
+    i = 0
+    while i < len(data) and len(out) < count:
+        header = data[i]
+        i += 1
+        if header & 0x80:
+            out += data[i:i + unit] * ((header & 0x7F) + 1)
+            i += unit
+        else:
+            size = (header + 1) * unit
+            out += data[i:i + size]
+            i += size
+    return out[:count]
+
+class Framebuffer:
+    def __init__(self):
+        self.width = 0
+        self.height = 0
+        self.pixels = bytearray()
+
+    def resize(self, width, height):
+        if (width, height) != (self.width, self.height):
+            self.width = width
+            self.height = height
+            self.pixels = bytearray(width * height * 3)
+
+    def put(self, x, y, rgb):
+        if 0 <= x < self.width and 0 <= y < self.height:
+            i = (y * self.width + x) * 3
+            self.pixels[i:i + 3] = rgb
+
+    def apply(self, packet):
+        magic, bits, flags, width, height, bx, by, bw, offset, count = HEADER.unpack_from(packet)
+        if magic != b'SM' or not bw:
+            return False
+        self.resize(width, height)
+        data = decompress(packet[HEADER.size:], count, 2 if bits == 16 else 1)
+        if bits == 1:
+            # ssd1306 pages: each byte is 8 vertical pixels, pages follow each other
+            for n, value in enumerate(data, offset):
+                x = bx + n % bw
+                y = (by + n // bw) * 8
+                for bit in range(8):
+                    self.put(x, y + bit, b'\xff\xff\xff' if value & (1 << bit) else b'\x00\x00\x00')
+        elif bits == 8:
+            for n, value in enumerate(data, offset):
+                rgb = bytes(((value & 0xE0), (value & 0x1C) << 3, (value & 0x03) << 6))
+                self.put(bx + n % bw, by + n // bw, rgb)
+        else:
+            for n in range(len(data) // 2):
+                value = (data[2 * n] << 8) | data[2 * n + 1]
+                rgb = bytes(((value >> 8) & 0xF8, (value >> 3) & 0xFC, (value << 3) & 0xF8))
+                pixel = offset // 2 + n
+                self.put(bx + pixel % bw, by + pixel // bw, rgb)
+        return True
+
+    def ppm(self):
+        return b'P6\n%d %d\n255\n' % (self.width, self.height) + bytes(self.pixels)
+
+def main():
+    port = 8888
+    scale = 4
+    output = None
+    args = sys.argv[1:]
+    while args:
+        arg = args.pop(0)
+        if arg == '-p' and args:
+            port = int(args.pop(0))
+        elif arg == '-s' and args:
+            scale = int(args.pop(0))
+        elif arg == '-o' and args:
+            output = args.pop(0)
+        else:
+            print_help_and_exit()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(('', port))
+    fb = Framebuffer()
+
+    if output:
+        while True:
+            if fb.apply(sock.recv(65536)):
+                with open(output, 'wb') as f:
+                    f.write(fb.ppm())
+
+    import tkinter
+    root = tkinter.Tk()
+    root.title("ssd1306 mirror :%d" % port)
+    label = tkinter.Label(root)
+    label.pack()
+    sock.setblocking(False)
+
+    def poll():
+        updated = False
+        try:
+            while True:
+                updated = fb.apply(sock.recv(65536)) or updated
+        except BlockingIOError:
+            pass
+        if updated:
+            image = tkinter.PhotoImage(data=fb.ppm(), format='ppm').zoom(scale)
+            label.configure(image=image)
+            label.image = image
+        root.after(20, poll)
+
+    poll()
+    root.mainloop()
+
+main()
@@ -0,0 +1,49 @@
+# -*- coding: UTF-8 -*-
+#    MIT License
+#
+#    Copyright (c) 2019, Alexey Dynda
+#
+#    Permission is hereby granted, free of charge, to any person obtaining a copy
+#    of this software and associated documentation files (the "Software"), to deal
+#    in the Software without restriction, including without limitation the rights
+#    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#    copies of the Software, and to permit persons to whom the Software is
+#    furnished to do so, subject to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be included in all
+#    copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#    SOFTWARE.
+#
+###################################################################################
+# Reads bytes of C array from source file (LCDAssistant output, library headers).
+# Shared by bitmapcompress.py, bitmapdither.py and assetpack.py.
+#
+
+import re
+import sys
+
+def read_array(name, array=None):
+    """Returns list of bytes of C array. If array is None, the first array of the file is read."""
+    with open(name) as f:
+        source = f.read()
+    source = re.sub(r'/\*.*?\*/|//[^\n]*', '', source, flags=re.S)
+    start = 0
+    if array is not None:
+        match = re.search(r'\b%s\s*\[[^\]]*\]\s*=' % re.escape(array), source)
+        if match is None:
+            sys.stderr.write("Array %s is not found in %s\n" % (array, name))
+            exit(1)
+        start = match.end()
+    start = source.find('{', start)
+    end = source.find('}', start)
+    if start < 0 or end < 0:
+        sys.stderr.write("No C array found in %s\n" % name)
+        exit(1)
+    return [int(v, 0) & 0xFF for v in re.findall(r'0[xX][0-9a-fA-F]+|\d+', source[start + 1:end])]
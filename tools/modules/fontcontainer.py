@@ -30,6 +30,8 @@ class FontContainer:
     first_char = None
     name = " "
     face = None
+    # bits per pixel of char bitmaps: 1 for monochrome, 8 for anti-aliased sources
+    bpp = 1
     # Char list is for compatibility with old format
     _groups = []
 
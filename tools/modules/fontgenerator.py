@@ -29,12 +29,79 @@
 # Get fonts
 # wget https://ftp.gnu.org/gnu/freefont/freefont-ttf-20120503.zip
 
+import sys
+
 class Generator:
     source = None
+    # glyphs are stored row by row (rows format) instead of vertical 8-pixel columns
+    rows = False
+    # glyph pixels of rows format are RLE-compressed
+    rle = False
+    # bits per pixel of anti-aliased rows format (2 or 4), 0 for monochrome glyphs
+    alpha = 0
+    # set of chars to keep in the font, None to keep all chars of the source
+    subset = None
 
     def __init__(self, source):
         self.source = source
 
+    # converts source pixel to value of specified bits count
+    def _pixel(self, value, bits):
+        if self.source.bpp == 1:
+            return ((1 << bits) - 1) if value else 0
+        if self.source.bpp < bits:
+            return value << (bits - self.source.bpp)
+        return value >> (self.source.bpp - bits)
+
+    def _char_data(self, char, height):
+        bitmap = self.source.charBitmap(char)
+        width = len(bitmap[0])
+        data = []
+        if not self.rows:
+            for row in range((height + 7) / 8):
+                for x in range(width):
+                    byte = 0
+                    for i in range(8):
+                        y = row * 8 + i
+                        if y >= len(bitmap):
+                           break
+                        byte |= (self._pixel(bitmap[y][x], 1) << i)
+                    data.append( byte )
+            return data
+        pixels = []
+        for y in range(height):
+            for x in range(width):
+                pixels.append( self._pixel(bitmap[y][x], self.alpha if self.alpha else 1) )
+        if self.alpha:
+            # alpha values are packed without padding at the end of rows, MSB goes first
+            per_byte = 8 / self.alpha
+            for idx in range(0, len(pixels), per_byte):
+                byte = 0
+                for i in range(per_byte):
+                    if idx + i < len(pixels):
+                        byte |= pixels[idx + i] << (8 - self.alpha * (i + 1))
+                data.append( byte )
+            return data
+        if self.rle:
+            # RLE byte: pixel value in bit 7, run length - 1 (up to 128 pixels) in bits 0-6
+            idx = 0
+            while idx < len(pixels):
+                count = 1
+                while (idx + count < len(pixels)) and (count < 128) and \
+                      (pixels[idx + count] == pixels[idx]):
+                    count += 1
+                data.append( (pixels[idx] << 7) | (count - 1) )
+                idx += count
+            return data
+        # pixels are packed without padding at the end of rows, MSB goes first
+        for idx in range(0, len(pixels), 8):
+            byte = 0
+            for i in range(8):
+                if idx + i < len(pixels) and pixels[idx + i]:
+                    byte |= 0x80 >> i
+            data.append( byte )
+        return data
+
     def generate_fixed_old(self):
         self.source.expand_chars()
         print "extern const uint8_t %s[] PROGMEM;" % (self.source.name)
@@ -70,55 +137,137 @@ class Generator:
         print "#endif"
         print "};"
 
-    def generate_new_format(self):
+    def _group_size(self, chars):
+        # unicode record + jump table + block size + char data
+        size = 3 + len(chars) * 4 + 2
+        for char in chars:
+            bitmap = self.source.charBitmap(char)
+            height = len(bitmap)
+            while (height > 0) and (sum(bitmap[height -1]) == 0):
+                height -= 1
+            size += len(self._char_data(char, height))
+        return size
+
+    def generate_index(self):
+        # Index is unicode record with 0xFFFF start code, followed by
+        # sorted entries: start code(MSB,LSB)|count|record offset(3 bytes, MSB first)
+        entries = []
+        offset = 0
+        for group in range(self.source.groups_count()):
+            chars = self.source.get_group_chars(group)
+            entries.append( (ord(chars[0]), len(chars), offset) )
+            offset += self._group_size(chars)
+        entries.sort()
+        print "//  unicode index: marker(0xFFFF)|blocks count"
+        print "    0xFF, 0xFF, 0x%02X, // unicode index record" % (len(entries) & 0xFF)
+        for e in entries:
+            print "    0x%02X, 0x%02X, 0x%02X, 0x%02X, 0x%02X, 0x%02X, // block 0x%04X" % \
+                 ((e[0] >> 8) & 0xFF, e[0] & 0xFF, e[1] & 0xFF, \
+                  (e[2] >> 16) & 0xFF, (e[2] >> 8) & 0xFF, e[2] & 0xFF, e[0])
+        return 3 + len(entries) * 6
+
+    # splits sorted chars to subset blocks: each block has up to 254 chars and
+    # remap table of up to 255 bytes, long gaps between chars start new block
+    def _subset_blocks(self, chars):
+        blocks = []
+        for char in chars:
+            if len(blocks) > 0:
+                block = blocks[-1]
+                if (ord(char) - ord(block[-1]) <= 8) and (ord(char) - ord(block[0]) < 255) \
+                   and (len(block) < 254):
+                    block.append( char )
+                    continue
+            blocks.append( [char] )
+        return blocks
+
+    def _subset_chars(self):
+        chars = []
+        for char in sorted(set(self.source.get_group_chars())):
+            if char in self.subset:
+                chars.append( char )
+        for char in sorted(self.subset):
+            if char not in chars:
+                sys.stderr.write("Warning: char 0x%04X is not found in the font\n" % ord(char))
+        return chars
+
+    def _print_block(self, chars):
+        size = 0
+        # jump table
+        offset = 0
+        heights = []
+        for char in chars:
+            bitmap = self.source.charBitmap(char)
+            print "   ",
+            width = len(bitmap[0])
+            height = len(bitmap)
+            while (height > 0) and (sum(bitmap[height -1]) == 0):
+                height -= 1
+            heights.append( height )
+            size += 4
+            print "0x%02X, 0x%02X, 0x%02X, 0x%02X," % (offset >> 8, offset & 0xFF, width, height),
+            print "// char '%s' (0x%04X/%d)" % (char.encode("utf-8"), ord(char), ord(char))
+            offset += len(self._char_data(char, height))
+        size += 2
+        print "    0x%02X, 0x%02X," % (offset >> 8, offset & 0xFF)
+        # char data
+        for index in range(len(chars)):
+            char = chars[index]
+            print "   ",
+            for data in self._char_data(char, heights[index]):
+                size += 1
+                print "0x%02X," % data,
+            print "// char '%s' (0x%04X/%d)" % (char.encode("utf-8"), ord(char), ord(char))
+        return size
+
+    def _print_subset(self):
+        size = 0
+        for chars in self._subset_blocks( self._subset_chars() ):
+            first = ord(chars[0])
+            span = ord(chars[-1]) - first + 1
+            size += 6 + span
+            print "// SUBSET first '%s' total %d chars" % (chars[0].encode("utf-8"), len(chars))
+            print "//  marker(0xFFFE)|count|first unicode(MSB,LSB)|span"
+            print "    0xFF, 0xFE, 0x%02X, 0x%02X, 0x%02X, 0x%02X," % \
+                 (len(chars), (first >> 8) & 0xFF, first & 0xFF, span)
+            print "//  remap table"
+            remap = [0xFF] * span
+            for index in range(len(chars)):
+                remap[ord(chars[index]) - first] = index
+            for idx in range(0, span, 16):
+                print "    " + " ".join("0x%02X," % x for x in remap[idx:idx + 16])
+            size += self._print_block( chars )
+        return size
+
+    def generate_new_format(self, with_index = False):
         total_size = 4
         self.source.expand_chars_top()
-        print "extern const uint8_t %s[] PROGMEM;" % ("free_" + self.source.name)
-        print "const uint8_t %s[] PROGMEM =" % ("free_" + self.source.name)
+        if self.alpha:
+            name = "aa%d_" % (self.alpha) + self.source.name
+            font_type = 7 if self.alpha == 4 else 6
+        elif self.rows:
+            name = "rows_" + self.source.name
+            font_type = 5 if self.rle else 4
+        else:
+            name = "free_" + self.source.name
+            font_type = 2
+        print "extern const uint8_t %s[] PROGMEM;" % (name)
+        print "const uint8_t %s[] PROGMEM =" % (name)
         print "{"
         print "//  type|width|height|first char"
-        print "    0x%02X, 0x%02X, 0x%02X, 0x%02X," % (2, self.source.width, self.source.height, 0x00)
-        for group in range(self.source.groups_count()):
-            chars = self.source.get_group_chars(group)
-            total_size += 3
-            print "// GROUP first '%s' total %d chars" % (chars[0].encode("utf-8"), len(chars))
-            print "//  unicode(LSB,MSB)|count"
-            print "    0x%02X, 0x%02X, 0x%02X, // unicode record" % \
-                 ((ord(chars[0]) >> 8) & 0xFF, ord(chars[0]) & 0xFF, len(chars) & 0xFF)
-            # jump table
-            offset = 0
-            heights = []
-            for char in chars:
-                bitmap = self.source.charBitmap(char)
-                print "   ",
-                width = len(bitmap[0])
-                height = len(bitmap)
-                while (height > 0) and (sum(bitmap[height -1]) == 0):
-                    height -= 1
-                heights.append( height )
-                size = ((height + 7) / 8) * width
-                total_size += 4
-                print "0x%02X, 0x%02X, 0x%02X, 0x%02X," % (offset >> 8, offset & 0xFF, width, height),
-                print "// char '%s' (0x%04X/%d)" % (char.encode("utf-8"), ord(char), ord(char))
-                offset += size
-            total_size += 2
-            print "    0x%02X, 0x%02X," % (offset >> 8, offset % 0xFF)
-            # char data
-            for index in range(len(chars)):
-                char = chars[index]
-                bitmap = self.source.charBitmap(char)
-                print "   ",
-                for row in range((heights[index] + 7) / 8):
-                    for x in range(len(bitmap[0])):
-                        data = 0
-                        for i in range(8):
-                            y = row * 8 + i
-                            if y >= len(bitmap):
-                               break
-                            data |= (self.source.charBitmap(char)[y][x] << i)
-                        total_size += 1
-                        print "0x%02X," % data,
-                print "// char '%s' (0x%04X/%d)" % (char.encode("utf-8"), ord(char), ord(char))
+        print "    0x%02X, 0x%02X, 0x%02X, 0x%02X," % (font_type, self.source.width, self.source.height, 0x00)
+        if self.subset is not None:
+            total_size += self._print_subset()
+        else:
+            if with_index:
+                total_size += self.generate_index()
+            for group in range(self.source.groups_count()):
+                chars = self.source.get_group_chars(group)
+                total_size += 3
+                print "// GROUP first '%s' total %d chars" % (chars[0].encode("utf-8"), len(chars))
+                print "//  unicode(LSB,MSB)|count"
+                print "    0x%02X, 0x%02X, 0x%02X, // unicode record" % \
+                     ((ord(chars[0]) >> 8) & 0xFF, ord(chars[0]) & 0xFF, len(chars) & 0xFF)
+                total_size += self._print_block( chars )
         total_size += 3
         print "    0x00, 0x00, 0x00, // end of unicode tables"
         print "    // FONT REQUIRES %d BYTES" % (total_size)
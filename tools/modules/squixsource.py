@@ -0,0 +1,86 @@
+# -*- coding: UTF-8 -*-
+#    MIT License
+#
+#    Copyright (c) 2018, Alexey Dynda
+#
+#    Permission is hereby granted, free of charge, to any person obtaining a copy
+#    of this software and associated documentation files (the "Software"), to deal
+#    in the Software without restriction, including without limitation the rights
+#    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#    copies of the Software, and to permit persons to whom the Software is
+#    furnished to do so, subject to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be included in all
+#    copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#    SOFTWARE.
+#
+###################################################################################
+# Fixed font converter for GLCD Creator fonts to internal ssd1306 format
+#
+# Squix (ThingPulse OLEDDisplay) font converter to internal ssd1306 format
+#
+# Squix font: WIDTH|HEIGHT|FIRSTCHAR|COUNT, jump table of
+# OFFSET(MSB)|OFFSET(LSB)|BYTES|ADVANCE and glyph data, stored column by
+# column ((HEIGHT+7)/8 bytes per column, trailing empty columns are cut off).
+#
+
+import re
+import codecs
+import fontcontainer
+
+class SquixSource(fontcontainer.FontContainer):
+
+    def __init__(self, filename, size, enc):
+        fontcontainer.FontContainer.__init__(self, filename, size)
+        with codecs.open(filename,'r',encoding=enc) as f:
+            content = f.read()
+
+        m = re.search(r'(\w+)\s*\[\s*\]', content)
+        if m is not None:
+            self._origin_name = "%s" % (m.group(1))
+        # Remove comments and take only array initializer
+        content = re.sub(r'//.*', '', content)
+        content = re.sub(r'/\*.*?\*/', '', content, flags=re.S)
+        start = content.find('{')
+        if start < 0:
+            print "Parsing error"
+            exit(1)
+        content = content[start + 1:content.find('}', start)]
+        data = [int(e, 0) for e in re.findall(r'0[xX][0-9a-fA-F]+|\d+', content)]
+
+        height = data[1]
+        self.first_char = data[2]
+        count = data[3]
+        pages = (height + 7) / 8
+        glyphs = 4 + count * 4
+        self.add_group()
+        for i in range(count):
+            offset = (data[4 + i * 4] << 8) | data[5 + i * 4]
+            size = data[6 + i * 4]
+            advance = data[7 + i * 4]
+            if offset == 0xFFFF:
+                size = 0
+            columns = (size + pages - 1) / pages
+            # ssd1306 library adds 1 pixel after each glyph
+            width = max([columns, advance - 1, 1])
+            bitmap = []
+            for y in range(height):
+                bitmap.append( [] )
+                for x in range(width):
+                    index = x * pages + y / 8
+                    if index < size:
+                        bitmap[y].append( (data[glyphs + offset + index] >> (y % 8)) & 0x01 )
+                    else:
+                        bitmap[y].append( 0 )
+            self.add_char(0, unichr(self.first_char + i), source=data[glyphs + offset:glyphs + offset + size],\
+                                   bitmap=bitmap,\
+                                   width=width,\
+                                   height=height)
+        self._commit_updates()
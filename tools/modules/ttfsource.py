@@ -38,9 +38,12 @@ class TTFSource(fontcontainer.FontContainer):
 
     # filename - name of TTF font file (full path is supported)
     # size - size of font (not pixels)
-    def __init__(self, filename, size):
+    # antialiasing - render 8-bit grayscale bitmaps instead of monochrome ones
+    def __init__(self, filename, size, antialiasing = False):
         fontname = os.path.basename(os.path.splitext(filename)[0])
         fontcontainer.FontContainer.__init__(self, fontname, size)
+        if antialiasing:
+            self.bpp = 8
         self.face = freetype.Face( filename )
         self.face.set_char_size( width=0, height=(size << 6), hres=96, vres=96 )
 
@@ -54,12 +57,18 @@ class TTFSource(fontcontainer.FontContainer):
         self._commit_updates()
 
     def __add_char(self, group_index, ch):
-        self.face.load_char(ch, freetype.FT_LOAD_MONOCHROME | freetype.FT_LOAD_RENDER )
+        if self.bpp == 8:
+            self.face.load_char(ch, freetype.FT_LOAD_RENDER )
+        else:
+            self.face.load_char(ch, freetype.FT_LOAD_MONOCHROME | freetype.FT_LOAD_RENDER )
         bitmap = self.face.glyph.bitmap
         bitmap_data = []
         for y in range( bitmap.rows ):
             bitmap_data.append( [] )
             for x in range( bitmap.width ):
+                if self.bpp == 8:
+                    bitmap_data[y].append( bitmap.buffer[ y * bitmap.pitch + x ] )
+                    continue
                 b_index = y * bitmap.pitch + x / 8
                 bit = 7 - (x % 8)
                 bit_data = (bitmap.buffer[ b_index ] >> bit) & 1
@@ -29,6 +29,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static volatile sig_atomic_t s_stop = 0;
 
 
 int init_interface(char *intf, char *bus, char *devId)
@@ -39,7 +45,7 @@ int init_interface(char *intf, char *bus, char *devId)
     }
     else if (!strcmp(intf, "i2c"))
     {
-        ssd1306_platform_i2cInit(bus[0] - '0', strtol(devId, NULL, 16), -1);
+        ssd1306_platform_i2cInit(bus[0] - '0', strtol(devId, NULL, 16), NULL);
 //        ssd1306_i2cInitEx(bus[0] - '0', bus[0] - '0', strtol(devId, NULL, 16));
     }
     else
@@ -52,7 +58,15 @@ int init_interface(char *intf, char *bus, char *devId)
 int init_driver(char *driver)
 {
     if (!strcmp(driver, "ssd1306_128x64")) ssd1306_128x64_init();
+    else if (!strcmp(driver, "ssd1306_128x32")) ssd1306_128x32_init();
+    else if (!strcmp(driver, "sh1106_128x64")) sh1106_128x64_init();
+    else if (!strcmp(driver, "ssd1351_128x128")) ssd1351_128x128_init();
+    else if (!strcmp(driver, "il9163_128x128")) il9163_128x128_init();
+    else if (!strcmp(driver, "st7735_128x160")) st7735_128x160_init();
+    else if (!strcmp(driver, "ili9341_240x320")) ili9341_240x320_init();
     else return -1;
+    /* Commands use monochrome functions, so color displays are switched to compatible mode */
+    if (ssd1306_lcd.send_pixels_buffer16) ssd1306_setMode(LCD_MODE_SSD1306_COMPAT);
     ssd1306_fillScreen(0x00);
     ssd1306_setFixedFont(ssd1306xled_font6x8);
     ssd1306_printFixed (0,  8, "ssd1306 library", STYLE_NORMAL);
@@ -128,34 +142,473 @@ uint8_t *atoi_b(char *str)
 }
 
 
-int execute_mono_cmd(int argc, char *argv[])
+/* Last pushed frame: display pages (bpp 1) or RGB565 pixels (bpp 16), bpp 0 if unknown */
+static uint8_t *s_shadow = NULL;
+static int s_shadow_bpp = 0;
+
+int read_exact(FILE *in, uint8_t *buffer, size_t size)
+{
+    return fread(buffer, 1, size, in) == size ? 0 : -1;
+}
+
+int read_pbm_field(FILE *in)
+{
+    int ch = fgetc(in);
+    while (ch == '#' || ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n')
+    {
+        if (ch == '#') while (ch != '\n' && ch != EOF) ch = fgetc(in);
+        ch = fgetc(in);
+    }
+    int value = -1;
+    while (ch >= '0' && ch <= '9')
+    {
+        value = (value < 0 ? 0 : value * 10) + ch - '0';
+        ch = fgetc(in);
+    }
+    /* Single whitespace after the last header field is consumed here */
+    return value;
+}
+
+/* Reads binary PBM (P4) image of display size, set pixels (1) are lit, and converts it to pages */
+int read_pbm(FILE *in, uint8_t *pages, lcduint_t w, lcduint_t h)
+{
+    if (fgetc(in) != 'P' || fgetc(in) != '4' || read_pbm_field(in) != w || read_pbm_field(in) != h)
+    {
+        return -1;
+    }
+    size_t pitch = (w + 7) >> 3;
+    uint8_t row[64];
+    if (pitch > sizeof(row))
+    {
+        return -1;
+    }
+    memset(pages, 0, (size_t)w * (h >> 3));
+    for (lcduint_t y = 0; y < h; y++)
+    {
+        if (read_exact(in, row, pitch) < 0)
+        {
+            return -1;
+        }
+        for (lcduint_t x = 0; x < w; x++)
+        {
+            if (row[x >> 3] & (0x80 >> (x & 7))) pages[(y >> 3) * w + x] |= 1 << (y & 7);
+        }
+    }
+    return 0;
+}
+
+/* Sends only changed part of each display page */
+void push_mono(const uint8_t *pages, lcduint_t w, lcduint_t h)
+{
+    const uint8_t *last = s_shadow_bpp == 1 ? s_shadow : NULL;
+    for (lcduint_t page = 0; page < (h >> 3); page++)
+    {
+        const uint8_t *src = &pages[page * w];
+        lcdint_t x0 = 0;
+        lcdint_t x1 = w - 1;
+        if (last)
+        {
+            while (x0 < w && src[x0] == last[page * w + x0]) x0++;
+            if (x0 == w) continue;
+            while (src[x1] == last[page * w + x1]) x1--;
+        }
+        ssd1306_lcd.set_block(x0, page, x1 - x0 + 1);
+        ssd1306_lcd.send_pixels_buffer1(&src[x0], x1 - x0 + 1);
+        ssd1306_intf.stop();
+    }
+    memcpy(s_shadow, pages, (size_t)w * (h >> 3));
+    s_shadow_bpp = 1;
+}
+
+/* Sends changed windows of RGB565 frame: columns range of each band of 8 rows */
+void push_rgb565(const uint8_t *pixels, lcduint_t w, lcduint_t h)
+{
+    const uint8_t *last = s_shadow_bpp == 16 ? s_shadow : NULL;
+    ssd1306_setMode(LCD_MODE_NORMAL);
+    for (lcduint_t y0 = 0; y0 < h; y0 += 8)
+    {
+        lcduint_t y1 = y0 + 8 < h ? y0 + 8 : h;
+        lcdint_t x0 = last ? w : 0;
+        lcdint_t x1 = last ? -1 : w - 1;
+        for (lcduint_t y = y0; last && y < y1; y++)
+        {
+            const uint16_t *src = (const uint16_t *)&pixels[(size_t)y * w * 2];
+            const uint16_t *old = (const uint16_t *)&last[(size_t)y * w * 2];
+            lcdint_t l = 0;
+            lcdint_t r = w - 1;
+            while (l < w && src[l] == old[l]) l++;
+            if (l == w) continue;
+            while (src[r] == old[r]) r--;
+            if (l < x0) x0 = l;
+            if (r > x1) x1 = r;
+        }
+        if (x1 < x0) continue;
+        ssd1306_lcd.set_block(x0, y0, x1 - x0 + 1);
+        for (lcduint_t y = y0; y < y1; y++)
+        {
+            ssd1306_lcd.send_pixels_buffer16(&pixels[((size_t)y * w + x0) * 2], x1 - x0 + 1);
+        }
+        ssd1306_intf.stop();
+    }
+    ssd1306_setMode(LCD_MODE_SSD1306_COMPAT);
+    memcpy(s_shadow, pixels, (size_t)w * h * 2);
+    s_shadow_bpp = 16;
+}
+
+/*
+ * Reads frame from file, given as argument, or from the session input and sends
+ * its changes to the display. Format: 1 - raw pages, 2 - PBM, 16 - raw RGB565 (MSB first)
+ */
+int push_frame(int argc, char *argv[], FILE *in, int format)
+{
+    lcduint_t w = ssd1306_displayWidth();
+    lcduint_t h = ssd1306_displayHeight();
+    size_t size = (size_t)w * h * 2;
+    static uint8_t *buffer = NULL;
+    if (!buffer)
+    {
+        buffer = (uint8_t *)malloc(size);
+        s_shadow = (uint8_t *)malloc(size);
+        if (!buffer || !s_shadow) return -1;
+    }
+    if (format == 16 && !ssd1306_lcd.send_pixels_buffer16)
+    {
+        return -1;
+    }
+    FILE *file = argc > 1 ? fopen(argv[1], "rb") : in;
+    if (!file)
+    {
+        return -1;
+    }
+    int result;
+    switch (format)
+    {
+        case 1: result = read_exact(file, buffer, (size_t)w * (h >> 3)); break;
+        case 2: result = read_pbm(file, buffer, w, h); break;
+        default: result = read_exact(file, buffer, size); break;
+    }
+    if (file != in)
+    {
+        fclose(file);
+    }
+    if (result < 0)
+    {
+        return -1;
+    }
+    if (format == 16) push_rgb565(buffer, w, h);
+    else push_mono(buffer, w, h);
+    return 0;
+}
+
+/* One iteration of benchmark pattern */
+typedef void (*bench_step_t)(const uint8_t *chunk, uint16_t size);
+
+/* Runs pattern for given time, returns number of iterations and spent time in microseconds */
+uint32_t run_pattern(bench_step_t step, const uint8_t *chunk, uint16_t size, uint32_t duration, uint32_t *us)
+{
+    uint32_t count = 0;
+    uint32_t start = micros();
+    do
+    {
+        step(chunk, size);
+        count++;
+        *us = micros() - start;
+    }
+    while (*us < duration);
+    return count;
+}
+
+void bench_stream(const uint8_t *chunk, uint16_t size)
+{
+    ssd1306_intf.send_buffer(chunk, size);
+}
+
+void bench_chunk(const uint8_t *chunk, uint16_t size)
+{
+    ssd1306_lcd.set_block(0, 0, 0);
+    ssd1306_intf.send_buffer(chunk, size);
+    ssd1306_intf.stop();
+}
+
+void bench_set_block(const uint8_t *chunk, uint16_t size)
+{
+    ssd1306_lcd.set_block(0, 0, 0);
+    ssd1306_intf.stop();
+}
+
+/* Sends whole screen in native format of the display, chunk holds one page or one row */
+void bench_frame(const uint8_t *chunk, uint16_t size)
+{
+    lcduint_t w = ssd1306_displayWidth();
+    lcduint_t h = ssd1306_displayHeight();
+    if (ssd1306_lcd.send_pixels_buffer16)
+    {
+        ssd1306_lcd.set_block(0, 0, w);
+        for (lcduint_t y = 0; y < h; y++) ssd1306_lcd.send_pixels_buffer16(chunk, w);
+        ssd1306_intf.stop();
+        return;
+    }
+    for (lcduint_t page = 0; page < (h >> 3); page++)
+    {
+        ssd1306_lcd.set_block(0, page, w);
+        ssd1306_lcd.send_pixels_buffer1(chunk, w);
+        ssd1306_intf.stop();
+    }
+}
+
+/*
+ * Measures real throughput of the interface: one long data stream, the same data split
+ * to transactions of chunk size, set_block() transactions without data and full frames.
+ * Per-transaction overhead is time of chunk transaction, not explained by stream throughput.
+ */
+int run_bench(int argc, char *argv[], FILE *out)
+{
+    static uint8_t chunk[4096];
+    uint32_t duration = (argc > 1 ? atoi_(argv[1]) : 1000) * 1000;
+    uint16_t size = argc > 2 ? atoi_(argv[2]) : 256;
+    lcduint_t w = ssd1306_displayWidth();
+    if (!duration || !size || size > sizeof(chunk) || w * 2 > sizeof(chunk))
+    {
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(chunk); i++) chunk[i] = i & 1 ? 0xAA : 0x55;
+    uint32_t us;
+    uint32_t count;
+    s_shadow_bpp = 0;
+    if (ssd1306_lcd.send_pixels_buffer16) ssd1306_setMode(LCD_MODE_NORMAL);
+
+    ssd1306_lcd.set_block(0, 0, 0);
+    count = run_pattern(bench_stream, chunk, size, duration, &us);
+    ssd1306_intf.stop();
+    double stream = (double)count * size * 1000000 / us;
+    fprintf(out, "stream:    %.0f bytes/s (%u byte chunks)\n", stream, size);
+
+    count = run_pattern(bench_chunk, chunk, size, duration, &us);
+    double rate = (double)count * 1000000 / us;
+    fprintf(out, "chunks:    %.0f transactions/s, %.0f bytes/s, overhead %.1f us per transaction\n",
+            rate, rate * size, 1000000 / rate - size * 1000000 / stream);
+
+    count = run_pattern(bench_set_block, chunk, size, duration, &us);
+    fprintf(out, "set_block: %.0f transactions/s, %.1f us each\n", (double)count * 1000000 / us, (double)us / count);
+
+    uint32_t frame = ssd1306_lcd.send_pixels_buffer16 ? (uint32_t)w * ssd1306_displayHeight() * 2
+                                                      : (uint32_t)w * (ssd1306_displayHeight() >> 3);
+    count = run_pattern(bench_frame, chunk, size, duration, &us);
+    fprintf(out, "frame:     %.1f frames/s, %.0f bytes/s (%u bytes per frame)\n",
+            (double)count * 1000000 / us, (double)count * frame * 1000000 / us, frame);
+    fflush(out);
+
+    if (ssd1306_lcd.send_pixels_buffer16) ssd1306_setMode(LCD_MODE_SSD1306_COMPAT);
+    ssd1306_clearScreen();
+    return 0;
+}
+
+/* Returns -1 for quit command, 1 for unknown command or bad arguments, 0 on success */
+int execute_mono_cmd(int argc, char *argv[], FILE *in, FILE *out)
 {
     if (!strcmp(argv[0], "quit")) return -1;
-    else if (!strcmp(argv[0], "clear"))
+    else if (!strcmp(argv[0], "frame"))
+        return push_frame(argc, argv, in, 1) < 0 ? 1 : 0;
+    else if (!strcmp(argv[0], "pbm"))
+        return push_frame(argc, argv, in, 2) < 0 ? 1 : 0;
+    else if (!strcmp(argv[0], "rgb565"))
+        return push_frame(argc, argv, in, 16) < 0 ? 1 : 0;
+    else if (!strcmp(argv[0], "bench"))
+        return run_bench(argc, argv, out) < 0 ? 1 : 0;
+    else if (!strcmp(argv[0], "sync"))
+    {
+        fprintf(out, "ok\n");
+        fflush(out);
+        return 0;
+    }
+    else if (argv[0][0] == '\0')
+        return 0;
+    /* Drawing commands change the display, so next frame is sent completely */
+    s_shadow_bpp = 0;
+    if (!strcmp(argv[0], "clear"))
         argc > 1 ? ssd1306_fillScreen(atoi_h(argv[1])) : ssd1306_clearScreen();
-    else if (!strcmp(argv[0], "rect"))
+    else if (!strcmp(argv[0], "rect") && argc > 4)
         ssd1306_drawRect(atoi_(argv[1]), atoi_(argv[2]), atoi_(argv[3]), atoi_(argv[4]));
-    else if (!strcmp(argv[0], "line"))
+    else if (!strcmp(argv[0], "line") && argc > 4)
         ssd1306_drawLine(atoi_(argv[1]), atoi_(argv[2]), atoi_(argv[3]), atoi_(argv[4]));
-    else if (!strcmp(argv[0], "bitmap"))
+    else if (!strcmp(argv[0], "bitmap") && argc > 5)
         gfx_drawMonoBitmap(atoi_(argv[1]), atoi_(argv[2]), atoi_(argv[3]), atoi_(argv[4]), atoi_b(argv[5]));
-    else if (argv[0][0] != '\0')
-        fprintf(stderr, "commands:\nclear [pattern]\nrect x1,y1,x2,y2\n"
-                        "line x1,y1,x2,y2\n"
-                        "bitmap x1,y1,width,height,bitmap_hex\n");
+    else
+        return 1;
     return 0;
 }
 
+void print_commands(FILE *out)
+{
+    fprintf(out, "commands:\nclear [pattern]\nrect x1,y1,x2,y2\n"
+                 "line x1,y1,x2,y2\n"
+                 "bitmap x1,y1,width,height,bitmap_hex\n"
+                 "frame [file] (raw page-format data, width*height/8 bytes)\n"
+                 "pbm [file] (binary PBM image of display size, 1 is lit pixel)\n"
+                 "rgb565 [file] (raw RGB565 pixels, MSB first, color displays only)\n"
+                 "  without file the frame data follow the command line;\n"
+                 "  only changed areas of the display are updated\n"
+                 "bench [ms] [chunk] (measures interface throughput, 1000 ms and 256 bytes by default)\n"
+                 "sync (replies ok, when all previous commands are executed)\n"
+                 "quit\n");
+}
+
+/* Executes commands until the end of input or quit command */
+int run_session(FILE *in, FILE *out)
+{
+    char str[16384];
+    while (fgets(str, sizeof str, in))
+    {
+        char* arg_list[128];
+        int result = execute_mono_cmd(get_args_list(str, &arg_list[0]), arg_list, in, out);
+        if (result < 0)
+        {
+            return -1;
+        }
+        if (result > 0)
+        {
+            fprintf(out, "error: %s\n", arg_list[0]);
+            print_commands(out);
+            fflush(out);
+        }
+    }
+    return 0;
+}
+
+static void on_signal(int sig)
+{
+    s_stop = 1;
+}
+
+int init_socket_addr(struct sockaddr_un *addr, const char *path)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path))
+    {
+        fprintf(stderr, "Socket path is too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr->sun_path, path);
+    return 0;
+}
+
+/* Keeps display open and executes commands of clients, connecting one by one to unix socket */
+int run_daemon(const char *path)
+{
+    struct sockaddr_un addr;
+    if (init_socket_addr(&addr, path) < 0)
+    {
+        return -1;
+    }
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0)
+    {
+        perror("socket");
+        return -1;
+    }
+    unlink(path);
+    if (bind(server, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(server, 8) < 0)
+    {
+        perror(path);
+        close(server);
+        return -1;
+    }
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    /* No SA_RESTART: accept() must return, when daemon is stopped */
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    fprintf(stderr, "Listening on %s\n", path);
+    while (!s_stop)
+    {
+        int client = accept(server, NULL, NULL);
+        if (client < 0)
+        {
+            continue;
+        }
+        FILE *in = fdopen(client, "r");
+        FILE *out = fdopen(dup(client), "w");
+        if (in && out)
+        {
+            run_session(in, out);
+        }
+        if (out) fclose(out);
+        if (in) fclose(in); else close(client);
+    }
+    close(server);
+    unlink(path);
+    return 0;
+}
+
+/* Sends stdin to the daemon and prints its replies */
+int run_client(const char *path)
+{
+    struct sockaddr_un addr;
+    if (init_socket_addr(&addr, path) < 0)
+    {
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        perror(path);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    char buffer[4096];
+    ssize_t len;
+    while ((len = read(STDIN_FILENO, buffer, sizeof(buffer))) > 0)
+    {
+        if (write(fd, buffer, len) != len)
+        {
+            perror(path);
+            close(fd);
+            return -1;
+        }
+    }
+    shutdown(fd, SHUT_WR);
+    while ((len = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        fwrite(buffer, 1, len, stdout);
+    }
+    close(fd);
+    return 0;
+}
+
+void print_usage(void)
+{
+    fprintf(stderr, "Usage: oled_cli [-d socket] [interface] [bus] [devId] [oled_driver]\n");
+    fprintf(stderr, "       oled_cli -c socket\n");
+    fprintf(stderr, "        -d socket     - run as daemon, accepting commands on unix socket\n");
+    fprintf(stderr, "        -c socket     - send commands from stdin to the daemon\n");
+    fprintf(stderr, "        interface     - spi, i2c\n");
+    fprintf(stderr, "        bus           - i2c-bus number or spidev  bus number\n");
+    fprintf(stderr, "        devId         - i2c-bus device address or spi device number in hex\n");
+    fprintf(stderr, "        oled_driver   - Oled driver name\n");
+    fprintf(stderr, "Example: oled_cli i2c 1 0x3c ssd1306_128x64\n");
+    fprintf(stderr, "         oled_cli -d /tmp/oled.sock i2c 1 0x3c ssd1306_128x64 &\n");
+    fprintf(stderr, "         printf 'clear\\nrect 0,0,127,63\\n' | oled_cli -c /tmp/oled.sock\n");
+}
+
 int main(int argc, char *argv[])
 {
+    const char *daemon = NULL;
+    if (argc == 3 && !strcmp(argv[1], "-c"))
+    {
+        return run_client(argv[2]) < 0 ? 1 : 0;
+    }
+    if (argc > 2 && !strcmp(argv[1], "-d"))
+    {
+        daemon = argv[2];
+        argc -= 2;
+        argv += 2;
+    }
     if (argc < 5)
     {
-        fprintf(stderr, "Usage: oled_cli [interface] [bus] [devId] [oled_driver]\n");
-        fprintf(stderr, "        interface     - spi, i2c\n");
-        fprintf(stderr, "        bus           - i2c-bus number or spidev  bus number\n");
-        fprintf(stderr, "        devId         - i2c-bus device address or spi device number in hex\n");
-        fprintf(stderr, "        oled_driver   - Oled driver name\n");
-        fprintf(stderr, "Example: oled_cli i2c 1 0x3c ssd1306_128x64\n");
+        print_usage();
         return 1;
     }
     if (init_interface(argv[1], argv[2], argv[3]) < 0)
@@ -168,17 +621,16 @@ int main(int argc, char *argv[])
         fprintf(stderr, "Error2\n");
         return 1;
     }
-    fprintf(stderr, "Enter command\n");
-    char str[16384];
-    while (fgets(str, sizeof str, stdin))
+    int result = 0;
+    if (daemon)
     {
-        char* arg_list[128];
-        if (execute_mono_cmd(get_args_list(str, &arg_list[0]), arg_list) < 0)
-        {
-            break;
-        }
+        result = run_daemon(daemon) < 0 ? 1 : 0;
+    }
+    else
+    {
+        fprintf(stderr, "Enter command\n");
+        run_session(stdin, stderr);
     }
     ssd1306_intf.close();
-    return 0;
+    return result;
 }
-
@@ -33,10 +33,13 @@
 #include "sdl_ili9341.h"
 #include "sdl_pcd8544.h"
 #include <unistd.h>
+#if !defined(SDL_HEADLESS)
 #include <SDL2/SDL.h>
+#endif
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/time.h>
 
 #define CANVAS_REFRESH_RATE  60
 
@@ -49,11 +52,26 @@ enum
 static int s_analogInput[128];
 static int s_digitalPins[128];
 static int s_dcPin = -1;
+/* 3-wire spi: D/C is the 9th bit of each word, bytes are unpacked to 9-bit words */
+static int s_spi3Wire = 0;
+static uint32_t s_spi3WireAcc;
+static int s_spi3WireBits;
 static uint8_t s_gpioKeys[6] = {0};
 
 static sdl_oled_info *p_oled_db[128] = { NULL };
 static sdl_oled_info *p_active_driver = NULL;
 
+/* Bus frequency in Hz, 0 if bus timing is not emulated */
+static uint32_t s_busFrequency = 0;
+static int s_busThrottle = 0;
+static uint64_t s_busBits = 0;
+static uint64_t s_busBytes = 0;
+static uint64_t s_busTransactions = 0;
+static uint64_t s_busStartUs = 0;
+
+static void sdl_bus_report(void);
+static void sdl_input_init(void);
+
 static void register_oled(sdl_oled_info *oled_info)
 {
     sdl_oled_info **p = p_oled_db;
@@ -72,8 +90,206 @@ void sdl_core_init(void)
     register_oled( &sdl_ili9341 );
     register_oled( &sdl_pcd8544 );
     sdl_graphics_init();
+    const char *frequency = getenv("SDL_BUS_FREQUENCY");
+    if (frequency && !s_busFrequency)
+    {
+        sdl_set_bus_timing(atoi(frequency), getenv("SDL_BUS_THROTTLE") != NULL);
+        atexit(sdl_bus_report);
+    }
+    sdl_input_init();
+}
+
+//////////////////////////////////////////////////////////////
+// Emulated keys, input recording and replay
+//////////////////////////////////////////////////////////////
+
+/* Keys use the same bits as NanoEngine buttons: down, left, right, up, A, B. *
+ * Z-keypad analog values and gpio keypad pin indexes for each key.          */
+static const int s_keyAnalog[6] = { 300, 500, 50, 150, 700, 1023 };
+static uint8_t s_keys = 0;
+
+static FILE *s_inputRecord = NULL;
+static FILE *s_inputReplay = NULL;
+static uint64_t s_inputStartUs = 0;
+/* Next replay event: time in milliseconds and keys state */
+static uint32_t s_replayTs = 0;
+static unsigned s_replayKeys = 0;
+
+/* Frame statistics, reported by NanoEngine */
+static int s_frameStats = 0;
+static uint32_t *s_frameUs = NULL;
+static uint32_t s_frames = 0;
+static uint32_t s_framesAllocated = 0;
+static uint64_t s_frameTiles = 0;
+static uint64_t s_frameBytes = 0;
+
+/* Checkpoint: number of delay() calls, after which display content is saved and emulator exits */
+static uint32_t s_delays = 0;
+static uint32_t s_exitDelays = 0;
+static const char *s_dumpFile = NULL;
+static int s_noDelay = 0;
+
+static uint64_t sdl_time_us(void);
+
+static uint32_t sdl_input_ts(void)
+{
+    return (sdl_time_us() - s_inputStartUs) / 1000;
+}
+
+static void sdl_set_keys(uint8_t keys)
+{
+    uint8_t changed = keys ^ s_keys;
+    for (int i = 0; i < 6; i++)
+    {
+        if (!(changed & (1 << i))) continue;
+        int pressed = (keys >> i) & 1;
+        if (i < 5) s_analogInput[0] = pressed ? s_keyAnalog[i] : 1023;
+        s_digitalPins[s_gpioKeys[i]] = pressed;
+    }
+    s_keys = keys;
+    if (s_inputRecord && changed)
+    {
+        fprintf(s_inputRecord, "%u %u\n", sdl_input_ts(), keys);
+    }
+}
+
+static int sdl_replay_next(void)
+{
+    return fscanf(s_inputReplay, "%u %u", &s_replayTs, &s_replayKeys) == 2;
+}
+
+static void sdl_replay_step(void)
+{
+    uint32_t ts = sdl_input_ts();
+    while (ts >= s_replayTs)
+    {
+        sdl_set_keys(s_replayKeys);
+        if (!sdl_replay_next())
+        {
+            /* The last line marks the end of the recorded session */
+            exit(0);
+        }
+    }
+}
+
+static int sdl_compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : (x > y);
+}
+
+static void sdl_frame_report(void)
+{
+    if (!s_frames)
+    {
+        fprintf(stderr, "Frames: none reported, %llu bytes sent in %u ms\n",
+                (unsigned long long)s_busBytes, sdl_input_ts());
+        return;
+    }
+    qsort(s_frameUs, s_frames, sizeof(uint32_t), sdl_compare_u32);
+    fprintf(stderr, "Frames: %u, frame time us min/p50/p90/p99/max: %u/%u/%u/%u/%u\n",
+            s_frames, s_frameUs[0], s_frameUs[s_frames / 2], s_frameUs[s_frames * 9 / 10],
+            s_frameUs[s_frames * 99 / 100], s_frameUs[s_frames - 1]);
+    fprintf(stderr, "Tiles per frame: %.1f, bytes per frame: %.1f, bytes total: %llu\n",
+            (double)s_frameTiles / s_frames, (double)s_frameBytes / s_frames,
+            (unsigned long long)s_busBytes);
+}
+
+static void sdl_record_close(void)
+{
+    /* End marker: session length and keys state */
+    fprintf(s_inputRecord, "%u %u\n", sdl_input_ts(), s_keys);
+    fclose(s_inputRecord);
+}
+
+static void sdl_input_init(void)
+{
+    if (s_inputStartUs)
+    {
+        return;
+    }
+    s_inputStartUs = sdl_time_us();
+    /* Z-keypad returns high level, if no key is pressed */
+    s_analogInput[0] = 1023;
+    const char *record = getenv("SDL_INPUT_RECORD");
+    const char *replay = getenv("SDL_INPUT_REPLAY");
+    if (record)
+    {
+        s_inputRecord = fopen(record, "w");
+        if (!s_inputRecord)
+        {
+            fprintf(stderr, "Failed to create %s\n", record);
+            exit(1);
+        }
+        atexit(sdl_record_close);
+    }
+    if (replay)
+    {
+        s_inputReplay = fopen(replay, "r");
+        if (!s_inputReplay || !sdl_replay_next())
+        {
+            fprintf(stderr, "Failed to read %s\n", replay);
+            exit(1);
+        }
+    }
+    const char *exitDelays = getenv("SDL_EXIT_AFTER_DELAYS");
+    s_exitDelays = exitDelays ? atoi(exitDelays) : 0;
+    s_dumpFile = getenv("SDL_DUMP_FRAME");
+    s_noDelay = getenv("SDL_NO_DELAY") != NULL;
+    if (s_exitDelays && !s_busFrequency)
+    {
+        /* Checkpoint reports bytes, which are counted only when bus timing is emulated */
+        sdl_set_bus_timing(400000, 0);
+    }
+    if (replay || getenv("SDL_FRAME_REPORT"))
+    {
+        s_frameStats = 1;
+        /* Bytes are counted only when bus timing is emulated */
+        if (!s_busFrequency)
+        {
+            sdl_set_bus_timing(400000, 0);
+        }
+        atexit(sdl_frame_report);
+    }
+}
+
+int sdl_core_frame_stats_enabled(void)
+{
+    return s_frameStats;
+}
+
+void sdl_core_frame_end(uint32_t frameUs, uint32_t tiles)
+{
+    static uint64_t lastBytes = 0;
+    if (!s_frameStats)
+    {
+        return;
+    }
+    if (s_frames >= s_framesAllocated)
+    {
+        s_framesAllocated = s_framesAllocated ? s_framesAllocated * 2 : 1024;
+        s_frameUs = realloc(s_frameUs, s_framesAllocated * sizeof(uint32_t));
+        if (!s_frameUs)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    s_frameUs[s_frames++] = frameUs;
+    s_frameTiles += tiles;
+    s_frameBytes += s_busBytes - lastBytes;
+    lastBytes = s_busBytes;
 }
 
+#if defined(SDL_HEADLESS)
+
+static void sdl_poll_event(void)
+{
+}
+
+#else
+
 static void sdl_poll_event(void)
 {
     SDL_Event event;
@@ -83,29 +299,39 @@ static void sdl_poll_event(void)
         switch (event.type)
         {
             case SDL_KEYDOWN:
-                if (event.key.keysym.scancode == SDL_SCANCODE_DOWN)  { s_analogInput[0] = 300; s_digitalPins[s_gpioKeys[0]] = 1; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_UP)    { s_analogInput[0] = 150; s_digitalPins[s_gpioKeys[3]] = 1; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_LEFT)  { s_analogInput[0] = 500; s_digitalPins[s_gpioKeys[1]] = 1; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_RIGHT) { s_analogInput[0] = 50;  s_digitalPins[s_gpioKeys[2]] = 1; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_SPACE) { s_analogInput[0] = 700; s_digitalPins[s_gpioKeys[4]] = 1; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_Z) { s_analogInput[0] = 700; s_digitalPins[s_gpioKeys[4]] = 1; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_X) { s_digitalPins[s_gpioKeys[5]] = 1; }
-                break;
             case SDL_KEYUP:
-                if (event.key.keysym.scancode == SDL_SCANCODE_DOWN)  { s_analogInput[0] = 1023; s_digitalPins[s_gpioKeys[0]] = 0; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_UP)    { s_analogInput[0] = 1023; s_digitalPins[s_gpioKeys[3]] = 0; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_LEFT)  { s_analogInput[0] = 1023; s_digitalPins[s_gpioKeys[1]] = 0; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_RIGHT) { s_analogInput[0] = 1023;  s_digitalPins[s_gpioKeys[2]] = 0; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_SPACE) { s_analogInput[0] = 1023; s_digitalPins[s_gpioKeys[4]] = 0; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_Z) { s_analogInput[0] = 1023; s_digitalPins[s_gpioKeys[4]] = 0; }
-                if (event.key.keysym.scancode == SDL_SCANCODE_X) { s_digitalPins[s_gpioKeys[5]] = 0; }
+            {
+                uint8_t key = 0;
+                switch (event.key.keysym.scancode)
+                {
+                    case SDL_SCANCODE_DOWN:  key = 0x01; break;
+                    case SDL_SCANCODE_LEFT:  key = 0x02; break;
+                    case SDL_SCANCODE_RIGHT: key = 0x04; break;
+                    case SDL_SCANCODE_UP:    key = 0x08; break;
+                    case SDL_SCANCODE_SPACE:
+                    case SDL_SCANCODE_Z:     key = 0x10; break;
+                    case SDL_SCANCODE_X:     key = 0x20; break;
+                    default: break;
+                }
+                if (key)
+                {
+                    sdl_set_keys(event.type == SDL_KEYDOWN ? (s_keys | key) : (s_keys & ~key));
+                }
                 break;
+            }
             default:
                 break;
         };
     }
 }
 
+#endif
+
+void sdl_set_spi_3wire(int enable)
+{
+    s_spi3Wire = enable;
+}
+
 void sdl_set_dc_pin(int pin)
 {
     s_dcPin = pin;
@@ -118,7 +344,8 @@ void sdl_set_gpio_keys(const uint8_t * pins)
 
 int sdl_read_analog(int pin)
 {
-    sdl_poll_event();
+    if (s_inputReplay) sdl_replay_step();
+    if (sdl_graphics_refresh()) sdl_poll_event();
     return s_analogInput[pin];
 }
 
@@ -129,29 +356,199 @@ void sdl_write_digital(int pin, int value)
 
 int sdl_read_digital(int pin)
 {
+    if (s_inputReplay) sdl_replay_step();
+    if (sdl_graphics_refresh()) sdl_poll_event();
     return s_digitalPins[pin];
 }
 
+void sdl_core_set_heatmap(const uint8_t *counters, int cols, int rows, int stride,
+                          int tileWidth, int tileHeight)
+{
+    sdl_graphics_set_heatmap(counters, cols, rows, stride, tileWidth, tileHeight);
+}
+
+void sdl_core_flush(void)
+{
+    sdl_graphics_flush();
+}
+
+void sdl_core_delay(uint32_t ms)
+{
+    sdl_graphics_flush();
+    /* Demos draw a step and wait, so delay() calls are stable points to compare display content */
+    if (s_exitDelays && ++s_delays >= s_exitDelays)
+    {
+        fprintf(stderr, "Checkpoint: %u delays, %llu bytes, %llu transactions, %llu us\n",
+                s_delays, (unsigned long long)s_busBytes, (unsigned long long)s_busTransactions,
+                (unsigned long long)(sdl_time_us() - s_inputStartUs));
+        if (s_dumpFile && sdl_core_dump_frame(s_dumpFile) < 0)
+        {
+            exit(1);
+        }
+        exit(0);
+    }
+    if (!s_noDelay)
+    {
+        usleep(ms * 1000);
+    }
+}
+
 void sdl_core_close(void)
 {
     sdl_graphics_close();
+#if !defined(SDL_HEADLESS)
     SDL_Quit();
+#endif
+}
+
+static void sdl_pixel_to_rgb(uint32_t pixel, int bpp, uint8_t *rgb)
+{
+    switch (bpp)
+    {
+        case 8: // RGB332
+            rgb[0] = pixel & 0xE0;
+            rgb[1] = (pixel << 3) & 0xE0;
+            rgb[2] = (pixel << 6) & 0xC0;
+            break;
+        case 16: // RGB565
+            rgb[0] = (pixel >> 8) & 0xF8;
+            rgb[1] = (pixel >> 3) & 0xFC;
+            rgb[2] = (pixel << 3) & 0xF8;
+            break;
+        default: // RGBX8888
+            rgb[0] = pixel >> 24;
+            rgb[1] = pixel >> 16;
+            rgb[2] = pixel >> 8;
+            break;
+    }
+}
+
+int sdl_core_dump_frame(const char *filename)
+{
+    if (!p_active_driver)
+    {
+        return -1;
+    }
+    FILE *f = fopen(filename, "wb");
+    if (!f)
+    {
+        fprintf(stderr, "Failed to open %s\n", filename);
+        return -1;
+    }
+    int width = p_active_driver->width;
+    int height = p_active_driver->height;
+    size_t len = strlen(filename);
+    if ((len > 4) && !strcmp(&filename[len - 4], ".pbm"))
+    {
+        fprintf(f, "P4\n%d %d\n", width, height);
+        for (int y = 0; y < height; y++)
+        {
+            uint8_t bits = 0;
+            for (int x = 0; x < width; x++)
+            {
+                if (sdl_get_pixel(x, y)) bits |= 0x80 >> (x & 7);
+                if (((x & 7) == 7) || (x == width - 1))
+                {
+                    fputc(bits, f);
+                    bits = 0;
+                }
+            }
+        }
+    }
+    else
+    {
+        fprintf(f, "P6\n%d %d\n255\n", width, height);
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                uint8_t rgb[3];
+                sdl_pixel_to_rgb(sdl_get_pixel(x, y), p_active_driver->bpp, rgb);
+                fwrite(rgb, 1, sizeof(rgb), f);
+            }
+        }
+    }
+    fclose(f);
+    return 0;
 }
 
 //////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////
 
+static uint64_t sdl_time_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+void sdl_set_bus_timing(uint32_t frequency, int throttle)
+{
+    s_busFrequency = frequency;
+    s_busThrottle = throttle;
+    s_busBits = 0;
+    s_busBytes = 0;
+    s_busTransactions = 0;
+    s_busStartUs = sdl_time_us();
+}
+
+uint64_t sdl_get_bus_time_us(void)
+{
+    return s_busFrequency ? s_busBits * 1000000 / s_busFrequency : 0;
+}
+
+static void sdl_bus_report(void)
+{
+    fprintf(stderr, "Bus %s at %u Hz: %llu transactions, %llu bytes, %llu bits, %llu us\n",
+            s_spi3Wire ? "3-wire spi" : s_dcPin >= 0 ? "spi" : "i2c", s_busFrequency,
+            (unsigned long long)s_busTransactions, (unsigned long long)s_busBytes,
+            (unsigned long long)s_busBits, (unsigned long long)sdl_get_bus_time_us());
+}
+
+/*
+ * i2c byte takes 9 clocks (8 data bits and ack), transaction adds start condition,
+ * address byte and stop condition. spi byte takes 8 clocks.
+ */
+static inline void sdl_bus_bytes(uint32_t count)
+{
+    s_busBytes += count;
+    s_busBits += (uint64_t)count * ((s_dcPin >= 0 || s_spi3Wire) ? 8 : 9);
+}
+
+static void sdl_bus_throttle(void)
+{
+    uint64_t emulated = s_busStartUs + sdl_get_bus_time_us();
+    uint64_t now = sdl_time_us();
+    if (emulated > now)
+    {
+        usleep(emulated - now);
+    }
+}
+
 int s_commandId = SSD_COMMAND_NONE;
 int s_cmdArgIndex;
 static int s_ssdMode = SSD_MODE_NONE;
 static sdl_data_mode s_active_data_mode = SDM_COMMAND_ARG;
 
 static int s_oled = SDL_AUTODETECT;
+/* Set by i2c control byte with Co bit: next byte is followed by another control byte */
+static uint8_t s_i2cSingleByte = 0;
 
 void sdl_send_init()
 {
+    if (s_busFrequency)
+    {
+        s_busTransactions++;
+        if (s_dcPin < 0 && !s_spi3Wire)
+        {
+            s_busBits += 1 + 9;
+        }
+    }
+    s_spi3WireAcc = 0;
+    s_spi3WireBits = 0;
     s_active_data_mode = SDM_COMMAND_ARG;
     s_ssdMode = SSD_MODE_NONE;
+    s_i2cSingleByte = 0;
 //    s_commandId = SSD_COMMAND_NONE;
 }
 
@@ -181,8 +578,32 @@ static void sdl_write_data(uint8_t data)
     }
 }
 
+static void sdl_send_mode_byte(uint8_t data);
+
+static void sdl_send_3wire_byte(uint8_t data)
+{
+    s_spi3WireAcc = (s_spi3WireAcc << 8) | data;
+    s_spi3WireBits += 8;
+    if (s_spi3WireBits >= 9)
+    {
+        s_spi3WireBits -= 9;
+        uint16_t word = (s_spi3WireAcc >> s_spi3WireBits) & 0x1FF;
+        s_ssdMode = (word & 0x100) ? SSD_MODE_DATA : SSD_MODE_COMMAND;
+        sdl_send_mode_byte(word & 0xFF);
+    }
+}
+
 void sdl_send_byte(uint8_t data)
 {
+    if (s_busFrequency)
+    {
+        sdl_bus_bytes(1);
+    }
+    if (s_spi3Wire)
+    {
+        sdl_send_3wire_byte(data);
+        return;
+    }
     if (s_dcPin>=0)
     {
         // for spi
@@ -190,10 +611,23 @@ void sdl_send_byte(uint8_t data)
     }
     else if (s_ssdMode == SSD_MODE_NONE)
     {
-        // for i2c
-        s_ssdMode = data == 0x00 ? SSD_MODE_COMMAND : SSD_MODE_DATA;
+        // for i2c: control byte with Co bit set applies to single next byte only
+        s_ssdMode = (data & 0x40) ? SSD_MODE_DATA : SSD_MODE_COMMAND;
+        s_i2cSingleByte = (data & 0x80) != 0;
+        return;
+    }
+    else if (s_i2cSingleByte)
+    {
+        s_i2cSingleByte = 0;
+        sdl_send_mode_byte(data);
+        s_ssdMode = SSD_MODE_NONE;
         return;
     }
+    sdl_send_mode_byte(data);
+}
+
+static void sdl_send_mode_byte(uint8_t data)
+{
     if (s_ssdMode == SSD_MODE_COMMAND)
     {
         if (s_oled == SDL_AUTODETECT)
@@ -244,10 +678,58 @@ void sdl_send_byte(uint8_t data)
     }
 }
 
+void sdl_send_bytes(const uint8_t *buffer, uint16_t size)
+{
+    while (size && s_spi3Wire)
+    {
+        sdl_send_byte(*buffer++);
+        size--;
+    }
+    while (size)
+    {
+        /* Once GDRAM write mode is active, the rest of the buffer is pixels data */
+        int dataMode = s_dcPin >= 0 ? s_digitalPins[s_dcPin] :
+                       (s_ssdMode == SSD_MODE_DATA && !s_i2cSingleByte);
+        if (dataMode && p_active_driver &&
+            ((p_active_driver->dataMode == SDMS_AUTO) || (s_active_data_mode == SDM_WRITE_DATA)))
+        {
+            if (s_dcPin >= 0)
+            {
+                s_ssdMode = SSD_MODE_DATA;
+            }
+            s_active_data_mode = SDM_WRITE_DATA;
+            if (s_busFrequency)
+            {
+                sdl_bus_bytes(size);
+            }
+            void (*run_data)(uint8_t data) = p_active_driver->run_data;
+            while (size--)
+            {
+                run_data(*buffer);
+                buffer++;
+            }
+            return;
+        }
+        sdl_send_byte(*buffer);
+        buffer++;
+        size--;
+    }
+}
+
 void sdl_send_stop()
 {
-    sdl_poll_event();
-    sdl_graphics_refresh();
+    if (s_busFrequency)
+    {
+        if (s_dcPin < 0 && !s_spi3Wire)
+        {
+            s_busBits += 1;
+        }
+        if (s_busThrottle)
+        {
+            sdl_bus_throttle();
+        }
+    }
+    if (sdl_graphics_refresh()) sdl_poll_event();
     s_ssdMode = -1;
 }
 
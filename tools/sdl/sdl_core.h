@@ -50,17 +50,80 @@ extern void sdl_core_init(void);
 extern void sdl_core_draw(void);
 
 extern void sdl_set_dc_pin(int pin);
+
+extern void sdl_set_spi_3wire(int enable);
+
 // Accepts pointer to six-elements array
 extern void sdl_set_gpio_keys(const uint8_t * pins);
 extern void sdl_send_init();
 extern void sdl_send_byte(uint8_t data);
+extern void sdl_send_bytes(const uint8_t *buffer, uint16_t size);
 extern void sdl_send_stop();
 extern int  sdl_read_analog(int pin);
 extern void sdl_write_digital(int pin, int value);
 extern int sdl_read_digital(int pin);
 
+/**
+ * Input recording and replay. If SDL_INPUT_RECORD environment variable is set, key
+ * changes are written to the file, named by the variable, as text lines "<ms> <keys>",
+ * where keys is a mask of NanoEngine buttons. The last line marks the end of session.
+ * If SDL_INPUT_REPLAY is set, keys are taken from the file at recorded time, and the
+ * application exits at the end of the file, printing frame statistics.
+ * SDL_FRAME_REPORT enables frame statistics without replay.
+ */
+/** Returns non-zero, if NanoEngine should report frames via sdl_core_frame_end() */
+extern int sdl_core_frame_stats_enabled(void);
+
+/** Accounts single frame for the report: frame time in microseconds and number of tiles */
+extern void sdl_core_frame_end(uint32_t frameUs, uint32_t tiles);
+
+/**
+ * Shows tile refresh heatmap over emulated display: each tile is tinted red in
+ * proportion to its counter (relative to the largest one). The overlay is drawn
+ * in the window only, and is not included to dumped frames.
+ * @param counters tile counters, row by row, or NULL to remove the overlay
+ * @param cols number of tiles in a row
+ * @param rows number of tile rows
+ * @param stride distance between rows in counters array
+ * @param tileWidth tile width in pixels
+ * @param tileHeight tile height in pixels
+ */
+extern void sdl_core_set_heatmap(const uint8_t *counters, int cols, int rows, int stride,
+                                 int tileWidth, int tileHeight);
+
+/** Presents emulated display changes, not shown yet because of refresh rate limit */
+extern void sdl_core_flush(void);
+
+/**
+ * Implements delay() for the emulator: presents pending changes and sleeps.
+ * If SDL_EXIT_AFTER_DELAYS=n is set, n-th call saves display content to SDL_DUMP_FRAME
+ * file (if set) and exits. SDL_NO_DELAY disables sleeping.
+ * @param ms time to sleep in milliseconds
+ */
+extern void sdl_core_delay(uint32_t ms);
+
 extern void sdl_core_close(void);
 
+/**
+ * Enables emulation of bus timing: each transaction is accounted in bits, including
+ * i2c start, address, ack and stop overhead. If throttle is non-zero, emulation is
+ * slowed down to real bus speed. Setting SDL_BUS_FREQUENCY (and SDL_BUS_THROTTLE)
+ * environment variable does the same, and prints bus statistics on exit.
+ * @param frequency bus clock in Hz, 0 disables bus timing emulation
+ * @param throttle non-zero to wait real time, taken by the bus
+ */
+extern void sdl_set_bus_timing(uint32_t frequency, int throttle);
+
+/** Returns time in microseconds, spent on the emulated bus since sdl_set_bus_timing() */
+extern uint64_t sdl_get_bus_time_us(void);
+
+/**
+ * Writes current emulated display content to file: PBM image (set pixels are 1)
+ * if filename ends with ".pbm", PPM image otherwise.
+ * Returns 0 on success, -1 on error.
+ */
+extern int sdl_core_dump_frame(const char *filename);
+
 #ifdef __cplusplus
 }
 #endif
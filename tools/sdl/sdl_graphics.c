@@ -24,6 +24,9 @@
 
 #include "sdl_graphics.h"
 #include "sdl_oled_basic.h"
+
+#if !defined(SDL_HEADLESS)
+
 #include <unistd.h>
 #include <SDL2/SDL.h>
 #include <stdlib.h>
@@ -130,35 +133,151 @@ static void sdl_draw_oled_frame(void)
 #endif
 }
 
-void sdl_graphics_refresh(void)
+/* Tile refresh heatmap, drawn over the display, or NULL */
+static const uint8_t *s_heatmap = NULL;
+static int s_heatmapCols = 0;
+static int s_heatmapRows = 0;
+static int s_heatmapStride = 0;
+static int s_heatmapTileWidth = 0;
+static int s_heatmapTileHeight = 0;
+
+static void sdl_draw_heatmap(void)
 {
-    sdl_draw_oled_frame();
-    if (g_texture)
+    int max = 0;
+    for (int ty = 0; ty < s_heatmapRows; ty++)
     {
-        SDL_Rect r;
-        void * l_pixels;
-        int  pitch;
-        if (SDL_LockTexture(g_texture, NULL, &l_pixels, &pitch) == 0)
+        for (int tx = 0; tx < s_heatmapCols; tx++)
         {
-            if (pitch != s_width * (s_bpp/8))
-            {
-                fprintf(stderr, "Warning, pitch %d is not expected\n", pitch);
-            }
-            memcpy(l_pixels, g_pixels, s_width * s_height * (s_bpp/8));
-            SDL_UnlockTexture(g_texture);
+            if (s_heatmap[ty * s_heatmapStride + tx] > max) max = s_heatmap[ty * s_heatmapStride + tx];
         }
-        else
+    }
+    if (!max)
+    {
+        return;
+    }
+    SDL_SetRenderDrawBlendMode( g_renderer, SDL_BLENDMODE_BLEND );
+    for (int ty = 0; ty < s_heatmapRows; ty++)
+    {
+        for (int tx = 0; tx < s_heatmapCols; tx++)
         {
-            fprintf(stderr, "Something bad happened to SDL texture\n");
-            exit(1);
+            int counter = s_heatmap[ty * s_heatmapStride + tx];
+            if (!counter)
+            {
+                continue;
+            }
+            SDL_Rect r;
+            r.x = tx * s_heatmapTileWidth;
+            r.y = ty * s_heatmapTileHeight;
+            r.w = (r.x + s_heatmapTileWidth > s_width ? s_width - r.x : s_heatmapTileWidth) * PIXEL_SIZE;
+            r.h = (r.y + s_heatmapTileHeight > s_height ? s_height - r.y : s_heatmapTileHeight) * PIXEL_SIZE;
+            r.x = BORDER_SIZE + r.x * PIXEL_SIZE;
+            r.y = BORDER_SIZE + TOP_HEADER + r.y * PIXEL_SIZE;
+            SDL_SetRenderDrawColor( g_renderer, 255, 0, 0, 32 + 160 * counter / max );
+            SDL_RenderFillRect( g_renderer, &r );
         }
+    }
+    SDL_SetRenderDrawBlendMode( g_renderer, SDL_BLENDMODE_NONE );
+}
+
+/* Window area, changed since last texture update */
+static int s_dirtyX1 = 0;
+static int s_dirtyY1 = 0;
+static int s_dirtyX2 = -1;
+static int s_dirtyY2 = -1;
+/* True if texture is updated, but not presented yet */
+static int s_pending = 0;
+static uint32_t s_presentTs = 0;
+
+static void sdl_update_texture(void)
+{
+    if (!g_texture || s_dirtyX2 < s_dirtyX1)
+    {
+        return;
+    }
+    /* Only changed window is uploaded, the rest of texture keeps previous content */
+    SDL_Rect r;
+    r.x = s_dirtyX1;
+    r.y = s_dirtyY1;
+    r.w = s_dirtyX2 - s_dirtyX1 + 1;
+    r.h = s_dirtyY2 - s_dirtyY1 + 1;
+    const uint8_t *src = (const uint8_t *)g_pixels + (r.x + r.y * s_width) * (s_bpp / 8);
+    if (SDL_UpdateTexture(g_texture, &r, src, s_width * (s_bpp / 8)) != 0)
+    {
+        fprintf(stderr, "Something bad happened to SDL texture: %s\n", SDL_GetError());
+        exit(1);
+    }
+    s_dirtyX1 = s_width;
+    s_dirtyY1 = s_height;
+    s_dirtyX2 = -1;
+    s_dirtyY2 = -1;
+    s_pending = 1;
+}
+
+static void sdl_present(void)
+{
+    sdl_draw_oled_frame();
+    if (g_texture)
+    {
+        SDL_Rect r;
         r.x = BORDER_SIZE;
         r.y = BORDER_SIZE + TOP_HEADER;
         r.w = windowWidth() - BORDER_SIZE * 2;
         r.h = windowHeight() - BORDER_SIZE * 2 - TOP_HEADER;
         SDL_RenderCopy(g_renderer, g_texture, NULL, &r);
     }
+    if (s_heatmap)
+    {
+        sdl_draw_heatmap();
+    }
     SDL_RenderPresent(g_renderer);
+    s_pending = 0;
+    s_presentTs = SDL_GetTicks();
+}
+
+int sdl_graphics_refresh(void)
+{
+    /* Window is presented not more often than CANVAS_REFRESH_RATE, so emulation *
+     * speed doesn't depend on the number of bus transactions                    */
+    if ((uint32_t)(SDL_GetTicks() - s_presentTs) < 1000 / CANVAS_REFRESH_RATE)
+    {
+        return 0;
+    }
+    sdl_update_texture();
+    if (s_pending)
+    {
+        sdl_present();
+    }
+    else
+    {
+        s_presentTs = SDL_GetTicks();
+    }
+    return 1;
+}
+
+void sdl_graphics_flush(void)
+{
+    sdl_update_texture();
+    if (s_pending)
+    {
+        sdl_present();
+    }
+}
+
+void sdl_graphics_set_heatmap(const uint8_t *counters, int cols, int rows, int stride,
+                              int tileWidth, int tileHeight)
+{
+    if (!counters && !s_heatmap)
+    {
+        return;
+    }
+    s_heatmap = counters;
+    s_heatmapCols = cols;
+    s_heatmapRows = rows;
+    s_heatmapStride = stride;
+    s_heatmapTileWidth = tileWidth;
+    s_heatmapTileHeight = tileHeight;
+    /* Counters change every frame, so the window is presented even without new pixels */
+    s_pending = 1;
 }
 
 void sdl_graphics_set_oled_params(int width, int height, int bpp, uint32_t pixfmt)
@@ -175,7 +294,7 @@ void sdl_graphics_set_oled_params(int width, int height, int bpp, uint32_t pixfm
         free(g_pixels);
         g_pixels = NULL;
     }
-    g_pixels = malloc(s_width * s_height * (s_bpp / 8));
+    g_pixels = calloc(s_width * s_height, s_bpp / 8);
     g_texture = SDL_CreateTexture( g_renderer, s_pixfmt,
                                    SDL_TEXTUREACCESS_STREAMING,
                                    width, height );
@@ -186,6 +305,11 @@ void sdl_graphics_set_oled_params(int width, int height, int bpp, uint32_t pixfm
     }
     SDL_SetWindowSize(g_window, windowWidth(), windowHeight());
 
+    s_dirtyX1 = 0;
+    s_dirtyY1 = 0;
+    s_dirtyX2 = width - 1;
+    s_dirtyY2 = height - 1;
+
     SDL_SetRenderDrawColor( g_renderer, 20, 20, 20, 255 );
     r.x = RECT_THICKNESS;
     r.y = RECT_THICKNESS;
@@ -204,6 +328,10 @@ void sdl_put_pixel(int x, int y, uint32_t color)
     if (g_pixels)
     {
         int index = x + y * s_width;
+        if (x < s_dirtyX1) s_dirtyX1 = x;
+        if (x > s_dirtyX2) s_dirtyX2 = x;
+        if (y < s_dirtyY1) s_dirtyY1 = y;
+        if (y > s_dirtyY2) s_dirtyY2 = y;
         switch (s_bpp)
         {
             case 8:
@@ -255,3 +383,4 @@ void sdl_graphics_close(void)
     SDL_DestroyWindow(g_window);
 }
 
+#endif
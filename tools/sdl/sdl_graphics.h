@@ -32,8 +32,18 @@ extern "C" {
 #endif
 
 extern void sdl_graphics_init(void);
-extern void sdl_graphics_refresh(void);
+/**
+ * Uploads changed area of emulated display to the window and presents it, but not more
+ * often than CANVAS_REFRESH_RATE times per second. Returns non-zero if refresh interval
+ * has elapsed, so the caller can poll window events at the same rate.
+ */
+extern int sdl_graphics_refresh(void);
+/** Presents pending changes immediately */
+extern void sdl_graphics_flush(void);
 extern void sdl_graphics_close(void);
+/** Sets tile heatmap, drawn over emulated display. See sdl_core_set_heatmap() */
+extern void sdl_graphics_set_heatmap(const uint8_t *counters, int cols, int rows, int stride,
+                                     int tileWidth, int tileHeight);
 
 extern void sdl_graphics_set_oled_params(int width, int height, int bpp, uint32_t pixfmt);
 extern void sdl_put_pixel(int x, int y, uint32_t color);
@@ -0,0 +1,134 @@
+/*
+    MIT License
+
+    Copyright (c) 2018, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "sdl_graphics.h"
+#include "sdl_oled_basic.h"
+
+#if defined(SDL_HEADLESS)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Headless backend: pixels are kept in memory only, no window is created */
+
+void                  *g_pixels = NULL;
+
+static int s_width = 128;
+static int s_height = 64;
+static int s_bpp = 16;
+
+void sdl_graphics_init(void)
+{
+}
+
+int sdl_graphics_refresh(void)
+{
+    return 0;
+}
+
+void sdl_graphics_flush(void)
+{
+}
+
+void sdl_graphics_set_oled_params(int width, int height, int bpp, uint32_t pixfmt)
+{
+    s_bpp = bpp;
+    s_width = width;
+    s_height = height;
+    free(g_pixels);
+    g_pixels = calloc(s_width * s_height, s_bpp / 8);
+    if (g_pixels == NULL)
+    {
+        fprintf(stderr, "Error creating back buffer\n");
+        exit(1);
+    }
+}
+
+void sdl_put_pixel(int x, int y, uint32_t color)
+{
+    while (x >= s_width) x-= s_width;
+    while (y >= s_height) y-= s_height;
+    if (x<0) x = 0;
+    if (y<0) y = 0;
+    if (g_pixels)
+    {
+        int index = x + y * s_width;
+        switch (s_bpp)
+        {
+            case 8:
+                ((uint8_t *)g_pixels)[ index ] = color;
+                break;
+            case 16:
+                ((uint16_t *)g_pixels)[ index ] = color;
+                break;
+            case 32:
+                ((uint32_t *)g_pixels)[ index ] = color;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+uint32_t sdl_get_pixel(int x, int y)
+{
+    uint32_t pixel = 0;
+    while (x >= s_width) x-= s_width;
+    while (y >= s_height) y-= s_height;
+    if (x<0) x = 0;
+    if (y<0) y = 0;
+    if (g_pixels)
+    {
+        int index = x + y * s_width;
+        switch (s_bpp)
+        {
+            case 8:
+                pixel = ((uint8_t *)g_pixels)[ index ];
+                break;
+            case 16:
+                pixel = ((uint16_t *)g_pixels)[ index ];
+                break;
+            case 32:
+                pixel = ((uint32_t *)g_pixels)[ index ];
+                break;
+            default:
+                break;
+        }
+    }
+    return pixel;
+}
+
+void sdl_graphics_set_heatmap(const uint8_t *counters, int cols, int rows, int stride,
+                              int tileWidth, int tileHeight)
+{
+}
+
+void sdl_graphics_close(void)
+{
+    free(g_pixels);
+    g_pixels = NULL;
+}
+
+#endif
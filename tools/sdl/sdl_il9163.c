@@ -147,6 +147,9 @@ static void sdl_il9163_commands(uint8_t data)
             }
             break;
         case 0x2C:
+            // Memory write command resets GDRAM pointer to the start of the window
+            s_activeColumn = s_columnStart;
+            s_activePage = s_pageStart;
             sdl_set_data_mode( SDM_WRITE_DATA );
             s_commandId = SSD_COMMAND_NONE;
             break;
@@ -26,7 +26,14 @@
 #define _SDL_OLED_BASIC_H_
 
 #include <stdint.h>
+#if defined(SDL_HEADLESS)
+/* Headless backend keeps pixels in memory, and does not need SDL library */
+#define SDL_PIXELFORMAT_RGB332      1
+#define SDL_PIXELFORMAT_RGB565      2
+#define SDL_PIXELFORMAT_RGBX8888    3
+#else
 #include <SDL2/SDL.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -97,6 +97,11 @@ void sdl_pcd8544_data(uint8_t data)
         if (s_activePage > s_pageEnd)
         {
             s_activePage = s_pageStart;
+            s_activeColumn++;
+            if (s_activeColumn > s_columnEnd)
+            {
+                s_activeColumn = s_columnStart;
+            }
         }
     }
     else
@@ -105,6 +110,11 @@ void sdl_pcd8544_data(uint8_t data)
         if (s_activeColumn > s_columnEnd)
         {
             s_activeColumn = s_columnStart;
+            s_activePage++;
+            if (s_activePage > s_pageEnd)
+            {
+                s_activePage = s_pageStart;
+            }
         }
     }
 }
@@ -35,6 +35,7 @@ static int s_columnStart = 0;
 static int s_columnEnd = 127;
 static int s_pageStart = 0;
 static int s_pageEnd = 7;
+static uint8_t s_verticalMode = 0;
 static uint8_t detected = 0;
 
 static uint8_t gdram[128][64];
@@ -97,6 +98,13 @@ static void sdl_ssd1306_commands(uint8_t data)
 //    printf("%02X (CMD: %02X)\n", data, s_commandId);
     switch (s_commandId)
     {
+        case 0x20:
+            if (s_cmdArgIndex == 0)
+            {
+                s_verticalMode = (data == 0x01);
+                s_commandId = SSD_COMMAND_NONE;
+            }
+            break;
         case 0x21:
             switch (s_cmdArgIndex)
             {
@@ -125,6 +133,27 @@ static void sdl_ssd1306_commands(uint8_t data)
                 default: break;
             }
             break;
+        case 0x26: // Horizontal scroll setup
+        case 0x27:
+            // Scrolling is not emulated, arguments are skipped
+            if (s_cmdArgIndex == 5)
+            {
+                s_commandId = SSD_COMMAND_NONE;
+            }
+            break;
+        case 0x29: // Vertical and horizontal scroll setup
+        case 0x2A:
+            if (s_cmdArgIndex == 4)
+            {
+                s_commandId = SSD_COMMAND_NONE;
+            }
+            break;
+        case 0xA3: // Vertical scroll area
+            if (s_cmdArgIndex == 1)
+            {
+                s_commandId = SSD_COMMAND_NONE;
+            }
+            break;
         case 0xA8:
             if (s_cmdArgIndex == 0)
             {
@@ -190,6 +219,20 @@ void sdl_ssd1306_data(uint8_t data)
     {
         blt_single_pixel( x, (y<<3) + i, data & (1<<i) );
     }
+    if (s_verticalMode)
+    {
+        s_activePage++;
+        if (s_activePage > s_pageEnd)
+        {
+            s_activePage = s_pageStart;
+            s_activeColumn++;
+            if (s_activeColumn > s_columnEnd)
+            {
+                s_activeColumn = s_columnStart;
+            }
+        }
+        return;
+    }
     s_activeColumn++;
     if (s_activeColumn > s_columnEnd)
     {
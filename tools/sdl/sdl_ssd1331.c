@@ -43,6 +43,8 @@ static uint8_t s_verticalMode = 1;
 static uint8_t s_leftToRight = 0;
 static uint8_t s_topToBottom = 0;
 static uint8_t s_16bitmode = 0;
+static uint8_t s_fillRect = 0;
+static uint32_t s_fillColor = 0;
 
 static void copyBlock()
 {
@@ -68,6 +70,20 @@ static void copyBlock()
     }
 }
 
+static uint32_t rectColor(uint32_t color, uint8_t index, uint8_t data)
+{
+    // Colors are passed as blue, green, red components in 6-bit scale
+    if (s_16bitmode)
+    {
+        if (index == 0) return ((data & 0x3F) >> 1);
+        if (index == 1) return color | ((data & 0x3F) << 5);
+        return color | ((data & 0x3E) << 10);
+    }
+    if (index == 0) return ((data & 0x30) >> 4);
+    if (index == 1) return color | ((data & 0x38) >> 1);
+    return color | ((data & 0x38) << 2);
+}
+
 static void drawLine()
 {
     if ( abs(s_columnStart - s_columnEnd) > abs(s_pageStart - s_pageEnd) )
@@ -79,6 +95,7 @@ static void drawLine()
             sdl_put_pixel(x, y, s_color);
             x += (s_columnEnd > s_columnStart ? 1: -1);
         }
+        sdl_put_pixel(x, s_pageEnd, s_color);
     }
     else
     {
@@ -89,6 +106,26 @@ static void drawLine()
             sdl_put_pixel(x, y, s_color);
             y += (s_pageEnd > s_pageStart ? 1: -1);
         }
+        sdl_put_pixel(s_columnEnd, y, s_color);
+    }
+}
+
+static void drawRect()
+{
+    for (int row = s_pageStart; row <= s_pageEnd; row++)
+    {
+        for (int column = s_columnStart; column <= s_columnEnd; column++)
+        {
+            int border = (row == s_pageStart) || (row == s_pageEnd) ||
+                         (column == s_columnStart) || (column == s_columnEnd);
+            if ( !border && !s_fillRect )
+            {
+                continue;
+            }
+            int y = s_topToBottom ? row : (sdl_ssd1331x8.height - row - 1);
+            int x = s_leftToRight ? column: (sdl_ssd1331x8.width - column - 1);
+            sdl_put_pixel(x, y, border ? s_color : s_fillColor);
+        }
     }
 }
 
@@ -145,27 +182,15 @@ static void sdl_ssd1331_commands(uint8_t data)
         case 0x21: // DRAW LINE
             switch (s_cmdArgIndex)
             {
-                case 0: s_columnStart = data; s_color = 0; break;
+                case 0: s_columnStart = data; break;
                 case 1: s_pageStart = data; break;
                 case 2: s_columnEnd = data; break;
                 case 3: s_pageEnd = data; break;
-                case 4:
-                    if (s_16bitmode)
-                        s_color |= ((data & 0x3F) >> 1);
-                    else
-                        s_color |= ((data & 0x30) >> 4);
-                    break;
-                case 5:
-                    if (s_16bitmode)
-                        s_color |= ((data & 0x3F) << 5);
-                    else
-                        s_color |= ((data & 0x30) >> 1);
+                case 4: case 5:
+                    s_color = rectColor(s_color, s_cmdArgIndex - 4, data);
                     break;
                 case 6:
-                     if (s_16bitmode)
-                        s_color |= ((data & 0x3E) << 10);
-                     else
-                        s_color |= ((data & 0x38) << 2);
+                     s_color = rectColor(s_color, 2, data);
                      drawLine();
                      s_commandId = SSD_COMMAND_NONE;
                      break;
@@ -173,6 +198,35 @@ static void sdl_ssd1331_commands(uint8_t data)
                      break;
             }
             break;
+        case 0x22: // DRAW RECTANGLE
+            switch (s_cmdArgIndex)
+            {
+                case 0: s_columnStart = data; break;
+                case 1: s_pageStart = data; break;
+                case 2: s_columnEnd = data; break;
+                case 3: s_pageEnd = data; break;
+                case 4: case 5: case 6:
+                    s_color = rectColor(s_color, s_cmdArgIndex - 4, data);
+                    break;
+                case 7: case 8:
+                    s_fillColor = rectColor(s_fillColor, s_cmdArgIndex - 7, data);
+                    break;
+                case 9:
+                    s_fillColor = rectColor(s_fillColor, 2, data);
+                    drawRect();
+                    s_commandId = SSD_COMMAND_NONE;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        case 0x26: // FILL ENABLE
+            if (s_cmdArgIndex == 0)
+            {
+                s_fillRect = data & 0x01;
+                s_commandId = SSD_COMMAND_NONE;
+            }
+            break;
         case 0x23: // MOVE BLOCK
             switch (s_cmdArgIndex)
             {
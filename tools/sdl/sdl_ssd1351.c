@@ -47,6 +47,8 @@ static int sdl_ssd1351_detect(uint8_t data)
 }
 
 static uint8_t s_verticalMode = 0;
+static uint8_t s_columnRemap = 0;
+static uint8_t s_comRemap = 0x10;
 
 static void sdl_ssd1351_commands(uint8_t data)
 {
@@ -56,6 +58,8 @@ static void sdl_ssd1351_commands(uint8_t data)
             if (s_cmdArgIndex == 0)
             {
                 s_verticalMode = data & 0x01;
+                s_columnRemap = data & 0x02;
+                s_comRemap = data & 0x10;
                 s_commandId = SSD_COMMAND_NONE;
             }
             break;
@@ -117,7 +121,9 @@ void sdl_ssd1351_data(uint8_t data)
         return;
     }
     firstByte = 1;
-    sdl_put_pixel(x, y, (dataFirst<<8) | data);
+    sdl_put_pixel(s_columnRemap ? (sdl_ssd1351.width - x - 1) : x,
+                  s_comRemap ? y : (sdl_ssd1351.height - y - 1),
+                  (dataFirst<<8) | data);
 
     if (s_verticalMode)
     {
@@ -0,0 +1,177 @@
+#    MIT License
+#
+#    Copyright (c) 2019, Alexey Dynda
+#
+#    Permission is hereby granted, free of charge, to any person obtaining a copy
+#    of this software and associated documentation files (the "Software"), to deal
+#    in the Software without restriction, including without limitation the rights
+#    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#    copies of the Software, and to permit persons to whom the Software is
+#    furnished to do so, subject to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be included in all
+#    copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#    SOFTWARE.
+#
+###################################################################################
+# Converts sprite sheet image to packed sprite-sheet format, used by
+# NanoAnimatedSprite. Format (all values are bytes):
+#    frame count, frame width, frame height, flags (bit 0: delta rects present)
+#    [delta rects: x, y, width, height for each frame, area changed since previous frame]
+#    frames: native ssd1306 format, width * ((height + 7) / 8) bytes per frame
+# Delta rect of frame 0 describes changes since the last frame (looped animation).
+#
+
+import sys
+
+def print_help_and_exit():
+    print("Usage: spritesheet.py [args] inputFile > outputFile")
+    print("args:")
+    print("      -w <N>    width of single frame (default: image height)")
+    print("      -h <N>    height of single frame (default: image height)")
+    print("      -c <N>    number of frames (default: all frames in the image)")
+    print("      -n <S>    name of output array (default: spriteSheet)")
+    print("      -i        invert image: dark pixels are lit")
+    print("      -d        do not emit delta rects")
+    print("Input file is binary PPM (P6) image with frames placed left to right, top to bottom")
+    print("Examples:")
+    print("   [convert 4 frames 16x16 each, placed in a row]")
+    print("      spritesheet.py -w 16 -n runner runner.ppm > runner.h")
+    exit(1)
+
+def read_ppm(name):
+    with open(name, 'rb') as f:
+        data = f.read()
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            while data[pos:pos + 1] not in (b'\n', b''):
+                pos += 1
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    if fields[0] != b'P6' or int(fields[3]) != 255:
+        sys.stderr.write("Only 8-bit binary PPM (P6) images are supported\n")
+        exit(1)
+    width = int(fields[1])
+    height = int(fields[2])
+    pixels = data[pos + 1:]
+    lit = []
+    for n in range(width * height):
+        r, g, b = pixels[n * 3], pixels[n * 3 + 1], pixels[n * 3 + 2]
+        lit.append(((r * 77 + g * 150 + b * 29) >> 8) >= 128)
+    return width, height, lit
+
+def frame_pixels(lit, width, fx, fy, fw, fh):
+    return [[lit[(fy + y) * width + fx + x] for x in range(fw)] for y in range(fh)]
+
+def pack(pixels, fw, fh):
+    out = []
+    for page in range((fh + 7) // 8):
+        for x in range(fw):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < fh and pixels[y][x]:
+                    byte |= 1 << bit
+            out.append(byte)
+    return out
+
+def delta(prev, cur, fw, fh):
+    xs = []
+    ys = []
+    for y in range(fh):
+        for x in range(fw):
+            if prev[y][x] != cur[y][x]:
+                xs.append(x)
+                ys.append(y)
+    if not xs:
+        return [0, 0, 0, 0]
+    return [min(xs), min(ys), max(xs) - min(xs) + 1, max(ys) - min(ys) + 1]
+
+if len(sys.argv) < 2:
+    print_help_and_exit()
+
+fw = 0
+fh = 0
+count = 0
+name = "spriteSheet"
+invert = False
+deltas = True
+source = None
+i = 1
+while i < len(sys.argv):
+    if sys.argv[i] == "-w":
+        i += 1
+        fw = int(sys.argv[i])
+    elif sys.argv[i] == "-h":
+        i += 1
+        fh = int(sys.argv[i])
+    elif sys.argv[i] == "-c":
+        i += 1
+        count = int(sys.argv[i])
+    elif sys.argv[i] == "-n":
+        i += 1
+        name = sys.argv[i]
+    elif sys.argv[i] == "-i":
+        invert = True
+    elif sys.argv[i] == "-d":
+        deltas = False
+    elif sys.argv[i].startswith("-"):
+        print_help_and_exit()
+    else:
+        source = sys.argv[i]
+    i += 1
+
+if source is None:
+    print_help_and_exit()
+
+width, height, lit = read_ppm(source)
+if invert:
+    lit = [not v for v in lit]
+if fh <= 0:
+    fh = height
+if fw <= 0:
+    fw = fh
+if fw > width or fh > height or fw > 255 or fh > 255:
+    sys.stderr.write("Invalid frame size %dx%d\n" % (fw, fh))
+    exit(1)
+total = (width // fw) * (height // fh)
+if count <= 0 or count > total:
+    count = total
+if count > 255:
+    sys.stderr.write("Too many frames: %d\n" % count)
+    exit(1)
+
+frames = []
+for n in range(count):
+    fx = (n % (width // fw)) * fw
+    fy = (n // (width // fw)) * fh
+    frames.append(frame_pixels(lit, width, fx, fy, fw, fh))
+
+print("// %d frames %dx%d sprite sheet" % (count, fw, fh))
+print("const PROGMEM uint8_t %s[] =" % name)
+print("{")
+print("    %d, %d, %d, 0x%02X," % (count, fw, fh, 1 if deltas else 0))
+if deltas:
+    print("    // delta rects")
+    for n in range(count):
+        print("    " + ", ".join("%d" % v for v in delta(frames[n - 1], frames[n], fw, fh)) + ",")
+for n in range(count):
+    print("    // frame %d" % n)
+    packed = pack(frames[n], fw, fh)
+    for p in range(0, len(packed), 16):
+        print("    " + ", ".join("0x%02X" % v for v in packed[p:p + 16]) + ",")
+print("};")
@@ -0,0 +1,179 @@
+#    MIT License
+#
+#    Copyright (c) 2019, Alexey Dynda
+#
+#    Permission is hereby granted, free of charge, to any person obtaining a copy
+#    of this software and associated documentation files (the "Software"), to deal
+#    in the Software without restriction, including without limitation the rights
+#    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#    copies of the Software, and to permit persons to whom the Software is
+#    furnished to do so, subject to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be included in all
+#    copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#    SOFTWARE.
+#
+###################################################################################
+# Converts sequence of PPM images to image stream (see format.txt), which is
+# played by ssd1306_streamPlay() directly from file or SD card.
+# Each frame stores only rectangle, changed since previous frame, and is
+# RLE-compressed (as bitmapcompress.py does) if it makes the frame smaller.
+#
+
+import struct
+import sys
+
+import bitmapcompress
+
+FLAG_RLE = 0x01
+VERSION = 1
+
+def print_help_and_exit():
+    print("Usage: streamencode.py [args] -o outputFile inputFile...")
+    print("args:")
+    print("      -b <N>    bits per pixel: 1, 8 or 16 (default: 16)")
+    print("      -t <N>    frame period in milliseconds (default: 33)")
+    print("      -i        invert monochrome image: dark pixels are lit")
+    print("      -k        store full frames instead of changed areas")
+    print("Input files are binary PPM (P6) images of the same size")
+    print("Examples:")
+    print("   [convert video to 128x128 RGB565 stream at 30 fps]")
+    print("      ffmpeg -i boot.mp4 -vf scale=128:128 -r 30 frame%04d.ppm")
+    print("      streamencode.py -b 16 -t 33 -o boot.img frame*.ppm")
+    exit(1)
+
+def read_ppm(name):
+    with open(name, 'rb') as f:
+        data = f.read()
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            while data[pos:pos + 1] not in (b'\n', b''):
+                pos += 1
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    if fields[0] != b'P6' or int(fields[3]) != 255:
+        sys.stderr.write("Only 8-bit binary PPM (P6) images are supported: %s\n" % name)
+        exit(1)
+    width = int(fields[1])
+    height = int(fields[2])
+    pixels = bytearray(data[pos + 1:])
+    return width, height, [tuple(pixels[n * 3:n * 3 + 3]) for n in range(width * height)]
+
+def convert(rgb, bpp, invert):
+    r, g, b = rgb
+    if bpp == 1:
+        return int((((r * 77 + g * 150 + b * 29) >> 8) >= 128) != invert)
+    if bpp == 8:
+        return (r & 0xE0) | ((g >> 3) & 0x1C) | (b >> 6)
+    return ((r << 8) & 0xF800) | ((g << 3) & 0x07E0) | (b >> 3)
+
+def changed_rect(prev, cur, width, height, bpp):
+    if prev is None:
+        return 0, 0, width, height
+    rows = [y for y in range(height) if prev[y * width:(y + 1) * width] != cur[y * width:(y + 1) * width]]
+    if not rows:
+        return 0, 0, 0, 0
+    cols = [x for x in range(width) if any(prev[y * width + x] != cur[y * width + x] for y in rows)]
+    top, bottom = rows[0], rows[-1] + 1
+    if bpp == 1:
+        # Monochrome frames are updated by whole pages
+        top, bottom = top & ~7, (bottom + 7) & ~7
+    return cols[0], top, cols[-1] + 1 - cols[0], bottom - top
+
+def pack_rect(pixels, width, x0, y0, w, h, bpp):
+    out = []
+    if bpp == 1:
+        for page in range(y0 // 8, (y0 + h) // 8):
+            for x in range(x0, x0 + w):
+                byte = 0
+                for bit in range(8):
+                    if pixels[(page * 8 + bit) * width + x]:
+                        byte |= 1 << bit
+                out.append((byte,))
+    else:
+        for y in range(y0, y0 + h):
+            for x in range(x0, x0 + w):
+                value = pixels[y * width + x]
+                out.append((value >> 8, value & 0xFF) if bpp == 16 else (value,))
+    return out
+
+def main():
+    bpp = 16
+    frame_time = 33
+    invert = False
+    keyframes = False
+    output = None
+    inputs = []
+    i = 1
+    while i < len(sys.argv):
+        if sys.argv[i] == "-b":
+            i += 1
+            bpp = int(sys.argv[i])
+        elif sys.argv[i] == "-t":
+            i += 1
+            frame_time = int(sys.argv[i])
+        elif sys.argv[i] == "-i":
+            invert = True
+        elif sys.argv[i] == "-k":
+            keyframes = True
+        elif sys.argv[i] == "-o":
+            i += 1
+            output = sys.argv[i]
+        elif sys.argv[i].startswith("-"):
+            print_help_and_exit()
+        else:
+            inputs.append(sys.argv[i])
+        i += 1
+
+    if output is None or not inputs or bpp not in (1, 8, 16):
+        print_help_and_exit()
+
+    width = height = None
+    prev = None
+    frames = b''
+    raw_size = 0
+    for name in inputs:
+        w, h, rgb = read_ppm(name)
+        if width is None:
+            width, height = w, h
+            if bpp == 1 and height % 8:
+                sys.stderr.write("Height of monochrome images should be multiple of 8\n")
+                exit(1)
+        elif (w, h) != (width, height):
+            sys.stderr.write("Image %s has different size %dx%d\n" % (name, w, h))
+            exit(1)
+        pixels = [convert(p, bpp, invert) for p in rgb]
+        x, y, fw, fh = changed_rect(None if keyframes else prev, pixels, width, height, bpp)
+        units = pack_rect(pixels, width, x, y, fw, fh, bpp)
+        data = [v for unit in units for v in unit]
+        packed = bitmapcompress.compress(units)
+        flags = 0
+        if len(packed) < len(data):
+            data = packed
+            flags |= FLAG_RLE
+        frames += struct.pack('<BHHHHI', flags, x, y, fw, fh, len(data)) + bytes(bytearray(data))
+        raw_size += width * height * bpp // 8
+        prev = pixels
+
+    with open(output, 'wb') as f:
+        f.write(struct.pack('<4sBBHHHH2x', b'SIMG', VERSION, bpp, width, height, len(inputs), frame_time))
+        f.write(frames)
+    sys.stderr.write("%d frames %dx%d, %d bytes (%d bytes uncompressed)\n" %
+                     (len(inputs), width, height, len(frames) + 16, raw_size))
+
+if __name__ == "__main__":
+    main()
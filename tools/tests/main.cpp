@@ -0,0 +1,126 @@
+/*
+    MIT License
+
+    Copyright (c) 2019, Alexey Dynda
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Library tests, running in headless emulator. Each test returns number of failed checks.
+ * Run: make -f Makefile.linux check
+ */
+
+#include "ssd1306.h"
+#include "intf/ssd1306_interface.h"
+#include "lcd/lcd_common.h"
+
+#include <stdio.h>
+
+#define CHECK(cond) \
+    do { if (!(cond)) { printf("  %s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+
+/* Interface functions of the emulator, wrapped to count bytes sent to the display */
+static ssd1306_interface_t s_intf;
+static uint32_t s_bytes;
+
+static void count_send(uint8_t data)
+{
+    s_bytes++;
+    s_intf.send(data);
+}
+
+static void count_send_buffer(const uint8_t *buffer, uint16_t size)
+{
+    s_bytes += size;
+    s_intf.send_buffer(buffer, size);
+}
+
+static void count_attach(void)
+{
+    s_intf = ssd1306_intf;
+    ssd1306_intf.send = count_send;
+    ssd1306_intf.send_buffer = count_send_buffer;
+}
+
+/* Hardware acceleration hooks of ssd1331 must not be used by the next display */
+static int test_ssd1331_hooks_reset(void)
+{
+    int failed = 0;
+    ssd1331_96x64_spi_init16(-1, 0, 1);
+    CHECK(ssd1306_lcd.draw_line != NULL);
+    count_attach();
+    il9163_128x128_init();
+    CHECK(ssd1306_lcd.draw_line == NULL);
+    CHECK(ssd1306_lcd.draw_rect == NULL);
+    CHECK(ssd1306_lcd.copy_block == NULL);
+    ssd1306_setColor(0xFFFF);
+    s_bytes = 0;
+    ssd1306_drawLine16(0, 10, 49, 10);
+    /* 50 pixels, 2 bytes each, are sent to il9163 instead of ssd1331 line command */
+    CHECK(s_bytes >= 100);
+    return failed;
+}
+
+/* Hooks of 1-bit and 4-bit displays must not be used by the next display */
+static int test_mono_hooks_reset(void)
+{
+    int failed = 0;
+    ssd1306_128x64_spi_init(-1, 0, 1);
+    CHECK(ssd1306_lcd.set_column_block != NULL);
+    CHECK(ssd1306_lcd.set_rotation != NULL);
+    sh1106_128x64_init();
+    CHECK(ssd1306_lcd.set_column_block == NULL);
+    CHECK(ssd1306_lcd.set_rotation == NULL);
+    CHECK(ssd1306_lcd.set_brightness != NULL);
+
+    ssd1306_128x64_spi_init(-1, 0, 1);
+    pcd8544_84x48_init();
+    CHECK(ssd1306_lcd.set_column_block == NULL);
+    CHECK(ssd1306_lcd.set_rotation == NULL);
+    CHECK(ssd1306_lcd.set_brightness == NULL);
+
+    ssd1325_128x64_spi_init(-1, 0, 1);
+    CHECK(ssd1306_lcd.send_pixels_buffer4 != NULL);
+    pcd8544_84x48_init();
+    CHECK(ssd1306_lcd.send_pixels_buffer4 == NULL);
+    return failed;
+}
+
+static const struct
+{
+    const char *name;
+    int (*run)(void);
+} s_tests[] =
+{
+    { "ssd1331_hooks_reset", test_ssd1331_hooks_reset },
+    { "mono_hooks_reset", test_mono_hooks_reset },
+};
+
+int main(int argc, char *argv[])
+{
+    int failed = 0;
+    for (unsigned i = 0; i < sizeof(s_tests) / sizeof(s_tests[0]); i++)
+    {
+        int result = s_tests[i].run();
+        printf("%s: %s\n", s_tests[i].name, result ? "FAILED" : "OK");
+        failed += result ? 1 : 0;
+    }
+    return failed ? 1 : 0;
+}